@@ -4,15 +4,15 @@
 #include "memdb/attributeregistry.h"
 #include "game/componentserialization.h"
 #include "game/componentinspection.h"
-#include "pjson/pjson.h"
+#include "io/jsonindex.h"
 //------------------------------------------------------------------------------
 namespace IO
 {
 template<> void JsonReader::Get<Game::Position>(Game::Position& ret, const char* attr)
 {
     ret = Game::Position();
-    const pjson::value_variant* node = this->GetChild(attr);
-    if (node->is_object())
+    const IndexT node = this->GetChild(attr);
+    if (this->index->IsObject(node))
     {
         this->SetToNode(attr);
         if (this->HasAttr("x")) this->Get<float>(ret.x, "x");
@@ -20,7 +20,7 @@ template<> void JsonReader::Get<Game::Position>(Game::Position& ret, const char*
         if (this->HasAttr("z")) this->Get<float>(ret.z, "z");
         this->SetToParent();
     }
-    else if (node->is_array())
+    else if (this->index->IsArray(node))
     {
         this->Get<Math::vec3>(ret, attr);
     }
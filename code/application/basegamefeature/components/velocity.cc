@@ -4,15 +4,15 @@
 #include "memdb/attributeregistry.h"
 #include "game/componentserialization.h"
 #include "game/componentinspection.h"
-#include "pjson/pjson.h"
+#include "io/jsonindex.h"
 //------------------------------------------------------------------------------
 namespace IO
 {
 template<> void JsonReader::Get<Game::Velocity>(Game::Velocity& ret, const char* attr)
 {
     ret = Game::Velocity();
-    const pjson::value_variant* node = this->GetChild(attr);
-    if (node->is_object())
+    const IndexT node = this->GetChild(attr);
+    if (this->index->IsObject(node))
     {
         this->SetToNode(attr);
         if (this->HasAttr("x")) this->Get<float>(ret.x, "x");
@@ -20,7 +20,7 @@ template<> void JsonReader::Get<Game::Velocity>(Game::Velocity& ret, const char*
         if (this->HasAttr("z")) this->Get<float>(ret.z, "z");
         this->SetToParent();
     }
-    else if (node->is_array())
+    else if (this->index->IsArray(node))
     {
         this->Get<Math::vec3>(ret, attr);
     }
@@ -34,8 +34,8 @@ template<> void JsonWriter::Add<Game::Velocity>(Game::Velocity const& value, Uti
 template<> void JsonReader::Get<Game::AngularVelocity>(Game::AngularVelocity& ret, const char* attr)
 {
     ret = Game::AngularVelocity();
-    const pjson::value_variant* node = this->GetChild(attr);
-    if (node->is_object())
+    const IndexT node = this->GetChild(attr);
+    if (this->index->IsObject(node))
     {
         this->SetToNode(attr);
         if (this->HasAttr("x")) this->Get<float>(ret.x, "x");
@@ -43,7 +43,7 @@ template<> void JsonReader::Get<Game::AngularVelocity>(Game::AngularVelocity& re
         if (this->HasAttr("z")) this->Get<float>(ret.z, "z");
         this->SetToParent();
     }
-    else if (node->is_array())
+    else if (this->index->IsArray(node))
     {
         this->Get<Math::vec3>(ret, attr);
     }
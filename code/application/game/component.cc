@@ -10,4 +10,18 @@
 namespace Game
 {
 
+//------------------------------------------------------------------------------
+/**
+    Quantization applies to all 32 bit floats of the field, so a vector field
+    uses the same range for all of its components.
+*/
+void
+ComponentInterface::SetFieldQuantization(size_t field, float min, float max, uint8_t bits)
+{
+    n_assert(field < this->numFields);
+    n_assert(bits <= 32);
+    n_assert(bits == 0 || max > min);
+    this->fieldQuantization[(IndexT)field] = { min, max, bits };
+}
+
 } // namespace Game
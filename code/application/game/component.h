@@ -13,6 +13,7 @@
 #include "game/componentserialization.h"
 #include "game/componentinspection.h"
 #include "util/bitfield.h"
+#include "util/fixedarray.h"
 
 namespace Game
 {
@@ -35,9 +36,14 @@ enum ComponentFlags : uint32_t
     COMPONENTFLAG_NONE = 0,
     /// Component will decay. This will delay the deletion of this component by
     /// one frame, allowing managers to clean up externally allocated resources
-    COMPONENTFLAG_DECAY = 1 << 0
+    COMPONENTFLAG_DECAY = 1 << 0,
+    /// Component is sent to clients by the Game::ReplicationServer
+    COMPONENTFLAG_REPLICATE = 1 << 1
 };
 
+/// largest component which may be replicated, an entity created with only this component still fits into a single datagram
+static const SizeT MaxReplicatedComponentSize = 960;
+
 //------------------------------------------------------------------------------
 /**
     Contains data for components flagged with COMPONENTFLAG_DECAY, that
@@ -63,6 +69,8 @@ struct ComponentRegisterInfo
 
     /// Set to true if the component should end up in the decay buffer before being completely destroyed.
     bool decay = false;
+    /// Set to true if the component should be replicated over the network. @see Game::ReplicationServer
+    bool replicate = false;
     /// initialization function to run for the component, or nullptr if not needed.
     OnInitFunc OnInit = nullptr;
 };
@@ -85,11 +93,21 @@ public:
         this->fieldNames = (const char**)T::Traits::field_names;
         this->fieldTypenames = (const char**)T::Traits::field_typenames;
         this->fieldByteOffsets = (const size_t*)T::Traits::field_byte_offsets;
+        this->fieldQuantization.Resize((SizeT)this->numFields);
     }
 
     using ComponentInitFunc = void (*)(Game::World*, Game::Entity, void*);
     ComponentInitFunc Init = nullptr;
 
+    /// Describes how the floats of a field are quantized for replication
+    struct FieldQuantization
+    {
+        float min = 0.0f;
+        float max = 0.0f;
+        /// bits per value, 0 replicates the values losslessly
+        uint8_t bits = 0;
+    };
+
     const char* GetName() const { return componentName; }
     const char* GetFullyQualifiedName() const { return fullyQualifiedName; }
     const char** GetFieldNames() const { return fieldNames; };
@@ -97,6 +115,13 @@ public:
     const size_t* GetFieldByteOffsets() const { return fieldByteOffsets; };
     size_t const GetNumFields() const { return numFields; };
 
+    /// set the quantization of a float field, values outside of [min, max] are clamped
+    void SetFieldQuantization(size_t field, float min, float max, uint8_t bits);
+    /// get the quantization of a field
+    FieldQuantization const& GetFieldQuantization(size_t field) const { return fieldQuantization[field]; };
+    /// returns true if the component is replicated
+    bool IsReplicated() const { return (this->externalFlags & COMPONENTFLAG_REPLICATE) != 0; };
+
 private:
     const char* componentName = nullptr;
     const char* fullyQualifiedName = nullptr;
@@ -104,6 +129,7 @@ private:
     const char** fieldTypenames = nullptr;
     const size_t* fieldByteOffsets = nullptr;
     size_t numFields = 0;
+    Util::FixedArray<FieldQuantization> fieldQuantization;
 };
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,240 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Game::BitWriter
+    @class Game::BitReader
+
+    Bit granular writing and reading of unsigned values, used by the
+    replication delta codec. Bits are packed LSB first.
+
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "core/types.h"
+#include "util/array.h"
+
+namespace Game
+{
+
+class BitWriter
+{
+public:
+    /// constructor
+    BitWriter();
+
+    /// write the lowest numBits of value, numBits must be in [0, 32]
+    void Write(uint32_t value, uint numBits);
+    /// write a single bit
+    void WriteBool(bool value);
+    /// append all bits written to another writer
+    void Append(const BitWriter& other);
+    /// reset to empty
+    void Clear();
+
+    /// get number of bits written
+    SizeT GetNumBits() const;
+    /// get number of bytes needed to store all bits
+    SizeT GetNumBytes() const;
+    /// copy all bits to a byte buffer of at least GetNumBytes() size
+    void CopyTo(void* buffer) const;
+
+private:
+    Util::Array<uint8_t> bytes;
+    uint64_t scratch;
+    uint scratchBits;
+};
+
+class BitReader
+{
+public:
+    /// constructor
+    BitReader(const void* data, SizeT numBytes);
+
+    /// read numBits bits, numBits must be in [0, 32]
+    uint32_t Read(uint numBits);
+    /// read a single bit
+    bool ReadBool();
+    /// returns true if more bits were read than available
+    bool HasOverflow() const;
+    /// get number of bits which haven't been read yet
+    SizeT GetNumBitsLeft() const;
+
+private:
+    const uint8_t* data;
+    SizeT numBytes;
+    SizeT bytePos;
+    uint64_t scratch;
+    uint scratchBits;
+    bool overflow;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+BitWriter::BitWriter() :
+    scratch(0),
+    scratchBits(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+BitWriter::Write(uint32_t value, uint numBits)
+{
+    n_assert(numBits <= 32);
+    if (numBits == 0)
+        return;
+    const uint64_t mask = (1ull << numBits) - 1;
+    this->scratch |= ((uint64_t)value & mask) << this->scratchBits;
+    this->scratchBits += numBits;
+    while (this->scratchBits >= 8)
+    {
+        this->bytes.Append((uint8_t)(this->scratch & 0xFF));
+        this->scratch >>= 8;
+        this->scratchBits -= 8;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+BitWriter::WriteBool(bool value)
+{
+    this->Write(value ? 1 : 0, 1);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+BitWriter::Append(const BitWriter& other)
+{
+    IndexT i;
+    for (i = 0; i < other.bytes.Size(); i++)
+    {
+        this->Write(other.bytes[i], 8);
+    }
+    this->Write((uint32_t)other.scratch, other.scratchBits);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+BitWriter::Clear()
+{
+    this->bytes.Reset();
+    this->scratch = 0;
+    this->scratchBits = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+BitWriter::GetNumBits() const
+{
+    return this->bytes.Size() * 8 + this->scratchBits;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+BitWriter::GetNumBytes() const
+{
+    return this->bytes.Size() + (this->scratchBits > 0 ? 1 : 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+BitWriter::CopyTo(void* buffer) const
+{
+    uint8_t* dst = (uint8_t*)buffer;
+    if (!this->bytes.IsEmpty())
+    {
+        Memory::Copy(this->bytes.Begin(), dst, this->bytes.Size());
+    }
+    if (this->scratchBits > 0)
+    {
+        dst[this->bytes.Size()] = (uint8_t)this->scratch;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+BitReader::BitReader(const void* data, SizeT numBytes) :
+    data((const uint8_t*)data),
+    numBytes(numBytes),
+    bytePos(0),
+    scratch(0),
+    scratchBits(0),
+    overflow(false)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline uint32_t
+BitReader::Read(uint numBits)
+{
+    n_assert(numBits <= 32);
+    if (numBits == 0)
+        return 0;
+    while (this->scratchBits < numBits && this->bytePos < this->numBytes)
+    {
+        this->scratch |= (uint64_t)this->data[this->bytePos++] << this->scratchBits;
+        this->scratchBits += 8;
+    }
+    if (this->scratchBits < numBits)
+    {
+        this->overflow = true;
+        this->scratch = 0;
+        this->scratchBits = 0;
+        return 0;
+    }
+    const uint32_t value = (uint32_t)(this->scratch & ((1ull << numBits) - 1));
+    this->scratch >>= numBits;
+    this->scratchBits -= numBits;
+    return value;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+BitReader::ReadBool()
+{
+    return this->Read(1) != 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+BitReader::HasOverflow() const
+{
+    return this->overflow;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+BitReader::GetNumBitsLeft() const
+{
+    return (this->numBytes - this->bytePos) * 8 + this->scratchBits;
+}
+
+} // namespace Game
@@ -0,0 +1,378 @@
+//------------------------------------------------------------------------------
+//  deltacodec.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "application/stdneb.h"
+#include "deltacodec.h"
+#include "game/component.h"
+#include "memdb/attributeregistry.h"
+
+namespace Game
+{
+
+/// number of bits per entity id gap size class
+static const uint GapBits[] = { 6, 12, 22, 32 };
+
+//------------------------------------------------------------------------------
+/**
+*/
+static void
+AppendRecord(
+    ReplicationSnapshot& result,
+    uint32_t entity,
+    const Util::Array<ComponentId>& components,
+    const uint32_t* words,
+    SizeT numWords)
+{
+    ReplicationSnapshot::Record record;
+    record.entity = entity;
+    record.cell = 0;
+    record.layout = result.AddLayout(components);
+    record.firstWord = result.words.Size();
+    n_assert(result.layouts[record.layout].numWords == numWords);
+    IndexT i;
+    for (i = 0; i < numWords; i++)
+    {
+        result.words.Append(words[i]);
+    }
+    result.records.Append(record);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Component ids of created entities come straight from the network, only
+    components which are registered and replicated may be passed on.
+*/
+static bool
+IsReplicatedComponent(ComponentId component)
+{
+    const Util::FixedArray<MemDb::Attribute*>& attributes = MemDb::AttributeRegistry::GetAllAttributes();
+    if (component.id >= attributes.Size() || attributes[component.id] == nullptr)
+        return false;
+    const ComponentInterface* desc = static_cast<const ComponentInterface*>(attributes[component.id]);
+    return desc->IsReplicated() && desc->typeSize > 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+DeltaCodec::Encode(
+    const ReplicationSnapshot& current,
+    Util::Array<uint64_t>* currentMask,
+    const ReplicationSnapshot* baseline,
+    const Util::Array<uint64_t>* baselineMask,
+    SizeT maxPacketBytes,
+    Util::Array<BitWriter>& outPackets)
+{
+    outPackets.Clear();
+
+    // reserve the terminating bit of every packet
+    const SizeT maxPacketBits = maxPacketBytes * 8 - 1;
+    const SizeT maxRecordBits = MaxRecordBits(maxPacketBytes);
+    SizeT numEncoded = 0;
+    uint32_t prevEntity = 0;
+    BitWriter packet;
+    BitWriter record;
+
+    auto Emit = [&](uint32_t entity) -> bool
+    {
+        if (record.GetNumBits() > maxRecordBits)
+        {
+            return false;
+        }
+
+        // more bit and the largest gap
+        const SizeT numBits = 1 + 2 + 32 + record.GetNumBits();
+        if (packet.GetNumBits() > 0 && packet.GetNumBits() + numBits > maxPacketBits)
+        {
+            packet.WriteBool(false);
+            outPackets.Append(packet);
+            packet.Clear();
+            prevEntity = 0;
+        }
+        packet.WriteBool(true);
+        WriteGap(packet, entity - prevEntity);
+        packet.Append(record);
+        prevEntity = entity;
+        numEncoded++;
+        return true;
+    };
+
+    // a record which doesn't fit into a packet is dropped from the relevant records, the receiver removes it if it has it
+    auto Drop = [&](IndexT index, bool inBaseline)
+    {
+        n_assert2(currentMask != nullptr, "DeltaCodec: a record exceeds the packet size, a relevance mask is required to drop it");
+        (*currentMask)[index / 64] &= ~(1ull << (index % 64));
+        if (inBaseline)
+        {
+            record.Clear();
+            record.Write(Remove, 2);
+            Emit(current.records[index].entity);
+        }
+    };
+
+    auto WriteCreate = [&](const ReplicationSnapshot::Record& rec)
+    {
+        const ReplicationSnapshot::Layout& layout = current.layouts[rec.layout];
+        n_assert(layout.components.Size() < 256);
+        record.Write(Create, 2);
+        record.Write(layout.components.Size(), 8);
+        IndexT i;
+        for (i = 0; i < layout.components.Size(); i++)
+        {
+            record.Write(layout.components[i].id, 16);
+        }
+        for (i = 0; i < layout.numWords; i++)
+        {
+            WriteWord(record, current.words[rec.firstWord + i]);
+        }
+    };
+
+    const SizeT numCurrent = current.records.Size();
+    const SizeT numBaseline = baseline != nullptr ? baseline->records.Size() : 0;
+    IndexT i = 0;
+    IndexT j = 0;
+    while (i < numCurrent || j < numBaseline)
+    {
+        if (i < numCurrent && !IsRelevant(currentMask, i))
+        {
+            i++;
+            continue;
+        }
+        if (j < numBaseline && !IsRelevant(baselineMask, j))
+        {
+            j++;
+            continue;
+        }
+
+        record.Clear();
+        const bool hasCurrent = i < numCurrent;
+        const bool hasBaseline = j < numBaseline;
+        if (hasBaseline && (!hasCurrent || baseline->records[j].entity < current.records[i].entity))
+        {
+            // entity is gone or not relevant anymore
+            record.Write(Remove, 2);
+            Emit(baseline->records[j].entity);
+            j++;
+        }
+        else if (hasCurrent && (!hasBaseline || current.records[i].entity < baseline->records[j].entity))
+        {
+            WriteCreate(current.records[i]);
+            if (!Emit(current.records[i].entity))
+            {
+                Drop(i, false);
+            }
+            i++;
+        }
+        else
+        {
+            const ReplicationSnapshot::Record& rec = current.records[i];
+            const ReplicationSnapshot::Record& base = baseline->records[j];
+            const ReplicationSnapshot::Layout& layout = current.layouts[rec.layout];
+            if (layout.components == baseline->layouts[base.layout].components)
+            {
+                const uint32_t* words = &current.words[rec.firstWord];
+                const uint32_t* baseWords = &baseline->words[base.firstWord];
+                if (memcmp(words, baseWords, layout.numWords * sizeof(uint32_t)) != 0)
+                {
+                    record.Write(Update, 2);
+                    IndexT w;
+                    for (w = 0; w < layout.numWords; w++)
+                    {
+                        WriteWord(record, words[w] ^ baseWords[w]);
+                    }
+                    if (!Emit(rec.entity))
+                    {
+                        Drop(i, true);
+                    }
+                }
+            }
+            else
+            {
+                // components were added or removed, recreate the entity
+                WriteCreate(rec);
+                if (!Emit(rec.entity))
+                {
+                    Drop(i, true);
+                }
+            }
+            i++;
+            j++;
+        }
+    }
+
+    // always send at least one packet, so the receiver can acknowledge the tick
+    if (packet.GetNumBits() > 0 || outPackets.IsEmpty())
+    {
+        packet.WriteBool(false);
+        outPackets.Append(packet);
+    }
+    return numEncoded;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+DeltaCodec::Decode(const Util::Blob* packets, SizeT numPackets, const ReplicationSnapshot* baseline, ReplicationSnapshot& result)
+{
+    result.records.Reset();
+    result.words.Reset();
+
+    const SizeT numBaseline = baseline != nullptr ? baseline->records.Size() : 0;
+    IndexT j = 0;
+    auto CopyBaseline = [&](IndexT index)
+    {
+        const ReplicationSnapshot::Record& base = baseline->records[index];
+        const ReplicationSnapshot::Layout& layout = baseline->layouts[base.layout];
+        AppendRecord(result, base.entity, layout.components, &baseline->words[base.firstWord], layout.numWords);
+    };
+
+    Util::Array<ComponentId> components;
+    Util::Array<uint32_t> words;
+    IndexT p;
+    for (p = 0; p < numPackets; p++)
+    {
+        BitReader reader(packets[p].GetPtr(), packets[p].Size());
+        uint32_t entity = 0;
+        while (reader.ReadBool())
+        {
+            entity += ReadGap(reader);
+
+            // unchanged entities are implicitly kept
+            while (j < numBaseline && baseline->records[j].entity < entity)
+            {
+                CopyBaseline(j++);
+            }
+            const bool inBaseline = j < numBaseline && baseline->records[j].entity == entity;
+
+            const uint op = reader.Read(2);
+            if (op == Remove)
+            {
+                if (!inBaseline)
+                    return false;
+                j++;
+            }
+            else if (op == Update)
+            {
+                if (!inBaseline)
+                    return false;
+                const ReplicationSnapshot::Record& base = baseline->records[j++];
+                const ReplicationSnapshot::Layout& layout = baseline->layouts[base.layout];
+                words.Clear();
+                IndexT w;
+                for (w = 0; w < layout.numWords; w++)
+                {
+                    words.Append(baseline->words[base.firstWord + w] ^ ReadWord(reader));
+                }
+                AppendRecord(result, entity, layout.components, words.Begin(), words.Size());
+            }
+            else if (op == Create)
+            {
+                if (inBaseline)
+                    j++;
+                components.Clear();
+                SizeT numWords = 0;
+                const uint numComponents = reader.Read(8);
+                if (numComponents == 0 || numComponents * 16 > (uint)reader.GetNumBitsLeft())
+                    return false;
+                IndexT c;
+                for (c = 0; c < (IndexT)numComponents; c++)
+                {
+                    const ComponentId component = (uint16_t)reader.Read(16);
+                    if (!IsReplicatedComponent(component))
+                        return false;
+                    components.Append(component);
+                    numWords += ReplicationSnapshot::GetNumWords(component);
+                }
+
+                // every word takes at least one bit
+                if (numWords > reader.GetNumBitsLeft())
+                    return false;
+                words.Clear();
+                IndexT w;
+                for (w = 0; w < numWords; w++)
+                {
+                    words.Append(ReadWord(reader));
+                }
+                AppendRecord(result, entity, components, words.Begin(), words.Size());
+            }
+            else
+            {
+                return false;
+            }
+
+            if (reader.HasOverflow())
+                return false;
+        }
+        if (reader.HasOverflow())
+            return false;
+    }
+
+    while (j < numBaseline)
+    {
+        CopyBaseline(j++);
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DeltaCodec::WriteWord(BitWriter& writer, uint32_t delta)
+{
+    if (delta == 0)
+    {
+        writer.WriteBool(false);
+        return;
+    }
+    uint numBits = 1;
+    while (numBits < 32 && (delta >> numBits) != 0)
+    {
+        numBits++;
+    }
+    writer.WriteBool(true);
+    writer.Write(numBits - 1, 5);
+    writer.Write(delta, numBits);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+uint32_t
+DeltaCodec::ReadWord(BitReader& reader)
+{
+    if (!reader.ReadBool())
+        return 0;
+    const uint numBits = reader.Read(5) + 1;
+    return reader.Read(numBits);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DeltaCodec::WriteGap(BitWriter& writer, uint32_t gap)
+{
+    uint sizeClass = 0;
+    while (sizeClass < 3 && (uint64_t)gap >= (1ull << GapBits[sizeClass]))
+    {
+        sizeClass++;
+    }
+    writer.Write(sizeClass, 2);
+    writer.Write(gap, GapBits[sizeClass]);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+uint32_t
+DeltaCodec::ReadGap(BitReader& reader)
+{
+    const uint sizeClass = reader.Read(2);
+    return reader.Read(GapBits[sizeClass]);
+}
+
+} // namespace Game
@@ -0,0 +1,121 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Game::DeltaCodec
+
+    Encodes a ReplicationSnapshot relative to a baseline snapshot that the
+    receiver already has, and decodes it again.
+
+    The records of both snapshots are walked in entity order. Entities which
+    haven't changed since the baseline are skipped entirely, changed
+    entities are sent as the XOR of their words with the baseline words,
+    where every word is written as a changed bit followed by the number of
+    significant bits of the XOR and the bits themselves. Small changes of
+    quantized values thus only cost a few bits. Entities which are new to
+    the receiver, or whose components changed, are sent with their component
+    ids and their words XOR'ed with zero, entities which disappeared are sent
+    as removals.
+
+    Relevance masks select which records of a snapshot the receiver sees,
+    with one bit per record. A record that becomes relevant is created on the
+    receiver, a record that stops being relevant is removed.
+
+    The output is split into packets of at most maxPacketBytes, every packet
+    can be decoded on its own, but the receiver must apply all packets of a
+    tick together since unchanged entities aren't sent. A record which
+    doesn't fit into a packet on its own is treated as not relevant: its bit
+    is cleared in the current mask, and the receiver is told to remove it if
+    it had the entity before.
+
+    Component ids are sent as is, so the sender and the receiver must
+    register the same components in the same order.
+
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "core/types.h"
+#include "util/array.h"
+#include "util/blob.h"
+#include "replicationsnapshot.h"
+#include "bitpacker.h"
+
+namespace Game
+{
+
+class DeltaCodec
+{
+public:
+    /// encode current against baseline, baseline may be null to send everything, masks may be null if all records are relevant and fit into a packet
+    static SizeT Encode(
+        const ReplicationSnapshot& current,
+        Util::Array<uint64_t>* currentMask,
+        const ReplicationSnapshot* baseline,
+        const Util::Array<uint64_t>* baselineMask,
+        SizeT maxPacketBytes,
+        Util::Array<BitWriter>& outPackets
+    );
+    /// decode all packets of a tick into result, baseline may be null if the packets were encoded without one
+    static bool Decode(
+        const Util::Blob* packets,
+        SizeT numPackets,
+        const ReplicationSnapshot* baseline,
+        ReplicationSnapshot& result
+    );
+
+    /// check a bit in a relevance mask
+    static bool IsRelevant(const Util::Array<uint64_t>* mask, IndexT record);
+    /// largest record which fits into a packet of maxPacketBytes
+    static SizeT MaxRecordBits(SizeT maxPacketBytes);
+    /// bits of a created entity with a single component of typeSize bytes, in the worst case
+    static SizeT MaxCreateBits(SizeT typeSize);
+
+private:
+    enum Op
+    {
+        Update = 0,
+        Create = 1,
+        Remove = 2
+    };
+
+    /// write a word delta
+    static void WriteWord(BitWriter& writer, uint32_t delta);
+    /// read a word delta
+    static uint32_t ReadWord(BitReader& reader);
+    /// write the gap between two entity ids
+    static void WriteGap(BitWriter& writer, uint32_t gap);
+    /// read the gap between two entity ids
+    static uint32_t ReadGap(BitReader& reader);
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+DeltaCodec::IsRelevant(const Util::Array<uint64_t>* mask, IndexT record)
+{
+    return mask == nullptr || ((*mask)[record / 64] & (1ull << (record % 64))) != 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Every record is preceded by the more bit and the entity gap, every packet
+    ends with a terminating bit.
+*/
+inline SizeT
+DeltaCodec::MaxRecordBits(SizeT maxPacketBytes)
+{
+    return maxPacketBytes * 8 - 1 - (1 + 2 + 32);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Op, component count and id, then every word with a changed bit, its
+    length and up to 32 bits.
+*/
+inline SizeT
+DeltaCodec::MaxCreateBits(SizeT typeSize)
+{
+    return 2 + 8 + 16 + ((typeSize + 3) / 4) * (1 + 5 + 32);
+}
+
+} // namespace Game
@@ -0,0 +1,247 @@
+//------------------------------------------------------------------------------
+//  replicationclient.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "application/stdneb.h"
+#include "replicationclient.h"
+#include "replicationserver.h"
+#include "deltacodec.h"
+
+namespace Game
+{
+__ImplementClass(Game::ReplicationClient, 'RPCL', Core::RefCounted);
+
+using namespace Net;
+
+//------------------------------------------------------------------------------
+/**
+*/
+ReplicationClient::ReplicationClient() :
+    serverAddr(0),
+    serverPort(0),
+    latestTick(ReplicationSnapshot::InvalidTick)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+ReplicationClient::~ReplicationClient()
+{
+    n_assert(!this->IsOpen());
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+ReplicationClient::Open(const IpAddress& address)
+{
+    n_assert(!this->IsOpen());
+    Ptr<Socket> socket = Socket::Create();
+    if (!socket->Open(Socket::UDP))
+    {
+        n_warning("ReplicationClient: failed to open socket\n");
+        return false;
+    }
+    socket->SetAddress(address);
+    if (!socket->Bind())
+    {
+        n_warning("ReplicationClient: failed to bind socket to port %d\n", address.GetPort());
+        socket->Close();
+        return false;
+    }
+    socket->SetBlocking(false);
+    this->socket = socket;
+    this->latestTick = ReplicationSnapshot::InvalidTick;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReplicationClient::Close()
+{
+    n_assert(this->IsOpen());
+    this->socket->Close();
+    this->socket = nullptr;
+    this->pending.Clear();
+    IndexT i;
+    for (i = 0; i < HistorySize; i++)
+    {
+        this->snapshots[i].Clear();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReplicationClient::Update()
+{
+    n_assert(this->IsOpen());
+
+    const SizeT NumDatagrams = 32;
+    uint8_t buffers[NumDatagrams][ReplicationServer::MaxPacketSize];
+    Socket::Datagram datagrams[NumDatagrams];
+    IndexT i;
+    for (i = 0; i < NumDatagrams; i++)
+    {
+        datagrams[i].buf = buffers[i];
+        datagrams[i].bufSize = ReplicationServer::MaxPacketSize;
+    }
+
+    SizeT numReceived = 0;
+    while (Socket::Success == this->socket->RecvBatch(datagrams, NumDatagrams, numReceived) && numReceived > 0)
+    {
+        for (i = 0; i < numReceived; i++)
+        {
+            this->ReceivePacket(datagrams[i]);
+        }
+        if (numReceived < NumDatagrams)
+            break;
+    }
+
+    // decode complete ticks in order, newer ticks supersede older ones
+    for (i = 0; i < this->pending.Size(); i++)
+    {
+        const PendingTick& tick = this->pending[i];
+        if (tick.numReceived == tick.packets.Size() && this->DecodeTick(tick))
+        {
+            this->SendAck(tick.tick);
+        }
+    }
+    for (i = this->pending.Size() - 1; i >= 0; i--)
+    {
+        if (this->latestTick != ReplicationSnapshot::InvalidTick && this->pending[i].tick <= this->latestTick)
+        {
+            this->pending.EraseIndex(i);
+        }
+    }
+
+    // ticks which never complete are dropped
+    while (this->pending.Size() > (SizeT)HistorySize)
+    {
+        this->pending.EraseIndex(0);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReplicationClient::ReceivePacket(const Socket::Datagram& datagram)
+{
+    if (datagram.numBytes < ReplicationServer::HeaderSize)
+        return;
+    BitReader reader(datagram.buf, ReplicationServer::HeaderSize);
+    if (reader.Read(8) != 'S')
+        return;
+    const uint32_t tick = reader.Read(32);
+    const uint32_t baselineTick = reader.Read(32);
+    const uint packetIndex = reader.Read(16);
+    const uint numPackets = reader.Read(16);
+    if (numPackets == 0 || packetIndex >= numPackets)
+        return;
+    if (this->latestTick != ReplicationSnapshot::InvalidTick && tick <= this->latestTick)
+        return;
+
+    this->serverAddr = datagram.addr;
+    this->serverPort = datagram.port;
+
+    // pending ticks are sorted by tick
+    IndexT i;
+    for (i = 0; i < this->pending.Size(); i++)
+    {
+        if (this->pending[i].tick >= tick)
+            break;
+    }
+    if (i == this->pending.Size() || this->pending[i].tick != tick)
+    {
+        PendingTick newTick;
+        newTick.tick = tick;
+        newTick.baselineTick = baselineTick;
+        newTick.packets.Resize(numPackets);
+        newTick.numReceived = 0;
+        this->pending.Insert(i, newTick);
+    }
+
+    PendingTick& pendingTick = this->pending[i];
+    if (pendingTick.packets.Size() != (SizeT)numPackets || pendingTick.packets[packetIndex].Size() > 0)
+        return;
+    pendingTick.packets[packetIndex].Set((const uint8_t*)datagram.buf + ReplicationServer::HeaderSize, datagram.numBytes - ReplicationServer::HeaderSize);
+    pendingTick.numReceived++;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+ReplicationClient::DecodeTick(const PendingTick& pending)
+{
+    if (this->latestTick != ReplicationSnapshot::InvalidTick && pending.tick <= this->latestTick)
+        return false;
+
+    const ReplicationSnapshot* baseline = nullptr;
+    if (pending.baselineTick != ReplicationSnapshot::InvalidTick)
+    {
+        baseline = &this->snapshots[pending.baselineTick % HistorySize];
+        if (baseline->tick != pending.baselineTick || pending.baselineTick % HistorySize == pending.tick % HistorySize)
+            return false;
+    }
+
+    ReplicationSnapshot& result = this->snapshots[pending.tick % HistorySize];
+    if (!DeltaCodec::Decode(pending.packets.Begin(), pending.packets.Size(), baseline, result))
+    {
+        n_warning("ReplicationClient: failed to decode tick %u\n", pending.tick);
+        result.Clear();
+        return false;
+    }
+    result.tick = pending.tick;
+    this->latestTick = pending.tick;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReplicationClient::SendAck(uint32_t tick)
+{
+    BitWriter writer;
+    writer.Write('A', 8);
+    writer.Write(tick, 32);
+    uint8_t buffer[5];
+    writer.CopyTo(buffer);
+    SizeT bytesSent = 0;
+    this->socket->SendTo(buffer, sizeof(buffer), this->serverAddr, this->serverPort, bytesSent);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const ReplicationSnapshot&
+ReplicationClient::GetSnapshot() const
+{
+    n_assert(this->latestTick != ReplicationSnapshot::InvalidTick);
+    return this->snapshots[this->latestTick % HistorySize];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+ReplicationClient::ReadComponent(Entity entity, ComponentId component, void* value) const
+{
+    if (this->latestTick == ReplicationSnapshot::InvalidTick)
+        return false;
+    const ReplicationSnapshot& snapshot = this->snapshots[this->latestTick % HistorySize];
+    const IndexT record = snapshot.FindRecord((Ids::Id32)entity);
+    if (record == InvalidIndex)
+        return false;
+    return snapshot.ReadComponent(record, component, value);
+}
+
+} // namespace Game
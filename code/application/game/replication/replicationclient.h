@@ -0,0 +1,125 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Game::ReplicationClient
+
+    Receives the snapshots sent by a ReplicationServer.
+
+    Packets are buffered per tick until all packets of the tick have
+    arrived, the tick is then decoded against the baseline snapshot named in
+    the packet header and acknowledged to the server. Ticks which can't be
+    completed are dropped, the server keeps sending deltas against the last
+    acknowledged tick until a newer one gets through.
+
+    Component values are read with the entity ids of the server, and are
+    dequantized with the field quantization hints of the component.
+
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "core/refcounted.h"
+#include "net/socket/socket.h"
+#include "util/blob.h"
+#include "util/fixedarray.h"
+#include "replicationsnapshot.h"
+#include "game/entity.h"
+
+namespace Game
+{
+
+class ReplicationClient : public Core::RefCounted
+{
+    __DeclareClass(ReplicationClient);
+public:
+    /// number of decoded snapshots kept as baselines
+    static const SizeT HistorySize = 32;
+
+    /// constructor
+    ReplicationClient();
+    /// destructor
+    virtual ~ReplicationClient();
+
+    /// open the client socket
+    bool Open(const Net::IpAddress& address);
+    /// close the client
+    void Close();
+    /// return true if the client is open
+    bool IsOpen() const;
+
+    /// receive packets, decode complete ticks and acknowledge them
+    void Update();
+    /// get the latest decoded tick, or ReplicationSnapshot::InvalidTick
+    uint32_t GetTick() const;
+    /// get the latest decoded snapshot
+    const ReplicationSnapshot& GetSnapshot() const;
+
+    /// read a component of an entity of the server, returns false if the entity or the component isn't replicated
+    bool ReadComponent(Entity entity, ComponentId component, void* value) const;
+    /// read a component of an entity of the server
+    template <typename TYPE> bool ReadComponent(Entity entity, TYPE& value) const;
+
+    /// get the client socket
+    const Ptr<Net::Socket>& GetSocket() const;
+
+private:
+    struct PendingTick
+    {
+        uint32_t tick;
+        uint32_t baselineTick;
+        Util::FixedArray<Util::Blob> packets;
+        SizeT numReceived;
+    };
+
+    /// handle a received datagram
+    void ReceivePacket(const Net::Socket::Datagram& datagram);
+    /// decode a complete tick, returns false if the baseline is missing
+    bool DecodeTick(const PendingTick& pending);
+    /// acknowledge a tick
+    void SendAck(uint32_t tick);
+
+    Ptr<Net::Socket> socket;
+    uint serverAddr;
+    ushort serverPort;
+    uint32_t latestTick;
+    ReplicationSnapshot snapshots[HistorySize];
+    Util::Array<PendingTick> pending;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+ReplicationClient::IsOpen() const
+{
+    return this->socket.isvalid();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline uint32_t
+ReplicationClient::GetTick() const
+{
+    return this->latestTick;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const Ptr<Net::Socket>&
+ReplicationClient::GetSocket() const
+{
+    return this->socket;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template <typename TYPE>
+inline bool
+ReplicationClient::ReadComponent(Entity entity, TYPE& value) const
+{
+    return this->ReadComponent(entity, GetComponentId<TYPE>(), &value);
+}
+
+} // namespace Game
@@ -0,0 +1,309 @@
+//------------------------------------------------------------------------------
+//  replicationserver.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "application/stdneb.h"
+#include "replicationserver.h"
+#include "deltacodec.h"
+#include "game/world.h"
+#include "util/bit.h"
+
+namespace Game
+{
+__ImplementClass(Game::ReplicationServer, 'RPSV', Core::RefCounted);
+
+using namespace Net;
+
+//------------------------------------------------------------------------------
+/**
+*/
+ReplicationServer::ReplicationServer() :
+    world(nullptr),
+    cellSize(32.0f),
+    tick(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+ReplicationServer::~ReplicationServer()
+{
+    n_assert(!this->IsOpen());
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+ReplicationServer::Open(World* world, const IpAddress& address)
+{
+    n_assert(!this->IsOpen());
+    n_assert(world != nullptr);
+    n_assert(DeltaCodec::MaxCreateBits(MaxReplicatedComponentSize) <= DeltaCodec::MaxRecordBits(MaxPacketSize - HeaderSize));
+
+    Ptr<Socket> socket = Socket::Create();
+    if (!socket->Open(Socket::UDP))
+    {
+        n_warning("ReplicationServer: failed to open socket\n");
+        return false;
+    }
+    socket->SetAddress(address);
+    if (!socket->Bind())
+    {
+        n_warning("ReplicationServer: failed to bind socket to port %d\n", address.GetPort());
+        socket->Close();
+        return false;
+    }
+    socket->SetBlocking(false);
+
+    this->socket = socket;
+    this->world = world;
+    this->tick = 0;
+    IndexT i;
+    for (i = 0; i < HistorySize; i++)
+    {
+        this->snapshots[i].Clear();
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReplicationServer::Close()
+{
+    n_assert(this->IsOpen());
+    this->socket->Close();
+    this->socket = nullptr;
+    this->world = nullptr;
+    this->clients.Clear();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReplicationServer::SetCellSize(float size)
+{
+    n_assert(size > 0.0f);
+    this->cellSize = size;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+IndexT
+ReplicationServer::AddClient(uint addr, ushort port)
+{
+    IndexT i;
+    for (i = 0; i < this->clients.Size(); i++)
+    {
+        if (!this->clients[i].active)
+            break;
+    }
+    if (i == this->clients.Size())
+    {
+        this->clients.Append(Client());
+    }
+    Client& client = this->clients[i];
+    client = Client();
+    client.active = true;
+    client.addr = addr;
+    client.port = port;
+    return i;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReplicationServer::RemoveClient(IndexT client)
+{
+    n_assert(this->clients[client].active);
+    this->clients[client] = Client();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReplicationServer::SetClientView(IndexT client, const Math::vec3& position, int radius)
+{
+    n_assert(this->clients[client].active);
+    this->clients[client].viewCell = ReplicationSnapshot::PackCell(position, this->cellSize);
+    this->clients[client].radius = radius;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+uint32_t
+ReplicationServer::GetClientAckedTick(IndexT client) const
+{
+    return this->clients[client].ackedTick;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReplicationServer::Update()
+{
+    n_assert(this->IsOpen());
+    this->ReceiveAcks();
+    this->stats = Stats();
+
+    const ReplicationSnapshot* previous = nullptr;
+    if (this->tick > 0 && this->snapshots[(this->tick - 1) % HistorySize].tick == this->tick - 1)
+    {
+        previous = &this->snapshots[(this->tick - 1) % HistorySize];
+    }
+    ReplicationSnapshot& snapshot = this->snapshots[this->tick % HistorySize];
+    snapshot.Capture(this->world, this->tick, this->cellSize, previous);
+
+    IndexT i;
+    for (i = 0; i < this->clients.Size(); i++)
+    {
+        if (this->clients[i].active)
+        {
+            this->SendSnapshot(this->clients[i], snapshot);
+        }
+    }
+    this->tick++;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReplicationServer::SendSnapshot(Client& client, const ReplicationSnapshot& snapshot)
+{
+    // find the entities within the interest radius of the client
+    Util::Array<uint64_t>& mask = client.masks[this->tick % HistorySize];
+    mask.Clear();
+    mask.Resize((snapshot.records.Size() + 63) / 64, 0ull);
+    IndexT i;
+    for (i = 0; i < snapshot.records.Size(); i++)
+    {
+        if (client.radius == UnlimitedRadius || ReplicationSnapshot::InRange(snapshot.records[i].cell, client.viewCell, client.radius))
+        {
+            mask[i / 64] |= 1ull << (i % 64);
+        }
+    }
+
+    // delta against the last acknowledged snapshot if it is still in the history
+    const ReplicationSnapshot* baseline = nullptr;
+    const Util::Array<uint64_t>* baselineMask = nullptr;
+    uint32_t baselineTick = ReplicationSnapshot::InvalidTick;
+    if (client.ackedTick != ReplicationSnapshot::InvalidTick && this->tick - client.ackedTick < HistorySize)
+    {
+        const IndexT slot = client.ackedTick % HistorySize;
+        if (this->snapshots[slot].tick == client.ackedTick)
+        {
+            baseline = &this->snapshots[slot];
+            baselineMask = &client.masks[slot];
+            baselineTick = client.ackedTick;
+        }
+    }
+    if (baseline == nullptr)
+    {
+        this->stats.numFullUpdates++;
+    }
+
+    // records too large for a datagram are dropped from the mask by the codec
+    SizeT numRelevant = 0;
+    for (i = 0; i < mask.Size(); i++)
+    {
+        numRelevant += Util::PopCnt(mask[i]);
+    }
+    this->stats.numEntities += DeltaCodec::Encode(snapshot, &mask, baseline, baselineMask, MaxPacketSize - HeaderSize, this->packets);
+    for (i = 0; i < mask.Size(); i++)
+    {
+        numRelevant -= Util::PopCnt(mask[i]);
+    }
+    this->stats.numDropped += numRelevant;
+    n_assert(this->packets.Size() <= 0xFFFF);
+
+    // write all packets into one buffer and send them in a single batch
+    this->sendBuffer.Resize(this->packets.Size() * MaxPacketSize);
+    this->datagrams.Resize(this->packets.Size());
+    BitWriter header;
+    for (i = 0; i < this->packets.Size(); i++)
+    {
+        header.Clear();
+        header.Write('S', 8);
+        header.Write(this->tick, 32);
+        header.Write(baselineTick, 32);
+        header.Write(i, 16);
+        header.Write(this->packets.Size(), 16);
+        header.Append(this->packets[i]);
+
+        const SizeT numBytes = header.GetNumBytes();
+        n_assert(numBytes <= MaxPacketSize);
+        Socket::Datagram& datagram = this->datagrams[i];
+        datagram.buf = &this->sendBuffer[i * MaxPacketSize];
+        datagram.bufSize = MaxPacketSize;
+        datagram.numBytes = numBytes;
+        datagram.addr = client.addr;
+        datagram.port = client.port;
+        header.CopyTo(datagram.buf);
+        this->stats.numBytes += numBytes;
+    }
+
+    // datagrams which don't fit into the socket buffer are dropped, the next delta covers them
+    SizeT numSent = 0;
+    this->socket->SendBatch(this->datagrams.Begin(), this->datagrams.Size(), numSent);
+    this->stats.numPackets += numSent;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReplicationServer::ReceiveAcks()
+{
+    const SizeT NumAcks = 32;
+    uint8_t buffers[NumAcks][8];
+    Socket::Datagram acks[NumAcks];
+    IndexT i;
+    for (i = 0; i < NumAcks; i++)
+    {
+        acks[i].buf = buffers[i];
+        acks[i].bufSize = sizeof(buffers[i]);
+    }
+
+    SizeT numReceived = 0;
+    while (Socket::Success == this->socket->RecvBatch(acks, NumAcks, numReceived) && numReceived > 0)
+    {
+        for (i = 0; i < numReceived; i++)
+        {
+            BitReader reader(acks[i].buf, acks[i].numBytes);
+            if (reader.Read(8) != 'A')
+                continue;
+            const uint32_t ackedTick = reader.Read(32);
+            if (reader.HasOverflow() || ackedTick >= this->tick)
+                continue;
+
+            IndexT c;
+            for (c = 0; c < this->clients.Size(); c++)
+            {
+                Client& client = this->clients[c];
+                if (client.active && client.addr == acks[i].addr && client.port == acks[i].port)
+                {
+                    if (client.ackedTick == ReplicationSnapshot::InvalidTick || ackedTick > client.ackedTick)
+                    {
+                        client.ackedTick = ackedTick;
+                    }
+                    break;
+                }
+            }
+        }
+        if (numReceived < NumAcks)
+            break;
+    }
+}
+
+} // namespace Game
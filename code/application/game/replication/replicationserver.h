@@ -0,0 +1,168 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Game::ReplicationServer
+
+    Streams the replicated components of a world to clients over UDP.
+
+    Every Update() captures a ReplicationSnapshot and sends each client the
+    delta between it and the last snapshot the client has acknowledged, or
+    the full state if there is no such snapshot in the history anymore.
+    Clients only receive entities in spatial cells within their interest
+    radius, entities that leave the radius are removed on the client.
+
+    Update() must be called once per frame after all modifications have been
+    marked with World::MarkAsModified, and before World::ManageEntities
+    resets the modified rows, for example from a manager's OnEndFrame.
+
+    Every datagram starts with a header of type 'S', the tick, the baseline
+    tick, the packet index and the number of packets of the tick. Clients
+    acknowledge complete ticks with an 'A' datagram, see ReplicationClient.
+
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "core/refcounted.h"
+#include "net/socket/socket.h"
+#include "replicationsnapshot.h"
+#include "bitpacker.h"
+
+namespace Game
+{
+
+class World;
+
+class ReplicationServer : public Core::RefCounted
+{
+    __DeclareClass(ReplicationServer);
+public:
+    /// number of snapshots kept as baselines
+    static const SizeT HistorySize = 32;
+    /// largest datagram sent
+    static const SizeT MaxPacketSize = 1200;
+    /// size of the header in front of every datagram
+    static const SizeT HeaderSize = 13;
+    /// client view radius that includes every cell
+    static const int UnlimitedRadius = -1;
+
+    /// statistics of the last update
+    struct Stats
+    {
+        SizeT numBytes = 0;
+        SizeT numPackets = 0;
+        SizeT numEntities = 0;
+        SizeT numFullUpdates = 0;
+        SizeT numDropped = 0;
+    };
+
+    /// constructor
+    ReplicationServer();
+    /// destructor
+    virtual ~ReplicationServer();
+
+    /// open the server socket and start replicating a world
+    bool Open(World* world, const Net::IpAddress& address);
+    /// close the server
+    void Close();
+    /// return true if the server is open
+    bool IsOpen() const;
+
+    /// set the size of the spatial cells used for interest management
+    void SetCellSize(float size);
+    /// get the cell size
+    float GetCellSize() const;
+
+    /// add a client, addr and port are in host byte order
+    IndexT AddClient(uint addr, ushort port);
+    /// remove a client
+    void RemoveClient(IndexT client);
+    /// set the position and interest radius in cells of a client, entities outside are not sent
+    void SetClientView(IndexT client, const Math::vec3& position, int radius);
+    /// get the last tick acknowledged by a client
+    uint32_t GetClientAckedTick(IndexT client) const;
+
+    /// capture a snapshot and send deltas to all clients
+    void Update();
+    /// get the tick of the next update
+    uint32_t GetTick() const;
+    /// get statistics of the last update
+    const Stats& GetStats() const;
+    /// get the server socket
+    const Ptr<Net::Socket>& GetSocket() const;
+
+private:
+    struct Client
+    {
+        bool active = false;
+        uint addr = 0;
+        ushort port = 0;
+        uint32_t viewCell = 0;
+        int radius = UnlimitedRadius;
+        uint32_t ackedTick = ReplicationSnapshot::InvalidTick;
+        /// relevant records of the snapshot sent at every tick in the history
+        Util::Array<uint64_t> masks[HistorySize];
+    };
+
+    /// read acknowledgements from clients
+    void ReceiveAcks();
+    /// send the current snapshot to a client
+    void SendSnapshot(Client& client, const ReplicationSnapshot& snapshot);
+
+    World* world;
+    Ptr<Net::Socket> socket;
+    float cellSize;
+    uint32_t tick;
+    ReplicationSnapshot snapshots[HistorySize];
+    Util::Array<Client> clients;
+    Util::Array<BitWriter> packets;
+    Util::Array<uint8_t> sendBuffer;
+    Util::Array<Net::Socket::Datagram> datagrams;
+    Stats stats;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+ReplicationServer::IsOpen() const
+{
+    return this->socket.isvalid();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline float
+ReplicationServer::GetCellSize() const
+{
+    return this->cellSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline uint32_t
+ReplicationServer::GetTick() const
+{
+    return this->tick;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const ReplicationServer::Stats&
+ReplicationServer::GetStats() const
+{
+    return this->stats;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const Ptr<Net::Socket>&
+ReplicationServer::GetSocket() const
+{
+    return this->socket;
+}
+
+} // namespace Game
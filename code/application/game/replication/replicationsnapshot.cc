@@ -0,0 +1,309 @@
+//------------------------------------------------------------------------------
+//  replicationsnapshot.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "application/stdneb.h"
+#include "replicationsnapshot.h"
+#include "game/world.h"
+#include "memdb/database.h"
+#include "memdb/attributeregistry.h"
+#include "basegamefeature/components/position.h"
+
+namespace Game
+{
+
+//------------------------------------------------------------------------------
+/**
+*/
+static bool
+CompareRecords(const ReplicationSnapshot::Record& lhs, const ReplicationSnapshot::Record& rhs)
+{
+    return lhs.entity < rhs.entity;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+ReplicationSnapshot::ReplicationSnapshot() :
+    tick(InvalidTick)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReplicationSnapshot::Capture(World* world, uint32_t tick, float cellSize, const ReplicationSnapshot* previous)
+{
+    n_assert(previous != this);
+    this->Clear();
+    this->tick = tick;
+
+    Ptr<MemDb::Database> db = world->GetDatabase();
+    Util::Array<ComponentId> components;
+    Util::Array<MemDb::ColumnIndex> columns;
+    db->ForEachTable([&](MemDb::TableId tid)
+    {
+        MemDb::Table& table = db->GetTable(tid);
+        const Util::Array<MemDb::AttributeId>& attributes = table.GetAttributes();
+        components.Clear();
+        columns.Clear();
+        IndexT i;
+        for (i = 0; i < attributes.Size(); i++)
+        {
+            const ComponentInterface* component = static_cast<ComponentInterface*>(MemDb::AttributeRegistry::GetAttribute(attributes[i]));
+            if (component->IsReplicated() && component->typeSize > 0)
+            {
+                components.Append(attributes[i]);
+                columns.Append(MemDb::ColumnIndex((uint16_t)i));
+            }
+        }
+        if (components.IsEmpty())
+            return;
+
+        const IndexT layoutIndex = this->AddLayout(components);
+        const IndexT prevLayoutIndex = previous != nullptr ? previous->FindLayout(components) : InvalidIndex;
+        const Layout& layout = this->layouts[layoutIndex];
+
+        MemDb::Table::Partition* partition = table.GetFirstActivePartition();
+        for (; partition != nullptr; partition = partition->next)
+        {
+            const Entity* owners = (const Entity*)partition->columns[Entity::Traits::fixed_column_index];
+            const Position* positions = (const Position*)partition->columns[Position::Traits::fixed_column_index];
+            uint16_t row;
+            for (row = 0; row < partition->numRows; row++)
+            {
+                if (!partition->validRows.IsSet(row))
+                    continue;
+
+                Record record;
+                record.entity = (Ids::Id32)owners[row];
+                record.cell = PackCell(positions[row], cellSize);
+                record.layout = layoutIndex;
+                record.firstWord = this->words.Size();
+                const SizeT numWords = this->words.Size() + layout.numWords;
+                if (numWords > this->words.Capacity())
+                    this->words.Reserve(Math::max(numWords, this->words.Capacity() * 2));
+                this->words.Resize(numWords);
+                uint32_t* dst = this->words.Begin() + record.firstWord;
+
+                // unmodified rows keep the words of the previous snapshot
+                if (prevLayoutIndex != InvalidIndex && !partition->modifiedRows.IsSet(row))
+                {
+                    const IndexT prevRecord = previous->FindRecord(record.entity);
+                    if (prevRecord != InvalidIndex && previous->records[prevRecord].layout == prevLayoutIndex)
+                    {
+                        Memory::Copy(&previous->words[previous->records[prevRecord].firstWord], dst, layout.numWords * sizeof(uint32_t));
+                        this->records.Append(record);
+                        continue;
+                    }
+                }
+
+                IndexT c;
+                for (c = 0; c < layout.components.Size(); c++)
+                {
+                    const SizeT typeSize = MemDb::AttributeRegistry::TypeSize(layout.components[c]);
+                    const uint8_t* value = (const uint8_t*)partition->columns[columns[c].id] + typeSize * row;
+                    const IndexT firstWord = layout.componentWordOffsets[c];
+                    const SizeT numWords = (typeSize + 3) / 4;
+
+                    // the last word of components which aren't a multiple of 4 bytes is zero padded
+                    dst[firstWord + numWords - 1] = 0;
+                    Memory::Copy(value, &dst[firstWord], typeSize);
+                    IndexT w;
+                    for (w = firstWord; w < firstWord + numWords; w++)
+                    {
+                        dst[w] = QuantizeWord(dst[w], layout.wordQuantization[w]);
+                    }
+                }
+                this->records.Append(record);
+            }
+        }
+    });
+
+    this->records.SortWithFunc(CompareRecords);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReplicationSnapshot::Clear()
+{
+    this->tick = InvalidTick;
+    this->records.Reset();
+    this->words.Reset();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Layouts are kept when clearing the snapshot, the number of distinct
+    layouts is bound by the number of tables.
+*/
+IndexT
+ReplicationSnapshot::AddLayout(const Util::Array<ComponentId>& components)
+{
+    IndexT i = this->FindLayout(components);
+    if (i != InvalidIndex)
+        return i;
+
+    Layout layout;
+    layout.components = components;
+    for (i = 0; i < components.Size(); i++)
+    {
+        const ComponentInterface* component = static_cast<ComponentInterface*>(MemDb::AttributeRegistry::GetAttribute(components[i]));
+        const SizeT numWords = GetNumWords(components[i]);
+        n_assert(layout.numWords + numWords <= 0xFFFF);
+        layout.componentWordOffsets.Append((uint16_t)layout.numWords);
+
+        IndexT w;
+        for (w = 0; w < numWords; w++)
+        {
+            // find the field that the word belongs to, fields are sorted by offset
+            ComponentInterface::FieldQuantization quantization;
+            const size_t offset = w * 4;
+            size_t f;
+            for (f = 0; f < component->GetNumFields(); f++)
+            {
+                if (component->GetFieldByteOffsets()[f] > offset)
+                    break;
+                quantization = component->GetFieldQuantization(f);
+            }
+            layout.wordQuantization.Append(quantization);
+        }
+        layout.numWords += numWords;
+    }
+    this->layouts.Append(layout);
+    return this->layouts.Size() - 1;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+IndexT
+ReplicationSnapshot::FindLayout(const Util::Array<ComponentId>& components) const
+{
+    IndexT i;
+    for (i = 0; i < this->layouts.Size(); i++)
+    {
+        if (this->layouts[i].components == components)
+            return i;
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+IndexT
+ReplicationSnapshot::FindRecord(uint32_t entity) const
+{
+    IndexT lo = 0;
+    IndexT hi = this->records.Size() - 1;
+    while (lo <= hi)
+    {
+        const IndexT mid = (lo + hi) / 2;
+        const uint32_t id = this->records[mid].entity;
+        if (id == entity)
+            return mid;
+        else if (id < entity)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+ReplicationSnapshot::ReadComponent(IndexT record, ComponentId component, void* value) const
+{
+    const Record& rec = this->records[record];
+    const Layout& layout = this->layouts[rec.layout];
+    const IndexT c = layout.components.FindIndex(component);
+    if (c == InvalidIndex)
+        return false;
+
+    const SizeT typeSize = MemDb::AttributeRegistry::TypeSize(component);
+    const IndexT firstWord = layout.componentWordOffsets[c];
+    uint8_t* dst = (uint8_t*)value;
+    IndexT w;
+    for (w = 0; w < (typeSize + 3) / 4; w++)
+    {
+        const uint32_t word = DequantizeWord(this->words[rec.firstWord + firstWord + w], layout.wordQuantization[firstWord + w]);
+        Memory::Copy(&word, dst + w * 4, Math::min(4, typeSize - w * 4));
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+uint32_t
+ReplicationSnapshot::PackCell(const Math::vec3& position, float cellSize)
+{
+    const int x = (int)Math::floor(position.x / cellSize);
+    const int z = (int)Math::floor(position.z / cellSize);
+    return ((uint32_t)(uint16_t)(int16_t)Math::clamp(x, -32768, 32767) << 16) | (uint16_t)(int16_t)Math::clamp(z, -32768, 32767);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+ReplicationSnapshot::InRange(uint32_t cell, uint32_t center, int radius)
+{
+    const int dx = (int)(int16_t)(cell >> 16) - (int)(int16_t)(center >> 16);
+    const int dz = (int)(int16_t)(cell & 0xFFFF) - (int)(int16_t)(center & 0xFFFF);
+    return Math::abs(dx) <= radius && Math::abs(dz) <= radius;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Maps the float in the word linearly to [0, 2^bits - 1] within the range
+    of the field, words of fields without quantization are passed through.
+*/
+uint32_t
+ReplicationSnapshot::QuantizeWord(uint32_t word, const ComponentInterface::FieldQuantization& quantization)
+{
+    if (quantization.bits == 0)
+        return word;
+
+    float value;
+    Memory::Copy(&word, &value, sizeof(float));
+    const double maxValue = (double)((1ull << quantization.bits) - 1);
+    double t = ((double)value - quantization.min) / ((double)quantization.max - quantization.min);
+    // also catches NaN, which may be in the padding of vector fields
+    t = !(t >= 0.0) ? 0.0 : (t > 1.0 ? 1.0 : t);
+    return (uint32_t)(t * maxValue + 0.5);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+uint32_t
+ReplicationSnapshot::DequantizeWord(uint32_t word, const ComponentInterface::FieldQuantization& quantization)
+{
+    if (quantization.bits == 0)
+        return word;
+
+    const double maxValue = (double)((1ull << quantization.bits) - 1);
+    const float value = (float)(quantization.min + ((double)quantization.max - quantization.min) * (word / maxValue));
+    uint32_t ret;
+    Memory::Copy(&value, &ret, sizeof(float));
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+ReplicationSnapshot::GetNumWords(ComponentId component)
+{
+    return (MemDb::AttributeRegistry::TypeSize(component) + 3) / 4;
+}
+
+} // namespace Game
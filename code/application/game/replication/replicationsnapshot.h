@@ -0,0 +1,95 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Game::ReplicationSnapshot
+
+    The state of all replicated components of a world at a given tick.
+
+    Every entity that has at least one component registered with
+    ComponentRegisterInfo::replicate is stored as a record, sorted by entity
+    id. The component values are stored as 32 bit words, float words are
+    quantized according to the field quantization hints of the component
+    (see ComponentInterface::SetFieldQuantization), everything else is stored
+    as is. Snapshots are compared word by word by the DeltaCodec.
+
+    Capturing only reads rows which are marked as modified in their partition
+    (World::MarkAsModified), all other rows reuse the words of the previous
+    snapshot. Capture must run before World::ManageEntities resets the
+    modified rows, for example in a manager's OnEndFrame.
+
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "core/types.h"
+#include "util/array.h"
+#include "game/component.h"
+#include "game/componentid.h"
+#include "math/vec3.h"
+
+namespace Game
+{
+
+class World;
+
+class ReplicationSnapshot
+{
+public:
+    /// tick used for snapshots which haven't been captured or decoded
+    static const uint32_t InvalidTick = 0xFFFFFFFF;
+
+    /// the replicated components of a table
+    struct Layout
+    {
+        Util::Array<ComponentId> components;
+        /// offset of every component in words relative to the first word of the record
+        Util::Array<uint16_t> componentWordOffsets;
+        /// quantization of every word
+        Util::Array<ComponentInterface::FieldQuantization> wordQuantization;
+        SizeT numWords = 0;
+    };
+
+    /// an entity in the snapshot
+    struct Record
+    {
+        uint32_t entity;
+        /// packed spatial cell of the entity, see PackCell
+        uint32_t cell;
+        IndexT layout;
+        IndexT firstWord;
+    };
+
+    /// constructor
+    ReplicationSnapshot();
+
+    /// capture all replicated components of a world, unmodified rows are copied from previous if not null
+    void Capture(World* world, uint32_t tick, float cellSize, const ReplicationSnapshot* previous);
+    /// clear the snapshot
+    void Clear();
+
+    /// find or add the layout of a list of components
+    IndexT AddLayout(const Util::Array<ComponentId>& components);
+    /// find the layout of a list of components, returns InvalidIndex if not found
+    IndexT FindLayout(const Util::Array<ComponentId>& components) const;
+    /// find a record by entity id, returns InvalidIndex if not found
+    IndexT FindRecord(uint32_t entity) const;
+    /// read a dequantized component value of a record, returns false if the record doesn't have the component
+    bool ReadComponent(IndexT record, ComponentId component, void* value) const;
+
+    /// pack the cell of a position into 16 bits per axis
+    static uint32_t PackCell(const Math::vec3& position, float cellSize);
+    /// returns true if two packed cells are at most radius cells apart in x and z
+    static bool InRange(uint32_t cell, uint32_t center, int radius);
+    /// quantize a single word
+    static uint32_t QuantizeWord(uint32_t word, const ComponentInterface::FieldQuantization& quantization);
+    /// dequantize a single word
+    static uint32_t DequantizeWord(uint32_t word, const ComponentInterface::FieldQuantization& quantization);
+    /// number of words used by a component
+    static SizeT GetNumWords(ComponentId component);
+
+    uint32_t tick;
+    Util::Array<Layout> layouts;
+    Util::Array<Record> records;
+    Util::Array<uint32_t> words;
+};
+
+} // namespace Game
@@ -257,8 +257,10 @@ template <typename COMPONENT_TYPE>
 ComponentId 
 RegisterType(ComponentRegisterInfo<COMPONENT_TYPE> info)
 {
+    n_assert2(!info.replicate || sizeof(COMPONENT_TYPE) <= MaxReplicatedComponentSize, "component is too large to be replicated");
     uint32_t componentFlags = 0;
     componentFlags |= (uint32_t)COMPONENTFLAG_DECAY * (uint32_t)info.decay;
+    componentFlags |= (uint32_t)COMPONENTFLAG_REPLICATE * (uint32_t)info.replicate;
 
     ComponentInterface* cInterface = new ComponentInterface(
         COMPONENT_TYPE::Traits::name,
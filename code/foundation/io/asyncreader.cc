@@ -0,0 +1,299 @@
+//------------------------------------------------------------------------------
+//  asyncreader.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "foundation/stdneb.h"
+#include "io/asyncreader.h"
+
+namespace IO
+{
+__ImplementClass(IO::AsyncReader, 'ASRD', Core::RefCounted);
+__ImplementInterfaceSingleton(IO::AsyncReader);
+
+//------------------------------------------------------------------------------
+/**
+*/
+AsyncReader::AsyncReader() :
+    isKernelQueue(false),
+    outstanding(0),
+    idleEvent(true),
+    numReads(0),
+    numBytesRead(0)
+{
+    __ConstructInterfaceSingleton;
+    this->idleEvent.Signal();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+AsyncReader::~AsyncReader()
+{
+    n_assert(this->threads.IsEmpty());
+    IndexT i;
+    for (i = 0; i < this->requestPool.Size(); i++)
+    {
+        delete this->requestPool[i];
+    }
+    this->requestPool.Clear();
+    __DestructInterfaceSingleton;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AsyncReader::Setup(SizeT queueDepth, SizeT numThreads)
+{
+    n_assert(this->threads.IsEmpty());
+    this->isKernelQueue = AsyncReaderImpl::Setup(this->platform, queueDepth);
+
+    // the kernel queue only needs a thread to run completions
+    SizeT numReaderThreads = this->isKernelQueue ? 1 : Math::max(numThreads, 1);
+    IndexT i;
+    for (i = 0; i < numReaderThreads; i++)
+    {
+        Ptr<AsyncReaderThread> thread = AsyncReaderThread::Create();
+        thread->reader = this;
+        if (this->isKernelQueue)
+            thread->SetName("AsyncReader Completion Thread");
+        else
+            thread->SetName(Util::String::Sprintf("AsyncReader Thread #%d", i));
+        thread->Start();
+        this->threads.Append(thread);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AsyncReader::Discard()
+{
+    this->idleEvent.Wait();
+    IndexT i;
+    for (i = 0; i < this->threads.Size(); i++)
+    {
+        this->threads[i]->Stop();
+    }
+    this->threads.Clear();
+
+    if (this->isKernelQueue)
+    {
+        AsyncReaderImpl::Discard(this->platform);
+        this->isKernelQueue = false;
+    }
+    this->registeredBuffers.Clear();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AsyncReader::Submit(const Ptr<Stream>& stream, FSWrapper::Handle handle, const Stream::AsyncRead* reads, SizeT numReads)
+{
+    n_assert(!this->threads.IsEmpty());
+    if (numReads == 0)
+        return;
+
+    this->lock.Enter();
+    IndexT i;
+    for (i = 0; i < numReads; i++)
+    {
+        AsyncReadRequest* request = this->AllocRequest();
+        request->stream = stream;
+        request->handle = handle;
+        request->read = reads[i];
+        request->bytesRead = 0;
+        request->bufferIndex = InvalidIndex;
+
+        // reads which fall entirely within a registered buffer use it
+        if (this->isKernelQueue)
+        {
+            const char* begin = (const char*)reads[i].buffer;
+            const char* end = begin + reads[i].numBytes;
+            IndexT j;
+            for (j = 0; j < this->registeredBuffers.Size(); j++)
+            {
+                const char* buffer = (const char*)this->registeredBuffers[j].first;
+                if (begin >= buffer && end <= buffer + this->registeredBuffers[j].second)
+                {
+                    request->bufferIndex = j;
+                    break;
+                }
+            }
+        }
+        this->pending.Enqueue(request);
+    }
+    if (this->outstanding == 0)
+        this->idleEvent.Reset();
+    this->outstanding += numReads;
+
+    Util::Array<AsyncReadRequest*> failed;
+    if (this->isKernelQueue)
+    {
+        AsyncReaderImpl::Submit(this, failed);
+    }
+    this->lock.Leave();
+
+    // reads the kernel queue refused are completed as failed reads
+    for (i = 0; i < failed.Size(); i++)
+    {
+        this->Finish(failed[i], failed[i]->bytesRead);
+    }
+
+    if (!this->isKernelQueue)
+    {
+        for (i = 0; i < this->threads.Size(); i++)
+        {
+            this->threads[i]->EmitWakeupSignal();
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AsyncReader::RegisterBuffer(void* buffer, SizeT size)
+{
+    this->lock.Enter();
+    n_assert(this->outstanding == 0);
+    this->registeredBuffers.Append(Util::MakePair(buffer, size));
+    if (this->isKernelQueue && !AsyncReaderImpl::RegisterBuffers(this))
+    {
+        n_warning("AsyncReader: failed to register buffers, using regular reads\n");
+        this->registeredBuffers.Clear();
+    }
+    this->lock.Leave();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AsyncReader::UnregisterBuffer(void* buffer)
+{
+    this->lock.Enter();
+    n_assert(this->outstanding == 0);
+    IndexT i;
+    for (i = 0; i < this->registeredBuffers.Size(); i++)
+    {
+        if (this->registeredBuffers[i].first == buffer)
+        {
+            this->registeredBuffers.EraseIndex(i);
+            if (this->isKernelQueue && !AsyncReaderImpl::RegisterBuffers(this))
+            {
+                this->registeredBuffers.Clear();
+            }
+            break;
+        }
+    }
+    this->lock.Leave();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+AsyncReader::ReadNext()
+{
+    this->lock.Enter();
+    if (this->pending.IsEmpty())
+    {
+        this->lock.Leave();
+        return false;
+    }
+    AsyncReadRequest* request = this->pending.Dequeue();
+    this->lock.Leave();
+
+    const Stream::AsyncRead& read = request->read;
+    Stream::Size bytesRead = FSWrapper::ReadAt(request->handle, read.buffer, read.numBytes, read.offset);
+    this->Finish(request, bytesRead);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AsyncReader::Finish(AsyncReadRequest* request, Stream::Size bytesRead)
+{
+    Threading::Interlocked::Increment(&this->numReads);
+    Threading::Interlocked::Add(&this->numBytesRead, (int64)bytesRead);
+    Stream::FinishAsyncRead(request->read, bytesRead);
+
+    // release the stream and callback before the request goes back to the pool
+    request->stream = nullptr;
+    request->read = Stream::AsyncRead();
+
+    this->lock.Enter();
+    this->requestPool.Append(request);
+    this->outstanding--;
+    if (this->outstanding == 0)
+        this->idleEvent.Signal();
+    this->lock.Leave();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Must be called within the lock.
+*/
+AsyncReadRequest*
+AsyncReader::AllocRequest()
+{
+    if (this->requestPool.IsEmpty())
+    {
+        return new AsyncReadRequest;
+    }
+    AsyncReadRequest* request = this->requestPool.Back();
+    this->requestPool.EraseBack();
+    return request;
+}
+
+__ImplementClass(IO::AsyncReaderThread, 'ASRT', Threading::Thread);
+//------------------------------------------------------------------------------
+/**
+*/
+AsyncReaderThread::AsyncReaderThread() :
+    reader(nullptr)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AsyncReaderThread::DoWork()
+{
+    while (!this->ThreadStopRequested())
+    {
+        if (this->reader->isKernelQueue)
+        {
+            AsyncReaderImpl::Complete(this->reader);
+        }
+        else if (!this->reader->ReadNext())
+        {
+            this->wakeupEvent.Wait();
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AsyncReaderThread::EmitWakeupSignal()
+{
+    if (this->reader->isKernelQueue)
+    {
+        AsyncReaderImpl::Wake(this->reader);
+    }
+    else
+    {
+        this->wakeupEvent.Signal();
+    }
+}
+
+} // namespace IO
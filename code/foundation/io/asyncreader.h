@@ -0,0 +1,159 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class IO::AsyncReader
+
+    Services the asynchronous reads of file streams (see Stream::ReadAsync).
+
+    On Linux, reads are submitted in batches to an io_uring and completed by a
+    dedicated thread. Reads into buffers registered with RegisterBuffer are issued
+    as fixed buffer reads, which spares the kernel from pinning the pages for every
+    read. Everywhere else, or if the kernel doesn't provide io_uring, reads are
+    performed by a pool of threads.
+
+    Completion callbacks run on the reader threads, so keep them short.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "core/refcounted.h"
+#include "core/singleton.h"
+#include "io/stream.h"
+#include "io/fswrapper.h"
+#include "threading/thread.h"
+#include "threading/event.h"
+#include "threading/criticalsection.h"
+#include "util/queue.h"
+#include "util/tupleutility.h"
+#if __WIN32__
+#include "io/win32/win32asyncreader.h"
+#elif __linux__
+#include "io/posix/linuxasyncreader.h"
+#else
+#error "not implemented"
+#endif
+
+//------------------------------------------------------------------------------
+namespace IO
+{
+
+/// a read in flight
+struct AsyncReadRequest
+{
+    Ptr<Stream> stream;
+    FSWrapper::Handle handle;
+    Stream::AsyncRead read;
+    Stream::Size bytesRead;
+    IndexT bufferIndex;
+    AsyncReadRequestPlatform platform;
+};
+
+class AsyncReaderThread;
+class AsyncReader : public Core::RefCounted
+{
+    __DeclareClass(AsyncReader);
+    __DeclareInterfaceSingleton(AsyncReader);
+public:
+    /// constructor
+    AsyncReader();
+    /// destructor
+    virtual ~AsyncReader();
+
+    /// setup reader, queueDepth is the max number of reads in flight in the kernel queue
+    void Setup(SizeT queueDepth = 256, SizeT numThreads = 4);
+    /// wait for reads in flight and stop threads
+    void Discard();
+    /// return true if reads are serviced by the kernel queue rather than the thread pool
+    bool IsKernelQueue() const;
+
+    /// submit a batch of reads from a file, the stream is kept alive until all reads are done
+    void Submit(const Ptr<Stream>& stream, FSWrapper::Handle handle, const Stream::AsyncRead* reads, SizeT numReads);
+
+    /// register a buffer for fixed buffer reads, must not be called with reads in flight
+    void RegisterBuffer(void* buffer, SizeT size);
+    /// unregister a buffer, must not be called with reads in flight
+    void UnregisterBuffer(void* buffer);
+
+    /// get total number of reads serviced
+    uint64 GetNumReads() const;
+    /// get total number of bytes read
+    uint64 GetNumBytesRead() const;
+
+private:
+    friend class AsyncReaderThread;
+    friend class AsyncReaderImpl;
+
+    /// perform a read on a pool thread, returns false if there was nothing to read
+    bool ReadNext();
+    /// complete a request
+    void Finish(AsyncReadRequest* request, Stream::Size bytesRead);
+    /// hand out request from the pool
+    AsyncReadRequest* AllocRequest();
+
+    bool isKernelQueue;
+    AsyncReaderPlatform platform;
+    Util::Array<Ptr<AsyncReaderThread>> threads;
+
+    Util::Array<AsyncReadRequest*> requestPool;
+    Util::Queue<AsyncReadRequest*> pending;
+    Util::Array<Util::Pair<void*, SizeT>> registeredBuffers;
+    SizeT outstanding;
+    Threading::CriticalSection lock;
+    Threading::Event idleEvent;
+
+    Threading::AtomicCounter64 numReads;
+    Threading::AtomicCounter64 numBytesRead;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+AsyncReader::IsKernelQueue() const
+{
+    return this->isKernelQueue;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline uint64
+AsyncReader::GetNumReads() const
+{
+    return this->numReads;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline uint64
+AsyncReader::GetNumBytesRead() const
+{
+    return this->numBytesRead;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Reads on the thread pool, or completions of the kernel queue.
+*/
+class AsyncReaderThread : public Threading::Thread
+{
+    __DeclareClass(AsyncReaderThread);
+public:
+    /// constructor
+    AsyncReaderThread();
+
+private:
+    friend class AsyncReader;
+
+    /// this method runs in the thread context
+    void DoWork() override;
+    /// emit wakeup signal
+    void EmitWakeupSignal() override;
+
+    AsyncReader* reader;
+    Threading::Event wakeupEvent;
+};
+
+} // namespace IO
+//------------------------------------------------------------------------------
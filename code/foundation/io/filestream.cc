@@ -5,6 +5,7 @@
 //------------------------------------------------------------------------------
 
 #include "io/filestream.h"
+#include "io/asyncreader.h"
 
 namespace IO
 {
@@ -167,6 +168,35 @@ FileStream::Read(void* ptr, Size numBytes)
     return FSWrapper::Read(this->handle, ptr, numBytes);
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+FileStream::CanReadAsync() const
+{
+    return AsyncReader::HasInstance();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Reads are positional and don't move the file pointer, the stream must be
+    kept open until all reads are done.
+*/
+void
+FileStream::ReadAsyncBatch(const AsyncRead* reads, SizeT numReads)
+{
+    n_assert(this->IsOpen());
+    n_assert(0 != this->handle);
+    if (AsyncReader::HasInstance())
+    {
+        AsyncReader::Instance()->Submit(this, this->handle, reads, numReads);
+    }
+    else
+    {
+        Stream::ReadAsyncBatch(reads, numReads);
+    }
+}
+
 //------------------------------------------------------------------------------
 /**
 */
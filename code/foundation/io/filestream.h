@@ -43,6 +43,10 @@ public:
     virtual void Write(const void* ptr, Size numBytes) override;
     /// directly read from the stream
     virtual Size Read(void* ptr, Size numBytes) override;
+    /// return true if reads are handed to the AsyncReader
+    virtual bool CanReadAsync() const override;
+    /// read byte ranges through the AsyncReader
+    virtual void ReadAsyncBatch(const AsyncRead* reads, SizeT numReads) override;
     /// seek in stream
     virtual void Seek(Offset offset, SeekOrigin origin) override;
     /// flush unsaved data
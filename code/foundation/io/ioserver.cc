@@ -13,6 +13,7 @@
 #include "io/assignregistry.h"
 #include "io/archfs/archive.h"
 #include "io/archfs/archivefilesystem.h"
+#include "io/packfs/packfilesystem.h"
 #include "io/filewatcher.h"
 #include "io/filestream.h"
 #include <filesystem>
@@ -79,6 +80,15 @@ IoServer::IoServer() :
     {
         this->archiveFileSystem = ArchiveFileSystem::Instance();
     }
+    if (!PackFileSystem::HasInstance())
+    {
+        this->packFileSystem = PackFileSystem::Create();
+        this->packFileSystem->Setup(Math::clamp(System::NumCpuCores - 1, 0, 4));
+    }
+    else
+    {
+        this->packFileSystem = PackFileSystem::Instance();
+    }
     this->archiveCriticalSection.Leave();
 
     this->watcherCriticalSection.Enter();
@@ -116,6 +126,7 @@ IoServer::~IoServer()
         this->UnmountStandardArchives();
     }
     this->archiveFileSystem = nullptr;
+    this->packFileSystem = nullptr;
     this->assignRegistry = nullptr;
     this->schemeRegistry = nullptr;
 
@@ -145,10 +156,14 @@ IoServer::CreateStream(const URI& uri) const
         }
     }
 #endif
-    // check if the URI points into a mounted archive
+    // check if the URI points into a mounted archive, pack archives take precedence
     if (this->IsArchiveFileSystemEnabled())
     {
-        URI newUri = ArchiveFileSystem::Instance()->ConvertFileToArchiveURIIfExists(uri);
+        URI newUri = this->packFileSystem->ConvertFileToPackURIIfExists(uri);
+        if (newUri.Scheme() != "pack")
+        {
+            newUri = ArchiveFileSystem::Instance()->ConvertFileToArchiveURIIfExists(uri);
+        }
         Ptr<Stream> stream = (Stream*) schemeRegistry->GetStreamClassByUriScheme(newUri.Scheme()).Create();
         stream->SetURI(newUri);
         return stream;
@@ -167,6 +182,10 @@ IoServer::CreateStream(const URI& uri) const
 bool
 IoServer::MountArchive(const URI& uri)
 {
+    if (PackFileSystem::ArchiveExists(uri))
+    {
+        return this->packFileSystem->Mount(uri).isvalid();
+    }
     Ptr<Archive> archive = this->archiveFileSystem->Mount(uri);
     return archive.isvalid();
 }
@@ -188,6 +207,11 @@ IoServer::MountEmbeddedArchive(const URI& uri)
 void
 IoServer::UnmountArchive(const URI& uri)
 {
+    if (this->packFileSystem->IsMounted(uri))
+    {
+        this->packFileSystem->Unmount(uri);
+        return;
+    }
     this->archiveFileSystem->Unmount(uri);
 }
 
@@ -197,7 +221,7 @@ IoServer::UnmountArchive(const URI& uri)
 bool
 IoServer::IsArchiveMounted(const URI& uri) const
 {
-    return this->archiveFileSystem->IsMounted(uri);
+    return this->packFileSystem->IsMounted(uri) || this->archiveFileSystem->IsMounted(uri);
 }
 
 //------------------------------------------------------------------------------
@@ -300,7 +324,11 @@ IoServer::CopyFile(const URI& fromUri, const URI& toUri) const
     URI srcUri;
     if (this->IsArchiveFileSystemEnabled())
     {
-        srcUri = ArchiveFileSystem::Instance()->ConvertFileToArchiveURIIfExists(fromUri);
+        srcUri = this->packFileSystem->ConvertFileToPackURIIfExists(fromUri);
+        if (srcUri.Scheme() != "pack")
+        {
+            srcUri = ArchiveFileSystem::Instance()->ConvertFileToArchiveURIIfExists(fromUri);
+        }
     }
     else
     {
@@ -416,6 +444,10 @@ IoServer::FileExists(const URI& uri) const
     // transparent archive support
     if (this->IsArchiveFileSystemEnabled())
     {
+        if (this->packFileSystem->HasArchives() && this->packFileSystem->FindArchiveWithFile(uri).isvalid())
+        {
+            return true;
+        }
         Ptr<Archive> archive = ArchiveFileSystem::Instance()->FindArchiveWithFile(uri);
         if (archive.isvalid())
         {
@@ -440,6 +472,10 @@ IoServer::DirectoryExists(const URI& uri) const
     {
         if (uri.Scheme() == "file")
         {
+            if (this->packFileSystem->HasArchives() && this->packFileSystem->FindArchiveWithDir(uri).isvalid())
+            {
+                return true;
+            }
             Ptr<Archive> archive = ArchiveFileSystem::Instance()->FindArchiveWithDir(uri);
             if (archive.isvalid())
             {
@@ -477,7 +513,11 @@ IoServer::IsReadOnly(const URI& uri) const
     // transparent archive file system support
     if (this->IsArchiveFileSystemEnabled())
     {
-        URI arcUri = ArchiveFileSystem::Instance()->ConvertFileToArchiveURIIfExists(uri);
+        URI arcUri = this->packFileSystem->ConvertFileToPackURIIfExists(uri);
+        if (arcUri.Scheme() == "file")
+        {
+            arcUri = ArchiveFileSystem::Instance()->ConvertFileToArchiveURIIfExists(uri);
+        }
         if (arcUri.Scheme() != "file")
         {
             // file exists in archive, archives are generally read only
@@ -547,8 +587,14 @@ IoServer::ListFiles(const URI& uri, const String& pattern, bool asFullPath) cons
     // transparent archive file system support
     if (this->IsArchiveFileSystemEnabled())
     {
-        Ptr<Archive> archive = ArchiveFileSystem::Instance()->FindArchiveWithDir(uri);
-        if (archive.isvalid())
+        Ptr<PackArchive> packArchive = this->packFileSystem->HasArchives() ? this->packFileSystem->FindArchiveWithDir(uri) : nullptr;
+        Ptr<Archive> archive = packArchive.isvalid() ? nullptr : ArchiveFileSystem::Instance()->FindArchiveWithDir(uri);
+        if (packArchive.isvalid())
+        {
+            String pathInArchive = packArchive->ConvertToPathInArchive(uri.LocalPath());
+            result = packArchive->ListFiles(pathInArchive, pattern);
+        }
+        else if (archive.isvalid())
         {
             String pathInArchive = archive->ConvertToPathInArchive(uri.LocalPath());
             result = archive->ListFiles(pathInArchive, pattern);
@@ -585,6 +631,17 @@ IoServer::ListDirectories(const URI& uri, const String& pattern, bool asFullPath
     // transparent archive file system support
     if (this->IsArchiveFileSystemEnabled() && prioritizeArchive)
     {
+        Ptr<PackArchive> packArchive = this->packFileSystem->HasArchives() ? this->packFileSystem->FindArchiveWithDir(uri) : nullptr;
+        if (packArchive.isvalid())
+        {
+            String pathInArchive = packArchive->ConvertToPathInArchive(uri.LocalPath());
+            result = packArchive->ListDirectories(pathInArchive, pattern);
+            if (asFullPath)
+            {
+                result = this->AddPathPrefixToArray(uri.LocalPath(), result);
+            }
+            return result;
+        }
         Ptr<Archive> archive = ArchiveFileSystem::Instance()->FindArchiveWithDir(uri);
         if (archive.isvalid())
         {
@@ -34,6 +34,7 @@ namespace Http
 namespace IO
 {
 class ArchiveFileSystem;
+class PackFileSystem;
 class FileWatcher;
 class Stream;
 class URI;
@@ -112,6 +113,7 @@ private:
 
     bool archiveFileSystemEnabled;    
     Ptr<ArchiveFileSystem> archiveFileSystem;
+    Ptr<PackFileSystem> packFileSystem;
     static Threading::CriticalSection archiveCriticalSection;
     static bool StandardArchivesMounted;
     
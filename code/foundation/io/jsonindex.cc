@@ -0,0 +1,794 @@
+//------------------------------------------------------------------------------
+//  jsonindex.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "io/jsonindex.h"
+#include "util/bit.h"
+#include <charconv>
+#include <cstdlib>
+
+namespace IO
+{
+
+//------------------------------------------------------------------------------
+/**
+    Bit masks of the characters of a 64 byte block, bit n is set if
+    character n matches.
+*/
+struct JsonBlockMasks
+{
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t op;
+    uint64_t whitespace;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline uint64_t
+CompareMask(__m128i chars, char c)
+{
+    return (uint)_mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8(c)));
+}
+
+//------------------------------------------------------------------------------
+/**
+    Setting bit 5 turns [ and ] into { and }, which saves two compares.
+*/
+static inline void
+ClassifyBlock(const char* block, JsonBlockMasks& masks)
+{
+    masks.quote = masks.backslash = masks.op = masks.whitespace = 0;
+    int i;
+    for (i = 0; i < 4; i++)
+    {
+        const __m128i chars = _mm_loadu_si128((const __m128i*)(block + i * 16));
+        const __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+        const int shift = i * 16;
+        masks.quote |= CompareMask(chars, '"') << shift;
+        masks.backslash |= CompareMask(chars, '\\') << shift;
+        masks.op |= (CompareMask(lower, '{') | CompareMask(lower, '}') | CompareMask(chars, ':') | CompareMask(chars, ',')) << shift;
+        masks.whitespace |= (CompareMask(chars, ' ') | CompareMask(chars, '\t') | CompareMask(chars, '\n') | CompareMask(chars, '\r')) << shift;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Find characters escaped by a backslash. Only backslash sequences of odd
+    length escape the following character, prevEscaped carries an escape
+    over to the next block.
+*/
+static inline uint64_t
+FindEscaped(uint64_t backslash, uint64_t& prevEscaped)
+{
+    const uint64_t evenBits = 0x5555555555555555ull;
+    backslash &= ~prevEscaped;
+    const uint64_t followsEscape = (backslash << 1) | prevEscaped;
+    const uint64_t oddSequenceStarts = backslash & ~evenBits & ~followsEscape;
+    const uint64_t sequencesStartingOnEvenBits = oddSequenceStarts + backslash;
+    prevEscaped = sequencesStartingOnEvenBits < oddSequenceStarts ? 1 : 0;
+    const uint64_t invertMask = sequencesStartingOnEvenBits << 1;
+    return (evenBits ^ invertMask) & followsEscape;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Set every bit which has an odd number of bits set at or below it, which
+    turns quote positions into a mask of string contents.
+*/
+static inline uint64_t
+PrefixXor(uint64_t bits)
+{
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline bool
+IsWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline bool
+IsDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+//------------------------------------------------------------------------------
+/**
+    Matches -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)? over the whole
+    length.
+*/
+static bool
+ValidateNumber(const char* str, SizeT length)
+{
+    const char* cur = str;
+    const char* end = str + length;
+    if (cur < end && *cur == '-')
+    {
+        cur++;
+    }
+    if (cur == end || !IsDigit(*cur))
+    {
+        return false;
+    }
+    if (*cur++ != '0')
+    {
+        while (cur < end && IsDigit(*cur))
+        {
+            cur++;
+        }
+    }
+    if (cur < end && *cur == '.')
+    {
+        cur++;
+        if (cur == end || !IsDigit(*cur))
+        {
+            return false;
+        }
+        while (cur < end && IsDigit(*cur))
+        {
+            cur++;
+        }
+    }
+    if (cur < end && (*cur == 'e' || *cur == 'E'))
+    {
+        cur++;
+        if (cur < end && (*cur == '+' || *cur == '-'))
+        {
+            cur++;
+        }
+        if (cur == end || !IsDigit(*cur))
+        {
+            return false;
+        }
+        while (cur < end && IsDigit(*cur))
+        {
+            cur++;
+        }
+    }
+    return cur == end;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+JsonIndex::JsonIndex() :
+    json(nullptr),
+    size(0),
+    error(nullptr),
+    errorOffset(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+JsonIndex::Parse(const char* json, SizeT size)
+{
+    n_assert(json != nullptr);
+    n_assert(size >= 0);
+    this->json = json;
+    this->size = size;
+    this->error = nullptr;
+    this->errorOffset = 0;
+    if (!this->FindStructurals())
+    {
+        return false;
+    }
+    return this->LinkContainers();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+JsonIndex::Clear()
+{
+    this->json = nullptr;
+    this->size = 0;
+    this->structurals = Util::Array<uint32_t>();
+    this->links = Util::Array<uint32_t>();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+JsonIndex::GetMemorySize() const
+{
+    return (this->structurals.Capacity() + this->links.Capacity()) * sizeof(uint32_t);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Stage one, classifies 64 characters at a time. Structurals are the
+    operators outside of strings, plus every character which starts a
+    value: opening quotes, and the first character of numbers and literals.
+    Everything inside strings is skipped, which makes the second pass see
+    exactly one entry per token.
+*/
+bool
+JsonIndex::FindStructurals()
+{
+    this->structurals.Resize(this->size / 8 + 64);
+    SizeT count = 0;
+    uint64_t prevEscaped = 0;
+    uint64_t prevInString = 0;
+    uint64_t prevScalar = 0;
+    char tail[64];
+
+    SizeT offset;
+    for (offset = 0; offset < this->size; offset += 64)
+    {
+        // pad the last block with whitespace instead of reading past the buffer
+        const char* block = this->json + offset;
+        if (this->size - offset < 64)
+        {
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, block, this->size - offset);
+            block = tail;
+        }
+
+        JsonBlockMasks masks;
+        ClassifyBlock(block, masks);
+
+        // the in string mask covers the opening quote and the contents, but not the closing quote
+        const uint64_t quote = masks.quote & ~FindEscaped(masks.backslash, prevEscaped);
+        const uint64_t inString = PrefixXor(quote) ^ prevInString;
+        prevInString = uint64_t(int64_t(inString) >> 63);
+
+        // a value starts at a character which is neither an operator nor whitespace, and doesn't follow one
+        const uint64_t op = masks.op & ~inString;
+        const uint64_t scalar = ~(op | (masks.whitespace & ~inString));
+        const uint64_t nonQuoteScalar = scalar & ~quote;
+        const uint64_t followsScalar = (nonQuoteScalar << 1) | prevScalar;
+        prevScalar = nonQuoteScalar >> 63;
+        uint64_t bits = (op | (scalar & ~followsScalar)) & ~(inString ^ quote);
+
+        if (count + 64 > this->structurals.Size())
+        {
+            this->structurals.Resize(this->structurals.Size() * 2);
+        }
+        uint32_t* out = this->structurals.Begin() + count;
+        while (bits != 0)
+        {
+            *out++ = uint32_t(offset + Util::FirstOne(bits));
+            bits &= bits - 1;
+        }
+        count = SizeT(out - this->structurals.Begin());
+    }
+
+    // terminate with the end of the buffer, so every value has a successor
+    this->structurals.Resize(count + 1);
+    this->structurals[count] = uint32_t(this->size);
+    this->structurals.Fit();
+    if (prevInString != 0)
+    {
+        this->error = "unterminated string";
+        this->errorOffset = count > 0 ? this->structurals[count - 1] : 0;
+        return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Stage two, walks the structurals once with a stack of open brackets.
+    While a container is open, its link counts the commas, and is replaced
+    by the index of the closing bracket when the container is closed. The
+    closing bracket's link gets the number of children.
+*/
+bool
+JsonIndex::LinkContainers()
+{
+    const SizeT num = this->structurals.Size() - 1;
+    if (num == 0)
+    {
+        return this->SetError("empty document", 0);
+    }
+    this->links.Resize(num);
+
+    enum State
+    {
+        Value,          // any value
+        FirstElement,   // value or ]
+        FirstKey,       // key or }
+        Key,            // key
+        Colon,          // colon after key
+        Next,           // comma or closing bracket
+    };
+    State state = Value;
+    Util::Array<uint32_t> stack;
+    IndexT i;
+    for (i = 0; i < num; i++)
+    {
+        const char c = this->At(i);
+        bool close = false;
+        switch (state)
+        {
+            case FirstKey:
+                if (c == '}')
+                {
+                    close = true;
+                    break;
+                }
+                // fall through
+            case Key:
+                if (c != '"')
+                {
+                    return this->SetError("expected key", i);
+                }
+                if (!this->ValidateScalar(i))
+                {
+                    return false;
+                }
+                state = Colon;
+                break;
+            case Colon:
+                if (c != ':')
+                {
+                    return this->SetError("expected ':'", i);
+                }
+                state = Value;
+                break;
+            case FirstElement:
+                if (c == ']')
+                {
+                    close = true;
+                    break;
+                }
+                // fall through
+            case Value:
+                if (c == '{' || c == '[')
+                {
+                    stack.Append(i);
+                    this->links[i] = 0;
+                    state = (c == '{') ? FirstKey : FirstElement;
+                }
+                else if (c == '}' || c == ']' || c == ':' || c == ',')
+                {
+                    return this->SetError("expected value", i);
+                }
+                else if (!this->ValidateScalar(i))
+                {
+                    return false;
+                }
+                else
+                {
+                    state = Next;
+                }
+                break;
+            case Next:
+                if (stack.IsEmpty())
+                {
+                    return this->SetError("unexpected data after root value", i);
+                }
+                if (c == ',')
+                {
+                    this->links[stack.Back()]++;
+                    state = (this->At(stack.Back()) == '{') ? Key : Value;
+                }
+                else if ((c == '}' && this->At(stack.Back()) == '{') || (c == ']' && this->At(stack.Back()) == '['))
+                {
+                    close = true;
+                }
+                else
+                {
+                    return this->SetError("expected ',' or closing bracket", i);
+                }
+                break;
+        }
+
+        if (close)
+        {
+            const IndexT open = stack.Back();
+            stack.EraseBack();
+            this->links[i] = (open + 1 == i) ? 0 : this->links[open] + 1;
+            this->links[open] = i;
+            state = Next;
+        }
+    }
+
+    if (!stack.IsEmpty())
+    {
+        return this->SetError("unclosed bracket", stack.Back());
+    }
+    if (state != Next)
+    {
+        return this->SetError("unexpected end of document", num);
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Checks a string, literal or number against the json grammar, and sets
+    the parse error if it doesn't match. Strings are only checked for raw
+    control characters, their escapes are resolved when they are read.
+*/
+bool
+JsonIndex::ValidateScalar(IndexT value)
+{
+    const SizeT start = this->structurals[value];
+    const SizeT length = this->ScalarEnd(value) - start;
+    const char* str = this->json + start;
+    bool valid = true;
+    switch (str[0])
+    {
+        case '"':
+        {
+            if (length < 2 || str[length - 1] != '"')
+            {
+                return this->SetError("invalid string", value);
+            }
+            SizeT i;
+            for (i = 1; i < length - 1; i++)
+            {
+                if (uchar(str[i]) < 0x20)
+                {
+                    return this->SetError("control character in string", value);
+                }
+            }
+            return true;
+        }
+        case 't':
+            valid = length == 4 && memcmp(str, "true", 4) == 0;
+            break;
+        case 'f':
+            valid = length == 5 && memcmp(str, "false", 5) == 0;
+            break;
+        case 'n':
+            valid = length == 4 && memcmp(str, "null", 4) == 0;
+            break;
+        default:
+            if (!ValidateNumber(str, length))
+            {
+                return this->SetError("invalid number", value);
+            }
+            return true;
+    }
+    if (!valid)
+    {
+        return this->SetError("invalid literal", value);
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+JsonIndex::SetError(const char* msg, IndexT structural)
+{
+    this->error = msg;
+    this->errorOffset = this->structurals[structural];
+    return false;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+JsonIndex::ScalarEnd(IndexT value) const
+{
+    const SizeT start = this->structurals[value];
+    SizeT end = this->structurals[value + 1];
+    while (end > start + 1 && IsWhitespace(this->json[end - 1]))
+    {
+        end--;
+    }
+    return end;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+JsonIndex::Type
+JsonIndex::GetType(IndexT value) const
+{
+    switch (this->At(value))
+    {
+        case '{': return Object;
+        case '[': return Array;
+        case '"': return String;
+        case 't':
+        case 'f': return Bool;
+        case 'n': return Null;
+        default:
+        {
+            const Util::StringView raw = this->GetRaw(value);
+            IndexT i;
+            for (i = 0; i < raw.Length(); i++)
+            {
+                const char c = raw[i];
+                if (c == '.' || c == 'e' || c == 'E')
+                {
+                    return Double;
+                }
+            }
+            return Int;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+IndexT
+JsonIndex::GetChildAt(IndexT value, IndexT childIndex) const
+{
+    if (childIndex < 0 || childIndex >= this->Size(value))
+    {
+        return InvalidIndex;
+    }
+    IndexT child = this->GetFirstChild(value);
+    IndexT i;
+    for (i = 0; i < childIndex; i++)
+    {
+        child = this->GetNextSibling(child);
+    }
+    return child;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Keys are compared as they appear in the json, only keys containing
+    escape sequences are unescaped first.
+*/
+IndexT
+JsonIndex::FindChild(IndexT object, const Util::StringView& key, IndexT* outChildIndex) const
+{
+    n_assert(this->IsObject(object));
+    IndexT childIndex = 0;
+    IndexT child;
+    for (child = this->GetFirstChild(object); child != InvalidIndex; child = this->GetNextSibling(child), childIndex++)
+    {
+        const Util::StringView rawKey = this->GetRawKey(child);
+        bool found = rawKey == key;
+        if (!found && rawKey.Length() > key.Length() && rawKey.FindCharIndex('\\') != InvalidIndex)
+        {
+            found = this->GetKey(child) == key;
+        }
+        if (found)
+        {
+            if (outChildIndex != nullptr)
+            {
+                *outChildIndex = childIndex;
+            }
+            return child;
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Util::String
+JsonIndex::GetKey(IndexT child) const
+{
+    Util::String result;
+    Unescape(this->GetRawKey(child), result);
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Util::String
+JsonIndex::GetString(IndexT value) const
+{
+    n_assert(this->IsString(value));
+    const SizeT start = this->structurals[value] + 1;
+    Util::String result;
+    Unescape(Util::StringView(this->json + start, this->ScalarEnd(value) - 1 - start), result);
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Unescapes the string into the builder instead of allocating a String,
+    the returned view is zero terminated and valid until the builder is reset.
+*/
+Util::StringView
+JsonIndex::GetString(IndexT value, Util::StringBuilder& builder) const
+{
+    n_assert(this->IsString(value));
+    const SizeT start = this->structurals[value] + 1;
+    return Unescape(Util::StringView(this->json + start, this->ScalarEnd(value) - 1 - start), builder);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+int64_t
+JsonIndex::GetInt64(IndexT value) const
+{
+    n_assert(this->IsNumeric(value));
+    if (this->IsDouble(value))
+    {
+        return (int64_t)this->GetDouble(value);
+    }
+    const Util::StringView raw = this->GetRaw(value);
+    int64_t result = 0;
+    const std::from_chars_result res = std::from_chars(raw.Data(), raw.End(), result);
+    n_assert2(res.ec == std::errc() && res.ptr == raw.End(), "JsonIndex: invalid integer");
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Floating point from_chars is missing from older standard libraries,
+    which fall back to strtod on a zero terminated copy of the number.
+*/
+double
+JsonIndex::GetDouble(IndexT value) const
+{
+    n_assert(this->IsNumeric(value));
+    const Util::StringView raw = this->GetRaw(value);
+#if defined(__cpp_lib_to_chars)
+    double result = 0.0;
+    const std::from_chars_result res = std::from_chars(raw.Data(), raw.End(), result);
+    n_assert2(res.ec == std::errc() && res.ptr == raw.End(), "JsonIndex: invalid number");
+    return result;
+#else
+    char buf[64];
+    Util::String longNumber;
+    const char* str = buf;
+    if (raw.Length() < (SizeT)sizeof(buf))
+    {
+        Memory::Copy(raw.Data(), buf, raw.Length());
+        buf[raw.Length()] = 0;
+    }
+    else
+    {
+        longNumber.Set(raw.Data(), raw.Length());
+        str = longNumber.AsCharPtr();
+    }
+    char* end = nullptr;
+    const double result = strtod(str, &end);
+    n_assert2(end == str + raw.Length(), "JsonIndex: invalid number");
+    return result;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Util::StringView
+JsonIndex::GetRaw(IndexT value) const
+{
+    const SizeT start = this->structurals[value];
+    const SizeT end = this->IsObjectOrArray(value) ? this->structurals[this->links[value]] + 1 : this->ScalarEnd(value);
+    return Util::StringView(this->json + start, end - start);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Decodes the json escape sequences, \\u escapes are converted to UTF-8.
+    Every decoded character is handed to append.
+*/
+template<typename APPEND>
+static void
+DecodeEscapes(const Util::StringView& str, APPEND append)
+{
+    const char* cur = str.Data();
+    const char* end = str.End();
+    while (cur < end)
+    {
+        if (*cur != '\\' || cur + 1 == end)
+        {
+            append(*cur++);
+            continue;
+        }
+        cur++;
+        const char c = *cur++;
+        switch (c)
+        {
+            case 'b': append('\b'); break;
+            case 'f': append('\f'); break;
+            case 'n': append('\n'); break;
+            case 'r': append('\r'); break;
+            case 't': append('\t'); break;
+            case 'u':
+            {
+                uint code = 0;
+                if (end - cur < 4 || std::from_chars(cur, cur + 4, code, 16).ptr != cur + 4)
+                {
+                    append('?');
+                    break;
+                }
+                cur += 4;
+
+                // combine surrogate pairs
+                uint low = 0;
+                if (code >= 0xD800 && code <= 0xDBFF && end - cur >= 6 && cur[0] == '\\' && cur[1] == 'u'
+                    && std::from_chars(cur + 2, cur + 6, low, 16).ptr == cur + 6 && low >= 0xDC00 && low <= 0xDFFF)
+                {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    cur += 6;
+                }
+
+                if (code < 0x80)
+                {
+                    append(char(code));
+                }
+                else if (code < 0x800)
+                {
+                    append(char(0xC0 | (code >> 6)));
+                    append(char(0x80 | (code & 0x3F)));
+                }
+                else if (code < 0x10000)
+                {
+                    append(char(0xE0 | (code >> 12)));
+                    append(char(0x80 | ((code >> 6) & 0x3F)));
+                    append(char(0x80 | (code & 0x3F)));
+                }
+                else
+                {
+                    append(char(0xF0 | (code >> 18)));
+                    append(char(0x80 | ((code >> 12) & 0x3F)));
+                    append(char(0x80 | ((code >> 6) & 0x3F)));
+                    append(char(0x80 | (code & 0x3F)));
+                }
+                break;
+            }
+            default:
+                // \" \\ \/
+                append(c);
+                break;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+JsonIndex::Unescape(const Util::StringView& str, Util::String& out)
+{
+    if (str.FindCharIndex('\\') == InvalidIndex)
+    {
+        out.Set(str.Data(), str.Length());
+        return;
+    }
+
+    Util::Array<char> buf;
+    buf.Reserve(str.Length());
+    DecodeEscapes(str, [&buf](char c) { buf.Append(c); });
+    out.Set(buf.Begin(), buf.Size());
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Util::StringView
+JsonIndex::Unescape(const Util::StringView& str, Util::StringBuilder& builder)
+{
+    if (str.FindCharIndex('\\') == InvalidIndex)
+    {
+        return builder.Add(str);
+    }
+
+    builder.Begin();
+    DecodeEscapes(str, [&builder](char c) { builder.AppendChar(c); });
+    return builder.End();
+}
+
+} // namespace IO
@@ -0,0 +1,338 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class IO::JsonIndex
+
+    On demand json parser used by the JsonReader. Instead of building a tree
+    of values, Parse only records the offsets of the structural characters
+    ({}[]:,) and of the first character of every value, found with SSE2 64
+    bytes at a time. A second pass over these offsets validates the grammar
+    and links every bracket to its counterpart, so containers can be skipped
+    in constant time.
+
+    Values are referenced by their index in the structural list and are only
+    materialized when asked for: strings are unescaped and numbers converted
+    by the getters, which makes reading a few keys of a large file cost
+    little more than scanning it once. The grammar of every scalar is
+    checked during Parse, so malformed numbers are reported as parse errors.
+
+    The index points into the parsed buffer, which must stay valid and
+    unchanged for as long as the index is used.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "core/types.h"
+#include "util/array.h"
+#include "util/string.h"
+#include "util/stringview.h"
+#include "util/stringbuilder.h"
+
+//------------------------------------------------------------------------------
+namespace IO
+{
+class JsonIndex
+{
+public:
+    /// value types
+    enum Type
+    {
+        Null,
+        Bool,
+        Int,
+        Double,
+        String,
+        Array,
+        Object,
+    };
+
+    /// constructor
+    JsonIndex();
+
+    /// index a json buffer, returns false on syntax errors
+    bool Parse(const char* json, SizeT size);
+    /// clear the index and free its memory
+    void Clear();
+    /// get error message of the last Parse
+    const char* GetError() const;
+    /// get buffer offset of the last error
+    SizeT GetErrorOffset() const;
+    /// get number of bytes used by the index
+    SizeT GetMemorySize() const;
+
+    /// get the root value
+    IndexT GetRoot() const;
+    /// get type of value
+    Type GetType(IndexT value) const;
+    /// return true if value is an object
+    bool IsObject(IndexT value) const;
+    /// return true if value is an array
+    bool IsArray(IndexT value) const;
+    /// return true if value is an object or an array
+    bool IsObjectOrArray(IndexT value) const;
+    /// return true if value is a string
+    bool IsString(IndexT value) const;
+    /// return true if value is a number without fraction or exponent
+    bool IsInt(IndexT value) const;
+    /// return true if value is a number with fraction or exponent
+    bool IsDouble(IndexT value) const;
+    /// return true if value is a number
+    bool IsNumeric(IndexT value) const;
+    /// return true if value is true or false
+    bool IsBool(IndexT value) const;
+    /// return true if value is null
+    bool IsNull(IndexT value) const;
+
+    /// get number of members of an object or elements of an array
+    SizeT Size(IndexT value) const;
+    /// get first member or element, InvalidIndex if empty
+    IndexT GetFirstChild(IndexT value) const;
+    /// get next member or element after child, InvalidIndex if child is the last one
+    IndexT GetNextSibling(IndexT child) const;
+    /// get member or element at position, InvalidIndex if out of range
+    IndexT GetChildAt(IndexT value, IndexT childIndex) const;
+    /// find an object member by key, InvalidIndex if not found
+    IndexT FindChild(IndexT object, const Util::StringView& key, IndexT* outChildIndex = nullptr) const;
+    /// get key of an object member
+    Util::String GetKey(IndexT child) const;
+    /// get key of an object member as it appears in the json, without quotes
+    Util::StringView GetRawKey(IndexT child) const;
+
+    /// get string value
+    Util::String GetString(IndexT value) const;
+    /// get string value unescaped into a builder, the view is zero terminated
+    Util::StringView GetString(IndexT value, Util::StringBuilder& builder) const;
+    /// get bool value
+    bool GetBool(IndexT value) const;
+    /// get number as 64-bit int, numbers with fractions are truncated
+    int64_t GetInt64(IndexT value) const;
+    /// get number as double
+    double GetDouble(IndexT value) const;
+    /// get the json text of a value, objects and arrays include all their children
+    Util::StringView GetRaw(IndexT value) const;
+
+private:
+    /// find structural characters and value starts, returns false if a string is not terminated
+    bool FindStructurals();
+    /// validate the grammar and link brackets
+    bool LinkContainers();
+    /// check strings, literals and numbers, sets the error if invalid
+    bool ValidateScalar(IndexT value);
+    /// set error at structural
+    bool SetError(const char* msg, IndexT structural);
+    /// get first character of structural
+    char At(IndexT structural) const;
+    /// get index of the structural following a value
+    IndexT SkipValue(IndexT value) const;
+    /// get end offset of a scalar value, without trailing whitespace
+    SizeT ScalarEnd(IndexT value) const;
+    /// unescape the contents of a string
+    static void Unescape(const Util::StringView& str, Util::String& out);
+    /// unescape the contents of a string into a builder
+    static Util::StringView Unescape(const Util::StringView& str, Util::StringBuilder& builder);
+
+    const char* json;
+    SizeT size;
+    Util::Array<uint32_t> structurals;  // offsets of structural characters and value starts, plus the end of the buffer
+    Util::Array<uint32_t> links;        // index of the closing bracket for open brackets, number of children for closing brackets
+    const char* error;
+    SizeT errorOffset;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const char*
+JsonIndex::GetError() const
+{
+    return this->error;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+JsonIndex::GetErrorOffset() const
+{
+    return this->errorOffset;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline IndexT
+JsonIndex::GetRoot() const
+{
+    n_assert(this->structurals.Size() > 1);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline char
+JsonIndex::At(IndexT structural) const
+{
+    return this->json[this->structurals[structural]];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+JsonIndex::IsObject(IndexT value) const
+{
+    return this->At(value) == '{';
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+JsonIndex::IsArray(IndexT value) const
+{
+    return this->At(value) == '[';
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+JsonIndex::IsObjectOrArray(IndexT value) const
+{
+    const char c = this->At(value);
+    return c == '{' || c == '[';
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+JsonIndex::IsString(IndexT value) const
+{
+    return this->At(value) == '"';
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+JsonIndex::IsInt(IndexT value) const
+{
+    return this->GetType(value) == Int;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+JsonIndex::IsDouble(IndexT value) const
+{
+    return this->GetType(value) == Double;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+JsonIndex::IsNumeric(IndexT value) const
+{
+    const char c = this->At(value);
+    return c == '-' || (c >= '0' && c <= '9');
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+JsonIndex::IsBool(IndexT value) const
+{
+    const char c = this->At(value);
+    return c == 't' || c == 'f';
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+JsonIndex::IsNull(IndexT value) const
+{
+    return this->At(value) == 'n';
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+JsonIndex::Size(IndexT value) const
+{
+    if (!this->IsObjectOrArray(value))
+    {
+        return 0;
+    }
+    return this->links[this->links[value]];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline IndexT
+JsonIndex::SkipValue(IndexT value) const
+{
+    return this->IsObjectOrArray(value) ? this->links[value] + 1 : value + 1;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Members of objects start after the key and the colon.
+*/
+inline IndexT
+JsonIndex::GetFirstChild(IndexT value) const
+{
+    if (this->Size(value) == 0)
+    {
+        return InvalidIndex;
+    }
+    return this->IsObject(value) ? value + 3 : value + 1;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Object members are preceded by a colon, array elements by a comma or
+    the opening bracket.
+*/
+inline IndexT
+JsonIndex::GetNextSibling(IndexT child) const
+{
+    const IndexT next = this->SkipValue(child);
+    if (this->At(next) != ',')
+    {
+        return InvalidIndex;
+    }
+    return this->At(child - 1) == ':' ? next + 3 : next + 1;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+JsonIndex::GetBool(IndexT value) const
+{
+    n_assert(this->IsBool(value));
+    return this->At(value) == 't';
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline Util::StringView
+JsonIndex::GetRawKey(IndexT child) const
+{
+    n_assert(child >= 3 && this->At(child - 1) == ':');
+    const IndexT key = child - 2;
+    const SizeT start = this->structurals[key] + 1;
+    return Util::StringView(this->json + start, this->ScalarEnd(key) - 1 - start);
+}
+
+} // namespace IO
+//------------------------------------------------------------------------------
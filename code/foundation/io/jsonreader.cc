@@ -2,15 +2,8 @@
 //  jsonreader.cc
 //  (C) 2018-2020 Individual contributors, see AUTHORS file
 //------------------------------------------------------------------------------
-
-#ifdef min
-#undef min
-#endif
-#ifdef max
-#undef max
-#endif
-#include "pjson/pjson.h"
 #include "io/jsonreader.h"
+#include "io/jsonindex.h"
 #include "util/variant.h"
 #include <climits>
 
@@ -21,14 +14,14 @@ __ImplementClass(IO::JsonReader, 'JSLR', IO::StreamReader);
 
 using namespace Util;
 using namespace Math;
-using namespace pjson;
     
 //------------------------------------------------------------------------------
 /**
 */
 JsonReader::JsonReader() :
-    document(0),
-    curNode(0)
+    index(nullptr),
+    curNode(InvalidIndex),
+    atomScratch(1024)
 {
     // empty
 }
@@ -46,40 +39,40 @@ JsonReader::~JsonReader()
 
 //------------------------------------------------------------------------------
 /**
-    Opens the stream and reads the content of the stream into
-    pjson.
+    Opens the stream and reads the content of the stream into a buffer,
+    which is indexed by the JsonIndex. Values are only parsed when they
+    are read.
 */
 bool
 JsonReader::Open()
 {
-    n_assert(0 == this->document);
+    n_assert(nullptr == this->index);
     
     if (StreamReader::Open())
     {
-        this->document = new pjson::document;
+        this->index = new JsonIndex;
 
-        // create an document object        
-        // we need to 0 terminate the input buffer
+        // keep the buffer 0 terminated, so error positions can be printed
         Stream::Size fileSize = this->stream->GetSize();
         this->buffer = (char*)Memory::Alloc(Memory::StreamDataHeap, fileSize + 1);
         this->stream->Read(buffer, fileSize);
         this->buffer[fileSize] = '\0';
-        if (!this->document->deserialize_in_place(buffer))
+        if (!this->index->Parse(this->buffer, (SizeT)fileSize))
         {
             const URI& uri = this->stream->GetURI();
-            const pjson::error_info & error = this->document->get_error();
             Util::String position;
-            if(error.m_ofs<(size_t)this->stream->GetSize())
+            const SizeT errorOffset = this->index->GetErrorOffset();
+            if (errorOffset < fileSize)
             {
-                position.Set(((const char *)this->buffer) + error.m_ofs, 40);
+                position.Set(((const char *)this->buffer) + errorOffset, Math::min(40, (SizeT)fileSize - errorOffset));
             }
 			Util::String const fileName = uri.IsEmpty() ? "" : uri.AsString();
-			n_error("JsonReader::Open(): failed to parse json file: %s\n%s\nat: %s\n", fileName.AsCharPtr(), error.m_pError_message, position.AsCharPtr());
+			n_error("JsonReader::Open(): failed to parse json file: %s\n%s\nat: %s\n", fileName.AsCharPtr(), this->index->GetError(), position.AsCharPtr());
 			return false;
         }        
 
         // set the current node to the root node
-        this->curNode = this->document;
+        this->curNode = this->index->GetRoot();
         return true;
     }
     return false;
@@ -91,10 +84,11 @@ JsonReader::Open()
 void
 JsonReader::Close()
 {
-    n_assert(0 != this->document);
-    this->document->clear();
-    delete this->document;
-    this->curNode = 0;
+    n_assert(nullptr != this->index);
+    delete this->index;
+    this->index = nullptr;
+    this->curNode = InvalidIndex;
+    this->parents.Clear();
     Memory::Free(Memory::StreamDataHeap, this->buffer);
     this->buffer = nullptr;
     StreamReader::Close();
@@ -109,19 +103,20 @@ JsonReader::Close()
 bool
 JsonReader::HasNode(const String& path)
 {
-    n_assert(0 != this->document);
+    n_assert(nullptr != this->index);
     bool absPath = (path[0] == '/');
-    Array<String> tokens = path.Tokenize("/");
+    Array<StringView> tokens;
+    path.Tokenize("/", tokens);
 
     // get starting node (either root or current node)
-    const value_variant* node;
+    IndexT node;
     if (absPath)
     {
-        node = this->document;
+        node = this->index->GetRoot();
     }
     else
     {
-        n_assert(0 != this->curNode);
+        n_assert(InvalidIndex != this->curNode);
         node = this->curNode;
     }
 
@@ -130,13 +125,12 @@ JsonReader::HasNode(const String& path)
     int num = tokens.Size();
     for (i = 0; i < num; i++)
     {       
-        const String& cur = tokens[i];
-        if (!node->is_object())
+        if (!this->index->IsObject(node))
         {
             return false;
         }
-        node = node->find_value_variant(cur.AsCharPtr());
-        if (0 == node)
+        node = this->index->FindChild(node, tokens[i]);
+        if (InvalidIndex == node)
         {
             return false;
         }
@@ -152,10 +146,9 @@ void
 JsonReader::SetToRoot()
 {
     // set the current node to the root node
-    this->curNode = this->document;
+    n_assert(nullptr != this->index);
+    this->curNode = this->index->GetRoot();
     this->parents.Clear();
-    this->parentIdx.Clear();
-    n_assert(this->curNode);
 }
 
 //------------------------------------------------------------------------------
@@ -179,7 +172,7 @@ JsonReader::SetToNode(const String& path)
     {
         this->SetToRoot();
     }
-    n_assert(0 != this->curNode);
+    n_assert(InvalidIndex != this->curNode);
 
     // iterate through path components
     int i;
@@ -193,15 +186,11 @@ JsonReader::SetToNode(const String& path)
         {
             Util::String numstr = cur;
             numstr.Trim("[]");
-            unsigned int idx = numstr.AsInt();
-            if (!this->curNode->is_object_or_array()) goto fail;
-            if (!(idx < this->curNode->size())) goto fail;
+            const IndexT node = this->index->GetChildAt(this->curNode, numstr.AsInt());
+            if (InvalidIndex == node) goto fail;
 
-            const value_variant* node = &this->curNode->get_value_at_index(idx);
             this->parents.Push(this->curNode);
-            this->parentIdx.Push(this->childIdx);
             this->curNode = node;
-            this->childIdx = idx;
         }
         else
         {
@@ -211,7 +200,6 @@ JsonReader::SetToNode(const String& path)
     return true;
 fail:
     this->parents.Clear();
-    this->parentIdx.Clear();
     return false;
 }
 
@@ -226,31 +214,23 @@ bool
 JsonReader::SetToFirstChild(const Util::String& name)
 {
     n_assert(this->IsOpen());
-    n_assert(0 != this->curNode);
-    const value_variant* child = nullptr;
-    IndexT cIdx = 0;
-    if (this->curNode->has_children())
+    n_assert(InvalidIndex != this->curNode);
+    IndexT child = InvalidIndex;
+    if (name.IsEmpty())
     {
-        if (name.IsEmpty())
-        {
-            child = &this->curNode->get_value_at_index(0);
-        }
-        else
-        {
-            child = this->curNode->find_value_variant(name.AsCharPtr());
-            cIdx = this->curNode->find_key(name.AsCharPtr());
-        }
-
-        if (child)
-        {
-            this->parents.Push(this->curNode);
-            this->parentIdx.Push(this->childIdx);
-            this->curNode = child;
-            this->childIdx = cIdx;
-            return true;
-        }
+        child = this->index->GetFirstChild(this->curNode);
+    }
+    else if (this->index->IsObject(this->curNode))
+    {
+        child = this->index->FindChild(this->curNode, name);
     }
 
+    if (InvalidIndex != child)
+    {
+        this->parents.Push(this->curNode);
+        this->curNode = child;
+        return true;
+    }
     return false;
 }
 
@@ -265,19 +245,14 @@ bool
 JsonReader::SetToNextChild()
 {
     n_assert(this->IsOpen());
-    n_assert(0 != this->curNode);
-    n_assert(0 <= this->childIdx);
-
-    this->childIdx++;
+    n_assert(InvalidIndex != this->curNode);
+    n_assert(!this->parents.IsEmpty());
 
-    if (this->childIdx < (IndexT)this->parents.Peek()->size())
+    const IndexT child = this->index->GetNextSibling(this->curNode);
+    if (InvalidIndex != child)
     {
-        const value_variant* child = &this->parents.Peek()->get_value_at_index(this->childIdx);
-        if (child)
-        {
-            this->curNode = child;
-            return true;
-        }
+        this->curNode = child;
+        return true;
     }
     this->SetToParent();
     return false;    
@@ -292,11 +267,10 @@ bool
 JsonReader::SetToParent()
 {
     n_assert(this->IsOpen());
-    n_assert(0 != this->curNode);
+    n_assert(InvalidIndex != this->curNode);
     if (!this->parents.IsEmpty())
     {
         this->curNode = this->parents.Pop();
-        this->childIdx = this->parentIdx.Pop();
         return true;
     }
     else
@@ -312,12 +286,16 @@ Util::String
 JsonReader::GetChildNodeName(SizeT childIndex)
 {
     n_assert(this->IsOpen());
-    n_assert(0 != this->curNode);
+    n_assert(InvalidIndex != this->curNode);
     n_assert(0 <= childIndex);
 
-    if (childIndex < (IndexT)this->curNode->size())
+    if (this->index->IsObject(this->curNode))
     {
-        return this->curNode->get_key_name_at_index(childIndex);
+        const IndexT child = this->index->GetChildAt(this->curNode, childIndex);
+        if (InvalidIndex != child)
+        {
+            return this->index->GetKey(child);
+        }
     }
 
     return "";
@@ -331,8 +309,8 @@ bool
 JsonReader::IsArray() const
 {
     n_assert(this->IsOpen());
-    n_assert(0 != this->curNode);
-    return this->curNode->is_array();
+    n_assert(InvalidIndex != this->curNode);
+    return this->index->IsArray(this->curNode);
 }
 
 
@@ -344,8 +322,8 @@ bool
 JsonReader::IsObject() const
 {
     n_assert(this->IsOpen());
-    n_assert(0 != this->curNode);
-    return this->curNode->is_object();
+    n_assert(InvalidIndex != this->curNode);
+    return this->index->IsObject(this->curNode);
 }
 //------------------------------------------------------------------------------
 /**
@@ -355,8 +333,8 @@ bool
 JsonReader::HasChildren() const
 {
     n_assert(this->IsOpen());
-    n_assert(0 != this->curNode);
-    return this->curNode->has_children();
+    n_assert(InvalidIndex != this->curNode);
+    return this->index->Size(this->curNode) > 0;
 }
 
 //------------------------------------------------------------------------------
@@ -367,12 +345,8 @@ SizeT
 JsonReader::CurrentSize() const
 {
     n_assert(this->IsOpen());
-    n_assert(0 != this->curNode);
-    if (this->curNode->is_object_or_array())
-    {
-        return this->curNode->size();
-    }
-    return 0;
+    n_assert(InvalidIndex != this->curNode);
+    return this->index->Size(this->curNode);
 }
  
 //------------------------------------------------------------------------------
@@ -383,10 +357,10 @@ bool
 JsonReader::HasAttr(const char* name) const
 {
     n_assert(this->IsOpen());
-    n_assert(0 != this->curNode);
+    n_assert(InvalidIndex != this->curNode);
     n_assert(0 != name);
-    n_assert(this->curNode->is_object());
-    return (0 != this->curNode->has_key(name));
+    n_assert(this->index->IsObject(this->curNode));
+    return InvalidIndex != this->index->FindChild(this->curNode, name);
 }
 
 //------------------------------------------------------------------------------
@@ -397,12 +371,14 @@ Array<String>
 JsonReader::GetAttrs() const
 {
     n_assert(this->IsOpen());
-    n_assert(0 != this->curNode);
-    n_assert(this->curNode->is_object());
+    n_assert(InvalidIndex != this->curNode);
+    n_assert(this->index->IsObject(this->curNode));
     Array<String> res;
-    for (unsigned int i = 0; i < this->curNode->size(); ++i)
+    res.Reserve(this->index->Size(this->curNode));
+    IndexT child;
+    for (child = this->index->GetFirstChild(this->curNode); child != InvalidIndex; child = this->index->GetNextSibling(child))
     {
-        res.Append(this->curNode->get_key_name_at_index(i));
+        res.Append(this->index->GetKey(child));
     }
     return res;
 }
@@ -413,27 +389,30 @@ JsonReader::GetAttrs() const
 Util::String
 JsonReader::GetCurrentNodeName() const
 {
-    //  get_key_name_at_index(this->childIdx)
-    auto parent = this->parents.Peek();
-    // auto parentIdx = this->parentIdx.Peek();
-    return parent->get_key_name_at_index(this->childIdx);
+    n_assert(!this->parents.IsEmpty());
+    if (this->index->IsObject(this->parents.Peek()))
+    {
+        return this->index->GetKey(this->curNode);
+    }
+    return "";
 }
 
 
 //------------------------------------------------------------------------------
 /**
-    
+    Returns the current node if name is 0, otherwise the attribute of the
+    current node, or InvalidIndex if it doesn't exist.
 */
-const pjson::value_variant* 
+IndexT
 JsonReader::GetChild(const char * name) const
 {
     n_assert(this->IsOpen());
-    n_assert(0 != this->curNode);
+    n_assert(InvalidIndex != this->curNode);
 
     if (0 != name)
     {
-        n_assert(this->curNode->is_object());        
-        return this->curNode->find_value_variant(name);
+        n_assert(this->index->IsObject(this->curNode));        
+        return this->index->FindChild(this->curNode, name);
     }
     else
     {
@@ -441,6 +420,25 @@ JsonReader::GetChild(const char * name) const
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+    Reads the first num elements of an array as floats.
+*/
+void
+JsonReader::GetFloats(IndexT node, float* out, SizeT num) const
+{
+    n_assert(InvalidIndex != node);
+    n_assert(this->index->IsArray(node));
+    n_assert(this->index->Size(node) >= num);
+    IndexT child = this->index->GetFirstChild(node);
+    IndexT i;
+    for (i = 0; i < num; i++)
+    {
+        out[i] = (float)this->index->GetDouble(child);
+        child = this->index->GetNextSibling(child);
+    }
+}
+
 //------------------------------------------------------------------------------
 /**
     Return the provided attribute as string. If the attribute does not exist
@@ -449,11 +447,11 @@ JsonReader::GetChild(const char * name) const
 String
 JsonReader::GetString(const char* name) const
 {
-    const value_variant * node = this->GetChild(name);
+    const IndexT node = this->GetChild(name);
 
-    n_assert(node);
-    n_assert(node->is_string());
-    return node->as_string_ptr();    
+    n_assert(node != InvalidIndex);
+    n_assert(this->index->IsString(node));
+    return this->index->GetString(node);    
 }
 
 //------------------------------------------------------------------------------
@@ -464,11 +462,16 @@ JsonReader::GetString(const char* name) const
 StringAtom
 JsonReader::GetStringAtom(const char* name) const
 {
-    const value_variant * node = this->GetChild(name);
+    const IndexT node = this->GetChild(name);
+
+    n_assert(node != InvalidIndex);
+    n_assert(this->index->IsString(node));
 
-    n_assert(node);
-    n_assert(node->is_string());
-    return node->as_string_ptr();
+    // the atom table only copies strings it hasn't seen yet, so the unescaped
+    // string goes through the scratch builder instead of a temporary String
+    const StringAtom atom(this->index->GetString(node, this->atomScratch).Data());
+    this->atomScratch.Reset();
+    return atom;
 }
 
 //------------------------------------------------------------------------------
@@ -479,11 +482,11 @@ JsonReader::GetStringAtom(const char* name) const
 bool
 JsonReader::GetBool(const char* name) const
 {
-    const value_variant * node = this->GetChild(name);
+    const IndexT node = this->GetChild(name);
 
-    n_assert(node);
-    n_assert(node->is_bool());
-    return node->as_bool();
+    n_assert(node != InvalidIndex);
+    n_assert(this->index->IsBool(node));
+    return this->index->GetBool(node);
 }
 
 //------------------------------------------------------------------------------
@@ -494,11 +497,11 @@ JsonReader::GetBool(const char* name) const
 int
 JsonReader::GetInt(const char* name) const
 {
-    const value_variant * node = this->GetChild(name);
+    const IndexT node = this->GetChild(name);
 
-    n_assert(node);
-    n_assert(node->is_int());
-    return node->as_int32();
+    n_assert(node != InvalidIndex);
+    n_assert(this->index->IsInt(node));
+    return (int)this->index->GetInt64(node);
 }
 
 //------------------------------------------------------------------------------
@@ -509,11 +512,11 @@ JsonReader::GetInt(const char* name) const
 uint
 JsonReader::GetUInt(const char * attr) const
 {
-    const value_variant * node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
     
-    n_assert(node);
-    n_assert(node->is_int());
-    return (uint)node->as_int32();
+    n_assert(node != InvalidIndex);
+    n_assert(this->index->IsInt(node));
+    return (uint)(int)this->index->GetInt64(node);
 }
 
 //------------------------------------------------------------------------------
@@ -524,12 +527,12 @@ JsonReader::GetUInt(const char * attr) const
 float
 JsonReader::GetFloat(const char* name) const
 {
-    const value_variant * node = this->GetChild(name);
+    const IndexT node = this->GetChild(name);
 
-    n_assert(node);
+    n_assert(node != InvalidIndex);
     // Floats can be either double or integer if it has no fraction
-    n_assert(node->is_double() || node->is_int());
-    return node->as_float();
+    n_assert(this->index->IsDouble(node) || this->index->IsInt(node));
+    return (float)this->index->GetDouble(node);
 }
 
 //------------------------------------------------------------------------------
@@ -540,11 +543,13 @@ JsonReader::GetFloat(const char* name) const
 vec2
 JsonReader::GetVec2(const char* name) const
 {
-    const value_variant * node = this->GetChild(name);
+    const IndexT node = this->GetChild(name);
 
-    n_assert(node->is_array());
-    n_assert(node->size() == 2);
-    return vec2(node->get_value_at_index(0).as_float(), node->get_value_at_index(1).as_float());
+    n_assert(this->index->IsArray(node));
+    n_assert(this->index->Size(node) == 2);
+    float v[2];
+    this->GetFloats(node, v, 2);
+    return vec2(v[0], v[1]);
 }
 
 //------------------------------------------------------------------------------
@@ -553,15 +558,12 @@ JsonReader::GetVec2(const char* name) const
 Math::vec3 
 JsonReader::GetVec3(const char* name) const
 {
-    const value_variant* node = this->GetChild(name);
+    const IndexT node = this->GetChild(name);
 
-    n_assert(node->is_array());
-    n_assert(node->size() == 3);
+    n_assert(this->index->IsArray(node));
+    n_assert(this->index->Size(node) == 3);
     NEBULA_ALIGN16 float v[3];
-    for (int i = 0; i < 3; i++)
-    {
-        v[i] = node->get_value_at_index(i).as_float();
-    }
+    this->GetFloats(node, v, 3);
     vec3 f;
     f.load(v);
     return f;
@@ -575,15 +577,12 @@ JsonReader::GetVec3(const char* name) const
 vec4
 JsonReader::GetVec4(const char* name) const
 {
-    const value_variant * node = this->GetChild(name);
+    const IndexT node = this->GetChild(name);
 
-    n_assert(node->is_array());
-    n_assert(node->size() == 4);
+    n_assert(this->index->IsArray(node));
+    n_assert(this->index->Size(node) == 4);
     NEBULA_ALIGN16 float v[4];
-    for (int i = 0; i < 4; i++)
-    {
-        v[i] = node->get_value_at_index(i).as_float();
-    }
+    this->GetFloats(node, v, 4);
     vec4 f;
     f.load(v);
     return f;
@@ -597,15 +596,12 @@ JsonReader::GetVec4(const char* name) const
 mat4
 JsonReader::GetMat4(const char* name) const
 {
-    const value_variant * node = this->GetChild(name);
+    const IndexT node = this->GetChild(name);
 
-    n_assert(node->is_array());
-    n_assert(node->size() == 16);
+    n_assert(this->index->IsArray(node));
+    n_assert(this->index->Size(node) == 16);
     NEBULA_ALIGN16 float v[16];
-    for (int i = 0; i < 16; i++)
-    {
-        v[i] = node->get_value_at_index(i).as_float();
-    }
+    this->GetFloats(node, v, 16);
     mat4 m;
     m.load(v);
     return m;
@@ -619,16 +615,13 @@ the method will fail hard (use HasAttr() to check for its existance).
 transform44
 JsonReader::GetTransform44(const char* name) const
 {
-    const value_variant * node = this->GetChild(name);
+    const IndexT node = this->GetChild(name);
 
-    n_assert(node->is_array());
-    n_assert(node->size() == 36);
+    n_assert(this->index->IsArray(node));
+    n_assert(this->index->Size(node) == 36);
 
     float v[36];
-    for (int i = 0; i < 36; i++)
-    {
-        v[i] = node->get_value_at_index(i).as_float();
-    }
+    this->GetFloats(node, v, 36);
     transform44 m;
     m.loadu(v);
     return m;
@@ -783,14 +776,15 @@ JsonReader::GetOptTransform44(const char* name, const transform44& defaultValue)
 */
 template<> void JsonReader::Get<Util::Array<uint32_t>>(Util::Array<uint32_t> & ret, const char* attr)
 {
-    const value_variant * node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
 
-    n_assert(node->is_array());
-    unsigned int count = node->size();    
+    n_assert(this->index->IsArray(node));
+    unsigned int count = this->index->Size(node);    
     ret.Reserve(count);
-    for (unsigned int i = 0; i < count; i++)
+    IndexT child;
+    for (child = this->index->GetFirstChild(node); child != InvalidIndex; child = this->index->GetNextSibling(child))
     {
-        ret.Append(node->get_value_at_index(i).as_int32());
+        ret.Append((int)this->index->GetInt64(child));
     }    
 }
 
@@ -799,14 +793,15 @@ template<> void JsonReader::Get<Util::Array<uint32_t>>(Util::Array<uint32_t> & r
 */
 template<> void JsonReader::Get<Util::Array<int>>(Util::Array<int> & ret, const char* attr)
 {
-    const value_variant * node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
 
-    n_assert(node->is_array());
-    unsigned int count = node->size();
+    n_assert(this->index->IsArray(node));
+    unsigned int count = this->index->Size(node);
     ret.Reserve(count);
-    for (unsigned int i = 0; i < count; i++)
+    IndexT child;
+    for (child = this->index->GetFirstChild(node); child != InvalidIndex; child = this->index->GetNextSibling(child))
     {
-        ret.Append(node->get_value_at_index(i).as_int32());
+        ret.Append((int)this->index->GetInt64(child));
     }
 }
 
@@ -815,10 +810,10 @@ template<> void JsonReader::Get<Util::Array<int>>(Util::Array<int> & ret, const
 */
 template<> void JsonReader::Get<bool>(bool & ret, const char* attr)
 {
-    const value_variant * node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
 
-    n_assert(node->is_bool());
-    ret = node->as_bool();
+    n_assert(this->index->IsBool(node));
+    ret = this->index->GetBool(node);
 }
 
 //------------------------------------------------------------------------------
@@ -826,10 +821,10 @@ template<> void JsonReader::Get<bool>(bool & ret, const char* attr)
 */
 template<> void JsonReader::Get<int64_t>(int64_t& ret, const char* attr)
 {
-    const value_variant* node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
 
-    n_assert(node->is_int());
-    ret = node->as_int64();
+    n_assert(this->index->IsInt(node));
+    ret = this->index->GetInt64(node);
 }
 
 //------------------------------------------------------------------------------
@@ -837,10 +832,10 @@ template<> void JsonReader::Get<int64_t>(int64_t& ret, const char* attr)
 */
 template<> void JsonReader::Get<int32_t>(int32_t& ret, const char* attr)
 {
-    const value_variant * node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
 
-    n_assert(node->is_int());
-    ret = node->as_int32();
+    n_assert(this->index->IsInt(node));
+    ret = (int)this->index->GetInt64(node);
 }
 
 //------------------------------------------------------------------------------
@@ -848,10 +843,10 @@ template<> void JsonReader::Get<int32_t>(int32_t& ret, const char* attr)
 */
 template<> void JsonReader::Get<int16_t>(int16_t& ret, const char* attr)
 {
-    const value_variant* node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
 
-    n_assert(node->is_int());
-    ret = (int16_t)node->as_int32();
+    n_assert(this->index->IsInt(node));
+    ret = (int16_t)(int)this->index->GetInt64(node);
 }
 
 //------------------------------------------------------------------------------
@@ -859,10 +854,10 @@ template<> void JsonReader::Get<int16_t>(int16_t& ret, const char* attr)
 */
 template<> void JsonReader::Get<int8_t>(int8_t& ret, const char* attr)
 {
-    const value_variant* node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
 
-    n_assert(node->is_int());
-    ret = (int8_t)node->as_int32();
+    n_assert(this->index->IsInt(node));
+    ret = (int8_t)(int)this->index->GetInt64(node);
 }
 
 //------------------------------------------------------------------------------
@@ -870,10 +865,10 @@ template<> void JsonReader::Get<int8_t>(int8_t& ret, const char* attr)
 */
 template<> void JsonReader::Get<char>(char& ret, const char* attr)
 {
-    const value_variant* node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
 
-    n_assert(node->is_int());
-    ret = (char)node->as_int32();
+    n_assert(this->index->IsInt(node));
+    ret = (char)(int)this->index->GetInt64(node);
 }
 
 //------------------------------------------------------------------------------
@@ -889,12 +884,13 @@ template<> void JsonReader::Get<Math::mat4>(Math::mat4 & ret, const char* attr)
 */
 template<> void JsonReader::Get<Math::int2>(Math::int2& ret, const char* attr)
 {
-    const value_variant* node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
 
-    n_assert(node->is_array());
-    n_assert(node->size() == 2);
-    ret.x = node->get_value_at_index(0).as_int32();
-    ret.y = node->get_value_at_index(1).as_int32();
+    n_assert(this->index->IsArray(node));
+    n_assert(this->index->Size(node) == 2);
+    const IndexT x = this->index->GetFirstChild(node);
+    ret.x = (int)this->index->GetInt64(x);
+    ret.y = (int)this->index->GetInt64(this->index->GetNextSibling(x));
 }
 
 //------------------------------------------------------------------------------
@@ -903,12 +899,9 @@ template<> void JsonReader::Get<Math::int2>(Math::int2& ret, const char* attr)
 template<> void JsonReader::Get<Math::vector>(Math::vector& ret, const char* attr)
 {
     //FIXME this searches twice
-    const value_variant* node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
     NEBULA_ALIGN16 float v[4];
-    for (int i = 0; i < 3; i++)
-    {
-        v[i] = node->get_value_at_index(i).as_float();
-    }
+    this->GetFloats(node, v, 3);
     ret.load(v);
 }
 
@@ -917,12 +910,9 @@ template<> void JsonReader::Get<Math::vector>(Math::vector& ret, const char* att
 */
 template<> void JsonReader::Get<Math::vec4>(Math::vec4& ret, const char* attr)
 {
-    const value_variant* node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
     NEBULA_ALIGN16 float v[4];
-    for (int i = 0; i < 4; i++)
-    {
-        v[i] = node->get_value_at_index(i).as_float();
-    }
+    this->GetFloats(node, v, 4);
     ret.load(v);
 }
 
@@ -931,12 +921,9 @@ template<> void JsonReader::Get<Math::vec4>(Math::vec4& ret, const char* attr)
 */
 template<> void JsonReader::Get<Math::quat>(Math::quat& ret, const char* attr)
 {
-	const value_variant* node = this->GetChild(attr);
+	const IndexT node = this->GetChild(attr);
 	NEBULA_ALIGN16 float v[4];
-	for (int i = 0; i < 4; i++)
-	{
-		v[i] = node->get_value_at_index(i).as_float();
-	}
+	this->GetFloats(node, v, 4);
 	ret.load(v);
 }
 
@@ -945,12 +932,9 @@ template<> void JsonReader::Get<Math::quat>(Math::quat& ret, const char* attr)
 */
 template<> void JsonReader::Get<Math::vec3>(Math::vec3& ret, const char* attr)
 {
-    const value_variant* node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
     NEBULA_ALIGN16 float v[4];
-    for (int i = 0; i < 3; i++)
-    {
-        v[i] = node->get_value_at_index(i).as_float();
-    }
+    this->GetFloats(node, v, 3);
     ret.load(v);
 }
 
@@ -959,9 +943,11 @@ template<> void JsonReader::Get<Math::vec3>(Math::vec3& ret, const char* attr)
 */
 template<> void JsonReader::Get<Math::vec2>(Math::vec2& ret, const char* attr)
 {
-    const value_variant* node = this->GetChild(attr);
-    ret.x = node->get_value_at_index(0).as_float();
-    ret.y = node->get_value_at_index(1).as_float();
+    const IndexT node = this->GetChild(attr);
+    float v[2];
+    this->GetFloats(node, v, 2);
+    ret.x = v[0];
+    ret.y = v[1];
 }
 
 //------------------------------------------------------------------------------
@@ -971,9 +957,9 @@ template <>
 void
 JsonReader::Get<uint64_t>(uint64_t& ret, const char* attr)
 {
-    const value_variant* node = this->GetChild(attr);
-    n_assert(node->is_int());
-    int64_t val = node->as_int64();
+    const IndexT node = this->GetChild(attr);
+    n_assert(this->index->IsInt(node));
+    int64_t val = this->index->GetInt64(node);
 
 #if NEBULA_DEBUG
     if (val < 0)
@@ -993,9 +979,9 @@ JsonReader::Get<uint64_t>(uint64_t& ret, const char* attr)
 */
 template<> void JsonReader::Get<uint32_t>(uint32_t & ret, const char* attr)
 {
-    const value_variant* node = this->GetChild(attr);
-    n_assert(node->is_int());
-    int32_t val = node->as_int32();
+    const IndexT node = this->GetChild(attr);
+    n_assert(this->index->IsInt(node));
+    int32_t val = (int)this->index->GetInt64(node);
 
 #if NEBULA_DEBUG
     if (val < 0)
@@ -1015,9 +1001,9 @@ template<> void JsonReader::Get<uint32_t>(uint32_t & ret, const char* attr)
 */
 template<> void JsonReader::Get<uint16_t>(uint16_t & ret, const char* attr)
 {
-    const value_variant* node = this->GetChild(attr);
-    n_assert(node->is_int());
-    int32_t val = node->as_int32();
+    const IndexT node = this->GetChild(attr);
+    n_assert(this->index->IsInt(node));
+    int32_t val = (int)this->index->GetInt64(node);
 
 #if NEBULA_DEBUG
     if (val < 0)
@@ -1037,9 +1023,9 @@ template<> void JsonReader::Get<uint16_t>(uint16_t & ret, const char* attr)
 */
 template<> void JsonReader::Get<uint8_t>(uint8_t & ret, const char* attr)
 {
-    const value_variant* node = this->GetChild(attr);
-    n_assert(node->is_int());
-    int32_t val = node->as_int32();
+    const IndexT node = this->GetChild(attr);
+    n_assert(this->index->IsInt(node));
+    int32_t val = (int)this->index->GetInt64(node);
 
 #if NEBULA_DEBUG
     if (val < 0)
@@ -1059,10 +1045,10 @@ template<> void JsonReader::Get<uint8_t>(uint8_t & ret, const char* attr)
 */
 template<> void JsonReader::Get<float>(float & ret, const char* attr)
 {
-    const value_variant * node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
 
-    n_assert(node->is_numeric());
-    ret = node->as_float();
+    n_assert(this->index->IsNumeric(node));
+    ret = (float)this->index->GetDouble(node);
 }
 
 //------------------------------------------------------------------------------
@@ -1079,27 +1065,27 @@ template<> void JsonReader::Get<Util::Variant>(Util::Variant & ret, const char*
     case Util::Variant::Type::Void:
     {
         // Special case: No type has been assigned, let the parser decide the type.
-        const value_variant * node = this->GetChild(attr);
+        const IndexT node = this->GetChild(attr);
 
-        if (node->is_bool())
+        if (this->index->IsBool(node))
         {
             ret.SetType(Util::Variant::Type::Bool);
-            ret.SetBool(node->as_bool());
+            ret.SetBool(this->index->GetBool(node));
         }
-        if (node->is_int())
+        else if (this->index->IsInt(node))
         {
             ret.SetType(Util::Variant::Type::Int);
-            ret.SetInt(node->as_int32());
+            ret.SetInt((int)this->index->GetInt64(node));
         }
-        else if (node->is_double())
+        else if (this->index->IsDouble(node))
         {
             ret.SetType(Util::Variant::Type::Double);
-            ret.SetDouble(node->as_double());
+            ret.SetDouble(this->index->GetDouble(node));
         }
-        else if (node->is_string())
+        else if (this->index->IsString(node))
         {
             ret.SetType(Util::Variant::Type::String);
-            ret.SetString(node->as_string_ptr());
+            ret.SetString(this->index->GetString(node));
         }
         else
         {
@@ -1145,10 +1131,10 @@ template<> void JsonReader::Get<Util::Variant>(Util::Variant & ret, const char*
 */
 template<> void JsonReader::Get<Util::String>(Util::String & ret, const char* attr)
 {
-    const value_variant * node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
 
-    n_assert(node->is_string());
-    ret = node->as_string_ptr();
+    n_assert(this->index->IsString(node));
+    ret = this->index->GetString(node);
 }
 
 //------------------------------------------------------------------------------
@@ -1156,12 +1142,12 @@ template<> void JsonReader::Get<Util::String>(Util::String & ret, const char* at
 */
 template<> void JsonReader::Get<Util::FourCC>(Util::FourCC& ret, const char* attr)
 {
-    const value_variant* node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
 
-    if (node->is_string())
-        ret.FromString(node->as_string_ptr());
-    else if (node->is_int())
-        ret.SetFromUInt(node->as_int32());
+    if (this->index->IsString(node))
+        ret.FromString(this->index->GetString(node));
+    else if (this->index->IsInt(node))
+        ret.SetFromUInt((int)this->index->GetInt64(node));
     else
         n_error("Invalid input\n");
 }
@@ -1171,10 +1157,7 @@ template<> void JsonReader::Get<Util::FourCC>(Util::FourCC& ret, const char* att
 */
 template<> void JsonReader::Get<Util::StringAtom>(Util::StringAtom & ret, const char* attr)
 {
-    const value_variant * node = this->GetChild(attr);
-
-    n_assert(node->is_string());
-    ret = node->as_string_ptr();
+    ret = this->GetStringAtom(attr);
 }
 
 //------------------------------------------------------------------------------
@@ -1182,14 +1165,15 @@ template<> void JsonReader::Get<Util::StringAtom>(Util::StringAtom & ret, const
 */
 template<> void JsonReader::Get<Util::Array<float>>(Util::Array<float> &ret, const char* attr)
 {
-    const value_variant * node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
 
-    n_assert(node->is_array());
-    unsigned int count = node->size();
+    n_assert(this->index->IsArray(node));
+    unsigned int count = this->index->Size(node);
     ret.Reserve(count);
-    for (unsigned int i = 0; i < count; i++)
+    IndexT child;
+    for (child = this->index->GetFirstChild(node); child != InvalidIndex; child = this->index->GetNextSibling(child))
     {
-        ret.Append(node->get_value_at_index(i).as_float());
+        ret.Append((float)this->index->GetDouble(child));
     }    
 }
 
@@ -1198,14 +1182,15 @@ template<> void JsonReader::Get<Util::Array<float>>(Util::Array<float> &ret, con
 */
 template<> void JsonReader::Get<Util::Array<Util::String>>(Util::Array<Util::String> &ret, const char* attr)
 {
-    const value_variant * node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
 
-    n_assert(node->is_array());
-    unsigned int count = node->size();
+    n_assert(this->index->IsArray(node));
+    unsigned int count = this->index->Size(node);
     ret.Reserve(count);
-    for (unsigned int i = 0; i < count; i++)
+    IndexT child;
+    for (child = this->index->GetFirstChild(node); child != InvalidIndex; child = this->index->GetNextSibling(child))
     {
-        ret.Append(node->get_value_at_index(i).as_string_ptr());
+        ret.Append(this->index->GetString(child));
     }    
 }
 
@@ -1214,11 +1199,11 @@ template<> void JsonReader::Get<Util::Array<Util::String>>(Util::Array<Util::Str
 */
 template<> bool JsonReader::GetOpt<bool>(bool & ret, const char* attr)
 {
-    const value_variant * node = this->GetChild(attr);
-    if (node)
+    const IndexT node = this->GetChild(attr);
+    if (node != InvalidIndex)
     {
-        n_assert(node->is_bool());
-        ret = node->as_bool();
+        n_assert(this->index->IsBool(node));
+        ret = this->index->GetBool(node);
         return true;
     }
     return false;
@@ -1229,11 +1214,11 @@ template<> bool JsonReader::GetOpt<bool>(bool & ret, const char* attr)
 */
 template<> bool JsonReader::GetOpt<int>(int & ret, const char* attr)
 {
-    const value_variant * node = this->GetChild(attr);
-    if (node)
+    const IndexT node = this->GetChild(attr);
+    if (node != InvalidIndex)
     {
-        n_assert(node->is_int());
-        ret = node->as_int32();
+        n_assert(this->index->IsInt(node));
+        ret = (int)this->index->GetInt64(node);
         return true;
     }
     return false;
@@ -1244,11 +1229,11 @@ template<> bool JsonReader::GetOpt<int>(int & ret, const char* attr)
 */
 template<> bool JsonReader::GetOpt<uint16_t>(uint16_t & ret, const char* attr)
 {
-    const value_variant * node = this->GetChild(attr);
-    if (node)
+    const IndexT node = this->GetChild(attr);
+    if (node != InvalidIndex)
     {
-        n_assert(node->is_int());
-        ret = static_cast<uint16_t>(node->as_int32());
+        n_assert(this->index->IsInt(node));
+        ret = static_cast<uint16_t>((int)this->index->GetInt64(node));
         return true;
     }
     return false;
@@ -1259,11 +1244,11 @@ template<> bool JsonReader::GetOpt<uint16_t>(uint16_t & ret, const char* attr)
 */
 template<> bool JsonReader::GetOpt<uint32_t>(uint32_t & ret, const char* attr)
 {
-    const value_variant * node = this->GetChild(attr);
-    if (node)
+    const IndexT node = this->GetChild(attr);
+    if (node != InvalidIndex)
     {
-        n_assert(node->is_int());
-        ret = node->as_int32();        
+        n_assert(this->index->IsInt(node));
+        ret = (int)this->index->GetInt64(node);        
         return true;
     }
     return false;
@@ -1274,11 +1259,11 @@ template<> bool JsonReader::GetOpt<uint32_t>(uint32_t & ret, const char* attr)
 */
 template<> bool JsonReader::GetOpt<float>(float & ret, const char* attr)
 {
-    const value_variant * node = this->GetChild(attr);
-    if (node)
+    const IndexT node = this->GetChild(attr);
+    if (node != InvalidIndex)
     {
-        n_assert(node->is_numeric());
-        ret = node->as_float();
+        n_assert(this->index->IsNumeric(node));
+        ret = (float)this->index->GetDouble(node);
         return true;
     }
     return false;
@@ -1290,8 +1275,8 @@ template<> bool JsonReader::GetOpt<float>(float & ret, const char* attr)
 template<> bool JsonReader::GetOpt<Math::vec4>(Math::vec4 & ret, const char* attr)
 {    
     //FIXME this searches twice
-    const value_variant * node = this->GetChild(attr);
-    if (node)
+    const IndexT node = this->GetChild(attr);
+    if (node != InvalidIndex)
     {
         ret = this->GetVec4(attr);        
         return true;
@@ -1305,8 +1290,8 @@ template<> bool JsonReader::GetOpt<Math::vec4>(Math::vec4 & ret, const char* att
 template<> bool JsonReader::GetOpt<Math::quat>(Math::quat & ret, const char* attr)
 {
     //FIXME this searches twice
-    const value_variant * node = this->GetChild(attr);
-    if (node)
+    const IndexT node = this->GetChild(attr);
+    if (node != InvalidIndex)
     {
         ret = this->GetVec4(attr);
         return true;
@@ -1321,8 +1306,8 @@ template<> bool JsonReader::GetOpt<Math::quat>(Math::quat & ret, const char* att
 template<> bool JsonReader::GetOpt<Math::mat4>(Math::mat4 & ret, const char* attr)
 {
     //FIXME this searches twice
-    const value_variant * node = this->GetChild(attr);
-    if (node)
+    const IndexT node = this->GetChild(attr);
+    if (node != InvalidIndex)
     {
         ret = this->GetMat4(attr);
         return true;
@@ -1334,11 +1319,11 @@ template<> bool JsonReader::GetOpt<Math::mat4>(Math::mat4 & ret, const char* att
 */
 template<> bool JsonReader::GetOpt<Util::String>(Util::String & ret, const char* attr)
 {
-    const value_variant * node = this->GetChild(attr);
-    if (node)
+    const IndexT node = this->GetChild(attr);
+    if (node != InvalidIndex)
     {
-        n_assert(node->is_string());
-        ret = node->as_string_ptr();
+        n_assert(this->index->IsString(node));
+        ret = this->index->GetString(node);
         return true;
     }
     return false;
@@ -1349,16 +1334,17 @@ template<> bool JsonReader::GetOpt<Util::String>(Util::String & ret, const char*
 */
 template<> bool JsonReader::GetOpt<Util::Array<int>>(Util::Array<int> & target, const char* attr)
 {
-    const value_variant * node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
 
-    if (node)
+    if (node != InvalidIndex)
     {
-        n_assert(node->is_array());
-        unsigned int count = node->size();
+        n_assert(this->index->IsArray(node));
+        unsigned int count = this->index->Size(node);
         target.Reserve(count);
-        for (unsigned int i = 0; i < count; i++)
+        IndexT child;
+        for (child = this->index->GetFirstChild(node); child != InvalidIndex; child = this->index->GetNextSibling(child))
         {
-            target.Append(node->get_value_at_index(i).as_int32());
+            target.Append((int)this->index->GetInt64(child));
         }
         return true;
     }
@@ -1370,16 +1356,17 @@ template<> bool JsonReader::GetOpt<Util::Array<int>>(Util::Array<int> & target,
 */
 template<> bool JsonReader::GetOpt<Util::Array<uint32_t>>(Util::Array<uint32_t> & target, const char* attr)
 {
-    const value_variant * node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
 
-    if (node)
+    if (node != InvalidIndex)
     {
-        n_assert(node->is_array());
-        unsigned int count = node->size();
+        n_assert(this->index->IsArray(node));
+        unsigned int count = this->index->Size(node);
         target.Reserve(count);
-        for (unsigned int i = 0; i < count; i++)
+        IndexT child;
+        for (child = this->index->GetFirstChild(node); child != InvalidIndex; child = this->index->GetNextSibling(child))
         {
-            target.Append(node->get_value_at_index(i).as_int32());
+            target.Append((int)this->index->GetInt64(child));
         }
         return true;
     }
@@ -1391,16 +1378,17 @@ template<> bool JsonReader::GetOpt<Util::Array<uint32_t>>(Util::Array<uint32_t>
 */
 template<> bool JsonReader::GetOpt<Util::Array<float>>(Util::Array<float> & target, const char* attr)
 {
-    const value_variant * node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
     
-    if (node)
+    if (node != InvalidIndex)
     {
-        n_assert(node->is_array());
-        unsigned int count = node->size();
+        n_assert(this->index->IsArray(node));
+        unsigned int count = this->index->Size(node);
         target.Reserve(count);
-        for (unsigned int i = 0; i < count; i++)
+        IndexT child;
+        for (child = this->index->GetFirstChild(node); child != InvalidIndex; child = this->index->GetNextSibling(child))
         {
-            target.Append(node->get_value_at_index(i).as_float());
+            target.Append((float)this->index->GetDouble(child));
         }
         return true;
     }
@@ -1412,16 +1400,17 @@ template<> bool JsonReader::GetOpt<Util::Array<float>>(Util::Array<float> & targ
 */
 template<> bool JsonReader::GetOpt<Util::Array<Util::String>>(Util::Array<Util::String> & target, const char* attr)
 {
-    const value_variant * node = this->GetChild(attr);
+    const IndexT node = this->GetChild(attr);
 
-    if (node)
+    if (node != InvalidIndex)
     {
-        n_assert(node->is_array());
-        unsigned int count = node->size();
+        n_assert(this->index->IsArray(node));
+        unsigned int count = this->index->Size(node);
         target.Reserve(count);
-        for (unsigned int i = 0; i < count; i++)
+        IndexT child;
+        for (child = this->index->GetFirstChild(node); child != InvalidIndex; child = this->index->GetNextSibling(child))
         {
-            target.Append(node->get_value_at_index(i).as_string_ptr());
+            target.Append(this->index->GetString(child));
         }
         return true;
     }
@@ -4,8 +4,9 @@
     @class IO::JsonReader
   
     Reads json formatted data with random access from a stream using 
-    pjson as backend. The json document is represented as a tree of
-    nodes, which can be navigated and queried.
+    a JsonIndex as backend. The json document is represented as a tree of
+    nodes, which can be navigated and queried. Values are only parsed
+    when they are read.
         
     @copyright
     (C) 2018-2020 Individual contributors, see AUTHORS file
@@ -17,17 +18,15 @@
 #include "util/stack.h"
 #include "util/array.h"
 #include "util/stringatom.h"
+#include "util/stringbuilder.h"
 #include "util/bitfield.h"
 #include "util/variant.h"
 
-namespace pjson
-{
-    class value_variant;
-    class document;
-}
 //------------------------------------------------------------------------------
 namespace IO
 {
+class JsonIndex;
+
 class JsonReader : public StreamReader
 {
     __DeclareClass(JsonReader);
@@ -126,14 +125,16 @@ public:
     template<typename T> bool GetOpt(T& target, const char* attr, const T& _default);
 
 private:  
-    ///
-    const pjson::value_variant* GetChild(const char * key = 0) const;
+    /// get the current node, or an attribute of the current node
+    IndexT GetChild(const char * key = 0) const;
+    /// read the first num elements of an array
+    void GetFloats(IndexT node, float* out, SizeT num) const;
        
-    pjson::document* document;
-    const pjson::value_variant* curNode;
-    IndexT childIdx = -1;
-    Util::Stack<const pjson::value_variant*> parents;
-    Util::Stack<IndexT> parentIdx;
+    JsonIndex* index;
+    IndexT curNode;
+    Util::Stack<IndexT> parents;
+    // scratch space for unescaping strings which are turned into atoms
+    mutable Util::StringBuilder atomScratch;
     // 0 terminated buffer containing the raw json file
     char * buffer = nullptr;
 };
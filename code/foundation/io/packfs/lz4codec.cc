@@ -0,0 +1,245 @@
+//------------------------------------------------------------------------------
+//  lz4codec.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "foundation/stdneb.h"
+#include "io/packfs/lz4codec.h"
+#include "math/scalar.h"
+
+namespace IO
+{
+
+static const SizeT MinMatch = 4;
+static const SizeT LastLiterals = 5;            // the last 5 bytes of a block are always literals
+static const SizeT MatchFindLimit = 12;         // the last match must start at least 12 bytes before the end
+static const SizeT MaxOffset = 65535;
+static const uint HashBits = 14;
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline uint
+Read32(const uchar* ptr)
+{
+    uint val;
+    memcpy(&val, ptr, sizeof(val));
+    return val;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline uint
+Hash(uint sequence)
+{
+    return (sequence * 2654435761u) >> (32 - HashBits);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Write a length continuation of a token nibble, returns the new output pointer
+    or nullptr if it doesn't fit.
+*/
+static inline uchar*
+WriteLength(uchar* op, const uchar* end, SizeT length)
+{
+    while (length >= 255)
+    {
+        if (op >= end)
+            return nullptr;
+        *op++ = 255;
+        length -= 255;
+    }
+    if (op >= end)
+        return nullptr;
+    *op++ = (uchar)length;
+    return op;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Write a sequence of literals followed by a match, a matchLength of 0 writes
+    the literals of the last sequence.
+*/
+static inline uchar*
+WriteSequence(uchar* op, const uchar* end, const uchar* literals, SizeT numLiterals, SizeT offset, SizeT matchLength)
+{
+    if (op >= end)
+        return nullptr;
+    uchar* token = op++;
+    *token = (uchar)(Math::min(numLiterals, (SizeT)15) << 4);
+    if (numLiterals >= 15)
+    {
+        op = WriteLength(op, end, numLiterals - 15);
+        if (op == nullptr)
+            return nullptr;
+    }
+    if (op + numLiterals > end)
+        return nullptr;
+    memcpy(op, literals, numLiterals);
+    op += numLiterals;
+
+    if (matchLength > 0)
+    {
+        const SizeT length = matchLength - MinMatch;
+        if (op + 2 > end)
+            return nullptr;
+        *op++ = (uchar)(offset & 0xFF);
+        *op++ = (uchar)(offset >> 8);
+        *token |= (uchar)Math::min(length, (SizeT)15);
+        if (length >= 15)
+        {
+            op = WriteLength(op, end, length - 15);
+        }
+    }
+    return op;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+Lz4Codec::Compress(const void* src, SizeT srcSize, void* dst, SizeT dstCapacity)
+{
+    const uchar* base = (const uchar*)src;
+    uchar* op = (uchar*)dst;
+    const uchar* opEnd = op + dstCapacity;
+    const uchar* anchor = base;
+
+    if (srcSize > (SizeT)MatchFindLimit)
+    {
+        // positions of the last occurences of hashed 4 byte sequences
+        int table[1 << HashBits];
+        memset(table, 0xFF, sizeof(table));
+
+        const uchar* ip = base;
+        const uchar* matchFindEnd = base + srcSize - MatchFindLimit;
+        const uchar* matchEnd = base + srcSize - LastLiterals;
+        uint misses = 0;
+        while (ip < matchFindEnd)
+        {
+            const uint sequence = Read32(ip);
+            const uint hash = Hash(sequence);
+            const int candidate = table[hash];
+            table[hash] = (int)(ip - base);
+
+            if (candidate < 0 || (SizeT)(ip - base - candidate) > MaxOffset || Read32(base + candidate) != sequence)
+            {
+                // skip ahead faster through incompressible data
+                ip += 1 + (misses++ >> 6);
+                continue;
+            }
+            misses = 0;
+
+            // extend the match forwards, and backwards over pending literals
+            const uchar* match = base + candidate;
+            const uchar* end = ip + MinMatch;
+            while (end < matchEnd && *end == *(match + (end - ip)))
+                end++;
+            while (ip > anchor && match > base && ip[-1] == match[-1])
+            {
+                ip--;
+                match--;
+            }
+
+            op = WriteSequence(op, opEnd, anchor, ip - anchor, ip - match, end - ip);
+            if (op == nullptr)
+                return 0;
+
+            // make the position just before the end of the match findable for the next one
+            ip = end;
+            anchor = ip;
+            if (ip - 2 >= base && ip < matchFindEnd)
+            {
+                table[Hash(Read32(ip - 2))] = (int)(ip - 2 - base);
+            }
+        }
+    }
+
+    // the remainder goes into the last sequence as literals
+    op = WriteSequence(op, opEnd, anchor, base + srcSize - anchor, 0, 0);
+    if (op == nullptr)
+        return 0;
+    return (SizeT)(op - (uchar*)dst);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+Lz4Codec::Decompress(const void* src, SizeT srcSize, void* dst, SizeT dstSize)
+{
+    const uchar* ip = (const uchar*)src;
+    const uchar* ipEnd = ip + srcSize;
+    uchar* op = (uchar*)dst;
+    uchar* opBase = op;
+    uchar* opEnd = op + dstSize;
+
+    while (ip < ipEnd)
+    {
+        const uint token = *ip++;
+
+        // literals
+        SizeT numLiterals = token >> 4;
+        if (numLiterals == 15)
+        {
+            uint next;
+            do
+            {
+                if (ip >= ipEnd)
+                    return false;
+                next = *ip++;
+                numLiterals += next;
+            } while (next == 255);
+        }
+        if ((SizeT)(ipEnd - ip) < numLiterals || (SizeT)(opEnd - op) < numLiterals)
+            return false;
+        memcpy(op, ip, numLiterals);
+        ip += numLiterals;
+        op += numLiterals;
+
+        // the last sequence has no match
+        if (ip == ipEnd)
+            break;
+
+        // match
+        if (ipEnd - ip < 2)
+            return false;
+        const SizeT offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || (SizeT)(op - opBase) < offset)
+            return false;
+        SizeT matchLength = token & 15;
+        if (matchLength == 15)
+        {
+            uint next;
+            do
+            {
+                if (ip >= ipEnd)
+                    return false;
+                next = *ip++;
+                matchLength += next;
+            } while (next == 255);
+        }
+        matchLength += MinMatch;
+        if ((SizeT)(opEnd - op) < matchLength)
+            return false;
+
+        const uchar* match = op - offset;
+        if (offset >= matchLength)
+        {
+            memcpy(op, match, matchLength);
+            op += matchLength;
+        }
+        else
+        {
+            // overlapping match, repeats the last offset bytes
+            const uchar* end = op + matchLength;
+            while (op < end)
+                *op++ = *match++;
+        }
+    }
+    return op == opEnd;
+}
+
+} // namespace IO
@@ -0,0 +1,43 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class IO::Lz4Codec
+
+    Compressor and decompressor for the LZ4 block format, used for the chunks
+    of pack archives.
+
+    The compressor is a greedy single pass matcher which trades some ratio for
+    speed, the decompressor is bounds checked and safe to use on untrusted data.
+    Blocks written by the compressor can be read by any LZ4 block decoder and
+    vice versa.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "core/types.h"
+
+//------------------------------------------------------------------------------
+namespace IO
+{
+class Lz4Codec
+{
+public:
+    /// get the worst case size of a compressed block
+    static SizeT CompressBound(SizeT srcSize);
+    /// compress a block, returns the compressed size, or 0 if it doesn't fit into dst
+    static SizeT Compress(const void* src, SizeT srcSize, void* dst, SizeT dstCapacity);
+    /// decompress a block, returns false if the block is malformed or doesn't decompress to exactly dstSize bytes
+    static bool Decompress(const void* src, SizeT srcSize, void* dst, SizeT dstSize);
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+Lz4Codec::CompressBound(SizeT srcSize)
+{
+    return srcSize + srcSize / 255 + 16;
+}
+
+} // namespace IO
+//------------------------------------------------------------------------------
@@ -0,0 +1,459 @@
+//------------------------------------------------------------------------------
+//  packarchive.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "foundation/stdneb.h"
+#include "io/packfs/packarchive.h"
+#include "io/packfs/lz4codec.h"
+#include "io/assignregistry.h"
+#include "io/ioserver.h"
+
+namespace IO
+{
+__ImplementClass(IO::PackArchive, 'PKAR', IO::ArchiveBase);
+
+using namespace Util;
+
+//------------------------------------------------------------------------------
+/**
+*/
+PackArchive::PackArchive() :
+    archiveData(nullptr),
+    archiveSize(0),
+    header(nullptr),
+    files(nullptr),
+    dirs(nullptr),
+    chunks(nullptr),
+    children(nullptr),
+    hashTable(nullptr),
+    strings(nullptr)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+PackArchive::~PackArchive()
+{
+    if (this->IsValid())
+    {
+        this->Discard();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Maps the archive and validates its index. Returns false if the archive
+    doesn't exist, can't be mapped or is corrupt.
+*/
+bool
+PackArchive::Setup(const URI& packFileURI, const String& rootPathOverride)
+{
+    n_assert(!this->IsValid());
+    if (!ArchiveBase::Setup(packFileURI, rootPathOverride))
+    {
+        return false;
+    }
+
+    // extract the root location of the archive
+    if (!rootPathOverride.IsEmpty())
+    {
+        this->rootPath = AssignRegistry::Instance()->ResolveAssigns(rootPathOverride).LocalPath() + "/";
+    }
+    else
+    {
+        this->rootPath = this->uri.LocalPath().ExtractDirName();
+    }
+
+    URI absPath = AssignRegistry::Instance()->ResolveAssigns(this->uri);
+    String realPath = absPath.AsString();
+    realPath.Append(".npk");
+    this->archiveStream = IoServer::Instance()->CreateStream(realPath);
+    this->archiveStream->SetAccessMode(Stream::ReadAccess);
+    if (this->archiveStream->CanBeMapped() && this->archiveStream->Open())
+    {
+        this->archiveSize = this->archiveStream->GetSize();
+        if (this->archiveSize >= (Stream::Size)sizeof(PackFormat::Header))
+        {
+            this->archiveData = (const unsigned char*)this->archiveStream->MemoryMap();
+            this->header = (const PackFormat::Header*)this->archiveData;
+            if (this->ValidateIndex())
+            {
+                this->files = (const PackFormat::File*)(this->archiveData + this->header->filesOffset);
+                this->dirs = (const PackFormat::Dir*)(this->archiveData + this->header->dirsOffset);
+                this->chunks = (const PackFormat::Chunk*)(this->archiveData + this->header->chunksOffset);
+                this->children = (const uint*)(this->archiveData + this->header->childrenOffset);
+                this->hashTable = (const uint*)(this->archiveData + this->header->hashTableOffset);
+                this->strings = (const char*)(this->archiveData + this->header->stringsOffset);
+                return true;
+            }
+            n_warning("PackArchive: '%s' is not a valid pack archive\n", realPath.AsCharPtr());
+        }
+    }
+
+    // fallthrough: failure
+    this->Discard();
+    return false;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PackArchive::Discard()
+{
+    n_assert(this->IsValid());
+    if (this->archiveStream.isvalid())
+    {
+        if (this->archiveStream->IsOpen())
+        {
+            if (this->archiveData != nullptr)
+            {
+                this->archiveStream->MemoryUnmap();
+            }
+            this->archiveStream->Close();
+        }
+        this->archiveStream = nullptr;
+    }
+    this->archiveData = nullptr;
+    this->archiveSize = 0;
+    this->header = nullptr;
+    this->files = nullptr;
+    this->dirs = nullptr;
+    this->chunks = nullptr;
+    this->children = nullptr;
+    this->hashTable = nullptr;
+    this->strings = nullptr;
+    ArchiveBase::Discard();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Checks that every offset and index in the archive points into the
+    archive, so lookups and reads never have to.
+*/
+bool
+PackArchive::ValidateIndex() const
+{
+    const PackFormat::Header& h = *this->header;
+    const uint64 size = (uint64)this->archiveSize;
+    if (h.magic != PackFormat::Magic || h.version != PackFormat::Version)
+    {
+        return false;
+    }
+    if (h.chunkSize == 0 || h.numDirs == 0 || h.hashTableSize == 0 || (h.hashTableSize & (h.hashTableSize - 1)) != 0
+        || ((h.numFiles | h.numDirs) & PackFormat::DirFlag) != 0 || h.hashTableSize <= h.numFiles + h.numDirs)
+    {
+        return false;
+    }
+
+    // tables must lie within the archive and be aligned for direct access
+    auto tableValid = [size](uint64 offset, uint64 count, uint64 elementSize) -> bool
+    {
+        return (offset % 8) == 0 && offset <= size && count <= (size - offset) / elementSize;
+    };
+    if (!tableValid(h.filesOffset, h.numFiles, sizeof(PackFormat::File))
+        || !tableValid(h.dirsOffset, h.numDirs, sizeof(PackFormat::Dir))
+        || !tableValid(h.chunksOffset, h.numChunks, sizeof(PackFormat::Chunk))
+        || !tableValid(h.childrenOffset, h.numChildren, sizeof(uint))
+        || !tableValid(h.hashTableOffset, h.hashTableSize, sizeof(uint))
+        || h.stringsOffset > size || h.stringsSize > size - h.stringsOffset)
+    {
+        return false;
+    }
+
+    const PackFormat::File* fileTable = (const PackFormat::File*)(this->archiveData + h.filesOffset);
+    const PackFormat::Dir* dirTable = (const PackFormat::Dir*)(this->archiveData + h.dirsOffset);
+    const PackFormat::Chunk* chunkTable = (const PackFormat::Chunk*)(this->archiveData + h.chunksOffset);
+    const uint* childTable = (const uint*)(this->archiveData + h.childrenOffset);
+    const uint* slots = (const uint*)(this->archiveData + h.hashTableOffset);
+
+    uint i;
+    for (i = 0; i < h.numFiles; i++)
+    {
+        const PackFormat::File& file = fileTable[i];
+        if ((uint64)file.pathOffset + file.pathLength > h.stringsSize || file.dir >= h.numDirs)
+        {
+            return false;
+        }
+        if (file.codec == PackFormat::Stored)
+        {
+            if (file.dataOffset > size || file.size > size - file.dataOffset)
+            {
+                return false;
+            }
+        }
+        else if (file.codec == PackFormat::Lz4)
+        {
+            if ((uint64)file.firstChunk + file.numChunks > h.numChunks
+                || (uint64)file.numChunks != (file.size + h.chunkSize - 1) / h.chunkSize)
+            {
+                return false;
+            }
+            uint j;
+            for (j = 0; j < file.numChunks; j++)
+            {
+                const PackFormat::Chunk& chunk = chunkTable[file.firstChunk + j];
+                const uint64 chunkSize = Math::min((uint64)h.chunkSize, file.size - (uint64)j * h.chunkSize);
+                if (chunk.size != chunkSize || chunk.compressedSize > chunk.size
+                    || chunk.offset > size || chunk.compressedSize > size - chunk.offset)
+                {
+                    return false;
+                }
+            }
+        }
+        else
+        {
+            return false;
+        }
+    }
+    for (i = 0; i < h.numDirs; i++)
+    {
+        const PackFormat::Dir& dir = dirTable[i];
+        if ((uint64)dir.pathOffset + dir.pathLength > h.stringsSize
+            || (uint64)dir.firstFile + dir.numFiles > h.numFiles
+            || (uint64)dir.firstChild + dir.numChildren > h.numChildren)
+        {
+            return false;
+        }
+    }
+    for (i = 0; i < h.numChildren; i++)
+    {
+        if (childTable[i] >= h.numDirs)
+        {
+            return false;
+        }
+    }
+    uint numEmptySlots = 0;
+    for (i = 0; i < h.hashTableSize; i++)
+    {
+        const uint slot = slots[i];
+        if (slot == PackFormat::EmptySlot)
+        {
+            numEmptySlots++;
+        }
+        else if ((slot & PackFormat::DirFlag) ? (slot & ~PackFormat::DirFlag) >= h.numDirs : slot >= h.numFiles)
+        {
+            return false;
+        }
+    }
+
+    // lookups probe until they hit an empty slot
+    return numEmptySlots > 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Convert backslashes and strip leading and trailing slashes, this is how
+    paths are stored in the archive.
+*/
+String
+PackArchive::NormalizePath(const String& path)
+{
+    String normalized = path;
+    normalized.SubstituteChar('\\', '/');
+    normalized.Trim("/");
+    return normalized;
+}
+
+//------------------------------------------------------------------------------
+/**
+    The hash table always has free slots, so the probe terminates.
+*/
+IndexT
+PackArchive::Find(const String& path, bool dir) const
+{
+    n_assert(this->IsValid());
+    const uint64 hash = PackFormat::HashPath(path.AsCharPtr(), path.Length());
+    const uint mask = this->header->hashTableSize - 1;
+    uint slotIndex = (uint)hash & mask;
+    for (;;)
+    {
+        const uint slot = this->hashTable[slotIndex];
+        if (slot == PackFormat::EmptySlot)
+        {
+            return InvalidIndex;
+        }
+
+        const bool isDir = (slot & PackFormat::DirFlag) != 0;
+        const uint index = slot & ~PackFormat::DirFlag;
+        uint64 entryHash;
+        uint pathOffset, pathLength;
+        if (isDir)
+        {
+            entryHash = this->dirs[index].pathHash;
+            pathOffset = this->dirs[index].pathOffset;
+            pathLength = this->dirs[index].pathLength;
+        }
+        else
+        {
+            entryHash = this->files[index].pathHash;
+            pathOffset = this->files[index].pathOffset;
+            pathLength = this->files[index].pathLength;
+        }
+        if (entryHash == hash && pathLength == (uint)path.Length() && 0 == memcmp(this->strings + pathOffset, path.AsCharPtr(), pathLength))
+        {
+            // a path is either a file or a directory
+            return isDir == dir ? (IndexT)index : InvalidIndex;
+        }
+        slotIndex = (slotIndex + 1) & mask;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+IndexT
+PackArchive::FindFile(const String& pathInArchive) const
+{
+    return this->Find(NormalizePath(pathInArchive), false);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+IndexT
+PackArchive::FindDir(const String& pathInArchive) const
+{
+    return this->Find(NormalizePath(pathInArchive), true);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Chunks are independent of each other, so any number of threads may decode
+    different chunks of the same file at once.
+*/
+bool
+PackArchive::DecodeChunk(const PackFormat::File& file, IndexT chunkIndex, void* fileBuffer) const
+{
+    n_assert(file.codec == PackFormat::Lz4);
+    n_assert((uint)chunkIndex < file.numChunks);
+    const PackFormat::Chunk& chunk = this->chunks[file.firstChunk + chunkIndex];
+    const unsigned char* src = this->archiveData + chunk.offset;
+    unsigned char* dst = (unsigned char*)fileBuffer + (uint64)chunkIndex * this->header->chunkSize;
+    if (chunk.compressedSize == chunk.size)
+    {
+        // incompressible chunk
+        memcpy(dst, src, chunk.size);
+        return true;
+    }
+    return Lz4Codec::Decompress(src, chunk.compressedSize, dst, chunk.size);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+String
+PackArchive::GetName(uint pathOffset, uint pathLength) const
+{
+    const char* path = this->strings + pathOffset;
+    uint start = pathLength;
+    while (start > 0 && path[start - 1] != '/')
+    {
+        start--;
+    }
+    String name;
+    name.Set(path + start, (SizeT)(pathLength - start));
+    return name;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Array<String>
+PackArchive::ListFiles(const String& dirPathInArchive, const String& pattern) const
+{
+    Array<String> result;
+    IndexT dirIndex = this->FindDir(dirPathInArchive);
+    if (InvalidIndex != dirIndex)
+    {
+        const PackFormat::Dir& dir = this->dirs[dirIndex];
+        String fileName;
+        uint i;
+        for (i = dir.firstFile; i < dir.firstFile + dir.numFiles; i++)
+        {
+            fileName = this->GetName(this->files[i].pathOffset, this->files[i].pathLength);
+            if (String::MatchPattern(fileName, pattern))
+            {
+                result.Append(fileName);
+            }
+        }
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Array<String>
+PackArchive::ListDirectories(const String& dirPathInArchive, const String& pattern) const
+{
+    Array<String> result;
+    IndexT dirIndex = this->FindDir(dirPathInArchive);
+    if (InvalidIndex != dirIndex)
+    {
+        const PackFormat::Dir& dir = this->dirs[dirIndex];
+        String subDirName;
+        uint i;
+        for (i = dir.firstChild; i < dir.firstChild + dir.numChildren; i++)
+        {
+            const PackFormat::Dir& subDir = this->dirs[this->children[i]];
+            subDirName = this->GetName(subDir.pathOffset, subDir.pathLength);
+            if (String::MatchPattern(subDirName, pattern))
+            {
+                result.Append(subDirName);
+            }
+        }
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+String
+PackArchive::ConvertToPathInArchive(const String& absPath) const
+{
+    // test if the absolute path starts with our root path
+    IndexT rootPathIndex = absPath.FindStringIndex(this->rootPath, 0);
+    if (0 == rootPathIndex)
+    {
+        // strip the root path from the absolute path
+        String localPath = absPath;
+        localPath.SubstituteString(this->rootPath, "");
+        return localPath;
+    }
+    // path doesn't point into this archive
+    return "";
+}
+
+//------------------------------------------------------------------------------
+/**
+    This method takes a normal "file:" scheme URI and convertes it into
+    a "pack:" scheme URI which points to the file in this archive. This
+    is used by the IoServer for transparent file access into pack archives.
+*/
+URI
+PackArchive::ConvertToArchiveURI(const URI& fileURI) const
+{
+    n_assert(fileURI.LocalPath().IsValid());
+
+    // localize path into archive, fail hard if URI doesn't point into archive
+    String localPath = this->ConvertToPathInArchive(fileURI.LocalPath());
+    if (!localPath.IsValid())
+    {
+        n_error("PackArchive::ConvertToArchiveURI(): file '%s' doesn't point into this pack archive (%s)!\n",
+            fileURI.AsString().AsCharPtr(), this->uri.AsString().AsCharPtr());
+    }
+
+    URI packURI = this->uri;
+    packURI.SetScheme("pack");
+    String query;
+    query.Append("file=");
+    query.Append(localPath);
+    packURI.SetQuery(query);
+    return packURI;
+}
+
+} // namespace IO
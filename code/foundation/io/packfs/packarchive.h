@@ -0,0 +1,107 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class IO::PackArchive
+
+    Private helper class for PackFileSystem to hold per-archive data.
+
+    The archive file is memory mapped once and never copied, lookups of files
+    and directories go straight through the hash table in the mapped index, so
+    mounting is cheap and finding a file is O(1) regardless of the number of
+    files in the archive. The index is validated when the archive is mounted,
+    so everything after that can trust the offsets it contains.
+
+    Since all data is read from the mapping, the archive can be accessed from
+    any number of threads at once without locking.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "io/archfs/archivebase.h"
+#include "io/packfs/packformat.h"
+#include "io/stream.h"
+
+//------------------------------------------------------------------------------
+namespace IO
+{
+class PackArchive : public ArchiveBase
+{
+    __DeclareClass(PackArchive);
+public:
+    /// constructor
+    PackArchive();
+    /// destructor
+    virtual ~PackArchive();
+
+    /// setup the archive from an URI (without file extension)
+    bool Setup(const URI& uri, const Util::String& rootPath = "");
+    /// discard the archive
+    void Discard();
+
+    /// list all files in a directory in the archive
+    Util::Array<Util::String> ListFiles(const Util::String& dirPathInArchive, const Util::String& pattern) const;
+    /// list all subdirectories in a directory in the archive
+    Util::Array<Util::String> ListDirectories(const Util::String& dirPathInArchive, const Util::String& pattern) const;
+    /// convert a "file:" URI into a "pack:" URI pointing into this archive
+    URI ConvertToArchiveURI(const URI& fileURI) const;
+    /// convert an absolute path to local path inside archive, returns empty string if absPath doesn't point into this archive
+    Util::String ConvertToPathInArchive(const Util::String& absPath) const;
+
+    /// find a file in the archive, returns InvalidIndex if it doesn't exist
+    IndexT FindFile(const Util::String& pathInArchive) const;
+    /// find a directory in the archive, returns InvalidIndex if it doesn't exist
+    IndexT FindDir(const Util::String& pathInArchive) const;
+    /// get a file entry by index
+    const PackFormat::File& GetFile(IndexT fileIndex) const;
+    /// get the data of a stored file inside the mapped archive
+    const void* GetStoredData(const PackFormat::File& file) const;
+    /// decompress a chunk of a compressed file into the file's buffer
+    bool DecodeChunk(const PackFormat::File& file, IndexT chunkIndex, void* fileBuffer) const;
+
+    /// normalize a path into the archive for lookup
+    static Util::String NormalizePath(const Util::String& path);
+
+private:
+    /// lookup a normalized path in the hash table
+    IndexT Find(const Util::String& path, bool dir) const;
+    /// validate the index of the mapped archive, returns false if it is corrupt
+    bool ValidateIndex() const;
+    /// get the name component of a path in the string table
+    Util::String GetName(uint pathOffset, uint pathLength) const;
+
+    Util::String rootPath;                      // location of the pack archive file
+    Ptr<Stream> archiveStream;                  // the archive file, memory mapped
+    const unsigned char* archiveData;
+    Stream::Size archiveSize;
+
+    const PackFormat::Header* header;
+    const PackFormat::File* files;
+    const PackFormat::Dir* dirs;
+    const PackFormat::Chunk* chunks;
+    const uint* children;
+    const uint* hashTable;
+    const char* strings;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const PackFormat::File&
+PackArchive::GetFile(IndexT fileIndex) const
+{
+    n_assert((uint)fileIndex < this->header->numFiles);
+    return this->files[fileIndex];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const void*
+PackArchive::GetStoredData(const PackFormat::File& file) const
+{
+    n_assert(file.codec == PackFormat::Stored);
+    return this->archiveData + file.dataOffset;
+}
+
+} // namespace IO
+//------------------------------------------------------------------------------
@@ -0,0 +1,415 @@
+//------------------------------------------------------------------------------
+//  packarchivewriter.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "foundation/stdneb.h"
+#include "io/packfs/packarchivewriter.h"
+#include "io/packfs/packarchive.h"
+#include "io/packfs/lz4codec.h"
+#include "io/ioserver.h"
+
+namespace IO
+{
+__ImplementClass(IO::PackArchiveWriter, 'PKAW', Core::RefCounted);
+
+using namespace Util;
+
+//------------------------------------------------------------------------------
+/**
+*/
+PackArchiveWriter::PackArchiveWriter() :
+    minCompressionRatio(0.9f),
+    numStored(0),
+    numCompressed(0),
+    uncompressedSize(0),
+    archiveSize(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+PackArchiveWriter::~PackArchiveWriter()
+{
+    if (this->IsOpen())
+    {
+        this->Close();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+PackArchiveWriter::Open(const URI& uri)
+{
+    n_assert(!this->IsOpen());
+    this->stream = IoServer::Instance()->CreateStream(uri);
+    this->stream->SetAccessMode(Stream::WriteAccess);
+    if (!this->stream->Open())
+    {
+        this->stream = nullptr;
+        return false;
+    }
+
+    // the header is written on close, reserve room for it
+    PackFormat::Header header;
+    memset(&header, 0, sizeof(header));
+    this->stream->Write(&header, sizeof(header));
+
+    this->files.Clear();
+    this->chunks.Clear();
+    this->numStored = 0;
+    this->numCompressed = 0;
+    this->uncompressedSize = 0;
+    this->archiveSize = 0;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PackArchiveWriter::Align(uint64 alignment)
+{
+    static const char zeros[PackFormat::Alignment] = { 0 };
+    n_assert(alignment <= PackFormat::Alignment);
+    const uint64 position = (uint64)this->stream->GetPosition();
+    const uint64 padding = (alignment - position % alignment) % alignment;
+    if (padding > 0)
+    {
+        this->stream->Write(zeros, (Stream::Size)padding);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PackArchiveWriter::AddFile(const String& pathInArchive, const void* data, SizeT size, bool compress)
+{
+    n_assert(this->IsOpen());
+    n_assert(size >= 0);
+
+    FileInfo info;
+    info.path = PackArchive::NormalizePath(pathInArchive);
+    n_assert(info.path.IsValid());
+    IndexT lastSlash = info.path.FindCharIndex('/', 0);
+    IndexT nextSlash = lastSlash;
+    while (nextSlash != InvalidIndex)
+    {
+        lastSlash = nextSlash;
+        nextSlash = info.path.FindCharIndex('/', lastSlash + 1);
+    }
+    if (lastSlash != InvalidIndex)
+    {
+        info.dirPath = info.path.ExtractRange(0, lastSlash);
+    }
+    memset(&info.file, 0, sizeof(info.file));
+    info.file.pathHash = PackFormat::HashPath(info.path.AsCharPtr(), info.path.Length());
+    info.file.size = (uint64)size;
+    info.file.dir = this->files.Size();      // add order until the index is built
+    this->uncompressedSize += (uint64)size;
+
+    if (compress && size > 0)
+    {
+        const SizeT numChunks = (size + PackFormat::ChunkSize - 1) / PackFormat::ChunkSize;
+        const SizeT bound = Lz4Codec::CompressBound(PackFormat::ChunkSize);
+        unsigned char* compressed = (unsigned char*)Memory::Alloc(Memory::ScratchHeap, (size_t)numChunks * bound);
+        Array<PackFormat::Chunk> fileChunks;
+        fileChunks.Reserve(numChunks);
+
+        // compress chunks back to back, incompressible chunks are copied
+        const unsigned char* src = (const unsigned char*)data;
+        uint64 compressedSize = 0;
+        IndexT i;
+        for (i = 0; i < numChunks; i++)
+        {
+            PackFormat::Chunk chunk;
+            chunk.offset = compressedSize;
+            chunk.size = (uint)Math::min((SizeT)PackFormat::ChunkSize, size - i * (SizeT)PackFormat::ChunkSize);
+            const unsigned char* chunkSrc = src + (uint64)i * PackFormat::ChunkSize;
+            SizeT chunkCompressedSize = Lz4Codec::Compress(chunkSrc, chunk.size, compressed + compressedSize, bound);
+            if (chunkCompressedSize == 0 || chunkCompressedSize >= (SizeT)chunk.size)
+            {
+                memcpy(compressed + compressedSize, chunkSrc, chunk.size);
+                chunkCompressedSize = chunk.size;
+            }
+            chunk.compressedSize = (uint)chunkCompressedSize;
+            compressedSize += chunkCompressedSize;
+            fileChunks.Append(chunk);
+        }
+
+        if ((float)compressedSize <= (float)size * this->minCompressionRatio)
+        {
+            const uint64 position = (uint64)this->stream->GetPosition();
+            this->stream->Write(compressed, (Stream::Size)compressedSize);
+            Memory::Free(Memory::ScratchHeap, compressed);
+
+            info.file.codec = PackFormat::Lz4;
+            info.file.dataOffset = position;
+            info.file.firstChunk = this->chunks.Size();
+            info.file.numChunks = numChunks;
+            for (i = 0; i < fileChunks.Size(); i++)
+            {
+                fileChunks[i].offset += position;
+                this->chunks.Append(fileChunks[i]);
+            }
+            this->files.Append(info);
+            this->numCompressed++;
+            return;
+        }
+        Memory::Free(Memory::ScratchHeap, compressed);
+    }
+
+    // stored files are page aligned, so they can be mapped in place
+    this->Align(PackFormat::Alignment);
+    info.file.codec = PackFormat::Stored;
+    info.file.dataOffset = (uint64)this->stream->GetPosition();
+    if (size > 0)
+    {
+        this->stream->Write(data, size);
+    }
+    this->files.Append(info);
+    this->numStored++;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+PackArchiveWriter::AddFile(const String& pathInArchive, const URI& srcUri, bool compress)
+{
+    Ptr<Stream> srcStream = IoServer::Instance()->CreateStream(srcUri);
+    srcStream->SetAccessMode(Stream::ReadAccess);
+    if (!srcStream->Open())
+    {
+        return false;
+    }
+    const SizeT size = (SizeT)srcStream->GetSize();
+    if (size > 0 && srcStream->CanBeMapped())
+    {
+        const void* data = srcStream->Map();
+        this->AddFile(pathInArchive, data, size, compress);
+        srcStream->Unmap();
+    }
+    else
+    {
+        void* data = Memory::Alloc(Memory::ScratchHeap, Math::max(size, 1));
+        const SizeT bytesRead = (SizeT)srcStream->Read(data, size);
+        this->AddFile(pathInArchive, data, bytesRead, compress);
+        Memory::Free(Memory::ScratchHeap, data);
+    }
+    srcStream->Close();
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+uint64
+PackArchiveWriter::WriteTable(const void* data, SizeT size)
+{
+    this->Align(8);
+    const uint64 offset = (uint64)this->stream->GetPosition();
+    if (size > 0)
+    {
+        this->stream->Write(data, size);
+    }
+    return offset;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Builds the directory tree and the hash table from the added files and
+    writes them along with the header.
+*/
+bool
+PackArchiveWriter::Close()
+{
+    n_assert(this->IsOpen());
+
+    // sort files by directory, so the files of a directory are contiguous
+    this->files.SortWithFunc([](const FileInfo& lhs, const FileInfo& rhs) -> bool
+    {
+        if (lhs.dirPath != rhs.dirPath)
+            return lhs.dirPath < rhs.dirPath;
+        if (lhs.path != rhs.path)
+            return lhs.path < rhs.path;
+        return lhs.file.dir < rhs.file.dir;
+    });
+
+    // the first file added with a path wins
+    IndexT i;
+    for (i = this->files.Size() - 1; i > 0; i--)
+    {
+        if (this->files[i].path == this->files[i - 1].path)
+        {
+            n_warning("PackArchiveWriter: '%s' added more than once, ignoring duplicate\n", this->files[i].path.AsCharPtr());
+            this->files.EraseIndex(i);
+        }
+    }
+
+    // collect all directories including the root and their parents
+    Array<String> dirPaths;
+    dirPaths.Append("");
+    for (i = 0; i < this->files.Size(); i++)
+    {
+        String dirPath = this->files[i].dirPath;
+        while (dirPath.IsValid() && (dirPaths.IsEmpty() || dirPaths.Back() != dirPath))
+        {
+            dirPaths.Append(dirPath);
+            IndexT slash = InvalidIndex;
+            IndexT next = dirPath.FindCharIndex('/', 0);
+            while (next != InvalidIndex)
+            {
+                slash = next;
+                next = dirPath.FindCharIndex('/', slash + 1);
+            }
+            dirPath = slash != InvalidIndex ? dirPath.ExtractRange(0, slash) : String();
+        }
+    }
+    dirPaths.Sort();
+    for (i = dirPaths.Size() - 1; i > 0; i--)
+    {
+        if (dirPaths[i] == dirPaths[i - 1])
+        {
+            dirPaths.EraseIndex(i);
+        }
+    }
+    Dictionary<String, IndexT> dirIndices;
+    dirIndices.BeginBulkAdd();
+    for (i = 0; i < dirPaths.Size(); i++)
+    {
+        dirIndices.Add(dirPaths[i], i);
+    }
+    dirIndices.EndBulkAdd();
+
+    // string table
+    uint64 stringsSize = 0;
+    for (i = 0; i < this->files.Size(); i++)
+        stringsSize += this->files[i].path.Length();
+    for (i = 0; i < dirPaths.Size(); i++)
+        stringsSize += dirPaths[i].Length();
+    char* strings = (char*)Memory::Alloc(Memory::ScratchHeap, (size_t)Math::max(stringsSize, (uint64)1));
+    uint stringsOffset = 0;
+
+    // file and directory tables
+    Array<PackFormat::File> fileTable;
+    Array<PackFormat::Dir> dirTable;
+    fileTable.Reserve(this->files.Size());
+    dirTable.Reserve(dirPaths.Size());
+    for (i = 0; i < dirPaths.Size(); i++)
+    {
+        PackFormat::Dir dir;
+        memset(&dir, 0, sizeof(dir));
+        dir.pathHash = PackFormat::HashPath(dirPaths[i].AsCharPtr(), dirPaths[i].Length());
+        dir.pathOffset = stringsOffset;
+        dir.pathLength = dirPaths[i].Length();
+        memcpy(strings + stringsOffset, dirPaths[i].AsCharPtr(), dir.pathLength);
+        stringsOffset += dir.pathLength;
+        dirTable.Append(dir);
+    }
+    for (i = 0; i < this->files.Size(); i++)
+    {
+        const FileInfo& info = this->files[i];
+        PackFormat::File file = info.file;
+        file.pathOffset = stringsOffset;
+        file.pathLength = info.path.Length();
+        memcpy(strings + stringsOffset, info.path.AsCharPtr(), file.pathLength);
+        stringsOffset += file.pathLength;
+        file.dir = dirIndices[info.dirPath];
+
+        PackFormat::Dir& dir = dirTable[file.dir];
+        if (dir.numFiles == 0)
+        {
+            dir.firstFile = i;
+        }
+        dir.numFiles++;
+        fileTable.Append(file);
+    }
+
+    // children are grouped by parent, directories are sorted so children follow their parents
+    Array<uint> childTable;
+    Array<Array<uint>> dirChildren;
+    childTable.Reserve(dirPaths.Size());
+    dirChildren.Resize(dirPaths.Size());
+    for (i = 1; i < dirPaths.Size(); i++)
+    {
+        const String& dirPath = dirPaths[i];
+        IndexT slash = InvalidIndex;
+        IndexT next = dirPath.FindCharIndex('/', 0);
+        while (next != InvalidIndex)
+        {
+            slash = next;
+            next = dirPath.FindCharIndex('/', slash + 1);
+        }
+        String parentPath = slash != InvalidIndex ? dirPath.ExtractRange(0, slash) : String();
+        dirChildren[dirIndices[parentPath]].Append((uint)i);
+    }
+    for (i = 0; i < dirPaths.Size(); i++)
+    {
+        dirTable[i].firstChild = childTable.Size();
+        dirTable[i].numChildren = dirChildren[i].Size();
+        childTable.AppendArray(dirChildren[i]);
+    }
+
+    // hash table, at most half full
+    const uint numEntries = (uint)(fileTable.Size() + dirTable.Size());
+    uint hashTableSize = 16;
+    while (hashTableSize < numEntries * 2)
+    {
+        hashTableSize <<= 1;
+    }
+    Array<uint> hashTable;
+    hashTable.Fill(0, hashTableSize, PackFormat::EmptySlot);
+    auto insert = [&hashTable, hashTableSize](uint64 hash, uint value)
+    {
+        uint slot = (uint)hash & (hashTableSize - 1);
+        while (hashTable[slot] != PackFormat::EmptySlot)
+        {
+            slot = (slot + 1) & (hashTableSize - 1);
+        }
+        hashTable[slot] = value;
+    };
+    for (i = 0; i < fileTable.Size(); i++)
+    {
+        insert(fileTable[i].pathHash, (uint)i);
+    }
+    for (i = 0; i < dirTable.Size(); i++)
+    {
+        insert(dirTable[i].pathHash, (uint)i | PackFormat::DirFlag);
+    }
+
+    // write index and header
+    PackFormat::Header header;
+    memset(&header, 0, sizeof(header));
+    header.magic = PackFormat::Magic;
+    header.version = PackFormat::Version;
+    header.numFiles = fileTable.Size();
+    header.numDirs = dirTable.Size();
+    header.numChunks = this->chunks.Size();
+    header.numChildren = childTable.Size();
+    header.hashTableSize = hashTableSize;
+    header.chunkSize = PackFormat::ChunkSize;
+    header.filesOffset = this->WriteTable(fileTable.Begin(), fileTable.ByteSize());
+    header.dirsOffset = this->WriteTable(dirTable.Begin(), dirTable.ByteSize());
+    header.chunksOffset = this->WriteTable(this->chunks.Begin(), this->chunks.ByteSize());
+    header.childrenOffset = this->WriteTable(childTable.Begin(), childTable.ByteSize());
+    header.hashTableOffset = this->WriteTable(hashTable.Begin(), hashTable.ByteSize());
+    header.stringsOffset = this->WriteTable(strings, (SizeT)stringsSize);
+    header.stringsSize = stringsSize;
+    Memory::Free(Memory::ScratchHeap, strings);
+
+    this->archiveSize = (uint64)this->stream->GetPosition();
+    this->stream->Seek(0, Stream::Begin);
+    this->stream->Write(&header, sizeof(header));
+    this->stream->Close();
+    this->stream = nullptr;
+    this->files.Clear();
+    this->chunks.Clear();
+    return true;
+}
+
+} // namespace IO
@@ -0,0 +1,132 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class IO::PackArchiveWriter
+
+    Writes pack archives (.npk), see packformat.h for the layout.
+
+    File data is written as files are added, the index is written on Close().
+    Files added with compression are split into chunks which are compressed
+    independently, files which don't shrink by at least a minimum ratio are
+    stored instead, so they can be mapped directly when the archive is read.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "core/refcounted.h"
+#include "io/stream.h"
+#include "io/packfs/packformat.h"
+
+//------------------------------------------------------------------------------
+namespace IO
+{
+class PackArchiveWriter : public Core::RefCounted
+{
+    __DeclareClass(PackArchiveWriter);
+public:
+    /// constructor
+    PackArchiveWriter();
+    /// destructor
+    virtual ~PackArchiveWriter();
+
+    /// set the ratio of compressed to uncompressed size above which files are stored instead (default 0.9)
+    void SetMinCompressionRatio(float ratio);
+    /// open the archive file for writing
+    bool Open(const URI& uri);
+    /// add a file from memory
+    void AddFile(const Util::String& pathInArchive, const void* data, SizeT size, bool compress);
+    /// add a file from the file system, returns false if it can't be read
+    bool AddFile(const Util::String& pathInArchive, const URI& srcUri, bool compress);
+    /// write the index and close the archive file
+    bool Close();
+    /// return true if the archive is open
+    bool IsOpen() const;
+
+    /// get number of files stored uncompressed
+    SizeT GetNumStoredFiles() const;
+    /// get number of files stored compressed
+    SizeT GetNumCompressedFiles() const;
+    /// get total size of all files
+    uint64 GetUncompressedSize() const;
+    /// get size of the archive, valid after Close()
+    uint64 GetArchiveSize() const;
+
+private:
+    struct FileInfo
+    {
+        Util::String path;
+        Util::String dirPath;
+        PackFormat::File file;
+    };
+
+    /// pad the archive with zeros up to an alignment
+    void Align(uint64 alignment);
+    /// write a table of the index, returns its offset
+    uint64 WriteTable(const void* data, SizeT size);
+
+    Ptr<Stream> stream;
+    float minCompressionRatio;
+    Util::Array<FileInfo> files;
+    Util::Array<PackFormat::Chunk> chunks;
+    SizeT numStored;
+    SizeT numCompressed;
+    uint64 uncompressedSize;
+    uint64 archiveSize;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+PackArchiveWriter::SetMinCompressionRatio(float ratio)
+{
+    this->minCompressionRatio = ratio;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+PackArchiveWriter::IsOpen() const
+{
+    return this->stream.isvalid();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+PackArchiveWriter::GetNumStoredFiles() const
+{
+    return this->numStored;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+PackArchiveWriter::GetNumCompressedFiles() const
+{
+    return this->numCompressed;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline uint64
+PackArchiveWriter::GetUncompressedSize() const
+{
+    return this->uncompressedSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline uint64
+PackArchiveWriter::GetArchiveSize() const
+{
+    return this->archiveSize;
+}
+
+} // namespace IO
+//------------------------------------------------------------------------------
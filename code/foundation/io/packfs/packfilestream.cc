@@ -0,0 +1,265 @@
+//------------------------------------------------------------------------------
+//  packfilestream.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "foundation/stdneb.h"
+#include "io/packfs/packfilestream.h"
+#include "io/packfs/packfilesystem.h"
+#include "io/packfs/packarchive.h"
+
+namespace IO
+{
+__ImplementClass(IO::PackFileStream, 'PKFT', IO::Stream);
+
+using namespace Util;
+
+//------------------------------------------------------------------------------
+/**
+*/
+PackFileStream::PackFileStream() :
+    size(0),
+    position(0),
+    data(nullptr),
+    buffer(nullptr)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+PackFileStream::~PackFileStream()
+{
+    if (this->IsOpen())
+    {
+        this->Close();
+    }
+    n_assert(this->buffer == nullptr);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+PackFileStream::CanRead() const
+{
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+PackFileStream::CanWrite() const
+{
+    return false;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+PackFileStream::CanSeek() const
+{
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+PackFileStream::CanBeMapped() const
+{
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Stream::Size
+PackFileStream::GetSize() const
+{
+    return this->size;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Stream::Position
+PackFileStream::GetPosition() const
+{
+    return this->position;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Open the stream for reading. Compressed files are decompressed entirely,
+    stored files are used in place.
+*/
+bool
+PackFileStream::Open()
+{
+    n_assert(!this->IsOpen());
+    n_assert(this->buffer == nullptr);
+    if (ReadAccess == this->accessMode && Stream::Open())
+    {
+        this->archive = PackFileSystem::Instance()->FindArchive(this->uri);
+        if (this->archive.isvalid())
+        {
+            Dictionary<String, String> params = this->uri.ParseQuery();
+            if (params.Contains("file"))
+            {
+                IndexT fileIndex = this->archive->FindFile(params["file"]);
+                if (InvalidIndex != fileIndex)
+                {
+                    const PackFormat::File& file = this->archive->GetFile(fileIndex);
+                    this->size = (Size)file.size;
+                    this->position = 0;
+                    if (file.codec == PackFormat::Stored)
+                    {
+                        this->data = (const unsigned char*)this->archive->GetStoredData(file);
+                        return true;
+                    }
+
+                    this->buffer = (unsigned char*)Memory::Alloc(Memory::StreamDataHeap, Math::max(this->size, (Size)1));
+                    if (PackFileSystem::Instance()->Decode(this->archive, file, this->buffer))
+                    {
+                        this->data = this->buffer;
+                        return true;
+                    }
+                    n_warning("PackFileStream: '%s' is corrupt\n", this->uri.AsString().AsCharPtr());
+                }
+            }
+        }
+        // fallthrough: failure
+        this->Close();
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PackFileStream::Close()
+{
+    n_assert(this->IsOpen());
+    if (this->IsMapped())
+    {
+        this->Unmap();
+    }
+    if (this->buffer != nullptr)
+    {
+        Memory::Free(Memory::StreamDataHeap, this->buffer);
+        this->buffer = nullptr;
+    }
+    this->data = nullptr;
+    this->archive = nullptr;
+    Stream::Close();
+    this->size = 0;
+    this->position = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Stream::Size
+PackFileStream::Read(void* ptr, Size numBytes)
+{
+    n_assert(ptr);
+    n_assert(this->IsOpen());
+    n_assert(ReadAccess == this->accessMode);
+    n_assert((this->position >= 0) && (this->position <= this->size));
+
+    Size readBytes = Math::min(numBytes, this->size - this->position);
+    if (readBytes > 0)
+    {
+        Memory::Copy(this->data + this->position, ptr, readBytes);
+        this->position += readBytes;
+    }
+    return readBytes;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PackFileStream::Seek(Offset offset, SeekOrigin origin)
+{
+    n_assert(this->IsOpen());
+    n_assert(!this->IsMapped());
+    n_assert((this->position >= 0) && (this->position <= this->size));
+
+    switch (origin)
+    {
+        case Begin:
+            this->position = offset;
+            break;
+        case Current:
+            this->position += offset;
+            break;
+        case End:
+            this->position = this->size + offset;
+            break;
+        default:
+            n_assert(false);
+    }
+
+    // make sure read/write position doesn't become invalid
+    this->position = Math::clamp(this->position, (Stream::Size)0, this->size);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+PackFileStream::Eof() const
+{
+    n_assert(this->IsOpen());
+    n_assert((this->position >= 0) && (this->position <= this->size));
+    return (this->position == this->size);
+}
+
+//------------------------------------------------------------------------------
+/**
+    The mapped data of stored files lives in the read only archive mapping,
+    it must not be written to.
+*/
+void*
+PackFileStream::Map()
+{
+    n_assert(this->IsOpen());
+    n_assert(ReadAccess == this->accessMode);
+    Stream::Map();
+    return (void*)this->data;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PackFileStream::Unmap()
+{
+    n_assert(this->IsOpen());
+    Stream::Unmap();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void*
+PackFileStream::MemoryMap()
+{
+    return this->Map();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PackFileStream::MemoryUnmap()
+{
+    this->Unmap();
+}
+
+} // namespace IO
@@ -0,0 +1,78 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class IO::PackFileStream
+
+    Wraps a file in a pack archive into a stream.
+
+    Files stored uncompressed are not copied at all, reads and maps go straight
+    to the memory mapped archive. Compressed files are decompressed into a
+    private buffer when the stream is opened.
+
+    The IoServer provides transparent access to files in mounted pack archives
+    through normal "file:" URIs. To force reading from a pack archive, use an
+    URI of the following format:
+
+    pack:///path/to/archive?file=path/in/archive
+
+    The local path of the URI is the path of the archive file without the .npk
+    extension, the query contains the path of the file in the archive.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "io/stream.h"
+
+//------------------------------------------------------------------------------
+namespace IO
+{
+class PackArchive;
+class PackFileStream : public Stream
+{
+    __DeclareClass(PackFileStream);
+public:
+    /// constructor
+    PackFileStream();
+    /// destructor
+    virtual ~PackFileStream();
+    /// pack file streams support reading
+    virtual bool CanRead() const;
+    /// pack file streams don't support writing
+    virtual bool CanWrite() const;
+    /// pack file streams support seeking
+    virtual bool CanSeek() const;
+    /// pack file streams are mappable
+    virtual bool CanBeMapped() const;
+    /// get the size of the stream in bytes
+    virtual Size GetSize() const;
+    /// get the current position of the read/write cursor
+    virtual Position GetPosition() const;
+    /// open the stream
+    virtual bool Open();
+    /// close the stream
+    virtual void Close();
+    /// directly read from the stream
+    virtual Size Read(void* ptr, Size numBytes);
+    /// seek in stream
+    virtual void Seek(Offset offset, SeekOrigin origin);
+    /// return true if end-of-stream reached
+    virtual bool Eof() const;
+    /// map for direct memory-access
+    virtual void* Map();
+    /// unmap a mapped stream
+    virtual void Unmap();
+    /// map for direct memory-access, does nothing but call Map()
+    virtual void* MemoryMap();
+    /// unmap memory stream
+    virtual void MemoryUnmap();
+
+private:
+    Ptr<PackArchive> archive;
+    Size size;
+    Position position;
+    const unsigned char* data;      // points into the archive for stored files, or to the buffer
+    unsigned char* buffer;          // decompressed data of compressed files
+};
+
+} // namespace IO
+//------------------------------------------------------------------------------
@@ -0,0 +1,412 @@
+//------------------------------------------------------------------------------
+//  packfilesystem.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "foundation/stdneb.h"
+#include "io/packfs/packfilesystem.h"
+#include "io/packfs/packfilestream.h"
+#include "io/assignregistry.h"
+#include "io/schemeregistry.h"
+#include "io/fswrapper.h"
+
+namespace IO
+{
+__ImplementClass(IO::PackFileSystem, 'PKFS', Core::RefCounted);
+__ImplementInterfaceSingleton(IO::PackFileSystem);
+
+using namespace Util;
+
+//------------------------------------------------------------------------------
+/**
+*/
+PackFileSystem::PackFileSystem() :
+    numDecodeThreads(0),
+    isValid(false)
+{
+    __ConstructInterfaceSingleton;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+PackFileSystem::~PackFileSystem()
+{
+    if (this->IsValid())
+    {
+        this->Discard();
+    }
+    __DestructInterfaceSingleton;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Registers the PackFileStream class, with 0 decode threads files are decoded
+    on the thread opening them only. The decode threads are only started once
+    an archive is mounted, so applications without pack archives don't pay for them.
+*/
+void
+PackFileSystem::Setup(SizeT numDecodeThreads)
+{
+    n_assert(!this->IsValid());
+    SchemeRegistry::Instance()->RegisterUriScheme("pack", PackFileStream::RTTI);
+    this->numDecodeThreads = numDecodeThreads;
+    this->isValid = true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PackFileSystem::StartDecodeThreads()
+{
+    n_assert(this->threads.IsEmpty());
+    IndexT i;
+    for (i = 0; i < this->numDecodeThreads; i++)
+    {
+        Ptr<PackDecodeThread> thread = PackDecodeThread::Create();
+        thread->fileSystem = this;
+        thread->SetName(String::Sprintf("PackFileSystem Decode Thread #%d", i));
+        thread->Start();
+        this->threads.Append(thread);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PackFileSystem::Discard()
+{
+    n_assert(this->IsValid());
+    while (!this->archives.IsEmpty())
+    {
+        this->Unmount(this->archives.ValueAtIndex(0)->GetURI());
+    }
+
+    IndexT i;
+    for (i = 0; i < this->threads.Size(); i++)
+    {
+        this->threads[i]->Stop();
+    }
+    this->threads.Clear();
+    SchemeRegistry::Instance()->UnregisterUriScheme("pack");
+    this->isValid = false;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+PackFileSystem::ArchiveExists(const URI& uri)
+{
+    String path = AssignRegistry::Instance()->ResolveAssigns(uri).LocalPath();
+    path.Append(".npk");
+    return FSWrapper::FileExists(path);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Ptr<PackArchive>
+PackFileSystem::Mount(const URI& uri, const String& rootPath)
+{
+    n_assert(!this->IsMounted(uri));
+    String path = AssignRegistry::Instance()->ResolveAssigns(uri).LocalPath();
+    Ptr<PackArchive> newArchive = PackArchive::Create();
+    if (newArchive->Setup(uri, rootPath))
+    {
+        this->critSect.Enter();
+        if (this->threads.IsEmpty())
+        {
+            this->StartDecodeThreads();
+        }
+        this->archives.Add(path, newArchive);
+        this->critSect.Leave();
+    }
+    else
+    {
+        newArchive = nullptr;
+    }
+    return newArchive;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Streams which are still open keep the archive mapped until they are closed.
+*/
+void
+PackFileSystem::Unmount(const URI& uri)
+{
+    n_assert(this->IsMounted(uri));
+    String path = AssignRegistry::Instance()->ResolveAssigns(uri).LocalPath();
+    this->critSect.Enter();
+    this->archives.Erase(path);
+    this->critSect.Leave();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+PackFileSystem::IsMounted(const URI& uri) const
+{
+    String path = AssignRegistry::Instance()->ResolveAssigns(uri).LocalPath();
+    this->critSect.Enter();
+    bool result = this->archives.Contains(path);
+    this->critSect.Leave();
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Ptr<PackArchive>
+PackFileSystem::FindArchive(const URI& uri) const
+{
+    String path = AssignRegistry::Instance()->ResolveAssigns(uri).LocalPath();
+    Ptr<PackArchive> result;
+    this->critSect.Enter();
+    IndexT index = this->archives.FindIndex(path);
+    if (InvalidIndex != index)
+    {
+        result = this->archives.ValueAtIndex(index);
+    }
+    this->critSect.Leave();
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns the first archive in alphabetical order which contains the file.
+*/
+Ptr<PackArchive>
+PackFileSystem::FindArchiveWithFile(const URI& uri) const
+{
+    String localPath = AssignRegistry::Instance()->ResolveAssigns(uri).LocalPath();
+    n_assert(localPath.IsValid());
+
+    Ptr<PackArchive> result;
+    this->critSect.Enter();
+    IndexT i;
+    for (i = 0; i < this->archives.Size(); i++)
+    {
+        const Ptr<PackArchive>& archive = this->archives.ValueAtIndex(i);
+        String pathInArchive = archive->ConvertToPathInArchive(localPath);
+        if (pathInArchive.IsValid() && InvalidIndex != archive->FindFile(pathInArchive))
+        {
+            result = archive;
+            break;
+        }
+    }
+    this->critSect.Leave();
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Ptr<PackArchive>
+PackFileSystem::FindArchiveWithDir(const URI& uri) const
+{
+    String localPath = AssignRegistry::Instance()->ResolveAssigns(uri).LocalPath();
+    n_assert(localPath.IsValid());
+
+    Ptr<PackArchive> result;
+    this->critSect.Enter();
+    IndexT i;
+    for (i = 0; i < this->archives.Size(); i++)
+    {
+        const Ptr<PackArchive>& archive = this->archives.ValueAtIndex(i);
+        String pathInArchive = archive->ConvertToPathInArchive(localPath);
+        if (pathInArchive.IsValid() && InvalidIndex != archive->FindDir(pathInArchive))
+        {
+            result = archive;
+            break;
+        }
+    }
+    this->critSect.Leave();
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+URI
+PackFileSystem::ConvertFileToPackURIIfExists(const URI& uri) const
+{
+    if (uri.Scheme() == "file" && !this->archives.IsEmpty())
+    {
+        Ptr<PackArchive> archive = this->FindArchiveWithFile(uri);
+        if (archive.isvalid())
+        {
+            return archive->ConvertToArchiveURI(uri);
+        }
+    }
+    // fallthrough: no match, return original uri
+    return uri;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Stored files are copied, compressed files are decoded chunk by chunk. The
+    job is posted to the decode threads before the calling thread starts on it,
+    whichever thread gets to a chunk first decodes it.
+*/
+bool
+PackFileSystem::Decode(const PackArchive* archive, const PackFormat::File& file, void* buffer)
+{
+    if (file.codec == PackFormat::Stored)
+    {
+        Memory::Copy(archive->GetStoredData(file), buffer, (size_t)file.size);
+        return true;
+    }
+
+    PackDecodeJob job;
+    job.archive = archive;
+    job.file = &file;
+    job.buffer = buffer;
+    job.nextChunk = 0;
+    job.chunksLeft = file.numChunks;
+    job.helpers = 0;
+    job.failed = 0;
+    if (file.numChunks == 0)
+    {
+        return true;
+    }
+
+    // the decode threads may just be started by a Mount on another thread
+    this->critSect.Enter();
+    const bool parallel = file.numChunks > 1 && !this->threads.IsEmpty();
+    if (parallel)
+    {
+        this->jobCritSect.Enter();
+        this->jobs.Enqueue(&job);
+        this->jobCritSect.Leave();
+
+        SizeT numWakeups = Math::min((SizeT)file.numChunks - 1, this->threads.Size());
+        IndexT i;
+        for (i = 0; i < numWakeups; i++)
+        {
+            this->threads[i]->EmitWakeupSignal();
+        }
+    }
+    this->critSect.Leave();
+
+    DecodeChunks(&job);
+
+    if (parallel)
+    {
+        job.doneEvent.Wait();
+
+        // all chunks are taken, make sure no decode thread picks the job up anymore
+        this->jobCritSect.Enter();
+        IndexT i;
+        for (i = 0; i < this->jobs.Size(); i++)
+        {
+            if (this->jobs[i] == &job)
+            {
+                this->jobs.EraseIndex(i);
+                break;
+            }
+        }
+        this->jobCritSect.Leave();
+
+        // helpers may still be on their way out of DecodeChunks
+        while (job.helpers > 0)
+        {
+            Threading::Thread::YieldThread();
+        }
+    }
+    return job.failed == 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PackFileSystem::DecodeChunks(PackDecodeJob* job)
+{
+    const SizeT numChunks = (SizeT)job->file->numChunks;
+    for (;;)
+    {
+        IndexT chunkIndex = Threading::Interlocked::Increment(&job->nextChunk) - 1;
+        if (chunkIndex >= numChunks)
+        {
+            break;
+        }
+        if (!job->archive->DecodeChunk(*job->file, chunkIndex, job->buffer))
+        {
+            Threading::Interlocked::Exchange(&job->failed, 1);
+        }
+        if (Threading::Interlocked::Decrement(&job->chunksLeft) == 0)
+        {
+            job->doneEvent.Signal();
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Jobs stay queued until all of their chunks have been handed out, so
+    several decode threads can help out with the same file.
+*/
+PackDecodeJob*
+PackFileSystem::AcquireJob()
+{
+    PackDecodeJob* result = nullptr;
+    this->jobCritSect.Enter();
+    while (!this->jobs.IsEmpty())
+    {
+        PackDecodeJob* job = this->jobs.Peek();
+        if (job->nextChunk >= (int)job->file->numChunks)
+        {
+            this->jobs.Dequeue();
+            continue;
+        }
+        Threading::Interlocked::Increment(&job->helpers);
+        result = job;
+        break;
+    }
+    this->jobCritSect.Leave();
+    return result;
+}
+
+__ImplementClass(IO::PackDecodeThread, 'PKDT', Threading::Thread);
+//------------------------------------------------------------------------------
+/**
+*/
+PackDecodeThread::PackDecodeThread() :
+    fileSystem(nullptr)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PackDecodeThread::DoWork()
+{
+    while (!this->ThreadStopRequested())
+    {
+        PackDecodeJob* job = this->fileSystem->AcquireJob();
+        if (job == nullptr)
+        {
+            this->wakeupEvent.Wait();
+            continue;
+        }
+        PackFileSystem::DecodeChunks(job);
+        Threading::Interlocked::Decrement(&job->helpers);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PackDecodeThread::EmitWakeupSignal()
+{
+    this->wakeupEvent.Signal();
+}
+
+} // namespace IO
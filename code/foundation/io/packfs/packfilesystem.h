@@ -0,0 +1,150 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class IO::PackFileSystem
+
+    Archive filesystem for Nebula pack archives (.npk), see packformat.h for
+    the layout. Registers the "pack" URI scheme with the SchemeRegistry.
+
+    The IoServer checks mounted pack archives before zip archives, so a pack
+    archive next to a zip archive of the same name takes precedence.
+
+    Compressed files are decompressed chunk by chunk. The thread opening the
+    file decodes chunks itself and, for files with more than one chunk, hands
+    the remaining ones out to a small pool of decode threads, so decoding large
+    files scales with the number of cores without ever blocking on a busy pool.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "core/refcounted.h"
+#include "core/singleton.h"
+#include "util/dictionary.h"
+#include "util/queue.h"
+#include "threading/thread.h"
+#include "threading/event.h"
+#include "threading/criticalsection.h"
+#include "threading/interlocked.h"
+#include "io/uri.h"
+#include "io/packfs/packarchive.h"
+
+//------------------------------------------------------------------------------
+namespace IO
+{
+
+/// a file being decoded, lives on the stack of the thread which opened the file
+struct PackDecodeJob
+{
+    const PackArchive* archive;
+    const PackFormat::File* file;
+    void* buffer;
+    Threading::AtomicCounter nextChunk;
+    Threading::AtomicCounter chunksLeft;
+    Threading::AtomicCounter helpers;
+    Threading::AtomicCounter failed;
+    Threading::Event doneEvent;
+};
+
+class PackDecodeThread;
+class PackFileSystem : public Core::RefCounted
+{
+    __DeclareClass(PackFileSystem);
+    __DeclareInterfaceSingleton(PackFileSystem);
+public:
+    /// constructor
+    PackFileSystem();
+    /// destructor
+    virtual ~PackFileSystem();
+
+    /// setup the pack file system, the decode threads are started when the first archive is mounted
+    void Setup(SizeT numDecodeThreads);
+    /// discard the pack file system
+    void Discard();
+    /// return true if pack file system has been setup
+    bool IsValid() const;
+
+    /// return true if a pack archive exists for the URI (without file extension)
+    static bool ArchiveExists(const URI& uri);
+    /// mount a pack archive (without file extension), returns invalid ptr on failure
+    Ptr<PackArchive> Mount(const URI& uri, const Util::String& rootPath = "");
+    /// unmount a pack archive
+    void Unmount(const URI& uri);
+    /// return true if a pack archive is mounted
+    bool IsMounted(const URI& uri) const;
+    /// any archives mounted?
+    bool HasArchives() const;
+
+    /// find a pack archive by its URI, returns invalid ptr if not mounted
+    Ptr<PackArchive> FindArchive(const URI& uri) const;
+    /// find first archive which contains the file path
+    Ptr<PackArchive> FindArchiveWithFile(const URI& fileUri) const;
+    /// find first archive which contains the directory path
+    Ptr<PackArchive> FindArchiveWithDir(const URI& dirUri) const;
+    /// transparently convert a URI pointing to a file into a matching pack URI
+    URI ConvertFileToPackURIIfExists(const URI& uri) const;
+
+    /// decompress a file of an archive into buffer, returns false if the data is corrupt
+    bool Decode(const PackArchive* archive, const PackFormat::File& file, void* buffer);
+
+private:
+    friend class PackDecodeThread;
+
+    /// start the decode threads, must be called within the critical section
+    void StartDecodeThreads();
+    /// decode chunks of a job until there are none left
+    static void DecodeChunks(PackDecodeJob* job);
+    /// pick a job to help out with on a decode thread, returns nullptr if there is none
+    PackDecodeJob* AcquireJob();
+
+    Threading::CriticalSection critSect;
+    Util::Dictionary<Util::String, Ptr<PackArchive>> archives;
+    Util::Array<Ptr<PackDecodeThread>> threads;
+    SizeT numDecodeThreads;
+    Threading::CriticalSection jobCritSect;
+    Util::Queue<PackDecodeJob*> jobs;
+    bool isValid;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+PackFileSystem::IsValid() const
+{
+    return this->isValid;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+PackFileSystem::HasArchives() const
+{
+    return !this->archives.IsEmpty();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Helps decoding chunks of files opened on other threads.
+*/
+class PackDecodeThread : public Threading::Thread
+{
+    __DeclareClass(PackDecodeThread);
+public:
+    /// constructor
+    PackDecodeThread();
+
+private:
+    friend class PackFileSystem;
+
+    /// this method runs in the thread context
+    void DoWork() override;
+    /// emit wakeup signal
+    void EmitWakeupSignal() override;
+
+    PackFileSystem* fileSystem;
+    Threading::Event wakeupEvent;
+};
+
+} // namespace IO
+//------------------------------------------------------------------------------
@@ -0,0 +1,127 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file io/packfs/packformat.h
+
+    On-disk layout of Nebula pack archives (.npk).
+
+    A pack archive starts with a Header, followed by the file data, and ends
+    with the index tables the header points to:
+
+    - file data: stored files are aligned to Alignment, so they can be handed
+      out as pointers straight into the memory mapped archive. Compressed files
+      are split into chunks of ChunkSize bytes which are compressed (and
+      decompressed) independently of each other.
+    - File and Dir tables: files are sorted by directory, so the files of a
+      directory are a contiguous range of the file table.
+    - Chunk table: the chunks of all compressed files, a chunk whose compressed
+      size equals its size was incompressible and is stored raw.
+    - Children table: indices of the subdirectories of each directory.
+    - Hash table: open addressing table of hashTableSize slots (a power of two),
+      each slot holds a file index, a directory index with DirFlag set, or
+      EmptySlot. Collisions are resolved by linear probing.
+    - String table: the paths of all files and directories, relative to the
+      archive root, with '/' as separator and without leading or trailing
+      separators. The root directory has an empty path.
+
+    All values are little endian.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "core/types.h"
+
+//------------------------------------------------------------------------------
+namespace IO
+{
+namespace PackFormat
+{
+
+static const uint Magic = 'NPK1';
+static const uint Version = 1;
+static const uint ChunkSize = 64 * 1024;
+static const uint Alignment = 4096;
+static const uint EmptySlot = 0xFFFFFFFF;
+static const uint DirFlag = 0x80000000;
+
+enum Codec : uint
+{
+    Stored = 0,
+    Lz4 = 1,
+};
+
+struct Header
+{
+    uint magic;
+    uint version;
+    uint numFiles;
+    uint numDirs;
+    uint numChunks;
+    uint numChildren;
+    uint hashTableSize;
+    uint chunkSize;
+    uint64 filesOffset;
+    uint64 dirsOffset;
+    uint64 chunksOffset;
+    uint64 childrenOffset;
+    uint64 hashTableOffset;
+    uint64 stringsOffset;
+    uint64 stringsSize;
+};
+
+struct File
+{
+    uint64 pathHash;
+    uint pathOffset;
+    uint pathLength;
+    uint64 dataOffset;      // offset of stored data, or unused if compressed
+    uint64 size;            // uncompressed size
+    uint firstChunk;
+    uint numChunks;
+    uint codec;
+    uint dir;               // index of the parent directory
+};
+
+struct Dir
+{
+    uint64 pathHash;
+    uint pathOffset;
+    uint pathLength;
+    uint firstFile;
+    uint numFiles;
+    uint firstChild;
+    uint numChildren;
+};
+
+struct Chunk
+{
+    uint64 offset;
+    uint compressedSize;
+    uint size;
+};
+
+static_assert(sizeof(Header) == 88, "PackFormat::Header must not contain padding");
+static_assert(sizeof(File) == 48, "PackFormat::File must not contain padding");
+static_assert(sizeof(Dir) == 32, "PackFormat::Dir must not contain padding");
+static_assert(sizeof(Chunk) == 16, "PackFormat::Chunk must not contain padding");
+
+//------------------------------------------------------------------------------
+/**
+    FNV-1a hash of a normalized path.
+*/
+inline uint64
+HashPath(const char* path, SizeT length)
+{
+    uint64 hash = 0xcbf29ce484222325ull;
+    IndexT i;
+    for (i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)path[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+} // namespace PackFormat
+} // namespace IO
+//------------------------------------------------------------------------------
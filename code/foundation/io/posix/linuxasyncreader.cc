@@ -0,0 +1,408 @@
+//------------------------------------------------------------------------------
+//  linuxasyncreader.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "foundation/stdneb.h"
+#include "io/asyncreader.h"
+#include "timing/time.h"
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <errno.h>
+
+#if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+#define NEBULA_IO_URING 1
+#endif
+
+namespace IO
+{
+
+#if NEBULA_IO_URING
+
+/// largest read issued per submission, the remainder of larger reads is resubmitted
+static const uint MaxReadSize = 1 << 30;
+/// number of times a submission is retried while the kernel is busy
+static const int MaxSubmitRetries = 100;
+
+//------------------------------------------------------------------------------
+/**
+*/
+static int
+IoUringEnter(int ring, uint toSubmit, uint minComplete, uint flags)
+{
+    int ret;
+    do
+    {
+        ret = (int)syscall(__NR_io_uring_enter, ring, toSubmit, minComplete, flags, nullptr, 0);
+    } while (ret < 0 && errno == EINTR);
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Get the next free submission queue entry, or nullptr if the queue is full.
+    Must be called within the reader lock.
+*/
+static io_uring_sqe*
+NextSqe(AsyncReaderPlatform& platform, uint& tail)
+{
+    // the completion queue is twice the size of the submission queue, limiting the
+    // number of requests in flight to the submission queue size keeps it from overflowing
+    if (platform.inflight >= platform.entries)
+        return nullptr;
+    const uint head = __atomic_load_n(platform.sqHead, __ATOMIC_ACQUIRE);
+    if (tail - head >= platform.entries)
+        return nullptr;
+
+    const uint index = tail & *platform.sqMask;
+    io_uring_sqe* sqe = &((io_uring_sqe*)platform.sqes)[index];
+    memset(sqe, 0, sizeof(io_uring_sqe));
+    platform.sqArray[index] = index;
+    platform.inflight++;
+    tail++;
+    return sqe;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+AsyncReaderImpl::Setup(AsyncReaderPlatform& platform, SizeT queueDepth)
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int ring = (int)syscall(__NR_io_uring_setup, (uint)queueDepth, &params);
+    if (ring < 0)
+    {
+        n_printf("AsyncReader: io_uring not available (%s), using thread pool\n", strerror(errno));
+        return false;
+    }
+
+    platform.ring = ring;
+    platform.sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint);
+    platform.cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    platform.sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+    bool singleMap = false;
+#ifdef IORING_FEAT_SINGLE_MMAP
+    singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+#endif
+    if (singleMap)
+    {
+        platform.sqRingSize = platform.cqRingSize = Math::max(platform.sqRingSize, platform.cqRingSize);
+    }
+
+    platform.sqRing = mmap(nullptr, platform.sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING);
+    if (platform.sqRing == MAP_FAILED)
+    {
+        platform.sqRing = nullptr;
+        AsyncReaderImpl::Discard(platform);
+        return false;
+    }
+    if (singleMap)
+    {
+        platform.cqRing = platform.sqRing;
+    }
+    else
+    {
+        platform.cqRing = mmap(nullptr, platform.cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_CQ_RING);
+        if (platform.cqRing == MAP_FAILED)
+        {
+            platform.cqRing = nullptr;
+            AsyncReaderImpl::Discard(platform);
+            return false;
+        }
+    }
+    platform.sqes = mmap(nullptr, platform.sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQES);
+    if (platform.sqes == MAP_FAILED)
+    {
+        platform.sqes = nullptr;
+        AsyncReaderImpl::Discard(platform);
+        return false;
+    }
+
+    char* sq = (char*)platform.sqRing;
+    char* cq = (char*)platform.cqRing;
+    platform.sqHead = (uint*)(sq + params.sq_off.head);
+    platform.sqTail = (uint*)(sq + params.sq_off.tail);
+    platform.sqMask = (uint*)(sq + params.sq_off.ring_mask);
+    platform.sqArray = (uint*)(sq + params.sq_off.array);
+    platform.cqHead = (uint*)(cq + params.cq_off.head);
+    platform.cqTail = (uint*)(cq + params.cq_off.tail);
+    platform.cqMask = (uint*)(cq + params.cq_off.ring_mask);
+    platform.cqes = cq + params.cq_off.cqes;
+    platform.entries = params.sq_entries;
+    platform.inflight = 0;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AsyncReaderImpl::Discard(AsyncReaderPlatform& platform)
+{
+    if (platform.sqes != nullptr)
+        munmap(platform.sqes, platform.sqesSize);
+    if (platform.cqRing != nullptr && platform.cqRing != platform.sqRing)
+        munmap(platform.cqRing, platform.cqRingSize);
+    if (platform.sqRing != nullptr)
+        munmap(platform.sqRing, platform.sqRingSize);
+    if (platform.ring >= 0)
+        close(platform.ring);
+    platform = AsyncReaderPlatform();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Fills the submission queue with pending requests and submits them with a single
+    system call. Requests which don't fit stay pending, they are submitted by the
+    completion thread as soon as reads in flight finish.
+
+    While the kernel is short on resources (EAGAIN) or its completion queue is full
+    (EBUSY), the submission is retried for a while, the completion thread keeps
+    draining completions meanwhile. If the ring still refuses the entries, they are
+    taken back and their requests returned in failed, to be finished as failed reads
+    once the caller left the lock.
+*/
+void
+AsyncReaderImpl::Submit(AsyncReader* reader, Util::Array<AsyncReadRequest*>& failed)
+{
+    AsyncReaderPlatform& platform = reader->platform;
+    uint tail = *platform.sqTail;
+    uint numSubmits = 0;
+    while (!reader->pending.IsEmpty())
+    {
+        io_uring_sqe* sqe = NextSqe(platform, tail);
+        if (sqe == nullptr)
+            break;
+
+        AsyncReadRequest* request = reader->pending.Dequeue();
+        char* buffer = (char*)request->read.buffer + request->bytesRead;
+        const uint size = (uint)Math::min(request->read.numBytes - request->bytesRead, (Stream::Size)MaxReadSize);
+        sqe->fd = fileno(request->handle);
+        sqe->off = (uint64)(request->read.offset + request->bytesRead);
+        if (request->bufferIndex != InvalidIndex)
+        {
+            sqe->opcode = IORING_OP_READ_FIXED;
+            sqe->addr = (uint64)buffer;
+            sqe->len = size;
+            sqe->buf_index = (uint16)request->bufferIndex;
+        }
+        else
+        {
+            request->platform.iov.iov_base = buffer;
+            request->platform.iov.iov_len = size;
+            sqe->opcode = IORING_OP_READV;
+            sqe->addr = (uint64)&request->platform.iov;
+            sqe->len = 1;
+        }
+        sqe->user_data = (uint64)request;
+        numSubmits++;
+    }
+
+    // entries left over from an earlier partial submission go along
+    const uint head = __atomic_load_n(platform.sqHead, __ATOMIC_ACQUIRE);
+    if (numSubmits == 0 && tail == head)
+        return;
+    __atomic_store_n(platform.sqTail, tail, __ATOMIC_RELEASE);
+
+    int retries = 0;
+    while (IoUringEnter(platform.ring, tail - head, 0, 0) < 0)
+    {
+        if ((errno == EAGAIN || errno == EBUSY) && retries++ < MaxSubmitRetries)
+        {
+            Timing::Sleep(0.001);
+            continue;
+        }
+
+        // the kernel only consumes entries within io_uring_enter, so everything past its head is still ours
+        const uint consumed = __atomic_load_n(platform.sqHead, __ATOMIC_ACQUIRE);
+        n_warning("AsyncReader: io_uring_enter failed (%s), failing %u reads\n", strerror(errno), tail - consumed);
+        uint i;
+        for (i = consumed; i != tail; i++)
+        {
+            const io_uring_sqe* sqe = &((io_uring_sqe*)platform.sqes)[platform.sqArray[i & *platform.sqMask]];
+            if (sqe->user_data != 0)
+                failed.Append((AsyncReadRequest*)sqe->user_data);
+        }
+        platform.inflight -= tail - consumed;
+        __atomic_store_n(platform.sqTail, consumed, __ATOMIC_RELEASE);
+        break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Waits for at least one completion. A failing wait doesn't stop the reader,
+    completions are posted to the ring without it, so they are polled instead.
+*/
+void
+AsyncReaderImpl::Complete(AsyncReader* reader)
+{
+    AsyncReaderPlatform& platform = reader->platform;
+    if (IoUringEnter(platform.ring, 0, 1, IORING_ENTER_GETEVENTS) < 0)
+    {
+        if (errno != EAGAIN && errno != EBUSY)
+        {
+            n_warning("AsyncReader: io_uring_enter failed (%s)\n", strerror(errno));
+        }
+        Timing::Sleep(0.001);
+    }
+
+    Util::Array<AsyncReadRequest*> finished;
+    Util::Array<AsyncReadRequest*> resubmits;
+    uint numCompletions = 0;
+    uint head = *platform.cqHead;
+    const uint tail = __atomic_load_n(platform.cqTail, __ATOMIC_ACQUIRE);
+    while (head != tail)
+    {
+        const io_uring_cqe* cqe = &((io_uring_cqe*)platform.cqes)[head & *platform.cqMask];
+        AsyncReadRequest* request = (AsyncReadRequest*)cqe->user_data;
+        const int res = cqe->res;
+        head++;
+        numCompletions++;
+
+        // wakeups are submitted as nops without a request
+        if (request == nullptr)
+            continue;
+
+        if (res == -EAGAIN || res == -EINTR)
+        {
+            resubmits.Append(request);
+        }
+        else if (res < 0)
+        {
+            n_warning("AsyncReader: read failed (%s)\n", strerror(-res));
+            finished.Append(request);
+        }
+        else
+        {
+            request->bytesRead += res;
+            if (res > 0 && request->bytesRead < request->read.numBytes)
+                resubmits.Append(request);
+            else
+                finished.Append(request);
+        }
+    }
+    __atomic_store_n(platform.cqHead, head, __ATOMIC_RELEASE);
+
+    if (numCompletions > 0)
+    {
+        reader->lock.Enter();
+        platform.inflight -= numCompletions;
+        for (IndexT i = 0; i < resubmits.Size(); i++)
+            reader->pending.Enqueue(resubmits[i]);
+        AsyncReaderImpl::Submit(reader, finished);
+        reader->lock.Leave();
+    }
+
+    for (IndexT i = 0; i < finished.Size(); i++)
+    {
+        reader->Finish(finished[i], finished[i]->bytesRead);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AsyncReaderImpl::Wake(AsyncReader* reader)
+{
+    AsyncReaderPlatform& platform = reader->platform;
+    reader->lock.Enter();
+    uint tail = *platform.sqTail;
+    io_uring_sqe* sqe = NextSqe(platform, tail);
+    if (sqe != nullptr)
+    {
+        sqe->opcode = IORING_OP_NOP;
+        sqe->user_data = 0;
+        __atomic_store_n(platform.sqTail, tail, __ATOMIC_RELEASE);
+        IoUringEnter(platform.ring, 1, 0, 0);
+    }
+    // if the queue is full, the completion thread wakes up anyway
+    reader->lock.Leave();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+AsyncReaderImpl::RegisterBuffers(AsyncReader* reader)
+{
+    AsyncReaderPlatform& platform = reader->platform;
+    n_assert(platform.inflight == 0);
+
+    // fails if nothing was registered before, which is fine
+    syscall(__NR_io_uring_register, platform.ring, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+    if (reader->registeredBuffers.IsEmpty())
+        return true;
+
+    Util::FixedArray<struct iovec> iovs(reader->registeredBuffers.Size());
+    for (IndexT i = 0; i < reader->registeredBuffers.Size(); i++)
+    {
+        iovs[i].iov_base = reader->registeredBuffers[i].first;
+        iovs[i].iov_len = reader->registeredBuffers[i].second;
+    }
+    return syscall(__NR_io_uring_register, platform.ring, IORING_REGISTER_BUFFERS, iovs.Begin(), (uint)iovs.Size()) == 0;
+}
+
+#else
+
+//------------------------------------------------------------------------------
+/**
+    Built without io_uring headers, always use the thread pool.
+*/
+bool
+AsyncReaderImpl::Setup(AsyncReaderPlatform& platform, SizeT queueDepth)
+{
+    return false;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AsyncReaderImpl::Discard(AsyncReaderPlatform& platform)
+{
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AsyncReaderImpl::Submit(AsyncReader* reader, Util::Array<AsyncReadRequest*>& failed)
+{
+    n_error("AsyncReaderImpl::Submit: io_uring not supported\n");
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AsyncReaderImpl::Complete(AsyncReader* reader)
+{
+    n_error("AsyncReaderImpl::Complete: io_uring not supported\n");
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AsyncReaderImpl::Wake(AsyncReader* reader)
+{
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+AsyncReaderImpl::RegisterBuffers(AsyncReader* reader)
+{
+    return false;
+}
+
+#endif
+
+} // namespace IO
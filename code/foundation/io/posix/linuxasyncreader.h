@@ -0,0 +1,67 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class IO::AsyncReaderImpl
+
+    Linux io_uring backend of the AsyncReader. The ring is set up through the
+    raw system calls, so no liburing is required. If the kernel doesn't support
+    io_uring (or it is blocked), Setup fails and the AsyncReader falls back to
+    its thread pool.
+
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "core/types.h"
+#include "util/array.h"
+#include <sys/uio.h>
+
+namespace IO
+{
+class AsyncReader;
+struct AsyncReadRequest;
+
+struct AsyncReaderPlatform
+{
+    int ring = -1;
+    void* sqRing = nullptr;
+    size_t sqRingSize = 0;
+    void* cqRing = nullptr;
+    size_t cqRingSize = 0;
+    void* sqes = nullptr;
+    size_t sqesSize = 0;
+
+    uint* sqHead = nullptr;
+    uint* sqTail = nullptr;
+    uint* sqMask = nullptr;
+    uint* sqArray = nullptr;
+    uint* cqHead = nullptr;
+    uint* cqTail = nullptr;
+    uint* cqMask = nullptr;
+    void* cqes = nullptr;
+
+    uint entries = 0;
+    uint inflight = 0;
+};
+
+struct AsyncReadRequestPlatform
+{
+    struct iovec iov;
+};
+
+class AsyncReaderImpl
+{
+public:
+    /// create the ring, returns false if io_uring is not available
+    static bool Setup(AsyncReaderPlatform& platform, SizeT queueDepth);
+    /// destroy the ring
+    static void Discard(AsyncReaderPlatform& platform);
+    /// submit as many pending requests as the ring has room for, must be called within the reader lock
+    static void Submit(AsyncReader* reader, Util::Array<AsyncReadRequest*>& failed);
+    /// wait for completions and finish or resubmit requests, runs on the completion thread
+    static void Complete(AsyncReader* reader);
+    /// wake up the completion thread
+    static void Wake(AsyncReader* reader);
+    /// register the reader's buffers for fixed buffer reads, must be called within the reader lock
+    static bool RegisterBuffers(AsyncReader* reader);
+};
+
+} // namespace IO
@@ -14,6 +14,7 @@
 #include <sys/stat.h>
 #include <sys/file.h>
 #include <sys/mman.h>
+#include <unistd.h>
 
 #ifdef __APPLE__
 namespace CoreFoundation {
@@ -111,6 +112,37 @@ PosixFSWrapper::Read(Handle handle, void* buf, Stream::Size numBytes)
     return bytesRead;
 }
 
+//------------------------------------------------------------------------------
+/**
+    Read data from an absolute position in a file, returns number of bytes read.
+    This runs on reader threads, so a failed read returns a short count instead
+    of aborting.
+*/
+Stream::Size
+PosixFSWrapper::ReadAt(Handle handle, void* buf, Stream::Size numBytes, Stream::Position offset)
+{
+    n_assert(0 != handle);
+    n_assert(buf != 0);
+    n_assert(numBytes > 0);
+    int fd = fileno(handle);
+    Stream::Size bytesRead = 0;
+    while (bytesRead < numBytes)
+    {
+        ssize_t ret = pread(fd, (char*)buf + bytesRead, numBytes - bytesRead, offset + bytesRead);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            n_warning("PosixFSWrapper: ReadAt() failed (%s)\n", strerror(errno));
+            break;
+        }
+        if (ret == 0)
+            break;
+        bytesRead += ret;
+    }
+    return bytesRead;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -5,6 +5,7 @@
 //------------------------------------------------------------------------------
 
 #include "io/stream.h"
+#include "threading/event.h"
 
 namespace IO
 {
@@ -282,6 +283,83 @@ Stream::Flush()
     n_assert(!this->isMapped);
 }
 
+//------------------------------------------------------------------------------
+/**
+    Streams which can't read asynchronously perform ReadAsync on the calling
+    thread, which also moves the read cursor.
+*/
+bool
+Stream::CanReadAsync() const
+{
+    return false;
+}
+
+//------------------------------------------------------------------------------
+/**
+    The default implementation reads synchronously, override this in
+    subclasses which can hand the reads over to the AsyncReader.
+*/
+void
+Stream::ReadAsyncBatch(const AsyncRead* reads, SizeT numReads)
+{
+    n_assert(this->IsOpen());
+    n_assert(this->CanRead() && this->CanSeek());
+    IndexT i;
+    for (i = 0; i < numReads; i++)
+    {
+        const AsyncRead& read = reads[i];
+        this->Seek(read.offset, Begin);
+        Size bytesRead = this->Read(read.buffer, read.numBytes);
+        FinishAsyncRead(read, bytesRead);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+Stream::ReadAsync(void* ptr, Size numBytes, Position offset, Threading::AtomicCounter* counter, Threading::Event* signalEvent)
+{
+    AsyncRead read;
+    read.buffer = ptr;
+    read.numBytes = numBytes;
+    read.offset = offset;
+    read.counter = counter;
+    read.signalEvent = signalEvent;
+    this->ReadAsyncBatch(&read, 1);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+Stream::ReadAsync(void* ptr, Size numBytes, Position offset, const std::function<void(Size)>& callback)
+{
+    AsyncRead read;
+    read.buffer = ptr;
+    read.numBytes = numBytes;
+    read.offset = offset;
+    read.callback = callback;
+    this->ReadAsyncBatch(&read, 1);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+Stream::FinishAsyncRead(const AsyncRead& read, Size bytesRead)
+{
+    if (read.callback != nullptr)
+        read.callback(bytesRead);
+
+    bool done = true;
+    if (read.counter != nullptr)
+        done = Threading::Interlocked::Decrement(read.counter) == 0;
+
+    if (done && read.signalEvent != nullptr)
+        read.signalEvent->Signal();
+}
+
 //------------------------------------------------------------------------------
 /**
     Return true if the read/write cursor is at the end of the stream.
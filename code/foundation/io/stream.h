@@ -19,7 +19,14 @@
 #include "core/refcounted.h"
 #include "io/uri.h"
 #include "threading/criticalsection.h"
+#include "threading/interlocked.h"
 #include "io/mediatype.h"
+#include <functional>
+
+namespace Threading
+{
+class Event;
+}
 
 //------------------------------------------------------------------------------
 namespace IO
@@ -56,6 +63,21 @@ public:
         Current,
         End,
     };
+
+    /// an asynchronous read of a byte range
+    struct AsyncRead
+    {
+        void* buffer = nullptr;
+        Size numBytes = 0;
+        Position offset = 0;
+        /// optional, called with the number of bytes read, may run on an I/O thread
+        std::function<void(Size)> callback;
+        /// optional, decremented when the read is done
+        Threading::AtomicCounter* counter = nullptr;
+        /// optional, signalled when the read is done and the counter (if any) reached zero
+        Threading::Event* signalEvent = nullptr;
+    };
+
     /// constructor
     Stream();
     /// destructor
@@ -100,6 +122,14 @@ public:
     virtual void Write(const void* ptr, Size numBytes);
     /// directly read from the stream
     virtual Size Read(void* ptr, Size numBytes);
+    /// return true if ReadAsync doesn't block the calling thread
+    virtual bool CanReadAsync() const;
+    /// read byte ranges asynchronously, submitted as a single batch
+    virtual void ReadAsyncBatch(const AsyncRead* reads, SizeT numReads);
+    /// read a byte range asynchronously, decrements the counter when done
+    void ReadAsync(void* ptr, Size numBytes, Position offset, Threading::AtomicCounter* counter, Threading::Event* signalEvent = nullptr);
+    /// read a byte range asynchronously, invokes the callback when done
+    void ReadAsync(void* ptr, Size numBytes, Position offset, const std::function<void(Size)>& callback);
     /// seek in stream
     virtual void Seek(Offset offset, SeekOrigin origin);
     /// flush unsaved data
@@ -116,6 +146,9 @@ public:
     virtual void MemoryUnmap();
     /// return true if stream is currently mapped to memory
     bool IsMapped() const;
+
+    /// run the completion of an asynchronous read
+    static void FinishAsyncRead(const AsyncRead& read, Size bytesRead);
         
 protected:
     URI uri;
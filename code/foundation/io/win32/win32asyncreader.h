@@ -0,0 +1,45 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class IO::AsyncReaderImpl
+
+    Win32 backend of the AsyncReader. There is no kernel queue backend on
+    Windows yet, so Setup always fails and reads are serviced by the
+    AsyncReader's thread pool.
+
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "core/types.h"
+#include "util/array.h"
+
+namespace IO
+{
+class AsyncReader;
+struct AsyncReadRequest;
+
+struct AsyncReaderPlatform
+{
+};
+
+struct AsyncReadRequestPlatform
+{
+};
+
+class AsyncReaderImpl
+{
+public:
+    /// create the kernel queue, always fails on win32
+    static bool Setup(AsyncReaderPlatform& platform, SizeT queueDepth) { return false; }
+    /// destroy the kernel queue
+    static void Discard(AsyncReaderPlatform& platform) {}
+    /// submit pending requests
+    static void Submit(AsyncReader* reader, Util::Array<AsyncReadRequest*>& failed) { n_error("AsyncReaderImpl::Submit: not supported on win32\n"); }
+    /// wait for completions
+    static void Complete(AsyncReader* reader) { n_error("AsyncReaderImpl::Complete: not supported on win32\n"); }
+    /// wake up the completion thread
+    static void Wake(AsyncReader* reader) {}
+    /// register buffers for fixed buffer reads
+    static bool RegisterBuffers(AsyncReader* reader) { return false; }
+};
+
+} // namespace IO
@@ -139,6 +139,33 @@ Win32FSWrapper::Read(Handle handle, void* buf, Stream::Size numBytes)
     return bytesRead;
 }
 
+//------------------------------------------------------------------------------
+/**
+    Read data from an absolute position in a file using an OVERLAPPED offset.
+    Note that the file pointer of a synchronous handle is moved by this. This
+    runs on reader threads, so a failed read returns a short count instead of
+    aborting.
+*/
+Stream::Size
+Win32FSWrapper::ReadAt(Handle handle, void* buf, Stream::Size numBytes, Stream::Position offset)
+{
+    n_assert(0 != handle);
+    n_assert(buf != 0);
+    n_assert(numBytes > 0);
+    n_assert(numBytes < LLONG_MAX);
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = (DWORD)(offset & 0xFFFFFFFF);
+    overlapped.OffsetHigh = (DWORD)(offset >> 32);
+    DWORD bytesRead = 0;
+    BOOL result = ReadFile(handle, buf, (DWORD)numBytes, &bytesRead, &overlapped);
+    if (0 == result && GetLastError() != ERROR_HANDLE_EOF)
+    {
+        n_warning("Win32FSWrapper: ReadFile() failed!\n");
+        return 0;
+    }
+    return bytesRead;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -473,7 +473,8 @@ XmlReader::GetVec4(const char* name) const
 {
 #if NEBULA_XMLREADER_LEGACY_VECTORS
     const String& vec4String = this->GetString(name);
-    Array<String> tokens = vec4String.Tokenize(", \t");
+    Array<StringView> tokens;
+    vec4String.Tokenize(", \t", tokens);
     if (tokens.Size() == 3)
     {
         return vec4(tokens[0].AsFloat(), tokens[1].AsFloat(), tokens[2].AsFloat(), 0);
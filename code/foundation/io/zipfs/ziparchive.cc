@@ -9,6 +9,7 @@
 #include "io/zipfs/zipdirentry.h"
 #include "io/assignregistry.h"
 #include "io/zipfs/ionebula3.h"
+#include "io/ioserver.h"
 
 namespace IO
 {
@@ -20,7 +21,9 @@ using namespace Util;
 /**
 */
 ZipArchive::ZipArchive() :
-    zipFileHandle(0)
+    zipFileHandle(0),
+    archiveData(nullptr),
+    archiveSize(0)
 {
     fill_nebula3_filefunc(&this->zlibIoFuncs);
 }
@@ -69,8 +72,34 @@ ZipArchive::Setup(const URI& zipFileURI, const String& rootPathOverride)
             return false;
         }
 
+        // map the archive, so entries can be decompressed without going through the shared handle
+        this->archiveStream = IoServer::Instance()->CreateStream(realPath);
+        this->archiveStream->SetAccessMode(Stream::ReadAccess);
+        if (this->archiveStream->CanBeMapped() && this->archiveStream->Open())
+        {
+            this->archiveSize = this->archiveStream->GetSize();
+            if (this->archiveSize > 0)
+            {
+                this->archiveData = (const unsigned char*)this->archiveStream->MemoryMap();
+            }
+        }
+
         // read the table of contents
-        this->ParseTableOfContents();    
+        if (nullptr == this->archiveData || !this->ParseCentralDirectory())
+        {
+            if (nullptr != this->archiveData)
+            {
+                n_warning("ZipArchive: failed to parse central directory of '%s', reads will be serialized\n", realPath.AsCharPtr());
+                this->archiveStream->MemoryUnmap();
+                this->archiveData = nullptr;
+            }
+            if (this->archiveStream->IsOpen())
+            {
+                this->archiveStream->Close();
+            }
+            this->archiveStream = nullptr;
+            this->ParseTableOfContents();
+        }
         return true;
     }
     else
@@ -89,6 +118,19 @@ ZipArchive::Discard()
 {
     n_assert(this->IsValid());
 
+    this->fileIndex.Clear();
+    this->fileEntries.Clear();
+    this->rootEntry = ZipDirEntry();
+
+    if (this->archiveStream.isvalid())
+    {
+        this->archiveStream->MemoryUnmap();
+        this->archiveStream->Close();
+        this->archiveStream = nullptr;
+        this->archiveData = nullptr;
+        this->archiveSize = 0;
+    }
+
     unzClose(this->zipFileHandle);
     this->zipFileHandle = 0;
 
@@ -106,6 +148,7 @@ ZipArchive::ParseTableOfContents()
     n_assert(this->IsValid());
 
     // for each entry of the zip file...
+    this->fileIndex.BeginBulkAdd();
     int walkRes = unzGoToFirstFile(this->zipFileHandle);
     if (UNZ_OK == walkRes) do
     {
@@ -117,10 +160,17 @@ ZipArchive::ParseTableOfContents()
                                 sizeof(curFileName),
                                 0, 0, 0, 0);
         n_assert(UNZ_OK == fileInfoRes);
-        this->AddEntry(curFileName);
+        if (this->AddEntry(curFileName))
+        {
+            String path = NormalizePath(curFileName);
+            ZipFileEntry& fileEntry = this->fileEntries.Emplace();
+            fileEntry.Setup(path.ExtractFileName(), this->zipFileHandle, &this->archiveCritSect);
+            this->fileIndex.Add(path, this->fileEntries.Size() - 1);
+        }
         walkRes = unzGoToNextFile(this->zipFileHandle);
     }
     while (UNZ_OK == walkRes);
+    this->fileIndex.EndBulkAdd();
     if (UNZ_END_OF_LIST_OF_FILE != walkRes)
     {
         n_error("ZipArchive: error in parsing zip file '%s'!\n", this->uri.AsString().AsCharPtr());
@@ -129,11 +179,12 @@ ZipArchive::ParseTableOfContents()
 
 //------------------------------------------------------------------------------
 /**
-    This will create a new ZipFileEntry or ZipDirEntry object and sort it into 
-    the entry tree. Missing ZipDirEntry objects in the path will be created as 
-    needed.
+    This will add the entry to the directory tree, which is used to list the
+    contents of the archive. Missing ZipDirEntry objects in the path will be 
+    created as needed. Returns true if the entry is a file, which must then be
+    added to the file index by the caller.
 */
-void
+bool
 ZipArchive::AddEntry(const String& path)
 {
     n_assert(path.IsValid());
@@ -172,15 +223,224 @@ ZipArchive::AddEntry(const String& path)
     StringAtom finalName(pathTokens.Back());
     if (isDirectory)
     {
-        dirEntry->AddDirEntry(finalName);
+        // the directory may have been created already by a file inside it
+        if (0 == dirEntry->FindDirEntry(finalName))
+        {
+            dirEntry->AddDirEntry(finalName);
+        }
+        return false;
     }
     else
     {
-        ZipFileEntry* finalFileEntry = dirEntry->AddFileEntry(finalName);
-        finalFileEntry->Setup(finalName, this->zipFileHandle, &this->archiveCritSect);
+        dirEntry->AddFileName(finalName);
+        return true;
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+    Paths in the file index use forward slashes and have no leading slash.
+*/
+String
+ZipArchive::NormalizePath(const String& path)
+{
+    String result = path;
+    result.SubstituteChar('\\', '/');
+    result.TrimLeft("/");
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline uint16_t
+ReadU16(const unsigned char* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline uint32_t
+ReadU32(const unsigned char* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline uint64_t
+ReadU64(const unsigned char* p)
+{
+    return (uint64_t)ReadU32(p) | ((uint64_t)ReadU32(p + 4) << 32);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Parses the central directory straight from the mapped archive (including
+    zip64 records), which also yields the local header offsets needed to 
+    decompress entries without minizip. The whole directory is validated before
+    anything is added, so a failure leaves the archive untouched for the 
+    minizip fallback.
+*/
+bool
+ZipArchive::ParseCentralDirectory()
+{
+    n_assert(nullptr != this->archiveData);
+    const unsigned char* data = this->archiveData;
+    const uint64_t size = (uint64_t)this->archiveSize;
+
+    // find the end of central directory record, which is followed by a comment of up to 64 KB
+    const uint64_t EocdSize = 22;
+    if (size < EocdSize)
+    {
+        return false;
+    }
+    uint64_t eocd = size - EocdSize;
+    const uint64_t searchEnd = size > (EocdSize + 0xFFFF) ? size - (EocdSize + 0xFFFF) : 0;
+    while (ReadU32(data + eocd) != 0x06054b50)
+    {
+        if (eocd == searchEnd)
+        {
+            return false;
+        }
+        eocd--;
+    }
+    uint64_t numEntries = ReadU16(data + eocd + 10);
+    uint64_t dirSize = ReadU32(data + eocd + 12);
+    uint64_t dirOffset = ReadU32(data + eocd + 16);
+    uint64_t dirEnd = eocd;
+
+    // zip64 archives have a locator right before the end of central directory
+    if (eocd >= 20 && ReadU32(data + eocd - 20) == 0x07064b50)
+    {
+        uint64_t eocd64 = ReadU64(data + eocd - 20 + 8);
+        if (eocd64 + 56 > size || ReadU32(data + eocd64) != 0x06064b50)
+        {
+            return false;
+        }
+        numEntries = ReadU64(data + eocd64 + 32);
+        dirSize = ReadU64(data + eocd64 + 40);
+        dirOffset = ReadU64(data + eocd64 + 48);
+        dirEnd = eocd64;
+    }
+
+    // data prepended to the archive (like a self extractor) shifts all offsets
+    if (dirOffset + dirSize > dirEnd)
+    {
+        return false;
+    }
+    const uint64_t bytesBefore = dirEnd - (dirOffset + dirSize);
+
+    struct Record
+    {
+        String path;
+        unz64_file_pos pos;
+        uint64_t localHeaderOffset;
+        uint64_t compressedSize;
+        uint64_t uncompressedSize;
+        uint16_t method;
+        uint16_t flags;
+        uint32_t crc;
+    };
+    Array<Record> records;
+    records.Reserve((SizeT)numEntries);
+
+    const uint64_t RecordSize = 46;
+    uint64_t offset = dirOffset;
+    uint64_t i;
+    for (i = 0; i < numEntries; i++)
+    {
+        const uint64_t pos = offset + bytesBefore;
+        if (pos + RecordSize > dirEnd)
+        {
+            return false;
+        }
+        const unsigned char* rec = data + pos;
+        if (ReadU32(rec) != 0x02014b50)
+        {
+            return false;
+        }
+        const uint16_t nameLength = ReadU16(rec + 28);
+        const uint16_t extraLength = ReadU16(rec + 30);
+        const uint16_t commentLength = ReadU16(rec + 32);
+        if (pos + RecordSize + nameLength + extraLength + commentLength > dirEnd || 0 == nameLength)
+        {
+            return false;
+        }
+
+        Record record;
+        record.path.Set((const char*)rec + RecordSize, nameLength);
+        record.pos.pos_in_zip_directory = offset;
+        record.pos.num_of_file = i;
+        record.flags = ReadU16(rec + 8);
+        record.method = ReadU16(rec + 10);
+        record.crc = ReadU32(rec + 16);
+        record.compressedSize = ReadU32(rec + 20);
+        record.uncompressedSize = ReadU32(rec + 24);
+        record.localHeaderOffset = ReadU32(rec + 42);
+
+        // zip64 extended information only holds the fields which overflowed
+        const unsigned char* extra = rec + RecordSize + nameLength;
+        const unsigned char* extraEnd = extra + extraLength;
+        while (extra + 4 <= extraEnd)
+        {
+            const uint16_t id = ReadU16(extra);
+            const uint16_t length = ReadU16(extra + 2);
+            const unsigned char* field = extra + 4;
+            const unsigned char* fieldEnd = field + length;
+            if (fieldEnd > extraEnd)
+            {
+                return false;
+            }
+            if (0x0001 == id)
+            {
+                if (record.uncompressedSize == 0xFFFFFFFF && field + 8 <= fieldEnd)
+                {
+                    record.uncompressedSize = ReadU64(field);
+                    field += 8;
+                }
+                if (record.compressedSize == 0xFFFFFFFF && field + 8 <= fieldEnd)
+                {
+                    record.compressedSize = ReadU64(field);
+                    field += 8;
+                }
+                if (record.localHeaderOffset == 0xFFFFFFFF && field + 8 <= fieldEnd)
+                {
+                    record.localHeaderOffset = ReadU64(field);
+                }
+            }
+            extra = fieldEnd;
+        }
+        record.localHeaderOffset += bytesBefore;
+        records.Append(record);
+        offset += RecordSize + nameLength + extraLength + commentLength;
+    }
+
+    // build the directory tree and the flat file index
+    this->fileEntries.Reserve(records.Size());
+    this->fileIndex.Reserve(records.Size());
+    this->fileIndex.BeginBulkAdd();
+    IndexT recordIndex;
+    for (recordIndex = 0; recordIndex < records.Size(); recordIndex++)
+    {
+        const Record& record = records[recordIndex];
+        if (this->AddEntry(record.path))
+        {
+            String path = NormalizePath(record.path);
+            ZipFileEntry& fileEntry = this->fileEntries.Emplace();
+            fileEntry.Setup(path.ExtractFileName(), this->zipFileHandle, &this->archiveCritSect, record.pos,
+                this->archiveData, size, record.localHeaderOffset,
+                record.compressedSize, record.uncompressedSize, record.method, record.flags, record.crc);
+            this->fileIndex.Add(path, this->fileEntries.Size() - 1);
+        }
+    }
+    this->fileIndex.EndBulkAdd();
+    return true;
+}
+
 //------------------------------------------------------------------------------
 /**
     Test if an absolute path points into the zip archive and
@@ -207,41 +467,17 @@ ZipArchive::ConvertToPathInArchive(const Util::String& absPath) const
 
 //------------------------------------------------------------------------------
 /**
+    Binary search in the flat file index.
 */
 const ZipFileEntry*
 ZipArchive::FindFileEntry(const String& pathInZipArchive) const
 {
-    // convert to local path into zip archive and split into components,
-    // fail if string doesn't point into archive
-    Array<String> pathTokens;
-    if (0 == pathInZipArchive.Tokenize("/\\", pathTokens))
+    IndexT index = this->fileIndex.FindIndex(NormalizePath(pathInZipArchive));
+    if (InvalidIndex == index)
     {
         return 0;
     }
-        
-    // walk directory entries
-    const ZipDirEntry* dirEntry = &this->rootEntry;
-    if (pathTokens.Size() > 1)
-    {
-        IndexT i;
-        for (i = 0; i < (pathTokens.Size() - 1); i++)
-        {
-            ZipDirEntry* subDirEntry = dirEntry->FindDirEntry(pathTokens[i]);
-            if (0 != subDirEntry)
-            {
-                dirEntry = subDirEntry;
-            }
-            else
-            {
-                // missing subdirectory
-                return 0;
-            }
-        }
-    }
-
-    // find the final file entry
-    const ZipFileEntry* fileEntry = dirEntry->FindFileEntry(pathTokens.Back());
-    return fileEntry;
+    return &this->fileEntries[this->fileIndex.ValueAtIndex(index)];
 }
 
 //------------------------------------------------------------------------------
@@ -297,12 +533,12 @@ ZipArchive::ListFiles(const String& dirPathInZipArchive, const String& pattern)
     const ZipDirEntry* dirEntry = this->FindDirEntry(dirPathInZipArchive);
     if (0 != dirEntry)
     {
-        const Array<ZipFileEntry>& files = dirEntry->GetFileEntries();
+        const Array<StringAtom>& files = dirEntry->GetFileNames();
         String fileName;
         IndexT i;
         for (i = 0; i < files.Size(); i++)
         {
-            fileName = files[i].GetName().Value();
+            fileName = files[i].Value();
             if (String::MatchPattern(fileName, pattern))
             {
                 result.Append(fileName);
@@ -6,9 +6,15 @@
     Private helper class for ZipFileSystem to hold per-Zip-archive data.
     Uses the zlib and the minizip lib for zip file access.
     
-    Multithreading: access to zlib archives needs to be serialized. A
-    ZipArchive objects contains a critical section which it will hand down
-    to ZipFileEntry objects.
+    The archive file is memory mapped and its central directory is parsed
+    once into a flat index of file entries sorted by path, which is binary
+    searched when opening files. Entries are decompressed straight from the
+    mapping, so any number of threads can read from the archive at once.
+
+    Multithreading: encrypted entries, and all entries of archives which can't
+    be mapped, go through the minizip handle, access to which needs to be
+    serialized. A ZipArchive objects contains a critical section which it
+    will hand down to ZipFileEntry objects.
 
     @copyright
     (C) 2006 Radon Labs GmbH
@@ -49,10 +55,14 @@ private:
     friend class ZipFileSystem;
     friend class ZipFileStream;
 
-    /// parse the table of contents into memory
+    /// parse the central directory of the mapped archive into the file index, returns false if it isn't a valid zip archive
+    bool ParseCentralDirectory();
+    /// parse the table of contents through minizip, used if the archive can't be mapped
     void ParseTableOfContents();
-    /// add a new file entry, create missing dir entries on the way
-    void AddEntry(const Util::String& path);
+    /// add a new entry to the directory tree, create missing dir entries on the way, returns false for directories
+    bool AddEntry(const Util::String& path);
+    /// normalize a path into the archive for lookup in the file index
+    static Util::String NormalizePath(const Util::String& path);
     /// find a file entry in the zip archive, return 0 if not exists
     const ZipFileEntry* FindFileEntry(const Util::String& pathInZipArchive) const;
     /// find a file entry in the zip archive, return 0 if not exists
@@ -63,6 +73,11 @@ private:
     Util::String rootPath;                      // location of the zip archive file
     unzFile zipFileHandle;                      // the zip file handle
     ZipDirEntry rootEntry;                      // the root entry of the zip archive
+    Util::Array<ZipFileEntry> fileEntries;      // all file entries in central directory order
+    Util::Dictionary<Util::String, IndexT> fileIndex; // normalized path to file entry, sorted by path
+    Ptr<Stream> archiveStream;                  // the archive file, memory mapped
+    const unsigned char* archiveData;           // the mapped archive, or nullptr
+    Stream::Size archiveSize;
     Threading::CriticalSection archiveCritSect; // need to serialize access to archive from multiple threads!
     zlib_filefunc64_def zlibIoFuncs;            // io functions struct from zlib to nebula
 };
@@ -20,20 +20,13 @@ ZipDirEntry::ZipDirEntry()
 
 //------------------------------------------------------------------------------
 /**
-    Adds a new file entry object to the internal dictionary. NOTE:
-    this method will not check whether the entry already exists for 
-    performance reasons (doing this would force the dictionary to be
-    sorted after every insert).
-
-    The method returns a reference of the actually added file entry.
+    Adds the name of a file in this directory. NOTE: this method will not
+    check whether the name already exists for performance reasons.
 */
-ZipFileEntry*
-ZipDirEntry::AddFileEntry(const StringAtom& name)
+void
+ZipDirEntry::AddFileName(const StringAtom& name)
 {
-    ZipFileEntry dummy;
-    this->fileEntries.Append(dummy);
-    this->fileIndexMap.Add(name, this->fileEntries.Size() - 1);
-    return &(this->fileEntries.Back());
+    this->fileNames.Append(name);
 }
 
 //------------------------------------------------------------------------------
@@ -55,24 +48,6 @@ ZipDirEntry::AddDirEntry(const StringAtom& name)
     return &(this->dirEntries.Back());
 }
 
-//------------------------------------------------------------------------------
-/**
-*/
-ZipFileEntry*
-ZipDirEntry::FindFileEntry(const StringAtom& name) const
-{
-    n_assert(name.IsValid());
-    IndexT index = this->fileIndexMap.FindIndex(name);
-    if (InvalidIndex == index)
-    {
-        return 0;
-    }
-    else
-    {
-        return &(this->fileEntries[this->fileIndexMap.ValueAtIndex(index)]);
-    }
-}
-
 //------------------------------------------------------------------------------
 /**
 */
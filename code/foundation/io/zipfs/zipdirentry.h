@@ -6,13 +6,18 @@
     A directory entry in a zip arcive. The ZipDirEntry class is thread-safe,
     all public methods can be invoked from on the same object from different
     threads.
+
+    Directory entries are only used to list the contents of an archive, files
+    are looked up through the flat index of the ZipArchive.
     
     @copyright
     (C) 2006 Radon Labs GmbH
     (C) 2013-2020 Individual contributors, see AUTHORS file
 */
 #include "core/types.h"
-#include "io/zipfs/zipfileentry.h"
+#include "util/array.h"
+#include "util/dictionary.h"
+#include "util/stringatom.h"
 
 //------------------------------------------------------------------------------
 namespace IO    
@@ -25,29 +30,26 @@ public:
     
     /// get the name of the dir entry
     const Util::StringAtom& GetName() const;
-    /// find a direct child file entry, return 0 if not exists
-    ZipFileEntry* FindFileEntry(const Util::StringAtom& name) const;
     /// find a direct child directory entry, return 0 if not exists
     ZipDirEntry* FindDirEntry(const Util::StringAtom& name) const;
     /// get directory entries
     const Util::Array<ZipDirEntry>& GetDirEntries() const;
-    /// get file entries
-    const Util::Array<ZipFileEntry>& GetFileEntries() const;
+    /// get names of the files in the directory
+    const Util::Array<Util::StringAtom>& GetFileNames() const;
     
 private:
     friend class ZipArchive;
 
     /// set the name of the dir entry
     void SetName(const Util::StringAtom& n);
-    /// add a file child entry
-    ZipFileEntry* AddFileEntry(const Util::StringAtom& name);
+    /// add the name of a file in the directory
+    void AddFileName(const Util::StringAtom& name);
     /// add a directory child entry
     ZipDirEntry* AddDirEntry(const Util::StringAtom& name);
 
     Util::StringAtom name;
-    Util::Array<ZipFileEntry> fileEntries;
+    Util::Array<Util::StringAtom> fileNames;
     Util::Array<ZipDirEntry> dirEntries;
-    Util::Dictionary<Util::StringAtom, IndexT> fileIndexMap;
     Util::Dictionary<Util::StringAtom, IndexT> dirIndexMap;
 };
 
@@ -81,10 +83,10 @@ ZipDirEntry::GetDirEntries() const
 //------------------------------------------------------------------------------
 /**
 */
-inline const Util::Array<ZipFileEntry>&
-ZipDirEntry::GetFileEntries() const
+inline const Util::Array<Util::StringAtom>&
+ZipDirEntry::GetFileNames() const
 {
-    return this->fileEntries;
+    return this->fileNames;
 }
 
 
@@ -5,6 +5,7 @@
 //------------------------------------------------------------------------------
 
 #include "io/zipfs/zipfileentry.h"
+#include "zlib/zlib.h"
 
 namespace IO
 {
@@ -17,7 +18,14 @@ using namespace Threading;
 ZipFileEntry::ZipFileEntry() :
     archiveCritSect(0),
     zipFileHandle(0),
-    uncompressedSize(0)
+    uncompressedSize(0),
+    archiveData(nullptr),
+    archiveSize(0),
+    localHeaderOffset(0),
+    compressedSize(0),
+    compressionMethod(0),
+    flags(0),
+    crc(0)
 {
     Memory::Clear(&this->filePosInfo, sizeof(this->filePosInfo));
 }
@@ -57,12 +65,58 @@ ZipFileEntry::Setup(const StringAtom& n, unzFile h, CriticalSection* critSect)
     this->uncompressedSize = fileInfo.uncompressed_size;
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ZipFileEntry::Setup(const StringAtom& n, unzFile h, CriticalSection* critSect, const unz64_file_pos& filePos,
+    const unsigned char* data, uint64_t dataSize, uint64_t headerOffset,
+    uint64_t packedSize, uint64_t unpackedSize, uint16_t method, uint16_t entryFlags, uint32_t entryCrc)
+{
+    n_assert(0 != h);
+    n_assert(0 == this->zipFileHandle);
+    n_assert(0 != critSect);
+    n_assert(nullptr != data);
+
+    this->name = n;
+    this->zipFileHandle = h;
+    this->archiveCritSect = critSect;
+    this->filePosInfo = filePos;
+    this->uncompressedSize = unpackedSize;
+    this->archiveData = data;
+    this->archiveSize = dataSize;
+    this->localHeaderOffset = headerOffset;
+    this->compressedSize = packedSize;
+    this->compressionMethod = method;
+    this->flags = entryFlags;
+    this->crc = entryCrc;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Entries are decompressed from the mapping if they are stored or deflated
+    and not encrypted, everything else is left to minizip.
+*/
+bool
+ZipFileEntry::IsDirect() const
+{
+    return (nullptr != this->archiveData)
+        && (0 == (this->flags & 1))
+        && ((0 == this->compressionMethod) || (Z_DEFLATED == this->compressionMethod));
+}
+
 //------------------------------------------------------------------------------
 /**
 */
 bool
 ZipFileEntry::Open(const String& password)
 {
+    // direct entries don't need the shared handle
+    if (this->IsDirect())
+    {
+        return true;
+    }
+
     // critical section active until close is called or this function fails
     this->archiveCritSect->Enter();
 
@@ -99,6 +153,11 @@ ZipFileEntry::Open(const String& password)
 void
 ZipFileEntry::Close()
 {
+    if (this->IsDirect())
+    {
+        return;
+    }
+
     // close the file
     int res = unzCloseCurrentFile(this->zipFileHandle);
     n_assert(UNZ_OK == res);
@@ -116,6 +175,10 @@ ZipFileEntry::Read(void* buf, Stream::Size numBytes) const
     n_assert(0 != this->zipFileHandle);
     n_assert(0 != buf);
     n_assert(0 != this->archiveCritSect);
+    if (this->IsDirect())
+    {
+        return this->ReadDirect(buf, numBytes);
+    }
     n_assert(numBytes < INT_MAX);
     // read uncompressed data 
     int readResult = unzReadCurrentFile(this->zipFileHandle, buf, (uint32_t)numBytes);
@@ -124,4 +187,100 @@ ZipFileEntry::Read(void* buf, Stream::Size numBytes) const
     return true;
 }
 
+//------------------------------------------------------------------------------
+/**
+    Locate the entry data behind its local header and inflate it into the
+    buffer. Only touches the mapping and a private z_stream, so any number of
+    threads may read from the same archive at once.
+*/
+bool
+ZipFileEntry::ReadDirect(void* buf, Stream::Size numBytes) const
+{
+    n_assert(numBytes <= (Stream::Size)this->uncompressedSize);
+
+    // the local header repeats the name and may have a different extra field than the central directory
+    const uint64_t LocalHeaderSize = 30;
+    if (this->localHeaderOffset + LocalHeaderSize > this->archiveSize)
+    {
+        return false;
+    }
+    const unsigned char* header = this->archiveData + this->localHeaderOffset;
+    if (header[0] != 'P' || header[1] != 'K' || header[2] != 3 || header[3] != 4)
+    {
+        n_warning("ZipFileEntry: bad local header for '%s'\n", this->name.Value());
+        return false;
+    }
+    const uint64_t nameLength = header[26] | (header[27] << 8);
+    const uint64_t extraLength = header[28] | (header[29] << 8);
+    const uint64_t dataOffset = this->localHeaderOffset + LocalHeaderSize + nameLength + extraLength;
+    if (dataOffset + this->compressedSize > this->archiveSize)
+    {
+        return false;
+    }
+    const unsigned char* src = this->archiveData + dataOffset;
+
+    if (0 == this->compressionMethod)
+    {
+        Memory::Copy(src, buf, numBytes);
+    }
+    else
+    {
+        // raw deflate stream, fed in pieces since zlib counts bytes in 32 bits
+        const uint64_t MaxChunk = 1u << 30;
+        z_stream stream;
+        Memory::Clear(&stream, sizeof(stream));
+        if (Z_OK != inflateInit2(&stream, -MAX_WBITS))
+        {
+            return false;
+        }
+        uint64_t inLeft = this->compressedSize;
+        uint64_t outLeft = numBytes;
+        stream.next_in = (Bytef*)src;
+        stream.next_out = (Bytef*)buf;
+        int res = Z_OK;
+        while (Z_OK == res && (outLeft > 0 || stream.avail_out > 0))
+        {
+            if (0 == stream.avail_in)
+            {
+                stream.avail_in = (uInt)Math::min(inLeft, MaxChunk);
+                inLeft -= stream.avail_in;
+            }
+            if (0 == stream.avail_out)
+            {
+                stream.avail_out = (uInt)Math::min(outLeft, MaxChunk);
+                outLeft -= stream.avail_out;
+            }
+            res = inflate(&stream, Z_NO_FLUSH);
+        }
+        const uint64_t produced = (uint64_t)numBytes - outLeft - stream.avail_out;
+        inflateEnd(&stream);
+        if ((Z_OK != res && Z_STREAM_END != res) || produced != (uint64_t)numBytes)
+        {
+            n_warning("ZipFileEntry: failed to inflate '%s'\n", this->name.Value());
+            return false;
+        }
+    }
+
+    // the checksum covers the whole file, so it can only be checked on full reads
+    if (numBytes == (Stream::Size)this->uncompressedSize)
+    {
+        uLong checksum = crc32(0L, Z_NULL, 0);
+        const Bytef* ptr = (const Bytef*)buf;
+        uint64_t left = numBytes;
+        while (left > 0)
+        {
+            uInt chunk = (uInt)Math::min(left, (uint64_t)(1u << 30));
+            checksum = crc32(checksum, ptr, chunk);
+            ptr += chunk;
+            left -= chunk;
+        }
+        if (checksum != this->crc)
+        {
+            n_warning("ZipFileEntry: crc mismatch in '%s'\n", this->name.Value());
+            return false;
+        }
+    }
+    return true;
+}
+
 } // namespace ZipFileEntry
@@ -6,6 +6,13 @@
     A file entry in a zip archive. The ZipFileEntry class is thread-safe,
     all public methods can be invoked from on the same object from different
     threads.
+
+    If the archive is memory mapped, stored and deflated entries are
+    decompressed straight from the mapping, so reads from different threads
+    run concurrently. Encrypted entries, and entries of archives which
+    couldn't be mapped, are read through the archive's shared minizip handle,
+    which serializes them on the archive's critical section from Open() until
+    Close().
     
     @copyright
     (C) 2006 Radon Labs GmbH
@@ -30,7 +37,6 @@ public:
     const Util::StringAtom& GetName() const;
     /// get the uncompressed file size in bytes
     IO::Stream::Size GetFileSize() const;
-
     /// open the zip file
     bool Open(const Util::String& password = "");
     /// close the zip file
@@ -41,14 +47,30 @@ public:
 private:
     friend class ZipArchive;
     
-    /// setup the file entry object
+    /// setup the file entry object from the current file of the zip handle
     void Setup(const Util::StringAtom& name, unzFile zipFileHandle, Threading::CriticalSection* critSect);
+    /// setup the file entry object from its central directory record in a mapped archive
+    void Setup(const Util::StringAtom& name, unzFile zipFileHandle, Threading::CriticalSection* critSect, const unz64_file_pos& filePos,
+        const unsigned char* archiveData, uint64_t archiveSize, uint64_t localHeaderOffset,
+        uint64_t compressedSize, uint64_t uncompressedSize, uint16_t compressionMethod, uint16_t flags, uint32_t crc);
+    /// return true if the entry is decompressed directly from the mapped archive
+    bool IsDirect() const;
+    /// decompress the entry from the mapped archive
+    bool ReadDirect(void* buf, IO::Stream::Size numBytes) const;
 
     Threading::CriticalSection* archiveCritSect;
     Util::StringAtom name;
     unzFile zipFileHandle;    // handle on zip file
     unz64_file_pos filePosInfo; // info about position in zip file
     uint64_t uncompressedSize;    // uncompressed size of the file
+
+    const unsigned char* archiveData;   // the mapped archive, or nullptr
+    uint64_t archiveSize;
+    uint64_t localHeaderOffset;         // offset of the local file header in the archive
+    uint64_t compressedSize;
+    uint16_t compressionMethod;
+    uint16_t flags;
+    uint32_t crc;
 };
 
 //------------------------------------------------------------------------------
@@ -71,4 +93,3 @@ ZipFileEntry::GetFileSize() const
 
 } // namespace IO
 //------------------------------------------------------------------------------
-
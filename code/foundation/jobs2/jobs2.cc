@@ -11,6 +11,7 @@ namespace Jobs2
 {
 
 Jobs2Context ctx;
+thread_local bool isWorkerThread = false;
 
 __ImplementClass(Jobs2::JobThread, 'J2TH', Threading::Thread);
 //------------------------------------------------------------------------------
@@ -57,6 +58,7 @@ JobThread::EmitWakeupSignal()
 void
 JobThread::DoWork()
 {
+    isWorkerThread = true;
     if (this->enableIo)
         IO::IoServer::Create();
     if (this->enableProfiling)
@@ -257,6 +259,15 @@ JobNewFrame()
     N_BUDGET_COUNTER_RESET(N_JOBS2_MEMORY_COUNTER);
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+JobIsWorkerThread()
+{
+    return isWorkerThread;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -266,9 +277,11 @@ JobAlloc(SizeT bytes)
     // make sure to always pad to next 16 byte alignment in case the 
     // context used needs to be aligned
     bytes = Math::align(bytes, 16);
-    n_assert((ctx.iterator + bytes) < ctx.scratchMemorySize);
-    void* ret = (ctx.scratchMemory[ctx.activeBuffer] + ctx.iterator);
-    ctx.iterator += bytes;
+
+    // jobs may dispatch jobs too, so the allocation has to be atomic
+    IndexT offset = Threading::Interlocked::Add((volatile int*)&ctx.iterator, bytes);
+    n_assert((offset + bytes) < ctx.scratchMemorySize);
+    void* ret = (ctx.scratchMemory[ctx.activeBuffer] + offset);
     N_BUDGET_COUNTER_INCR(N_JOBS2_MEMORY_COUNTER, bytes);
     return ret;
 }
@@ -282,10 +295,10 @@ JobSequencePlaceholder(SizeT totalJobs, SizeT groupSize, IndexT groupIndex, Size
     // Do nothing, this is just held by a sequence node to provide validity
 }
 
-Jobs2::JobNode* sequenceNode = nullptr;
-Jobs2::JobNode* sequenceTail = nullptr;
-const Threading::AtomicCounter* prevDoneCounter = nullptr;
-Threading::ThreadId sequenceThread;
+thread_local Jobs2::JobNode* sequenceNode = nullptr;
+thread_local Jobs2::JobNode* sequenceTail = nullptr;
+thread_local const Threading::AtomicCounter* prevDoneCounter = nullptr;
+thread_local Threading::ThreadId sequenceThread;
 
 //------------------------------------------------------------------------------
 /**
@@ -357,6 +370,12 @@ JobEndSequence(Threading::Event* signalEvent)
         ctx.tail = sequenceNode;
 
         ctx.jobLock.Leave();
+
+        // Trigger threads to wake up and compete for jobs
+        for (Ptr<JobThread>& thread : ctx.threads)
+        {
+            thread->SignalWorkAvailable();
+        }
     }
     prevDoneCounter = nullptr;
     sequenceNode = nullptr;
@@ -178,11 +178,14 @@ template <typename T> T* JobAlloc(SizeT count);
 void* JobAlloc(SizeT bytes);
 /// Progress to new buffer
 void JobNewFrame();
-
-extern JobNode* sequenceNode;
-extern JobNode* sequenceTail;
-extern const Threading::AtomicCounter* prevDoneCounter;
-extern Threading::ThreadId sequenceThread;
+/// Returns true if called from one of the job system threads
+bool JobIsWorkerThread();
+
+// sequences are built per thread, so jobs can begin sequences of their own
+extern thread_local JobNode* sequenceNode;
+extern thread_local JobNode* sequenceTail;
+extern thread_local const Threading::AtomicCounter* prevDoneCounter;
+extern thread_local Threading::ThreadId sequenceThread;
 
 /// Begin a sequence of jobs
 void JobBeginSequence(const Util::FixedArray<const Threading::AtomicCounter*>& waitCounters = nullptr
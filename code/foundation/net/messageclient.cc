@@ -45,6 +45,7 @@ MessageClient::Connect()
     if (TcpClient::Success == res)
     {
         this->sendMessageStream = MemoryStream::Create();
+        this->recvMessageBuffer = MemoryStream::Create();
     }
     return res;
 }
@@ -58,6 +59,7 @@ MessageClient::Disconnect()
     TcpClient::Disconnect();
     this->sendMessageStream = nullptr;
     this->recvMessageStream = nullptr;
+    this->recvMessageBuffer = nullptr;
 }
 
 //------------------------------------------------------------------------------
@@ -96,26 +98,25 @@ MessageClient::Recv()
     // first check if new data is available from the socket
     if (TcpClient::Recv())
     {
-        // decode incoming data into separate message, and queue the
-        // message for later use
+        // decode incoming data into the receive ring of the codec, complete
+        // messages are queued as views into the ring
         this->codec.DecodeStream(this->recvStream);
-        if (this->codec.HasMessages())
-        {
-            Array<Ptr<Stream> > msgArray = this->codec.DequeueMessages();
-            IndexT i;
-            for (i = 0; i < msgArray.Size(); i++)
-            {
-                this->msgQueue.Enqueue(msgArray[i]);
-            }
-        }
     }
 
-    // set the oldest received message from the message queue
-    // as receive stream (we either return 1 complete message,
-    // or none at all per call to Recv()
-    if (!this->msgQueue.IsEmpty())
+    // copy the oldest received message into the receive stream (we
+    // either return 1 complete message, or none at all per call to Recv()
+    TcpMessageView message;
+    if (this->codec.DequeueMessage(message))
     {
-        this->recvMessageStream = this->msgQueue.Dequeue();
+        this->recvMessageBuffer->SetAccessMode(Stream::WriteAccess);
+        this->recvMessageBuffer->SetSize(0);
+        if (this->recvMessageBuffer->Open())
+        {
+            this->recvMessageBuffer->Write(message.GetData(), message.GetSize());
+            this->recvMessageBuffer->Close();
+        }
+        this->recvMessageBuffer->SetAccessMode(Stream::ReadAccess);
+        this->recvMessageStream = this->recvMessageBuffer.upcast<Stream>();
         return true;
     }
     else
@@ -44,7 +44,7 @@ private:
     TcpMessageCodec codec;
     Ptr<IO::Stream> sendMessageStream;
     Ptr<IO::Stream> recvMessageStream;
-    Util::Queue<Ptr<IO::Stream> > msgQueue;
+    Ptr<IO::MemoryStream> recvMessageBuffer;
 };
 
 //------------------------------------------------------------------------------
@@ -42,11 +42,12 @@ MessageClientConnection::Connect(const Ptr<Socket>& s)
 {
     n_assert(!this->sendMessageStream.isvalid());
     n_assert(!this->recvMessageStream.isvalid());
-    n_assert(this->msgQueue.IsEmpty());
+    n_assert(this->codec.GetNumMessages() == 0);
     bool res = TcpClientConnection::Connect(s);
     if (res)
     {
         this->sendMessageStream = MemoryStream::Create();
+        this->recvMessageBuffer = MemoryStream::Create();
     }
     return res;
 }
@@ -58,10 +59,12 @@ MessageClientConnection::Connect(const Ptr<Socket>& s)
 void
 MessageClientConnection::Shutdown()
 {
-    n_assert(this->msgQueue.IsEmpty());
+    n_assert(this->codec.GetNumMessages() == 0);
     TcpClientConnection::Shutdown();
     this->sendMessageStream = nullptr;
     this->recvMessageStream = nullptr;
+    this->recvMessageBuffer = nullptr;
+    this->recvMessage.Release();
 }
 
 //------------------------------------------------------------------------------
@@ -77,7 +80,8 @@ MessageClientConnection::Send()
 
 //------------------------------------------------------------------------------
 /**
-    Writes given stream into a message container and sends this container.
+    Frames the given stream into the send ring of the codec and sends the
+    filled slabs, which are recycled once they have been sent.
 */
 Socket::Result
 MessageClientConnection::Send(const Ptr<IO::Stream> &stream)
@@ -90,11 +94,24 @@ MessageClientConnection::Send(const Ptr<IO::Stream> &stream)
     }
 
     stream->SetAccessMode(Stream::ReadAccess);
-    this->codec.EncodeToMessage(stream, this->sendStream);
-
-    n_printf("MessageClientConnection: sending %ld bytes\n", this->sendStream->GetSize());
-
-    return TcpClientConnection::Send(sendStream);
+    if (!stream->Open())
+    {
+        return Socket::Error;
+    }
+    n_assert(stream->GetSize() < INT_MAX);
+    this->codec.Encode(stream->Map(), (SizeT)stream->GetSize());
+    stream->Unmap();
+    stream->Close();
+
+    Socket::Result res = Socket::Success;
+    this->codec.TakeSendBuffers(this->sendBuffers);
+    IndexT i;
+    for (i = 0; (i < this->sendBuffers.Size()) && (Socket::Success == res); i++)
+    {
+        res = this->SendBuffer(this->sendBuffers[i]);
+    }
+    this->sendBuffers.Clear();
+    return res;
 }
 
 //------------------------------------------------------------------------------
@@ -116,35 +133,43 @@ MessageClientConnection::GetSendStream()
 Socket::Result
 MessageClientConnection::Recv()
 {
+    // release the previous message, so its slab can be recycled
+    this->recvMessage.Release();
+
     // first check if new data is available from the socket...
     Socket::Result returnValue = TcpClientConnection::Recv();
     if (Socket::Success == returnValue)
     {
-        // decode incoming data into separate messages, and queue 
-        // the messages for later use
-        this->codec.DecodeStream(this->recvStream);
-        if (this->codec.HasMessages())
+        // decode incoming data into the receive ring of the codec, complete
+        // messages are queued as views into the ring
+        const Ptr<Stream>& stream = this->recvStream;
+        stream->SetAccessMode(Stream::ReadAccess);
+        if (stream->Open())
         {
-            Array<Ptr<Stream> > msgArray = this->codec.DequeueMessages();
-            IndexT i;
-            for (i = 0; i < msgArray.Size(); i++)
+            if (stream->GetSize() > 0)
             {
-                this->msgQueue.Enqueue(msgArray[i]);
+                n_assert(stream->GetSize() < INT_MAX);
+                this->codec.Decode(stream->Map(), (SizeT)stream->GetSize());
+                stream->Unmap();
             }
-        }
-        else
-        {
-            // Connection blocks if received data, but no complete message
-            returnValue = Socket::WouldBlock;
+            stream->Close();
         }
     }
 
-    // now write the oldest message from the message queue
-    // to the recv stream, so that exactly one 
-    if (!this->msgQueue.IsEmpty())
+    // now hand out the oldest message, so that exactly one
+    // message is returned per call
+    if (this->codec.DequeueMessage(this->recvMessage))
     {
-        this->recvMessageStream = this->msgQueue.Dequeue();
-        
+        this->recvMessageBuffer->SetAccessMode(Stream::WriteAccess);
+        this->recvMessageBuffer->SetSize(0);
+        if (this->recvMessageBuffer->Open())
+        {
+            this->recvMessageBuffer->Write(this->recvMessage.GetData(), this->recvMessage.GetSize());
+            this->recvMessageBuffer->Close();
+        }
+        this->recvMessageBuffer->SetAccessMode(Stream::ReadAccess);
+        this->recvMessageStream = this->recvMessageBuffer.upcast<Stream>();
+
         // as long as messages are available, and no error occured,
         // set the result to Success
         if (Socket::Error != returnValue)
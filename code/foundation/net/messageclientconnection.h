@@ -13,13 +13,18 @@
     The MessageClientConnection will concatenate incoming data chunks to full messages and
     Recv() will only return finished messages.
 
+    Messages are framed directly into the send ring of the TcpMessageCodec, and the
+    filled slabs are sent without copying them again. Received messages stay in the
+    receive ring of the codec, GetRecvMessage() gives access to the current message
+    without copying it, GetRecvStream() copies it into a stream which is reused.
+
     @copyright
     (C) 2009 Radon Labs GmbH
     (C) 2013-2020 Individual contributors, see AUTHORS file
 */
 #include "net/tcpclientconnection.h"
 #include "net/tcpmessagecodec.h"
-#include "util/queue.h"
+#include "io/memorystream.h"
 
 //------------------------------------------------------------------------------
 namespace Net
@@ -48,11 +53,25 @@ public:
     virtual Socket::Result Recv();
     /// access to recv stream
     virtual const Ptr<IO::Stream>& GetRecvStream();    
+    /// access to the message received by the last Recv() without copying it
+    const TcpMessageView& GetRecvMessage() const;
 
 private:   
     Ptr<IO::Stream> sendMessageStream;
     Ptr<IO::Stream> recvMessageStream;
-    Util::Queue<Ptr<IO::Stream> > msgQueue;
+    Ptr<IO::MemoryStream> recvMessageBuffer;
+    TcpMessageView recvMessage;
+    Util::Array<Ptr<TcpSendBuffer>> sendBuffers;
     TcpMessageCodec codec;
 };
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const TcpMessageView&
+MessageClientConnection::GetRecvMessage() const
+{
+    return this->recvMessage;
+}
+
 } // namespace Net
\ No newline at end of file
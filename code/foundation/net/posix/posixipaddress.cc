@@ -169,6 +169,16 @@ PosixIpAddress::GetHostAddr() const
     return this->addrAsString;
 }
 
+//------------------------------------------------------------------------------
+/**
+    Return the ipv4 address in host byte order.
+*/
+uint
+PosixIpAddress::GetAddr() const
+{
+    return ntohl(((const sockaddr_in &)this->addr).sin_addr.s_addr);
+}
+
 //------------------------------------------------------------------------------
 /**
     This resolves a host name into a IPv4 ip address. The ip address is
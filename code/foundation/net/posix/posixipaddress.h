@@ -60,6 +60,8 @@ public:
     ushort GetPort() const;
     /// get the ip address resulting from the host name as string
     const Util::String& GetHostAddr() const;
+    /// get the ipv4 address in host byte order, as used by Socket::SendTo()
+    uint GetAddr() const;
 
 protected:
     friend class PosixSocket;
@@ -9,6 +9,7 @@
 #include <sys/errno.h>
 #include <fcntl.h>
 #include <netdb.h>
+#include <netinet/in.h>
 
 namespace Posix
 {
@@ -286,6 +287,16 @@ PosixSocket::Bind()
         n_printf("PosixSocket::Bind(): bind() failed with '%s'!\n", this->GetErrorString().AsCharPtr());
         return false;
     }
+    if (0 == this->addr.GetPort())
+    {
+        // let the address reflect the port picked by the system
+        sockaddr_in boundAddr;
+        socklen_t boundAddrLen = sizeof(boundAddr);
+        if (SOCKET_ERROR != getsockname(this->sock, (sockaddr*)&boundAddr, &boundAddrLen))
+        {
+            this->addr.SetPort(ntohs(boundAddr.sin_port));
+        }
+    }
     this->isBound = true;
     return true;
 }
@@ -332,6 +343,12 @@ PosixSocket::Accept(Ptr<Net::Socket>& outSocket)
     if (INVALID_SOCKET == newSocket)
     {
         this->SetToLastSocketError();
+
+        // a non-blocking socket has no more connections waiting
+        if (!this->isBlocking && ErrorWouldBlock == this->error)
+        {
+            return false;
+        }
         n_printf("PosixSocket::Accept(): accept() failed with '%s'!\n", this->GetErrorString().AsCharPtr());
         return false;
     }
@@ -440,10 +457,10 @@ PosixSocket::Send(const void* buf, SizeT numBytes, SizeT& bytesSent)
     n_assert(0 != buf);
     this->ClearError();
     bytesSent = 0;
-    int res = send(this->sock, (const char*) buf, numBytes, 0);
+    int res = send(this->sock, (const char*) buf, numBytes, MSG_NOSIGNAL);
     if (SOCKET_ERROR == res)
     {
-        if (EWOULDBLOCK == res)
+        if (EWOULDBLOCK == errno)
         {
             return WouldBlock;
         }
@@ -457,6 +474,41 @@ PosixSocket::Send(const void* buf, SizeT numBytes, SizeT& bytesSent)
     return Success;
 }
 
+//------------------------------------------------------------------------------
+/**
+    Send several buffers at once, as if they were a single contiguous buffer.
+    Like Send(), this may send less than the sum of all buffers, even though
+    the return value is Success.
+*/
+PosixSocket::Result
+PosixSocket::SendVectored(const struct iovec* buffers, SizeT numBuffers, SizeT& bytesSent)
+{
+    n_assert(this->IsOpen());
+    n_assert(0 != buffers);
+    this->ClearError();
+    bytesSent = 0;
+
+    msghdr msg;
+    Memory::Clear(&msg, sizeof(msg));
+    msg.msg_iov = (struct iovec*)buffers;
+    msg.msg_iovlen = numBuffers;
+    ssize_t res = sendmsg(this->sock, &msg, MSG_NOSIGNAL);
+    if (SOCKET_ERROR == res)
+    {
+        if (EWOULDBLOCK == errno)
+        {
+            return WouldBlock;
+        }
+        else
+        {
+            this->SetToLastSocketError();
+            return Error;
+        }
+    }
+    bytesSent = (SizeT)res;
+    return Success;
+}
+
 //------------------------------------------------------------------------------
 /**
     This method checks if the socket has received data available. Use
@@ -548,26 +600,219 @@ PosixSocket::Recv(void* buf, SizeT bufSize, SizeT& bytesReceived)
 
 //------------------------------------------------------------------------------
 /**
-    FIXME: this is the send method for connectionless sockets using the 
-    UDP protocol.
+    Fill a sockaddr_in from an address and port in host byte order.
+*/
+static void
+ToSockAddr(uint addr, ushort port, sockaddr_in& outAddr)
+{
+    Memory::Clear(&outAddr, sizeof(outAddr));
+    outAddr.sin_family = AF_INET;
+    outAddr.sin_addr.s_addr = htonl(addr);
+    outAddr.sin_port = htons(port);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Send a single datagram to an address on a connectionless socket. The
+    address and port are expected in host byte order. A datagram is either
+    sent completely or not at all.
 */
 PosixSocket::Result
-PosixSocket::SendTo(const void* /*buf*/, SizeT /*numBytes*/, uint /*addr*/, ushort /*port*/, SizeT& /*bytesSent*/)
+PosixSocket::SendTo(const void* buf, SizeT numBytes, uint addr, ushort port, SizeT& bytesSent)
 {
-    n_error("PosixSocket::SendTo(): IMPLEMENT ME!");
-    return Error;
+    n_assert(this->IsOpen());
+    n_assert(0 != buf);
+    this->ClearError();
+    bytesSent = 0;
+    sockaddr_in sockAddr;
+    ToSockAddr(addr, port, sockAddr);
+    ssize_t res = sendto(this->sock, buf, numBytes, MSG_NOSIGNAL, (const sockaddr*)&sockAddr, sizeof(sockAddr));
+    if (SOCKET_ERROR == res)
+    {
+        if (EWOULDBLOCK == errno)
+        {
+            return WouldBlock;
+        }
+        this->SetToLastSocketError();
+        return Error;
+    }
+    bytesSent = (SizeT)res;
+    return Success;
 }
 
 //------------------------------------------------------------------------------
 /**
-    FIXME: this is the recv method for connectionless socket using the UDP
-    protocol.
+    Receive a single datagram on a connectionless socket, the address and
+    port of the sender are returned in host byte order. Datagrams which are
+    larger than the buffer are truncated. Unlike Recv(), an empty datagram
+    is a valid result and doesn't mean the socket has been closed.
 */
 PosixSocket::Result
-PosixSocket::RecvFrom(void* /*buf*/, SizeT /*bufSize*/, uint /*addr*/, ushort /*port*/, SizeT& /*bytesReceived*/)
+PosixSocket::RecvFrom(void* buf, SizeT bufSize, uint& addr, ushort& port, SizeT& bytesReceived)
 {
-    n_error("PosixSocket::RecvFrom(): IMPLEMENT ME!");
-    return Error;
+    n_assert(this->IsOpen());
+    n_assert(0 != buf);
+    this->ClearError();
+    bytesReceived = 0;
+    sockaddr_in sockAddr;
+    socklen_t sockAddrLen = sizeof(sockAddr);
+    ssize_t res = recvfrom(this->sock, buf, bufSize, 0, (sockaddr*)&sockAddr, &sockAddrLen);
+    if (SOCKET_ERROR == res)
+    {
+        if (EWOULDBLOCK == errno)
+        {
+            return WouldBlock;
+        }
+        this->SetToLastSocketError();
+        return Error;
+    }
+    addr = ntohl(sockAddr.sin_addr.s_addr);
+    port = ntohs(sockAddr.sin_port);
+    bytesReceived = (SizeT)res;
+    return Success;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Send several datagrams with as few system calls as possible (sendmmsg,
+    other platforms send them one by one). Returns WouldBlock if not a single
+    datagram could be sent, numSent tells how many datagrams went out, the
+    remaining ones have to be resent by the caller.
+*/
+PosixSocket::Result
+PosixSocket::SendBatch(const Datagram* datagrams, SizeT numDatagrams, SizeT& numSent)
+{
+    n_assert(this->IsOpen());
+    n_assert(0 != datagrams);
+    this->ClearError();
+    numSent = 0;
+
+#if __linux__
+    const SizeT MaxBatch = 64;
+    mmsghdr msgs[MaxBatch];
+    iovec iovs[MaxBatch];
+    sockaddr_in addrs[MaxBatch];
+    while (numSent < numDatagrams)
+    {
+        const SizeT batchSize = Math::min(numDatagrams - numSent, MaxBatch);
+        IndexT i;
+        for (i = 0; i < batchSize; i++)
+        {
+            const Datagram& datagram = datagrams[numSent + i];
+            ToSockAddr(datagram.addr, datagram.port, addrs[i]);
+            iovs[i].iov_base = datagram.buf;
+            iovs[i].iov_len = datagram.numBytes;
+            Memory::Clear(&msgs[i], sizeof(mmsghdr));
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        int res = sendmmsg(this->sock, msgs, batchSize, MSG_NOSIGNAL);
+        if (SOCKET_ERROR == res)
+        {
+            if (EWOULDBLOCK == errno)
+            {
+                return numSent > 0 ? Success : WouldBlock;
+            }
+            this->SetToLastSocketError();
+            return Error;
+        }
+        numSent += res;
+        if (res < batchSize)
+        {
+            // the socket buffer is full
+            break;
+        }
+    }
+    return Success;
+#else
+    while (numSent < numDatagrams)
+    {
+        const Datagram& datagram = datagrams[numSent];
+        SizeT bytesSent;
+        const Result res = this->SendTo(datagram.buf, datagram.numBytes, datagram.addr, datagram.port, bytesSent);
+        if (Success != res)
+        {
+            return (WouldBlock == res && numSent > 0) ? Success : res;
+        }
+        numSent++;
+    }
+    return Success;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+    Receive up to numDatagrams datagrams with a single system call (recvmmsg,
+    other platforms receive them one by one). The buf and bufSize members of
+    the datagrams must be set up by the caller, numBytes, addr and port are
+    filled in. On a blocking socket this waits for the first datagram only.
+*/
+PosixSocket::Result
+PosixSocket::RecvBatch(Datagram* datagrams, SizeT numDatagrams, SizeT& numReceived)
+{
+    n_assert(this->IsOpen());
+    n_assert(0 != datagrams);
+    this->ClearError();
+    numReceived = 0;
+
+#if __linux__
+    const SizeT MaxBatch = 64;
+    mmsghdr msgs[MaxBatch];
+    iovec iovs[MaxBatch];
+    sockaddr_in addrs[MaxBatch];
+    const SizeT batchSize = Math::min(numDatagrams, MaxBatch);
+    IndexT i;
+    for (i = 0; i < batchSize; i++)
+    {
+        iovs[i].iov_base = datagrams[i].buf;
+        iovs[i].iov_len = datagrams[i].bufSize;
+        Memory::Clear(&msgs[i], sizeof(mmsghdr));
+        msgs[i].msg_hdr.msg_name = &addrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    int res = recvmmsg(this->sock, msgs, batchSize, MSG_WAITFORONE, nullptr);
+    if (SOCKET_ERROR == res)
+    {
+        if (EWOULDBLOCK == errno)
+        {
+            return WouldBlock;
+        }
+        this->SetToLastSocketError();
+        return Error;
+    }
+    for (i = 0; i < res; i++)
+    {
+        datagrams[i].numBytes = (SizeT)msgs[i].msg_len;
+        datagrams[i].addr = ntohl(addrs[i].sin_addr.s_addr);
+        datagrams[i].port = ntohs(addrs[i].sin_port);
+    }
+    numReceived = res;
+    return Success;
+#else
+    while (numReceived < numDatagrams)
+    {
+        Datagram& datagram = datagrams[numReceived];
+        SizeT bytesReceived;
+        const Result res = this->RecvFrom(datagram.buf, datagram.bufSize, datagram.addr, datagram.port, bytesReceived);
+        if (Success != res)
+        {
+            return (WouldBlock == res && numReceived > 0) ? Success : res;
+        }
+        datagram.numBytes = bytesReceived;
+        numReceived++;
+
+        // like recvmmsg with MSG_WAITFORONE, only wait for the first datagram
+        if (this->isBlocking)
+        {
+            break;
+        }
+    }
+    return Success;
+#endif
 }
 
 //------------------------------------------------------------------------------
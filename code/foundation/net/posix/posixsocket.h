@@ -16,6 +16,7 @@
 #include "core/refcounted.h"
 #include "net/socket/ipaddress.h"
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/tcp.h>
 
 namespace Net
@@ -49,6 +50,16 @@ public:
         Closed,         // connection has been gracefully closed
     };
 
+    /// a datagram for batched sends and receives on connectionless sockets
+    struct Datagram
+    {
+        void* buf;          // packet data
+        SizeT bufSize;      // capacity of buf, only used when receiving
+        SizeT numBytes;     // size of the packet
+        uint addr;          // remote ipv4 address in host byte order
+        ushort port;        // remote port in host byte order
+    };
+
     /// error codes
     enum ErrorCode
     {
@@ -169,14 +180,23 @@ public:
     bool IsConnected();
     /// send raw data into the socket
     Result Send(const void* buf, SizeT numBytes, SizeT& bytesSent);
+    /// send a list of buffers with a single system call (scatter-gather)
+    Result SendVectored(const struct iovec* buffers, SizeT numBuffers, SizeT& bytesSent);
     /// return true if recv data is available at the socket
     bool HasRecvData();
     /// receive raw data from the socket
     Result Recv(void* buf, SizeT bufSize, SizeT& bytesReceived);
     /// send raw data to address for connectionless sockets
     Result SendTo(const void* buf, SizeT numBytes, uint addr, ushort port, SizeT& bytesSent);
-    /// receive raw data from address for connectionless sockets
-    Result RecvFrom(void* buf, SizeT bufSize, uint addr, ushort port, SizeT& bytesReceived);
+    /// receive raw data and the sender's address for connectionless sockets
+    Result RecvFrom(void* buf, SizeT bufSize, uint& addr, ushort& port, SizeT& bytesReceived);
+    /// send several datagrams, stops at the first datagram which would block
+    Result SendBatch(const Datagram* datagrams, SizeT numDatagrams, SizeT& numSent);
+    /// receive up to numDatagrams datagrams
+    Result RecvBatch(Datagram* datagrams, SizeT numDatagrams, SizeT& numReceived);
+
+    /// get the system socket, used to register the socket with epoll
+    SOCKET GetSystemSocket() const;
 
 private:
     friend class PosixIpAddress;
@@ -257,6 +277,15 @@ PosixSocket::GetAddress() const
     return this->addr;
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline SOCKET
+PosixSocket::GetSystemSocket() const
+{
+    return this->sock;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
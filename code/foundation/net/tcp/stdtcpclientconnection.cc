@@ -18,6 +18,13 @@ using namespace IO;
 /**
 */
 StdTcpClientConnection::StdTcpClientConnection()
+#if __linux__
+    : queuedBytes(0),
+    connectionResult(Socket::Success),
+    isReactorDriven(false),
+    isReady(false),
+    reactorId(0)
+#endif
 {
     // empty
 }
@@ -61,6 +68,13 @@ StdTcpClientConnection::Connect(const Ptr<Socket>& sock)
 bool
 StdTcpClientConnection::IsConnected() const
 {
+#if __linux__
+    if (this->isReactorDriven)
+    {
+        // the reactor notices when the connection breaks, so don't probe the socket
+        return this->socket.isvalid() && (Socket::Success == this->connectionResult);
+    }
+#endif
     if (this->socket.isvalid())
     {
         return this->socket->IsConnected();
@@ -77,6 +91,13 @@ StdTcpClientConnection::IsConnected() const
 void
 StdTcpClientConnection::Shutdown()
 {
+#if __linux__
+    // the reactor thread may be reading or writing
+    this->lock.Enter();
+    this->sendQueue.Clear();
+    this->queuedBytes = 0;
+    this->pendingRecvStream = nullptr;
+#endif
     if (this->socket.isvalid())
     {
         this->socket->Close();
@@ -84,6 +105,9 @@ StdTcpClientConnection::Shutdown()
     }
     this->sendStream = nullptr;
     this->recvStream = nullptr;
+#if __linux__
+    this->lock.Leave();
+#endif
 }
 
 //------------------------------------------------------------------------------
@@ -110,6 +134,49 @@ StdTcpClientConnection::Send(const Ptr<Stream>& stream)
     }
     
     Socket::Result res = Socket::Success;
+#if __linux__
+    if (this->isReactorDriven)
+    {
+        stream->SetAccessMode(Stream::ReadAccess);
+        if (stream->Open())
+        {
+            const uchar* ptr = (const uchar*)stream->Map();
+            const SizeT size = (SizeT)stream->GetSize();
+            SizeT bytesSent = 0;
+            this->lock.Enter();
+            if (!this->socket.isvalid() || (Socket::Success != this->connectionResult))
+            {
+                res = Socket::Error;
+            }
+            else if (this->sendQueue.IsEmpty())
+            {
+                // nothing is queued, so try to send without copying the data
+                res = this->socket->Send(ptr, size, bytesSent);
+                if (Socket::WouldBlock == res)
+                {
+                    res = Socket::Success;
+                }
+            }
+            if ((Socket::Success == res) && (bytesSent < size))
+            {
+                // queue the rest, the stream may change before the reactor gets to send it
+                Ptr<TcpSendBuffer> buffer = TcpSendBuffer::Create();
+                buffer->Setup(ptr + bytesSent, size - bytesSent);
+                this->sendQueue.Enqueue({ buffer, 0 });
+                this->queuedBytes += buffer->GetSize();
+                res = this->FlushLocked();
+            }
+            if (Socket::Error == res)
+            {
+                this->connectionResult = Socket::Error;
+            }
+            this->lock.Leave();
+            stream->Unmap();
+            stream->Close();
+        }
+        return res;
+    }
+#endif
     stream->SetAccessMode(Stream::ReadAccess);
     if (stream->Open())
     {
@@ -139,6 +206,56 @@ StdTcpClientConnection::Send(const Ptr<Stream>& stream)
     return res;
 }
 
+//------------------------------------------------------------------------------
+/**
+    When driven by the reactor, the buffer is queued and sent as far as
+    possible without copying it, the buffer must not be modified anymore.
+    Otherwise the buffer is sent right away.
+*/
+Socket::Result
+StdTcpClientConnection::SendBuffer(const Ptr<TcpSendBuffer>& buffer)
+{
+    n_assert(buffer.isvalid());
+    if (buffer->GetSize() == 0)
+    {
+        // nothing to send
+        return Socket::Success;
+    }
+
+    Socket::Result res = Socket::Success;
+#if __linux__
+    if (this->isReactorDriven)
+    {
+        res = Socket::Error;
+        this->lock.Enter();
+        if (this->socket.isvalid() && (Socket::Success == this->connectionResult))
+        {
+            this->sendQueue.Enqueue({ buffer, 0 });
+            this->queuedBytes += buffer->GetSize();
+            res = this->FlushLocked();
+        }
+        this->lock.Leave();
+        return res;
+    }
+#endif
+    SizeT maxMsgSize = this->socket->GetMaxMsgSize();
+    const uchar* ptr = buffer->GetData();
+    SizeT overallBytesSent = 0;
+    while ((Socket::Success == res) && (overallBytesSent < buffer->GetSize()))
+    {
+        SizeT bytesToSend = buffer->GetSize() - overallBytesSent;
+        if (bytesToSend > maxMsgSize)
+        {
+            bytesToSend = maxMsgSize;
+        }
+        SizeT bytesSent = 0;
+        res = this->socket->Send(ptr, bytesToSend, bytesSent);
+        ptr += bytesSent;
+        overallBytesSent += bytesSent;
+    }
+    return res;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -158,6 +275,29 @@ Socket::Result
 StdTcpClientConnection::Recv()
 {
     n_assert(this->recvStream.isvalid());
+#if __linux__
+    if (this->isReactorDriven)
+    {
+        // the reactor has already read the data, just swap streams
+        Socket::Result res = Socket::WouldBlock;
+        this->lock.Enter();
+        if (this->pendingRecvStream->GetSize() > 0)
+        {
+            Ptr<Stream> stream = this->recvStream;
+            this->recvStream = this->pendingRecvStream;
+            this->pendingRecvStream = stream;
+            this->pendingRecvStream->SetSize(0);
+            res = Socket::Success;
+        }
+        else if (Socket::Success != this->connectionResult)
+        {
+            res = this->connectionResult;
+        }
+        this->lock.Leave();
+        this->recvStream->SetAccessMode(Stream::ReadAccess);
+        return res;
+    }
+#endif
     this->recvStream->SetAccessMode(Stream::WriteAccess);
     this->recvStream->SetSize(0);
     Socket::Result res = Socket::Success;
@@ -213,4 +353,143 @@ StdTcpClientConnection::GetRecvStream()
     return this->recvStream;
 }
 
+#if __linux__
+//------------------------------------------------------------------------------
+/**
+*/
+void
+StdTcpClientConnection::SetupReactor()
+{
+    n_assert(this->socket.isvalid());
+    this->socket->SetBlocking(false);
+    this->pendingRecvStream = MemoryStream::Create();
+    this->isReactorDriven = true;
+}
+
+//------------------------------------------------------------------------------
+/**
+    The reactor is edge triggered, so the socket has to be read until it
+    would block, otherwise no further events are reported.
+*/
+Socket::Result
+StdTcpClientConnection::Drain()
+{
+    this->lock.Enter();
+    if (!this->socket.isvalid())
+    {
+        this->lock.Leave();
+        return Socket::Closed;
+    }
+
+    Socket::Result res = Socket::Success;
+    this->pendingRecvStream->SetAccessMode(Stream::AppendAccess);
+    if (this->pendingRecvStream->Open())
+    {
+        uchar buf[16 * 1024];
+        while (Socket::Success == res)
+        {
+            SizeT bytesReceived = 0;
+            res = this->socket->Recv(buf, sizeof(buf), bytesReceived);
+            if ((Socket::Success == res) && (bytesReceived > 0))
+            {
+                this->pendingRecvStream->Write(buf, bytesReceived);
+            }
+        }
+        this->pendingRecvStream->Close();
+    }
+
+    if (Socket::WouldBlock == res)
+    {
+        res = Socket::Success;
+    }
+    else
+    {
+        // closed or broken, reported by Recv() once the data received so far has been handed over
+        this->connectionResult = res;
+    }
+    this->lock.Leave();
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Socket::Result
+StdTcpClientConnection::Flush()
+{
+    Socket::Result res = Socket::Error;
+    this->lock.Enter();
+    if (this->socket.isvalid() && (Socket::Success == this->connectionResult))
+    {
+        res = this->FlushLocked();
+    }
+    this->lock.Leave();
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Sends the queued buffers with as few system calls as possible. If the
+    socket would block, the rest stays queued until the reactor reports the
+    socket as writable again. A client which doesn't keep up with the data
+    sent to it is considered broken once too much data is queued.
+*/
+Socket::Result
+StdTcpClientConnection::FlushLocked()
+{
+    const SizeT MaxBuffersPerSend = 64;
+    struct iovec buffers[MaxBuffersPerSend];
+    while (!this->sendQueue.IsEmpty())
+    {
+        SizeT numBuffers = Math::min(this->sendQueue.Size(), MaxBuffersPerSend);
+        IndexT i;
+        for (i = 0; i < numBuffers; i++)
+        {
+            const _QueuedSend& send = this->sendQueue[i];
+            buffers[i].iov_base = (void*)(send.buffer->GetData() + send.offset);
+            buffers[i].iov_len = send.buffer->GetSize() - send.offset;
+        }
+
+        SizeT bytesSent = 0;
+        Socket::Result res = this->socket->SendVectored(buffers, numBuffers, bytesSent);
+        if (Socket::WouldBlock == res)
+        {
+            break;
+        }
+        else if (Socket::Success != res)
+        {
+            this->connectionResult = Socket::Error;
+            return Socket::Error;
+        }
+
+        // drop buffers which have been sent completely
+        this->queuedBytes -= bytesSent;
+        while (bytesSent > 0)
+        {
+            _QueuedSend& send = this->sendQueue.Peek();
+            const SizeT remaining = send.buffer->GetSize() - send.offset;
+            if (bytesSent >= remaining)
+            {
+                bytesSent -= remaining;
+                this->sendQueue.Dequeue();
+            }
+            else
+            {
+                send.offset += bytesSent;
+                bytesSent = 0;
+            }
+        }
+    }
+
+    if (this->queuedBytes > MaxQueuedBytes)
+    {
+        n_printf("StdTcpClientConnection: client from addr=%s doesn't keep up, dropping it\n",
+            this->socket->GetAddress().GetHostAddr().AsCharPtr());
+        this->connectionResult = Socket::Error;
+        return Socket::Error;
+    }
+    return Socket::Success;
+}
+#endif
+
 } // namespace Net
@@ -17,6 +17,12 @@
     XmlReader, etc...). To send data back to the client just do the reverse:
     write data to the SendStream, and at any time call the Send() method which
     will send all data accumulated in the SendStream to the client.
+
+    On Linux, connections accepted by the StdTcpServer are non-blocking and
+    driven by the server's epoll reactor thread. The reactor reads incoming
+    data as soon as it arrives, so Recv() only hands it over without a system
+    call. Data which can't be sent right away is queued and sent by the reactor
+    as soon as the socket becomes writable again.
     
     @copyright
     (C) 2006 Radon Labs GmbH
@@ -26,10 +32,14 @@
 #include "net/socket/ipaddress.h"
 #include "io/stream.h"
 #include "net/socket/socket.h"
+#include "net/tcp/tcpsendbuffer.h"
+#include "threading/criticalsection.h"
+#include "util/queue.h"
 
 //------------------------------------------------------------------------------
 namespace Net
 {
+class StdTcpServer;
 class StdTcpClientConnection : public Core::RefCounted
 {
     __DeclareClass(StdTcpClientConnection);
@@ -50,6 +60,8 @@ public:
     virtual Socket::Result Send();
     /// directly send a stream to the server, often prevents a memory copy
     virtual Socket::Result Send(const Ptr<IO::Stream>& stream);
+    /// send a shared buffer, queued without copying it when driven by the reactor
+    Socket::Result SendBuffer(const Ptr<TcpSendBuffer>& buffer);
     /// access to send stream
     virtual const Ptr<IO::Stream>& GetSendStream();
     /// receive data from server into recv stream
@@ -58,6 +70,36 @@ public:
     virtual const Ptr<IO::Stream>& GetRecvStream();
 
 protected:
+    friend class StdTcpServer;
+
+#if __linux__
+    /// max bytes queued for sending before a connection is considered broken
+    static const SizeT MaxQueuedBytes = 16 * 1024 * 1024;
+
+    /// make the socket non-blocking and hand it over to the reactor
+    void SetupReactor();
+    /// read everything available on the socket into the pending stream, called by the reactor
+    Socket::Result Drain();
+    /// send queued buffers, called by the reactor when the socket becomes writable
+    Socket::Result Flush();
+    /// send queued buffers, must be called within the lock
+    Socket::Result FlushLocked();
+
+    struct _QueuedSend
+    {
+        Ptr<TcpSendBuffer> buffer;
+        SizeT offset;
+    };
+    Util::Queue<_QueuedSend> sendQueue;
+    SizeT queuedBytes;
+    Ptr<IO::Stream> pendingRecvStream;
+    Socket::Result connectionResult;
+    bool isReactorDriven;
+    bool isReady;
+    uint reactorId;
+    Threading::CriticalSection lock;
+#endif
+
     Ptr<Socket> socket;
     Ptr<IO::Stream> sendStream;
     Ptr<IO::Stream> recvStream;
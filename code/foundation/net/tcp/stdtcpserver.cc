@@ -5,20 +5,39 @@
 //------------------------------------------------------------------------------
 
 #include "net/tcp/stdtcpserver.h"
+#if __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
 
 namespace Net
 {
 __ImplementClass(Net::StdTcpServer, 'STSV', Core::RefCounted);
+#if __linux__
+__ImplementClass(Net::StdTcpServer::ReactorThread, 'tcrt', Threading::Thread);
+#else
 __ImplementClass(Net::StdTcpServer::ListenerThread, 'tclt', Threading::Thread);
+#endif
 
 using namespace Util;
 using namespace Threading;
 using namespace IO;
 
+#if __linux__
+/// reactor ids of the listening socket and the wakeup event, client ids follow
+static const uint ListenerId = 0;
+static const uint WakeupId = 1;
+#endif
+
 //------------------------------------------------------------------------------
 /**
 */
 StdTcpServer::StdTcpServer() :
+#if __linux__
+    nextReactorId(WakeupId + 1),
+#endif
     isOpen(false)
 {
     this->connectionClassRtti = &TcpClientConnection::RTTI;
@@ -39,9 +58,27 @@ bool
 StdTcpServer::Open()
 {
     n_assert(!this->isOpen);
-    n_assert(!this->listenerThread.isvalid());
     n_assert(this->clientConnections.IsEmpty());
 
+#if __linux__
+    n_assert(!this->reactorThread.isvalid());
+
+    // create the reactor thread, the socket is bound right away so failures are reported
+    this->reactorThread = ReactorThread::Create();
+    this->reactorThread->SetName("StdTcpServer::ReactorThread");
+    this->reactorThread->SetTcpServer(this);
+    this->reactorThread->SetAddress(this->ipAddress);
+    this->reactorThread->SetThreadAffinity(System::Cpu::Core4);
+    this->reactorThread->SetClientConnectionClass(*this->connectionClassRtti);
+    if (!this->reactorThread->Setup())
+    {
+        this->reactorThread = nullptr;
+        return false;
+    }
+    this->reactorThread->Start();
+#else
+    n_assert(!this->listenerThread.isvalid());
+
     // create the listener thread
     this->listenerThread = ListenerThread::Create();
     this->listenerThread->SetName("StdTcpServer::ListenerThread");
@@ -50,6 +87,7 @@ StdTcpServer::Open()
     this->listenerThread->SetThreadAffinity(System::Cpu::Core4);
     this->listenerThread->SetClientConnectionClass(*this->connectionClassRtti);
     this->listenerThread->Start();
+#endif
     
     this->isOpen = true;
     return true;
@@ -62,11 +100,18 @@ void
 StdTcpServer::Close()
 {
     n_assert(this->isOpen);
-    n_assert(this->listenerThread.isvalid());
-    
+
+#if __linux__
+    // stop the reactor thread
+    n_assert(this->reactorThread.isvalid());
+    this->reactorThread->Stop();
+    this->reactorThread = nullptr;
+#else
     // stop the listener thread
+    n_assert(this->listenerThread.isvalid());
     this->listenerThread->Stop();
     this->listenerThread = nullptr;
+#endif
 
     // disconnect client connections
     this->connectionCritSect.Enter();
@@ -77,6 +122,10 @@ StdTcpServer::Close()
         curConnection->Shutdown();
     }
     this->clientConnections.Clear();
+#if __linux__
+    this->reactorConnections.Clear();
+    this->readyConnections.Clear();
+#endif
     this->connectionCritSect.Leave();
 
     this->isOpen = false;
@@ -89,9 +138,21 @@ void
 StdTcpServer::AddClientConnection(const Ptr<TcpClientConnection>& conn)
 {
     n_assert(conn.isvalid());
+#if __linux__
+    // called on the reactor thread, the connection is serviced by it from now on
+    this->connectionCritSect.Enter();
+    const uint id = this->nextReactorId++;
+    conn->SetupReactor();
+    conn->reactorId = id;
+    this->clientConnections.Append(conn);
+    this->reactorConnections.Add(id, conn);
+    this->connectionCritSect.Leave();
+    this->reactorThread->Watch(conn->socket, id);
+#else
     this->connectionCritSect.Enter();
     this->clientConnections.Append(conn);
     this->connectionCritSect.Leave();
+#endif
 }
 
 //------------------------------------------------------------------------------
@@ -102,6 +163,44 @@ StdTcpServer::Recv()
 {
     Array<Ptr<TcpClientConnection> > clientsWithData;
 
+#if __linux__
+    // only the connections the reactor got data for, or which broke, have to be looked at
+    this->connectionCritSect.Enter();
+    Array<Ptr<TcpClientConnection> > ready = this->readyConnections;
+    this->readyConnections.Clear();
+    IndexT readyIndex;
+    for (readyIndex = 0; readyIndex < ready.Size(); readyIndex++)
+    {
+        const Ptr<TcpClientConnection>& cur = ready[readyIndex];
+        cur->isReady = false;
+        if (Socket::Success == cur->Recv())
+        {
+            clientsWithData.Append(cur);
+
+            // if the client disconnected after sending, drop it with the next call
+            if (!cur->IsConnected())
+            {
+                this->MarkReady(cur);
+            }
+        }
+    }
+
+    // drop closed connections, this doesn't probe the sockets
+    IndexT clientIndex;
+    for (clientIndex = 0; clientIndex < this->clientConnections.Size();)
+    {
+        const Ptr<TcpClientConnection>& cur = this->clientConnections[clientIndex];
+        if (!cur->IsConnected() && !cur->isReady)
+        {
+            this->DropClientConnection(clientIndex);
+        }
+        else
+        {
+            clientIndex++;
+        }
+    }
+    this->connectionCritSect.Leave();
+#else
     // iterate over all clients, and check for new data,
     // if the client connection has been closed, remove
     // the client from the list
@@ -140,6 +239,7 @@ StdTcpServer::Recv()
         }
     }
     this->connectionCritSect.Leave();
+#endif
     return clientsWithData;
 }
 
@@ -150,6 +250,29 @@ bool
 StdTcpServer::Broadcast(const Ptr<Stream>& msg)
 {
     bool result = true;
+#if __linux__
+    // copy the message once, all connections queue the same buffer
+    Ptr<TcpSendBuffer> buffer = TcpSendBuffer::Create();
+    buffer->Setup(msg);
+    if (buffer->GetSize() == 0)
+    {
+        return true;
+    }
+
+    this->connectionCritSect.Enter();
+    IndexT i;
+    for (i = 0; i < this->clientConnections.Size(); i++)
+    {
+        const Ptr<TcpClientConnection>& cur = this->clientConnections[i];
+        if (Socket::Success != cur->SendBuffer(buffer))
+        {
+            // the next Recv() drops the connection
+            this->MarkReady(cur);
+            result = false;
+        }
+    }
+    this->connectionCritSect.Leave();
+#else
     this->connectionCritSect.Enter();
     IndexT i;
     for (i = 0; i < this->clientConnections.Size(); i++)
@@ -160,9 +283,289 @@ StdTcpServer::Broadcast(const Ptr<Stream>& msg)
         }
     }
     this->connectionCritSect.Leave();
+#endif
     return result;
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+StdTcpServer::GetNumClientConnections()
+{
+    this->connectionCritSect.Enter();
+    SizeT num = this->clientConnections.Size();
+    this->connectionCritSect.Leave();
+    return num;
+}
+
+#if __linux__
+//------------------------------------------------------------------------------
+/**
+    Called on the reactor thread. The connection might be dropped concurrently,
+    in which case it's either not found, or its socket has been shut down.
+*/
+void
+StdTcpServer::Dispatch(uint id, bool readable, bool writable)
+{
+    this->connectionCritSect.Enter();
+    IndexT i = this->reactorConnections.FindIndex(id);
+    if (i == InvalidIndex)
+    {
+        this->connectionCritSect.Leave();
+        return;
+    }
+    Ptr<TcpClientConnection> conn = this->reactorConnections.ValueAtIndex(i);
+    this->connectionCritSect.Leave();
+
+    bool ready = false;
+    if (writable && (Socket::Success != conn->Flush()))
+    {
+        ready = true;
+    }
+    if (readable)
+    {
+        conn->Drain();
+        ready = true;
+    }
+
+    if (ready)
+    {
+        this->connectionCritSect.Enter();
+        this->MarkReady(conn);
+        this->connectionCritSect.Leave();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+StdTcpServer::DropClientConnection(IndexT index)
+{
+    const Ptr<TcpClientConnection> conn = this->clientConnections[index];
+    conn->Shutdown();
+    this->reactorConnections.Erase(conn->reactorId);
+    this->clientConnections.EraseIndex(index);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+StdTcpServer::MarkReady(const Ptr<TcpClientConnection>& conn)
+{
+    if (!conn->isReady)
+    {
+        conn->isReady = true;
+        this->readyConnections.Append(conn);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+StdTcpServer::ReactorThread::ReactorThread() :
+    tcpServer(nullptr),
+    connectionClassRtti(nullptr),
+    epoll(-1),
+    wakeup(-1)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+StdTcpServer::ReactorThread::~ReactorThread()
+{
+    if (this->socket.isvalid() && this->socket->IsOpen())
+    {
+        this->socket->Close();
+    }
+    this->socket = nullptr;
+    if (this->epoll >= 0)
+    {
+        close(this->epoll);
+    }
+    if (this->wakeup >= 0)
+    {
+        close(this->wakeup);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+StdTcpServer::ReactorThread::SetTcpServer(StdTcpServer* serv)
+{
+    n_assert(0 != serv);
+    this->tcpServer = serv;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+StdTcpServer::ReactorThread::SetAddress(const IpAddress& a)
+{
+    this->ipAddress = a;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+StdTcpServer::ReactorThread::SetClientConnectionClass(const Core::Rtti& type)
+{
+    this->connectionClassRtti = &type;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+StdTcpServer::ReactorThread::Setup()
+{
+    n_assert(!this->socket.isvalid());
+    this->socket = Socket::Create();
+    if (!this->socket->Open(Socket::TCP))
+    {
+        n_warn2(false, "StdTcpServer::ReactorThread: Socket::Open() failed!");
+        return false;
+    }
+    this->socket->SetAddress(this->ipAddress);
+    this->socket->SetReUseAddr(true);
+    if (!this->socket->Bind())
+    {
+        n_warn2(false, "StdTcpServer::ReactorThread: Socket::Bind() failed!");
+        return false;
+    }
+    if (!this->socket->Listen())
+    {
+        return false;
+    }
+
+    // the listener must not block so the backlog can be drained, accept() doesn't pass
+    // O_NONBLOCK on to the accepted sockets, Socket::Accept sets their mode explicitly
+    this->socket->SetBlocking(false);
+
+    this->epoll = epoll_create1(EPOLL_CLOEXEC);
+    this->wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (this->epoll < 0 || this->wakeup < 0)
+    {
+        n_warn2(false, "StdTcpServer::ReactorThread: failed to create epoll instance!");
+        return false;
+    }
+
+    epoll_event event;
+    event.events = EPOLLIN | EPOLLET;
+    event.data.u64 = ListenerId;
+    epoll_ctl(this->epoll, EPOLL_CTL_ADD, this->socket->GetSystemSocket(), &event);
+    event.events = EPOLLIN;
+    event.data.u64 = WakeupId;
+    epoll_ctl(this->epoll, EPOLL_CTL_ADD, this->wakeup, &event);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Sockets are watched for both directions at once. Being edge-triggered,
+    writability is only reported when the socket's send buffer drains after
+    a send would have blocked, which is exactly when queued data can be sent.
+*/
+void
+StdTcpServer::ReactorThread::Watch(const Ptr<Socket>& sock, uint id)
+{
+    epoll_event event;
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event.data.u64 = id;
+    if (epoll_ctl(this->epoll, EPOLL_CTL_ADD, sock->GetSystemSocket(), &event) < 0)
+    {
+        n_printf("StdTcpServer::ReactorThread: epoll_ctl() failed with '%s'\n", strerror(errno));
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Waits for socket events and dispatches them. Sockets which are closed
+    are removed from the epoll instance by the kernel.
+*/
+void
+StdTcpServer::ReactorThread::DoWork()
+{
+    const int MaxEvents = 64;
+    epoll_event events[MaxEvents];
+    while (!this->ThreadStopRequested())
+    {
+        int numEvents = epoll_wait(this->epoll, events, MaxEvents, -1);
+        if (numEvents < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            n_printf("StdTcpServer::ReactorThread: epoll_wait() failed with '%s'\n", strerror(errno));
+            break;
+        }
+
+        IndexT i;
+        for (i = 0; i < numEvents; i++)
+        {
+            const uint id = (uint)events[i].data.u64;
+            const uint flags = events[i].events;
+            if (ListenerId == id)
+            {
+                this->AcceptConnections();
+            }
+            else if (WakeupId == id)
+            {
+                uint64 value;
+                while (read(this->wakeup, &value, sizeof(value)) > 0);
+            }
+            else
+            {
+                const bool readable = (flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0;
+                const bool writable = (flags & EPOLLOUT) != 0;
+                this->tcpServer->Dispatch(id, readable, writable);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+StdTcpServer::ReactorThread::AcceptConnections()
+{
+    // edge triggered, so accept until no more clients are waiting
+    Ptr<Socket> newSocket;
+    while (this->socket->Accept(newSocket))
+    {
+        Ptr<TcpClientConnection> newConnection = (TcpClientConnection*) this->connectionClassRtti->Create();
+        if (newConnection->Connect(newSocket))
+        {
+            this->tcpServer->AddClientConnection(newConnection);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+StdTcpServer::ReactorThread::EmitWakeupSignal()
+{
+    const uint64 value = 1;
+    if (write(this->wakeup, &value, sizeof(value)) < 0)
+    {
+        n_printf("StdTcpServer::ReactorThread: failed to wake up reactor\n");
+    }
+}
+
+#else
 //------------------------------------------------------------------------------
 /**
 */
@@ -254,5 +657,6 @@ StdTcpServer::ListenerThread::EmitWakeupSignal()
         socket->Close();
     }
 }
+#endif
 
 } // namespace Net
@@ -9,6 +9,14 @@
     TcpClientConnection object which can be used by the application
     to communicate with a specific client.
 
+    On Linux, the listener thread is replaced by an edge-triggered epoll
+    reactor thread, which accepts clients and reads from and writes to their
+    non-blocking sockets as soon as they are ready. Connections with received
+    data are put on a ready list, so Recv() only touches the connections which
+    have something to report instead of probing every client's socket.
+    Broadcast() copies the message once and queues the same buffer on every
+    connection, queued buffers are sent with scatter-gather writes.
+
     @copyright
     (C) 2006 Radon Labs GmbH
     (C) 2013-2020 Individual contributors, see AUTHORS file
@@ -19,6 +27,7 @@
 #include "net/tcpclientconnection.h"
 #include "net/socket/socket.h"
 #include "threading/criticalsection.h"
+#include "util/dictionary.h"
 
 //------------------------------------------------------------------------------
 namespace Net
@@ -49,8 +58,58 @@ public:
     Util::Array<Ptr<TcpClientConnection> > Recv();
     /// broadcast a message to all clients
     bool Broadcast(const Ptr<IO::Stream>& msg);
+    /// get number of connected clients
+    SizeT GetNumClientConnections();
 
 private:
+#if __linux__
+    /// the epoll reactor thread, accepts clients and services their sockets
+    class ReactorThread : public Threading::Thread
+    {
+        __DeclareClass(ReactorThread);
+    public:
+        /// constructor
+        ReactorThread();
+        /// destructor
+        virtual ~ReactorThread();
+        /// set pointer to parent tcp server
+        void SetTcpServer(StdTcpServer* tcpServer);
+        /// set ip address
+        void SetAddress(const IpAddress& a);
+        /// set client connection class
+        void SetClientConnectionClass(const Core::Rtti& type);
+        /// create the epoll instance and the listening socket
+        bool Setup();
+        /// start watching a client socket
+        void Watch(const Ptr<Socket>& socket, uint id);
+    private:
+        /// implements the reactor loop
+        virtual void DoWork();
+        /// send a wakeup signal
+        virtual void EmitWakeupSignal();
+        /// accept all waiting clients
+        void AcceptConnections();
+
+        StdTcpServer* tcpServer;
+        IpAddress ipAddress;
+        Ptr<Socket> socket;
+        const Core::Rtti* connectionClassRtti;
+        int epoll;
+        int wakeup;
+    };
+    friend class ReactorThread;
+    /// service a client socket the reactor got an event for
+    void Dispatch(uint id, bool readable, bool writable);
+    /// drop a client connection, must be called within the critical section
+    void DropClientConnection(IndexT index);
+    /// put a connection on the ready list, must be called within the critical section
+    void MarkReady(const Ptr<TcpClientConnection>& connection);
+
+    Ptr<ReactorThread> reactorThread;
+    Util::Dictionary<uint, Ptr<TcpClientConnection>> reactorConnections;
+    Util::Array<Ptr<TcpClientConnection>> readyConnections;
+    uint nextReactorId;
+#else
     /// a private listener thread class
     class ListenerThread : public Threading::Thread
     {
@@ -74,11 +133,12 @@ private:
         const Core::Rtti* connectionClassRtti;
     };
     friend class ListenerThread;
+    Ptr<ListenerThread> listenerThread;
+#endif
     /// add a client connection (called by the listener thread)
     void AddClientConnection(const Ptr<TcpClientConnection>& connection);
 
     IpAddress ipAddress;
-    Ptr<ListenerThread> listenerThread;
     bool isOpen;
     Util::Array<Ptr<TcpClientConnection> > clientConnections;
     Threading::CriticalSection connectionCritSect;
@@ -0,0 +1,85 @@
+//------------------------------------------------------------------------------
+//  tcpsendbuffer.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "foundation/stdneb.h"
+#include "net/tcp/tcpsendbuffer.h"
+
+namespace Net
+{
+__ImplementClass(Net::TcpSendBuffer, 'TSBF', Core::RefCounted);
+
+using namespace IO;
+
+//------------------------------------------------------------------------------
+/**
+*/
+TcpSendBuffer::TcpSendBuffer() :
+    data(nullptr),
+    size(0),
+    capacity(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+TcpSendBuffer::~TcpSendBuffer()
+{
+    if (this->data != nullptr)
+    {
+        Memory::Free(Memory::NetworkHeap, this->data);
+        this->data = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TcpSendBuffer::Setup(const void* ptr, SizeT numBytes)
+{
+    n_assert(this->data == nullptr);
+    n_assert(numBytes > 0);
+    this->data = (uchar*)Memory::Alloc(Memory::NetworkHeap, numBytes);
+    this->size = numBytes;
+    this->capacity = numBytes;
+    Memory::Copy(ptr, this->data, numBytes);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TcpSendBuffer::Setup(const Ptr<Stream>& stream)
+{
+    n_assert(stream.isvalid());
+    stream->SetAccessMode(Stream::ReadAccess);
+    if (stream->Open())
+    {
+        const Stream::Size streamSize = stream->GetSize();
+        n_assert(streamSize < INT_MAX);
+        if (streamSize > 0)
+        {
+            this->Setup(stream->Map(), (SizeT)streamSize);
+            stream->Unmap();
+        }
+        stream->Close();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TcpSendBuffer::Allocate(SizeT capacity)
+{
+    n_assert(this->data == nullptr);
+    n_assert(capacity > 0);
+    this->data = (uchar*)Memory::Alloc(Memory::NetworkHeap, capacity);
+    this->size = 0;
+    this->capacity = capacity;
+}
+
+} // namespace Net
@@ -0,0 +1,116 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Net::TcpSendBuffer
+
+    A reference counted chunk of data queued for sending. The same buffer can
+    be queued on any number of connections, which is how the StdTcpServer
+    broadcasts a message without copying it for each client.
+
+    Buffers can also be allocated empty and filled with Append, the
+    TcpMessageCodec uses them as slabs for its send and receive rings. A
+    buffer must not be modified anymore once it has been queued.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "core/refcounted.h"
+#include "io/stream.h"
+
+//------------------------------------------------------------------------------
+namespace Net
+{
+class TcpSendBuffer : public Core::RefCounted
+{
+    __DeclareClass(TcpSendBuffer);
+public:
+    /// constructor
+    TcpSendBuffer();
+    /// destructor
+    virtual ~TcpSendBuffer();
+
+    /// copy data into the buffer
+    void Setup(const void* ptr, SizeT numBytes);
+    /// copy the content of a stream into the buffer
+    void Setup(const Ptr<IO::Stream>& stream);
+    /// allocate an empty buffer which is filled with Append
+    void Allocate(SizeT capacity);
+    /// grow the size by numBytes and return a pointer to the new bytes
+    uchar* Append(SizeT numBytes);
+    /// set the size back to zero to refill the buffer
+    void Reset();
+
+    /// get pointer to data
+    const uchar* GetData() const;
+    /// get size of data
+    SizeT GetSize() const;
+    /// get the number of bytes allocated
+    SizeT GetCapacity() const;
+    /// get the number of bytes which can still be appended
+    SizeT GetFreeSpace() const;
+
+private:
+    uchar* data;
+    SizeT size;
+    SizeT capacity;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const uchar*
+TcpSendBuffer::GetData() const
+{
+    return this->data;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+TcpSendBuffer::GetSize() const
+{
+    return this->size;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+TcpSendBuffer::GetCapacity() const
+{
+    return this->capacity;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+TcpSendBuffer::GetFreeSpace() const
+{
+    return this->capacity - this->size;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline uchar*
+TcpSendBuffer::Append(SizeT numBytes)
+{
+    n_assert(this->size + numBytes <= this->capacity);
+    uchar* ptr = this->data + this->size;
+    this->size += numBytes;
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+TcpSendBuffer::Reset()
+{
+    this->size = 0;
+}
+
+} // namespace Net
+//------------------------------------------------------------------------------
@@ -16,14 +16,37 @@ using namespace IO;
 namespace Net
 {
 
+//------------------------------------------------------------------------------
+/**
+*/
+static void
+WriteHeader(uchar* ptr, SizeT size)
+{
+    const uint magic = 'TCPM';
+    ptr[0] = (uchar)(magic >> 24);
+    ptr[1] = (uchar)(magic >> 16);
+    ptr[2] = (uchar)(magic >> 8);
+    ptr[3] = (uchar)magic;
+    ptr[4] = (uchar)((uint)size >> 24);
+    ptr[5] = (uchar)((uint)size >> 16);
+    ptr[6] = (uchar)((uint)size >> 8);
+    ptr[7] = (uchar)size;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static uint
+ReadUInt(const uchar* ptr)
+{
+    return ((uint)ptr[0] << 24) | ((uint)ptr[1] << 16) | ((uint)ptr[2] << 8) | (uint)ptr[3];
+}
+
 //------------------------------------------------------------------------------
 /**
 */
 TcpMessageCodec::TcpMessageCodec():
-    receiveState(HeaderData),
-    messageSize(0),
-    headerPosition(0),
-    messagePostition(0)
+    recvOffset(0)
 {
     // empty
 }
@@ -33,23 +56,12 @@ TcpMessageCodec::TcpMessageCodec():
 */
 TcpMessageCodec::~TcpMessageCodec()
 {
-    // closes and discards header and message streams if they exists...
-    if (this->headerStream.isvalid())
-    {
-        if (this->headerStream->IsOpen())
-        {
-            this->headerStream->Close();
-        }
-        this->headerStream = nullptr;
-    }
-    if (this->messageStream.isvalid())
-    {
-        if (this->messageStream->IsOpen())
-        {
-            this->messageStream->Close();
-        }
-        this->messageStream = nullptr;
-    }
+    // views which are still around keep their slabs alive
+    this->messages.Clear();
+    this->recvSlab = nullptr;
+    this->sendSlab = nullptr;
+    this->filledSendSlabs.Clear();
+    this->slabs.Clear();
 }
 
 //------------------------------------------------------------------------------
@@ -94,85 +106,16 @@ void
 TcpMessageCodec::DecodeStream(const Ptr<IO::Stream> &stream)
 {
     stream->SetAccessMode(Stream::ReadAccess);
-    Ptr<BinaryReader> reader = BinaryReader::Create();
-    reader->SetStream(stream);
-    if(reader->Open())
+    if (stream->Open())
     {
-        uchar byte;
-        while(!reader->Eof())
+        const Stream::Size size = stream->GetSize();
+        n_assert(size < INT_MAX);
+        if (size > 0)
         {
-            // read byte
-            byte = reader->ReadUChar();
-            
-            if(HeaderData == this->receiveState)
-            {
-                // read header until enough bytes arrived
-                if(this->headerPosition == 0)
-                {
-                    this->headerStream = MemoryStream::Create();
-                    this->headerStream->SetAccessMode(Stream::WriteAccess);
-                    this->headerStream->Open();
-                }
-                
-                if (headerStream->IsOpen())
-                {
-                    // write byte to headerstream
-                    this->headerStream->Write(&byte,sizeof(byte));
-                    headerPosition++;
-                    
-                    if (this->headerPosition == 8)
-                    {
-                        this->headerStream->Close();
-                        n_assert(this->headerStream->GetSize() == 8);
-                        // handle complete received header
-                        this->headerStream->SetAccessMode(Stream::ReadAccess);
-                        Ptr<BinaryReader> reader = BinaryReader::Create();
-                        reader->SetStream(this->headerStream);
-                        reader->SetStreamByteOrder(System::ByteOrder::Network);
-                        n_assert(reader->Open());
-                        // read header name 'TCPM'
-                        uint tcpm = reader->ReadUInt();
-                        if(tcpm == 'TCPM')
-                        {
-                            this->messageSize = reader->ReadInt();
-                            this->messagePostition = 0;
-                            this->receiveState = MessageData;
-                        }
-                        reader->Close();
-                        this->headerPosition = 0;
-                    }
-                }
-            }
-            else if(MessageData == this->receiveState)
-            {   
-                // read message until all bytes arrived
-                if (this->messagePostition == 0)
-                {
-                    this->messageStream = MemoryStream::Create();
-                    this->messageStream->SetAccessMode(Stream::WriteAccess);
-                    this->messageStream->Open();
-                }
-                
-                if (this->messageStream->IsOpen())
-                {
-                    // write byte to messagestream
-                    this->messageStream->Write(&byte,sizeof(byte));
-                    messagePostition++;
-                    
-                    if(messagePostition == messageSize)
-                    {
-                        this->messageStream->Close();
-                        n_assert(this->messageStream->GetSize() == messageSize);
-                        // attach completely received mesage
-                        this->messageStream->SetAccessMode(Stream::ReadAccess);
-                        this->completedMessages.Append(this->messageStream);
-                        this->messageStream = nullptr;
-                        this->messagePostition = 0;
-                        this->receiveState = HeaderData;
-                    }
-                }
-            }
+            this->Decode(stream->Map(), (SizeT)size);
+            stream->Unmap();
         }
+        stream->Close();
     }
 }
 
@@ -183,20 +126,265 @@ TcpMessageCodec::DecodeStream(const Ptr<IO::Stream> &stream)
 bool
 TcpMessageCodec::HasMessages()
 {
-    return this->completedMessages.Size() > 0;
+    return !this->messages.IsEmpty();
 }
 
 //------------------------------------------------------------------------------
 /**
     Returns all created messages since the last call and clears message
-    queue.
+    queue. This copies every message into a stream of its own, use
+    DequeueMessage to avoid that.
 */
 Util::Array<Ptr<IO::Stream> >
 TcpMessageCodec::DequeueMessages()
 {
     Array<Ptr<Stream> > output;
-    output.AppendArray(this->completedMessages);
-    this->completedMessages.Clear();
+    TcpMessageView view;
+    while (this->DequeueMessage(view))
+    {
+        Ptr<MemoryStream> stream = MemoryStream::Create();
+        stream->SetAccessMode(Stream::WriteAccess);
+        if (stream->Open())
+        {
+            stream->Write(view.GetData(), view.GetSize());
+            stream->Close();
+        }
+        stream->SetAccessMode(Stream::ReadAccess);
+        output.Append(stream.upcast<Stream>());
+        view.Release();
+    }
     return output;
 }
+
+//------------------------------------------------------------------------------
+/**
+    The receive slab is reused in place if every message in it has been
+    parsed and released.
+*/
+uchar*
+TcpMessageCodec::GetRecvBuffer(SizeT& numBytes)
+{
+    if (!this->recvSlab.isvalid())
+    {
+        this->recvSlab = this->AllocSlab(SlabSize);
+        this->recvOffset = 0;
+    }
+    else if (this->recvOffset == this->recvSlab->GetSize() && this->recvSlab->GetRefCount() == 2)
+    {
+        // only referenced by the ring and the receive slot, a slab of a large message is given up
+        if (this->recvSlab->GetCapacity() > SlabSize)
+        {
+            this->recvSlab = nullptr;
+            this->recvSlab = this->AllocSlab(SlabSize);
+        }
+        else
+        {
+            this->recvSlab->Reset();
+        }
+        this->recvOffset = 0;
+    }
+    else if (this->recvSlab->GetFreeSpace() == 0)
+    {
+        this->RotateRecvSlab(SlabSize);
+    }
+    numBytes = this->recvSlab->GetFreeSpace();
+    return (uchar*)this->recvSlab->GetData() + this->recvSlab->GetSize();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TcpMessageCodec::CommitRecv(SizeT numBytes)
+{
+    n_assert(this->recvSlab.isvalid());
+    this->recvSlab->Append(numBytes);
+    this->Parse();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TcpMessageCodec::Decode(const void* data, SizeT size)
+{
+    const uchar* src = (const uchar*)data;
+    while (size > 0)
+    {
+        SizeT numFree = 0;
+        uchar* dst = this->GetRecvBuffer(numFree);
+        const SizeT numBytes = Math::min(numFree, size);
+        Memory::Copy(src, dst, numBytes);
+        this->CommitRecv(numBytes);
+        src += numBytes;
+        size -= numBytes;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+TcpMessageCodec::DequeueMessage(TcpMessageView& outView)
+{
+    if (this->messages.IsEmpty())
+    {
+        return false;
+    }
+    outView = this->messages.Dequeue();
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Splits all complete messages off the receive slab. A message which is
+    incomplete and won't fit into the rest of the slab is moved into a new
+    slab which is large enough for it.
+*/
+void
+TcpMessageCodec::Parse()
+{
+    const uchar* base = this->recvSlab->GetData();
+    while (true)
+    {
+        const SizeT numAvailable = this->recvSlab->GetSize() - this->recvOffset;
+        if (numAvailable < (SizeT)HeaderSize)
+        {
+            if (this->recvSlab->GetCapacity() - this->recvOffset < (SizeT)HeaderSize)
+            {
+                this->RotateRecvSlab(SlabSize);
+            }
+            break;
+        }
+
+        const uchar* header = base + this->recvOffset;
+        if (ReadUInt(header) != 'TCPM' || ReadUInt(header + 4) > (uint)INT_MAX - HeaderSize)
+        {
+            // not a frame, skip the header like the stream based decoder did
+            n_warning("TcpMessageCodec: invalid frame header, skipping %d bytes\n", HeaderSize);
+            this->recvOffset += HeaderSize;
+            continue;
+        }
+
+        const SizeT messageSize = (SizeT)ReadUInt(header + 4);
+        const SizeT frameSize = HeaderSize + messageSize;
+        if (numAvailable < frameSize)
+        {
+            if (this->recvSlab->GetCapacity() - this->recvOffset < frameSize)
+            {
+                this->RotateRecvSlab(Math::max(frameSize, (SizeT)SlabSize));
+            }
+            break;
+        }
+
+        this->messages.Enqueue(TcpMessageView(this->recvSlab, header + HeaderSize, messageSize));
+        this->recvOffset += frameSize;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TcpMessageCodec::RotateRecvSlab(SizeT minCapacity)
+{
+    Ptr<TcpSendBuffer> slab = this->AllocSlab(minCapacity);
+    const SizeT numUnparsed = this->recvSlab->GetSize() - this->recvOffset;
+    if (numUnparsed > 0)
+    {
+        Memory::Copy(this->recvSlab->GetData() + this->recvOffset, slab->Append(numUnparsed), numUnparsed);
+    }
+    this->recvSlab = slab;
+    this->recvOffset = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+uchar*
+TcpMessageCodec::BeginMessage(SizeT size)
+{
+    const SizeT frameSize = HeaderSize + size;
+    if (!this->sendSlab.isvalid() || this->sendSlab->GetFreeSpace() < frameSize)
+    {
+        if (this->sendSlab.isvalid() && this->sendSlab->GetSize() > 0)
+        {
+            this->filledSendSlabs.Append(this->sendSlab);
+        }
+        this->sendSlab = this->AllocSlab(Math::max(frameSize, (SizeT)SlabSize));
+    }
+    uchar* ptr = this->sendSlab->Append(frameSize);
+    WriteHeader(ptr, size);
+    return ptr + HeaderSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TcpMessageCodec::Encode(const void* data, SizeT size)
+{
+    Memory::Copy(data, this->BeginMessage(size), size);
+}
+
+//------------------------------------------------------------------------------
+/**
+    The slabs must not be modified anymore, the codec continues with a new
+    slab and recycles the taken ones once they have been released.
+*/
+bool
+TcpMessageCodec::TakeSendBuffers(Util::Array<Ptr<TcpSendBuffer>>& outBuffers)
+{
+    if (this->sendSlab.isvalid() && this->sendSlab->GetSize() > 0)
+    {
+        this->filledSendSlabs.Append(this->sendSlab);
+    }
+    this->sendSlab = nullptr;
+    if (this->filledSendSlabs.IsEmpty())
+    {
+        return false;
+    }
+    outBuffers.AppendArray(this->filledSendSlabs);
+    this->filledSendSlabs.Clear();
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+    A slab can be reused once the codec holds the only reference to it,
+    views and send queues release theirs when they are done with it. Slabs
+    allocated for messages larger than SlabSize are freed once released
+    instead of joining the ring, unless they are reused for another large
+    message right away, so a single large message doesn't keep its memory.
+*/
+Ptr<TcpSendBuffer>
+TcpMessageCodec::AllocSlab(SizeT minCapacity)
+{
+    const bool large = minCapacity > SlabSize;
+    IndexT i;
+    for (i = 0; i < this->slabs.Size(); i++)
+    {
+        const SizeT capacity = this->slabs[i]->GetCapacity();
+        if (capacity > SlabSize && this->slabs[i]->GetRefCount() == 1 && !(large && capacity >= minCapacity))
+        {
+            this->slabs.EraseIndex(i);
+            i--;
+        }
+    }
+    for (i = 0; i < this->slabs.Size(); i++)
+    {
+        const Ptr<TcpSendBuffer>& slab = this->slabs[i];
+        const SizeT capacity = slab->GetCapacity();
+        if (slab->GetRefCount() == 1 && capacity >= minCapacity && (large || capacity == SlabSize))
+        {
+            slab->Reset();
+            return slab;
+        }
+    }
+    Ptr<TcpSendBuffer> slab = TcpSendBuffer::Create();
+    slab->Allocate(minCapacity);
+    this->slabs.Append(slab);
+    return slab;
+}
+
 } // namespace Net
@@ -4,16 +4,27 @@
     @class Net::TcpMessageCodec
 
     Helperclass that provides function to encode and decode sreams into messages.
-    
-    The encoder adds header informations at the beginning of the stream,
-    that includes the complete size of the stream. Call EncodeToMessage at the
-    sending site.
 
-    The decoder reads sequential incoming streams and append the data
-    to an internal buffer. It concatenates the incoming streams to
-    a list of streams containing complete messages.
-    Call DecodeStream at the receiving site and check for completed messsages
-    with GetMessages.
+    Every message is framed by an 8 byte header, 'TCPM' followed by the size
+    of the message, both in network byte order.
+
+    Received data is appended to a ring of reference counted slabs, and
+    complete messages are handed out as TcpMessageViews which point right
+    into the slab. A view keeps its slab alive, slabs go back into the ring
+    once all views into them have been released. Only a message that is cut
+    off at the end of a slab is copied, to the start of the next slab. A
+    message larger than a slab gets a slab of its own, which is freed once
+    released instead of going back into the ring. Data can be read from the
+    socket straight into the ring with GetRecvBuffer and CommitRecv, or
+    copied in with Decode.
+
+    Messages are encoded into a send ring of slabs in the same way, either
+    with Encode or by writing the payload to the memory returned by
+    BeginMessage. TakeSendBuffers hands the filled slabs out for sending.
+
+    Once the rings have warmed up, neither decoding nor encoding allocates
+    memory per message. EncodeToMessage, DecodeStream and DequeueMessages
+    still work on streams, at the cost of a stream per message.
 
     @copyright
     (C) 2009 Radon Labs
@@ -21,20 +32,50 @@
 */
 #include "io/memorystream.h"
 #include "io/binaryreader.h"
+#include "net/tcp/tcpsendbuffer.h"
+#include "util/queue.h"
 
 //------------------------------------------------------------------------------
 namespace Net
 {
+class TcpMessageView
+{
+public:
+    /// constructor
+    TcpMessageView();
+    /// constructor
+    TcpMessageView(const Ptr<TcpSendBuffer>& slab, const uchar* data, SizeT size);
+
+    /// release the reference to the slab
+    void Release();
+    /// return true if the view points to a message
+    bool IsValid() const;
+    /// get pointer to the message
+    const uchar* GetData() const;
+    /// get size of the message
+    SizeT GetSize() const;
+
+private:
+    Ptr<TcpSendBuffer> slab;
+    const uchar* data;
+    SizeT size;
+};
+
 class TcpMessageCodec
 {
 public:
+    /// size of the frame header
+    static const SizeT HeaderSize = 8;
+    /// default size of the ring slabs, larger messages get a slab of their own which isn't kept
+    static const SizeT SlabSize = 64 * 1024;
+
     /// Constructor
     TcpMessageCodec();
     /// Destructor
     virtual ~TcpMessageCodec();
 
     /// Attachs header information to the stream and returns a copy with header
-    void EncodeToMessage(const Ptr<IO::Stream> & stream, const Ptr<IO::Stream> &output);  
+    void EncodeToMessage(const Ptr<IO::Stream> & stream, const Ptr<IO::Stream> &output);
     /// Decodes a given Stream. Check for HasMessages() if this completes a message.
     void DecodeStream(const Ptr<IO::Stream> & stream);
     /// Returns true, if there are messages in the internal message queue.
@@ -42,21 +83,120 @@ public:
     /// Gets the list of all created messages since the last call of this function
     Util::Array<Ptr<IO::Stream> > DequeueMessages();
 
-private: 
-    /// what data is currently expected from the decoder
-    enum ReceiveState
-    {
-        HeaderData,
-        MessageData
-    };
-    
-    ReceiveState receiveState;
-    Ptr<IO::Stream> headerStream;
-    Ptr<IO::Stream> messageStream;
-    SizeT messageSize;
-    IndexT headerPosition;
-    IndexT messagePostition;
-    Util::Array<Ptr<IO::Stream> > completedMessages;
+    /// get free space at the end of the receive ring to read data into, never returns less than 1 byte
+    uchar* GetRecvBuffer(SizeT& numBytes);
+    /// commit numBytes written to the receive buffer and split off complete messages
+    void CommitRecv(SizeT numBytes);
+    /// copy received data into the receive ring and split off complete messages
+    void Decode(const void* data, SizeT size);
+    /// get the number of decoded messages
+    SizeT GetNumMessages() const;
+    /// dequeue the oldest decoded message, returns false if there is none
+    bool DequeueMessage(TcpMessageView& outView);
+
+    /// start a message of size bytes in the send ring, returns the memory to write the message to
+    uchar* BeginMessage(SizeT size);
+    /// copy a message into the send ring
+    void Encode(const void* data, SizeT size);
+    /// append all filled send slabs to outBuffers, returns false if nothing was encoded
+    bool TakeSendBuffers(Util::Array<Ptr<TcpSendBuffer>>& outBuffers);
+
+    /// get the number of slabs allocated by both rings
+    SizeT GetNumSlabs() const;
+
+private:
+    /// get a slab that isn't referenced anymore, or allocate a new one
+    Ptr<TcpSendBuffer> AllocSlab(SizeT minCapacity);
+    /// move the unparsed end of the receive slab into a fresh slab
+    void RotateRecvSlab(SizeT minCapacity);
+    /// split complete messages off the receive slab
+    void Parse();
+
+    Util::Array<Ptr<TcpSendBuffer>> slabs;
+    Ptr<TcpSendBuffer> recvSlab;
+    SizeT recvOffset;
+    Util::Queue<TcpMessageView> messages;
+    Ptr<TcpSendBuffer> sendSlab;
+    Util::Array<Ptr<TcpSendBuffer>> filledSendSlabs;
 };
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+TcpMessageView::TcpMessageView() :
+    data(nullptr),
+    size(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+TcpMessageView::TcpMessageView(const Ptr<TcpSendBuffer>& slab, const uchar* data, SizeT size) :
+    slab(slab),
+    data(data),
+    size(size)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+TcpMessageView::Release()
+{
+    this->slab = nullptr;
+    this->data = nullptr;
+    this->size = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+TcpMessageView::IsValid() const
+{
+    return this->slab.isvalid();
+}
+
 //------------------------------------------------------------------------------
-} // namespace Net
\ No newline at end of file
+/**
+*/
+inline const uchar*
+TcpMessageView::GetData() const
+{
+    return this->data;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+TcpMessageView::GetSize() const
+{
+    return this->size;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+TcpMessageCodec::GetNumMessages() const
+{
+    return this->messages.Size();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+TcpMessageCodec::GetNumSlabs() const
+{
+    return this->slabs.Size();
+}
+
+} // namespace Net
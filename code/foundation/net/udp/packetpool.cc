@@ -0,0 +1,74 @@
+//------------------------------------------------------------------------------
+//  packetpool.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "foundation/stdneb.h"
+#include "net/udp/packetpool.h"
+
+namespace Net
+{
+__ImplementClass(Net::PacketPool, 'PKPL', Core::RefCounted);
+
+//------------------------------------------------------------------------------
+/**
+*/
+PacketPool::PacketPool() :
+    buffer(nullptr),
+    packetSize(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+PacketPool::~PacketPool()
+{
+    if (this->IsValid())
+    {
+        this->Discard();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PacketPool::Setup(SizeT numPackets, SizeT size)
+{
+    n_assert(!this->IsValid());
+    n_assert(numPackets > 0 && size > 0);
+    this->packetSize = size;
+    this->buffer = (uchar*)Memory::Alloc(Memory::NetworkHeap, numPackets * size);
+    this->packets.Resize(numPackets);
+    this->freePackets.Reserve(numPackets);
+
+    // hand out the packets at the start of the buffer first
+    IndexT i;
+    for (i = numPackets - 1; i >= 0; i--)
+    {
+        Socket::Datagram& packet = this->packets[i];
+        packet.buf = this->buffer + i * size;
+        packet.bufSize = size;
+        packet.numBytes = 0;
+        packet.addr = 0;
+        packet.port = 0;
+        this->freePackets.Append(&packet);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PacketPool::Discard()
+{
+    n_assert(this->IsValid());
+    n_assert(this->freePackets.Size() == this->packets.Size());
+    Memory::Free(Memory::NetworkHeap, this->buffer);
+    this->buffer = nullptr;
+    this->packets.Clear();
+    this->freePackets.Clear();
+}
+
+} // namespace Net
@@ -0,0 +1,122 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Net::PacketPool
+
+    A preallocated pool of fixed size datagram buffers. All packets live in
+    a single allocation, so sending or receiving a batch of datagrams never
+    touches the heap. The pool is not thread safe.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "core/refcounted.h"
+#include "net/socket/socket.h"
+#include "util/fixedarray.h"
+#include "util/array.h"
+
+//------------------------------------------------------------------------------
+namespace Net
+{
+class PacketPool : public Core::RefCounted
+{
+    __DeclareClass(PacketPool);
+public:
+    /// largest datagram which fits into an ethernet frame without fragmentation
+    static const SizeT DefaultPacketSize = 1472;
+
+    /// constructor
+    PacketPool();
+    /// destructor
+    virtual ~PacketPool();
+
+    /// allocate numPackets packets of packetSize bytes each
+    void Setup(SizeT numPackets, SizeT packetSize = DefaultPacketSize);
+    /// free the pool, all packets must have been returned
+    void Discard();
+    /// return true if the pool has been set up
+    bool IsValid() const;
+
+    /// take a packet from the pool, returns nullptr if the pool is exhausted
+    Socket::Datagram* Alloc();
+    /// return a packet to the pool
+    void Free(Socket::Datagram* packet);
+
+    /// get the size of a packet buffer
+    SizeT GetPacketSize() const;
+    /// get the number of packets in the pool
+    SizeT GetNumPackets() const;
+    /// get the number of packets which can be allocated
+    SizeT GetNumFree() const;
+
+private:
+    uchar* buffer;
+    SizeT packetSize;
+    Util::FixedArray<Socket::Datagram> packets;
+    Util::Array<Socket::Datagram*> freePackets;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+PacketPool::IsValid() const
+{
+    return this->buffer != nullptr;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline Socket::Datagram*
+PacketPool::Alloc()
+{
+    if (this->freePackets.IsEmpty())
+    {
+        return nullptr;
+    }
+    Socket::Datagram* packet = this->freePackets.Back();
+    this->freePackets.EraseBack();
+    packet->numBytes = 0;
+    return packet;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+PacketPool::Free(Socket::Datagram* packet)
+{
+    n_assert(packet >= this->packets.Begin() && packet < this->packets.End());
+    this->freePackets.Append(packet);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+PacketPool::GetPacketSize() const
+{
+    return this->packetSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+PacketPool::GetNumPackets() const
+{
+    return this->packets.Size();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+PacketPool::GetNumFree() const
+{
+    return this->freePackets.Size();
+}
+
+} // namespace Net
+//------------------------------------------------------------------------------
@@ -0,0 +1,364 @@
+//------------------------------------------------------------------------------
+//  reliablechannel.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "foundation/stdneb.h"
+#include "net/udp/reliablechannel.h"
+#include "util/bit.h"
+
+namespace Net
+{
+__ImplementClass(Net::ReliableChannel, 'RLCH', Core::RefCounted);
+
+//------------------------------------------------------------------------------
+/**
+*/
+ReliableChannel::ReliableChannel() :
+    remoteAddr(0),
+    remotePort(0),
+    time(0),
+    resendTimeout(0.1),
+    roundTripTime(0),
+    numResent(0),
+    localSequence(0),
+    oldestUnacked(0),
+    remoteSequence(0),
+    hasReceived(false),
+    ackPending(false),
+    nextDelivery(0)
+{
+    Memory::Clear(this->receivedBits, sizeof(this->receivedBits));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+ReliableChannel::~ReliableChannel()
+{
+    if (this->IsValid())
+    {
+        this->Discard();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReliableChannel::Setup(const Ptr<Socket>& sock, uint addr, ushort port)
+{
+    n_assert(!this->IsValid());
+    n_assert(sock.isvalid() && sock->IsOpen());
+    this->socket = sock;
+    this->remoteAddr = addr;
+    this->remotePort = port;
+
+    // one packet per message in flight, all sends are served from the pool
+    this->pool = PacketPool::Create();
+    this->pool->Setup(WindowSize, HeaderSize + MaxMessageSize);
+    this->sent.Resize(WindowSize);
+    this->received.Resize(WindowSize);
+    IndexT i;
+    for (i = 0; i < WindowSize; i++)
+    {
+        this->sent[i].packet = nullptr;
+        this->sent[i].acked = true;
+        this->received[i].valid = false;
+    }
+    this->outgoing.Reserve(WindowSize);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReliableChannel::Discard()
+{
+    n_assert(this->IsValid());
+    IndexT i;
+    for (i = 0; i < this->sent.Size(); i++)
+    {
+        if (this->sent[i].packet != nullptr)
+        {
+            this->pool->Free(this->sent[i].packet);
+            this->sent[i].packet = nullptr;
+        }
+    }
+    this->pool->Discard();
+    this->pool = nullptr;
+    this->sent.Clear();
+    this->received.Clear();
+    this->outgoing.Clear();
+    this->socket = nullptr;
+}
+
+//------------------------------------------------------------------------------
+/**
+    The message is copied into a datagram right away, it goes out with the
+    next Update().
+*/
+bool
+ReliableChannel::Send(const void* data, SizeT size)
+{
+    n_assert(this->IsValid());
+    n_assert(size > 0 && size <= MaxMessageSize);
+    if (this->GetNumUnacked() >= WindowSize)
+    {
+        return false;
+    }
+
+    Socket::Datagram* packet = this->pool->Alloc();
+    n_assert(packet != nullptr);
+    Memory::Copy(data, (uchar*)packet->buf + HeaderSize, size);
+    packet->numBytes = HeaderSize + size;
+    packet->addr = this->remoteAddr;
+    packet->port = this->remotePort;
+
+    _Sent& entry = this->sent[this->localSequence % WindowSize];
+    n_assert(entry.packet == nullptr);
+    entry.packet = packet;
+    entry.sendTime = 0;
+    entry.sent = false;
+    entry.resent = false;
+    entry.acked = false;
+    this->localSequence++;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReliableChannel::ProcessPacket(const void* data, SizeT size)
+{
+    n_assert(this->IsValid());
+    if (size < HeaderSize)
+    {
+        return;
+    }
+    const uchar* buf = (const uchar*)data;
+    const ushort sequence = buf[0] | (buf[1] << 8);
+    const ushort ack = buf[2] | (buf[3] << 8);
+    const ushort flags = buf[4] | (buf[5] << 8);
+
+    if (flags & HasAck)
+    {
+        this->Acknowledge(ack);
+        IndexT word;
+        for (word = 0; word < NumAckWords; word++)
+        {
+            const uchar* bytes = buf + 6 + word * 4;
+            uint bits = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint)bytes[3] << 24);
+            while (bits != 0)
+            {
+                // find the sequence in the window before ack which maps to this bit
+                const ushort index = (ushort)(word * 32 + Util::FirstOne(bits));
+                const ushort distance = (ushort)(ack - index) % WindowSize;
+                if (distance != 0)
+                {
+                    this->Acknowledge((ushort)(ack - distance));
+                }
+                bits &= bits - 1;
+            }
+        }
+
+        // slide the send window
+        while (this->oldestUnacked != this->localSequence && this->sent[this->oldestUnacked % WindowSize].acked)
+        {
+            this->oldestUnacked++;
+        }
+    }
+
+    if ((flags & HasMessage) && size > HeaderSize)
+    {
+        const ushort distance = sequence - this->nextDelivery;
+        if (distance >= 32768)
+        {
+            // already delivered, the ack must have been lost
+            this->RecordReceived(sequence);
+        }
+        else if (distance < WindowSize)
+        {
+            _Received& slot = this->received[sequence % WindowSize];
+            if (!slot.valid)
+            {
+                slot.message.Set(buf + HeaderSize, size - HeaderSize);
+                slot.valid = true;
+            }
+            this->RecordReceived(sequence);
+        }
+        // messages too far ahead are dropped without an ack, so they will be resent
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+ReliableChannel::Recv(Util::Blob& outMessage)
+{
+    n_assert(this->IsValid());
+    _Received& slot = this->received[this->nextDelivery % WindowSize];
+    if (!slot.valid)
+    {
+        return false;
+    }
+    outMessage = std::move(slot.message);
+    slot.valid = false;
+    this->nextDelivery++;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+    All datagrams go out with a single batched send. If nothing needs to be
+    sent but messages have been received, an ack-only datagram is sent.
+*/
+void
+ReliableChannel::Update(Timing::Time t)
+{
+    n_assert(this->IsValid());
+    this->time = t;
+    const Timing::Time timeout = Math::max(this->resendTimeout, this->roundTripTime * 2.0);
+
+    this->outgoing.Clear();
+    ushort sequence;
+    for (sequence = this->oldestUnacked; sequence != this->localSequence; sequence++)
+    {
+        _Sent& entry = this->sent[sequence % WindowSize];
+        if (entry.acked || (entry.sent && (t - entry.sendTime) < timeout))
+        {
+            continue;
+        }
+        if (entry.sent)
+        {
+            entry.resent = true;
+            this->numResent++;
+        }
+        entry.sent = true;
+        entry.sendTime = t;
+        this->WriteHeader((uchar*)entry.packet->buf, sequence, HasMessage);
+        this->outgoing.Append(*entry.packet);
+    }
+
+    if (this->ackPending && this->outgoing.IsEmpty())
+    {
+        this->WriteHeader(this->ackPacket, 0, 0);
+        Socket::Datagram datagram;
+        datagram.buf = this->ackPacket;
+        datagram.bufSize = HeaderSize;
+        datagram.numBytes = HeaderSize;
+        datagram.addr = this->remoteAddr;
+        datagram.port = this->remotePort;
+        this->outgoing.Append(datagram);
+    }
+
+    if (!this->outgoing.IsEmpty())
+    {
+        // datagrams which don't fit into the socket buffer are treated as lost
+        SizeT numSent;
+        this->socket->SendBatch(this->outgoing.Begin(), this->outgoing.Size(), numSent);
+        this->ackPending = false;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReliableChannel::WriteHeader(uchar* buf, ushort sequence, ushort flags) const
+{
+    if (this->hasReceived)
+    {
+        flags |= HasAck;
+    }
+    buf[0] = (uchar)sequence;
+    buf[1] = (uchar)(sequence >> 8);
+    buf[2] = (uchar)this->remoteSequence;
+    buf[3] = (uchar)(this->remoteSequence >> 8);
+    buf[4] = (uchar)flags;
+    buf[5] = (uchar)(flags >> 8);
+    IndexT word;
+    for (word = 0; word < NumAckWords; word++)
+    {
+        const uint bits = this->receivedBits[word];
+        uchar* bytes = buf + 6 + word * 4;
+        bytes[0] = (uchar)bits;
+        bytes[1] = (uchar)(bits >> 8);
+        bytes[2] = (uchar)(bits >> 16);
+        bytes[3] = (uchar)(bits >> 24);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReliableChannel::Acknowledge(ushort sequence)
+{
+    const ushort distance = sequence - this->oldestUnacked;
+    if (distance >= this->GetNumUnacked())
+    {
+        return;
+    }
+    _Sent& entry = this->sent[sequence % WindowSize];
+    if (entry.acked || !entry.sent)
+    {
+        return;
+    }
+
+    // resent messages are ambiguous, don't use them for the round trip time
+    if (!entry.resent)
+    {
+        const Timing::Time sample = this->time - entry.sendTime;
+        if (this->roundTripTime == 0)
+            this->roundTripTime = sample;
+        else
+            this->roundTripTime += (sample - this->roundTripTime) * 0.125;
+    }
+    entry.acked = true;
+    this->pool->Free(entry.packet);
+    entry.packet = nullptr;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReliableChannel::RecordReceived(ushort sequence)
+{
+    this->ackPending = true;
+    if (!this->hasReceived)
+    {
+        this->hasReceived = true;
+        this->remoteSequence = sequence;
+    }
+    else if (SequenceGreater(sequence, this->remoteSequence))
+    {
+        // forget the sequences which drop out of the window, the skipped ones haven't been received
+        const ushort shift = sequence - this->remoteSequence;
+        if (shift >= WindowSize)
+        {
+            Memory::Clear(this->receivedBits, sizeof(this->receivedBits));
+        }
+        else
+        {
+            ushort skipped;
+            for (skipped = this->remoteSequence + 1; skipped != sequence; skipped++)
+            {
+                const ushort index = skipped % WindowSize;
+                this->receivedBits[index / 32] &= ~(1u << (index % 32));
+            }
+        }
+        this->remoteSequence = sequence;
+    }
+    else if ((ushort)(this->remoteSequence - sequence) >= WindowSize)
+    {
+        // too old to be acknowledged, the sender has given up on it anyway
+        return;
+    }
+    const ushort index = sequence % WindowSize;
+    this->receivedBits[index / 32] |= 1u << (index % 32);
+}
+
+} // namespace Net
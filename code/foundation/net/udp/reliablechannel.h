@@ -0,0 +1,222 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Net::ReliableChannel
+
+    Reliable, ordered message delivery to a single remote endpoint on top of
+    an UDP socket. Every message is sent in its own datagram with a sequence
+    number. Each datagram also acknowledges the latest sequence number received
+    from the remote end, plus a bitfield covering the whole window before it,
+    so a lost ack is covered by any later datagram, and every message in flight
+    can be acknowledged. Bit i of the field stands for the sequence number in
+    the window which is congruent to i modulo WindowSize. Messages which aren't
+    acknowledged within the resend timeout are sent again.
+
+    The channel doesn't read from the socket, since a socket usually serves
+    many channels. Received datagrams from the remote end have to be passed to
+    ProcessPacket(), queued messages and acks go out with the next Update().
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "core/refcounted.h"
+#include "net/socket/socket.h"
+#include "net/udp/packetpool.h"
+#include "timing/time.h"
+#include "util/blob.h"
+#include "util/fixedarray.h"
+
+//------------------------------------------------------------------------------
+namespace Net
+{
+class ReliableChannel : public Core::RefCounted
+{
+    __DeclareClass(ReliableChannel);
+public:
+    /// maximum number of unacknowledged messages, must divide 65536
+    static const SizeT WindowSize = 256;
+    /// size of the header in front of every datagram
+    static const SizeT HeaderSize = 6 + WindowSize / 8;
+    /// largest message which can be sent
+    static const SizeT MaxMessageSize = PacketPool::DefaultPacketSize - HeaderSize;
+
+    /// constructor
+    ReliableChannel();
+    /// destructor
+    virtual ~ReliableChannel();
+
+    /// setup the channel, addr and port are in host byte order
+    void Setup(const Ptr<Socket>& socket, uint addr, ushort port);
+    /// discard the channel
+    void Discard();
+    /// return true if the channel has been set up
+    bool IsValid() const;
+
+    /// set the minimum time before an unacknowledged message is resent
+    void SetResendTimeout(Timing::Time t);
+    /// get the resend timeout
+    Timing::Time GetResendTimeout() const;
+
+    /// queue a message, returns false if too many messages are unacknowledged
+    bool Send(const void* data, SizeT size);
+    /// process a datagram received from the remote end
+    void ProcessPacket(const void* data, SizeT size);
+    /// get the next message in order, returns false if there is none
+    bool Recv(Util::Blob& outMessage);
+    /// send queued messages, resend lost ones and acknowledge received ones
+    void Update(Timing::Time time);
+
+    /// get the remote address in host byte order
+    uint GetRemoteAddr() const;
+    /// get the remote port
+    ushort GetRemotePort() const;
+    /// get the smoothed round trip time
+    Timing::Time GetRoundTripTime() const;
+    /// get the number of messages which haven't been acknowledged yet
+    SizeT GetNumUnacked() const;
+    /// get the number of resent datagrams
+    SizeT GetNumResent() const;
+
+private:
+    enum Flags
+    {
+        HasMessage = 1 << 0,
+        HasAck = 1 << 1,        // the ack fields of the header are valid
+    };
+
+    /// number of 32-bit words in the ack bitfield
+    static const SizeT NumAckWords = WindowSize / 32;
+
+    struct _Sent
+    {
+        Socket::Datagram* packet;
+        Timing::Time sendTime;
+        bool sent;
+        bool resent;
+        bool acked;
+    };
+
+    struct _Received
+    {
+        Util::Blob message;
+        bool valid;
+    };
+
+    /// write the header with the current ack state into a datagram
+    void WriteHeader(uchar* buf, ushort sequence, ushort flags) const;
+    /// mark a sent message as acknowledged
+    void Acknowledge(ushort sequence);
+    /// record that a message has been received
+    void RecordReceived(ushort sequence);
+    /// return true if sequence a is more recent than b
+    static bool SequenceGreater(ushort a, ushort b);
+
+    Ptr<Socket> socket;
+    Ptr<PacketPool> pool;
+    uint remoteAddr;
+    ushort remotePort;
+    Timing::Time time;
+    Timing::Time resendTimeout;
+    Timing::Time roundTripTime;
+    SizeT numResent;
+
+    // sending side
+    ushort localSequence;
+    ushort oldestUnacked;
+    Util::FixedArray<_Sent> sent;
+    Util::Array<Socket::Datagram> outgoing;
+
+    // receiving side
+    ushort remoteSequence;
+    uint receivedBits[NumAckWords];
+    bool hasReceived;
+    bool ackPending;
+    ushort nextDelivery;
+    Util::FixedArray<_Received> received;
+    uchar ackPacket[HeaderSize];
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+ReliableChannel::IsValid() const
+{
+    return this->socket.isvalid();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+ReliableChannel::SetResendTimeout(Timing::Time t)
+{
+    this->resendTimeout = t;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline Timing::Time
+ReliableChannel::GetResendTimeout() const
+{
+    return this->resendTimeout;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline uint
+ReliableChannel::GetRemoteAddr() const
+{
+    return this->remoteAddr;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline ushort
+ReliableChannel::GetRemotePort() const
+{
+    return this->remotePort;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline Timing::Time
+ReliableChannel::GetRoundTripTime() const
+{
+    return this->roundTripTime;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+ReliableChannel::GetNumUnacked() const
+{
+    return (ushort)(this->localSequence - this->oldestUnacked);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+ReliableChannel::GetNumResent() const
+{
+    return this->numResent;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Compare sequence numbers, taking wrap around into account.
+*/
+inline bool
+ReliableChannel::SequenceGreater(ushort a, ushort b)
+{
+    return ((a > b) && (a - b <= 32768)) || ((a < b) && (b - a > 32768));
+}
+
+} // namespace Net
+//------------------------------------------------------------------------------
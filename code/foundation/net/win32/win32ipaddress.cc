@@ -181,6 +181,16 @@ Win32IpAddress::GetHostAddr() const
     return this->addrAsString;
 }
 
+//------------------------------------------------------------------------------
+/**
+    Return the ipv4 address in host byte order.
+*/
+uint
+Win32IpAddress::GetAddr() const
+{
+    return ntohl(this->addr.sin_addr.S_un.S_addr);
+}
+
 //------------------------------------------------------------------------------
 /**
     This resolves a host name into a IPv4 ip address. The ip address is
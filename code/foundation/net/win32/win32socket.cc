@@ -272,6 +272,16 @@ Win32Socket::Bind()
         n_printf("Win32Socket::Bind(): bind() failed with '%s'!\n", this->GetErrorString().AsCharPtr());
         return false;
     }
+    if (0 == this->addr.GetPort())
+    {
+        // let the address reflect the port picked by the system
+        sockaddr_in boundAddr;
+        int boundAddrLen = sizeof(boundAddr);
+        if (SOCKET_ERROR != getsockname(this->sock, (sockaddr*)&boundAddr, &boundAddrLen))
+        {
+            this->addr.SetPort(ntohs(boundAddr.sin_port));
+        }
+    }
     this->isBound = true;
     return true;
 }
@@ -545,26 +555,124 @@ Win32Socket::Recv(void* buf, SizeT bufSize, SizeT& bytesReceived)
 
 //------------------------------------------------------------------------------
 /**
-    FIXME: this is the send method for connectionless sockets using the 
-    UDP protocol.
+    Send a single datagram to an address on a connectionless socket. The
+    address and port are expected in host byte order.
 */
 Win32Socket::Result
-Win32Socket::SendTo(const void* /*buf*/, SizeT /*numBytes*/, uint /*addr*/, ushort /*port*/, SizeT& /*bytesSent*/)
+Win32Socket::SendTo(const void* buf, SizeT numBytes, uint addr, ushort port, SizeT& bytesSent)
 {
-    n_error("Win32Socket::SendTo(): IMPLEMENT ME!");
-    return Error;
+    n_assert(this->IsOpen());
+    n_assert(0 != buf);
+    this->ClearError();
+    bytesSent = 0;
+    sockaddr_in sockAddr;
+    Memory::Clear(&sockAddr, sizeof(sockAddr));
+    sockAddr.sin_family = AF_INET;
+    sockAddr.sin_addr.s_addr = htonl(addr);
+    sockAddr.sin_port = htons(port);
+    int res = sendto(this->sock, (const char*) buf, numBytes, 0, (const sockaddr*) &sockAddr, sizeof(sockAddr));
+    if (SOCKET_ERROR == res)
+    {
+        int wsaError = WSAGetLastError();
+        if (WSAEWOULDBLOCK == wsaError)
+        {
+            return WouldBlock;
+        }
+        this->SetWSAError(wsaError);
+        n_printf("Win32Socket::SendTo(): sendto() failed with '%s'\n", this->GetErrorString().AsCharPtr());
+        return Error;
+    }
+    bytesSent = res;
+    return Success;
 }
 
 //------------------------------------------------------------------------------
 /**
-    FIXME: this is the recv method for connectionless socket using the UDP
-    protocol.
+    Receive a single datagram on a connectionless socket, the address and
+    port of the sender are returned in host byte order.
 */
 Win32Socket::Result
-Win32Socket::RecvFrom(void* /*buf*/, SizeT /*bufSize*/, uint /*addr*/, ushort /*port*/, SizeT& /*bytesReceived*/)
+Win32Socket::RecvFrom(void* buf, SizeT bufSize, uint& addr, ushort& port, SizeT& bytesReceived)
 {
-    n_error("Win32Socket::RecvFrom(): IMPLEMENT ME!");
-    return Error;
+    n_assert(this->IsOpen());
+    n_assert(0 != buf);
+    this->ClearError();
+    bytesReceived = 0;
+    sockaddr_in sockAddr;
+    int sockAddrLen = sizeof(sockAddr);
+    int res = recvfrom(this->sock, (char*) buf, bufSize, 0, (sockaddr*) &sockAddr, &sockAddrLen);
+    if (SOCKET_ERROR == res)
+    {
+        int wsaError = WSAGetLastError();
+        if (WSAEMSGSIZE == wsaError)
+        {
+            // the datagram has been truncated
+            res = bufSize;
+        }
+        else if (WSAEWOULDBLOCK == wsaError)
+        {
+            return WouldBlock;
+        }
+        else
+        {
+            this->SetWSAError(wsaError);
+            n_printf("Win32Socket::RecvFrom(): recvfrom() failed with '%s'\n", this->GetErrorString().AsCharPtr());
+            return Error;
+        }
+    }
+    addr = ntohl(sockAddr.sin_addr.s_addr);
+    port = ntohs(sockAddr.sin_port);
+    bytesReceived = res;
+    return Success;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Winsock has no batched datagram calls, so this sends one datagram
+    after the other.
+*/
+Win32Socket::Result
+Win32Socket::SendBatch(const Datagram* datagrams, SizeT numDatagrams, SizeT& numSent)
+{
+    numSent = 0;
+    while (numSent < numDatagrams)
+    {
+        const Datagram& datagram = datagrams[numSent];
+        SizeT bytesSent;
+        Result res = this->SendTo(datagram.buf, datagram.numBytes, datagram.addr, datagram.port, bytesSent);
+        if (Success != res)
+        {
+            return (WouldBlock == res && numSent > 0) ? Success : res;
+        }
+        numSent++;
+    }
+    return Success;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Win32Socket::Result
+Win32Socket::RecvBatch(Datagram* datagrams, SizeT numDatagrams, SizeT& numReceived)
+{
+    numReceived = 0;
+    while (numReceived < numDatagrams)
+    {
+        Datagram& datagram = datagrams[numReceived];
+        Result res = this->RecvFrom(datagram.buf, datagram.bufSize, datagram.addr, datagram.port, datagram.numBytes);
+        if (Success != res)
+        {
+            return (WouldBlock == res && numReceived > 0) ? Success : res;
+        }
+        numReceived++;
+
+        // like recvmmsg, only wait for the first datagram
+        if (this->isBlocking && !this->HasRecvData())
+        {
+            break;
+        }
+    }
+    return Success;
 }
 
 //------------------------------------------------------------------------------
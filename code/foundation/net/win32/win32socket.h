@@ -43,6 +43,16 @@ public:
         Closed,         // connection has been gracefully closed
     };
 
+    /// a datagram for batched sends and receives on connectionless sockets
+    struct Datagram
+    {
+        void* buf;          // packet data
+        SizeT bufSize;      // capacity of buf, only used when receiving
+        SizeT numBytes;     // size of the packet
+        uint addr;          // remote ipv4 address in host byte order
+        ushort port;        // remote port in host byte order
+    };
+
     /// error codes
     enum ErrorCode
     {
@@ -169,8 +179,12 @@ public:
     Result Recv(void* buf, SizeT bufSize, SizeT& bytesReceived);
     /// send raw data to address for connectionless sockets
     Result SendTo(const void* buf, SizeT numBytes, uint addr, ushort port, SizeT& bytesSent);
-    /// receive raw data from address for connectionless sockets
-    Result RecvFrom(void* buf, SizeT bufSize, uint addr, ushort port, SizeT& bytesReceived);
+    /// receive raw data and the sender's address for connectionless sockets
+    Result RecvFrom(void* buf, SizeT bufSize, uint& addr, ushort& port, SizeT& bytesReceived);
+    /// send several datagrams, stops at the first datagram which would block
+    Result SendBatch(const Datagram* datagrams, SizeT numDatagrams, SizeT& numSent);
+    /// receive up to numDatagrams datagrams
+    Result RecvBatch(Datagram* datagrams, SizeT numDatagrams, SizeT& numReceived);
 
 private:
     friend class Win32IpAddress;
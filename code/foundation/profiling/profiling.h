@@ -47,9 +47,14 @@
 #define N_SCOPE_ACCUM(name, cat)
 #define N_SCOPE_DYN_ACCUM(name, cat)
 #define N_MARKER_BEGIN(name, cat)
+#define N_MARKER_DYN_BEGIN(str, cat)
 #define N_MARKER_END()
 #define N_COUNTER_INCR(name, value)
 #define N_COUNTER_DECR(name, value)
+#define N_BUDGET_COUNTER_SETUP(name, budget)
+#define N_BUDGET_COUNTER_INCR(name, value)
+#define N_BUDGET_COUNTER_DECR(name, value)
+#define N_BUDGET_COUNTER_RESET(name)
 #define N_DECLARE_COUNTER(name, label)
 #endif
 
@@ -93,7 +98,7 @@ void ProfilingDecreaseCounter(const char* id, uint64 value);
 /// return table of counters
 const Util::Dictionary<const char*, uint64>& ProfilingGetCounters();
 
-/// Setup a profiling budget counter
+/// Setup a profiling budget counter, or change the budget of an existing one
 void ProfilingSetupBudgetCounter(const char* id, uint64 budget);
 /// Increment budget counter
 void ProfilingBudgetIncreaseCounter(const char* id, uint64 value);
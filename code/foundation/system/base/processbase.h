@@ -49,11 +49,14 @@ public:
     virtual void UpdateStdoutStream() = 0;
     /// Detect if an instance of the process is already running
     virtual bool CheckIfExists() = 0;
+    /// exit code of the last launched process, valid once IsRunning() returned false
+    int GetExitCode() const;
 
 protected:
 
     bool noConsoleWindow;
     bool isRunning;
+    int exitCode;
     IO::URI exePath;
     IO::URI workingDir;
     Util::String args;
@@ -69,6 +72,7 @@ inline
 Process::Process() :
     noConsoleWindow(false),
     isRunning(false),
+    exitCode(0),
     stdoutCaptureStream(nullptr)   
 { 
     // empty
@@ -147,6 +151,15 @@ Process::GetStderrCaptureStream() const
     return this->stderrCaptureStream;
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline int
+Process::GetExitCode() const
+{
+    return this->exitCode;
+}
+
 
 } // namespace Base
 //------------------------------------------------------------------------------
@@ -4,7 +4,11 @@
 //------------------------------------------------------------------------------
 #include "foundation/stdneb.h"
 #include "posixprocess.h"
+#include "util/fixedarray.h"
 #include <sys/wait.h>
+#include <poll.h>
+#include <errno.h>
+#include <unistd.h>
 
 namespace Posix
 {
@@ -25,25 +29,88 @@ PosixProcess::PosixProcess() :
 
 //------------------------------------------------------------------------------
 /**
+    Launches the application and waits for it, captured output is read while
+    it runs so the child never blocks on a full pipe. Nothing of this object
+    is touched, the child and its pipes only live in here.
 */
 bool
 PosixProcess::LaunchWait() const
 {
-    if(this->Launch())
+    int outRead, errRead;
+    const pid_t child = this->Spawn(outRead, errRead);
+    if(child < 0)
     {
-        int status;
-        if(waitpid(this->pid,&status,0) > 0)
+        return false;
+    }
+
+    struct pollfd fds[2];
+    Ptr<Stream> streams[2];
+    int numFds = 0;
+    if(outRead >= 0)
+    {
+        this->stdoutCaptureStream->SetAccessMode(Stream::WriteAccess);
+        this->stdoutCaptureStream->Open();
+        fds[numFds] = { outRead, POLLIN, 0 };
+        streams[numFds++] = this->stdoutCaptureStream;
+    }
+    if(errRead >= 0)
+    {
+        this->stderrCaptureStream->SetAccessMode(Stream::WriteAccess);
+        this->stderrCaptureStream->Open();
+        fds[numFds] = { errRead, POLLIN, 0 };
+        streams[numFds++] = this->stderrCaptureStream;
+    }
+
+    // read until the child closed all captured pipes
+    char buffer[4096];
+    int numOpen = numFds;
+    while(numOpen > 0)
+    {
+        if(poll(fds, numFds, -1) < 0)
         {
-            this->CleanUp();
-            return true;
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            break;
         }
-        else
+        int i;
+        for(i = 0; i < numFds; i++)
         {
-            this->CleanUp();
-            n_error("Failed on waitpid\n");
-            return false;
+            if(fds[i].fd < 0 || fds[i].revents == 0)
+            {
+                continue;
+            }
+            ssize_t bytesRead = read(fds[i].fd, buffer, sizeof(buffer));
+            if(bytesRead > 0)
+            {
+                streams[i]->Write(buffer, bytesRead);
+            }
+            else if(bytesRead == 0 || errno != EINTR)
+            {
+                close(fds[i].fd);
+                streams[i]->Close();
+                fds[i].fd = -1;
+                numOpen--;
+            }
         }
     }
+    int i;
+    for(i = 0; i < numFds; i++)
+    {
+        if(fds[i].fd >= 0)
+        {
+            close(fds[i].fd);
+            streams[i]->Close();
+        }
+    }
+
+    int status;
+    if(waitpid(child,&status,0) > 0)
+    {
+        return true;
+    }
+    n_error("Failed on waitpid\n");
     return false;
 }
 
@@ -54,13 +121,45 @@ PosixProcess::LaunchWait() const
 */
 bool
 PosixProcess::Launch()
+{
+    this->pid = this->Spawn(this->outPipe, this->errPipe);
+    if(this->pid < 0)
+    {
+        return false;
+    }
+
+    if(this->stdoutCaptureStream.isvalid())
+    {
+        this->stdoutCaptureStream->SetAccessMode(Stream::WriteAccess);
+        this->stdoutCaptureStream->Open();
+    }
+    if(this->stderrCaptureStream.isvalid())
+    {
+        this->stderrCaptureStream->SetAccessMode(Stream::WriteAccess);
+        this->stderrCaptureStream->Open();
+    }
+    this->exitCode = 0;
+    this->isRunning = true;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Forks and executes the application. Returns the pid of the child, or -1 on
+    failure. Captured stdout and stderr are returned as the read ends of their
+    pipes, output which isn't captured goes to the parent's console and its
+    pipe end is -1.
+*/
+pid_t
+PosixProcess::Spawn(int& outRead, int& errRead) const
 {
     n_assert(this->exePath.IsValid());
+    outRead = -1;
+    errRead = -1;
 
     int in[2];
     int out[2];
     int err[2];
-    int pid;
     int rc;
 
     rc = pipe(in);
@@ -68,7 +167,7 @@ PosixProcess::Launch()
     if(rc<0)
     {
         n_error("Failed to create input pipe\n");
-        return false;
+        return -1;
     }
 
     rc = pipe(out);
@@ -77,7 +176,7 @@ PosixProcess::Launch()
         n_error("Failed to create output pipe\n");
         close(in[0]);
         close(in[1]);
-        return false;
+        return -1;
     }
 
     rc = pipe(err);
@@ -88,44 +187,56 @@ PosixProcess::Launch()
         close(in[1]);
         close(out[0]);
         close(out[1]);
-        return false;
+        return -1;
     }
 
-    pid = fork();
+    // the argument strings are copied into one writable block, as execvp wants mutable strings
+    const String exe = this->exePath.LocalPath();
+    const Array<String> strargs = this->args.Tokenize(" ",'\"');
+    SizeT argBytes = exe.Length() + 1;
+    IndexT i;
+    for(i = 0; i < strargs.Size(); i++)
+    {
+        argBytes += strargs[i].Length() + 1;
+    }
+    FixedArray<char> argData(argBytes);
+    FixedArray<char*> argv(strargs.Size() + 2);
+    char* argPtr = argData.Begin();
+    for(i = 0; i <= strargs.Size(); i++)
+    {
+        const String& arg = i == 0 ? exe : strargs[i - 1];
+        Memory::Copy(arg.AsCharPtr(), argPtr, arg.Length() + 1);
+        argv[i] = argPtr;
+        argPtr += arg.Length() + 1;
+    }
+    argv[i] = NULL;
+
+    pid_t pid = fork();
     if(pid > 0)
     { // parent
             close(in[0]);
             close(out[1]);
             close(err[1]);
-            inPipe = in[1];
-            outPipe = out[0];
-            errPipe = err[0];
 
             // we are currently not using stdin so we close it again
-            close(inPipe);
-            if(!this->stdoutCaptureStream.isvalid())
+            close(in[1]);
+            if(this->stdoutCaptureStream.isvalid())
             {
-                close(outPipe);
+                outRead = out[0];
             }
             else
             {
-                this->stdoutCaptureStream->SetAccessMode(Stream::WriteAccess);
-                this->stdoutCaptureStream->Open();
+                close(out[0]);
             }
-
-            if(!this->stderrCaptureStream.isvalid())
+            if(this->stderrCaptureStream.isvalid())
             {
-                close(errPipe);
+                errRead = err[0];
             }
             else
             {
-                this->stderrCaptureStream->SetAccessMode(Stream::WriteAccess);
-                this->stderrCaptureStream->Open();
+                close(err[0]);
             }
-            this->isRunning = true;
-
-            return true;
-
+            return pid;
     }
     else if(pid == 0)
     { // child
@@ -134,24 +245,31 @@ PosixProcess::Launch()
             close(err[0]);
             close(0);
             dup(in[0]);
-            close(1);
-            dup(out[1]);
-            close(2);
-            dup(err[1]);
 
-            // convert arg string to array of char*
-            Array<String> strargs = this->args.Tokenize(" ",'\"');
-            char ** argv = new char*[strargs.Size() + 2];
-            argv[0] = this->exePath.LocalPath().AsCharPtr();
-            int i;
-            for(i = 0 ; i<strargs.Size() ; i++)
+            // output which isn't captured goes to the parent's console
+            if(this->stdoutCaptureStream.isvalid())
             {
-                argv[i+1] = strargs[i].AsCharPtr();
+                close(1);
+                dup(out[1]);
             }
-            argv[i+1] = NULL;
+            if(this->stderrCaptureStream.isvalid())
+            {
+                close(2);
+                dup(err[1]);
+            }
+            close(in[0]);
+            close(out[1]);
+            close(err[1]);
 
+            if(this->workingDir.IsValid())
+            {
+                if(chdir(this->workingDir.LocalPath().AsCharPtr()) != 0)
+                {
+                    exit(1);
+                }
+            }
 
-            execvp(this->exePath.LocalPath().AsCharPtr(), (char**)argv);
+            execvp(argv[0], argv.Begin());
             exit(1);
     }
     else
@@ -163,7 +281,7 @@ PosixProcess::Launch()
         close(in[0]);
         close(in[1]);
         n_error("Failed to fork\n");
-        return false;
+        return -1;
     }
 }
 
@@ -181,6 +299,8 @@ PosixProcess::IsRunning()
         int res = waitpid(this->pid, &status, WNOHANG);
         if(res > 0)
         {
+            this->exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+
             // cleanup
             if(this->stdoutCaptureStream.isvalid())
             {
@@ -249,10 +369,18 @@ PosixProcess::CheckIfExists(const IO::URI & program)
 /**
 */
 void
-PosixProcess::CleanUp() const
+PosixProcess::CleanUp()
 {
-    close(outPipe);
-    close(errPipe);
+    if(outPipe >= 0)
+    {
+        close(outPipe);
+        outPipe = -1;
+    }
+    if(errPipe >= 0)
+    {
+        close(errPipe);
+        errPipe = -1;
+    }
 }
 
 } // namespace Posix
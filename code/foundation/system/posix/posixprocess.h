@@ -36,8 +36,10 @@ public:
     static bool CheckIfExists(const IO::URI & program);
 
 private:
+    /// fork and exec the application, returns the child pid or -1
+    pid_t Spawn(int& outRead, int& errRead) const;
     /// cleanup all pipes
-    void CleanUp() const;
+    void CleanUp();
 
     int inPipe;
     int outPipe;
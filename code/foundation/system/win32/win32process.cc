@@ -169,6 +169,7 @@ Win32Process::IsRunning()
         GetExitCodeProcess(this->lauchedProcessInfo.hProcess, &exitCode);
         if (exitCode != STILL_ACTIVE)
         {
+            this->exitCode = (int)exitCode;
             this->UpdateStdoutStream();
             // cleanup
             if(this->stdoutCaptureStream.isvalid())
@@ -10,6 +10,7 @@
     (C) 2013-2020 Individual contributors, see AUTHORS file
 */
 #include "core/types.h"
+#include <functional>
 
 namespace Util
 {
@@ -187,7 +188,7 @@ FirstOne(uint64 value)
     DWORD count = 0;
     _BitScanForward64(&count, value);
 #else
-    int count = __builtin_ctz(value);
+    int count = __builtin_ctzll(value);
 #endif
     return count;
 }
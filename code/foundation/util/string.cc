@@ -296,6 +296,18 @@ String::Tokenize(const String& whiteSpace, char fence) const
     return tokens;
 }
 
+//------------------------------------------------------------------------------
+/**
+    Tokenize into views of this string, which stay valid until the string is
+    modified or destroyed. Unlike the other Tokenize methods the string is
+    neither copied nor are strings created for the tokens.
+*/
+SizeT
+String::Tokenize(const StringView& whiteSpace, Array<StringView>& outTokens) const
+{
+    return StringView(*this).Tokenize(whiteSpace, outTokens);
+}
+
 //------------------------------------------------------------------------------
 /**
     Extract a substring range.
@@ -343,24 +355,11 @@ String::Strip(const String& charSet)
     Return the index of a substring, or InvalidIndex if not found.
 */
 IndexT
-String::FindStringIndex(const String& s, IndexT startIndex) const
+String::FindStringIndex(const StringView& s, IndexT startIndex) const
 {
     n_assert(startIndex < this->strLen);
     n_assert(s.IsValid());
-    IndexT i;
-    for (i = startIndex; i < this->strLen; i++)
-    {
-        if ((this->strLen - i) < s.strLen)
-        {
-            break;
-        }
-
-        if (strncmp(&(this->AsCharPtr()[i]), s.AsCharPtr(), s.strLen) == 0)
-        {
-            return i;
-        }
-    }
-    return InvalidIndex;
+    return StringView(*this).FindStringIndex(s, startIndex);
 }
 
 //------------------------------------------------------------------------------
@@ -1121,6 +1120,15 @@ String::StrCmp(const char* str0, const char* str1)
     return strcmp(str0, str1);
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+int
+String::StrCmp(const StringView& str0, const StringView& str1)
+{
+    return StringView::StrCmp(str0, str1);
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -28,6 +28,7 @@
 #include "core/sysfunc.h"
 #include "util/array.h"
 #include "util/dictionary.h"
+#include "util/stringview.h"
 #include "memory/heap.h"
 
 #include "memory/poolarrayallocator.h"
@@ -60,6 +61,8 @@ public:
     String(const char* cStr);
     /// construct from C string
     String(const char* cStr, size_t len);
+    /// construct from string view
+    explicit String(const StringView& view);
     /// destructor
     ~String();
 
@@ -93,6 +96,8 @@ public:
     char operator[](IndexT i) const;
     /// read/write index operator
     char& operator[](IndexT i);
+    /// get a view of the string, valid until the string is modified
+    operator StringView() const;
 
     /// reserve internal buffer size to prevent heap allocs
     void Reserve(SizeT newSize);
@@ -128,6 +133,8 @@ public:
     SizeT Tokenize(const String& whiteSpace, char fence, Array<String>& outTokens) const;
     /// tokenize string, keep strings within fence characters intact, SLOW since new array will be constructed
     Array<String> Tokenize(const String& whiteSpace, char fence) const;
+    /// tokenize string into views of this string, no allocations if the tokens array can be reused
+    SizeT Tokenize(const StringView& whiteSpace, Array<StringView>& outTokens) const;
     /// extract substring
     String ExtractRange(IndexT fromIndex, SizeT numChars) const;
     /// extract substring to end of this string
@@ -135,7 +142,7 @@ public:
     /// terminate string at first occurence of character in set
     void Strip(const String& charSet);
     /// return start index of substring, or InvalidIndex if not found
-    IndexT FindStringIndex(const String& s, IndexT startIndex = 0) const;
+    IndexT FindStringIndex(const StringView& s, IndexT startIndex = 0) const;
     /// return index of character in string, or InvalidIndex if not found
     IndexT FindCharIndex(char c, IndexT startIndex = 0) const;
     /// returns true if string begins with string
@@ -403,6 +410,8 @@ public:
 
     /// lowlevel string compare wrapper function
     static int StrCmp(const char* str0, const char* str1);
+    /// string compare for views, which are not zero terminated
+    static int StrCmp(const StringView& str0, const StringView& str1);
     /// lowlevel string length function
     static int StrLen(const char* str);
     /// find character in string
@@ -495,6 +504,19 @@ String::String(const char* str, size_t len) :
 }
 
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+String::String(const StringView& view) :
+    heapBuffer(0),
+    strLen(0),
+    heapBufferSize(0)
+{
+    this->localBuffer[0] = 0;
+    this->Set(view.Data(), view.Length());
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -548,6 +570,15 @@ String::AsCharPtr() const
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+String::operator StringView() const
+{
+    return StringView(this->AsCharPtr(), this->strLen);
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -0,0 +1,143 @@
+//------------------------------------------------------------------------------
+//  stringbuilder.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+
+#include "util/stringbuilder.h"
+#include "math/scalar.h"
+
+#include <stdio.h>
+
+namespace Util
+{
+
+//------------------------------------------------------------------------------
+/**
+*/
+StringBuilder::StringBuilder(SizeT chunkSize) :
+    curChunk(InvalidIndex),
+    chunkSize(chunkSize),
+    begin(nullptr),
+    cur(nullptr),
+    chunkEnd(nullptr),
+    usedSize(0),
+    inString(false)
+{
+    n_assert(chunkSize > 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+StringBuilder::~StringBuilder()
+{
+    this->Discard();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+StringBuilder::AppendInt(int val)
+{
+    char buf[16];
+    int len = snprintf(buf, sizeof(buf), "%d", val);
+    this->Append(StringView(buf, len));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+StringBuilder::AppendFloat(float val)
+{
+    char buf[64];
+    int len = snprintf(buf, sizeof(buf), "%.6f", val);
+    this->Append(StringView(buf, Math::min(len, (int)sizeof(buf) - 1)));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+StringBuilder::Reset()
+{
+    n_assert(!this->inString);
+    if (this->chunks.IsEmpty())
+    {
+        return;
+    }
+    this->curChunk = 0;
+    this->begin = this->cur = this->chunks[0].data;
+    this->chunkEnd = this->chunks[0].data + this->chunks[0].size;
+    this->usedSize = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+StringBuilder::Discard()
+{
+    IndexT i;
+    for (i = 0; i < this->chunks.Size(); i++)
+    {
+        Memory::Free(Memory::StringDataHeap, this->chunks[i].data);
+    }
+    this->chunks.Clear();
+    this->curChunk = InvalidIndex;
+    this->begin = this->cur = this->chunkEnd = nullptr;
+    this->usedSize = 0;
+    this->inString = false;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+StringBuilder::GetUsedSize() const
+{
+    if (this->curChunk == InvalidIndex)
+    {
+        return 0;
+    }
+    return this->usedSize + SizeT(this->cur - this->chunks[this->curChunk].data);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Moves on to the next chunk, reusing chunks from before the last Reset if
+    they are big enough. The part of the current string which is already
+    built is moved along, so strings never span chunks.
+*/
+void
+StringBuilder::Reserve(SizeT numChars)
+{
+    const SizeT partial = SizeT(this->cur - this->begin);
+    const SizeT needed = partial + numChars + 1;
+    if (this->curChunk != InvalidIndex)
+    {
+        this->usedSize += SizeT(this->begin - this->chunks[this->curChunk].data);
+    }
+
+    IndexT next = this->curChunk + 1;
+    if (next >= this->chunks.Size() || this->chunks[next].size < needed)
+    {
+        Chunk chunk;
+        chunk.size = Math::max(this->chunkSize, needed);
+        chunk.data = (char*)Memory::Alloc(Memory::StringDataHeap, chunk.size);
+        this->chunks.Insert(next, chunk);
+    }
+
+    const Chunk& chunk = this->chunks[next];
+    if (partial > 0)
+    {
+        memcpy(chunk.data, this->begin, partial);
+    }
+    this->curChunk = next;
+    this->begin = chunk.data;
+    this->cur = chunk.data + partial;
+    this->chunkEnd = chunk.data + chunk.size;
+}
+
+} // namespace Util
@@ -0,0 +1,166 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Util::StringBuilder
+
+    Builds zero terminated strings in arena chunks, for parsers which need
+    lots of short lived strings. A string costs no allocation unless a chunk
+    runs full, and all strings are released at once with Reset, which keeps
+    the chunks for reuse.
+
+    Strings are built between Begin and End, or copied in one go with Add.
+    The returned views stay valid until Reset or Discard, and are zero
+    terminated so Data() can be passed on as a C string.
+
+        StringBuilder builder;
+        builder.Begin();
+        builder.Append(name);
+        builder.AppendChar('.');
+        builder.AppendInt(index);
+        StringView key = builder.End();
+
+    NOTE: not thread-safe, use one builder per thread.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "core/types.h"
+#include "util/array.h"
+#include "util/stringview.h"
+
+//------------------------------------------------------------------------------
+namespace Util
+{
+class StringBuilder
+{
+public:
+    /// constructor, chunkSize is the default size of the arena chunks in bytes
+    StringBuilder(SizeT chunkSize = 65536);
+    /// destructor
+    ~StringBuilder();
+
+    /// begin a new string
+    void Begin();
+    /// append a string to the current string
+    void Append(const StringView& str);
+    /// append a character to the current string
+    void AppendChar(char c);
+    /// append an int to the current string
+    void AppendInt(int val);
+    /// append a float to the current string
+    void AppendFloat(float val);
+    /// finish the current string and return it
+    StringView End();
+
+    /// copy a string into the arena
+    StringView Add(const StringView& str);
+
+    /// release all strings, but keep the chunks
+    void Reset();
+    /// release all strings and free the chunks
+    void Discard();
+
+    /// get number of allocated chunks
+    SizeT GetNumChunks() const;
+    /// get number of bytes used by strings since the last reset
+    SizeT GetUsedSize() const;
+
+private:
+    /// make room for numChars more characters plus terminator, moving the current string if needed
+    void Reserve(SizeT numChars);
+
+    struct Chunk
+    {
+        char* data;
+        SizeT size;
+    };
+    Util::Array<Chunk> chunks;
+    IndexT curChunk;
+    SizeT chunkSize;
+    char* begin;            // start of the current string
+    char* cur;              // end of the current string
+    char* chunkEnd;
+    SizeT usedSize;         // bytes used in retired chunks
+    bool inString;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+StringBuilder::Begin()
+{
+    n_assert(!this->inString);
+    this->inString = true;
+    this->begin = this->cur;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+StringBuilder::Append(const StringView& str)
+{
+    n_assert(this->inString);
+    if (SizeT(this->chunkEnd - this->cur) <= str.Length())
+    {
+        this->Reserve(str.Length());
+    }
+    memcpy(this->cur, str.Data(), str.Length());
+    this->cur += str.Length();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+StringBuilder::AppendChar(char c)
+{
+    n_assert(this->inString);
+    if (SizeT(this->chunkEnd - this->cur) <= 1)
+    {
+        this->Reserve(1);
+    }
+    *this->cur++ = c;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline StringView
+StringBuilder::End()
+{
+    n_assert(this->inString);
+    if (this->cur == this->chunkEnd)
+    {
+        this->Reserve(0);
+    }
+    *this->cur = 0;
+    StringView result(this->begin, SizeT(this->cur - this->begin));
+    this->cur++;
+    this->inString = false;
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline StringView
+StringBuilder::Add(const StringView& str)
+{
+    this->Begin();
+    this->Append(str);
+    return this->End();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+StringBuilder::GetNumChunks() const
+{
+    return this->chunks.Size();
+}
+
+} // namespace Util
+//------------------------------------------------------------------------------
@@ -0,0 +1,420 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Util::StringView
+
+    A non owning view of a range of characters, for searching and splitting
+    strings without creating a String per token.
+
+    Views are not zero terminated, since they usually point into the middle
+    of a String or a file buffer. Use CopyToBuffer or construct a String
+    when a C string is required, and keep in mind that a view is only valid
+    for as long as the characters it points to.
+
+    Comparison and hashing match the String class, so views can be used to
+    look up strings without converting them first.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "core/types.h"
+#include "util/array.h"
+#include <string.h>
+#include <stdlib.h>
+
+//------------------------------------------------------------------------------
+namespace Util
+{
+class StringView
+{
+public:
+    /// default constructor, creates an empty view
+    StringView();
+    /// construct from zero terminated C string
+    StringView(const char* cStr);
+    /// construct from pointer and length
+    StringView(const char* ptr, SizeT length);
+
+    /// equality operator
+    friend bool operator==(const StringView& a, const StringView& b) { return StringView::StrCmp(a, b) == 0; }
+    /// inequality operator
+    friend bool operator!=(const StringView& a, const StringView& b) { return StringView::StrCmp(a, b) != 0; }
+    /// less-then operator
+    friend bool operator<(const StringView& a, const StringView& b) { return StringView::StrCmp(a, b) < 0; }
+    /// greater-then operator
+    friend bool operator>(const StringView& a, const StringView& b) { return StringView::StrCmp(a, b) > 0; }
+    /// read-only index operator
+    char operator[](IndexT i) const;
+
+    /// return length of view
+    SizeT Length() const;
+    /// return true if the view is empty
+    bool IsEmpty() const;
+    /// return true if the view is not empty
+    bool IsValid() const;
+    /// get pointer to the first character, NOT zero terminated
+    const char* Data() const;
+    /// get pointer past the last character
+    const char* End() const;
+    /// copy to zero terminated char buffer (return false if buffer is too small)
+    bool CopyToBuffer(char* buf, SizeT bufSize) const;
+
+    /// extract a sub view
+    StringView ExtractRange(IndexT fromIndex, SizeT numChars) const;
+    /// extract a sub view to the end of this view
+    StringView ExtractToEnd(IndexT fromIndex) const;
+    /// return start index of substring, or InvalidIndex if not found
+    IndexT FindStringIndex(const StringView& s, IndexT startIndex = 0) const;
+    /// return index of character, or InvalidIndex if not found
+    IndexT FindCharIndex(char c, IndexT startIndex = 0) const;
+    /// returns true if view begins with string
+    bool BeginsWithString(const StringView& s) const;
+    /// returns true if view ends with string
+    bool EndsWithString(const StringView& s) const;
+    /// return view without characters from charset at both sides
+    StringView Trim(const StringView& charSet) const;
+    /// split into views at any character of whiteSpace, empty tokens are skipped
+    SizeT Tokenize(const StringView& whiteSpace, Array<StringView>& outTokens) const;
+
+    /// return contents as integer
+    int AsInt() const;
+    /// return contents as float
+    float AsFloat() const;
+    /// return a 32-bit hash code, same as String::HashCode
+    uint32_t HashCode() const;
+
+    /// compare two views, with the same ordering as strcmp
+    static int StrCmp(const StringView& a, const StringView& b);
+
+private:
+    /// character set as a lookup table
+    struct CharSet
+    {
+        CharSet(const StringView& chars);
+        bool Contains(char c) const;
+        uint64_t bits[4];
+    };
+
+    const char* ptr;
+    SizeT len;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+StringView::StringView() :
+    ptr(""),
+    len(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+StringView::StringView(const char* cStr) :
+    ptr(cStr != nullptr ? cStr : ""),
+    len(cStr != nullptr ? (SizeT)strlen(cStr) : 0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+StringView::StringView(const char* ptr, SizeT length) :
+    ptr(ptr),
+    len(length)
+{
+    n_assert(ptr != nullptr || length == 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline char
+StringView::operator[](IndexT i) const
+{
+    n_assert((i >= 0) && (i < this->len));
+    return this->ptr[i];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+StringView::Length() const
+{
+    return this->len;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+StringView::IsEmpty() const
+{
+    return 0 == this->len;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+StringView::IsValid() const
+{
+    return 0 != this->len;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const char*
+StringView::Data() const
+{
+    return this->ptr;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const char*
+StringView::End() const
+{
+    return this->ptr + this->len;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+StringView::CopyToBuffer(char* buf, SizeT bufSize) const
+{
+    n_assert(0 != buf);
+    if (this->len >= bufSize)
+    {
+        return false;
+    }
+    memcpy(buf, this->ptr, this->len);
+    buf[this->len] = 0;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline StringView
+StringView::ExtractRange(IndexT fromIndex, SizeT numChars) const
+{
+    n_assert(fromIndex <= this->len);
+    n_assert((fromIndex + numChars) <= this->len);
+    return StringView(this->ptr + fromIndex, numChars);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline StringView
+StringView::ExtractToEnd(IndexT fromIndex) const
+{
+    return this->ExtractRange(fromIndex, this->len - fromIndex);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Searches for the first character with memchr, and compares the rest
+    with memcmp.
+*/
+inline IndexT
+StringView::FindStringIndex(const StringView& s, IndexT startIndex) const
+{
+    n_assert(s.IsValid());
+    if (startIndex >= this->len || s.len > this->len - startIndex)
+    {
+        return InvalidIndex;
+    }
+    const char* cur = this->ptr + startIndex;
+    const char* last = this->ptr + this->len - s.len;
+    while (cur <= last)
+    {
+        cur = (const char*)memchr(cur, s.ptr[0], last - cur + 1);
+        if (cur == nullptr)
+        {
+            break;
+        }
+        if (memcmp(cur, s.ptr, s.len) == 0)
+        {
+            return IndexT(cur - this->ptr);
+        }
+        cur++;
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline IndexT
+StringView::FindCharIndex(char c, IndexT startIndex) const
+{
+    if (startIndex >= this->len)
+    {
+        return InvalidIndex;
+    }
+    const char* found = (const char*)memchr(this->ptr + startIndex, c, this->len - startIndex);
+    return found != nullptr ? IndexT(found - this->ptr) : InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+StringView::BeginsWithString(const StringView& s) const
+{
+    return s.len <= this->len && memcmp(this->ptr, s.ptr, s.len) == 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+StringView::EndsWithString(const StringView& s) const
+{
+    return s.len <= this->len && memcmp(this->ptr + this->len - s.len, s.ptr, s.len) == 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+StringView::CharSet::CharSet(const StringView& chars)
+{
+    this->bits[0] = this->bits[1] = this->bits[2] = this->bits[3] = 0;
+    for (IndexT i = 0; i < chars.len; i++)
+    {
+        const uchar c = (uchar)chars.ptr[i];
+        this->bits[c >> 6] |= 1ull << (c & 63);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+StringView::CharSet::Contains(char c) const
+{
+    return (this->bits[(uchar)c >> 6] >> ((uchar)c & 63)) & 1;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline StringView
+StringView::Trim(const StringView& charSet) const
+{
+    const CharSet set(charSet);
+    const char* first = this->ptr;
+    const char* last = this->ptr + this->len;
+    while (first < last && set.Contains(*first))
+    {
+        first++;
+    }
+    while (last > first && set.Contains(last[-1]))
+    {
+        last--;
+    }
+    return StringView(first, SizeT(last - first));
+}
+
+//------------------------------------------------------------------------------
+/**
+    Splits like String::Tokenize, but neither copies the string nor creates
+    strings for the tokens. The tokens point into this view.
+*/
+inline SizeT
+StringView::Tokenize(const StringView& whiteSpace, Array<StringView>& outTokens) const
+{
+    outTokens.Clear();
+    const CharSet set(whiteSpace);
+    const char* cur = this->ptr;
+    const char* end = this->ptr + this->len;
+    while (cur < end)
+    {
+        while (cur < end && set.Contains(*cur))
+        {
+            cur++;
+        }
+        const char* start = cur;
+        while (cur < end && !set.Contains(*cur))
+        {
+            cur++;
+        }
+        if (cur > start)
+        {
+            outTokens.Append(StringView(start, SizeT(cur - start)));
+        }
+    }
+    return outTokens.Size();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Numbers don't need more than 64 characters, longer views return 0.
+*/
+inline int
+StringView::AsInt() const
+{
+    char buf[64];
+    return this->CopyToBuffer(buf, sizeof(buf)) ? atoi(buf) : 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline float
+StringView::AsFloat() const
+{
+    char buf[64];
+    return this->CopyToBuffer(buf, sizeof(buf)) ? float(atof(buf)) : 0.0f;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline uint32_t
+StringView::HashCode() const
+{
+    uint32_t hash = 0;
+    SizeT i;
+    for (i = 0; i < this->len; i++)
+    {
+        hash += this->ptr[i];
+        hash += hash << 10;
+        hash ^= hash >>  6;
+    }
+    hash += hash << 3;
+    hash ^= hash >> 11;
+    hash += hash << 15;
+    return hash;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline int
+StringView::StrCmp(const StringView& a, const StringView& b)
+{
+    const SizeT common = a.len < b.len ? a.len : b.len;
+    const int res = memcmp(a.ptr, b.ptr, common);
+    if (res != 0)
+    {
+        return res;
+    }
+    return a.len < b.len ? -1 : (a.len > b.len ? 1 : 0);
+}
+
+} // namespace Util
+//------------------------------------------------------------------------------
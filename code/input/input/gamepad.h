@@ -9,7 +9,7 @@
     (C) 2007 Radon Labs GmbH
     (C) 2013-2020 Individual contributors, see AUTHORS file
 */ 
-#if __VULKAN__
+#if (__VULKAN__ || __NULL_GRAPHICS__)
 #include "input/base/gamepadbase.h"
 namespace Input
 {
@@ -5,7 +5,7 @@
 //------------------------------------------------------------------------------
 #include "foundation/stdneb.h"
 #include "input/mouse.h"
-#if __VULKAN__
+#if (__VULKAN__ || __NULL_GRAPHICS__)
 namespace Input
 {
 __ImplementClass(Input::Mouse, 'MOUS', Base::MouseBase);
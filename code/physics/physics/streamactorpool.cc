@@ -15,6 +15,7 @@
 #include "flat/physics/material.h"
 #include "flat/physics/actor.h"
 #include "coregraphics/nvx3fileformatstructs.h"
+#include "coregraphics/nvx3quantization.h"
 #include "coregraphics/primitivegroup.h"
 #include "coregraphics/load/glimltypes.h"
 #include "coregraphics/indextype.h"
@@ -152,6 +153,9 @@ CreateMeshFromResource(MeshTopology type, Util::StringAtom resource, int primGro
 
     n_assert(header != nullptr);
 
+    // quantized meshes are decoded to a temporary plain nvx3 image
+    void* decodedPtr = CoreGraphics::Nvx3::DecodeQuantized(header, Memory::ScratchHeap);
+
     if (header->magic != NEBULA_NVX_MAGICNUMBER)
     {
         // not a nvx3 file, break hard
@@ -221,6 +225,8 @@ CreateMeshFromResource(MeshTopology type, Util::StringAtom resource, int primGro
         }
         break;
     }
+    if (decodedPtr != nullptr)
+        Memory::Free(Memory::ScratchHeap, decodedPtr);
     nvx3Reader->Close();
     return holder;
 }
@@ -293,6 +299,9 @@ AddMeshColliders(PhysicsResource::MeshColliderT* colliderNode, Math::mat4 const&
 
     n_assert(header != nullptr);
 
+    // quantized meshes are decoded to a temporary plain nvx3 image
+    void* decodedPtr = CoreGraphics::Nvx3::DecodeQuantized(header, Memory::ScratchHeap);
+
     if (header->magic != NEBULA_NVX_MAGICNUMBER)
     {
         // not a nvx3 file, break hard
@@ -366,6 +375,8 @@ AddMeshColliders(PhysicsResource::MeshColliderT* colliderNode, Math::mat4 const&
         }
         currBone++;
     }
+    if (decodedPtr != nullptr)
+        Memory::Free(Memory::ScratchHeap, decodedPtr);
     nvx3Reader->Close();
 }
 
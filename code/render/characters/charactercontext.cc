@@ -14,6 +14,7 @@
 #include "models/nodes/characterskinnode.h"
 #include "profiling/profiling.h"
 #include "resources/resourceserver.h"
+#include "graphics/cameracontext.h"
 
 using namespace Graphics;
 using namespace Resources;
@@ -27,6 +28,17 @@ Util::HashTable<Util::StringAtom, CoreAnimation::AnimSampleMask> CharacterContex
 Threading::Event CharacterContext::totalCompletionEvent;
 Threading::AtomicCounter CharacterContext::ConstantUpdateCounter = 0;
 
+bool CharacterContext::animLodEnabled = true;
+float CharacterContext::animLodHalfRateDistance = 20.0f;
+float CharacterContext::animLodQuarterRateDistance = 50.0f;
+bool CharacterContext::poseCacheEnabled = true;
+Timing::Tick CharacterContext::poseCacheTimeQuantum = 0;
+SizeT CharacterContext::poseCacheHits = 0;
+SizeT CharacterContext::poseCacheMisses = 0;
+
+// number of frames between evaluations per animation LOD
+static const SizeT AnimLodIntervals[] = { 1, 2, 4, 1 };
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -53,6 +65,12 @@ CharacterContext::Create()
 #ifndef PUBLIC_BUILD
     __bundle.OnRenderDebug = CharacterContext::OnRenderDebug;
 #endif
+
+    // animations read the model transforms
+    __bundle.frameCalls.Append(CharacterContext::UpdateAnimations);
+    __bundle.waitCalls.Append(CharacterContext::WaitForCharacterJobs);
+    __bundle.dependencies.Append(Models::ModelContext::GetFunctionBundle());
+    __bundle.jobCounters.Append(&CharacterContext::ConstantUpdateCounter);
     Graphics::GraphicsServer::Instance()->RegisterGraphicsContext(&__bundle, &__state);
 }
 
@@ -74,6 +92,8 @@ CharacterContext::Setup(
     n_assert_fmt(cid != InvalidContextEntityId, "Entity %d is not registered in CharacterContext", id.HashCode());
     characterContextAllocator.Set<Loaded>(cid.id, NoneLoaded);
     characterContextAllocator.Set<EntityId>(cid.id, id);
+    characterContextAllocator.Set<AnimLod>(cid.id, FullRate);
+    characterContextAllocator.Set<AnimLodJointMask>(cid.id, nullptr);
 
     // check to make sure we registered this entity for observation, then get the visibility context
     const ContextEntityId visId = Visibility::ObservableContext::GetContextId(id);
@@ -110,6 +130,8 @@ CharacterContext::Setup(
             characterContextAllocator.Get<JointPalette>(cid.id).Resize(joints.Size());
             characterContextAllocator.Get<JointPaletteScaled>(cid.id).Resize(joints.Size());
             characterContextAllocator.Get<UserControlledJoint>(cid.id).Resize(joints.Size());
+            characterContextAllocator.Get<JointPalettePrev>(cid.id).Resize(joints.Size());
+            characterContextAllocator.Get<JointPaletteNext>(cid.id).Resize(joints.Size());
 
             // setup job joints
             IndexT i;
@@ -193,6 +215,7 @@ CharacterContext::PlayClip(
     runtime.duration = 0;
     runtime.evalTime = runtime.prevEvalTime = 0;
     runtime.sampleTime = runtime.prevSampleTime = 0;
+    runtime.clipTime = 0;
     runtime.paused = false;
     runtime.duration = Timing::Tick(clip.duration * loopCount * (1 / timeFactor));
 
@@ -374,6 +397,14 @@ GetAbsoluteStopTime(const CharacterContext::AnimationRuntime& runtime)
     return (runtime.baseTime + runtime.startTime + runtime.duration) - runtime.fadeOutTime;
 }
 
+enum CharacterEvalMode : uchar
+{
+    EvalMode_Skip,              // not loaded or frozen
+    EvalMode_Interpolate,       // between two evaluations at a reduced rate
+    EvalMode_Hold,              // evaluation frame, but nothing is playing
+    EvalMode_Evaluate           // evaluation frame with at least one playing clip
+};
+
 struct CharacterJobContext
 {
     const Util::Array<Timing::Time>* times;
@@ -388,21 +419,135 @@ struct CharacterJobContext
     float** tmpSamples;
     uint** tmpSampleIndices;
     Math::mat4** tmpJoints;
+    Util::Array<CharacterContext::LoadState>* loadStates;
+    const Util::Array<AnimationLod>* lods;
+    const Util::Array<const CoreAnimation::AnimSampleMask*>* lodJointMasks;
+    const Util::Array<Util::FixedArray<Math::mat4>>* prevJointPalettes;
+    const Util::Array<Util::FixedArray<Math::mat4>>* nextJointPalettes;
+    uchar* evalModes;
+    uint64* poseKeys;
+    IndexT* poseSources;
     
     const Util::Array<Graphics::GraphicsEntityId>* entities;
     CoreAnimation::AnimSampleMixInfo* animMixInfos;
     float frameTime;
     Timing::Tick time;
     Timing::Tick ticks;
+    IndexT frameIndex;
+    bool poseCacheEnabled;
+    Timing::Tick poseCacheTimeQuantum;
 };
 
 //------------------------------------------------------------------------------
 /**
 */
+static void
+LerpJointPalette(const Math::mat4* from, const Math::mat4* to, const float t, Math::mat4* out, const SizeT numJoints)
+{
+    IndexT i;
+    for (i = 0; i < numJoints; i++)
+    {
+        out[i].r[0] = Math::lerp(from[i].r[0], to[i].r[0], t);
+        out[i].r[1] = Math::lerp(from[i].r[1], to[i].r[1], t);
+        out[i].r[2] = Math::lerp(from[i].r[2], to[i].r[2], t);
+        out[i].r[3] = Math::lerp(from[i].r[3], to[i].r[3], t);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline uint64
+HashCombine(const uint64 hash, const uint64 value)
+{
+    return hash ^ (value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline uint64
+FloatBits(const float value)
+{
+    uint bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+//------------------------------------------------------------------------------
+/**
+    The palette evaluated for a character, characters at a reduced rate
+    evaluate into the next palette and interpolate towards it
+*/
+static inline Math::mat4*
+GetEvaluationTarget(const CharacterJobContext* context, const IndexT index)
+{
+    if (AnimLodIntervals[context->lods->Get(index)] > 1)
+        return context->nextJointPalettes->Get(index).Begin();
+    else
+        return context->jointPalettes->Get(index).Begin();
+}
+
+//------------------------------------------------------------------------------
+/**
+    The joint mask sampled for a character, joints outside of it keep their last
+    sampled pose so it only applies once the character has a complete pose
+*/
+static inline const CoreAnimation::AnimSampleMask*
+GetLodJointMask(const CharacterJobContext* context, const IndexT index)
+{
+    if (context->lods->Get(index) != QuarterRate || !AllBits(context->loadStates->Get(index), CharacterContext::PoseSampled))
+        return nullptr;
+    return context->lodJointMasks->Get(index);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Compares everything the pose key is made of, so characters whose keys
+    merely collide never end up sharing a pose
+*/
+static bool
+PosesMatch(const CharacterJobContext* context, const IndexT a, const IndexT b)
+{
+    if (context->anims->Get(a) != context->anims->Get(b)
+        || context->skeletons->Get(a) != context->skeletons->Get(b)
+        || GetLodJointMask(context, a) != GetLodJointMask(context, b))
+        return false;
+
+    // the shared pose is copied, so the buffers have to line up as well
+    if (context->sampleBuffers->Get(a).GetNumSamples() != context->sampleBuffers->Get(b).GetNumSamples()
+        || context->jointPalettes->Get(a).Size() != context->jointPalettes->Get(b).Size())
+        return false;
+
+    const CharacterContext::AnimationTracks& tracksA = context->tracks->Get(a);
+    const CharacterContext::AnimationTracks& tracksB = context->tracks->Get(b);
+    IndexT j;
+    for (j = 0; j < CharacterContext::MaxNumTracks; j++)
+    {
+        const CharacterContext::AnimationRuntime& playingA = tracksA.playingAnimations[j];
+        const CharacterContext::AnimationRuntime& playingB = tracksB.playingAnimations[j];
+        if (playingA.clip != playingB.clip)
+            return false;
+        if (playingA.clip == -1)
+            continue;
+        if (playingA.clipTime != playingB.clipTime
+            || playingA.blend != playingB.blend
+            || playingA.timeFactor != playingB.timeFactor
+            || playingA.mask != playingB.mask)
+            return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Advances the tracks of every character and decides how it is evaluated this frame.
+    Characters which evaluate get a pose key made up of everything the sampled pose depends on.
+*/
 void
-EvalCharacter(SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocationOffset, void* ctx)
+UpdateCharacterTracks(SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocationOffset, void* ctx)
 {
-    N_SCOPE(EvalCharacter, Graphics);
+    N_SCOPE(UpdateCharacterTracks, Graphics);
     auto context = static_cast<CharacterJobContext*>(ctx);
     using namespace CoreAnimation;
 
@@ -411,6 +556,7 @@ EvalCharacter(SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocat
         IndexT index = invocationOffset + i;
         if (index >= totalJobs)
             return;
+        context->evalModes[index] = EvalMode_Skip;
 
         // update time, get track controller
         Timing::Time& currentTime = context->times->Get(index);
@@ -419,24 +565,35 @@ EvalCharacter(SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocat
         const AnimationId anim = context->anims->Get(index);
         if (anim == InvalidAnimationId)
             continue;
-        const Util::FixedArray<SkeletonJobJoint>& jobJoint = context->jobJoints->Get(index);
         const SkeletonId skeleton = context->skeletons->Get(index);
         if (skeleton == InvalidSkeletonId)
             continue;
-        const Util::FixedArray<Math::mat4>& bindPose = Characters::SkeletonGetBindPose(skeleton);
-        const Util::FixedArray<Characters::CharacterJoint>& joints = Characters::SkeletonGetJoints(skeleton);
         const Util::FixedArray<Math::mat4>& jointPalette = context->jointPalettes->Get(index);
-        const Util::FixedArray<Math::mat4>& scaledJointPalette = context->scaledJointPalettes->Get(index);
-        const Util::FixedArray<Math::vec4>& idleSamples = Characters::SkeletonGetIdleSamples(skeleton);
-        const CoreAnimation::AnimSampleBuffer& sampleBuffer = context->sampleBuffers->Get(index);
-        Math::mat4* tmpMatrices = context->tmpJoints[index];
-        float* tmpSamples = context->tmpSamples[index];
-        uint* tmpSampleIndices = context->tmpSampleIndices[index];
-        auto sampleMixInfo = context->animMixInfos + index;
-        bool runSkeletonThisFrame = false;
+
+        // Characters at a reduced rate only evaluate every few frames, and show a blend from the pose
+        // at the time of the last evaluation towards the evaluated pose in between
+        const AnimationLod lod = context->lods->Get(index);
+        if (lod == Frozen)
+            continue;
+        const SizeT lodInterval = AnimLodIntervals[lod];
+        if ((context->frameIndex + index) % lodInterval != 0)
+        {
+            context->evalModes[index] = EvalMode_Interpolate;
+            continue;
+        }
+        if (lodInterval > 1)
+        {
+            const Util::FixedArray<Math::mat4>& prevJointPalette = context->prevJointPalettes->Get(index);
+            Memory::Copy(jointPalette.Begin(), prevJointPalette.Begin(), jointPalette.ByteSize());
+        }
+
+        // the pose depends on the skeleton, the clips and their times, blends and masks
+        const AnimSampleMask* jointMask = GetLodJointMask(context, index);
+        uint64 poseKey = HashCombine(skeleton.HashCode(), anim.HashCode());
+        poseKey = HashCombine(poseKey, (uint64)(intptr_t)jointMask);
+        bool playingAny = false;
 
         // loop over all tracks, and update the playing clip on each respective track
-        bool firstAnimTrack = true;
         IndexT j;
         for (j = 0; j < CharacterContext::MaxNumTracks; j++)
         {
@@ -533,53 +690,160 @@ EvalCharacter(SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocat
                     playing.sampleTime += playing.timeOffset;
                 }
 
-                // Need to compute the sample weight and pointers to "before" and "after" keys
+                // Snap the clip time to the quantum so characters close in time can share their pose
                 const CoreAnimation::AnimClip& clip = CoreAnimation::AnimGetClip(anim, playing.clip);
-                const Ptr<AnimKeyBuffer>& buffer = AnimGetBuffer(anim);
+                playing.clipTime = playing.sampleTime % clip.duration;
+                if (context->poseCacheEnabled && context->poseCacheTimeQuantum > 0)
+                    playing.clipTime -= playing.clipTime % context->poseCacheTimeQuantum;
+
+                poseKey = HashCombine(poseKey, j);
+                poseKey = HashCombine(poseKey, playing.clip);
+                poseKey = HashCombine(poseKey, playing.clipTime);
+                poseKey = HashCombine(poseKey, FloatBits(playing.blend));
+                poseKey = HashCombine(poseKey, FloatBits(playing.timeFactor));
+                poseKey = HashCombine(poseKey, (uint64)(intptr_t)playing.mask);
+                playingAny = true;
+            }
+        }
 
-                // Create scratch memory
-                Memory::Clear(sampleMixInfo, sizeof(AnimSampleMixInfo));
-                sampleMixInfo->sampleType = SampleType::Linear;
-                sampleMixInfo->velocityScale.set(playing.timeFactor, playing.timeFactor, playing.timeFactor, 0);
+        context->evalModes[index] = playingAny ? EvalMode_Evaluate : EvalMode_Hold;
+        context->poseKeys[index] = poseKey;
+    }
+}
 
-                // Get pointers to memory and size
-                const float* srcPtr = buffer->GetKeyBufferPointer();
-                const AnimKeyBuffer::Interval* srcTimePtr = buffer->GetIntervalBufferPointer();
+//------------------------------------------------------------------------------
+/**
+    Runs on a single thread, the first character with a given pose key evaluates
+    the pose and every other character with the same key copies it. A character
+    whose key collides with one of a different pose evaluates its own.
+*/
+void
+GroupCharacterPoses(SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocationOffset, void* ctx)
+{
+    N_SCOPE(GroupCharacterPoses, Graphics);
+    auto context = static_cast<CharacterJobContext*>(ctx);
+    const SizeT numCharacters = context->entities->Size();
 
-                const Util::FixedArray<AnimCurve>& curves = CoreAnimation::AnimGetCurves(anim);
-                Timing::Tick evalTime = playing.sampleTime % clip.duration;
+    Util::Dictionary<uint64, IndexT> sources;
+    SizeT hits = 0, misses = 0;
+    IndexT i;
+    for (i = 0; i < numCharacters; i++)
+    {
+        context->poseSources[i] = i;
+        if (context->evalModes[i] != EvalMode_Evaluate)
+            continue;
 
-                if (firstAnimTrack
-                    || playing.blend != 1.0f)
-                {
-                    if (sampleMixInfo->sampleType == SampleType::Step)
-                        AnimSampleStep(clip, curves, evalTime, sampleMixInfo->velocityScale, idleSamples, srcPtr, srcTimePtr, playing.curveSampleIndices.Begin(), sampleBuffer.GetSamplesPointer(), sampleBuffer.GetSampleCountsPointer());
-                    else
-                        AnimSampleLinear(clip, curves, evalTime, sampleMixInfo->velocityScale, idleSamples, srcPtr, srcTimePtr, playing.curveSampleIndices.Begin(), sampleBuffer.GetSamplesPointer(), sampleBuffer.GetSampleCountsPointer());
-                }
-                else // Playing with mix
-                {
-                    uchar tmpSampleCounts = 0;
-                    if (sampleMixInfo->sampleType == SampleType::Step)
-                        AnimSampleStep(clip, curves, evalTime, sampleMixInfo->velocityScale, idleSamples, srcPtr, srcTimePtr, tmpSampleIndices, tmpSamples, &tmpSampleCounts);
-                    else
-                        AnimSampleLinear(clip, curves, evalTime, sampleMixInfo->velocityScale, idleSamples, srcPtr, srcTimePtr, tmpSampleIndices, tmpSamples, &tmpSampleCounts);
+        if (context->poseCacheEnabled)
+        {
+            IndexT source = sources.FindIndex(context->poseKeys[i]);
+            if (source == InvalidIndex)
+                sources.Add(context->poseKeys[i], i);
+            else if (PosesMatch(context, sources.ValueAtIndex(source), i))
+            {
+                context->poseSources[i] = sources.ValueAtIndex(source);
+                hits++;
+                continue;
+            }
+        }
+        misses++;
+    }
+    CharacterContext::poseCacheHits = hits;
+    CharacterContext::poseCacheMisses = misses;
+}
 
-                    AnimMix(clip, curves.Size(), playing.mask, sampleMixInfo->mixWeight, sampleBuffer.GetSamplesPointer(), tmpSamples, sampleBuffer.GetSampleCountsPointer(), &tmpSampleCounts, sampleBuffer.GetSamplesPointer(), sampleBuffer.GetSampleCountsPointer());
-                }
+//------------------------------------------------------------------------------
+/**
+    Samples the playing clips and evaluates the skeleton for every character which owns its pose
+*/
+void
+EvalCharacter(SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocationOffset, void* ctx)
+{
+    N_SCOPE(EvalCharacter, Graphics);
+    auto context = static_cast<CharacterJobContext*>(ctx);
+    using namespace CoreAnimation;
+
+    for (IndexT i = 0; i < groupSize; i++)
+    {
+        IndexT index = invocationOffset + i;
+        if (index >= totalJobs)
+            return;
+
+        if (context->evalModes[index] != EvalMode_Evaluate || context->poseSources[index] != index)
+            continue;
+
+        CharacterContext::AnimationTracks& trackController = context->tracks->Get(index);
+        const AnimationId anim = context->anims->Get(index);
+        const Util::FixedArray<SkeletonJobJoint>& jobJoint = context->jobJoints->Get(index);
+        const SkeletonId skeleton = context->skeletons->Get(index);
+        const Util::FixedArray<Math::mat4>& bindPose = Characters::SkeletonGetBindPose(skeleton);
+        const Util::FixedArray<Math::mat4>& jointPalette = context->jointPalettes->Get(index);
+        const Util::FixedArray<Math::mat4>& scaledJointPalette = context->scaledJointPalettes->Get(index);
+        const Util::FixedArray<Math::vec4>& idleSamples = Characters::SkeletonGetIdleSamples(skeleton);
+        const CoreAnimation::AnimSampleBuffer& sampleBuffer = context->sampleBuffers->Get(index);
+        Math::mat4* tmpMatrices = context->tmpJoints[index];
+        float* tmpSamples = context->tmpSamples[index];
+        uint* tmpSampleIndices = context->tmpSampleIndices[index];
+        auto sampleMixInfo = context->animMixInfos + index;
+        const AnimSampleMask* jointMask = GetLodJointMask(context, index);
 
-                // Run skeleton as soon as we have a single anim job queued
-                runSkeletonThisFrame = true;
+        // sample the clip on each track, and mix it with the previous tracks
+        bool firstAnimTrack = true;
+        IndexT j;
+        for (j = 0; j < CharacterContext::MaxNumTracks; j++)
+        {
+            CharacterContext::AnimationRuntime& playing = trackController.playingAnimations[j];
+            if (playing.clip == -1)
+                continue;
+
+            // Need to compute the sample weight and pointers to "before" and "after" keys
+            const CoreAnimation::AnimClip& clip = CoreAnimation::AnimGetClip(anim, playing.clip);
+            const Ptr<AnimKeyBuffer>& buffer = AnimGetBuffer(anim);
+            const Ptr<AnimCompressedBuffer>& compressedBuffer = AnimGetCompressedBuffer(anim);
+
+            // Create scratch memory
+            Memory::Clear(sampleMixInfo, sizeof(AnimSampleMixInfo));
+            sampleMixInfo->sampleType = SampleType::Linear;
+            sampleMixInfo->velocityScale.set(playing.timeFactor, playing.timeFactor, playing.timeFactor, 0);
+
+            const Util::FixedArray<AnimCurve>& curves = CoreAnimation::AnimGetCurves(anim);
+            Timing::Tick evalTime = playing.clipTime;
+
+            // Tracks after the first are sampled into scratch memory and mixed in
+            const bool mix = !(firstAnimTrack || playing.blend != 1.0f);
+            uchar tmpSampleCounts = 0;
+            float* outSamples = mix ? tmpSamples : sampleBuffer.GetSamplesPointer();
+            uchar* outSampleCounts = mix ? &tmpSampleCounts : sampleBuffer.GetSampleCountsPointer();
+
+            // masked joints keep the samples in the output, mixing them with themselves keeps the last pose
+            if (mix && jointMask != nullptr)
+                Memory::Copy(sampleBuffer.GetSamplesPointer(), tmpSamples, sampleBuffer.GetNumSamples() * sizeof(float));
 
-                // flip the first anim track flag, which will trigger the next job to mix
-                firstAnimTrack = false;
+            if (compressedBuffer.isvalid())
+            {
+                if (sampleMixInfo->sampleType == SampleType::Step)
+                    AnimSampleCompressedStep(clip, curves, evalTime, sampleMixInfo->velocityScale, idleSamples, compressedBuffer, outSamples, outSampleCounts, jointMask);
+                else
+                    AnimSampleCompressedLinear(clip, curves, evalTime, sampleMixInfo->velocityScale, idleSamples, compressedBuffer, outSamples, outSampleCounts, jointMask);
             }
+            else
+            {
+                // Get pointers to memory and size
+                const float* srcPtr = buffer->GetKeyBufferPointer();
+                const AnimKeyBuffer::Interval* srcTimePtr = buffer->GetIntervalBufferPointer();
+                uint* outSampleIndices = mix ? tmpSampleIndices : playing.curveSampleIndices.Begin();
 
-        }
+                if (sampleMixInfo->sampleType == SampleType::Step)
+                    AnimSampleStep(clip, curves, evalTime, sampleMixInfo->velocityScale, idleSamples, srcPtr, srcTimePtr, outSampleIndices, outSamples, outSampleCounts, jointMask);
+                else
+                    AnimSampleLinear(clip, curves, evalTime, sampleMixInfo->velocityScale, idleSamples, srcPtr, srcTimePtr, outSampleIndices, outSamples, outSampleCounts, jointMask);
+            }
 
-        // If we have no animations, just skip the character skeleton update
-        if (!runSkeletonThisFrame)
-            continue;
+            if (mix)
+                AnimMix(clip, curves.Size(), playing.mask, sampleMixInfo->mixWeight, sampleBuffer.GetSamplesPointer(), tmpSamples, sampleBuffer.GetSampleCountsPointer(), &tmpSampleCounts, sampleBuffer.GetSamplesPointer(), sampleBuffer.GetSampleCountsPointer());
+
+            // flip the first anim track flag, which will trigger the next job to mix
+            firstAnimTrack = false;
+        }
 
         // Evaluate skeleton
         const Math::mat4* invPoseMatrixBase = bindPose.Begin();
@@ -599,7 +863,7 @@ EvalCharacter(SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocat
         const float* samplesPtr = samplesBase;
 
         Math::mat4* scaledMatrixBase = scaledJointPalette.Begin();
-        Math::mat4* skinMatrixBase = jointPalette.Begin();
+        Math::mat4* skinMatrixBase = GetEvaluationTarget(context, index);
 
         // input samples may optionally include velocity samples which we need to skip...
         uint sampleWidth = (sampleBuffer.GetNumSamples() / jointPalette.Size());
@@ -638,6 +902,56 @@ EvalCharacter(SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocat
 
             skinMatrixBase[jointIndex] = scaledMatrix * invPoseMatrixBase[jointIndex];
         }
+        context->loadStates->Get(index) |= CharacterContext::PoseSampled;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Copies shared poses from the character which evaluated them, and blends the
+    joint palette of characters running at a reduced rate
+*/
+void
+ShareCharacterPoses(SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocationOffset, void* ctx)
+{
+    N_SCOPE(ShareCharacterPoses, Graphics);
+    auto context = static_cast<CharacterJobContext*>(ctx);
+
+    for (IndexT i = 0; i < groupSize; i++)
+    {
+        IndexT index = invocationOffset + i;
+        if (index >= totalJobs)
+            return;
+
+        const uchar mode = context->evalModes[index];
+        if (mode == EvalMode_Skip)
+            continue;
+
+        const Util::FixedArray<Math::mat4>& jointPalette = context->jointPalettes->Get(index);
+        if (mode == EvalMode_Evaluate && context->poseSources[index] != index)
+        {
+            // the samples come along so joints masked in a later evaluation keep the shown pose
+            const IndexT source = context->poseSources[index];
+            const CoreAnimation::AnimSampleBuffer& sampleBuffer = context->sampleBuffers->Get(index);
+            Memory::Copy(context->sampleBuffers->Get(source).GetSamplesPointer(), sampleBuffer.GetSamplesPointer(), sampleBuffer.GetNumSamples() * sizeof(float));
+            Memory::Copy(GetEvaluationTarget(context, source), GetEvaluationTarget(context, index), jointPalette.ByteSize());
+            context->loadStates->Get(index) |= CharacterContext::PoseSampled;
+        }
+
+        const SizeT lodInterval = AnimLodIntervals[context->lods->Get(index)];
+        if (lodInterval > 1)
+        {
+            const Util::FixedArray<Math::mat4>& prevJointPalette = context->prevJointPalettes->Get(index);
+            const Util::FixedArray<Math::mat4>& nextJointPalette = context->nextJointPalettes->Get(index);
+
+            // with nothing playing the pose is held
+            if (mode == EvalMode_Hold)
+                Memory::Copy(prevJointPalette.Begin(), nextJointPalette.Begin(), prevJointPalette.ByteSize());
+
+            const IndexT lodPhase = (context->frameIndex + index) % lodInterval;
+            const float lodBlend = (lodPhase + 1) / float(lodInterval);
+            LerpJointPalette(prevJointPalette.Begin(), nextJointPalette.Begin(), lodBlend, jointPalette.Begin(), jointPalette.Size());
+        }
     }
 }
 
@@ -661,6 +975,11 @@ CharacterContext::UpdateAnimations(const Graphics::FrameContext& ctx)
     const Util::Array<Graphics::GraphicsEntityId>& models = characterContextAllocator.GetArray<EntityId>();
     const Util::Array<bool>& supportsBlending = characterContextAllocator.GetArray<SupportMix>();
     const Util::Array<IndexT>& characterSkinNodeIndices = characterContextAllocator.GetArray<CharacterSkinNodeIndexOffset>();
+    Util::Array<LoadState>& loadStates = characterContextAllocator.GetArray<Loaded>();
+    Util::Array<AnimationLod>& lods = characterContextAllocator.GetArray<AnimLod>();
+    const Util::Array<const CoreAnimation::AnimSampleMask*>& lodJointMasks = characterContextAllocator.GetArray<AnimLodJointMask>();
+    const Util::Array<Util::FixedArray<Math::mat4>>& prevJointPalettes = characterContextAllocator.GetArray<JointPalettePrev>();
+    const Util::Array<Util::FixedArray<Math::mat4>>& nextJointPalettes = characterContextAllocator.GetArray<JointPaletteNext>();
 
     if (!models.IsEmpty())
     {
@@ -681,21 +1000,65 @@ CharacterContext::UpdateAnimations(const Graphics::FrameContext& ctx)
         charCtx.scaledJointPalettes = &scaledJointPalettes;
         charCtx.userJoints = &userJoints;
         charCtx.entities = &models;
+        charCtx.loadStates = &loadStates;
+        charCtx.lods = &lods;
+        charCtx.lodJointMasks = &lodJointMasks;
+        charCtx.prevJointPalettes = &prevJointPalettes;
+        charCtx.nextJointPalettes = &nextJointPalettes;
         charCtx.frameTime = ctx.frameTime;
         charCtx.ticks = ctx.ticks;
         charCtx.time = ctx.time;
+        charCtx.frameIndex = ctx.frameIndex;
+        charCtx.poseCacheEnabled = poseCacheEnabled;
+        charCtx.poseCacheTimeQuantum = poseCacheTimeQuantum;
+        charCtx.evalModes = Jobs2::JobAlloc<uchar>(models.Size());
+        charCtx.poseKeys = Jobs2::JobAlloc<uint64>(models.Size());
+        charCtx.poseSources = Jobs2::JobAlloc<IndexT>(models.Size());
         charCtx.animMixInfos = Jobs2::JobAlloc<AnimSampleMixInfo>(models.Size());
 
         charCtx.tmpJoints = Jobs2::JobAlloc<Math::mat4*>(models.Size());
         charCtx.tmpSampleIndices = Jobs2::JobAlloc<uint*>(models.Size());
         charCtx.tmpSamples = Jobs2::JobAlloc<float*>(models.Size());
 
+        const Models::ModelContext::ModelInstance::Renderable& renderables = Models::ModelContext::GetModelRenderables();
+        const Math::vec4 cameraPosition = Graphics::CameraContext::GetTransform(Graphics::CameraContext::GetLODCamera()).position;
+
         IndexT i;
         for (i = 0; i < models.Size(); i++)
         {
             if (models[i] == Graphics::InvalidGraphicsEntityId)
                 continue;
 
+            if (!animLodEnabled)
+                lods[i] = FullRate;
+            else
+            {
+                // Characters are frozen as soon as no observer has seen their skin in the last frames
+                const Models::NodeInstanceRange& range = Models::ModelContext::GetModelRenderableRange(models[i]);
+                const IndexT skinNode = range.begin + characterSkinNodeIndices[i];
+                const Models::NodeInstanceFlags visibleBits = Models::NodeInstanceFlags::NodeInstance_Visible | Models::NodeInstanceFlags::NodeInstance_WasVisible;
+                const bool visible = skinNode >= range.end || AnyBits(renderables.nodeFlags[skinNode], visibleBits);
+
+                if (!visible)
+                    lods[i] = Frozen;
+                else if (lods[i] == Frozen || (i % AnimLodStaggerFrames) == (ctx.frameIndex % AnimLodStaggerFrames))
+                {
+                    // Distance LODs are only reassigned for a slice of the characters every frame
+                    const Math::vec4 viewVector = Models::ModelContext::GetTransform(models[i]).position - cameraPosition;
+                    const float distance = Math::length(viewVector);
+                    if (distance >= animLodQuarterRateDistance)
+                        lods[i] = QuarterRate;
+                    else if (distance >= animLodHalfRateDistance)
+                        lods[i] = HalfRate;
+                    else
+                        lods[i] = FullRate;
+                }
+            }
+
+            // Skip scratch memory for characters which aren't evaluated this frame
+            if (lods[i] == Frozen || ((ctx.frameIndex + i) % AnimLodIntervals[lods[i]]) != 0)
+                continue;
+
             // Allocate scratch memory for character transforms
             const Util::FixedArray<Math::mat4>& jointPalette = jointPalettes[i];
             charCtx.tmpJoints[i] = Jobs2::JobAlloc<Math::mat4>(jointPalette.Size());
@@ -709,8 +1072,13 @@ CharacterContext::UpdateAnimations(const Graphics::FrameContext& ctx)
             }
         }
 
-        // Run job
-        Jobs2::JobDispatch(EvalCharacter, models.Size(), 64, charCtx, nullptr, &animationCounter, nullptr);
+        // Update tracks, find characters sharing a pose, evaluate the unique poses and hand them out
+        Jobs2::JobBeginSequence(nullptr, &animationCounter, nullptr);
+        Jobs2::JobAppendSequence(UpdateCharacterTracks, models.Size(), 64, charCtx);
+        Jobs2::JobAppendSequence(GroupCharacterPoses, 1, charCtx);
+        Jobs2::JobAppendSequence(EvalCharacter, models.Size(), 64, charCtx);
+        Jobs2::JobAppendSequence(ShareCharacterPoses, models.Size(), 64, charCtx);
+        Jobs2::JobEndSequence();
 
         n_assert(ConstantUpdateCounter == 0);
         ConstantUpdateCounter = 1;
@@ -800,6 +1168,76 @@ CharacterContext::GetAnimSampleMask(const Util::StringAtom& name)
     return &CharacterContext::masks.ValueAtIndex(name, index);
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CharacterContext::SetAnimationLodEnabled(bool enabled)
+{
+    CharacterContext::animLodEnabled = enabled;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CharacterContext::SetAnimationLodDistances(const float halfRateDistance, const float quarterRateDistance)
+{
+    n_assert(halfRateDistance <= quarterRateDistance);
+    CharacterContext::animLodHalfRateDistance = halfRateDistance;
+    CharacterContext::animLodQuarterRateDistance = quarterRateDistance;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CharacterContext::SetAnimationLodJointMask(const Graphics::GraphicsEntityId id, const CoreAnimation::AnimSampleMask* mask)
+{
+    const ContextEntityId cid = GetContextId(id);
+    characterContextAllocator.Set<AnimLodJointMask>(cid.id, mask);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+AnimationLod
+CharacterContext::GetAnimationLod(const Graphics::GraphicsEntityId id)
+{
+    const ContextEntityId cid = GetContextId(id);
+    return characterContextAllocator.Get<AnimLod>(cid.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CharacterContext::SetPoseCacheEnabled(bool enabled)
+{
+    CharacterContext::poseCacheEnabled = enabled;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CharacterContext::SetPoseCacheTimeQuantum(const Timing::Tick quantum)
+{
+    n_assert(quantum >= 0);
+    CharacterContext::poseCacheTimeQuantum = quantum;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Only valid after the character jobs of the frame have been waited for
+*/
+void
+CharacterContext::GetPoseCacheStats(SizeT& outHits, SizeT& outMisses)
+{
+    outHits = CharacterContext::poseCacheHits;
+    outMisses = CharacterContext::poseCacheMisses;
+}
+
 #ifndef PUBLIC_BUILD 
 //------------------------------------------------------------------------------
 /**
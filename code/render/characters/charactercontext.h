@@ -21,6 +21,19 @@
         Animations can be played without enqueueing, which replaces the currently
         playing animation on that track.
 
+    Characters are also assigned an animation LOD. Characters which no observer has
+    seen are frozen, the others are evaluated at full, half or quarter rate depending
+    on the distance to the LOD camera, and in between evaluations the joint palette is
+    interpolated towards the last evaluated pose. Distance LODs are reassigned for a
+    slice of the characters each frame to spread the work, and characters at quarter
+    rate only sample the joints enabled in their LOD joint mask.
+
+    Evaluated poses are shared through a pose cache. Every frame, characters are keyed
+    by their skeleton, animation, clips, clip times, blend weights and masks, and only
+    the first character with a given key samples and evaluates its skeleton, the others
+    copy the resulting joint palette. Clip times can be snapped to a quantum to let
+    crowds playing the same clip slightly out of phase share their pose.
+
 
     @copyright
     (C) 2018-2020 Individual contributors, see AUTHORS file
@@ -54,6 +67,14 @@ enum EnqueueMode
     IgnoreIfSame        // ignore enqueue if same clip is playing
 };
 
+enum AnimationLod
+{
+    FullRate,           // evaluate every frame
+    HalfRate,           // evaluate every second frame and interpolate in between
+    QuarterRate,        // evaluate every fourth frame and interpolate in between, only sample the LOD joint mask
+    Frozen              // not visible, keep the current joint palette
+};
+
 class CharacterContext : public Graphics::GraphicsContext
 {
     __DeclareContext();
@@ -127,6 +148,22 @@ public:
     /// get anim sample mask by name
     static CoreAnimation::AnimSampleMask* GetAnimSampleMask(const Util::StringAtom& name);
 
+    /// enable or disable animation LOD, if disabled all characters are evaluated every frame
+    static void SetAnimationLodEnabled(bool enabled);
+    /// set the distances to the LOD camera from which characters are evaluated at half and quarter rate
+    static void SetAnimationLodDistances(const float halfRateDistance, const float quarterRateDistance);
+    /// set the mask of joints sampled at quarter rate, joints with a zero weight keep their last evaluated pose
+    static void SetAnimationLodJointMask(const Graphics::GraphicsEntityId id, const CoreAnimation::AnimSampleMask* mask);
+    /// get the animation LOD currently assigned to a character
+    static AnimationLod GetAnimationLod(const Graphics::GraphicsEntityId id);
+
+    /// enable or disable sharing evaluated poses between characters
+    static void SetPoseCacheEnabled(bool enabled);
+    /// set the quantum clip times are snapped to before looking up the pose cache, 0 disables snapping
+    static void SetPoseCacheTimeQuantum(const Timing::Tick quantum);
+    /// get the number of poses shared (hits) and evaluated (misses) in the last frame
+    static void GetPoseCacheStats(SizeT& outHits, SizeT& outMisses);
+
 #ifndef PUBLIC_DEBUG    
     /// debug rendering
     static void OnRenderDebug(uint32_t flags);
@@ -137,6 +174,7 @@ public:
         NoneLoaded = 0,
         SkeletonLoaded = N_BIT(1),
         AnimationLoaded = N_BIT(2),
+        PoseSampled = N_BIT(3),         // the sample buffer holds a complete pose
     };
 
     static Threading::AtomicCounter ConstantUpdateCounter;
@@ -152,6 +190,7 @@ private:
         Timing::Tick fadeInTime, fadeOutTime;
         Timing::Tick evalTime, prevEvalTime;
         Timing::Tick sampleTime, prevSampleTime;
+        Timing::Tick clipTime;
         Timing::Tick timeOffset;
         Util::Array<uint> curveSampleIndices;
         const CoreAnimation::AnimSampleMask* mask;
@@ -166,9 +205,12 @@ private:
     friend const bool IsExpired(const CharacterContext::AnimationRuntime& runtime, const Timing::Time time);
     friend const bool IsInfinite(const CharacterContext::AnimationRuntime& runtime);
     friend Timing::Tick GetAbsoluteStopTime(const CharacterContext::AnimationRuntime& runtime);
+    friend void UpdateCharacterTracks(SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocationOffset, void* ctx);
+    friend void GroupCharacterPoses(SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocationOffset, void* ctx);
     friend void EvalCharacter(SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocationOffset, void* ctx);
 
     static const SizeT MaxNumTracks = 16;
+    static const SizeT AnimLodStaggerFrames = 8;
     struct AnimationTracks
     {
         Util::StackArray<AnimationRuntime, 8>   pendingAnimations[MaxNumTracks]; // max 16 tracks
@@ -189,7 +231,11 @@ private:
         SampleBuffer,
         SupportMix,
         EntityId,
-        CharacterSkinNodeIndexOffset
+        CharacterSkinNodeIndexOffset,
+        AnimLod,
+        AnimLodJointMask,
+        JointPalettePrev,
+        JointPaletteNext
     };
 
     typedef Ids::IdAllocator<
@@ -205,7 +251,11 @@ private:
         CoreAnimation::AnimSampleBuffer,
         bool,
         Graphics::GraphicsEntityId,
-        IndexT
+        IndexT,
+        AnimationLod,
+        const CoreAnimation::AnimSampleMask*,
+        Util::FixedArray<Math::mat4>,           // pose shown when the last evaluation started
+        Util::FixedArray<Math::mat4>            // last evaluated pose
     > CharacterContextAllocator;
     static CharacterContextAllocator characterContextAllocator;
 
@@ -216,6 +266,15 @@ private:
 
     static Util::HashTable<Util::StringAtom, CoreAnimation::AnimSampleMask> masks;
     static Threading::Event totalCompletionEvent;
+
+    static bool animLodEnabled;
+    static float animLodHalfRateDistance;
+    static float animLodQuarterRateDistance;
+
+    static bool poseCacheEnabled;
+    static Timing::Tick poseCacheTimeQuantum;
+    static SizeT poseCacheHits;
+    static SizeT poseCacheMisses;
 };
 
 __ImplementEnumBitOperators(CharacterContext::LoadState);
@@ -22,6 +22,7 @@ CreateAnimation(const AnimationCreateInfo& info)
     animAllocator.Set<Anim_Events>(id, info.events);
     animAllocator.Set<Anim_ClipIndices>(id, info.indices);
     animAllocator.Set<Anim_KeyBuffer>(id, info.keyBuffer);
+    animAllocator.Set<Anim_CompressedBuffer>(id, info.compressedBuffer);
 
     AnimationId ret = id;
     return ret;
@@ -36,8 +37,12 @@ void DestroyAnimation(const AnimationId id)
     animAllocator.Get<Anim_Curves>(id.id).Clear();
     animAllocator.Get<Anim_Events>(id.id).Clear();
     animAllocator.Get<Anim_ClipIndices>(id.id).Clear();
-    animAllocator.Get<Anim_KeyBuffer>(id.id)->Discard();
+    if (animAllocator.Get<Anim_KeyBuffer>(id.id).isvalid())
+        animAllocator.Get<Anim_KeyBuffer>(id.id)->Discard();
     animAllocator.Set<Anim_KeyBuffer>(id.id, nullptr);
+    if (animAllocator.Get<Anim_CompressedBuffer>(id.id).isvalid())
+        animAllocator.Get<Anim_CompressedBuffer>(id.id)->Discard();
+    animAllocator.Set<Anim_CompressedBuffer>(id.id, nullptr);
     animAllocator.Dealloc(id.id);
 }
 
@@ -68,6 +73,15 @@ AnimGetBuffer(const AnimationId& id)
     return animAllocator.Get<Anim_KeyBuffer>(id.id);
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+const Ptr<AnimCompressedBuffer>&
+AnimGetCompressedBuffer(const AnimationId& id)
+{
+    return animAllocator.Get<Anim_CompressedBuffer>(id.id);
+}
+
 //------------------------------------------------------------------------------
 /**
 */
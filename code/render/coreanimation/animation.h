@@ -16,6 +16,7 @@
 #include "ids/idallocator.h"
 #include "coreanimation/animclip.h"
 #include "coreanimation/animkeybuffer.h"
+#include "coreanimation/animcompressedbuffer.h"
 #include "coreanimation/animsamplemask.h"
 
 //------------------------------------------------------------------------------
@@ -45,7 +46,8 @@ extern void AnimSampleStep(
     const AnimKeyBuffer::Interval* intervalPtr,
     uint* outSampleKeyPtr,
     float* outSamplePtr,
-    uchar* outSampleCounts
+    uchar* outSampleCounts,
+    const AnimSampleMask* jointMask = nullptr
 );
 
 //------------------------------------------------------------------------------
@@ -61,7 +63,40 @@ extern void AnimSampleLinear(
     const AnimKeyBuffer::Interval* intervalPtr,
     uint* outSampleKeyPtr,
     float* outSamplePtr,
-    uchar* outSampleCounts
+    uchar* outSampleCounts,
+    const AnimSampleMask* jointMask = nullptr
+);
+
+//------------------------------------------------------------------------------
+/**
+    Samples a compressed clip by taking the key at or before the sample time
+*/
+extern void AnimSampleCompressedStep(
+    const AnimClip& clip,
+    const Util::FixedArray<AnimCurve>& curves,
+    const Timing::Tick time,
+    const Math::vec4& velocityScale,
+    const Util::FixedArray<Math::vec4>& idleSamples,
+    const AnimCompressedBuffer* buffer,
+    float* outSamplePtr,
+    uchar* outSampleCounts,
+    const AnimSampleMask* jointMask = nullptr
+);
+
+//------------------------------------------------------------------------------
+/**
+    Samples a compressed clip by interpolating the keys around the sample time
+*/
+extern void AnimSampleCompressedLinear(
+    const AnimClip& clip,
+    const Util::FixedArray<AnimCurve>& curves,
+    const Timing::Tick time,
+    const Math::vec4& velocityScale,
+    const Util::FixedArray<Math::vec4>& idleSamples,
+    const AnimCompressedBuffer* buffer,
+    float* outSamplePtr,
+    uchar* outSampleCounts,
+    const AnimSampleMask* jointMask = nullptr
 );
 
 //------------------------------------------------------------------------------
@@ -87,6 +122,7 @@ struct AnimationCreateInfo
     Util::FixedArray<AnimEvent> events;
     Util::HashTable<Util::StringAtom, IndexT, 32> indices;
     Ptr<AnimKeyBuffer> keyBuffer;
+    Ptr<AnimCompressedBuffer> compressedBuffer;
 };
 
 /// Create animation resource
@@ -100,6 +136,8 @@ const Util::FixedArray<AnimClip>& AnimGetClips(const AnimationId& id);
 const AnimClip& AnimGetClip(const AnimationId& id, const IndexT index);
 /// Get anim buffer
 const Ptr<AnimKeyBuffer>& AnimGetBuffer(const AnimationId& id);
+/// Get compressed key buffer, invalid if the animation is not compressed
+const Ptr<AnimCompressedBuffer>& AnimGetCompressedBuffer(const AnimationId& id);
 /// Get curves
 const Util::FixedArray<AnimCurve>& AnimGetCurves(const AnimationId& id);
 /// Get anim clip index
@@ -111,7 +149,8 @@ enum
     Anim_Curves,
     Anim_Events,
     Anim_ClipIndices,
-    Anim_KeyBuffer
+    Anim_KeyBuffer,
+    Anim_CompressedBuffer
 };
 
 typedef Ids::IdAllocator<
@@ -119,7 +158,8 @@ typedef Ids::IdAllocator<
     Util::FixedArray<AnimCurve>,
     Util::FixedArray<AnimEvent>,
     Util::HashTable<Util::StringAtom, IndexT, 32>,
-    Ptr<AnimKeyBuffer>
+    Ptr<AnimKeyBuffer>,
+    Ptr<AnimCompressedBuffer>
 > AnimAllocator;
 extern AnimAllocator animAllocator;
 
@@ -18,14 +18,193 @@ using namespace Util;
 using namespace System;
 using namespace Math;
 
+//------------------------------------------------------------------------------
+/**
+*/
+static void
+ReadEvents(uchar*& ptr, const SizeT numEvents, Util::FixedArray<AnimEvent>& events)
+{
+    if (numEvents > 0)
+    {
+        events.SetSize(numEvents);
+        for (IndexT eventIndex = 0; eventIndex < numEvents; eventIndex++)
+        {
+            Nax3AnimEvent* naxEvent = (Nax3AnimEvent*)ptr;
+            ptr += sizeof(Nax3AnimEvent);
+
+            AnimEvent& event = events[eventIndex];
+            event.name = naxEvent->name;
+            event.category = naxEvent->category;
+            event.time = naxEvent->keyIndex;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template <typename CLIP>
+static void
+SetupClip(const CLIP* naxClip, const Util::FixedArray<AnimEvent>& events, AnimClip& clip)
+{
+    clip.SetName(naxClip->name);
+    clip.firstCurve = naxClip->firstCurve;
+    clip.numCurves = naxClip->numCurves;
+    clip.firstEvent = naxClip->firstEvent;
+    clip.numEvents = naxClip->numEvents;
+    clip.firstVelocityCurve = naxClip->firstVelocityCurve;
+    clip.numVelocityCurves = naxClip->numVelocityCurves;
+    clip.duration = naxClip->duration;
+
+    for (IndexT i = 0; i < naxClip->numEvents; i++)
+        clip.eventIndexMap.Add(events[naxClip->firstEvent + i].name, naxClip->firstEvent + i);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static AnimationId
+LoadNax3Animation(uchar*& ptr)
+{
+    Nax3Anim* anim = (Nax3Anim*)ptr;
+    ptr += sizeof(Nax3Anim);
+
+    Util::HashTable<Util::StringAtom, IndexT, 32> clipIndices;
+    Util::FixedArray<AnimCurve> curves;
+    if (anim->numCurves > 0)
+    {
+        curves.SetSize(anim->numCurves);
+        for (IndexT curveIndex = 0; curveIndex < anim->numCurves; curveIndex++)
+        {
+            Nax3Curve* naxCurve = (Nax3Curve*)ptr;
+            ptr += sizeof(Nax3Curve);
+
+            AnimCurve& curve = curves[curveIndex];
+            curve.firstIntervalOffset = naxCurve->firstIntervalOffset;
+            curve.numIntervals = naxCurve->numIntervals;
+            curve.preInfinityType = (CoreAnimation::InfinityType::Code)naxCurve->preInfinityType;
+            curve.postInfinityType = (CoreAnimation::InfinityType::Code)naxCurve->postInfinityType;
+            curve.curveType = (CoreAnimation::CurveType::Code)naxCurve->curveType;
+        }
+    }
+
+    Util::FixedArray<AnimEvent> events;
+    ReadEvents(ptr, anim->numEvents, events);
+
+    Util::FixedArray<AnimClip> clips;
+    if (anim->numClips > 0)
+    {
+        // setup animation clips
+        clips.SetSize(anim->numClips);
+        for (IndexT clipIndex = 0; clipIndex < anim->numClips; clipIndex++)
+        {
+            Nax3Clip* naxClip = (Nax3Clip*)ptr;
+            ptr += sizeof(Nax3Clip);
+
+            // setup anim clip object
+            SetupClip(naxClip, events, clips[clipIndex]);
+            clipIndices.Add(naxClip->name, clipIndex);
+        }
+    }
+
+    // Load keys
+    Ptr<AnimKeyBuffer> keyBuffer = AnimKeyBuffer::Create();
+    keyBuffer->Setup(anim->numIntervals, anim->numKeys, ptr, ptr + sizeof(Nax3Interval) * anim->numIntervals);
+
+    // Advance pointer by keys and timings
+    ptr += anim->numKeys * sizeof(float) + anim->numIntervals * sizeof(AnimKeyBuffer::Interval);
+
+    // Create animation
+    AnimationCreateInfo info;
+    info.clips = clips;
+    info.curves = curves;
+    info.events = events;
+    info.indices = clipIndices;
+    info.keyBuffer = keyBuffer;
+    return CreateAnimation(info);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static AnimationId
+LoadNaxcAnimation(uchar*& ptr)
+{
+    NaxcAnim* anim = (NaxcAnim*)ptr;
+    ptr += sizeof(NaxcAnim);
+
+    // curves keep the range of their quantized keys, which goes into the compressed buffer once it exists
+    const NaxcCurve* naxCurves = (const NaxcCurve*)ptr;
+    ptr += sizeof(NaxcCurve) * anim->numCurves;
+
+    Util::HashTable<Util::StringAtom, IndexT, 32> clipIndices;
+    Util::FixedArray<AnimCurve> curves;
+    if (anim->numCurves > 0)
+    {
+        curves.SetSize(anim->numCurves);
+        for (IndexT curveIndex = 0; curveIndex < anim->numCurves; curveIndex++)
+        {
+            const NaxcCurve* naxCurve = naxCurves + curveIndex;
+            AnimCurve& curve = curves[curveIndex];
+            curve.firstIntervalOffset = 0;
+            curve.numIntervals = naxCurve->numKeys > 0 ? naxCurve->numKeys - 1 : 0;
+            curve.preInfinityType = (CoreAnimation::InfinityType::Code)naxCurve->preInfinityType;
+            curve.postInfinityType = (CoreAnimation::InfinityType::Code)naxCurve->postInfinityType;
+            curve.curveType = (CoreAnimation::CurveType::Code)naxCurve->curveType;
+        }
+    }
+
+    Util::FixedArray<AnimEvent> events;
+    ReadEvents(ptr, anim->numEvents, events);
+
+    Util::FixedArray<AnimClip> clips;
+    if (anim->numClips > 0)
+    {
+        clips.SetSize(anim->numClips);
+        for (IndexT clipIndex = 0; clipIndex < anim->numClips; clipIndex++)
+        {
+            NaxcClip* naxClip = (NaxcClip*)ptr;
+            ptr += sizeof(NaxcClip);
+
+            AnimClip& clip = clips[clipIndex];
+            SetupClip(naxClip, events, clip);
+            clip.firstSegment = naxClip->firstSegment;
+            clip.numSegments = naxClip->numSegments;
+            clip.segmentDuration = naxClip->segmentDuration;
+            clipIndices.Add(naxClip->name, clipIndex);
+        }
+    }
+
+    // Load segments and their keys
+    Ptr<AnimCompressedBuffer> compressedBuffer = AnimCompressedBuffer::Create();
+    compressedBuffer->Setup(anim->numCurves, anim->numSegments, anim->segmentDataSize, ptr, ptr + sizeof(NaxcSegment) * anim->numSegments);
+    for (IndexT curveIndex = 0; curveIndex < anim->numCurves; curveIndex++)
+    {
+        AnimCompressedBuffer::CurveRange& range = compressedBuffer->GetCurveRange(curveIndex);
+        Memory::Copy(naxCurves[curveIndex].rangeMin, range.min, sizeof(range.min));
+        Memory::Copy(naxCurves[curveIndex].rangeExtent, range.extent, sizeof(naxCurves[curveIndex].rangeExtent));
+        range.extent[3] = 0.0f;
+    }
+
+    // Advance pointer by segments and their keys
+    ptr += anim->numSegments * sizeof(NaxcSegment) + anim->segmentDataSize;
+
+    // Create animation
+    AnimationCreateInfo info;
+    info.clips = clips;
+    info.curves = curves;
+    info.events = events;
+    info.indices = clipIndices;
+    info.compressedBuffer = compressedBuffer;
+    return CreateAnimation(info);
+}
+
 //------------------------------------------------------------------------------
 /**
 */
 Resources::ResourceUnknownId
 AnimationLoader::InitializeResource(const Ids::Id32 entry, const Util::StringAtom& tag, const Ptr<IO::Stream>& stream, bool immediate)
 {
-    Ptr<AnimKeyBuffer> keyBuffer = nullptr;
-    
     // map buffer
     uchar* ptr = (uchar*)stream->Map();
 
@@ -33,8 +212,9 @@ AnimationLoader::InitializeResource(const Ids::Id32 entry, const Util::StringAto
     Nax3Header* naxHeader = (Nax3Header*)ptr;
     ptr += sizeof(Nax3Header);
 
-    // check magic value
-    if (FourCC(naxHeader->magic) != NEBULA_NAX3_MAGICNUMBER)
+    // check magic value, animations are either stored as raw keys (NAX3) or compressed (NAXC)
+    const FourCC magic = FourCC(naxHeader->magic);
+    if (magic != NEBULA_NAX3_MAGICNUMBER && magic != NEBULA_NAXC_MAGICNUMBER)
     {
         n_error("StreamAnimationLoader::InitializeResource(): '%s' has invalid file format (magic number doesn't match)!", stream->GetURI().AsString().AsCharPtr());
         return Resources::InvalidResourceUnknownId;
@@ -45,88 +225,10 @@ AnimationLoader::InitializeResource(const Ids::Id32 entry, const Util::StringAto
     animations.Fill(InvalidAnimationId);
     for (IndexT animationIndex = 0; animationIndex < naxHeader->numAnimations; animationIndex++)
     {
-        Nax3Anim* anim = (Nax3Anim*)ptr;
-        ptr += sizeof(Nax3Anim);
-
-        Util::HashTable<Util::StringAtom, IndexT, 32> clipIndices;
-        Util::FixedArray<AnimCurve> curves;
-        if (anim->numCurves > 0)
-        {
-            curves.SetSize(anim->numCurves);
-            for (IndexT curveIndex = 0; curveIndex < anim->numCurves; curveIndex++)
-            {
-                Nax3Curve* naxCurve = (Nax3Curve*)ptr;
-                ptr += sizeof(Nax3Curve);
-
-                AnimCurve& curve = curves[curveIndex];
-                curve.firstIntervalOffset = naxCurve->firstIntervalOffset;
-                curve.numIntervals = naxCurve->numIntervals;
-                curve.preInfinityType = (CoreAnimation::InfinityType::Code)naxCurve->preInfinityType;
-                curve.postInfinityType = (CoreAnimation::InfinityType::Code)naxCurve->postInfinityType;
-                curve.curveType = (CoreAnimation::CurveType::Code)naxCurve->curveType;
-            }
-        }
-
-        Util::FixedArray<AnimEvent> events;
-        if (anim->numEvents > 0)
-        {
-            events.SetSize(anim->numEvents);
-            for (IndexT eventIndex = 0; eventIndex < anim->numEvents; eventIndex++)
-            {
-                Nax3AnimEvent* naxEvent = (Nax3AnimEvent*)ptr;
-                ptr += sizeof(Nax3AnimEvent);
-
-                AnimEvent& event = events[eventIndex];
-                event.name = naxEvent->name;
-                event.category = naxEvent->category;
-                event.time = naxEvent->keyIndex;
-            }
-        }
-
-        Util::FixedArray<AnimClip> clips;
-        if (anim->numClips > 0)
-        {
-            // setup animation clips
-            clips.SetSize(anim->numClips);
-            for (IndexT clipIndex = 0; clipIndex < anim->numClips; clipIndex++)
-            {
-                Nax3Clip* naxClip = (Nax3Clip*)ptr;
-                ptr += sizeof(Nax3Clip);
-
-                // setup anim clip object
-                AnimClip& clip = clips[clipIndex];
-                clip.SetName(naxClip->name);
-                clip.firstCurve = naxClip->firstCurve;
-                clip.numCurves = naxClip->numCurves;
-                clip.firstEvent = naxClip->firstEvent;
-                clip.numEvents = naxClip->numEvents;
-                clip.firstVelocityCurve = naxClip->firstVelocityCurve;
-                clip.numVelocityCurves = naxClip->numVelocityCurves;
-                clip.duration = naxClip->duration;
-                clip.SetName(naxClip->name);
-
-                for (IndexT i = 0; i < naxClip->numEvents; i++)
-                    clip.eventIndexMap.Add(events[naxClip->firstEvent + i].name, naxClip->firstEvent + i);
-                clipIndices.Add(naxClip->name, clipIndex);
-            }
-        }
-
-        // Load keys
-        keyBuffer = AnimKeyBuffer::Create();
-        keyBuffer->Setup(anim->numIntervals, anim->numKeys, ptr, ptr + sizeof(Nax3Interval) * anim->numIntervals);
-
-        // Advance pointer by keys and timings
-        ptr += anim->numKeys * sizeof(float) + anim->numIntervals * sizeof(AnimKeyBuffer::Interval);
-
-        // Create animation
-        AnimationCreateInfo info;
-        info.clips = clips;
-        info.curves = curves;
-        info.events = events;
-        info.indices = clipIndices;
-        info.keyBuffer = keyBuffer;
-        AnimationId animid = CreateAnimation(info);
-        animations[animationIndex] = animid;
+        if (magic == NEBULA_NAXC_MAGICNUMBER)
+            animations[animationIndex] = LoadNaxcAnimation(ptr);
+        else
+            animations[animationIndex] = LoadNax3Animation(ptr);
     }
 
     // unmap memory
@@ -22,6 +22,9 @@ AnimClip::AnimClip()
     , numVelocityCurves(0)
     , firstVelocityCurve(0)
     , duration(0)
+    , firstSegment(0)
+    , numSegments(0)
+    , segmentDuration(0)
 {
     // empty
 }
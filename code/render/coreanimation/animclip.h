@@ -42,6 +42,9 @@ public:
     IndexT firstVelocityCurve;
 
     Timing::Tick duration;
+    IndexT firstSegment;                // compressed animations only
+    SizeT numSegments;
+    Timing::Tick segmentDuration;
     Util::Dictionary<Util::StringAtom, IndexT> eventIndexMap;
 };
 
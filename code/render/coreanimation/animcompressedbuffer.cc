@@ -0,0 +1,72 @@
+//------------------------------------------------------------------------------
+//  animcompressedbuffer.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "coreanimation/animcompressedbuffer.h"
+
+namespace CoreAnimation
+{
+__ImplementClass(CoreAnimation::AnimCompressedBuffer, 'ANCB', Core::RefCounted);
+
+//------------------------------------------------------------------------------
+/**
+*/
+AnimCompressedBuffer::AnimCompressedBuffer()
+    : numCurves(0)
+    , numSegments(0)
+    , dataSize(0)
+    , curveRanges(nullptr)
+    , segments(nullptr)
+    , data(nullptr)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+AnimCompressedBuffer::~AnimCompressedBuffer()
+{
+    if (this->IsValid())
+    {
+        this->Discard();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AnimCompressedBuffer::Setup(SizeT numCurves, SizeT numSegments, SizeT dataSize, void* segmentPtr, void* dataPtr)
+{
+    n_assert(!this->IsValid());
+    this->numCurves = numCurves;
+    this->numSegments = numSegments;
+    this->dataSize = dataSize;
+    this->curveRanges = (CurveRange*)Memory::Alloc(Memory::ResourceHeap, sizeof(CurveRange) * Math::max(1, this->numCurves));
+    Memory::Clear(this->curveRanges, sizeof(CurveRange) * this->numCurves);
+    this->segments = (Segment*)Memory::Alloc(Memory::ResourceHeap, sizeof(Segment) * Math::max(1, this->numSegments));
+    Memory::Copy(segmentPtr, this->segments, sizeof(Segment) * this->numSegments);
+    this->data = (uchar*)Memory::Alloc(Memory::ResourceHeap, Math::max(1, this->dataSize));
+    Memory::Copy(dataPtr, this->data, this->dataSize);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AnimCompressedBuffer::Discard()
+{
+    n_assert(this->IsValid());
+    Memory::Free(Memory::ResourceHeap, this->curveRanges);
+    this->curveRanges = nullptr;
+    Memory::Free(Memory::ResourceHeap, this->segments);
+    this->segments = nullptr;
+    Memory::Free(Memory::ResourceHeap, this->data);
+    this->data = nullptr;
+    this->numCurves = 0;
+    this->numSegments = 0;
+    this->dataSize = 0;
+}
+
+} // namespace CoreAnimation
@@ -0,0 +1,125 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class CoreAnimation::AnimCompressedBuffer
+    
+    Holds the keys of a compressed animation. Curves keep the range their keys
+    are quantized in, and the keys of each clip are cut into time segments which
+    are laid out contiguously, so sampling a clip only touches the block of the
+    segment the sample time falls into. See NaxcCurve for the layout of a segment.
+    
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "core/refcounted.h"
+#include "timing/time.h"
+
+//------------------------------------------------------------------------------
+namespace CoreAnimation
+{
+class AnimCompressedBuffer : public Core::RefCounted
+{
+    __DeclareClass(AnimCompressedBuffer);
+public:
+    struct CurveRange
+    {
+        float min[4];
+        float extent[4];
+    };
+
+    struct Segment
+    {
+        Timing::Tick start, end;
+        uint dataOffset;
+        uint numKeys;
+    };
+
+    /// constructor
+    AnimCompressedBuffer();
+    /// destructor
+    virtual ~AnimCompressedBuffer();
+
+    /// setup the buffer
+    void Setup(SizeT numCurves, SizeT numSegments, SizeT dataSize, void* segmentPtr, void* dataPtr);
+    /// discard the buffer
+    void Discard();
+    /// return true if the object has been setup
+    bool IsValid() const;
+    /// get buffer size in bytes
+    SizeT GetByteSize() const;
+
+    /// get curve range, to be filled in after setup
+    CurveRange& GetCurveRange(IndexT curveIndex);
+    /// get direct pointer to curve ranges
+    const CurveRange* GetCurveRangePointer() const;
+    /// get direct pointer to segments
+    const Segment* GetSegmentPointer() const;
+    /// get direct pointer to segment data
+    const uchar* GetDataPointer() const;
+
+private:
+    SizeT numCurves;
+    SizeT numSegments;
+    SizeT dataSize;
+    CurveRange* curveRanges;
+    Segment* segments;
+    uchar* data;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+AnimCompressedBuffer::IsValid() const
+{
+    return (nullptr != this->segments);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+AnimCompressedBuffer::GetByteSize() const
+{
+    return this->numCurves * sizeof(CurveRange) + this->numSegments * sizeof(Segment) + this->dataSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline AnimCompressedBuffer::CurveRange&
+AnimCompressedBuffer::GetCurveRange(IndexT curveIndex)
+{
+    n_assert(curveIndex < this->numCurves);
+    return this->curveRanges[curveIndex];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const AnimCompressedBuffer::CurveRange*
+AnimCompressedBuffer::GetCurveRangePointer() const
+{
+    return this->curveRanges;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const AnimCompressedBuffer::Segment*
+AnimCompressedBuffer::GetSegmentPointer() const
+{
+    return this->segments;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const uchar*
+AnimCompressedBuffer::GetDataPointer() const
+{
+    return this->data;
+}
+
+} // namespace CoreAnimation
+//------------------------------------------------------------------------------
@@ -0,0 +1,115 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file animcompression.h
+
+    Key quantization for compressed animations (see NaxcCurve).
+
+    Rotations are stored as smallest-three quaternions in 48 bits, the largest
+    component is dropped and rebuilt from the unit length, the other three lie
+    within [-1/sqrt(2), 1/sqrt(2)] and are stored with 15 bits each. Translation,
+    scale and velocity keys are quantized to 16 bits per component within the
+    range of their curve.
+
+    The unpack functions are used by the sampler and decode with SSE.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "core/types.h"
+#include "math/scalar.h"
+#include "math/vec4.h"
+#include "math/quat.h"
+
+namespace CoreAnimation
+{
+
+static const float AnimQuatComponentRange = 0.70710678f;
+static const uint AnimQuatComponentMax = 0x7FFF;
+static const uint AnimRangeComponentMax = 0xFFFF;
+
+//------------------------------------------------------------------------------
+/**
+    Pack a normalized quaternion (x, y, z, w) into 3 ushorts
+*/
+inline void
+AnimPackQuaternion(const float* q, ushort* out)
+{
+    uint largest = 0;
+    for (uint i = 1; i < 4; i++)
+    {
+        if (Math::abs(q[i]) > Math::abs(q[largest]))
+            largest = i;
+    }
+
+    // q and -q are the same rotation, flip so the dropped component is positive
+    const float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+    uint64 bits = uint64(largest) << 45;
+    uint shift = 30;
+    for (uint i = 0; i < 4; i++)
+    {
+        if (i == largest)
+            continue;
+        const float normalized = (q[i] * sign / AnimQuatComponentRange) * 0.5f + 0.5f;
+        const uint quantized = (uint)Math::clamp(Math::frnd(normalized * AnimQuatComponentMax), 0, int(AnimQuatComponentMax));
+        bits |= uint64(quantized) << shift;
+        shift -= 15;
+    }
+    out[0] = ushort(bits >> 32);
+    out[1] = ushort(bits >> 16);
+    out[2] = ushort(bits);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Pack the first three components of a value within [min, min + extent] into 3 ushorts
+*/
+inline void
+AnimPackRange(const float* value, const float* min, const float* extent, ushort* out)
+{
+    for (uint i = 0; i < 3; i++)
+    {
+        const float normalized = extent[i] > 0.0f ? (value[i] - min[i]) / extent[i] : 0.0f;
+        out[i] = (ushort)Math::clamp(Math::frnd(normalized * AnimRangeComponentMax), 0, int(AnimRangeComponentMax));
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline Math::quat
+AnimUnpackQuaternion(const ushort* in)
+{
+    const uint64 bits = (uint64(in[0]) << 32) | (uint64(in[1]) << 16) | uint64(in[2]);
+    const __m128i quantized = _mm_set_epi32(0, int(bits & 0x7FFF), int((bits >> 15) & 0x7FFF), int((bits >> 30) & 0x7FFF));
+
+    // scale back to [-1/sqrt(2), 1/sqrt(2)], then rebuild the dropped component in w
+    const __m128 scale = _mm_set_ps1(2.0f * AnimQuatComponentRange / AnimQuatComponentMax);
+    const __m128 comps = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(quantized), scale), _mm_set_ps1(AnimQuatComponentRange));
+    const float lengthSq = _mm_cvtss_f32(_mm_dp_ps(comps, comps, 0x71));
+    const __m128 q = _mm_blend_ps(comps, _mm_set_ps1(Math::sqrt(Math::max(0.0f, 1.0f - lengthSq))), 0x8);
+
+    // move the rebuilt component to its place
+    switch (uint(bits >> 45) & 0x3)
+    {
+        case 0: return _mm_shuffle_ps(q, q, _MM_SHUFFLE(2, 1, 0, 3));
+        case 1: return _mm_shuffle_ps(q, q, _MM_SHUFFLE(2, 1, 3, 0));
+        case 2: return _mm_shuffle_ps(q, q, _MM_SHUFFLE(2, 3, 1, 0));
+        default: return q;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Unpack 3 ushorts within [min, min + extent], the w component is min.w
+*/
+inline Math::vec4
+AnimUnpackRange(const ushort* in, const float* min, const float* extent)
+{
+    const __m128 quantized = _mm_cvtepi32_ps(_mm_set_epi32(0, in[2], in[1], in[0]));
+    const __m128 scale = _mm_mul_ps(_mm_setr_ps(extent[0], extent[1], extent[2], 0.0f), _mm_set_ps1(1.0f / AnimRangeComponentMax));
+    return _mm_add_ps(_mm_mul_ps(quantized, scale), _mm_loadu_ps(min));
+}
+
+} // namespace CoreAnimation
@@ -7,6 +7,8 @@
 #include "animkeybuffer.h"
 #include "animcurve.h"
 #include "animclip.h"
+#include "animcompressedbuffer.h"
+#include "animcompression.h"
 
 using namespace Math;
 namespace CoreAnimation
@@ -30,6 +32,32 @@ WrapTime(
         return time;
 }
 
+//------------------------------------------------------------------------------
+/**
+    Returns the number of curves per joint if the joint mask applies to the clip, 0 otherwise
+*/
+inline SizeT
+CurvesPerMaskedJoint(const AnimClip& clip, const AnimSampleMask* jointMask)
+{
+    if (jointMask == nullptr || jointMask->weights.Size() == 0)
+        return 0;
+    return Math::max(1, clip.numCurves / jointMask->weights.Size());
+}
+
+//------------------------------------------------------------------------------
+/**
+    Curves of joints with a zero weight in the joint mask are not sampled,
+    their output keeps the value of the last evaluation
+*/
+inline bool
+IsCurveSampled(const AnimSampleMask* jointMask, const SizeT curvesPerJoint, const IndexT curveIndex)
+{
+    if (curvesPerJoint == 0)
+        return true;
+    const IndexT joint = curveIndex / curvesPerJoint;
+    return joint >= jointMask->weights.Size() || jointMask->weights[joint] > 0.0f;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -76,18 +104,31 @@ AnimSampleStep(
     const AnimKeyBuffer::Interval* intervalPtr,
     uint* lastUsedIntervalPtr,
     float* outSamplePtr,
-    uchar* outSampleCounts)
+    uchar* outSampleCounts,
+    const AnimSampleMask* jointMask)
 {
+    const SizeT curvesPerJoint = CurvesPerMaskedJoint(clip, jointMask);
     int i;
     for (i = 0; i < clip.numCurves; i ++)
     {
         const AnimCurve& curve = curves[clip.firstCurve + i];
         const bool activeCurve = curve.numIntervals > 0;
+        const bool sampleCurve = activeCurve && IsCurveSampled(jointMask, curvesPerJoint, i);
+
+        if (activeCurve && !sampleCurve)
+        {
+            outSamplePtr += curve.curveType == CurveType::Rotation ? 4 : 3;
+            *outSampleCounts = 1;
+            ++outSampleCounts;
+            ++lastUsedIntervalPtr;
+            continue;
+        }
+
         int stride = 0;
 
         uint key = *lastUsedIntervalPtr;
         AnimKeyBuffer::Interval currentTime = intervalPtr[key];
-        if (activeCurve)
+        if (sampleCurve)
         {
             AnimKeyBuffer::Interval curveLastTime = intervalPtr[curve.firstIntervalOffset + curve.numIntervals - 1];
             Timing::Tick wrappedTime = WrapTime(curve, time, curveLastTime.end);
@@ -98,7 +139,7 @@ AnimSampleStep(
         {
             case CurveType::Rotation:
             {
-                if (activeCurve)
+                if (sampleCurve)
                     memcpy(outSamplePtr, &srcSamplePtr[currentTime.key0], 4 * sizeof(float));
                 else
                     idleSamples[i].store(outSamplePtr);
@@ -109,7 +150,7 @@ AnimSampleStep(
             case CurveType::Velocity:
             case CurveType::Translation:
             {
-                if (activeCurve)
+                if (sampleCurve)
                     memcpy(outSamplePtr, &srcSamplePtr[currentTime.key0], 3 * sizeof(float));
                 else
                     idleSamples[i].store(outSamplePtr);
@@ -150,20 +191,32 @@ AnimSampleLinear(
     const AnimKeyBuffer::Interval* intervalPtr,
     uint* lastUsedIntervalPtr,
     float* outSamplePtr,
-    uchar* outSampleCounts)
+    uchar* outSampleCounts,
+    const AnimSampleMask* jointMask)
 {
+    const SizeT curvesPerJoint = CurvesPerMaskedJoint(clip, jointMask);
     int i;
     for (i = 0; i < clip.numCurves; i++)
     {
         const AnimCurve& curve = curves[clip.firstCurve + i];
         const bool activeCurve = curve.numIntervals > 0;
+        const bool sampleCurve = activeCurve && IsCurveSampled(jointMask, curvesPerJoint, i);
+
+        if (activeCurve && !sampleCurve)
+        {
+            outSamplePtr += curve.curveType == CurveType::Rotation ? 4 : 3;
+            *outSampleCounts = 1;
+            ++outSampleCounts;
+            ++lastUsedIntervalPtr;
+            continue;
+        }
 
         float sampleWeight = 0.0f;
         int stride = 0;
 
         uint key = *lastUsedIntervalPtr;
         AnimKeyBuffer::Interval currentTime = intervalPtr[key];
-        if (activeCurve)
+        if (sampleCurve)
         {
             AnimKeyBuffer::Interval curveLastTime = intervalPtr[curve.firstIntervalOffset + curve.numIntervals - 1];
             Timing::Tick wrappedTime = WrapTime(curve, time, curveLastTime.end);
@@ -180,7 +233,7 @@ AnimSampleLinear(
             case CurveType::Rotation:
             {
                 Math::quat q0;
-                if (activeCurve)
+                if (sampleCurve)
                 {
                     Math::quat q1;
                     q0.load(&srcSamplePtr[currentTime.key0]);
@@ -199,7 +252,7 @@ AnimSampleLinear(
             case CurveType::Translation:
             {
                 Math::vec3 v0;
-                if (activeCurve)
+                if (sampleCurve)
                 {
                     Math::vec3 v1;
                     v0.load(&srcSamplePtr[currentTime.key0]);
@@ -233,6 +286,181 @@ AnimSampleLinear(
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+    Find the segment of a compressed clip a clip time falls into
+*/
+inline const AnimCompressedBuffer::Segment&
+FindSegment(const AnimClip& clip, const AnimCompressedBuffer* buffer, const Timing::Tick time)
+{
+    IndexT segment = clip.segmentDuration > 0 ? time / clip.segmentDuration : 0;
+    segment = Math::clamp(segment, 0, clip.numSegments - 1);
+    return buffer->GetSegmentPointer()[clip.firstSegment + segment];
+}
+
+//------------------------------------------------------------------------------
+/**
+    Samples all curves of a compressed clip from the single segment containing the sample time.
+    Keys are decoded with SSE, only the two keys around the sample time are decoded per curve.
+*/
+template <bool LINEAR>
+static void
+AnimSampleCompressed(
+    const AnimClip& clip,
+    const Util::FixedArray<AnimCurve>& curves,
+    const Timing::Tick time,
+    const vec4& velocityScale,
+    const Util::FixedArray<Math::vec4>& idleSamples,
+    const AnimCompressedBuffer* buffer,
+    float* outSamplePtr,
+    uchar* outSampleCounts,
+    const AnimSampleMask* jointMask)
+{
+    n_assert(clip.numSegments > 0);
+    const SizeT curvesPerJoint = CurvesPerMaskedJoint(clip, jointMask);
+    const Timing::Tick clampedTime = Math::clamp(time, 0, clip.duration);
+    const AnimCompressedBuffer::Segment& segment = FindSegment(clip, buffer, clampedTime);
+    const Timing::Tick segmentTime = clampedTime - segment.start;
+
+    // key counts, times and keys of all curves in the segment are contiguous
+    const ushort* keyCounts = (const ushort*)(buffer->GetDataPointer() + segment.dataOffset);
+    const ushort* keyTimes = keyCounts + clip.numCurves;
+    const ushort* keys = keyTimes + segment.numKeys;
+    const AnimCompressedBuffer::CurveRange* ranges = buffer->GetCurveRangePointer() + clip.firstCurve;
+
+    uint keyOffset = 0;
+    int i;
+    for (i = 0; i < clip.numCurves; i++)
+    {
+        const AnimCurve& curve = curves[clip.firstCurve + i];
+        const bool activeCurve = curve.numIntervals > 0;
+        const bool sampleCurve = activeCurve && IsCurveSampled(jointMask, curvesPerJoint, i);
+        const uint numKeys = keyCounts[i];
+        const ushort* times = keyTimes + keyOffset;
+        const ushort* curveKeys = keys + keyOffset * 3;
+        keyOffset += numKeys;
+
+        if (activeCurve && !sampleCurve)
+        {
+            outSamplePtr += curve.curveType == CurveType::Rotation ? 4 : 3;
+            *outSampleCounts = 1;
+            ++outSampleCounts;
+            continue;
+        }
+
+        // find the keys around the sample time, constant curves have no keys in any segment
+        uint key = 0;
+        float sampleWeight = 0.0f;
+        if (sampleCurve && numKeys > 1)
+        {
+            while (key < numKeys - 2 && segmentTime >= times[key + 1])
+                key++;
+
+            if (LINEAR)
+            {
+                const Timing::Tick span = times[key + 1] - times[key];
+                if (span > 0)
+                    sampleWeight = Math::clamp(float(segmentTime - times[key]) / span, 0.0f, 1.0f);
+            }
+            else if (segmentTime >= times[key + 1])
+                key++;
+        }
+        const bool interpolate = LINEAR && sampleWeight > 0.0f;
+        int stride = 0;
+
+        switch (curve.curveType)
+        {
+            case CurveType::Rotation:
+            {
+                Math::quat q0;
+                if (!sampleCurve)
+                    q0 = idleSamples[i].vec;
+                else if (numKeys == 0)
+                    q0.loadu(ranges[i].min);
+                else
+                {
+                    q0 = AnimUnpackQuaternion(curveKeys + key * 3);
+                    if (interpolate)
+                        q0 = Math::slerp(q0, AnimUnpackQuaternion(curveKeys + (key + 1) * 3), sampleWeight);
+                }
+
+                q0.store(outSamplePtr);
+                stride = 4;
+                break;
+            }
+            case CurveType::Scale:
+            case CurveType::Velocity:
+            case CurveType::Translation:
+            {
+                Math::vec4 v0;
+                if (!sampleCurve)
+                    v0 = idleSamples[i];
+                else if (numKeys == 0)
+                    v0.loadu(ranges[i].min);
+                else
+                {
+                    v0 = AnimUnpackRange(curveKeys + key * 3, ranges[i].min, ranges[i].extent);
+                    if (interpolate)
+                        v0 = Math::lerp(v0, AnimUnpackRange(curveKeys + (key + 1) * 3, ranges[i].min, ranges[i].extent), sampleWeight);
+                }
+
+                xyz(v0).store(outSamplePtr);
+                stride = 3;
+                break;
+            }
+            default: n_error("unhandled enum"); break;
+        }
+
+        if (curve.curveType == CurveType::Velocity)
+        {
+            outSamplePtr[0] = outSamplePtr[0] * velocityScale.x;
+            outSamplePtr[1] = outSamplePtr[1] * velocityScale.y;
+            outSamplePtr[2] = outSamplePtr[2] * velocityScale.z;
+        }
+
+        outSamplePtr += stride;
+
+        *outSampleCounts = activeCurve;
+        ++outSampleCounts;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AnimSampleCompressedStep(
+    const AnimClip& clip,
+    const Util::FixedArray<AnimCurve>& curves,
+    const Timing::Tick time,
+    const vec4& velocityScale,
+    const Util::FixedArray<Math::vec4>& idleSamples,
+    const AnimCompressedBuffer* buffer,
+    float* outSamplePtr,
+    uchar* outSampleCounts,
+    const AnimSampleMask* jointMask)
+{
+    AnimSampleCompressed<false>(clip, curves, time, velocityScale, idleSamples, buffer, outSamplePtr, outSampleCounts, jointMask);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AnimSampleCompressedLinear(
+    const AnimClip& clip,
+    const Util::FixedArray<AnimCurve>& curves,
+    const Timing::Tick time,
+    const vec4& velocityScale,
+    const Util::FixedArray<Math::vec4>& idleSamples,
+    const AnimCompressedBuffer* buffer,
+    float* outSamplePtr,
+    uchar* outSampleCounts,
+    const AnimSampleMask* jointMask)
+{
+    AnimSampleCompressed<true>(clip, curves, time, velocityScale, idleSamples, buffer, outSamplePtr, outSampleCounts, jointMask);
+}
+
 //------------------------------------------------------------------------------
 /**
 */
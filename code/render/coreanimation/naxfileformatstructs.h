@@ -16,6 +16,7 @@ namespace CoreAnimation
 #pragma pack(push, 1)
 
 #define NEBULA_NAX3_MAGICNUMBER 'NA01'
+#define NEBULA_NAXC_MAGICNUMBER 'NC01'
 
 //------------------------------------------------------------------------------
 /** 
@@ -75,6 +76,67 @@ struct Nax3Curve
     uchar curveType;                // CoreAnimation::CurveType::Code
 };
 
+//------------------------------------------------------------------------------
+/**
+    Compressed NAX file format structs.
+
+    Shares the Nax3Header (with the NAXC magic number) and Nax3AnimEvent.
+    Each clip is cut into segments of equal duration, and every segment holds
+    the keys of all clip curves overlapping it in one block:
+
+        ushort keyCounts[clip.numCurves];   // 0 for constant and inactive curves
+        ushort keyTimes[segment.numKeys];   // ticks relative to the segment start
+        ushort keys[segment.numKeys * 3];   // 48 bits per key
+
+    The first and last key of a curve in a segment lie on the segment bounds.
+    Rotation keys are smallest-three quaternions, 2 bits for the index of the
+    dropped component and 15 bits for each of the other three, translation,
+    scale and velocity keys are 16 bits per component within the curve range.
+*/
+struct NaxcAnim
+{
+    ushort numClips;
+    ushort numCurves;
+    ushort numEvents;
+    uint numSegments;
+    uint segmentDataSize;           // in bytes
+};
+
+struct NaxcCurve
+{
+    float rangeMin[4];              // value of constant curves
+    float rangeExtent[3];
+    uint numKeys;                   // keys left after reduction, 0 for inactive curves
+    uchar preInfinityType;          // CoreAnimation::InfinityType::Code
+    uchar postInfinityType;         // CoreAnimation::InfinityType::Code
+    uchar curveType;                // CoreAnimation::CurveType::Code
+    uchar padding;
+};
+
+struct NaxcClip
+{
+    ushort numCurves;
+    ushort firstCurve;
+    ushort numEvents;
+    ushort firstEvent;
+    ushort numVelocityCurves;
+    ushort firstVelocityCurve;
+
+    uint duration;
+    uint firstSegment;
+    uint numSegments;
+    uint segmentDuration;
+
+    char name[48];
+};
+
+struct NaxcSegment
+{
+    uint start, end;
+    uint dataOffset;                // in bytes, from the start of the segment data
+    uint numKeys;
+};
+
 //------------------------------------------------------------------------------
 /** 
     legacy NAX2 file format structs
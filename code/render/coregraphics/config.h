@@ -307,7 +307,7 @@ PipelineStageFromString(const Util::String& str)
 #endif
 
 //------------------------------------------------------------------------------
-#if __VULKAN__
+#if (__VULKAN__ || __NULL_GRAPHICS__)
     #define COREGRAPHICS_TRIANGLE_FRONT_FACE_CCW (1)
     // define the same descriptor set slots as we do in the shaders
     #define NEBULA_TICK_GROUP 0             // set per tick (once for all views) by the system
@@ -11,6 +11,9 @@ namespace CoreGraphics
 #if __VULKAN__
 __ImplementClass(CoreGraphics::DisplayDevice, 'DDVC', GLFW::GLFWDisplayDevice);
 __ImplementSingleton(CoreGraphics::DisplayDevice);
+#elif __NULL_GRAPHICS__
+__ImplementClass(CoreGraphics::DisplayDevice, 'DDVC', Base::DisplayDeviceBase);
+__ImplementSingleton(CoreGraphics::DisplayDevice);
 #else
 #error "DisplayDevice class not implemented on this platform!"
 #endif
@@ -25,6 +25,27 @@ public:
     virtual ~DisplayDevice();
 };
 } // namespace CoreGraphics
+#elif __NULL_GRAPHICS__
+#include "coregraphics/base/displaydevicebase.h"
+#include "coregraphics/window.h"
+namespace CoreGraphics
+{
+class DisplayDevice : public Base::DisplayDeviceBase
+{
+    __DeclareClass(DisplayDevice);
+    __DeclareSingleton(DisplayDevice);
+public:
+    /// constructor
+    DisplayDevice();
+    /// destructor
+    virtual ~DisplayDevice();
+
+private:
+    friend const CoreGraphics::WindowId CoreGraphics::CreateWindow(const CoreGraphics::WindowCreateInfo& info);
+    friend void CoreGraphics::DestroyWindow(const CoreGraphics::WindowId id);
+    friend void CoreGraphics::WindowResize(const CoreGraphics::WindowId id, SizeT newWidth, SizeT newHeight);
+};
+} // namespace CoreGraphics
 #else
 #error "CoreGraphics::DisplayDevice not implemented on this platform!"
 #endif
@@ -77,7 +77,7 @@ struct SubmissionWaitEvent
     // Invalidate
     void operator=(const std::nullptr_t);
 
-#if __VULKAN__
+#if (__VULKAN__ || __NULL_GRAPHICS__)
     uint64_t timelineIndex;
 #endif
     CoreGraphics::QueueType queue;
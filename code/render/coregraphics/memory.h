@@ -23,6 +23,10 @@ namespace CoreGraphics
 typedef VkDeviceSize DeviceSize;
 typedef VkDeviceMemory DeviceMemory;
 typedef VkDeviceAddress DeviceAddress;
+#elif __NULL_GRAPHICS__
+typedef uint64_t DeviceSize;
+typedef void* DeviceMemory;
+typedef uint64_t DeviceAddress;
 #else
 #error "coregraphics/memory.h is not supported for the renderer"
 #endif
@@ -108,7 +112,11 @@ void SetupMemoryPools(
     DeviceSize hostToDeviceMemory,
     DeviceSize deviceToHostMemory);
 /// discard memory pools
+#if __VULKAN__
 void DiscardMemoryPools(VkDevice dev);
+#else
+void DiscardMemoryPools();
+#endif
 
 /// free memory
 void FreeMemory(const CoreGraphics::Alloc& alloc);
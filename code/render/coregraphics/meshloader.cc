@@ -6,6 +6,7 @@
 #include "meshloader.h"
 #include "coregraphics/mesh.h"
 #include "nvx3fileformatstructs.h"
+#include "nvx3quantization.h"
 #include "coregraphics/meshloader.h"
 #include "coregraphics/graphicsdevice.h"
 
@@ -26,6 +27,9 @@ MeshLoader::MeshLoader()
     this->failResourceName = "sysmsh:error.nvx";
     this->async = true;
 
+    // meshes are mapped as a whole, so read them ahead with batched async reads
+    this->prefetchStreams = true;
+
     this->streamerThreadName = "Mesh Streamer Thread";
 
     // Setup vertex layouts
@@ -122,6 +126,10 @@ MeshLoader::StreamResource(const Resources::ResourceId entry, IndexT frameIndex,
     ResourceLoader::StreamData& stream = this->streams[entry.loaderInstanceId];
 
     MeshStreamData* streamData = (MeshStreamData*)stream.data;
+
+    // the decoded image of a quantized file is released once it is uploaded
+    if (streamData->mappedData == nullptr)
+        return 0x3;
     auto header = (Nvx3Header*)streamData->mappedData;
 
     n_assert(header->magic == NEBULA_NVX_MAGICNUMBER);
@@ -181,15 +189,40 @@ MeshLoader::StreamResource(const Resources::ResourceId entry, IndexT frameIndex,
         }
     }
 
+    if (loadBits == 0x3)
+        ReleaseDecodedData(streamData);
     return loadBits;
 }
 
+//------------------------------------------------------------------------------
+/**
+    The GPU buffers hold everything the mesh needs after the upload, so the
+    decoded image of a quantized file is freed right away instead of
+    staying resident until the mesh is unloaded.
+*/
+void
+MeshLoader::ReleaseDecodedData(MeshStreamData* streamData)
+{
+    if (streamData->decodedData == nullptr)
+        return;
+    Memory::Free(Memory::ResourceHeap, streamData->decodedData);
+    streamData->decodedData = nullptr;
+    streamData->mappedData = nullptr;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
 void
 MeshLoader::Unload(const Resources::ResourceId id)
 {
+    MeshStreamData* streamData = (MeshStreamData*)this->streams[id.loaderInstanceId].data;
+    if (streamData != nullptr)
+    {
+        ReleaseDecodedData(streamData);
+        Memory::Free(Memory::ScratchHeap, streamData);
+        this->streams[id.loaderInstanceId].data = nullptr;
+    }
     DestroyMeshResource(id);
 }
 
@@ -202,6 +235,33 @@ MeshLoader::LodMask(const Ids::Id32 entry, float lod, bool stream) const
     return 0x3;
 }
 
+//------------------------------------------------------------------------------
+/**
+    Counts the vertex and index allocations, the file image and the decoded
+    image of a quantized file until it is uploaded. A mesh whose stream failed
+    to open holds nothing.
+*/
+uint64
+MeshLoader::MemoryUsage(const Resources::ResourceId id) const
+{
+    const ResourceLoader::StreamData& stream = this->streams[id.loaderInstanceId];
+    const MeshStreamData* streamData = (const MeshStreamData*)stream.data;
+    if (streamData == nullptr || !stream.stream.isvalid())
+        return 0;
+
+    uint64 bytes = (uint64)streamData->vertexAllocationOffset.size + streamData->indexAllocationOffset.size;
+    bytes += stream.stream->GetSize();
+    if (streamData->decodedData != nullptr)
+    {
+        auto header = (const Nvx3Header*)streamData->decodedData;
+        auto vertexRanges = (const Nvx3VertexRange*)(header + 1);
+        auto groups = (const Nvx3Group*)(vertexRanges + header->numMeshes);
+        auto vertexData = (const ubyte*)(groups + header->numGroups);
+        bytes += (vertexData - (const ubyte*)header) + header->vertexDataSize + header->indexDataSize;
+    }
+    return bytes;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -239,6 +299,10 @@ MeshLoader::SetupMeshFromNvx(const Ptr<IO::Stream>& stream, const Ids::Id32 entr
         n_assert(nullptr != mapPtr);
 
         auto header = (Nvx3Header*)mapPtr;
+
+        // quantized files are decoded into a plain nvx3 image, which is what gets uploaded
+        void* decodedPtr = Nvx3::DecodeQuantized(header, Memory::ResourceHeap);
+
         if (header->magic != NEBULA_NVX_MAGICNUMBER)
         {
             // not a nvx2 file, break hard
@@ -255,7 +319,8 @@ MeshLoader::SetupMeshFromNvx(const Ptr<IO::Stream>& stream, const Ids::Id32 entr
         meshes.Resize(header->numMeshes);
 
         MeshStreamData* streamData = (MeshStreamData*)Memory::Alloc(Memory::ScratchHeap, sizeof(MeshStreamData));
-        streamData->mappedData = mapPtr;
+        streamData->mappedData = header;
+        streamData->decodedData = decodedPtr;
 
         this->streams[entry].stream = stream;
         this->streams[entry].data = streamData;
@@ -314,6 +379,9 @@ MeshLoader::SetupMeshFromNvx(const Ptr<IO::Stream>& stream, const Ids::Id32 entr
             meshes[i] = mesh;
         }
 
+        if (immediate)
+            ReleaseDecodedData(streamData);
+
         reader->Close();
     }
 
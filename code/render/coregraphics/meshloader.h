@@ -32,7 +32,8 @@ private:
 
     struct MeshStreamData
     {
-        void* mappedData;
+        void* mappedData;       // nvx3 image to upload, nullptr once a decoded image is released
+        void* decodedData;      // plain nvx3 image decoded from a quantized file until it is uploaded, nullptr otherwise
         CoreGraphics::VertexAlloc indexAllocationOffset, vertexAllocationOffset;
     };
     
@@ -44,9 +45,13 @@ private:
     void Unload(const Resources::ResourceId id) override;
     /// Create load mask based on LOD
     uint LodMask(const Ids::Id32 entry, float lod, bool stream) const override;
+    /// get the GPU and CPU memory of a mesh
+    uint64 MemoryUsage(const Resources::ResourceId id) const override;
 
     /// Get vertex layout
     static const CoreGraphics::VertexLayoutId GetLayout(const CoreGraphics::VertexLayoutType type);
+    /// free the decoded image of a quantized file once it is on the GPU
+    static void ReleaseDecodedData(MeshStreamData* streamData);
     /// setup mesh from nvx3 file in memory
     void SetupMeshFromNvx(const Ptr<IO::Stream>& stream, const Ids::Id32 entry, const MeshResourceId meshResource, bool immediate);
 };
@@ -0,0 +1,164 @@
+//------------------------------------------------------------------------------
+//  nullaccelerationstructure.cc
+//
+//  The null renderer doesn't support raytracing, RayTracingSupported is
+//  always false so none of these should ever be called.
+//
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "coregraphics/accelerationstructure.h"
+
+namespace CoreGraphics
+{
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+BlasIdAcquire(const BlasId id)
+{
+    n_error("Raytracing is not supported by the null renderer");
+    return false;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BlasIdRelease(const BlasId id)
+{
+    n_error("Raytracing is not supported by the null renderer");
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+BlasInstanceIdAcquire(const BlasInstanceId id)
+{
+    n_error("Raytracing is not supported by the null renderer");
+    return false;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BlasInstanceIdRelease(const BlasInstanceId id)
+{
+    n_error("Raytracing is not supported by the null renderer");
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+BlasId
+CreateBlas(const BlasCreateInfo& info)
+{
+    n_error("Raytracing is not supported by the null renderer");
+    return InvalidBlasId;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyBlas(const BlasId blas)
+{
+    n_error("Raytracing is not supported by the null renderer");
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+BlasInstanceId
+CreateBlasInstance(const BlasInstanceCreateInfo& info)
+{
+    n_error("Raytracing is not supported by the null renderer");
+    return InvalidBlasInstanceId;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyBlasInstance(const BlasInstanceId id)
+{
+    n_error("Raytracing is not supported by the null renderer");
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BlasInstanceUpdate(const BlasInstanceId id, const Math::mat4& transform, CoreGraphics::BufferId buf, uint offset)
+{
+    n_error("Raytracing is not supported by the null renderer");
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BlasInstanceUpdate(const BlasInstanceId id, CoreGraphics::BufferId buf, uint offset)
+{
+    n_error("Raytracing is not supported by the null renderer");
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BlasInstanceSetMask(const BlasInstanceId id, uint mask)
+{
+    n_error("Raytracing is not supported by the null renderer");
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const SizeT
+BlasInstanceGetSize()
+{
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+TlasId
+CreateTlas(const TlasCreateInfo& info)
+{
+    n_error("Raytracing is not supported by the null renderer");
+    return InvalidTlasId;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyTlas(const TlasId tlas)
+{
+    n_error("Raytracing is not supported by the null renderer");
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TlasInitBuild(const TlasId tlas)
+{
+    n_error("Raytracing is not supported by the null renderer");
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TlasInitUpdate(const TlasId tlas)
+{
+    n_error("Raytracing is not supported by the null renderer");
+}
+
+} // namespace CoreGraphics
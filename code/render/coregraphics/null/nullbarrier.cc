@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+//  nullbarrier.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "nullbarrier.h"
+
+namespace Null
+{
+NullBarrierAllocator barrierAllocator(0x00FFFFFF);
+} // namespace Null
+
+namespace CoreGraphics
+{
+
+using namespace Null;
+
+//------------------------------------------------------------------------------
+/**
+*/
+BarrierId
+CreateBarrier(const BarrierCreateInfo& info)
+{
+    Ids::Id32 id = barrierAllocator.Alloc();
+    barrierAllocator.Get<0>(id) = info;
+    BarrierId ret = id;
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyBarrier(const BarrierId id)
+{
+    BarrierCreateInfo& info = barrierAllocator.Get<0>(id.id);
+    info.textures.Clear();
+    info.buffers.Clear();
+    barrierAllocator.Dealloc(id.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BarrierReset(const BarrierId id)
+{
+    // empty, barriers don't track resource state
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BarrierPush(
+    const CoreGraphics::CmdBufferId buf,
+    CoreGraphics::PipelineStage fromStage,
+    CoreGraphics::PipelineStage toStage,
+    CoreGraphics::BarrierDomain domain,
+    const Util::FixedArray<TextureBarrierInfo>& textures,
+    const Util::FixedArray<BufferBarrierInfo>& buffers)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BarrierPush(
+    const CoreGraphics::CmdBufferId buf,
+    CoreGraphics::PipelineStage fromStage,
+    CoreGraphics::PipelineStage toStage,
+    CoreGraphics::BarrierDomain domain,
+    const Util::FixedArray<TextureBarrierInfo>& textures)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BarrierPush(
+    const CoreGraphics::CmdBufferId buf,
+    CoreGraphics::PipelineStage fromStage,
+    CoreGraphics::PipelineStage toStage,
+    CoreGraphics::BarrierDomain domain,
+    const Util::FixedArray<BufferBarrierInfo>& buffers)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BarrierPop(const CoreGraphics::CmdBufferId buf)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BarrierRepeat(const CoreGraphics::CmdBufferId buf)
+{
+    // empty
+}
+
+} // namespace CoreGraphics
@@ -0,0 +1,20 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    Null barrier, barriers keep their create info but never synchronize anything
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "ids/idallocator.h"
+#include "coregraphics/barrier.h"
+namespace Null
+{
+
+typedef Ids::IdAllocator<
+    CoreGraphics::BarrierCreateInfo
+> NullBarrierAllocator;
+extern NullBarrierAllocator barrierAllocator;
+
+} // namespace Null
@@ -0,0 +1,280 @@
+//------------------------------------------------------------------------------
+//  nullbuffer.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "nullbuffer.h"
+#include "nullmemory.h"
+#include "coregraphics/graphicsdevice.h"
+#include "util/bit.h"
+namespace Null
+{
+NullBufferAllocator bufferAllocator;
+} // namespace Null
+
+namespace CoreGraphics
+{
+
+using namespace Null;
+_IMPL_ACQUIRE_RELEASE(BufferId, bufferAllocator);
+
+//------------------------------------------------------------------------------
+/**
+*/
+const BufferId
+CreateBuffer(const BufferCreateInfo& info)
+{
+    Ids::Id32 id = bufferAllocator.Alloc();
+    NullBufferLoadInfo& loadInfo = bufferAllocator.Get<Buffer_LoadInfo>(id);
+    NullBufferRuntimeInfo& runtimeInfo = bufferAllocator.Get<Buffer_RuntimeInfo>(id);
+    NullBufferMapInfo& mapInfo = bufferAllocator.Get<Buffer_MapInfo>(id);
+
+    runtimeInfo.usageFlags = info.usageFlags;
+    if (info.sparse)
+        n_assert(info.data == nullptr);
+
+    CoreGraphics::MemoryPoolType pool = CoreGraphics::MemoryPool_DeviceLocal;
+    if (info.mode == DeviceLocal)
+        pool = CoreGraphics::MemoryPool_DeviceLocal;
+    else if (info.mode == HostLocal)
+        pool = CoreGraphics::MemoryPool_HostLocal;
+    else if (info.mode == DeviceAndHost)
+        pool = CoreGraphics::MemoryPool_DeviceAndHost;
+    else if (info.mode == HostCached)
+        pool = CoreGraphics::MemoryPool_HostCached;
+
+    uint baseAlignment = 16;
+    if (AllBits(info.usageFlags, CoreGraphics::ConstantBuffer))
+        baseAlignment = 256;
+
+    // sparse buffers are made fully resident up front, there is no page table to bind
+    uint size = info.byteSize == 0 ? info.size * info.elementSize : info.byteSize;
+    CoreGraphics::Alloc alloc = Null::AllocateMemory(pool, baseAlignment, Math::max(size, 1u));
+    loadInfo.mem = alloc;
+    mapInfo.mappedMemory = GetMappedMemory(alloc);
+
+    // all memory is host visible, so initial data is copied straight into the buffer
+    if (info.data)
+    {
+        n_assert(info.dataSize <= size);
+        memcpy(mapInfo.mappedMemory, info.data, info.dataSize);
+    }
+
+    // setup resource
+    loadInfo.mode = info.mode;
+    loadInfo.size = info.size;
+    loadInfo.byteSize = size;
+    loadInfo.elementSize = info.elementSize;
+    loadInfo.sparse = info.sparse;
+
+    BufferId ret = id;
+
+#if NEBULA_GRAPHICS_DEBUG
+    ObjectSetName(ret, info.name.Value());
+#endif
+
+    CoreGraphics::BufferIdRelease(ret);
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyBuffer(const BufferId id)
+{
+    bufferAllocator.Acquire(id.id);
+    NullBufferLoadInfo& loadInfo = bufferAllocator.Get<Buffer_LoadInfo>(id.id);
+
+    CoreGraphics::DelayedFreeMemory(loadInfo.mem);
+    loadInfo.mem = CoreGraphics::Alloc{};
+    bufferAllocator.Get<Buffer_MapInfo>(id.id).mappedMemory = nullptr;
+    bufferAllocator.Dealloc(id.id);
+    bufferAllocator.Release(id.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const BufferUsageFlags
+BufferGetType(const BufferId id)
+{
+    return bufferAllocator.ConstGet<Buffer_RuntimeInfo>(id.id).usageFlags;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const SizeT
+BufferGetSize(const BufferId id)
+{
+    return bufferAllocator.ConstGet<Buffer_LoadInfo>(id.id).size;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const SizeT
+BufferGetElementSize(const BufferId id)
+{
+    return bufferAllocator.ConstGet<Buffer_LoadInfo>(id.id).elementSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const SizeT
+BufferGetByteSize(const BufferId id)
+{
+    return bufferAllocator.ConstGet<Buffer_LoadInfo>(id.id).byteSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const SizeT
+BufferGetUploadMaxSize()
+{
+    return 65536;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void*
+BufferMap(const BufferId id)
+{
+    return bufferAllocator.ConstGet<Buffer_MapInfo>(id.id).mappedMemory;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BufferUnmap(const BufferId id)
+{
+    // empty, buffers are always mapped
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BufferUpdate(const BufferId id, const void* data, const uint size, const uint offset)
+{
+    const NullBufferMapInfo& map = bufferAllocator.ConstGet<Buffer_MapInfo>(id.id);
+
+#if NEBULA_DEBUG
+    const NullBufferLoadInfo& setup = bufferAllocator.ConstGet<Buffer_LoadInfo>(id.id);
+    n_assert(size + offset <= (uint)setup.byteSize);
+#endif
+    byte* buf = (byte*)map.mappedMemory + offset;
+    memcpy(buf, data, size);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BufferUpload(const CoreGraphics::CmdBufferId cmdBuf, const BufferId id, const void* data, const uint size, const uint offset)
+{
+    n_assert(size <= (uint)BufferGetUploadMaxSize());
+    CoreGraphics::CmdUpdateBuffer(cmdBuf, id, offset, size, data);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BufferFill(const CoreGraphics::CmdBufferId cmdBuf, const BufferId id, char pattern)
+{
+    const NullBufferLoadInfo& setup = bufferAllocator.ConstGet<Buffer_LoadInfo>(id.id);
+    const NullBufferMapInfo& map = bufferAllocator.ConstGet<Buffer_MapInfo>(id.id);
+    memset(map.mappedMemory, pattern, setup.byteSize);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BufferFlush(const BufferId id, IndexT offset, SizeT size)
+{
+    // empty, memory is coherent
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BufferInvalidate(const BufferId id, IndexT offset, SizeT size)
+{
+    // empty, memory is coherent
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BufferSparseEvict(const BufferId id, IndexT pageIndex)
+{
+    n_assert(bufferAllocator.ConstGet<Buffer_LoadInfo>(id.id).sparse);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BufferSparseMakeResident(const BufferId id, IndexT pageIndex)
+{
+    n_assert(bufferAllocator.ConstGet<Buffer_LoadInfo>(id.id).sparse);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+IndexT
+BufferSparseGetPageIndex(const BufferId id, SizeT offset)
+{
+    return offset / BufferSparsePageSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+BufferSparseGetPageSize(const BufferId id)
+{
+    return BufferSparsePageSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BufferSparseCommitChanges(const BufferId id)
+{
+    // empty, all pages are resident
+}
+
+//------------------------------------------------------------------------------
+/**
+    The device address is the CPU address of the buffer memory
+*/
+CoreGraphics::DeviceAddress
+BufferGetDeviceAddress(const BufferId id)
+{
+    return (CoreGraphics::DeviceAddress)bufferAllocator.ConstGet<Buffer_MapInfo>(id.id).mappedMemory;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BufferCopyWithStaging(const CoreGraphics::BufferId dest, const uint offset, const void* data, const uint size)
+{
+    // there is no staging on the null device, the destination is always mapped
+    BufferUpdate(dest, data, size, offset);
+}
+
+} // namespace CoreGraphics
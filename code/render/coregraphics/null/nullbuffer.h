@@ -0,0 +1,59 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    Null implementation of a GPU buffer
+
+    Buffers live in CPU memory and are always mapped, regardless of the
+    access mode they were created with.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "ids/idallocator.h"
+#include "coregraphics/config.h"
+#include "coregraphics/buffer.h"
+#include "coregraphics/memory.h"
+
+namespace Null
+{
+
+struct NullBufferLoadInfo
+{
+    CoreGraphics::Alloc mem;
+    CoreGraphics::BufferAccessMode mode;
+    uint32_t size;
+    uint32_t elementSize;
+    uint32_t byteSize;
+    bool sparse;
+};
+
+struct NullBufferRuntimeInfo
+{
+    CoreGraphics::BufferUsageFlags usageFlags;
+};
+
+struct NullBufferMapInfo
+{
+    void* mappedMemory;
+};
+
+enum
+{
+    Buffer_LoadInfo,
+    Buffer_RuntimeInfo,
+    Buffer_MapInfo,
+};
+
+typedef Ids::IdAllocatorSafe<
+    0xFFFF
+    , NullBufferLoadInfo
+    , NullBufferRuntimeInfo
+    , NullBufferMapInfo
+> NullBufferAllocator;
+extern NullBufferAllocator bufferAllocator;
+
+/// sparse buffers are fully resident, but report pages of this size
+static const SizeT BufferSparsePageSize = 65536;
+
+} // namespace Null
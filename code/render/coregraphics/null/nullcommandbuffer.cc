@@ -0,0 +1,800 @@
+//------------------------------------------------------------------------------
+//  nullcommandbuffer.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "nullcommandbuffer.h"
+#include "nullpass.h"
+#include "coregraphics/pipeline.h"
+#include "coregraphics/graphicsdevice.h"
+#include "coregraphics/event.h"
+
+namespace Null
+{
+
+NullCommandBufferAllocator commandBuffers;
+NullCommandBufferPoolAllocator commandBufferPools(0x00FFFFFF);
+
+//------------------------------------------------------------------------------
+/**
+*/
+NullCmdBufferStats
+CmdBufferTakeStats(const CoreGraphics::CmdBufferId id)
+{
+    __Lock(commandBuffers, id.id);
+    NullCmdBufferStats& stats = commandBuffers.Get<CmdBuffer_Stats>(id.id);
+    NullCmdBufferStats ret = stats;
+    stats = NullCmdBufferStats{ 0, 0, 0 };
+    return ret;
+}
+
+} // namespace Null
+
+namespace CoreGraphics
+{
+
+using namespace Null;
+
+_IMPL_ACQUIRE_RELEASE(CmdBufferId, commandBuffers);
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CmdBufferPoolId
+CreateCmdBufferPool(const CmdBufferPoolCreateInfo& info)
+{
+    Ids::Id32 id = commandBufferPools.Alloc();
+    commandBufferPools.Set<CommandBufferPool_Queue>(id, info.queue);
+
+    CmdBufferPoolId ret = id;
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyCmdBufferPool(const CmdBufferPoolId pool)
+{
+    commandBufferPools.Dealloc(pool.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CmdBufferId
+CreateCmdBuffer(const CmdBufferCreateInfo& info)
+{
+    n_assert(info.pool != CoreGraphics::InvalidCmdBufferPoolId);
+    Ids::Id32 id = commandBuffers.Alloc();
+    commandBuffers.Set<CmdBuffer_Pool>(id, info.pool);
+    commandBuffers.Set<CmdBuffer_Usage>(id, info.usage);
+    commandBuffers.Set<CmdBuffer_Stats>(id, NullCmdBufferStats{ 0, 0, 0 });
+
+    NullPipelineBundle& pipelineBundle = commandBuffers.Get<CmdBuffer_PipelineBundle>(id);
+    pipelineBundle.pass = InvalidPassId;
+    pipelineBundle.subpass = 0;
+    pipelineBundle.program = InvalidShaderProgramId;
+    pipelineBundle.topology = CoreGraphics::PrimitiveTopology::TriangleList;
+
+    CmdBufferId ret = id;
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyCmdBuffer(const CmdBufferId id)
+{
+    __Lock(commandBuffers, id.id);
+
+#if NEBULA_ENABLE_PROFILING
+    CmdBufferMarkerBundle& markers = commandBuffers.Get<CmdBuffer_ProfilingMarkers>(id.id);
+    markers.markerStack.Clear();
+    markers.finishedMarkers.Clear();
+#endif
+
+    CoreGraphics::DelayedDeleteCommandBuffer(id);
+    commandBuffers.Dealloc(id.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdBeginRecord(const CmdBufferId id, const CmdBufferBeginInfo& info)
+{
+    n_assert(id != InvalidCmdBufferId);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdEndRecord(const CmdBufferId id)
+{
+    n_assert(id != InvalidCmdBufferId);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdReset(const CmdBufferId id, const CmdBufferClearInfo& info)
+{
+    commandBuffers.Get<CmdBuffer_Stats>(id.id) = NullCmdBufferStats{ 0, 0, 0 };
+#if NEBULA_ENABLE_PROFILING
+    CmdBufferMarkerBundle& markers = commandBuffers.Get<CmdBuffer_ProfilingMarkers>(id.id);
+    markers.markerStack.Clear();
+    markers.finishedMarkers.Clear();
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdSetVertexBuffer(const CmdBufferId id, IndexT streamIndex, const CoreGraphics::BufferId& buffer, SizeT bufferOffset)
+{
+#if _DEBUG
+    CoreGraphics::QueueType usage = commandBuffers.Get<CmdBuffer_Usage>(id.id);
+    n_assert(usage == QueueType::GraphicsQueueType);
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdSetVertexLayout(const CmdBufferId id, const CoreGraphics::VertexLayoutId& vl)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdSetIndexBuffer(const CmdBufferId id, const IndexType::Code indexType, const CoreGraphics::BufferId& buffer, SizeT bufferOffset)
+{
+#if _DEBUG
+    CoreGraphics::QueueType usage = commandBuffers.Get<CmdBuffer_Usage>(id.id);
+    n_assert(usage == QueueType::GraphicsQueueType);
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdSetPrimitiveTopology(const CmdBufferId id, const CoreGraphics::PrimitiveTopology::Code topo)
+{
+    commandBuffers.Get<CmdBuffer_PipelineBundle>(id.id).topology = topo;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdSetShaderProgram(const CmdBufferId id, const CoreGraphics::ShaderProgramId pro, bool bindGlobals)
+{
+    commandBuffers.Get<CmdBuffer_PipelineBundle>(id.id).program = pro;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdSetResourceTable(const CmdBufferId id, const CoreGraphics::ResourceTableId table, const IndexT slot, CoreGraphics::ShaderPipeline pipeline, const Util::FixedArray<uint>& offsets)
+{
+    n_assert(table != InvalidResourceTableId);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdSetResourceTable(const CmdBufferId id, const CoreGraphics::ResourceTableId table, const IndexT slot, CoreGraphics::ShaderPipeline pipeline, uint32 numOffsets, uint32* offsets)
+{
+    n_assert(table != InvalidResourceTableId);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdPushConstants(const CmdBufferId id, ShaderPipeline pipeline, uint offset, uint size, const void* data)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdSetGraphicsPipeline(const CmdBufferId id)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdSetGraphicsPipeline(const CmdBufferId buf, const PipelineId pipeline)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdSetRayTracingPipeline(const CmdBufferId buf, const PipelineId pipeline)
+{
+    n_error("Raytracing is not supported by the null renderer");
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdBarrier(
+    const CmdBufferId id,
+    CoreGraphics::PipelineStage fromStage,
+    CoreGraphics::PipelineStage toStage,
+    CoreGraphics::BarrierDomain domain,
+    const IndexT fromQueue,
+    const IndexT toQueue,
+    const char* name)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdBarrier(
+    const CmdBufferId id,
+    CoreGraphics::PipelineStage fromStage,
+    CoreGraphics::PipelineStage toStage,
+    CoreGraphics::BarrierDomain domain,
+    const Util::FixedArray<TextureBarrierInfo>& textures,
+    const IndexT fromQueue,
+    const IndexT toQueue,
+    const char* name)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdBarrier(
+    const CmdBufferId id,
+    CoreGraphics::PipelineStage fromStage,
+    CoreGraphics::PipelineStage toStage,
+    CoreGraphics::BarrierDomain domain,
+    const Util::FixedArray<BufferBarrierInfo>& buffers,
+    const IndexT fromQueue,
+    const IndexT toQueue,
+    const char* name)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdBarrier(
+    const CmdBufferId id,
+    CoreGraphics::PipelineStage fromStage,
+    CoreGraphics::PipelineStage toStage,
+    CoreGraphics::BarrierDomain domain,
+    const Util::FixedArray<AccelerationStructureBarrierInfo>& accelerationStructures,
+    const IndexT fromQueue,
+    const IndexT toQueue,
+    const char* name)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdBarrier(
+    const CmdBufferId id,
+    CoreGraphics::PipelineStage fromStage,
+    CoreGraphics::PipelineStage toStage,
+    CoreGraphics::BarrierDomain domain,
+    const Util::FixedArray<TextureBarrierInfo>& textures,
+    const Util::FixedArray<BufferBarrierInfo>& buffers,
+    const Util::FixedArray<AccelerationStructureBarrierInfo>& accelerationStructures,
+    const IndexT fromQueue,
+    const IndexT toQueue,
+    const char* name)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdHandover(
+    const CmdBufferId from,
+    const CmdBufferId to,
+    CoreGraphics::PipelineStage fromStage,
+    CoreGraphics::PipelineStage toStage,
+    const Util::FixedArray<TextureBarrierInfo>& textures,
+    const Util::FixedArray<BufferBarrierInfo>& buffers,
+    const IndexT fromQueue,
+    const IndexT toQueue,
+    const char* name)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdBarrier(const CmdBufferId id, const CoreGraphics::BarrierId barrier)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdSignalEvent(const CmdBufferId id, const CoreGraphics::EventId ev, const CoreGraphics::PipelineStage stage)
+{
+    CoreGraphics::EventSignal(ev, id, stage);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdWaitEvent(const CmdBufferId id, const EventId ev, const CoreGraphics::PipelineStage waitStage, const CoreGraphics::PipelineStage signalStage)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdResetEvent(const CmdBufferId id, const CoreGraphics::EventId ev, const CoreGraphics::PipelineStage stage)
+{
+    CoreGraphics::EventReset(ev, id, stage);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdBeginPass(const CmdBufferId id, const PassId pass)
+{
+    NullPipelineBundle& pipelineBundle = commandBuffers.Get<CmdBuffer_PipelineBundle>(id.id);
+    pipelineBundle.pass = pass;
+    pipelineBundle.subpass = 0;
+    PassSetCurrentSubpass(pass, 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdNextSubpass(const CmdBufferId id)
+{
+    NullPipelineBundle& pipelineBundle = commandBuffers.Get<CmdBuffer_PipelineBundle>(id.id);
+    pipelineBundle.subpass++;
+    PassSetCurrentSubpass(pipelineBundle.pass, pipelineBundle.subpass);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdEndPass(const CmdBufferId id)
+{
+    NullPipelineBundle& pipelineBundle = commandBuffers.Get<CmdBuffer_PipelineBundle>(id.id);
+    PassSetCurrentSubpass(pipelineBundle.pass, 0);
+    pipelineBundle.pass = InvalidPassId;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdResetClipToPass(const CmdBufferId id)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdDraw(const CmdBufferId id, const CoreGraphics::PrimitiveGroup& pg)
+{
+    CmdDraw(id, 1, 0, pg);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdDraw(const CmdBufferId id, SizeT numInstances, const CoreGraphics::PrimitiveGroup& pg)
+{
+    CmdDraw(id, numInstances, 0, pg);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdDraw(const CmdBufferId id, SizeT numInstances, IndexT baseInstance, const CoreGraphics::PrimitiveGroup& pg)
+{
+    const NullPipelineBundle& pipelineBundle = commandBuffers.Get<CmdBuffer_PipelineBundle>(id.id);
+    NullCmdBufferStats& stats = commandBuffers.Get<CmdBuffer_Stats>(id.id);
+    stats.numDrawCalls++;
+    stats.numPrimitives += pg.GetNumPrimitives(pipelineBundle.topology) * numInstances;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdDrawIndirect(const CmdBufferId id, const CoreGraphics::BufferId buffer, IndexT bufferOffset, SizeT numDraws, SizeT stride)
+{
+    commandBuffers.Get<CmdBuffer_Stats>(id.id).numDrawCalls += numDraws;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdDrawIndirectIndexed(const CmdBufferId id, const CoreGraphics::BufferId buffer, IndexT bufferOffset, SizeT numDraws, SizeT stride)
+{
+    commandBuffers.Get<CmdBuffer_Stats>(id.id).numDrawCalls += numDraws;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdDispatch(const CmdBufferId id, int dimX, int dimY, int dimZ)
+{
+    commandBuffers.Get<CmdBuffer_Stats>(id.id).numComputes++;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdResolve(const CmdBufferId id, const CoreGraphics::TextureId source, const CoreGraphics::TextureCopy sourceCopy, const CoreGraphics::TextureId dest, const CoreGraphics::TextureCopy destCopy)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdBuildBlas(const CmdBufferId id, const CoreGraphics::BlasId blas)
+{
+    n_error("Raytracing is not supported by the null renderer");
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdBuildTlas(const CmdBufferId id, const CoreGraphics::TlasId tlas)
+{
+    n_error("Raytracing is not supported by the null renderer");
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdRaysDispatch(const CmdBufferId id, const RayDispatchTable& table, int dimX, int dimY, int dimZ)
+{
+    n_error("Raytracing is not supported by the null renderer");
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdDrawMeshlets(const CmdBufferId id, int dimX, int dimY, int dimZ)
+{
+    commandBuffers.Get<CmdBuffer_Stats>(id.id).numDrawCalls++;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdCopy(
+    const CmdBufferId id
+    , const CoreGraphics::TextureId fromTexture
+    , const Util::Array<CoreGraphics::TextureCopy>& from
+    , const CoreGraphics::TextureId toTexture
+    , const Util::Array<CoreGraphics::TextureCopy>& to
+)
+{
+    n_assert(from.Size() == to.Size());
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdCopy(
+    const CmdBufferId id
+    , const CoreGraphics::TextureId fromTexture
+    , const Util::Array<CoreGraphics::TextureCopy>& from
+    , const CoreGraphics::BufferId toBuffer
+    , const Util::Array<CoreGraphics::BufferCopy>& to
+)
+{
+    n_assert(from.Size() == to.Size());
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdCopy(
+    const CmdBufferId id
+    , const CoreGraphics::BufferId fromBuffer
+    , const Util::Array<CoreGraphics::BufferCopy>& from
+    , const CoreGraphics::BufferId toBuffer
+    , const Util::Array<CoreGraphics::BufferCopy>& to
+    , const SizeT size
+)
+{
+    n_assert(from.Size() == to.Size());
+
+    // buffers live in CPU memory, so copies can be done right away
+    const byte* src = (const byte*)BufferMap(fromBuffer);
+    byte* dst = (byte*)BufferMap(toBuffer);
+    for (IndexT i = 0; i < from.Size(); i++)
+        memmove(dst + to[i].offset, src + from[i].offset, size);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdCopy(
+    const CmdBufferId id
+    , const CoreGraphics::BufferId fromBuffer
+    , const Util::Array<CoreGraphics::BufferCopy>& from
+    , const CoreGraphics::TextureId toTexture
+    , const Util::Array<CoreGraphics::TextureCopy>& to
+)
+{
+    n_assert(from.Size() == to.Size());
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdBlit(
+    const CmdBufferId id
+    , const CoreGraphics::TextureId from
+    , const Math::rectangle<SizeT>& fromRegion
+    , const CoreGraphics::ImageBits fromBits
+    , IndexT fromMip
+    , IndexT fromLayer
+    , const CoreGraphics::TextureId to
+    , const Math::rectangle<SizeT>& toRegion
+    , const CoreGraphics::ImageBits toBits
+    , IndexT toMip
+    , IndexT toLayer
+)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdSetViewports(const CmdBufferId id, Util::FixedArray<Math::rectangle<int>> viewports)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdSetScissors(const CmdBufferId id, Util::FixedArray<Math::rectangle<int>> rects)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdSetViewport(const CmdBufferId id, const Math::rectangle<int>& rect, int index)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdSetScissorRect(const CmdBufferId id, const Math::rectangle<int>& rect, int index)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdSetStencilRef(const CmdBufferId id, const uint frontRef, const uint backRef)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdSetStencilReadMask(const CmdBufferId id, const uint readMask)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdSetStencilWriteMask(const CmdBufferId id, const uint writeMask)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdUpdateBuffer(const CmdBufferId id, const CoreGraphics::BufferId buffer, uint offset, uint size, const void* data)
+{
+    memcpy((byte*)BufferMap(buffer) + offset, data, size);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdStartOcclusionQueries(const CmdBufferId id)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdEndOcclusionQueries(const CmdBufferId id)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdStartPipelineQueries(const CmdBufferId id)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdEndPipelineQueries(const CmdBufferId id)
+{
+    // empty
+}
+
+#if NEBULA_GRAPHICS_DEBUG
+//------------------------------------------------------------------------------
+/**
+    There are no timestamps to write, markers are kept so profiling still
+    shows the frame structure.
+*/
+void
+CmdBeginMarker(const CmdBufferId id, const Math::vec4& color, const char* name)
+{
+#if NEBULA_ENABLE_PROFILING
+    CmdBufferMarkerBundle& markers = commandBuffers.Get<CmdBuffer_ProfilingMarkers>(id.id);
+    FrameProfilingMarker marker;
+    marker.color = color;
+    marker.name = name;
+    marker.queue = commandBuffers.Get<CmdBuffer_Usage>(id.id);
+    marker.gpuBegin = InvalidIndex;
+    marker.gpuEnd = InvalidIndex;
+    marker.start = 0;
+    marker.duration = 0;
+    markers.markerStack.Push(marker);
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdEndMarker(const CmdBufferId id)
+{
+#if NEBULA_ENABLE_PROFILING
+    CmdBufferMarkerBundle& markers = commandBuffers.Get<CmdBuffer_ProfilingMarkers>(id.id);
+    n_assert(!markers.markerStack.IsEmpty());
+    FrameProfilingMarker marker = markers.markerStack.Pop();
+    if (markers.markerStack.IsEmpty())
+        markers.finishedMarkers.Append(marker);
+    else
+        markers.markerStack.Peek().children.Append(marker);
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdInsertMarker(const CmdBufferId id, const Math::vec4& color, const char* name)
+{
+    // empty
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CmdFinishQueries(const CmdBufferId id)
+{
+    // empty
+}
+
+#if NEBULA_ENABLE_PROFILING
+//------------------------------------------------------------------------------
+/**
+*/
+Util::Array<CoreGraphics::FrameProfilingMarker>
+CmdCopyProfilingMarkers(const CmdBufferId id)
+{
+    CoreGraphics::CmdBufferMarkerBundle& markers = commandBuffers.Get<CmdBuffer_ProfilingMarkers>(id.id);
+    return markers.finishedMarkers;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+uint
+CmdGetMarkerOffset(const CmdBufferId id)
+{
+    return 0;
+}
+#endif
+
+} // namespace CoreGraphics
@@ -0,0 +1,70 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    Null command buffer implementation
+
+    Commands are not recorded, the command buffer only tracks the state the
+    rest of the engine queries and counts the draws and dispatches, which
+    are accumulated into the graphics device counters on submission.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "ids/idallocator.h"
+#include "coregraphics/commandbuffer.h"
+#include "coregraphics/pass.h"
+#include "coregraphics/shader.h"
+
+namespace Null
+{
+
+enum
+{
+    CommandBufferPool_Queue
+};
+typedef Ids::IdAllocator<CoreGraphics::QueueType> NullCommandBufferPoolAllocator;
+extern NullCommandBufferPoolAllocator commandBufferPools;
+
+struct NullCmdBufferStats
+{
+    SizeT numDrawCalls;
+    SizeT numPrimitives;
+    SizeT numComputes;
+};
+
+struct NullPipelineBundle
+{
+    CoreGraphics::PassId pass;
+    uint32_t subpass;
+    CoreGraphics::ShaderProgramId program;
+    CoreGraphics::PrimitiveTopology::Code topology;
+};
+
+enum
+{
+    CmdBuffer_Pool
+    , CmdBuffer_Usage
+    , CmdBuffer_PipelineBundle
+    , CmdBuffer_Stats
+#if NEBULA_ENABLE_PROFILING
+    , CmdBuffer_ProfilingMarkers
+#endif
+};
+
+typedef Ids::IdAllocatorSafe<
+    0xFFF
+    , CoreGraphics::CmdBufferPoolId
+    , CoreGraphics::QueueType
+    , NullPipelineBundle
+    , NullCmdBufferStats
+#if NEBULA_ENABLE_PROFILING
+    , CoreGraphics::CmdBufferMarkerBundle
+#endif
+> NullCommandBufferAllocator;
+extern NullCommandBufferAllocator commandBuffers;
+
+/// get the draw and dispatch counts recorded since the last reset, and clear them
+NullCmdBufferStats CmdBufferTakeStats(const CoreGraphics::CmdBufferId id);
+
+} // namespace Null
@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------
+//  nullevent.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "nullevent.h"
+#ifdef CreateEvent
+#pragma push_macro("CreateEvent")
+#undef CreateEvent
+#endif
+
+namespace Null
+{
+NullEventAllocator eventAllocator(0x00FFFFFF);
+} // namespace Null
+
+namespace CoreGraphics
+{
+
+using namespace Null;
+
+//------------------------------------------------------------------------------
+/**
+*/
+EventId
+CreateEvent(const EventCreateInfo& info)
+{
+    Ids::Id32 id = eventAllocator.Alloc();
+    eventAllocator.Get<Event_Name>(id) = info.name;
+    eventAllocator.Get<Event_Signaled>(id) = info.createSignaled;
+    EventId ret = id;
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyEvent(const EventId id)
+{
+    eventAllocator.Dealloc(id.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Command buffers execute immediately, so signaling on a command buffer
+    signals right away
+*/
+void
+EventSignal(const EventId id, const CoreGraphics::CmdBufferId buf, const CoreGraphics::PipelineStage stage)
+{
+    eventAllocator.Get<Event_Signaled>(id.id) = true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+EventWait(
+    const EventId id,
+    const CoreGraphics::CmdBufferId buf,
+    const CoreGraphics::PipelineStage waitStage,
+    const CoreGraphics::PipelineStage signalStage)
+{
+    // empty, there is nothing to wait for
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+EventReset(const EventId id, const CoreGraphics::CmdBufferId buf, const CoreGraphics::PipelineStage stage)
+{
+    eventAllocator.Get<Event_Signaled>(id.id) = false;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+EventWaitAndReset(const EventId id, const CoreGraphics::CmdBufferId buf, const CoreGraphics::PipelineStage waitStage, const CoreGraphics::PipelineStage signalStage)
+{
+    EventWait(id, buf, waitStage, signalStage);
+    EventReset(id, buf, signalStage);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+EventPoll(const EventId id)
+{
+    return eventAllocator.Get<Event_Signaled>(id.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+EventHostReset(const EventId id)
+{
+    eventAllocator.Get<Event_Signaled>(id.id) = false;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+EventHostSignal(const EventId id)
+{
+    eventAllocator.Get<Event_Signaled>(id.id) = true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+EventHostWait(const EventId id)
+{
+    n_assert2(eventAllocator.Get<Event_Signaled>(id.id), "Waiting on an event which is never going to be signaled");
+}
+
+} // namespace CoreGraphics
+
+#pragma pop_macro("CreateEvent")
@@ -0,0 +1,27 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    Null event, only keeps track of the signal state set from the host
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "ids/idallocator.h"
+#include "coregraphics/event.h"
+namespace Null
+{
+
+enum
+{
+    Event_Name,
+    Event_Signaled
+};
+
+typedef Ids::IdAllocator<
+    Util::StringAtom,
+    bool
+> NullEventAllocator;
+extern NullEventAllocator eventAllocator;
+
+} // namespace Null
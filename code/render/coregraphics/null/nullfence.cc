@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+//  nullfence.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "nullfence.h"
+
+namespace Null
+{
+
+NullFenceAllocator fenceAllocator(0x00FFFFFF);
+
+} // namespace Null
+
+namespace CoreGraphics
+{
+
+using namespace Null;
+
+//------------------------------------------------------------------------------
+/**
+*/
+FenceId
+CreateFence(const FenceCreateInfo& info)
+{
+    Ids::Id32 id = fenceAllocator.Alloc();
+    fenceAllocator.Get<0>(id) = info.createSignaled;
+    FenceId ret = id;
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyFence(const FenceId id)
+{
+    fenceAllocator.Dealloc(id.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+FencePeek(const FenceId id)
+{
+    return fenceAllocator.Get<0>(id.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+FenceReset(const FenceId id)
+{
+    fenceAllocator.Get<0>(id.id) = false;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Work is completed as soon as it is submitted, so waiting always succeeds
+*/
+bool
+FenceWait(const FenceId id, const uint64 time)
+{
+    fenceAllocator.Get<0>(id.id) = true;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+FenceWaitAndReset(const FenceId id, const uint64 time)
+{
+    bool ret = FenceWait(id, time);
+    if (ret)
+        FenceReset(id);
+    return ret;
+}
+
+} // namespace CoreGraphics
@@ -0,0 +1,20 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    Null fence, there is never any outstanding work so waits return at once
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "ids/idallocator.h"
+#include "coregraphics/fence.h"
+namespace Null
+{
+
+typedef Ids::IdAllocator<
+    bool
+> NullFenceAllocator;
+extern NullFenceAllocator fenceAllocator;
+
+} // namespace Null
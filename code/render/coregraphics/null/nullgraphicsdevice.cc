@@ -0,0 +1,1151 @@
+//------------------------------------------------------------------------------
+//  nullgraphicsdevice.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "coregraphics/config.h"
+#include "nullgraphicsdevice.h"
+#include "nullcommandbuffer.h"
+#include "nullmemory.h"
+#include "coregraphics/commandbuffer.h"
+#include "coregraphics/buffer.h"
+#include "coregraphics/fence.h"
+#include "coregraphics/semaphore.h"
+#include "coregraphics/displaydevice.h"
+#include "profiling/profiling.h"
+#include "threading/criticalsection.h"
+#include "threading/interlocked.h"
+
+namespace Null
+{
+static Threading::CriticalSection transferLock;
+static Threading::CriticalSection setupLock;
+
+struct GraphicsDeviceState : CoreGraphics::GraphicsDeviceState
+{
+    struct ConstantsRingBuffer
+    {
+        Threading::AtomicCounter endAddress;
+        bool allowConstantAllocation;
+    };
+    Util::FixedArray<ConstantsRingBuffer> constantBufferRings;
+
+    struct UploadRingBuffer
+    {
+        Util::Array<Memory::RangeAllocation> allocs;
+        Util::Array<uint> allocSizes;
+    };
+    Util::FixedArray<UploadRingBuffer> uploadRingBuffers;
+    CoreGraphics::BufferId uploadBuffer;
+
+    uint64 submissionIndices[CoreGraphics::QueueType::NumQueueTypes];
+    CoreGraphics::SubmissionWaitEvent mostRecentEvents[CoreGraphics::QueueType::NumQueueTypes];
+    uint64 numSubmissions;
+
+#if NEBULA_ENABLE_PROFILING
+    Util::FixedArray<Util::Array<CoreGraphics::FrameProfilingMarker>> pendingMarkers;
+#endif
+
+    Util::Set<uint32_t> usedQueueFamilies;
+} state;
+
+// matches the minimum uniform buffer offset alignment most devices report
+static const uint ConstantBufferAlignment = 256;
+
+//------------------------------------------------------------------------------
+/**
+*/
+uint64
+GetNumSubmissions()
+{
+    return state.numSubmissions;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Nothing is executed, so the stats of the command buffer are what's left
+    of the submission.
+*/
+static CoreGraphics::SubmissionWaitEvent
+Submit(const CoreGraphics::CmdBufferId cmds, CoreGraphics::QueueType type)
+{
+    NullCmdBufferStats stats = CmdBufferTakeStats(cmds);
+    _incr_counter(state.GraphicsDeviceNumDrawCalls, stats.numDrawCalls);
+    _incr_counter(state.GraphicsDeviceNumPrimitives, stats.numPrimitives);
+    _incr_counter(state.GraphicsDeviceNumComputes, stats.numComputes);
+
+    CoreGraphics::SubmissionWaitEvent ret;
+    ret.timelineIndex = state.submissionIndices[type]++;
+    ret.queue = type;
+    state.mostRecentEvents[type] = ret;
+    state.numSubmissions++;
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static void
+SubmitSetupCommandBuffer(CoreGraphics::CmdBufferId& cmds, CoreGraphics::QueueType type)
+{
+    if (cmds != CoreGraphics::InvalidCmdBufferId)
+    {
+        CoreGraphics::CmdBufferIdAcquire(cmds);
+        CoreGraphics::CmdEndRecord(cmds);
+        Submit(cmds, type);
+
+        // Delete command buffer
+        CoreGraphics::DestroyCmdBuffer(cmds);
+        CoreGraphics::CmdBufferIdRelease(cmds);
+
+        // Reset command buffer id for the next frame
+        cmds = CoreGraphics::InvalidCmdBufferId;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static const CoreGraphics::CmdBufferId
+LockSetupCommandBuffer(CoreGraphics::CmdBufferId& cmds, CoreGraphics::CmdBufferPoolId pool, CoreGraphics::QueueType type)
+{
+    if (cmds == CoreGraphics::InvalidCmdBufferId)
+    {
+        CoreGraphics::CmdBufferCreateInfo cmdCreateInfo;
+        cmdCreateInfo.pool = pool;
+        cmdCreateInfo.usage = type;
+        cmdCreateInfo.queryTypes = CoreGraphics::CmdBufferQueryBits::NoQueries;
+        cmds = CoreGraphics::CreateCmdBuffer(cmdCreateInfo);
+        CoreGraphics::CmdBeginRecord(cmds, { true, false, false });
+    }
+    else
+    {
+        CoreGraphics::CmdBufferIdAcquire(cmds);
+    }
+    return cmds;
+}
+
+} // namespace Null
+
+namespace CoreGraphics
+{
+
+bool RayTracingSupported = false;
+bool DynamicVertexInputSupported = false;
+bool MeshShadersSupported = false;
+bool VariableRateShadingSupported = false;
+using namespace Null;
+
+N_DECLARE_COUNTER(N_CONSTANT_MEMORY, Graphics Constant Memory);
+N_DECLARE_COUNTER(N_VERTEX_MEMORY, Vertex Memory);
+N_DECLARE_COUNTER(N_INDEX_MEMORY, Index Memory);
+N_DECLARE_COUNTER(N_UPLOAD_MEMORY, Upload Memory);
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+CreateGraphicsDevice(const GraphicsDeviceCreateInfo& info)
+{
+    DisplayDevice* displayDevice = DisplayDevice::Instance();
+    n_assert(displayDevice->IsOpen());
+
+    state.enableValidation = info.enableValidation;
+
+    // setup memory pools
+    SetupMemoryPools(
+        info.memoryHeaps[MemoryPool_DeviceLocal],
+        info.memoryHeaps[MemoryPool_HostLocal],
+        info.memoryHeaps[MemoryPool_HostCached],
+        info.memoryHeaps[MemoryPool_DeviceAndHost]
+        );
+
+    state.constantBufferRings.Resize(info.numBufferedFrames);
+
+    N_BUDGET_COUNTER_SETUP(N_CONSTANT_MEMORY, info.globalConstantBufferMemorySize);
+    N_BUDGET_COUNTER_SETUP(N_VERTEX_MEMORY, info.globalVertexBufferMemorySize);
+    N_BUDGET_COUNTER_SETUP(N_INDEX_MEMORY, info.globalIndexBufferMemorySize);
+    N_BUDGET_COUNTER_SETUP(N_UPLOAD_MEMORY, info.globalUploadMemorySize);
+
+    IndexT i;
+    for (i = 0; i < info.numBufferedFrames; i++)
+    {
+        Null::GraphicsDeviceState::ConstantsRingBuffer& cboRing = state.constantBufferRings[i];
+        cboRing.allowConstantAllocation = true;
+        cboRing.endAddress = 0;
+    }
+
+    BufferCreateInfo cboInfo;
+    state.globalConstantBufferMaxValue = info.globalConstantBufferMemorySize;
+    cboInfo.name = "Global Constant Buffer";
+    cboInfo.byteSize = info.globalConstantBufferMemorySize;
+    cboInfo.mode = CoreGraphics::BufferAccessMode::DeviceAndHost;
+    cboInfo.usageFlags = CoreGraphics::ConstantBuffer | CoreGraphics::TransferBufferDestination;
+    cboInfo.queueSupport = CoreGraphics::GraphicsQueueSupport | CoreGraphics::ComputeQueueSupport;
+    state.globalConstantBuffer.Resize(info.numBufferedFrames);
+    for (i = 0; i < info.numBufferedFrames; i++)
+    {
+        state.globalConstantBuffer[i] = CreateBuffer(cboInfo);
+    }
+
+    state.maxNumBufferedFrames = info.numBufferedFrames;
+
+#ifdef CreateSemaphore
+#pragma push_macro("CreateSemaphore")
+#undef CreateSemaphore
+#endif
+
+    state.presentFences.Resize(info.numBufferedFrames);
+    state.renderingFinishedSemaphores.Resize(info.numBufferedFrames);
+    for (i = 0; i < info.numBufferedFrames; i++)
+    {
+        state.presentFences[i] = CreateFence({ true });
+        state.renderingFinishedSemaphores[i] = CreateSemaphore({ SemaphoreType::Binary });
+    }
+
+#pragma pop_macro("CreateSemaphore")
+
+    // Setup "special" command buffers
+    CoreGraphics::CmdBufferPoolCreateInfo setupResourcePoolInfo;
+    setupResourcePoolInfo.queue = CoreGraphics::QueueType::GraphicsQueueType;
+    setupResourcePoolInfo.resetable = true;
+    setupResourcePoolInfo.shortlived = true;
+    state.setupGraphicsCommandBufferPool = CoreGraphics::CreateCmdBufferPool(setupResourcePoolInfo);
+    state.setupGraphicsCommandBuffer = CoreGraphics::InvalidCmdBufferId;
+    setupResourcePoolInfo.queue = CoreGraphics::QueueType::TransferQueueType;
+    state.setupTransferCommandBufferPool = CoreGraphics::CreateCmdBufferPool(setupResourcePoolInfo);
+    state.setupTransferCommandBuffer = CoreGraphics::InvalidCmdBufferId;
+    state.handoverTransferCommandBuffer = CoreGraphics::InvalidCmdBufferId;
+
+    for (i = 0; i < CoreGraphics::QueueType::NumQueueTypes; i++)
+    {
+        state.submissionIndices[i] = 0;
+        state.usedQueueFamilies.Add(i);
+    }
+    state.numSubmissions = 0;
+
+#if NEBULA_ENABLE_PROFILING
+    state.pendingMarkers.Resize(info.numBufferedFrames);
+#endif
+
+    CoreGraphics::BufferCreateInfo vboInfo;
+    vboInfo.name = "Global Vertex Cache";
+    vboInfo.byteSize = info.globalVertexBufferMemorySize;
+    vboInfo.mode = CoreGraphics::BufferAccessMode::DeviceLocal;
+    vboInfo.queueSupport = CoreGraphics::BufferQueueSupport::GraphicsQueueSupport | CoreGraphics::BufferQueueSupport::ComputeQueueSupport;
+    vboInfo.usageFlags =
+        CoreGraphics::BufferUsageFlag::VertexBuffer
+        | CoreGraphics::BufferUsageFlag::TransferBufferDestination
+        | CoreGraphics::BufferUsageFlag::ReadWriteBuffer;
+    state.vertexBuffer = CoreGraphics::CreateBuffer(vboInfo);
+    state.vertexAllocator = Memory::RangeAllocator(info.globalVertexBufferMemorySize, 2048);
+
+    CoreGraphics::BufferCreateInfo iboInfo;
+    iboInfo.name = "Global Index Cache";
+    iboInfo.byteSize = info.globalIndexBufferMemorySize;
+    iboInfo.mode = CoreGraphics::BufferAccessMode::DeviceLocal;
+    iboInfo.queueSupport = CoreGraphics::BufferQueueSupport::GraphicsQueueSupport | CoreGraphics::BufferQueueSupport::ComputeQueueSupport;
+    iboInfo.usageFlags =
+        CoreGraphics::BufferUsageFlag::IndexBuffer
+        | CoreGraphics::BufferUsageFlag::TransferBufferDestination
+        | CoreGraphics::BufferUsageFlag::ReadWriteBuffer;
+    state.indexBuffer = CoreGraphics::CreateBuffer(iboInfo);
+    state.indexAllocator = Memory::RangeAllocator(info.globalIndexBufferMemorySize, 2048);
+
+    CoreGraphics::BufferCreateInfo uploadInfo;
+    uploadInfo.name = "Global Upload Buffer";
+    uploadInfo.byteSize = info.globalUploadMemorySize;
+    uploadInfo.mode = CoreGraphics::BufferAccessMode::HostLocal;
+    uploadInfo.queueSupport = CoreGraphics::BufferQueueSupport::GraphicsQueueSupport | CoreGraphics::BufferQueueSupport::ComputeQueueSupport;
+    uploadInfo.usageFlags = CoreGraphics::BufferUsageFlag::TransferBufferSource;
+    state.uploadBuffer = CoreGraphics::CreateBuffer(uploadInfo);
+    state.globalUploadBufferPoolSize = info.globalUploadMemorySize;
+    state.uploadRingBuffers.Resize(info.numBufferedFrames);
+    state.uploadAllocator = Memory::RangeAllocator(info.globalUploadMemorySize, 2048);
+
+    _setup_grouped_counter(state.NumImageBytesAllocated, "GraphicsDevice");
+    _begin_counter(state.NumImageBytesAllocated);
+    _setup_grouped_counter(state.NumBufferBytesAllocated, "GraphicsDevice");
+    _begin_counter(state.NumBufferBytesAllocated);
+    _setup_grouped_counter(state.NumBytesAllocated, "GraphicsDevice");
+    _begin_counter(state.NumBytesAllocated);
+    _setup_grouped_counter(state.GraphicsDeviceNumComputes, "GraphicsDevice");
+    _begin_counter(state.GraphicsDeviceNumComputes);
+    _setup_grouped_counter(state.GraphicsDeviceNumPrimitives, "GraphicsDevice");
+    _begin_counter(state.GraphicsDeviceNumPrimitives);
+    _setup_grouped_counter(state.GraphicsDeviceNumDrawCalls, "GraphicsDevice");
+    _begin_counter(state.GraphicsDeviceNumDrawCalls);
+
+    state.isOpen = true;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyGraphicsDevice()
+{
+    _end_counter(state.GraphicsDeviceNumDrawCalls);
+    _discard_counter(state.GraphicsDeviceNumDrawCalls);
+    _end_counter(state.GraphicsDeviceNumPrimitives);
+    _discard_counter(state.GraphicsDeviceNumPrimitives);
+    _end_counter(state.GraphicsDeviceNumComputes);
+    _discard_counter(state.GraphicsDeviceNumComputes);
+    _end_counter(state.NumImageBytesAllocated);
+    _discard_counter(state.NumImageBytesAllocated);
+    _end_counter(state.NumBufferBytesAllocated);
+    _discard_counter(state.NumBufferBytesAllocated);
+    _end_counter(state.NumBytesAllocated);
+    _discard_counter(state.NumBytesAllocated);
+
+    DestroyBuffer(state.vertexBuffer);
+    DestroyBuffer(state.indexBuffer);
+    DestroyBuffer(state.uploadBuffer);
+    IndexT i;
+    for (i = 0; i < state.globalConstantBuffer.Size(); i++)
+    {
+        DestroyBuffer(state.globalConstantBuffer[i]);
+    }
+
+    for (i = 0; i < state.renderingFinishedSemaphores.Size(); i++)
+    {
+        DestroyFence(state.presentFences[i]);
+        DestroySemaphore(state.renderingFinishedSemaphores[i]);
+    }
+
+    DestroyCmdBufferPool(state.setupGraphicsCommandBufferPool);
+    DestroyCmdBufferPool(state.setupTransferCommandBufferPool);
+
+    DiscardMemoryPools();
+    state.isOpen = false;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+GetNumBufferedFrames()
+{
+    return state.maxNumBufferedFrames;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+IndexT
+GetBufferedFrameIndex()
+{
+    return state.currentBufferedFrameIndex;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AttachEventHandler(const Ptr<CoreGraphics::RenderEventHandler>& h)
+{
+    n_assert(h.isvalid());
+    n_assert(InvalidIndex == state.eventHandlers.FindIndex(h));
+    n_assert(!state.inNotifyEventHandlers);
+    state.eventHandlers.Append(h);
+    h->OnAttach();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+RemoveEventHandler(const Ptr<CoreGraphics::RenderEventHandler>& h)
+{
+    n_assert(h.isvalid());
+    n_assert(!state.inNotifyEventHandlers);
+    IndexT index = state.eventHandlers.FindIndex(h);
+    n_assert(InvalidIndex != index);
+    state.eventHandlers.EraseIndex(index);
+    h->OnRemove();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+NotifyEventHandlers(const CoreGraphics::RenderEvent& e)
+{
+    n_assert(!state.inNotifyEventHandlers);
+    bool handled = false;
+    state.inNotifyEventHandlers = true;
+    IndexT i;
+    for (i = 0; i < state.eventHandlers.Size(); i++)
+    {
+        handled |= state.eventHandlers[i]->PutEvent(e);
+    }
+    state.inNotifyEventHandlers = false;
+    return handled;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AddBackBufferTexture(const CoreGraphics::TextureId tex)
+{
+    state.backBuffers.Append(tex);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+RemoveBackBufferTexture(const CoreGraphics::TextureId tex)
+{
+    IndexT i = state.backBuffers.FindIndex(tex);
+    n_assert(i != InvalidIndex);
+    state.backBuffers.EraseIndex(i);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CoreGraphics::CmdBufferId
+LockTransferSetupCommandBuffer()
+{
+    transferLock.Enter();
+    return LockSetupCommandBuffer(state.setupTransferCommandBuffer, state.setupTransferCommandBufferPool, CoreGraphics::TransferQueueType);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+UnlockTransferSetupCommandBuffer()
+{
+    CmdBufferIdRelease(state.setupTransferCommandBuffer);
+    transferLock.Leave();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CoreGraphics::CmdBufferId
+LockGraphicsSetupCommandBuffer()
+{
+    setupLock.Enter();
+    return LockSetupCommandBuffer(state.setupGraphicsCommandBuffer, state.setupGraphicsCommandBufferPool, CoreGraphics::GraphicsQueueType);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+UnlockGraphicsSetupCommandBuffer()
+{
+    CmdBufferIdRelease(state.setupGraphicsCommandBuffer);
+    setupLock.Leave();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CoreGraphics::CmdBufferId
+LockTransferHandoverSetupCommandBuffer()
+{
+    transferLock.Enter();
+    return LockSetupCommandBuffer(state.handoverTransferCommandBuffer, state.setupTransferCommandBufferPool, CoreGraphics::TransferQueueType);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+UnlockTransferHandoverSetupCommandBuffer()
+{
+    CmdBufferIdRelease(state.handoverTransferCommandBuffer);
+    transferLock.Leave();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+uint64
+NextSubmissionIndex(const CoreGraphics::QueueType queue)
+{
+    return state.submissionIndices[queue];
+}
+
+//------------------------------------------------------------------------------
+/**
+    Submissions complete as soon as they are made.
+*/
+bool
+PollSubmissionIndex(const CoreGraphics::QueueType queue, uint64 index)
+{
+    return index < state.submissionIndices[queue];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+CoreGraphics::SubmissionWaitEvent
+SubmitCommandBuffer(const CoreGraphics::CmdBufferId cmds, CoreGraphics::QueueType type)
+{
+    transferLock.Enter();
+    SubmitSetupCommandBuffer(state.setupTransferCommandBuffer, CoreGraphics::TransferQueueType);
+    SubmitSetupCommandBuffer(state.handoverTransferCommandBuffer, CoreGraphics::TransferQueueType);
+    transferLock.Leave();
+
+    setupLock.Enter();
+    SubmitSetupCommandBuffer(state.setupGraphicsCommandBuffer, CoreGraphics::GraphicsQueueType);
+    setupLock.Leave();
+
+#if NEBULA_ENABLE_PROFILING
+    state.pendingMarkers[state.currentBufferedFrameIndex].AppendArray(CmdCopyProfilingMarkers(cmds));
+#endif
+    return Submit(cmds, type);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+WaitForSubmission(SubmissionWaitEvent index, CoreGraphics::QueueType type, CoreGraphics::QueueType waitType)
+{
+    // empty, submissions are already done
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+WaitForLastSubmission(CoreGraphics::QueueType type, CoreGraphics::QueueType waitType)
+{
+    // empty, submissions are already done
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+UnlockConstantUpdates()
+{
+    Null::GraphicsDeviceState::ConstantsRingBuffer& sub = state.constantBufferRings[state.currentBufferedFrameIndex];
+    sub.allowConstantAllocation = true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+LockConstantUpdates()
+{
+    Null::GraphicsDeviceState::ConstantsRingBuffer& sub = state.constantBufferRings[state.currentBufferedFrameIndex];
+    sub.allowConstantAllocation = false;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Set constants for preallocated memory
+*/
+void
+SetConstantsInternal(ConstantBufferOffset offset, const void* data, SizeT size)
+{
+    BufferUpdate(state.globalConstantBuffer[state.currentBufferedFrameIndex], data, size, offset);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+ConstantBufferOffset
+AllocateConstantBufferMemory(uint size)
+{
+    Null::GraphicsDeviceState::ConstantsRingBuffer& sub = state.constantBufferRings[state.currentBufferedFrameIndex];
+    n_assert(sub.allowConstantAllocation);
+
+    // Calculate aligned upper bound
+    int alignedSize = Math::align(size, ConstantBufferAlignment);
+    N_BUDGET_COUNTER_INCR(N_CONSTANT_MEMORY, alignedSize);
+
+    // Allocate the memory range
+    int ret = Threading::Interlocked::Add(&sub.endAddress, alignedSize);
+    if (ret + alignedSize >= state.globalConstantBufferMaxValue)
+    {
+        n_error("Over allocation of constant memory! Memory will be overwritten!\n");
+    }
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+CoreGraphics::BufferId
+GetConstantBuffer(IndexT i)
+{
+    return state.globalConstantBuffer[i];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Threading::CriticalSection vertexAllocationMutex;
+
+//------------------------------------------------------------------------------
+/**
+*/
+const VertexAlloc
+AllocateVertices(const SizeT numVertices, const SizeT vertexSize)
+{
+    Threading::CriticalScope scope(&vertexAllocationMutex);
+    const uint size = numVertices * vertexSize;
+    Memory::RangeAllocation alloc = state.vertexAllocator.Alloc(size);
+    n_assert(alloc.offset != alloc.OOM);
+    N_BUDGET_COUNTER_INCR(N_VERTEX_MEMORY, size);
+    return VertexAlloc{ .size = size, .offset = alloc.offset, .node = alloc.node };
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const VertexAlloc
+AllocateVertices(const SizeT bytes)
+{
+    Threading::CriticalScope scope(&vertexAllocationMutex);
+    Memory::RangeAllocation alloc = state.vertexAllocator.Alloc(bytes);
+    n_assert(alloc.offset != alloc.OOM);
+    N_BUDGET_COUNTER_INCR(N_VERTEX_MEMORY, bytes);
+    return VertexAlloc{ .size = (uint)bytes, .offset = alloc.offset, .node = alloc.node };
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DeallocateVertices(const VertexAlloc& alloc)
+{
+    Threading::CriticalScope scope(&vertexAllocationMutex);
+    state.vertexAllocator.Dealloc(Memory::RangeAllocation{.offset = (uint)alloc.offset, .node = alloc.node});
+    N_BUDGET_COUNTER_DECR(N_VERTEX_MEMORY, alloc.size);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CoreGraphics::BufferId
+GetVertexBuffer()
+{
+    return state.vertexBuffer;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const VertexAlloc
+AllocateIndices(const SizeT numIndices, const IndexType::Code indexType)
+{
+    Threading::CriticalScope scope(&vertexAllocationMutex);
+    uint indexSize = IndexType::SizeOf(indexType);
+    uint size = numIndices * indexSize;
+    Memory::RangeAllocation alloc = state.indexAllocator.Alloc(size, indexSize);
+    n_assert(alloc.offset != alloc.OOM);
+    N_BUDGET_COUNTER_INCR(N_INDEX_MEMORY, size);
+    return VertexAlloc{ .size = size, .offset = alloc.offset, .node = alloc.node };
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const VertexAlloc
+AllocateIndices(const SizeT bytes)
+{
+    Threading::CriticalScope scope(&vertexAllocationMutex);
+    Memory::RangeAllocation alloc = state.indexAllocator.Alloc(bytes, 4);
+    n_assert(alloc.offset != alloc.OOM);
+    N_BUDGET_COUNTER_INCR(N_INDEX_MEMORY, bytes);
+    return VertexAlloc{ .size = (uint)bytes, .offset = alloc.offset, .node = alloc.node };
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DeallocateIndices(const VertexAlloc& alloc)
+{
+    Threading::CriticalScope scope(&vertexAllocationMutex);
+    state.indexAllocator.Dealloc(Memory::RangeAllocation{.offset = (uint)alloc.offset, .node = alloc.node});
+    N_BUDGET_COUNTER_DECR(N_INDEX_MEMORY, alloc.size);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CoreGraphics::BufferId
+GetIndexBuffer()
+{
+    return state.indexBuffer;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Threading::CriticalSection UploadLock;
+Util::Pair<uint, CoreGraphics::BufferId>
+AllocateUpload(const SizeT numBytes, const SizeT alignment)
+{
+    Threading::CriticalScope _0(&UploadLock);
+    Null::GraphicsDeviceState::UploadRingBuffer& ring = state.uploadRingBuffers[state.currentBufferedFrameIndex];
+
+    const SizeT alignedBytes = numBytes + alignment - 1;
+    N_BUDGET_COUNTER_INCR(N_UPLOAD_MEMORY, alignedBytes);
+
+    Memory::RangeAllocation alloc = state.uploadAllocator.Alloc(numBytes, alignment);
+    if (alloc.offset != alloc.OOM)
+    {
+        ring.allocs.Append(alloc);
+        ring.allocSizes.Append(alignedBytes);
+        return Util::MakePair(alloc.offset, state.uploadBuffer);
+    }
+    return Util::MakePair(0xFFFFFFFF, InvalidBufferId);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+UploadInternal(const CoreGraphics::BufferId buffer, const uint offset, const void* data, SizeT size)
+{
+    CoreGraphics::BufferUpdate(buffer, data, size, offset);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+FlushUpload()
+{
+    // empty, upload memory is coherent
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReloadShaderProgram(const CoreGraphics::ShaderProgramId& pro)
+{
+    // empty, no pipelines are built
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+WaitForQueue(CoreGraphics::QueueType queue)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+WaitAndClearPendingCommands()
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+    Resources are never in flight, so they are deleted right away by their
+    destroy functions and the delayed deletes have nothing left to do.
+*/
+void
+DelayedDeleteBuffer(const BufferId id)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DelayedDeleteTexture(const TextureId id)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DelayedDeleteTextureView(const TextureViewId id)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DelayedDeleteCommandBuffer(const CoreGraphics::CmdBufferId id)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DelayedFreeMemory(const CoreGraphics::Alloc alloc)
+{
+    FreeMemory(alloc);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DelayedDeleteDescriptorSet(const ResourceTableId id)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DelayedDeletePass(const CoreGraphics::PassId id)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DelayedDeleteBlas(const CoreGraphics::BlasId id)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DelayedDeleteTlas(const CoreGraphics::TlasId id)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+uint
+AllocateQueries(const CoreGraphics::QueryType type, uint numQueries)
+{
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+FinishQueries(const CoreGraphics::CmdBufferId cmdBuf, const CoreGraphics::QueryType type, IndexT* starts, SizeT* counts, SizeT numCopies)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+IndexT
+GetQueueIndex(const QueueType queue)
+{
+    return queue;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const Util::Set<uint32_t>&
+GetQueueIndices()
+{
+    return state.usedQueueFamilies;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+FinishFrame(IndexT frameIndex)
+{
+    if (state.currentFrameIndex != frameIndex)
+    {
+        _end_counter(state.GraphicsDeviceNumComputes);
+        _end_counter(state.GraphicsDeviceNumPrimitives);
+        _end_counter(state.GraphicsDeviceNumDrawCalls);
+        state.currentFrameIndex = frameIndex;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+NewFrame()
+{
+    Threading::CriticalScope transferScope(&transferLock);
+    Threading::CriticalScope setupScope(&setupLock);
+
+    // Progress to next frame
+    state.currentBufferedFrameIndex = (state.currentBufferedFrameIndex + 1) % state.maxNumBufferedFrames;
+
+#if NEBULA_ENABLE_PROFILING
+    // Markers have no timings, but keep the hierarchy for the profiler
+    state.frameProfilingMarkers = std::move(state.pendingMarkers[state.currentBufferedFrameIndex]);
+    state.pendingMarkers[state.currentBufferedFrameIndex].Clear();
+#endif
+
+    // update constant buffer offsets
+    Null::GraphicsDeviceState::ConstantsRingBuffer& nextCboRing = state.constantBufferRings[state.currentBufferedFrameIndex];
+    nextCboRing.endAddress = 0;
+
+    Threading::CriticalScope uploadScope(&UploadLock);
+    Null::GraphicsDeviceState::UploadRingBuffer& nextUploadRing = state.uploadRingBuffers[state.currentBufferedFrameIndex];
+    for (IndexT i = 0; i < nextUploadRing.allocs.Size(); i++)
+    {
+        state.uploadAllocator.Dealloc(nextUploadRing.allocs[i]);
+    }
+    nextUploadRing.allocs.Clear();
+    nextUploadRing.allocSizes.Clear();
+
+    N_BUDGET_COUNTER_RESET(N_CONSTANT_MEMORY);
+    N_BUDGET_COUNTER_RESET(N_UPLOAD_MEMORY);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+CoreGraphics::ImageFileFormat::Code
+SaveScreenshot(CoreGraphics::ImageFileFormat::Code fmt, const Ptr<IO::Stream>& outStream)
+{
+    return CoreGraphics::ImageFileFormat::InvalidImageFileFormat;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+CoreGraphics::ImageFileFormat::Code
+SaveScreenshot(CoreGraphics::ImageFileFormat::Code fmt, const Ptr<IO::Stream>& outStream, const Math::rectangle<int>& rect, int x, int y)
+{
+    return CoreGraphics::ImageFileFormat::InvalidImageFileFormat;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+GetVisualizeMipMaps()
+{
+    return state.visualizeMipMaps;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+SetVisualizeMipMaps(bool val)
+{
+    state.visualizeMipMaps = val;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+GetRenderWireframe()
+{
+    return state.renderWireframe;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+SetRenderWireframe(bool b)
+{
+    state.renderWireframe = b;
+}
+
+#if NEBULA_ENABLE_PROFILING
+//------------------------------------------------------------------------------
+/**
+*/
+IndexT
+Timestamp(CoreGraphics::QueueType queue, const CoreGraphics::PipelineStage stage, const char* name)
+{
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const Util::Array<FrameProfilingMarker>&
+GetProfilingMarkers()
+{
+    return state.frameProfilingMarkers;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+GetNumDrawCalls()
+{
+    return state.GraphicsDeviceNumDrawCalls->GetSample();
+}
+#endif
+
+#if NEBULA_GRAPHICS_DEBUG
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<>
+void
+ObjectSetName(const CoreGraphics::BufferId id, const char* name)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<>
+void
+ObjectSetName(const CoreGraphics::TextureId id, const char* name)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<>
+void
+ObjectSetName(const CoreGraphics::TextureViewId id, const char* name)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<>
+void
+ObjectSetName(const CoreGraphics::ResourceTableLayoutId id, const char* name)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<>
+void
+ObjectSetName(const CoreGraphics::ResourcePipelineId id, const char* name)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<>
+void
+ObjectSetName(const CoreGraphics::ResourceTableId id, const char* name)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<>
+void
+ObjectSetName(const CoreGraphics::CmdBufferId id, const char* name)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<>
+void
+ObjectSetName(const SemaphoreId id, const char* name)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+QueueBeginMarker(const CoreGraphics::QueueType queue, const Math::vec4& color, const char* name)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+QueueEndMarker(const CoreGraphics::QueueType queue)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+QueueInsertMarker(const CoreGraphics::QueueType queue, const Math::vec4& color, const char* name)
+{
+    // empty
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+*/
+SubmissionWaitEvent::SubmissionWaitEvent()
+    : timelineIndex(UINT64_MAX)
+{
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const bool
+SubmissionWaitEvent::operator==(const std::nullptr_t) const
+{
+    return this->timelineIndex == UINT64_MAX;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const bool
+SubmissionWaitEvent::operator!=(const std::nullptr_t) const
+{
+    return this->timelineIndex != UINT64_MAX;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+SubmissionWaitEvent::operator=(const std::nullptr_t)
+{
+    this->timelineIndex = UINT64_MAX;
+}
+
+} // namespace CoreGraphics
@@ -0,0 +1,30 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    The null implementation of the graphics device.
+
+    Nothing is sent to a GPU, submissions complete immediately and only the
+    draw and dispatch counts of the submitted command buffers are kept, which
+    makes it possible to run and profile the render loop headless.
+
+    The backend is chosen when configuring the build, with
+    N_RENDERER=N_RENDERER_NULL, rather than at startup: every backend
+    implements the same CoreGraphics functions, so only one of them can be
+    linked into an executable.
+
+    All functions in the Null namespace are internal helper functions specifically for the
+    null renderer, the other functions implement the abstraction layer.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "coregraphics/graphicsdevice.h"
+
+namespace Null
+{
+
+/// get the number of command buffers submitted since the device was created
+uint64 GetNumSubmissions();
+
+} // namespace Null
@@ -0,0 +1,145 @@
+//------------------------------------------------------------------------------
+//  nullmemory.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "nullmemory.h"
+#include "profiling/profiling.h"
+namespace CoreGraphics
+{
+
+N_DECLARE_COUNTER(N_DEVICE_ONLY_GPU_MEMORY, Device Only GPU Memory);
+N_DECLARE_COUNTER(N_HOST_ONLY_GPU_MEMORY, Host Only GPU Memory);
+N_DECLARE_COUNTER(N_DEVICE_TO_HOST_GPU_MEMORY, Device To Host GPU Memory);
+N_DECLARE_COUNTER(N_HOST_TO_DEVICE_GPU_MEMORY, Host To Device GPU Memory);
+
+/// the null device pretends to have this much memory per pool
+static const DeviceSize NullHeapSize = 16ull * 1024 * 1024 * 1024;
+
+//------------------------------------------------------------------------------
+/**
+    Sets up one pool per memory pool type, each with a heap of its own
+*/
+void 
+SetupMemoryPools(
+    DeviceSize deviceLocalMemory,
+    DeviceSize hostLocalMemory,
+    DeviceSize hostCachedMemory,
+    DeviceSize deviceAndHostMemory)
+{
+    const DeviceSize blockSizes[NumMemoryPoolTypes] = { deviceLocalMemory, hostLocalMemory, hostCachedMemory, deviceAndHostMemory };
+
+    // resize heaps up front, pools point into the array
+    CoreGraphics::Heaps.Resize(NumMemoryPoolTypes);
+    CoreGraphics::Pools.Resize(NumMemoryPoolTypes);
+    for (uint32_t i = 0; i < NumMemoryPoolTypes; i++)
+    {
+        CoreGraphics::Heaps[i].space = NullHeapSize;
+
+        CoreGraphics::MemoryPool& pool = CoreGraphics::Pools[i];
+        pool.heap = &CoreGraphics::Heaps[i];
+        pool.maxSize = NullHeapSize;
+        pool.memoryType = i;
+        pool.mapMemory = true;
+        pool.blockSize = blockSizes[i];
+        pool.size = 0;
+        pool.budgetCounter = nullptr;
+    }
+#if NEBULA_ENABLE_PROFILING
+    CoreGraphics::Pools[MemoryPool_DeviceLocal].budgetCounter = N_DEVICE_ONLY_GPU_MEMORY;
+    CoreGraphics::Pools[MemoryPool_HostLocal].budgetCounter = N_HOST_ONLY_GPU_MEMORY;
+    CoreGraphics::Pools[MemoryPool_HostCached].budgetCounter = N_DEVICE_TO_HOST_GPU_MEMORY;
+    CoreGraphics::Pools[MemoryPool_DeviceAndHost].budgetCounter = N_HOST_TO_DEVICE_GPU_MEMORY;
+#endif
+    N_BUDGET_COUNTER_SETUP(N_DEVICE_ONLY_GPU_MEMORY, NullHeapSize);
+    N_BUDGET_COUNTER_SETUP(N_HOST_ONLY_GPU_MEMORY, NullHeapSize);
+    N_BUDGET_COUNTER_SETUP(N_DEVICE_TO_HOST_GPU_MEMORY, NullHeapSize);
+    N_BUDGET_COUNTER_SETUP(N_HOST_TO_DEVICE_GPU_MEMORY, NullHeapSize);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void 
+DiscardMemoryPools()
+{
+    for (IndexT i = 0; i < CoreGraphics::Pools.Size(); i++)
+    {
+        CoreGraphics::Pools[i].Clear();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+FreeMemory(const Alloc& alloc)
+{
+    CoreGraphics::MemoryPool& pool = CoreGraphics::Pools[alloc.poolIndex];
+    AllocationLock.Enter();
+    bool res = pool.DeallocateMemory(alloc);
+    n_assert(res);
+    N_BUDGET_COUNTER_DECR(pool.budgetCounter, alloc.size);
+    AllocationLock.Leave();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void* 
+GetMappedMemory(const CoreGraphics::Alloc& alloc)
+{
+    return CoreGraphics::Pools[alloc.poolIndex].GetMappedMemory(alloc);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+DeviceMemory 
+MemoryPool::CreateBlock(void** outMappedPtr)
+{
+    n_assert(this->heap->space >= this->blockSize);
+    this->heap->space -= this->blockSize;
+
+    // device memory is just CPU memory, which is always mapped
+    void* mem = Memory::Alloc(Memory::ResourceHeap, (size_t)this->blockSize);
+    n_assert(mem != nullptr);
+    *outMappedPtr = mem;
+    return mem;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void 
+MemoryPool::DestroyBlock(DeviceMemory mem)
+{
+    n_assert(mem != nullptr);
+    Memory::Free(Memory::ResourceHeap, mem);
+}
+
+} // namespace CoreGraphics
+
+namespace Null
+{
+
+using namespace CoreGraphics;
+
+//------------------------------------------------------------------------------
+/**
+*/
+CoreGraphics::Alloc
+AllocateMemory(MemoryPoolType type, DeviceSize alignment, DeviceSize size)
+{
+    CoreGraphics::MemoryPool& pool = CoreGraphics::Pools[type];
+
+    AllocationLock.Enter();
+    Alloc ret = pool.AllocateMemory((uint)alignment, (uint)size);
+    N_BUDGET_COUNTER_INCR(pool.budgetCounter, ret.size);
+    AllocationLock.Leave();
+
+    n_assert(ret.offset + ret.size < pool.maxSize);
+    return ret;
+}
+
+} // namespace Null
@@ -0,0 +1,22 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    Null Memory Manager
+
+    Memory blocks are plain CPU memory which is always mapped, so allocations
+    go through the same pool and range allocator logic as a real device.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "util/array.h"
+#include "coregraphics/memory.h"
+
+namespace Null
+{
+
+/// allocate memory from the pool of the given type
+CoreGraphics::Alloc AllocateMemory(CoreGraphics::MemoryPoolType type, CoreGraphics::DeviceSize alignment, CoreGraphics::DeviceSize size);
+
+} // namespace Null
@@ -0,0 +1,236 @@
+//------------------------------------------------------------------------------
+//  nullpass.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "nullpass.h"
+#include "coregraphics/shader.h"
+#include "coregraphics/texture.h"
+#include "coregraphics/graphicsdevice.h"
+
+
+namespace Null
+{
+
+NullPassAllocator passAllocator(0x00FFFFFF);
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PassSetCurrentSubpass(const CoreGraphics::PassId& id, uint32_t subpass)
+{
+    NullPassRuntimeInfo& runtimeInfo = passAllocator.Get<Pass_RuntimeInfo>(id.id);
+    n_assert(subpass < (uint32_t)runtimeInfo.subpassRects.Size());
+    runtimeInfo.currentSubpassIndex = subpass;
+}
+
+} // namespace Null
+
+namespace CoreGraphics
+{
+
+using namespace Null;
+
+//------------------------------------------------------------------------------
+/**
+*/
+static void
+SetupPass(const PassId pid)
+{
+    Ids::Id32 id = pid.id;
+    NullPassLoadInfo& loadInfo = passAllocator.Get<Pass_LoadInfo>(id);
+    NullPassRuntimeInfo& runtimeInfo = passAllocator.Get<Pass_RuntimeInfo>(id);
+    Util::Array<uint32_t>& subpassAttachmentCounts = passAllocator.Get<Pass_SubpassAttachments>(id);
+
+    // every attachment covers its whole texture
+    Util::FixedArray<Math::rectangle<int>> rects(loadInfo.attachments.Size());
+    IndexT i;
+    for (i = 0; i < loadInfo.attachments.Size(); i++)
+    {
+        TextureId tex = TextureViewGetTexture(loadInfo.attachments[i]);
+        const CoreGraphics::TextureDimensions dims = TextureGetDimensions(tex);
+        rects[i] = Math::rectangle<int>(0, 0, dims.width, dims.height);
+    }
+
+    // the depth attachment only provides a viewport if there are no color attachments, same as on the GPU
+    subpassAttachmentCounts.Clear();
+    runtimeInfo.currentSubpassIndex = 0;
+    runtimeInfo.subpassRects.Resize(loadInfo.subpasses.Size());
+    runtimeInfo.subpassViewports.Resize(loadInfo.subpasses.Size());
+    for (i = 0; i < loadInfo.subpasses.Size(); i++)
+    {
+        const CoreGraphics::Subpass& subpass = loadInfo.subpasses[i];
+        n_assert(subpass.numViewports >= subpass.attachments.Size());
+        n_assert(subpass.numScissors >= subpass.attachments.Size());
+        runtimeInfo.subpassViewports[i].Resize(subpass.numViewports);
+        runtimeInfo.subpassRects[i].Resize(subpass.numScissors);
+
+        IndexT j = 0;
+        if (subpass.depth != InvalidIndex && subpass.attachments.IsEmpty())
+        {
+            runtimeInfo.subpassViewports[i][j] = rects[subpass.depth];
+            runtimeInfo.subpassRects[i][j] = rects[subpass.depth];
+            j++;
+        }
+        for (auto attachment : subpass.attachments)
+        {
+            runtimeInfo.subpassViewports[i][j] = rects[attachment];
+            runtimeInfo.subpassRects[i][j] = rects[attachment];
+            j++;
+        }
+        subpassAttachmentCounts.Append(subpass.attachments.Size());
+    }
+
+    // If the pass descriptor is invalid (which it is when the pass is first created) create a new resource table and constant buffer
+    if (runtimeInfo.passDescriptorSet == ResourceTableId::Invalid())
+    {
+        ShaderId sid = CoreGraphics::ShaderGet("shd:system_shaders/shared.fxb"_atm);
+        loadInfo.passBlockBuffer = CoreGraphics::ShaderCreateConstantBuffer(sid, "PassBlock");
+        loadInfo.renderTargetDimensionsVar = ShaderGetConstantBinding(sid, "RenderTargetDimensions");
+
+        CoreGraphics::ResourceTableLayoutId tableLayout = ShaderGetResourceTableLayout(sid, NEBULA_PASS_GROUP);
+        runtimeInfo.passDescriptorSet = CreateResourceTable(ResourceTableCreateInfo{ tableLayout, 8 });
+
+        CoreGraphics::ResourceTableBuffer write;
+        write.buf = loadInfo.passBlockBuffer;
+        write.offset = 0;
+        write.size = NEBULA_WHOLE_BUFFER_SIZE;
+        write.index = 0;
+        write.dynamicOffset = false;
+        write.texelBuffer = false;
+        write.slot = ShaderGetResourceSlot(sid, "PassBlock");
+        ResourceTableSetConstantBuffer(runtimeInfo.passDescriptorSet, write);
+        ResourceTableCommitChanges(runtimeInfo.passDescriptorSet);
+    }
+
+    // update render target dimensions
+    Util::FixedArray<Math::vec4> dimensions(loadInfo.attachments.Size());
+    for (i = 0; i < loadInfo.attachments.Size(); i++)
+    {
+        const Math::rectangle<int>& rect = rects[i];
+        dimensions[i] = Math::vec4((Math::scalar)rect.width(), (Math::scalar)rect.height(), 1 / (Math::scalar)rect.width(), 1 / (Math::scalar)rect.height());
+    }
+    if (!dimensions.IsEmpty())
+        BufferUpdateArray(loadInfo.passBlockBuffer, dimensions.Begin(), dimensions.Size(), loadInfo.renderTargetDimensionsVar);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const PassId
+CreatePass(const PassCreateInfo& info)
+{
+    n_assert(info.subpasses.Size() > 0);
+    Ids::Id32 id = passAllocator.Alloc();
+    NullPassLoadInfo& loadInfo = passAllocator.Get<Pass_LoadInfo>(id);
+    NullPassRuntimeInfo& runtimeInfo = passAllocator.Get<Pass_RuntimeInfo>(id);
+
+    loadInfo.name = info.name;
+    loadInfo.attachments = info.attachments;
+    loadInfo.attachmentClears = info.attachmentClears;
+    loadInfo.attachmentFlags = info.attachmentFlags;
+    loadInfo.attachmentIsDepthStencil = info.attachmentDepthStencil;
+    loadInfo.subpasses = info.subpasses;
+    loadInfo.passBlockBuffer = BufferId::Invalid();
+    runtimeInfo.passDescriptorSet = ResourceTableId::Invalid();
+
+    PassId ret = id;
+    SetupPass(ret);
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyPass(const PassId id)
+{
+    NullPassLoadInfo& loadInfo = passAllocator.Get<Pass_LoadInfo>(id.id);
+    NullPassRuntimeInfo& runtimeInfo = passAllocator.Get<Pass_RuntimeInfo>(id.id);
+
+    for (IndexT i = 0; i < loadInfo.attachments.Size(); i++)
+        CoreGraphics::DestroyTextureView(loadInfo.attachments[i]);
+
+    DestroyResourceTable(runtimeInfo.passDescriptorSet);
+    DestroyBuffer(loadInfo.passBlockBuffer);
+    runtimeInfo.passDescriptorSet = ResourceTableId::Invalid();
+    loadInfo.passBlockBuffer = BufferId::Invalid();
+
+    DelayedDeletePass(id);
+    passAllocator.Dealloc(id.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PassWindowResizeCallback(const PassId id)
+{
+    NullPassLoadInfo& loadInfo = passAllocator.Get<Pass_LoadInfo>(id.id);
+
+    // update attachments because their underlying textures might have changed
+    for (IndexT i = 0; i < loadInfo.attachments.Size(); i++)
+        CoreGraphics::TextureViewReload(loadInfo.attachments[i]);
+
+    SetupPass(id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const Util::Array<CoreGraphics::TextureViewId>&
+PassGetAttachments(const CoreGraphics::PassId id)
+{
+    return passAllocator.Get<Pass_LoadInfo>(id.id).attachments;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const uint32_t
+PassGetNumSubpassAttachments(const CoreGraphics::PassId id, const IndexT subpass)
+{
+    return passAllocator.Get<Pass_SubpassAttachments>(id.id)[subpass];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CoreGraphics::ResourceTableId
+PassGetResourceTable(const CoreGraphics::PassId id)
+{
+    return passAllocator.Get<Pass_RuntimeInfo>(id.id).passDescriptorSet;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const Util::StringAtom
+PassGetName(const CoreGraphics::PassId id)
+{
+    return passAllocator.Get<Pass_LoadInfo>(id.id).name;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const Util::FixedArray<Math::rectangle<int>>&
+PassGetRects(const CoreGraphics::PassId& id)
+{
+    const NullPassRuntimeInfo& info = passAllocator.Get<Pass_RuntimeInfo>(id.id);
+    return info.subpassRects[info.currentSubpassIndex];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const Util::FixedArray<Math::rectangle<int>>&
+PassGetViewports(const CoreGraphics::PassId& id)
+{
+    const NullPassRuntimeInfo& info = passAllocator.Get<Pass_RuntimeInfo>(id.id);
+    return info.subpassViewports[info.currentSubpassIndex];
+}
+
+} // namespace CoreGraphics
@@ -0,0 +1,63 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    Null pass implementation
+
+    Keeps the attachments and the per-subpass viewports and scissors, which
+    are what the frame script and the command buffers query. The pass
+    constant buffer and resource table are setup like they are on a real
+    device so shaders binding them behave the same.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "coregraphics/pass.h"
+#include "coregraphics/buffer.h"
+#include "coregraphics/resourcetable.h"
+
+namespace Null
+{
+
+struct NullPassLoadInfo
+{
+    Util::StringAtom name;
+
+    // these hold the per-pass shader state
+    CoreGraphics::BufferId passBlockBuffer;
+    IndexT renderTargetDimensionsVar;
+
+    Util::Array<CoreGraphics::TextureViewId> attachments;
+    Util::Array<Math::vec4> attachmentClears;
+    Util::Array<CoreGraphics::AttachmentFlagBits> attachmentFlags;
+    Util::Array<bool> attachmentIsDepthStencil;
+    Util::Array<CoreGraphics::Subpass> subpasses;
+};
+
+struct NullPassRuntimeInfo
+{
+    uint32_t currentSubpassIndex;
+    CoreGraphics::ResourceTableId passDescriptorSet;
+
+    Util::FixedArray<Util::FixedArray<Math::rectangle<int>>> subpassRects;
+    Util::FixedArray<Util::FixedArray<Math::rectangle<int>>> subpassViewports;
+};
+
+enum
+{
+    Pass_LoadInfo
+    , Pass_RuntimeInfo
+    , Pass_SubpassAttachments
+};
+
+typedef Ids::IdAllocator<
+    NullPassLoadInfo,
+    NullPassRuntimeInfo,
+    Util::Array<uint32_t>   // subpass attachments
+> NullPassAllocator;
+extern NullPassAllocator passAllocator;
+
+/// set the subpass the pass is currently recording
+void PassSetCurrentSubpass(const CoreGraphics::PassId& id, uint32_t subpass);
+
+} // namespace Null
@@ -0,0 +1,71 @@
+//------------------------------------------------------------------------------
+//  @file nullpipeline.cc
+//  @copyright (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "nullpipeline.h"
+#include "coregraphics/buffer.h"
+namespace Null
+{
+Ids::IdAllocator<Pipeline> pipelineAllocator;
+} // namespace Null
+
+namespace CoreGraphics
+{
+using namespace Null;
+
+//------------------------------------------------------------------------------
+/**
+*/
+PipelineId
+CreateGraphicsPipeline(const PipelineCreateInfo& info)
+{
+    Ids::Id32 ret = pipelineAllocator.Alloc();
+    Pipeline& obj = pipelineAllocator.Get<0>(ret);
+    obj.program = info.shader;
+    obj.pass = info.pass;
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyGraphicsPipeline(const PipelineId pipeline)
+{
+    Pipeline& obj = pipelineAllocator.Get<0>(pipeline.id);
+    obj.program = CoreGraphics::InvalidShaderProgramId;
+    obj.pass = CoreGraphics::InvalidPassId;
+    pipelineAllocator.Dealloc(pipeline.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+    The null device doesn't support raytracing, the table has no shader bindings
+*/
+const PipelineRayTracingTable
+CreateRaytracingPipeline(const Util::Array<CoreGraphics::ShaderProgramId> programs)
+{
+    PipelineRayTracingTable ret;
+    Ids::Id32 id = pipelineAllocator.Alloc();
+    Pipeline& obj = pipelineAllocator.Get<0>(id);
+    obj.program = programs.IsEmpty() ? CoreGraphics::InvalidShaderProgramId : programs[0];
+    obj.pass = CoreGraphics::InvalidPassId;
+    ret.pipeline = id;
+    ret.raygenBindingBuffer = CoreGraphics::InvalidBufferId;
+    ret.missBindingBuffer = CoreGraphics::InvalidBufferId;
+    ret.hitBindingBuffer = CoreGraphics::InvalidBufferId;
+    ret.callableBindingBuffer = CoreGraphics::InvalidBufferId;
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyRaytracingPipeline(const PipelineRayTracingTable& table)
+{
+    pipelineAllocator.Dealloc(table.pipeline.id);
+}
+
+} // namespace CoreGraphics
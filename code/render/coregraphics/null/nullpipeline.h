@@ -0,0 +1,24 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    Null pipeline
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "ids/idallocator.h"
+#include "coregraphics/pipeline.h"
+namespace Null
+{
+
+struct Pipeline
+{
+    CoreGraphics::ShaderProgramId program;
+
+    // Pass needed for pass related resource tables
+    CoreGraphics::PassId pass;
+};
+
+extern Ids::IdAllocator<Pipeline> pipelineAllocator;
+} // namespace Null
@@ -0,0 +1,208 @@
+//------------------------------------------------------------------------------
+//  nullresourcetable.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "nullresourcetable.h"
+
+namespace Null
+{
+NullResourceTableAllocator resourceTableAllocator(0x00FFFFFF);
+NullResourceTableLayoutAllocator resourceTableLayoutAllocator(0x00FFFFFF);
+NullResourcePipelineAllocator resourcePipelineAllocator(0x00FFFFFF);
+} // namespace Null
+
+namespace CoreGraphics
+{
+
+using namespace Null;
+
+Util::Array<CoreGraphics::ResourceTableId> PendingTableCommits;
+bool ResourceTableBlocked = false;
+Threading::CriticalSection PendingTableCommitsLock;
+
+//------------------------------------------------------------------------------
+/**
+*/
+ResourceTableId
+CreateResourceTable(const ResourceTableCreateInfo& info)
+{
+    n_assert(info.layout != InvalidResourceTableLayoutId);
+    Ids::Id32 id = resourceTableAllocator.Alloc();
+    resourceTableAllocator.Set<0>(id, info.layout);
+
+    ResourceTableId ret = id;
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyResourceTable(const ResourceTableId id)
+{
+    resourceTableAllocator.Dealloc(id.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const ResourceTableLayoutId&
+ResourceTableGetLayout(CoreGraphics::ResourceTableId id)
+{
+    return resourceTableAllocator.Get<0>(id.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceTableSetTexture(const ResourceTableId id, const ResourceTableTexture& tex)
+{
+    n_assert(id != InvalidResourceTableId);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceTableSetTexture(const ResourceTableId id, const ResourceTableTextureView& tex)
+{
+    n_assert(id != InvalidResourceTableId);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceTableSetInputAttachment(const ResourceTableId id, const ResourceTableInputAttachment& tex)
+{
+    n_assert(id != InvalidResourceTableId);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceTableSetRWTexture(const ResourceTableId id, const ResourceTableTexture& tex)
+{
+    n_assert(id != InvalidResourceTableId);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceTableSetRWTexture(const ResourceTableId id, const ResourceTableTextureView& tex)
+{
+    n_assert(id != InvalidResourceTableId);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceTableSetConstantBuffer(const ResourceTableId id, const ResourceTableBuffer& buf)
+{
+    n_assert(id != InvalidResourceTableId);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceTableSetRWBuffer(const ResourceTableId id, const ResourceTableBuffer& buf)
+{
+    n_assert(id != InvalidResourceTableId);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceTableSetSampler(const ResourceTableId id, const ResourceTableSampler& samp)
+{
+    n_assert(id != InvalidResourceTableId);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceTableSetAccelerationStructure(const ResourceTableId id, const ResourceTableTlas& tlas)
+{
+    n_assert(id != InvalidResourceTableId);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceTableCopy(const ResourceTableId from, const IndexT fromSlot, const IndexT fromIndex, const ResourceTableId to, const IndexT toSlot, const IndexT toIndex, const SizeT numResources)
+{
+    n_assert(from != InvalidResourceTableId && to != InvalidResourceTableId);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceTableBlock(bool b)
+{
+    ResourceTableBlocked = b;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceTableCommitChanges(const ResourceTableId id)
+{
+    n_assert(!ResourceTableBlocked);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+ResourceTableLayoutId
+CreateResourceTableLayout(const ResourceTableLayoutCreateInfo& info)
+{
+    Ids::Id32 id = resourceTableLayoutAllocator.Alloc();
+    resourceTableLayoutAllocator.Set<0>(id, info);
+
+    ResourceTableLayoutId ret = id;
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyResourceTableLayout(const ResourceTableLayoutId& id)
+{
+    resourceTableLayoutAllocator.Dealloc(id.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+ResourcePipelineId
+CreateResourcePipeline(const ResourcePipelineCreateInfo& info)
+{
+    Ids::Id32 id = resourcePipelineAllocator.Alloc();
+    resourcePipelineAllocator.Set<0>(id, info);
+
+    ResourcePipelineId ret = id;
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyResourcePipeline(const ResourcePipelineId& id)
+{
+    resourcePipelineAllocator.Dealloc(id.id);
+}
+
+} // namespace CoreGraphics
@@ -0,0 +1,34 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    Null resource table implementation
+
+    Resource tables only keep track of their layout, descriptor writes are
+    ignored since nothing ever reads them.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "coregraphics/resourcetable.h"
+#include "ids/idallocator.h"
+
+namespace Null
+{
+
+typedef Ids::IdAllocator<
+    CoreGraphics::ResourceTableLayoutId
+> NullResourceTableAllocator;
+extern NullResourceTableAllocator resourceTableAllocator;
+
+typedef Ids::IdAllocator<
+    CoreGraphics::ResourceTableLayoutCreateInfo
+> NullResourceTableLayoutAllocator;
+extern NullResourceTableLayoutAllocator resourceTableLayoutAllocator;
+
+typedef Ids::IdAllocator<
+    CoreGraphics::ResourcePipelineCreateInfo
+> NullResourcePipelineAllocator;
+extern NullResourcePipelineAllocator resourcePipelineAllocator;
+
+} // namespace Null
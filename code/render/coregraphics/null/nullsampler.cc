@@ -0,0 +1,55 @@
+//------------------------------------------------------------------------------
+//  nullsampler.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "nullsampler.h"
+#include "util/dictionary.h"
+namespace Null
+{
+NullSamplerAllocator samplerAllocator;
+} // namespace Null
+
+namespace CoreGraphics
+{
+
+using namespace Null;
+
+Util::Dictionary<uint32_t, Ids::Id32> UniqueSamplerHashes;
+
+//------------------------------------------------------------------------------
+/**
+*/
+SamplerId
+CreateSampler(const SamplerCreateInfo& info)
+{
+    uint32_t hash = info.HashCode();
+    IndexT i = UniqueSamplerHashes.FindIndex(hash);
+    if (i == InvalidIndex)
+    {
+        Ids::Id32 id = samplerAllocator.Alloc();
+        samplerAllocator.Set<0>(id, info);
+        samplerAllocator.Set<1>(id, hash);
+        UniqueSamplerHashes.Add(hash, id);
+
+        SamplerId ret = id;
+        return ret;
+    }
+    else
+    {
+        SamplerId ret = UniqueSamplerHashes.ValueAtIndex(i);
+        return ret;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroySampler(const SamplerId& id)
+{
+    UniqueSamplerHashes.Erase(samplerAllocator.Get<1>(id.id));
+    samplerAllocator.Dealloc(id.id);
+}
+
+} // namespace CoreGraphics
@@ -0,0 +1,22 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    Null sampler implementation
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "coregraphics/sampler.h"
+#include "ids/idallocator.h"
+
+namespace Null
+{
+
+typedef Ids::IdAllocator<
+    CoreGraphics::SamplerCreateInfo,
+    uint32_t
+> NullSamplerAllocator;
+extern NullSamplerAllocator samplerAllocator;
+
+} // namespace Null
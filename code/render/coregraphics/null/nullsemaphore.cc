@@ -0,0 +1,87 @@
+//------------------------------------------------------------------------------
+//  nullsemaphore.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "nullsemaphore.h"
+#ifdef CreateSemaphore
+#pragma push_macro("CreateSemaphore")
+#undef CreateSemaphore
+#endif
+
+namespace Null
+{
+NullSemaphoreAllocator semaphoreAllocator(0x00FFFFFF);
+} // namespace Null
+
+namespace CoreGraphics
+{
+
+using namespace Null;
+
+//------------------------------------------------------------------------------
+/**
+*/
+SemaphoreId
+CreateSemaphore(const SemaphoreCreateInfo& info)
+{
+    Ids::Id32 id = semaphoreAllocator.Alloc();
+    semaphoreAllocator.Get<Semaphore_Type>(id) = info.type;
+    semaphoreAllocator.Get<Semaphore_LastIndex>(id) = 0;
+    SemaphoreId ret = id;
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroySemaphore(const SemaphoreId& semaphore)
+{
+    semaphoreAllocator.Dealloc(semaphore.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+uint64
+SemaphoreGetValue(const SemaphoreId& semaphore)
+{
+    return semaphoreAllocator.Get<Semaphore_LastIndex>(semaphore.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+SemaphoreSignal(const SemaphoreId& semaphore)
+{
+    switch (semaphoreAllocator.Get<Semaphore_Type>(semaphore.id))
+    {
+    case SemaphoreType::Binary:
+        semaphoreAllocator.Get<Semaphore_LastIndex>(semaphore.id) = 1;
+        break;
+    case SemaphoreType::Timeline:
+        semaphoreAllocator.Get<Semaphore_LastIndex>(semaphore.id)++;
+        break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+SemaphoreReset(const SemaphoreId& semaphore)
+{
+    switch (semaphoreAllocator.Get<Semaphore_Type>(semaphore.id))
+    {
+    case SemaphoreType::Binary:
+        semaphoreAllocator.Get<Semaphore_LastIndex>(semaphore.id) = 0;
+        break;
+    default: n_error("unhandled enum"); break;
+    }
+}
+
+} // namespace CoreGraphics
+
+#pragma pop_macro("CreateSemaphore")
@@ -0,0 +1,27 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    Null semaphore, only keeps track of the signal value
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "ids/idallocator.h"
+#include "coregraphics/semaphore.h"
+namespace Null
+{
+
+enum
+{
+    Semaphore_Type,
+    Semaphore_LastIndex
+};
+
+typedef Ids::IdAllocator<
+    CoreGraphics::SemaphoreType,
+    uint64
+> NullSemaphoreAllocator;
+extern NullSemaphoreAllocator semaphoreAllocator;
+
+} // namespace Null
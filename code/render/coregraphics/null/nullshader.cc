@@ -0,0 +1,811 @@
+//------------------------------------------------------------------------------
+//  nullshader.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "nullshader.h"
+#include "coregraphics/config.h"
+#include "coregraphics/graphicsdevice.h"
+#include "lowlevel/vk/vkvarblock.h"
+#include "lowlevel/vk/vkvarbuffer.h"
+#include "lowlevel/vk/vkvariable.h"
+#include "lowlevel/vk/vkprogram.h"
+#include "util/bit.h"
+
+namespace Null
+{
+
+ShaderAllocator shaderAlloc;
+ShaderProgramAllocator shaderProgramAlloc;
+
+//------------------------------------------------------------------------------
+/**
+*/
+static CoreGraphics::ShaderConstantType
+ConstantTypeFromAnyFX(const AnyFX::VariableType type, bool handles)
+{
+    using namespace CoreGraphics;
+    switch (type)
+    {
+        case AnyFX::Double:
+        case AnyFX::Float:
+            return FloatVariableType;
+        case AnyFX::Short:
+        case AnyFX::Integer:
+        case AnyFX::UInteger:
+            return IntVariableType;
+        case AnyFX::Bool:
+            return BoolVariableType;
+        case AnyFX::Float3:
+        case AnyFX::Float4:
+        case AnyFX::Double3:
+        case AnyFX::Double4:
+        case AnyFX::Integer3:
+        case AnyFX::Integer4:
+        case AnyFX::UInteger3:
+        case AnyFX::UInteger4:
+        case AnyFX::Short3:
+        case AnyFX::Short4:
+        case AnyFX::Bool3:
+        case AnyFX::Bool4:
+            return VectorVariableType;
+        case AnyFX::Float2:
+        case AnyFX::Double2:
+        case AnyFX::Integer2:
+        case AnyFX::UInteger2:
+        case AnyFX::Short2:
+        case AnyFX::Bool2:
+            return Vector2VariableType;
+        case AnyFX::Matrix2x2:
+        case AnyFX::Matrix2x3:
+        case AnyFX::Matrix2x4:
+        case AnyFX::Matrix3x2:
+        case AnyFX::Matrix3x3:
+        case AnyFX::Matrix3x4:
+        case AnyFX::Matrix4x2:
+        case AnyFX::Matrix4x3:
+        case AnyFX::Matrix4x4:
+            return MatrixVariableType;
+        case AnyFX::Image1D:
+        case AnyFX::Image1DArray:
+        case AnyFX::Image2D:
+        case AnyFX::Image2DArray:
+        case AnyFX::Image2DMS:
+        case AnyFX::Image2DMSArray:
+        case AnyFX::Image3D:
+        case AnyFX::ImageCube:
+        case AnyFX::ImageCubeArray:
+            return ImageReadWriteVariableType;
+        case AnyFX::Sampler1D:
+        case AnyFX::Sampler1DArray:
+        case AnyFX::Sampler2D:
+        case AnyFX::Sampler2DArray:
+        case AnyFX::Sampler2DMS:
+        case AnyFX::Sampler2DMSArray:
+        case AnyFX::Sampler3D:
+        case AnyFX::SamplerCube:
+        case AnyFX::SamplerCubeArray:
+            return SamplerVariableType;
+        case AnyFX::Texture1D:
+        case AnyFX::Texture1DArray:
+        case AnyFX::Texture2D:
+        case AnyFX::Texture2DArray:
+        case AnyFX::Texture2DMS:
+        case AnyFX::Texture2DMSArray:
+        case AnyFX::Texture3D:
+        case AnyFX::TextureCube:
+        case AnyFX::TextureCubeArray:
+            return TextureVariableType;
+        case AnyFX::TextureHandle:
+            return handles ? TextureHandleType : TextureVariableType;
+        case AnyFX::ImageHandle:
+            return handles ? ImageHandleType : ImageReadWriteVariableType;
+        case AnyFX::SamplerHandle:
+            return handles ? SamplerHandleType : SamplerVariableType;
+        default:
+            return ConstantBufferVariableType;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Builds the resource table layouts from the effect, without any of the
+    device limit validation a GPU backend has to do.
+*/
+static void
+ShaderSetup(
+    const Util::StringAtom& name,
+    AnyFX::ShaderEffect* effect,
+    Util::FixedArray<Util::Pair<uint32_t, CoreGraphics::ResourceTableLayoutId>>& setLayouts,
+    Util::Dictionary<uint32_t, uint32_t>& setLayoutMap,
+    CoreGraphics::ResourcePipelineId& pipelineLayout,
+    Util::Dictionary<Util::StringAtom, uint32_t>& resourceSlotMapping,
+    Util::Dictionary<Util::StringAtom, IndexT>& constantBindings)
+{
+    using namespace CoreGraphics;
+    const std::vector<AnyFX::VarblockBase*>& varblocks = effect->GetVarblocks();
+    const std::vector<AnyFX::VarbufferBase*>& varbuffers = effect->GetVarbuffers();
+    const std::vector<AnyFX::VariableBase*>& variables = effect->GetVariables();
+
+    Util::Dictionary<uint32_t, ResourceTableLayoutCreateInfo> layoutCreateInfos;
+    ResourcePipelinePushConstantRange pushRange{ 0, 0, InvalidVisibility };
+    uint32_t pushRangeOffset = 0;
+    uint32_t numsets = 0;
+    size_t i;
+
+    for (i = 0; i < varblocks.size(); i++)
+    {
+        AnyFX::VarblockBase* block = varblocks[i];
+        if (block->variables.empty()) continue;
+        if (AnyFX::HasFlags(block->qualifiers, AnyFX::Qualifiers::Push))
+        {
+            // push constants are not part of any table, but their constants still need bindings
+            pushRange.offset = pushRangeOffset;
+            pushRange.size = block->alignedSize;
+            pushRange.vis = AllGraphicsVisibility;
+            pushRangeOffset += block->alignedSize;
+        }
+        else
+        {
+            resourceSlotMapping.Add(block->name.c_str(), block->binding);
+            ResourceTableLayoutConstantBuffer cbo;
+            cbo.slot = block->binding;
+            cbo.num = 1;
+            cbo.visibility = AllVisibility;
+            cbo.dynamicOffset = block->set == NEBULA_DYNAMIC_OFFSET_GROUP || block->set == NEBULA_INSTANCE_GROUP;
+            layoutCreateInfos.Emplace(block->set).constantBuffers.Append(cbo);
+            numsets = Math::max(numsets, block->set + 1);
+        }
+
+        const std::vector<AnyFX::VariableBase*>& vars = block->variables;
+        for (size_t j = 0; j < vars.size(); j++)
+        {
+            constantBindings.Add(vars[j]->name.c_str(), { (IndexT)block->offsetsByName[vars[j]->name] });
+        }
+    }
+
+    for (i = 0; i < varbuffers.size(); i++)
+    {
+        AnyFX::VarbufferBase* buffer = varbuffers[i];
+        resourceSlotMapping.Add(buffer->name.c_str(), buffer->binding);
+        if (buffer->alignedSize == 0) continue;
+
+        ResourceTableLayoutShaderRWBuffer rwbo;
+        rwbo.slot = buffer->binding;
+        rwbo.num = 1;
+        rwbo.visibility = AllVisibility;
+        rwbo.dynamicOffset = buffer->set == NEBULA_DYNAMIC_OFFSET_GROUP || buffer->set == NEBULA_INSTANCE_GROUP;
+        layoutCreateInfos.Emplace(buffer->set).rwBuffers.Append(rwbo);
+        numsets = Math::max(numsets, buffer->set + 1);
+    }
+
+    for (i = 0; i < variables.size(); i++)
+    {
+        AnyFX::VariableBase* variable = variables[i];
+        if (variable->type >= AnyFX::Sampler1D && variable->type <= AnyFX::TextureCubeArray)
+        {
+            resourceSlotMapping.Add(variable->name.c_str(), variable->binding);
+
+            ResourceTableLayoutTexture tex;
+            tex.slot = variable->binding;
+            tex.num = 1;
+            tex.immutableSampler = InvalidSamplerId;
+            tex.visibility = AllVisibility;
+
+            ResourceTableLayoutCreateInfo& info = layoutCreateInfos.Emplace(variable->set);
+            if (ConstantTypeFromAnyFX(variable->type, false) == ImageReadWriteVariableType)
+                info.rwTextures.Append(tex);
+            else
+                info.textures.Append(tex);
+            numsets = Math::max(numsets, variable->set + 1);
+        }
+        else if (variable->type >= AnyFX::InputAttachment && variable->type <= AnyFX::InputAttachmentUIntegerMS)
+        {
+            resourceSlotMapping.Add(variable->name.c_str(), variable->binding);
+
+            ResourceTableLayoutInputAttachment ia;
+            ia.slot = variable->binding;
+            ia.num = 1;
+            ia.visibility = PixelShaderVisibility;
+            layoutCreateInfos.Emplace(variable->set).inputAttachments.Append(ia);
+            numsets = Math::max(numsets, variable->set + 1);
+        }
+    }
+
+    setLayouts.Resize(numsets);
+    for (i = 0; i < setLayouts.Size(); i++)
+    {
+        setLayouts[i] = Util::MakePair((uint32_t)i, ResourceTableLayoutId::Invalid());
+    }
+
+    Util::Array<ResourceTableLayoutId> layoutList;
+    Util::Array<uint32_t> layoutIndices;
+    IndexT j;
+    for (j = 0; j < layoutCreateInfos.Size(); j++)
+    {
+        const uint32_t set = layoutCreateInfos.KeyAtIndex(j);
+        ResourceTableLayoutId layout = CreateResourceTableLayout(layoutCreateInfos.ValueAtIndex(j));
+        setLayouts[j] = Util::MakePair(set, layout);
+        setLayoutMap.Add(set, j);
+        layoutList.Append(layout);
+        layoutIndices.Append(set);
+    }
+
+    ResourcePipelineCreateInfo piInfo =
+    {
+        layoutList, layoutIndices, pushRange
+    };
+    pipelineLayout = CreateResourcePipeline(piInfo);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static void
+ShaderSetupReflection(NullReflectionInfo& reflectionInfo, const AnyFX::ShaderEffect* effect)
+{
+    reflectionInfo.uniformBuffers.Clear();
+    reflectionInfo.uniformBuffersByName.Clear();
+    reflectionInfo.uniformBuffersPerSet.Clear();
+    reflectionInfo.uniformBuffersMask.Clear();
+    reflectionInfo.variables.Clear();
+    reflectionInfo.variablesByName.Clear();
+
+    const std::vector<AnyFX::VariableBase*>& variables = effect->GetVariables();
+    for (size_t i = 0; i < variables.size(); i++)
+    {
+        AnyFX::VariableBase* var = variables[i];
+        NullReflectionInfo::Variable refl;
+        refl.name = var->name.c_str();
+        refl.blockBinding = -1;
+        refl.blockSet = -1;
+        refl.type = ConstantTypeFromAnyFX(var->type, false);
+        refl.handleType = ConstantTypeFromAnyFX(var->type, true);
+        if (var->parentBlock)
+        {
+            refl.blockName = var->parentBlock->name.c_str();
+            refl.blockBinding = var->parentBlock->binding;
+            refl.blockSet = var->parentBlock->set;
+        }
+        reflectionInfo.variables.Append(refl);
+        reflectionInfo.variablesByName.Add(refl.name, refl);
+    }
+
+    const std::vector<AnyFX::VarblockBase*>& varblocks = effect->GetVarblocks();
+    for (size_t i = 0; i < varblocks.size(); i++)
+    {
+        AnyFX::VarblockBase* var = varblocks[i];
+        NullReflectionInfo::UniformBuffer refl;
+        refl.name = var->name.c_str();
+        refl.binding = var->binding;
+        refl.set = var->set;
+        refl.byteSize = var->alignedSize;
+        if (var->binding != 0xFFFFFFFF)
+        {
+            n_assert(var->binding < 64);
+            reflectionInfo.uniformBuffersMask.Resize(Math::max(var->set + 1, (uint)reflectionInfo.uniformBuffersMask.Size()), 0);
+            reflectionInfo.uniformBuffersMask[var->set] |= (1ull << (uint64)var->binding);
+        }
+        reflectionInfo.uniformBuffers.Append(refl);
+        reflectionInfo.uniformBuffersByName.Add(refl.name, refl);
+        reflectionInfo.uniformBuffersPerSet.Resize(Math::max(var->set + 1, (uint)reflectionInfo.uniformBuffersPerSet.Size()), nullptr);
+        reflectionInfo.uniformBuffersPerSet[var->set].Append(refl);
+    }
+
+    for (auto& set : reflectionInfo.uniformBuffersPerSet)
+    {
+        set.SortWithFunc(
+            [](const NullReflectionInfo::UniformBuffer& lhs, const NullReflectionInfo::UniformBuffer& rhs) -> bool
+            {
+                return lhs.binding < rhs.binding;
+            }
+        );
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static void
+ShaderCleanup(NullShaderSetupInfo& setup, NullShaderRuntimeInfo& runtime)
+{
+    IndexT i;
+    for (i = 0; i < setup.descriptorSetLayouts.Size(); i++)
+    {
+        if (Util::Get<1>(setup.descriptorSetLayouts[i]) != CoreGraphics::ResourceTableLayoutId::Invalid())
+            CoreGraphics::DestroyResourceTableLayout(Util::Get<1>(setup.descriptorSetLayouts[i]));
+    }
+    setup.descriptorSetLayouts.Clear();
+    setup.descriptorSetLayoutMap.Clear();
+    setup.resourceIndexMap.Clear();
+    setup.constantBindings.Clear();
+    CoreGraphics::DestroyResourcePipeline(setup.pipelineLayout);
+
+    for (i = 0; i < runtime.programMap.Size(); i++)
+    {
+        shaderProgramAlloc.Dealloc(runtime.programMap.ValueAtIndex(i).programId);
+    }
+    runtime.programMap.Clear();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+CoreGraphics::ResourcePipelineId
+ShaderProgramGetLayout(const CoreGraphics::ShaderProgramId id)
+{
+    return shaderProgramAlloc.Get<ShaderProgram_SetupInfo>(id.programId).layout;
+}
+
+} // namespace Null
+
+namespace CoreGraphics
+{
+
+using namespace Null;
+
+//------------------------------------------------------------------------------
+/**
+*/
+const ShaderId
+CreateShader(const ShaderCreateInfo& info)
+{
+    AnyFX::ShaderEffect* effect = info.effect;
+
+    Ids::Id32 id = shaderAlloc.Alloc();
+    NullReflectionInfo& reflectionInfo = shaderAlloc.Get<Shader_ReflectionInfo>(id);
+    NullShaderSetupInfo& setupInfo = shaderAlloc.Get<Shader_SetupInfo>(id);
+    NullShaderRuntimeInfo& runtimeInfo = shaderAlloc.Get<Shader_RuntimeInfo>(id);
+    ShaderId ret = id;
+
+    setupInfo.id = ShaderIdentifier::FromName(info.name);
+    setupInfo.name = info.name;
+    ShaderSetup(
+        info.name,
+        effect,
+        setupInfo.descriptorSetLayouts,
+        setupInfo.descriptorSetLayoutMap,
+        setupInfo.pipelineLayout,
+        setupInfo.resourceIndexMap,
+        setupInfo.constantBindings
+    );
+    ShaderSetupReflection(reflectionInfo, effect);
+
+    // programs are only a mask and a name
+    const std::vector<AnyFX::ProgramBase*>& programs = effect->GetPrograms();
+    for (size_t i = 0; i < programs.size(); i++)
+    {
+        AnyFX::ProgramBase* program = programs[i];
+        Ids::Id32 programId = shaderProgramAlloc.Alloc();
+        NullShaderProgramSetupInfo& programSetup = shaderProgramAlloc.Get<ShaderProgram_SetupInfo>(programId);
+        programSetup.name = program->name.c_str();
+        programSetup.mask = ShaderFeatureMask(program->GetAnnotationString("Mask").c_str());
+        programSetup.layout = setupInfo.pipelineLayout;
+
+        ShaderProgramId shaderProgramId;
+        shaderProgramId.shader = ret.id;
+        shaderProgramId.program = programId;
+        runtimeInfo.programMap.Add(programSetup.mask, shaderProgramId);
+    }
+
+    delete effect;
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyShader(const ShaderId id)
+{
+    ShaderCleanup(shaderAlloc.Get<Shader_SetupInfo>(id.id), shaderAlloc.Get<Shader_RuntimeInfo>(id.id));
+    shaderAlloc.Dealloc(id.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReloadShader(const ShaderId id, const AnyFX::ShaderEffect* effect)
+{
+    NullShaderSetupInfo& setupInfo = shaderAlloc.Get<Shader_SetupInfo>(id.id);
+    NullShaderRuntimeInfo& runtimeInfo = shaderAlloc.Get<Shader_RuntimeInfo>(id.id);
+    ShaderSetupReflection(shaderAlloc.Get<Shader_ReflectionInfo>(id.id), effect);
+
+    // keep the program ids stable, just like a GPU backend would
+    const std::vector<AnyFX::ProgramBase*>& programs = effect->GetPrograms();
+    for (size_t i = 0; i < programs.size(); i++)
+    {
+        ShaderFeature::Mask mask = ShaderFeatureMask(programs[i]->GetAnnotationString("Mask").c_str());
+        IndexT index = runtimeInfo.programMap.FindIndex(mask);
+        if (index != InvalidIndex)
+        {
+            const ShaderProgramId& program = runtimeInfo.programMap.ValueAtIndex(index);
+            shaderProgramAlloc.Get<ShaderProgram_SetupInfo>(program.programId).name = programs[i]->name.c_str();
+            CoreGraphics::ReloadShaderProgram(program);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CoreGraphics::ResourceTableId
+ShaderCreateResourceTable(const CoreGraphics::ShaderId id, const IndexT group, const uint overallocationSize)
+{
+    const NullShaderSetupInfo& info = shaderAlloc.Get<Shader_SetupInfo>(id.id);
+    IndexT idx = info.descriptorSetLayoutMap.FindIndex(group);
+    if (idx == InvalidIndex) return CoreGraphics::InvalidResourceTableId;
+    else
+    {
+        ResourceTableCreateInfo crInfo =
+        {
+            Util::Get<1>(info.descriptorSetLayouts[info.descriptorSetLayoutMap.ValueAtIndex(idx)]),
+            overallocationSize
+        };
+        return CoreGraphics::CreateResourceTable(crInfo);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+ResourceTableSet
+ShaderCreateResourceTableSet(const ShaderId id, const IndexT group, const uint overallocationSize)
+{
+    const NullShaderSetupInfo& info = shaderAlloc.Get<Shader_SetupInfo>(id.id);
+    IndexT idx = info.descriptorSetLayoutMap.FindIndex(group);
+    if (idx == InvalidIndex) return CoreGraphics::ResourceTableSet();
+    else
+    {
+        ResourceTableCreateInfo crInfo =
+        {
+            Util::Get<1>(info.descriptorSetLayouts[info.descriptorSetLayoutMap.ValueAtIndex(idx)]),
+            overallocationSize
+        };
+        return CoreGraphics::ResourceTableSet(crInfo);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const bool
+ShaderHasResourceTable(const ShaderId id, const IndexT group)
+{
+    const NullShaderSetupInfo& info = shaderAlloc.Get<Shader_SetupInfo>(id.id);
+    return info.descriptorSetLayoutMap.FindIndex(group) != InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static BufferId
+CreateConstantBuffer(const Util::StringAtom& name, uint32_t byteSize, BufferAccessMode mode)
+{
+    if (byteSize == 0)
+        return CoreGraphics::InvalidBufferId;
+
+    BufferCreateInfo info;
+    info.byteSize = byteSize;
+    info.name = name;
+    info.mode = mode;
+    info.queueSupport = CoreGraphics::GraphicsQueueSupport | CoreGraphics::ComputeQueueSupport;
+    info.usageFlags = CoreGraphics::ConstantBuffer;
+
+    // initialize data to zeroes
+    Util::FixedArray<byte> data(byteSize, 0x0);
+    info.data = data.Begin();
+    info.dataSize = data.Size();
+    return CoreGraphics::CreateBuffer(info);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CoreGraphics::BufferId
+ShaderCreateConstantBuffer(const CoreGraphics::ShaderId id, const Util::StringAtom& name, CoreGraphics::BufferAccessMode mode)
+{
+    const auto& uniformBuffers = shaderAlloc.Get<Shader_ReflectionInfo>(id.id).uniformBuffersByName;
+    IndexT i = uniformBuffers.FindIndex(name);
+    if (i == InvalidIndex)
+        return CoreGraphics::InvalidBufferId;
+    return CreateConstantBuffer(name, uniformBuffers.ValueAtIndex(i).byteSize, mode);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CoreGraphics::BufferId
+ShaderCreateConstantBuffer(const CoreGraphics::ShaderId id, const IndexT cbIndex, CoreGraphics::BufferAccessMode mode)
+{
+    const NullReflectionInfo::UniformBuffer& buffer = shaderAlloc.Get<Shader_ReflectionInfo>(id.id).uniformBuffers[cbIndex];
+    return CreateConstantBuffer(buffer.name, buffer.byteSize, mode);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const BufferId
+ShaderCreateConstantBuffer(const ShaderId id, const IndexT group, const IndexT cbIndex, BufferAccessMode mode)
+{
+    const NullReflectionInfo::UniformBuffer& buffer = shaderAlloc.Get<Shader_ReflectionInfo>(id.id).uniformBuffersPerSet[group][cbIndex];
+    return CreateConstantBuffer(buffer.name, buffer.byteSize, mode);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const uint
+ShaderCalculateConstantBufferIndex(const uint64 bindingMask, const IndexT slot)
+{
+    if ((bindingMask & (1ull << slot)) == 0)
+        return 0xFFFFFFFF;
+    uint mask = (1 << slot) - 1;
+    uint survivingBits = bindingMask & mask;
+    return Util::PopCnt(survivingBits);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const IndexT
+ShaderGetConstantBinding(const CoreGraphics::ShaderId id, const Util::StringAtom& name)
+{
+    const NullShaderSetupInfo& info = shaderAlloc.Get<Shader_SetupInfo>(id.id);
+    IndexT index = info.constantBindings.FindIndex(name.Value());
+    if (index == InvalidIndex)  return INT32_MAX; // invalid binding
+    else                        return info.constantBindings.ValueAtIndex(index);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const IndexT
+ShaderGetConstantBinding(const CoreGraphics::ShaderId id, const IndexT cIndex)
+{
+    return shaderAlloc.Get<Shader_SetupInfo>(id.id).constantBindings.ValueAtIndex(cIndex);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const SizeT
+ShaderGetConstantBindingsCount(const CoreGraphics::ShaderId id)
+{
+    return shaderAlloc.Get<Shader_SetupInfo>(id.id).constantBindings.Size();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+CoreGraphics::ResourceTableLayoutId
+ShaderGetResourceTableLayout(const CoreGraphics::ShaderId id, const IndexT group)
+{
+    const NullShaderSetupInfo& setupInfo = shaderAlloc.Get<Shader_SetupInfo>(id.id);
+    uint layout = setupInfo.descriptorSetLayoutMap[group];
+    return Util::Get<1>(setupInfo.descriptorSetLayouts[layout]);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+CoreGraphics::ResourcePipelineId
+ShaderGetResourcePipeline(const CoreGraphics::ShaderId id)
+{
+    return shaderAlloc.Get<Shader_SetupInfo>(id.id).pipelineLayout;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const Resources::ResourceName
+ShaderGetName(const ShaderId id)
+{
+    return shaderAlloc.Get<Shader_SetupInfo>(id.id).name;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const SizeT
+ShaderGetConstantCount(const CoreGraphics::ShaderId id)
+{
+    return shaderAlloc.Get<Shader_ReflectionInfo>(id.id).variables.Size();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CoreGraphics::ShaderConstantType
+ShaderGetConstantType(const CoreGraphics::ShaderId id, const IndexT i)
+{
+    return shaderAlloc.Get<Shader_ReflectionInfo>(id.id).variables[i].type;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CoreGraphics::ShaderConstantType
+ShaderGetConstantType(const CoreGraphics::ShaderId id, const Util::StringAtom& name)
+{
+    return shaderAlloc.Get<Shader_ReflectionInfo>(id.id).variablesByName[name].handleType;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const Util::StringAtom
+ShaderGetConstantBlockName(const CoreGraphics::ShaderId id, const Util::StringAtom& name)
+{
+    return shaderAlloc.Get<Shader_ReflectionInfo>(id.id).variablesByName[name].blockName;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const Util::StringAtom
+ShaderGetConstantBlockName(const CoreGraphics::ShaderId id, const IndexT cIndex)
+{
+    return shaderAlloc.Get<Shader_ReflectionInfo>(id.id).variables[cIndex].blockName;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const Util::StringAtom
+ShaderGetConstantName(const CoreGraphics::ShaderId id, const IndexT i)
+{
+    return shaderAlloc.Get<Shader_ReflectionInfo>(id.id).variables[i].name;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const IndexT
+ShaderGetConstantGroup(const CoreGraphics::ShaderId id, const Util::StringAtom& name)
+{
+    const NullReflectionInfo& reflection = shaderAlloc.Get<Shader_ReflectionInfo>(id.id);
+    IndexT idx = reflection.variablesByName.FindIndex(name);
+    if (idx != InvalidIndex)
+        return reflection.variablesByName.ValueAtIndex(idx).blockSet;
+    else
+        return -1;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const IndexT
+ShaderGetConstantSlot(const CoreGraphics::ShaderId id, const Util::StringAtom& name)
+{
+    const NullReflectionInfo& reflection = shaderAlloc.Get<Shader_ReflectionInfo>(id.id);
+    IndexT idx = reflection.variablesByName.FindIndex(name);
+    if (idx != InvalidIndex)
+        return reflection.variablesByName.ValueAtIndex(idx).blockBinding;
+    else
+        return -1;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const SizeT
+ShaderGetConstantBufferCount(const CoreGraphics::ShaderId id)
+{
+    return shaderAlloc.Get<Shader_ReflectionInfo>(id.id).uniformBuffers.Size();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const SizeT
+ShaderGetConstantBufferSize(const CoreGraphics::ShaderId id, const IndexT i)
+{
+    return shaderAlloc.Get<Shader_ReflectionInfo>(id.id).uniformBuffers[i].byteSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const Util::StringAtom
+ShaderGetConstantBufferName(const CoreGraphics::ShaderId id, const IndexT i)
+{
+    return shaderAlloc.Get<Shader_ReflectionInfo>(id.id).uniformBuffers[i].name;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const IndexT
+ShaderGetConstantBufferResourceSlot(const CoreGraphics::ShaderId id, const IndexT i)
+{
+    return shaderAlloc.Get<Shader_ReflectionInfo>(id.id).uniformBuffers[i].binding;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const IndexT
+ShaderGetConstantBufferResourceGroup(const CoreGraphics::ShaderId id, const IndexT i)
+{
+    return shaderAlloc.Get<Shader_ReflectionInfo>(id.id).uniformBuffers[i].set;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const uint64
+ShaderGetConstantBufferBindingMask(const ShaderId id, const IndexT group)
+{
+    const auto& masks = shaderAlloc.Get<Shader_ReflectionInfo>(id.id).uniformBuffersMask;
+    if (masks.Size() > group)
+        return masks[group];
+    else
+        return 0x0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const uint64
+ShaderGetConstantBufferSize(const ShaderId id, const IndexT group, const IndexT i)
+{
+    return shaderAlloc.Get<Shader_ReflectionInfo>(id.id).uniformBuffersPerSet[group][i].byteSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const IndexT
+ShaderGetResourceSlot(const CoreGraphics::ShaderId id, const Util::StringAtom& name)
+{
+    const NullShaderSetupInfo& info = shaderAlloc.Get<Shader_SetupInfo>(id.id);
+    IndexT index = info.resourceIndexMap.FindIndex(name);
+    if (index == InvalidIndex)  return index;
+    else                        return info.resourceIndexMap.ValueAtIndex(index);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const Util::Dictionary<CoreGraphics::ShaderFeature::Mask, CoreGraphics::ShaderProgramId>&
+ShaderGetPrograms(const CoreGraphics::ShaderId id)
+{
+    return shaderAlloc.Get<Shader_RuntimeInfo>(id.id).programMap;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const Util::StringAtom
+ShaderProgramGetName(const ShaderProgramId id)
+{
+    return shaderProgramAlloc.Get<ShaderProgram_SetupInfo>(id.programId).name;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CoreGraphics::ShaderProgramId
+ShaderGetProgram(const ShaderId id, const CoreGraphics::ShaderFeature::Mask mask)
+{
+    const NullShaderRuntimeInfo& runtime = shaderAlloc.Get<Shader_RuntimeInfo>(id.id);
+    IndexT i = runtime.programMap.FindIndex(mask);
+    if (i == InvalidIndex)  return CoreGraphics::InvalidShaderProgramId;
+    else                    return runtime.programMap.ValueAtIndex(i);
+}
+
+//------------------------------------------------------------------------------
+/**
+    The null device has no ray tracing support, so no program has any ray tracing stages
+*/
+RayTracingBits
+ShaderProgramGetRaytracingBits(const ShaderProgramId id)
+{
+    RayTracingBits bits;
+    bits.bits = 0x0;
+    return bits;
+}
+
+} // namespace CoreGraphics
@@ -0,0 +1,107 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    Null implementation of a shader effect.
+
+    The AnyFX effect is reflected the same way as on a real device, so
+    resource tables, constant bindings and constant buffer sizes match what
+    the engine would get from a GPU backend. Programs carry no shader code.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "ids/idallocator.h"
+#include "util/tupleutility.h"
+#include "coregraphics/shader.h"
+#include "coregraphics/resourcetable.h"
+#include "coregraphics/shaderidentifier.h"
+
+namespace AnyFX
+{
+class ShaderEffect;
+}
+
+namespace Null
+{
+
+typedef Util::Dictionary<CoreGraphics::ShaderFeature::Mask, CoreGraphics::ShaderProgramId> ProgramMap;
+
+struct NullShaderRuntimeInfo
+{
+    ProgramMap programMap;
+};
+
+struct NullShaderSetupInfo
+{
+    Resources::ResourceName name;
+    CoreGraphics::ShaderIdentifier::Code id;
+    CoreGraphics::ResourcePipelineId pipelineLayout;
+    Util::Dictionary<Util::StringAtom, uint32_t> resourceIndexMap;
+    Util::Dictionary<Util::StringAtom, IndexT> constantBindings;
+    Util::FixedArray<Util::Pair<uint32_t, CoreGraphics::ResourceTableLayoutId>> descriptorSetLayouts;
+    Util::Dictionary<uint32_t, uint32_t> descriptorSetLayoutMap;
+};
+
+struct NullReflectionInfo
+{
+    struct UniformBuffer
+    {
+        uint32_t set;
+        uint32_t binding;
+        uint32_t byteSize;
+        Util::StringAtom name;
+    };
+    Util::Array<Util::Array<UniformBuffer>> uniformBuffersPerSet;
+    Util::Dictionary<Util::StringAtom, UniformBuffer> uniformBuffersByName;
+    Util::Array<UniformBuffer> uniformBuffers;
+
+    struct Variable
+    {
+        CoreGraphics::ShaderConstantType type;
+        CoreGraphics::ShaderConstantType handleType;
+        Util::StringAtom name;
+        Util::StringAtom blockName;
+        uint32_t blockSet;
+        uint32_t blockBinding;
+    };
+    Util::Dictionary<Util::StringAtom, Variable> variablesByName;
+    Util::Array<Variable> variables;
+    Util::Array<uint64> uniformBuffersMask;
+};
+
+enum
+{
+    Shader_ReflectionInfo,
+    Shader_SetupInfo,
+    Shader_RuntimeInfo,
+};
+
+typedef Ids::IdAllocator<
+    NullReflectionInfo,
+    NullShaderSetupInfo,
+    NullShaderRuntimeInfo
+> ShaderAllocator;
+extern ShaderAllocator shaderAlloc;
+
+struct NullShaderProgramSetupInfo
+{
+    Util::StringAtom name;
+    CoreGraphics::ShaderFeature::Mask mask;
+    CoreGraphics::ResourcePipelineId layout;
+};
+
+enum
+{
+    ShaderProgram_SetupInfo,
+};
+
+typedef Ids::IdAllocator<
+    NullShaderProgramSetupInfo
+> ShaderProgramAllocator;
+extern ShaderProgramAllocator shaderProgramAlloc;
+
+/// get the resource pipeline a program was created with
+CoreGraphics::ResourcePipelineId ShaderProgramGetLayout(const CoreGraphics::ShaderProgramId id);
+
+} // namespace Null
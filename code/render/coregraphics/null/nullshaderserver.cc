@@ -0,0 +1,69 @@
+//------------------------------------------------------------------------------
+//  nullshaderserver.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "nullshaderserver.h"
+#include "coregraphics/graphicsdevice.h"
+
+namespace Null
+{
+
+__ImplementClass(Null::NullShaderServer, 'NLSS', Base::ShaderServerBase);
+__ImplementInterfaceSingleton(Null::NullShaderServer);
+
+//------------------------------------------------------------------------------
+/**
+*/
+NullShaderServer::NullShaderServer() :
+    factory(nullptr)
+{
+    __ConstructSingleton;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+NullShaderServer::~NullShaderServer()
+{
+    __DestructSingleton;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+NullShaderServer::Open()
+{
+    n_assert(!this->IsOpen());
+
+    // the shader loader creates effects through the factory singleton
+    this->factory = new(AnyFX::EffectFactory);
+    ShaderServerBase::Open();
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+NullShaderServer::Close()
+{
+    n_assert(this->IsOpen());
+    delete this->factory;
+    this->factory = nullptr;
+
+    CoreGraphics::WaitAndClearPendingCommands();
+    ShaderServerBase::Close();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+NullShaderServer::UpdateResources()
+{
+    // empty, texture views never change on the null device
+}
+
+} // namespace Null
@@ -0,0 +1,43 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    Implements the shader server used by the null renderer.
+
+    Shaders are still parsed with AnyFX so their reflection is available,
+    but there are no image views to update.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "core/refcounted.h"
+#include "coregraphics/base/shaderserverbase.h"
+#include "coregraphics/config.h"
+#include "effectfactory.h"
+
+namespace Null
+{
+
+class NullShaderServer : public Base::ShaderServerBase
+{
+    __DeclareClass(NullShaderServer);
+    __DeclareInterfaceSingleton(NullShaderServer);
+public:
+    /// constructor
+    NullShaderServer();
+    /// destructor
+    virtual ~NullShaderServer();
+
+    /// open the shader server
+    bool Open();
+    /// close the shader server
+    void Close();
+
+    /// begin frame
+    void UpdateResources();
+
+private:
+    AnyFX::EffectFactory* factory;
+};
+
+} // namespace Null
@@ -0,0 +1,71 @@
+//------------------------------------------------------------------------------
+//  @file nullswapchain.cc
+//  @copyright (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "nullswapchain.h"
+#include "coregraphics/graphicsdevice.h"
+
+namespace Null
+{
+NullSwapchainAllocator swapchainAllocator(0xFFFF);
+} // namespace Null
+
+namespace CoreGraphics
+{
+
+using namespace Null;
+
+//------------------------------------------------------------------------------
+/**
+*/
+SwapchainId
+CreateSwapchain(const SwapchainCreateInfo& info)
+{
+    Ids::Id32 id = swapchainAllocator.Alloc();
+    swapchainAllocator.Set<Swapchain_DisplayMode>(id, info.displayMode);
+    swapchainAllocator.Set<Swapchain_CurrentBackbuffer>(id, 0);
+    swapchainAllocator.Set<Swapchain_NumBackbuffers>(id, CoreGraphics::GetNumBufferedFrames());
+
+    SwapchainId ret = id;
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroySwapchain(const SwapchainId id)
+{
+    swapchainAllocator.Dealloc(id.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+SwapchainSwap(const SwapchainId id)
+{
+    uint& currentBackbuffer = swapchainAllocator.Get<Swapchain_CurrentBackbuffer>(id.id);
+    currentBackbuffer = (currentBackbuffer + 1) % swapchainAllocator.Get<Swapchain_NumBackbuffers>(id.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+SwapchainCopy(const SwapchainId id, const CoreGraphics::CmdBufferId cmdBuf, const CoreGraphics::TextureId source)
+{
+    // empty, there is no backbuffer to copy to
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+SwapchainPresent(const SwapchainId id)
+{
+    // empty, nothing is ever displayed
+}
+
+} // namespace CoreGraphics
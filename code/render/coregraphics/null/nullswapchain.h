@@ -0,0 +1,29 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    Null swapchain, cycles through its backbuffer indices without any images
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "ids/idallocator.h"
+#include "coregraphics/swapchain.h"
+namespace Null
+{
+
+enum
+{
+    Swapchain_DisplayMode,
+    Swapchain_CurrentBackbuffer,
+    Swapchain_NumBackbuffers
+};
+
+typedef Ids::IdAllocator<
+    CoreGraphics::DisplayMode,
+    uint,
+    uint
+> NullSwapchainAllocator;
+extern NullSwapchainAllocator swapchainAllocator;
+
+} // namespace Null
@@ -0,0 +1,505 @@
+//------------------------------------------------------------------------------
+// nulltexture.cc
+// (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "nulltexture.h"
+#include "nulltextureview.h"
+#include "coregraphics/graphicsdevice.h"
+#include "coregraphics/window.h"
+#include "graphics/bindlessregistry.h"
+
+namespace Null
+{
+
+NullTextureAllocator textureAllocator;
+NullTextureStencilExtensionAllocator textureStencilExtensionAllocator;
+NullTextureSparseExtensionAllocator textureSparseExtensionAllocator;
+
+} // namespace Null
+
+namespace CoreGraphics
+{
+
+using namespace Null;
+_IMPL_ACQUIRE_RELEASE(TextureId, textureAllocator);
+
+//------------------------------------------------------------------------------
+/**
+    Split every layer and mip of a sparse texture into pages
+*/
+static void
+SetupSparse(Ids::Id32 sparseExtension, const NullTextureLoadInfo& info)
+{
+    TextureSparsePageTable& table = textureSparseExtensionAllocator.Get<TextureExtension_SparsePageTable>(sparseExtension);
+    table.Resize(info.layers);
+    for (uint layer = 0; layer < info.layers; layer++)
+    {
+        table[layer].Resize(info.mips);
+        for (uint mip = 0; mip < info.mips; mip++)
+        {
+            const uint width = Math::max((uint)info.width >> mip, 1u);
+            const uint height = Math::max((uint)info.height >> mip, 1u);
+            const uint depth = Math::max((uint)info.depth >> mip, 1u);
+            Util::Array<TextureSparsePage>& pages = table[layer][mip];
+            for (uint z = 0; z < depth; z += TextureSparsePageExtents.depth)
+            {
+                for (uint y = 0; y < height; y += TextureSparsePageExtents.height)
+                {
+                    for (uint x = 0; x < width; x += TextureSparsePageExtents.width)
+                    {
+                        TextureSparsePage page;
+                        page.offset = TextureSparsePageOffset{ x, y, z };
+                        page.extent = TextureSparsePageSize
+                        {
+                            Math::min(TextureSparsePageExtents.width, width - x),
+                            Math::min(TextureSparsePageExtents.height, height - y),
+                            Math::min(TextureSparsePageExtents.depth, depth - z)
+                        };
+                        page.alloc = CoreGraphics::Alloc{ nullptr, 0, 0, 0, 0, 0 };
+                        pages.Append(page);
+                    }
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static void
+SetupTexture(const TextureId id)
+{
+    __Lock(textureAllocator, id.id);
+    NullTextureRuntimeInfo& runtimeInfo = textureAllocator.Get<Texture_RuntimeInfo>(id.id);
+    NullTextureLoadInfo& loadInfo = textureAllocator.Get<Texture_LoadInfo>(id.id);
+
+    const bool isDepthFormat = PixelFormat::IsDepthFormat(loadInfo.format);
+
+    if (loadInfo.sparse)
+    {
+        n_assert(loadInfo.data == nullptr);
+        loadInfo.sparseExtension = textureSparseExtensionAllocator.Alloc();
+        SetupSparse(loadInfo.sparseExtension, loadInfo);
+        textureSparseExtensionAllocator.Release(loadInfo.sparseExtension);
+    }
+
+    // the initial data is never read, don't keep a pointer to it
+    loadInfo.data = nullptr;
+    loadInfo.dataSize = 0;
+
+    if (isDepthFormat)
+    {
+        TextureViewCreateInfo viewCreate;
+        viewCreate.format = loadInfo.format;
+        viewCreate.numLayers = loadInfo.layers;
+        viewCreate.numMips = loadInfo.mips - loadInfo.minMip;
+        viewCreate.startLayer = 0;
+        viewCreate.startMip = loadInfo.minMip;
+        viewCreate.tex = id;
+        viewCreate.bits = ImageBits::StencilBits;
+        TextureViewId stencilView = CreateTextureView(viewCreate);
+
+        loadInfo.stencilExtension = textureStencilExtensionAllocator.Alloc();
+        textureStencilExtensionAllocator.Set<TextureExtension_StencilInfo>(loadInfo.stencilExtension, stencilView);
+        textureStencilExtensionAllocator.Set<TextureExtension_StencilBind>(loadInfo.stencilExtension, 0xFFFFFFFF);
+        textureStencilExtensionAllocator.Release(loadInfo.stencilExtension);
+    }
+
+    // register image with shader server
+    if (loadInfo.bindless)
+    {
+        if (runtimeInfo.bind == 0xFFFFFFFF)
+            runtimeInfo.bind = Graphics::RegisterTexture(id, runtimeInfo.type, isDepthFormat);
+        else
+            Graphics::ReregisterTexture(id, runtimeInfo.type, runtimeInfo.bind, isDepthFormat);
+
+        // if this is a depth-stencil texture, also register the stencil
+        if (isDepthFormat)
+        {
+            __Lock(textureStencilExtensionAllocator, loadInfo.stencilExtension);
+            IndexT& bind = textureStencilExtensionAllocator.Get<TextureExtension_StencilBind>(loadInfo.stencilExtension);
+            bind = Graphics::RegisterTexture(id, runtimeInfo.type, false, true);
+        }
+    }
+    else
+        runtimeInfo.bind = 0xFFFFFFFF;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static void
+DeleteTexture(const TextureId id)
+{
+    __Lock(textureAllocator, id.id);
+    NullTextureLoadInfo& loadInfo = textureAllocator.Get<Texture_LoadInfo>(id.id);
+    NullTextureRuntimeInfo& runtimeInfo = textureAllocator.Get<Texture_RuntimeInfo>(id.id);
+
+    if (loadInfo.stencilExtension != Ids::InvalidId32)
+    {
+        __Lock(textureStencilExtensionAllocator, loadInfo.stencilExtension);
+        TextureViewId stencil = textureStencilExtensionAllocator.Get<TextureExtension_StencilInfo>(loadInfo.stencilExtension);
+        IndexT bind = textureStencilExtensionAllocator.Get<TextureExtension_StencilBind>(loadInfo.stencilExtension);
+        CoreGraphics::DestroyTextureView(stencil);
+        if (bind != 0xFFFFFFFF)
+            Graphics::UnregisterTexture(bind, runtimeInfo.type);
+        textureStencilExtensionAllocator.Dealloc(loadInfo.stencilExtension);
+        loadInfo.stencilExtension = Ids::InvalidId32;
+    }
+
+    if (loadInfo.sparseExtension != Ids::InvalidId32)
+    {
+        textureSparseExtensionAllocator.Acquire(loadInfo.sparseExtension);
+        textureSparseExtensionAllocator.Get<TextureExtension_SparsePageTable>(loadInfo.sparseExtension).Clear();
+        textureSparseExtensionAllocator.Dealloc(loadInfo.sparseExtension);
+        textureSparseExtensionAllocator.Release(loadInfo.sparseExtension);
+        loadInfo.sparseExtension = Ids::InvalidId32;
+    }
+
+    if (runtimeInfo.bind != 0xFFFFFFFF)
+        Graphics::UnregisterTexture(runtimeInfo.bind, runtimeInfo.type);
+    CoreGraphics::DelayedDeleteTexture(id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const TextureId
+CreateTexture(const TextureCreateInfo& info)
+{
+    if (info.windowRelative)
+        n_assert(info.type == CoreGraphics::Texture2D);
+
+    Ids::Id32 id = textureAllocator.Alloc();
+
+    TextureId ret = id;
+
+#ifdef WITH_NEBULA_EDITOR
+    TrackedTextures.Append(ret);
+#endif
+
+    NullTextureRuntimeInfo& runtimeInfo = textureAllocator.Get<Texture_RuntimeInfo>(id);
+    NullTextureLoadInfo& loadInfo = textureAllocator.Get<Texture_LoadInfo>(id);
+
+    // create adjusted info
+    TextureCreateInfoAdjusted adjustedInfo = TextureGetAdjustedInfo(info);
+    (TextureCreateInfoAdjusted&)loadInfo = adjustedInfo;
+    loadInfo.relativeDims.width = adjustedInfo.widthScale;
+    loadInfo.relativeDims.height = adjustedInfo.heightScale;
+    loadInfo.relativeDims.depth = adjustedInfo.depthScale;
+    loadInfo.stencilExtension = Ids::InvalidId32;
+    loadInfo.sparseExtension = Ids::InvalidId32;
+
+    runtimeInfo.bind = 0xFFFFFFFF;
+    runtimeInfo.type = adjustedInfo.type;
+
+    // the lock in SetupTexture must be able to take ownership
+    CoreGraphics::TextureIdRelease(ret);
+    SetupTexture(ret);
+
+#if NEBULA_GRAPHICS_DEBUG
+    ObjectSetName(ret, info.name.Value());
+#endif
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyTexture(const TextureId id)
+{
+    DeleteTexture(id);
+    textureAllocator.Dealloc(id.id);
+
+#ifdef WITH_NEBULA_EDITOR
+    TrackedTextures.EraseIndex(TrackedTextures.FindIndex(id));
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Util::StringAtom
+TextureGetName(const TextureId id)
+{
+    return textureAllocator.ConstGet<Texture_LoadInfo>(id.id).name;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+CoreGraphics::TextureDimensions
+TextureGetDimensions(const CoreGraphics::TextureId id)
+{
+    const NullTextureLoadInfo& loadInfo = textureAllocator.ConstGet<Texture_LoadInfo>(id.id);
+    return CoreGraphics::TextureDimensions { .width = (SizeT)loadInfo.width, .height = (SizeT)loadInfo.height, .depth = (SizeT)loadInfo.depth };
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+CoreGraphics::TextureRelativeDimensions
+TextureGetRelativeDimensions(const CoreGraphics::TextureId id)
+{
+    return textureAllocator.ConstGet<Texture_LoadInfo>(id.id).relativeDims;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+CoreGraphics::PixelFormat::Code
+TextureGetPixelFormat(const CoreGraphics::TextureId id)
+{
+    return textureAllocator.ConstGet<Texture_LoadInfo>(id.id).format;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+CoreGraphics::TextureType
+TextureGetType(const CoreGraphics::TextureId id)
+{
+    return textureAllocator.ConstGet<Texture_RuntimeInfo>(id.id).type;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+TextureGetNumMips(const CoreGraphics::TextureId id)
+{
+    return textureAllocator.ConstGet<Texture_LoadInfo>(id.id).mips;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+TextureGetNumLayers(const CoreGraphics::TextureId id)
+{
+    return textureAllocator.ConstGet<Texture_LoadInfo>(id.id).layers;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+TextureGetNumSamples(const CoreGraphics::TextureId id)
+{
+    return textureAllocator.ConstGet<Texture_LoadInfo>(id.id).samples;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CoreGraphics::TextureId
+TextureGetAlias(const CoreGraphics::TextureId id)
+{
+    return textureAllocator.ConstGet<Texture_LoadInfo>(id.id).alias;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CoreGraphics::TextureUsage
+TextureGetUsage(const TextureId id)
+{
+    return textureAllocator.ConstGet<Texture_LoadInfo>(id.id).usage;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CoreGraphics::ImageLayout
+TextureGetDefaultLayout(const CoreGraphics::TextureId id)
+{
+    return textureAllocator.ConstGet<Texture_LoadInfo>(id.id).defaultLayout;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+uint
+TextureGetBindlessHandle(const CoreGraphics::TextureId id)
+{
+    return textureAllocator.ConstGet<Texture_RuntimeInfo>(id.id).bind;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+uint
+TextureGetStencilBindlessHandle(const CoreGraphics::TextureId id)
+{
+    Ids::Id32 stencil = textureAllocator.ConstGet<Texture_LoadInfo>(id.id).stencilExtension;
+    n_assert(stencil != Ids::InvalidId32);
+    return textureStencilExtensionAllocator.ConstGet<TextureExtension_StencilBind>(stencil);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TextureWindowResized(const TextureId id)
+{
+    __Lock(textureAllocator, id.id);
+    NullTextureLoadInfo& loadInfo = textureAllocator.Get<Texture_LoadInfo>(id.id);
+    NullTextureRuntimeInfo& runtimeInfo = textureAllocator.Get<Texture_RuntimeInfo>(id.id);
+
+    if (loadInfo.windowRelative)
+    {
+        uint tmp = runtimeInfo.bind;
+        runtimeInfo.bind = 0xFFFFFFFF;
+        DeleteTexture(id);
+
+        // if the window has been resized, we need to update our dimensions based on relative size
+        const CoreGraphics::DisplayMode mode = CoreGraphics::WindowGetDisplayMode(loadInfo.window);
+        loadInfo.width = mode.GetWidth() * loadInfo.relativeDims.width;
+        loadInfo.height = mode.GetHeight() * loadInfo.relativeDims.height;
+        loadInfo.depth = 1;
+
+        runtimeInfo.bind = tmp;
+        SetupTexture(id);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+CoreGraphics::TextureSparsePageSize
+TextureSparseGetPageSize(const CoreGraphics::TextureId id)
+{
+    n_assert(textureAllocator.ConstGet<Texture_LoadInfo>(id.id).sparseExtension != Ids::InvalidId32);
+    return TextureSparsePageExtents;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+IndexT
+TextureSparseGetPageIndex(const CoreGraphics::TextureId id, IndexT layer, IndexT mip, IndexT x, IndexT y, IndexT z)
+{
+    const NullTextureLoadInfo& loadInfo = textureAllocator.ConstGet<Texture_LoadInfo>(id.id);
+    n_assert(loadInfo.sparseExtension != Ids::InvalidId32);
+    const uint width = Math::max((uint)loadInfo.width >> mip, 1u);
+    const uint height = Math::max((uint)loadInfo.height >> mip, 1u);
+    const uint pagesX = Math::divandroundup(width, TextureSparsePageExtents.width);
+    const uint pagesY = Math::divandroundup(height, TextureSparsePageExtents.height);
+    return x / TextureSparsePageExtents.width + pagesX * (y / TextureSparsePageExtents.height + pagesY * (z / TextureSparsePageExtents.depth));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CoreGraphics::TextureSparsePage&
+TextureSparseGetPage(const CoreGraphics::TextureId id, IndexT layer, IndexT mip, IndexT pageIndex)
+{
+    Ids::Id32 sparseExtension = textureAllocator.ConstGet<Texture_LoadInfo>(id.id).sparseExtension;
+    n_assert(sparseExtension != Ids::InvalidId32);
+    const TextureSparsePageTable& table = textureSparseExtensionAllocator.ConstGet<TextureExtension_SparsePageTable>(sparseExtension);
+    return table[layer][mip][pageIndex];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+TextureSparseGetNumPages(const CoreGraphics::TextureId id, IndexT layer, IndexT mip)
+{
+    Ids::Id32 sparseExtension = textureAllocator.ConstGet<Texture_LoadInfo>(id.id).sparseExtension;
+    n_assert(sparseExtension != Ids::InvalidId32);
+    const TextureSparsePageTable& table = textureSparseExtensionAllocator.ConstGet<TextureExtension_SparsePageTable>(sparseExtension);
+    return table[layer][mip].Size();
+}
+
+//------------------------------------------------------------------------------
+/**
+    There is no mip tail, every mip is paged
+*/
+IndexT
+TextureSparseGetMaxMip(const CoreGraphics::TextureId id)
+{
+    const NullTextureLoadInfo& loadInfo = textureAllocator.ConstGet<Texture_LoadInfo>(id.id);
+    n_assert(loadInfo.sparseExtension != Ids::InvalidId32);
+    return loadInfo.mips;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TextureSparseEvict(const CoreGraphics::TextureId id, IndexT layer, IndexT mip, IndexT pageIndex)
+{
+    // empty, pages are always resident
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TextureSparseMakeResident(const CoreGraphics::TextureId id, IndexT layer, IndexT mip, IndexT pageIndex)
+{
+    // empty, pages are always resident
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TextureSparseEvictMip(const CoreGraphics::TextureId id, IndexT layer, IndexT mip)
+{
+    // empty, pages are always resident
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TextureSparseMakeMipResident(const CoreGraphics::TextureId id, IndexT layer, IndexT mip)
+{
+    // empty, pages are always resident
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TextureSparseCommitChanges(const CoreGraphics::TextureId id)
+{
+    // empty, there are no bindings to commit
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TextureClearColor(const CoreGraphics::CmdBufferId cmd, const CoreGraphics::TextureId id, Math::vec4 color, const CoreGraphics::ImageLayout layout, const CoreGraphics::TextureSubresourceInfo& subres)
+{
+    // empty, textures have no contents
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TextureClearDepthStencil(const CoreGraphics::CmdBufferId cmd, const CoreGraphics::TextureId id, float depth, uint stencil, const CoreGraphics::ImageLayout layout, const CoreGraphics::TextureSubresourceInfo& subres)
+{
+    // empty, textures have no contents
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TextureSetHighestLod(const CoreGraphics::TextureId id, uint lod)
+{
+    __Lock(textureAllocator, id.id);
+    NullTextureLoadInfo& loadInfo = textureAllocator.Get<Texture_LoadInfo>(id.id);
+    loadInfo.minMip = Math::min(lod, loadInfo.mips - 1);
+}
+
+} // namespace CoreGraphics
@@ -0,0 +1,76 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    Null texture abstraction types.
+
+    Textures on the null device are descriptions only, there is no image
+    memory behind them. They are still registered with the bindless registry
+    so the CPU side cost of managing them matches a real device.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "coregraphics/texture.h"
+#include "coregraphics/pixelformat.h"
+#include "coregraphics/textureview.h"
+#include "ids/idallocator.h"
+
+namespace Null
+{
+struct NullTextureLoadInfo : CoreGraphics::TextureCreateInfoAdjusted
+{
+    CoreGraphics::TextureRelativeDimensions relativeDims;
+    Ids::Id32 stencilExtension;
+    Ids::Id32 sparseExtension;
+};
+
+struct NullTextureRuntimeInfo
+{
+    CoreGraphics::TextureType type;
+    uint32_t bind;
+};
+
+enum
+{
+    Texture_RuntimeInfo,
+    Texture_LoadInfo,
+};
+
+/// we need a thread-safe allocator since it will be used by both the memory and stream pool
+typedef Ids::IdAllocatorSafe<
+    0xFFFF
+    , NullTextureRuntimeInfo                 // runtime info (for binding)
+    , NullTextureLoadInfo                    // loading info (mostly used during the load/unload phase)
+> NullTextureAllocator;
+extern NullTextureAllocator textureAllocator;
+
+enum
+{
+    TextureExtension_StencilInfo
+    , TextureExtension_StencilBind
+};
+typedef Ids::IdAllocatorSafe<
+    0xFFFF
+    , CoreGraphics::TextureViewId
+    , IndexT
+> NullTextureStencilExtensionAllocator;
+extern NullTextureStencilExtensionAllocator textureStencilExtensionAllocator;
+
+/// pages per layer and mip, all pages are always resident
+typedef Util::FixedArray<Util::FixedArray<Util::Array<CoreGraphics::TextureSparsePage>>> TextureSparsePageTable;
+
+enum
+{
+    TextureExtension_SparsePageTable
+};
+typedef Ids::IdAllocatorSafe<
+    0xFF
+    , TextureSparsePageTable
+> NullTextureSparseExtensionAllocator;
+extern NullTextureSparseExtensionAllocator textureSparseExtensionAllocator;
+
+/// the page size reported for sparse textures
+static const CoreGraphics::TextureSparsePageSize TextureSparsePageExtents = { 128, 128, 1 };
+
+} // namespace Null
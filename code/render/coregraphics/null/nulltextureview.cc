@@ -0,0 +1,74 @@
+//------------------------------------------------------------------------------
+//  nulltextureview.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "nulltextureview.h"
+#include "coregraphics/graphicsdevice.h"
+namespace Null
+{
+NullTextureViewAllocator textureViewAllocator(0x00FFFFFF);
+} // namespace Null
+
+namespace CoreGraphics
+{
+
+using namespace Null;
+
+//------------------------------------------------------------------------------
+/**
+*/
+TextureViewId
+CreateTextureView(const TextureViewCreateInfo& info)
+{
+    Ids::Id32 id = textureViewAllocator.Alloc();
+    NullTextureViewLoadInfo& loadInfo = textureViewAllocator.Get<TextureView_LoadInfo>(id);
+
+    n_assert(info.bits != ImageBits::Auto);
+    loadInfo.tex = info.tex;
+    loadInfo.format = info.format;
+    loadInfo.mip = info.startMip;
+    loadInfo.numMips = info.numMips;
+    loadInfo.layer = info.startLayer;
+    loadInfo.numLayers = info.numLayers;
+    loadInfo.bits = info.bits;
+    loadInfo.swizzle = info.swizzle;
+
+    TextureViewId ret = id;
+
+#if NEBULA_GRAPHICS_DEBUG
+    ObjectSetName(ret, info.name.Value());
+#endif
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyTextureView(const TextureViewId id)
+{
+    CoreGraphics::DelayedDeleteTextureView(id);
+    textureViewAllocator.Dealloc(id.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TextureViewReload(const TextureViewId id)
+{
+    // empty, a null view holds no backend object which could go stale
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+TextureId
+TextureViewGetTexture(const TextureViewId id)
+{
+    return textureViewAllocator.Get<TextureView_LoadInfo>(id.id).tex;
+}
+
+} // namespace CoreGraphics
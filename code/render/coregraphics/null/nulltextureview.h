@@ -0,0 +1,37 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    Null implementation of a texture view
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "ids/idallocator.h"
+#include "coregraphics/textureview.h"
+namespace Null
+{
+
+struct NullTextureViewLoadInfo
+{
+    CoreGraphics::TextureId tex;
+    IndexT mip;
+    SizeT numMips;
+    IndexT layer;
+    SizeT numLayers;
+    CoreGraphics::PixelFormat::Code format;
+    CoreGraphics::ImageBits bits;
+    CoreGraphics::TextureSwizzle swizzle;
+};
+
+enum
+{
+    TextureView_LoadInfo
+};
+
+typedef Ids::IdAllocator<
+    NullTextureViewLoadInfo
+> NullTextureViewAllocator;
+extern NullTextureViewAllocator textureViewAllocator;
+
+} // namespace Null
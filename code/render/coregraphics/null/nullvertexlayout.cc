@@ -0,0 +1,102 @@
+//------------------------------------------------------------------------------
+//  @file nullvertexlayout.cc
+//  @copyright (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "nullvertexlayout.h"
+namespace Null
+{
+NullVertexLayoutAllocator vertexLayoutAllocator;
+} // namespace Null
+
+namespace CoreGraphics
+{
+
+using namespace Null;
+
+//------------------------------------------------------------------------------
+/**
+*/
+const VertexLayoutId
+CreateVertexLayout(const VertexLayoutCreateInfo& info)
+{
+    Ids::Id32 id = vertexLayoutAllocator.Alloc();
+    VertexLayoutInfo& loadInfo = vertexLayoutAllocator.Get<VertexSignature_LayoutInfo>(id);
+    Util::Array<SizeT>& streamSizes = vertexLayoutAllocator.Get<VertexSignature_StreamSize>(id);
+
+    loadInfo.name = info.name;
+    loadInfo.comps = info.comps;
+    streamSizes.Clear();
+
+    // offsets and sizes are calculated the same way as on a real device
+    bool usedStreams[CoreGraphics::MaxNumVertexStreams];
+    Memory::Fill(usedStreams, CoreGraphics::MaxNumVertexStreams * sizeof(bool), 0);
+
+    SizeT size = 0;
+    IndexT compIndex;
+    for (compIndex = 0; compIndex < loadInfo.comps.Size(); compIndex++)
+    {
+        CoreGraphics::VertexComponent& component = loadInfo.comps[compIndex];
+        const IndexT stream = component.GetStreamIndex();
+        component.SetByteOffset(component.GetByteOffset() + size);
+        if (usedStreams[stream])
+            streamSizes[stream] += component.GetByteSize();
+        else
+        {
+            usedStreams[stream] = true;
+            streamSizes.Append(component.GetByteSize());
+        }
+        size += component.GetByteSize();
+    }
+    loadInfo.vertexByteSize = size;
+
+    VertexLayoutId ret = id;
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyVertexLayout(const VertexLayoutId id)
+{
+    vertexLayoutAllocator.Dealloc(id.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const SizeT
+VertexLayoutGetSize(const VertexLayoutId id)
+{
+    return vertexLayoutAllocator.Get<VertexSignature_LayoutInfo>(id.id).vertexByteSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const SizeT
+VertexLayoutGetStreamSize(const VertexLayoutId id, IndexT stream)
+{
+    return vertexLayoutAllocator.Get<VertexSignature_StreamSize>(id.id)[stream];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const Util::Array<VertexComponent>&
+VertexLayoutGetComponents(const VertexLayoutId id)
+{
+    return vertexLayoutAllocator.Get<VertexSignature_LayoutInfo>(id.id).comps;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const Util::StringAtom&
+VertexLayoutGetName(const VertexLayoutId id)
+{
+    return vertexLayoutAllocator.Get<VertexSignature_LayoutInfo>(id.id).name;
+}
+
+} // namespace CoreGraphics
@@ -0,0 +1,28 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    Null implementation of a vertex layout
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "coregraphics/vertexlayout.h"
+#include "ids/idallocator.h"
+
+namespace Null
+{
+
+enum
+{
+    VertexSignature_LayoutInfo
+    , VertexSignature_StreamSize
+};
+
+typedef Ids::IdAllocator<
+    CoreGraphics::VertexLayoutInfo,
+    Util::Array<SizeT>
+> NullVertexLayoutAllocator;
+extern NullVertexLayoutAllocator vertexLayoutAllocator;
+
+} // namespace Null
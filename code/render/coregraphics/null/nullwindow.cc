@@ -0,0 +1,250 @@
+//------------------------------------------------------------------------------
+//  nullwindow.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "nullwindow.h"
+#include "coregraphics/displaydevice.h"
+#include "coregraphics/displayevent.h"
+
+namespace Null
+{
+NullWindowAllocator windowAllocator(0x00FFFFFF);
+} // namespace Null
+
+namespace CoreGraphics
+{
+
+using namespace Null;
+
+WindowId CurrentWindow;
+
+//------------------------------------------------------------------------------
+/**
+*/
+const WindowId
+CreateWindow(const WindowCreateInfo& info)
+{
+    Ids::Id32 windowId = windowAllocator.Alloc();
+    WindowId id = windowId;
+    windowAllocator.Set<Window_SetupInfo>(windowId, info);
+    windowAllocator.Set<Window_DisplayMode>(windowId, info.mode);
+    windowAllocator.Set<Window_SwapFrame>(windowId, InvalidIndex);
+
+    CoreGraphics::SwapchainCreateInfo swapCreate;
+    swapCreate.displayMode = info.mode;
+    swapCreate.vsync = info.vsync;
+    swapCreate.window = nullptr;
+    windowAllocator.Set<Window_Swapchain>(windowId, CoreGraphics::CreateSwapchain(swapCreate));
+
+    DisplayDevice::Instance()->NotifyEventHandlers(DisplayEvent(DisplayEvent::WindowOpen, id));
+    DisplayDevice::Instance()->MakeWindowCurrent(id);
+    return id;
+}
+
+//------------------------------------------------------------------------------
+/**
+    There is no native window to embed into, the window gets a default mode
+*/
+const WindowId
+EmbedWindow(const Util::Blob& windowData)
+{
+    return CreateWindow(WindowCreateInfo());
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DestroyWindow(const WindowId id)
+{
+    CoreGraphics::DestroySwapchain(windowAllocator.Get<Window_Swapchain>(id.id));
+    DisplayDevice::Instance()->NotifyEventHandlers(DisplayEvent(DisplayEvent::WindowClose, id));
+    windowAllocator.Dealloc(id.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Resizes happen right away, since there is no window system to wait for
+*/
+void
+WindowResize(const WindowId id, SizeT newWidth, SizeT newHeight)
+{
+    if (newWidth == 0 || newHeight == 0)
+        return;
+
+    CoreGraphics::DisplayMode& mode = windowAllocator.Get<Window_DisplayMode>(id.id);
+    mode.SetWidth(newWidth);
+    mode.SetHeight(newHeight);
+    mode.SetAspectRatio(newWidth / float(newHeight));
+
+    CoreGraphics::SwapchainId& swapchain = windowAllocator.Get<Window_Swapchain>(id.id);
+    CoreGraphics::DestroySwapchain(swapchain);
+    CoreGraphics::SwapchainCreateInfo swapCreate;
+    swapCreate.displayMode = mode;
+    swapCreate.vsync = windowAllocator.Get<Window_SetupInfo>(id.id).vsync;
+    swapCreate.window = nullptr;
+    swapchain = CoreGraphics::CreateSwapchain(swapCreate);
+
+    DisplayDevice::Instance()->NotifyEventHandlers(DisplayEvent(DisplayEvent::WindowResized, id));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+WindowSetTitle(const WindowId id, const Util::String& title)
+{
+    windowAllocator.Get<Window_SetupInfo>(id.id).title = title;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+WindowApplyFullscreen(const WindowId id, Adapter::Code monitor, bool b)
+{
+    windowAllocator.Get<Window_SetupInfo>(id.id).fullscreen = b;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+WindowSetCursorVisible(const WindowId id, bool b)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+WindowSetCursorLocked(const WindowId id, bool b)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+WindowMakeCurrent(const WindowId id)
+{
+    CurrentWindow = id;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+WindowPresent(const WindowId id, const IndexT frameIndex)
+{
+    IndexT& frame = windowAllocator.Get<Window_SwapFrame>(id.id);
+    if (frame != frameIndex)
+    {
+        CoreGraphics::SwapchainPresent(windowAllocator.Get<Window_Swapchain>(id.id));
+        frame = frameIndex;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+WindowPollEvents()
+{
+    // empty, there is no event source
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+WindowNewFrame(const WindowId id)
+{
+    // empty, resizes are applied immediately
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CoreGraphics::DisplayMode
+WindowGetDisplayMode(const WindowId id)
+{
+    return windowAllocator.Get<Window_DisplayMode>(id.id);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CoreGraphics::AntiAliasQuality::Code
+WindowGetAAQuality(const WindowId id)
+{
+    return windowAllocator.Get<Window_SetupInfo>(id.id).aa;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const bool
+WindowIsFullscreen(const WindowId id)
+{
+    return windowAllocator.Get<Window_SetupInfo>(id.id).fullscreen;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const bool
+WindowIsDecorated(const WindowId id)
+{
+    return windowAllocator.Get<Window_SetupInfo>(id.id).decorated;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const bool
+WindowIsResizable(const WindowId id)
+{
+    return windowAllocator.Get<Window_SetupInfo>(id.id).resizable;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const Util::StringAtom&
+WindowGetTitle(const WindowId id)
+{
+    return windowAllocator.Get<Window_SetupInfo>(id.id).title;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const Util::StringAtom&
+WindowGetIcon(const WindowId id)
+{
+    return windowAllocator.Get<Window_SetupInfo>(id.id).icon;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Math::vec2
+WindowGetContentScale(const WindowId id)
+{
+    return Math::vec2(1.0f, 1.0f);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const CoreGraphics::SwapchainId
+WindowGetSwapchain(const WindowId id)
+{
+    return windowAllocator.Get<Window_Swapchain>(id.id);
+}
+
+} // namespace CoreGraphics
@@ -0,0 +1,32 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    Null window, a window without a surface which never receives any events
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "ids/idallocator.h"
+#include "coregraphics/window.h"
+#include "coregraphics/swapchain.h"
+namespace Null
+{
+
+enum
+{
+    Window_SetupInfo,
+    Window_DisplayMode,
+    Window_Swapchain,
+    Window_SwapFrame
+};
+
+typedef Ids::IdAllocator<
+    CoreGraphics::WindowCreateInfo,
+    CoreGraphics::DisplayMode,
+    CoreGraphics::SwapchainId,
+    IndexT
+> NullWindowAllocator;
+extern NullWindowAllocator windowAllocator;
+
+} // namespace Null
@@ -0,0 +1,363 @@
+//------------------------------------------------------------------------------
+//  nvx3quantization.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "render/stdneb.h"
+#include "nvx3quantization.h"
+
+namespace CoreGraphics
+{
+namespace Nvx3
+{
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline uint
+Align4(uint size)
+{
+    return (size + 3) & ~3;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline float
+SignNotZero(float f)
+{
+    return f >= 0.0f ? 1.0f : -1.0f;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline byte
+PackSnorm8(float f)
+{
+    return (byte)(int)Math::clamp(Math::round(f * 127.0f), -127.0f, 127.0f);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+AttributeVertexSize(CoreGraphics::VertexLayoutType layout)
+{
+    switch (layout)
+    {
+        case CoreGraphics::VertexLayoutType::Normal:
+            return sizeof(CoreGraphics::NormalVertex);
+        case CoreGraphics::VertexLayoutType::Colors:
+            return sizeof(CoreGraphics::ColorVertex);
+        case CoreGraphics::VertexLayoutType::SecondUV:
+            return sizeof(CoreGraphics::SecondUVVertex);
+        case CoreGraphics::VertexLayoutType::Skin:
+            return sizeof(CoreGraphics::SkinVertex);
+        default:
+            return 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Nvx3QuantizedStreams
+GetQuantizedStreams(CoreGraphics::VertexLayoutType layout, uint numVertices, uint flags)
+{
+    Nvx3QuantizedStreams streams;
+    uint offset = 0;
+
+    streams.positions = offset;
+    offset += Align4(numVertices * ((flags & Nvx3QuantizedPositions) ? 3 * sizeof(ushort) : 3 * sizeof(float)));
+    streams.uvs = offset;
+    offset += numVertices * 2 * sizeof(short);
+    streams.normals = offset;
+    if (flags & Nvx3QuantizedNormals)
+    {
+        offset += numVertices * 4;
+        streams.tangentSigns = offset;
+        offset += Align4((numVertices + 7) / 8);
+    }
+    else
+    {
+        offset += numVertices * 2 * sizeof(Math::byte4);
+        streams.tangentSigns = InvalidIndex;
+    }
+
+    streams.colors = InvalidIndex;
+    streams.secondaryUvs = InvalidIndex;
+    streams.skinWeights = InvalidIndex;
+    streams.skinIndices = InvalidIndex;
+    switch (layout)
+    {
+        case CoreGraphics::VertexLayoutType::Colors:
+            streams.colors = offset;
+            offset += numVertices * sizeof(Math::byte4u);
+            break;
+        case CoreGraphics::VertexLayoutType::SecondUV:
+            streams.secondaryUvs = offset;
+            offset += numVertices * 2 * sizeof(ushort);
+            break;
+        case CoreGraphics::VertexLayoutType::Skin:
+            streams.skinWeights = offset;
+            offset += numVertices * ((flags & Nvx3QuantizedSkinWeights) ? 4 : 4 * sizeof(float));
+            streams.skinIndices = offset;
+            offset += numVertices * sizeof(Math::byte4u);
+            break;
+        default:
+            break;
+    }
+    streams.size = offset;
+    return streams;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Projects onto the octahedron and folds the lower hemisphere over the
+    diagonals. Trying all four roundings of the projected coordinates halves
+    the worst case error compared to plain rounding.
+*/
+void
+EncodeOctahedral(float x, float y, float z, byte* out)
+{
+    const float l1 = Math::abs(x) + Math::abs(y) + Math::abs(z);
+    if (l1 == 0.0f)
+    {
+        out[0] = out[1] = 0;
+        return;
+    }
+    float u = x / l1;
+    float v = y / l1;
+    if (z < 0.0f)
+    {
+        const float fu = (1.0f - Math::abs(v)) * SignNotZero(u);
+        const float fv = (1.0f - Math::abs(u)) * SignNotZero(v);
+        u = fu;
+        v = fv;
+    }
+
+    float best = -2.0f;
+    for (int i = 0; i < 4; i++)
+    {
+        byte candidate[2];
+        candidate[0] = (byte)(int)Math::clamp((i & 1) ? Math::ceil(u * 127.0f) : Math::floor(u * 127.0f), -127.0f, 127.0f);
+        candidate[1] = (byte)(int)Math::clamp((i & 2) ? Math::ceil(v * 127.0f) : Math::floor(v * 127.0f), -127.0f, 127.0f);
+        float dx, dy, dz;
+        DecodeOctahedral(candidate, dx, dy, dz);
+        const float cosine = (dx * x + dy * y + dz * z) / l1;
+        if (cosine > best)
+        {
+            best = cosine;
+            out[0] = candidate[0];
+            out[1] = candidate[1];
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+DecodeOctahedral(const byte* in, float& x, float& y, float& z)
+{
+    // bytes hold snorm bits, as in the Byte4N vertex components
+    float u = Math::max((int8_t)in[0] / 127.0f, -1.0f);
+    float v = Math::max((int8_t)in[1] / 127.0f, -1.0f);
+    z = 1.0f - Math::abs(u) - Math::abs(v);
+    if (z < 0.0f)
+    {
+        const float fu = (1.0f - Math::abs(v)) * SignNotZero(u);
+        const float fv = (1.0f - Math::abs(u)) * SignNotZero(v);
+        u = fu;
+        v = fv;
+    }
+    x = u;
+    y = v;
+    const float len = Math::sqrt(x * x + y * y + z * z);
+    x /= len;
+    y /= len;
+    z /= len;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static SizeT
+DecodedVertexDataSize(const Nvx3Header* header)
+{
+    const Nvx3VertexRange* ranges = (const Nvx3VertexRange*)(header + 1);
+    const Nvx3Group* groups = (const Nvx3Group*)(ranges + header->numMeshes);
+    const Nvx3QuantizedRange* quantized = (const Nvx3QuantizedRange*)(groups + header->numGroups);
+    SizeT size = 0;
+    for (uint i = 0; i < header->numMeshes; i++)
+    {
+        const SizeT end = ranges[i].attributesVertexByteOffset + quantized[i].numVertices * AttributeVertexSize(ranges[i].layout);
+        size = Math::max(size, end);
+    }
+    return size;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+DecodedSize(const Nvx3Header* header)
+{
+    n_assert(header->magic == NEBULA_NVX_QUANTIZED_MAGICNUMBER);
+    return sizeof(Nvx3Header)
+        + header->numMeshes * sizeof(Nvx3VertexRange)
+        + header->numGroups * sizeof(Nvx3Group)
+        + DecodedVertexDataSize(header)
+        + header->indexDataSize
+        + header->numMeshlets * sizeof(Nvx3Meshlet);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+Decode(const Nvx3Header* header, void* out)
+{
+    n_assert(header->magic == NEBULA_NVX_QUANTIZED_MAGICNUMBER);
+    const Nvx3VertexRange* ranges = (const Nvx3VertexRange*)(header + 1);
+    const Nvx3Group* groups = (const Nvx3Group*)(ranges + header->numMeshes);
+    const Nvx3QuantizedRange* quantized = (const Nvx3QuantizedRange*)(groups + header->numGroups);
+    const ubyte* encoded = (const ubyte*)(quantized + header->numMeshes);
+    const ubyte* indexData = encoded + header->vertexDataSize;
+
+    // header, ranges and groups are the same, the vertex data grows to the GPU vertices
+    Nvx3Header* outHeader = (Nvx3Header*)out;
+    *outHeader = *header;
+    outHeader->magic = NEBULA_NVX_MAGICNUMBER;
+    outHeader->vertexDataSize = DecodedVertexDataSize(header);
+    Memory::Copy(ranges, outHeader + 1, header->numMeshes * sizeof(Nvx3VertexRange) + header->numGroups * sizeof(Nvx3Group));
+
+    Nvx3Elements elements;
+    FillNvx3Elements(outHeader, elements);
+    Memory::Copy(indexData, elements.indexData, header->indexDataSize + header->numMeshlets * sizeof(Nvx3Meshlet));
+
+    for (uint i = 0; i < header->numMeshes; i++)
+    {
+        const Nvx3QuantizedRange& range = quantized[i];
+        const CoreGraphics::VertexLayoutType layout = ranges[i].layout;
+        const Nvx3QuantizedStreams streams = GetQuantizedStreams(layout, range.numVertices, range.flags);
+        const ubyte* src = encoded + range.encodedByteOffset;
+        CoreGraphics::BaseVertex* base = (CoreGraphics::BaseVertex*)(elements.vertexData + ranges[i].baseVertexByteOffset);
+        ubyte* attributes = elements.vertexData + ranges[i].attributesVertexByteOffset;
+        const SizeT stride = AttributeVertexSize(layout);
+
+        const short* uvs = (const short*)(src + streams.uvs);
+        if (range.flags & Nvx3QuantizedPositions)
+        {
+            const ushort* positions = (const ushort*)(src + streams.positions);
+            for (uint v = 0; v < range.numVertices; v++)
+            {
+                for (int c = 0; c < 3; c++)
+                    base[v].position[c] = range.positionOffset[c] + range.positionScale[c] * positions[v * 3 + c];
+            }
+        }
+        else
+        {
+            const float* positions = (const float*)(src + streams.positions);
+            for (uint v = 0; v < range.numVertices; v++)
+                Memory::Copy(&positions[v * 3], base[v].position, 3 * sizeof(float));
+        }
+        for (uint v = 0; v < range.numVertices; v++)
+        {
+            base[v].uv[0] = uvs[v * 2 + 0];
+            base[v].uv[1] = uvs[v * 2 + 1];
+        }
+
+        if (range.flags & Nvx3QuantizedNormals)
+        {
+            const byte* normals = (const byte*)(src + streams.normals);
+            const ubyte* signs = src + streams.tangentSigns;
+            for (uint v = 0; v < range.numVertices; v++)
+            {
+                CoreGraphics::NormalVertex& vertex = *(CoreGraphics::NormalVertex*)(attributes + v * stride);
+                float x, y, z;
+                DecodeOctahedral(&normals[v * 4 + 0], x, y, z);
+                vertex.normal.x = PackSnorm8(x);
+                vertex.normal.y = PackSnorm8(y);
+                vertex.normal.z = PackSnorm8(z);
+                vertex.normal.w = 0;
+                DecodeOctahedral(&normals[v * 4 + 2], x, y, z);
+                vertex.tangent.x = PackSnorm8(x);
+                vertex.tangent.y = PackSnorm8(y);
+                vertex.tangent.z = PackSnorm8(z);
+                vertex.tangent.w = (signs[v / 8] & (1 << (v % 8))) ? 0x7F : 0x80;
+            }
+        }
+        else
+        {
+            const Math::byte4* normals = (const Math::byte4*)(src + streams.normals);
+            for (uint v = 0; v < range.numVertices; v++)
+            {
+                CoreGraphics::NormalVertex& vertex = *(CoreGraphics::NormalVertex*)(attributes + v * stride);
+                vertex.normal = normals[v * 2 + 0];
+                vertex.tangent = normals[v * 2 + 1];
+            }
+        }
+
+        switch (layout)
+        {
+            case CoreGraphics::VertexLayoutType::Colors:
+            {
+                const Math::byte4u* colors = (const Math::byte4u*)(src + streams.colors);
+                for (uint v = 0; v < range.numVertices; v++)
+                    ((CoreGraphics::ColorVertex*)(attributes + v * stride))->color = colors[v];
+                break;
+            }
+            case CoreGraphics::VertexLayoutType::SecondUV:
+            {
+                const ushort* uvs2 = (const ushort*)(src + streams.secondaryUvs);
+                for (uint v = 0; v < range.numVertices; v++)
+                {
+                    CoreGraphics::SecondUVVertex& vertex = *(CoreGraphics::SecondUVVertex*)(attributes + v * stride);
+                    vertex.uv2[0] = uvs2[v * 2 + 0];
+                    vertex.uv2[1] = uvs2[v * 2 + 1];
+                }
+                break;
+            }
+            case CoreGraphics::VertexLayoutType::Skin:
+            {
+                const Math::byte4u* indices = (const Math::byte4u*)(src + streams.skinIndices);
+                for (uint v = 0; v < range.numVertices; v++)
+                {
+                    CoreGraphics::SkinVertex& vertex = *(CoreGraphics::SkinVertex*)(attributes + v * stride);
+                    if (range.flags & Nvx3QuantizedSkinWeights)
+                    {
+                        const ubyte* weights = src + streams.skinWeights + v * 4;
+                        for (int c = 0; c < 4; c++)
+                            vertex.skinWeights[c] = weights[c] / 255.0f;
+                    }
+                    else
+                    {
+                        Memory::Copy(src + streams.skinWeights + v * 4 * sizeof(float), vertex.skinWeights, 4 * sizeof(float));
+                    }
+                    vertex.skinIndices = indices[v];
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void*
+DecodeQuantized(Nvx3Header*& header, Memory::HeapType heap)
+{
+    if (header->magic != NEBULA_NVX_QUANTIZED_MAGICNUMBER)
+        return nullptr;
+    void* decoded = Memory::Alloc(heap, DecodedSize(header));
+    Decode(header, decoded);
+    header = (Nvx3Header*)decoded;
+    return decoded;
+}
+
+} // namespace Nvx3
+} // namespace CoreGraphics
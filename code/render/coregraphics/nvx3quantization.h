@@ -0,0 +1,93 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file nvx3quantization.h
+
+    Quantized vertex storage for nvx3 files.
+
+    NVXQ files share the nvx3 layout, but have an Nvx3QuantizedRange per mesh
+    after the groups, and their vertex data holds encoded streams per mesh
+    instead of GPU vertices:
+
+        positions       ushort3 unorm within the mesh bounding box, or float3
+        uvs             short2, as in the GPU layout
+        normals         byte2 octahedral normal and tangent plus a bit array
+                        of tangent signs, or byte4 normal and tangent
+        colors          byte4, as in the GPU layout
+        secondary uvs   ushort2, as in the GPU layout
+        skin weights    ubyte4 unorm, or float4
+        skin indices    ubyte4, as in the GPU layout
+
+    The flags of a range tell which components were quantized, the toolkit
+    keeps components in the GPU format when quantizing them would exceed its
+    error bounds. Every stream starts 4 byte aligned.
+
+    Loaders decode NVXQ files into plain nvx3 images, so the GPU vertex
+    layouts, and everything reading vertex buffers, stay the same. The mesh
+    loader frees the decoded image as soon as it is uploaded.
+
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "coregraphics/nvx3fileformatstructs.h"
+
+#define NEBULA_NVX_QUANTIZED_MAGICNUMBER 'NVXQ'
+
+namespace CoreGraphics
+{
+
+enum Nvx3QuantizedFlags
+{
+    Nvx3QuantizedPositions = 1 << 0,
+    Nvx3QuantizedNormals = 1 << 1,
+    Nvx3QuantizedSkinWeights = 1 << 2
+};
+
+#pragma pack(push, 1)
+struct Nvx3QuantizedRange
+{
+    float positionOffset[3];    // position = offset + scale * unorm16
+    float positionScale[3];
+    uint numVertices;
+    uint encodedByteOffset;     // offset of the encoded streams of the mesh into the vertex data
+    uint flags;                 // Nvx3QuantizedFlags
+};
+#pragma pack(pop)
+
+/// byte offsets of the encoded streams of a mesh relative to its encodedByteOffset, InvalidIndex if the layout has no such stream
+struct Nvx3QuantizedStreams
+{
+    IndexT positions;
+    IndexT uvs;
+    IndexT normals;
+    IndexT tangentSigns;
+    IndexT colors;
+    IndexT secondaryUvs;
+    IndexT skinWeights;
+    IndexT skinIndices;
+    SizeT size;
+};
+
+namespace Nvx3
+{
+
+/// get the byte size of an attribute vertex of a layout
+SizeT AttributeVertexSize(CoreGraphics::VertexLayoutType layout);
+/// get the encoded streams of a mesh
+Nvx3QuantizedStreams GetQuantizedStreams(CoreGraphics::VertexLayoutType layout, uint numVertices, uint flags);
+
+/// encode a unit vector as two octahedral snorm bytes, picking the rounding with the smallest error
+void EncodeOctahedral(float x, float y, float z, byte* out);
+/// decode two octahedral snorm bytes to a unit vector
+void DecodeOctahedral(const byte* in, float& x, float& y, float& z);
+
+/// get the byte size of the plain nvx3 image a quantized file decodes to
+SizeT DecodedSize(const Nvx3Header* header);
+/// decode a quantized file into a plain nvx3 image of DecodedSize bytes
+void Decode(const Nvx3Header* header, void* out);
+/// decode a quantized file into a plain nvx3 image allocated from heap and point header at it, returns the image or nullptr for plain files
+void* DecodeQuantized(Nvx3Header*& header, Memory::HeapType heap);
+
+} // namespace Nvx3
+
+} // namespace CoreGraphics
+//------------------------------------------------------------------------------
@@ -11,6 +11,9 @@ namespace CoreGraphics
 #if __VULKAN__
 __ImplementClass(CoreGraphics::ShaderServer, 'SHSV', Vulkan::VkShaderServer);
 __ImplementSingleton(CoreGraphics::ShaderServer);
+#elif __NULL_GRAPHICS__
+__ImplementClass(CoreGraphics::ShaderServer, 'SHSV', Null::NullShaderServer);
+__ImplementSingleton(CoreGraphics::ShaderServer);
 #else
 #error "ShaderServer class not implemented on this platform!"
 #endif
@@ -25,6 +25,21 @@ public:
     virtual ~ShaderServer();
 };
 }
+#elif __NULL_GRAPHICS__
+#include "coregraphics/null/nullshaderserver.h"
+namespace CoreGraphics
+{
+class ShaderServer : public Null::NullShaderServer
+{
+    __DeclareClass(ShaderServer);
+    __DeclareSingleton(ShaderServer);
+public:
+    /// constructor
+    ShaderServer();
+    /// destructor
+    virtual ~ShaderServer();
+};
+}
 #else
 #error "ShaderServer class not implemented on this platform!"
 #endif
@@ -10,6 +10,8 @@ namespace CoreGraphics
 {
 #if __VULKAN__
 __ImplementClass(CoreGraphics::ShapeRenderer, 'SHPR', Vulkan::VkShapeRenderer);
+#elif __NULL_GRAPHICS__
+__ImplementClass(CoreGraphics::ShapeRenderer, 'SHPR', Base::ShapeRendererBase);
 #else
 #error "ShapeRenderer class not implemented on this platform!"
 #endif
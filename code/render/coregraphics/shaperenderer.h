@@ -24,6 +24,21 @@ public:
     virtual ~ShapeRenderer();
 };
 } // namespace CoreGraphics
+#elif __NULL_GRAPHICS__
+#include "coregraphics/base/shaperendererbase.h"
+namespace CoreGraphics
+{
+class ShapeRenderer : public Base::ShapeRendererBase
+{
+    __DeclareClass(ShapeRenderer);
+    __DeclareSingleton(ShapeRenderer);
+public:
+    /// constructor
+    ShapeRenderer();
+    /// destructor
+    virtual ~ShapeRenderer();
+};
+} // namespace CoreGraphics
 #else
 #error "ShapeRenderer class not implemented on this platform!"
 #endif
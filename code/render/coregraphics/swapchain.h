@@ -11,6 +11,8 @@
 #include "coregraphics/displaydevice.h"
 #include "ids/idallocator.h"
 
+struct GLFWwindow;
+
 namespace CoreGraphics
 {
 
@@ -10,6 +10,8 @@ namespace CoreGraphics
 {
 #if __VULKAN__
 __ImplementClass(CoreGraphics::TextRenderer, 'TXRR', Vulkan::VkTextRenderer);
+#elif __NULL_GRAPHICS__
+__ImplementClass(CoreGraphics::TextRenderer, 'TXRR', Base::TextRendererBase);
 #else
 #error "TextRenderer class not implemented on this platform!"
 #endif
@@ -25,6 +25,21 @@ public:
     virtual ~TextRenderer();
 };
 } // namespace CoreGraphics
+#elif __NULL_GRAPHICS__
+#include "coregraphics/base/textrendererbase.h"
+namespace CoreGraphics
+{
+class TextRenderer : public Base::TextRendererBase
+{
+    __DeclareClass(TextRenderer);
+    __DeclareSingleton(TextRenderer);
+public:
+    /// constructor
+    TextRenderer();
+    /// destructor
+    virtual ~TextRenderer();
+};
+} // namespace CoreGraphics
 #else
 #error "TextRenderer class not implemented on this platform!"
 #endif
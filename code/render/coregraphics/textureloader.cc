@@ -364,4 +364,28 @@ TextureLoader::LodMask(const Ids::Id32 entry, float lod, bool stream) const
     return (1 << numMipsRequested) - 1;
 }
 
+//------------------------------------------------------------------------------
+/**
+    The texture is created with its full mip chain, no matter how many mips
+    have been streamed in. The file stays mapped for streaming, but those pages
+    are backed by the file and can be dropped by the OS, so they aren't counted.
+*/
+uint64
+TextureLoader::MemoryUsage(const Resources::ResourceId id) const
+{
+    const TextureStreamData* streamData = static_cast<const TextureStreamData*>(this->streams[id.loaderInstanceId].data);
+    if (streamData == nullptr)
+        return 0;
+
+    uint64 bytes = 0;
+    for (IndexT layer = 0; layer < streamData->numLayers; layer++)
+    {
+        for (IndexT mip = 0; mip < streamData->numMips; mip++)
+        {
+            bytes += streamData->ctx.image_size(layer, mip);
+        }
+    }
+    return bytes;
+}
+
 } // namespace CoreGraphics
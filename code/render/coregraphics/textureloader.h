@@ -36,6 +36,8 @@ private:
 
     /// Create load mask based on LOD
     uint LodMask(const Ids::Id32 entry, float lod, bool stream) const override;
+    /// get the GPU memory of a texture
+    uint64 MemoryUsage(const Resources::ResourceId id) const override;
 };
 
 } // namespace CoreGraphics
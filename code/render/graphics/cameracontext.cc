@@ -38,6 +38,7 @@ CameraContext::Create()
     __CreateContext();
 
     __bundle.OnWindowResized = CameraContext::OnWindowResized;
+    __bundle.frameCalls.Append(CameraContext::UpdateCameras);
     Graphics::GraphicsServer::Instance()->RegisterGraphicsContext(&__bundle, &__state);
 }
 
@@ -8,6 +8,10 @@
 
     Use the __DeclareContext macro in the header and __ImplementContext in the implementation.
 
+    A context can list its pre and post logic callbacks in its function bundle, together
+    with the contexts it depends on. The graphics server runs the callbacks of contexts
+    which don't depend on each other in parallel, see GraphicsServer::RunPreLogic.
+
     @note
     The reason for why the function bundle and state are implemented through macros, is because
     they have to be static, and thus implemented explicitly once per each context.
@@ -23,6 +27,7 @@
 #include "ids/idgenerationpool.h"
 #include "util/stringatom.h"
 #include "util/arraystack.h"
+#include "threading/interlocked.h"
 #include "graphicsentity.h"
 #include "coregraphics/window.h"
 
@@ -35,6 +40,7 @@ public:\
     static void DeregisterEntity(const Graphics::GraphicsEntityId id);\
     static bool IsEntityRegistered(const Graphics::GraphicsEntityId id);\
     static void Destroy(); \
+    static const Graphics::GraphicsContextFunctionBundle* GetFunctionBundle(); \
     static Graphics::ContextEntityId GetContextId(const Graphics::GraphicsEntityId id); \
     static const Graphics::ContextEntityId& GetContextIdRef(const Graphics::GraphicsEntityId id); \
     static void BeginBulkRegister(); \
@@ -67,6 +73,10 @@ void ctx::Destroy()\
 {\
     Graphics::GraphicsServer::Instance()->UnregisterGraphicsContext(&__bundle);\
 }\
+const Graphics::GraphicsContextFunctionBundle* ctx::GetFunctionBundle()\
+{\
+    return &__bundle;\
+}\
 Graphics::ContextEntityId ctx::GetContextId(const Graphics::GraphicsEntityId id)\
 {\
     IndexT idx = __state.entitySliceMap.FindIndex(id); \
@@ -124,6 +134,19 @@ struct GraphicsContextFunctionBundle
     void(*OnRemoveEntity)(Graphics::GraphicsEntityId entity);
     void(*OnWindowResized)(const CoreGraphics::WindowId windowId, SizeT width, SizeT height);
 
+    // frame callbacks, lets the graphics server run the pre and post logic calls of this context as tasks
+    Util::StackArray<void(*)(const Graphics::FrameContext& ctx), 4> frameCalls;
+    Util::StackArray<void(*)(const Ptr<Graphics::View>& view, const Graphics::FrameContext& ctx), 4> viewCalls;
+
+    // frame callbacks which block until the jobs of the context are done, they are only run once the job counters are zero
+    Util::StackArray<void(*)(const Graphics::FrameContext& ctx), 2> waitCalls;
+
+    // contexts whose frame callbacks, and the jobs they dispatched, have to be done before the callbacks of this context run
+    Util::StackArray<const GraphicsContextFunctionBundle*, 4> dependencies;
+
+    // counters of the jobs dispatched by the frame callbacks
+    Util::StackArray<const Threading::AtomicCounter*, 2> jobCounters;
+
     GraphicsContextFunctionBundle() : OnRenderDebug(nullptr), OnStageCreated(nullptr), OnDiscardStage(nullptr), OnViewCreated(nullptr), OnDiscardView(nullptr), 
         OnAttachEntity(nullptr), OnRemoveEntity(nullptr), OnWindowResized(nullptr)
     {
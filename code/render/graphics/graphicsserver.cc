@@ -18,6 +18,7 @@
 #include "renderutil/drawfullscreenquad.h"
 #include "renderutil/geometryhelpers.h"
 #include "io/ioserver.h"
+#include "jobs2/jobs2.h"
 
 #include "bindlessregistry.h"
 #include "globalconstants.h"
@@ -28,10 +29,77 @@ namespace Graphics
 __ImplementClass(Graphics::GraphicsServer, 'GFXS', Core::RefCounted);
 __ImplementSingleton(Graphics::GraphicsServer);
 
+//------------------------------------------------------------------------------
+/**
+*/
+static const GraphicsContextFunctionBundle*
+FindFrameCallContext(const Util::Array<GraphicsContextFunctionBundle*>& contexts, ViewIndependentCall call, bool& waitsForJobs)
+{
+    IndexT i;
+    for (i = 0; i < contexts.Size(); i++)
+    {
+        if (contexts[i]->frameCalls.FindIndex(call) != InvalidIndex)
+        {
+            waitsForJobs = false;
+            return contexts[i];
+        }
+        if (contexts[i]->waitCalls.FindIndex(call) != InvalidIndex)
+        {
+            waitsForJobs = true;
+            return contexts[i];
+        }
+    }
+    waitsForJobs = false;
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static const GraphicsContextFunctionBundle*
+FindFrameCallContext(const Util::Array<GraphicsContextFunctionBundle*>& contexts, ViewDependentCall call, bool& waitsForJobs)
+{
+    waitsForJobs = false;
+    IndexT i;
+    for (i = 0; i < contexts.Size(); i++)
+    {
+        if (contexts[i]->viewCalls.FindIndex(call) != InvalidIndex)
+            return contexts[i];
+    }
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+/**
+    A task is done once its call has returned and the jobs its context
+    dispatched are done, which is what the tasks depending on it wait for.
+*/
+static void
+FinishFrameTask(const GraphicsContextFunctionBundle* context, Threading::AtomicCounter* done)
+{
+    if (context->jobCounters.IsEmpty())
+    {
+        Threading::Interlocked::Decrement(done);
+        return;
+    }
+
+    Util::FixedArray<const Threading::AtomicCounter*> waitCounters(context->jobCounters.Size());
+    IndexT i;
+    for (i = 0; i < context->jobCounters.Size(); i++)
+        waitCounters[i] = context->jobCounters[i];
+    Jobs2::JobDispatch([](SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocationOffset)
+    {
+        // empty, only decrements the done counter once the job counters are zero
+    }, 1, waitCounters, done);
+}
+
 //------------------------------------------------------------------------------
 /**
 */
 GraphicsServer::GraphicsServer() :
+    frameTasksDirty(true),
+    frameTaskGraphEnabled(true),
+    numPendingFrameTasks(0),
     isOpen(false)
 {
     __ConstructSingleton;
@@ -262,6 +330,7 @@ GraphicsServer::RegisterGraphicsContext(GraphicsContextFunctionBundle* context,
 {
     this->contexts.Append(context);
     this->states.Append(state);
+    this->frameTasksDirty = true;
 }
 
 //------------------------------------------------------------------------------
@@ -274,6 +343,7 @@ GraphicsServer::UnregisterGraphicsContext(GraphicsContextFunctionBundle* context
     n_assert(i != InvalidIndex);
     this->contexts.EraseIndex(i);
     this->states.EraseIndex(i);
+    this->frameTasksDirty = true;
 }
 
 //------------------------------------------------------------------------------
@@ -434,6 +504,132 @@ GraphicsServer::RenderDebug(uint32_t flags)
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+void
+GraphicsServer::SetupFrameTasks()
+{
+    this->SetupFrameTasks(this->preLogicCalls, this->preLogicTasks);
+    this->SetupFrameTasks(this->preLogicViewCalls, this->preLogicViewTasks);
+    this->SetupFrameTasks(this->postLogicCalls, this->postLogicTasks);
+    this->SetupFrameTasks(this->postLogicViewCalls, this->postLogicViewTasks);
+    this->frameTasksDirty = false;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Calls which no context claims split the list into segments. Within a
+    segment, a task waits for the earlier tasks of its own context and of the
+    contexts it depends on, the list order breaks cycles.
+*/
+template <typename CALL> void
+GraphicsServer::SetupFrameTasks(const Util::Array<CALL>& calls, Util::Array<FrameTask>& outTasks)
+{
+    outTasks.Clear();
+    IndexT segmentStart = 0;
+    IndexT i;
+    for (i = 0; i < calls.Size(); i++)
+    {
+        FrameTask task;
+        task.context = FindFrameCallContext(this->contexts, calls[i], task.waitsForJobs);
+        if (task.context == nullptr)
+        {
+            segmentStart = i + 1;
+        }
+        else
+        {
+            IndexT j;
+            for (j = segmentStart; j < i; j++)
+            {
+                const GraphicsContextFunctionBundle* other = outTasks[j].context;
+                if (other == task.context || task.context->dependencies.FindIndex(other) != InvalidIndex)
+                    task.dependencies.Append(j);
+            }
+        }
+        outTasks.Append(task);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Runs the tasks of every segment as jobs and waits until all of their calls
+    have returned, the jobs the calls dispatched keep running. Tasks which wait
+    for the jobs of their context are only started once the job counters of the
+    context are zero, so they never block a job thread.
+*/
+template <typename CALL, typename INVOKE> void
+GraphicsServer::RunFrameTasks(const Util::Array<CALL>& calls, const Util::Array<FrameTask>& tasks, const INVOKE& invoke)
+{
+    if (!this->frameTaskGraphEnabled)
+    {
+        IndexT i;
+        for (i = 0; i < calls.Size(); i++)
+            invoke(calls[i]);
+        return;
+    }
+
+    IndexT start = 0;
+    while (start < calls.Size())
+    {
+        IndexT end = start;
+        while (end < calls.Size() && tasks[end].context != nullptr)
+            end++;
+
+        const SizeT numTasks = end - start;
+        if (numTasks == 1)
+        {
+            invoke(calls[start]);
+        }
+        else if (numTasks > 1)
+        {
+            Threading::AtomicCounter* done = Jobs2::JobAlloc<Threading::AtomicCounter>(numTasks);
+            IndexT i;
+            for (i = 0; i < numTasks; i++)
+                done[i] = 1;
+            this->numPendingFrameTasks = numTasks;
+
+            for (i = start; i < end; i++)
+            {
+                const FrameTask& task = tasks[i];
+                const SizeT numJobCounters = task.waitsForJobs ? task.context->jobCounters.Size() : 0;
+                Util::FixedArray<const Threading::AtomicCounter*> waitCounters(task.dependencies.Size() + numJobCounters);
+                IndexT j;
+                for (j = 0; j < task.dependencies.Size(); j++)
+                    waitCounters[j] = &done[task.dependencies[j] - start];
+                for (j = 0; j < numJobCounters; j++)
+                    waitCounters[task.dependencies.Size() + j] = task.context->jobCounters[j];
+
+                Jobs2::JobDispatch(
+                    [
+                        call = calls[i]
+                        , invoke
+                        , context = task.context
+                        , taskDone = &done[i - start]
+                        , pending = &this->numPendingFrameTasks
+                        , returned = &this->frameTasksReturned
+                    ]
+                (SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocationOffset)
+                {
+                    invoke(call);
+                    FinishFrameTask(context, taskDone);
+                    if (Threading::Interlocked::Decrement(pending) == 0)
+                        returned->Signal();
+                }, 1, waitCounters);
+            }
+
+            N_MARKER_BEGIN(WaitForContexts, Graphics);
+            this->frameTasksReturned.Wait();
+            N_MARKER_END();
+        }
+
+        // run the call which no context claims on the main thread
+        if (end < calls.Size())
+            invoke(calls[end]);
+        start = end + 1;
+    }
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -469,11 +665,14 @@ GraphicsServer::RunPreLogic()
             state->Defragment();
     }
 
+    if (this->frameTasksDirty)
+        this->SetupFrameTasks();
+
     N_MARKER_BEGIN(ContextPreLogic, Graphics);
-    for (auto& call : this->preLogicCalls)
+    this->RunFrameTasks(this->preLogicCalls, this->preLogicTasks, [ctx = &this->frameContext](ViewIndependentCall call)
     {
-        call(this->frameContext);
-    }
+        call(*ctx);
+    });
     N_MARKER_END();
 
     // Go through views and call before view
@@ -488,10 +687,10 @@ GraphicsServer::RunPreLogic()
         this->currentView = view;
         view->UpdateConstants();
         N_MARKER_BEGIN(ContextPerView, Graphics);
-        for (auto& call : this->preLogicViewCalls)
+        this->RunFrameTasks(this->preLogicViewCalls, this->preLogicViewTasks, [view = &view, ctx = &this->frameContext](ViewDependentCall call)
         {
-            call(view, this->frameContext);
-        }
+            call(*view, *ctx);
+        });
         N_MARKER_END();
         this->currentView = nullptr;
     }
@@ -505,11 +704,14 @@ void GraphicsServer::RunPostLogic()
 {
     N_SCOPE(PostLogic, Graphics);
 
+    if (this->frameTasksDirty)
+        this->SetupFrameTasks();
+
     N_MARKER_BEGIN(ContextPostLogic, Graphics);
-    for (auto& call : this->postLogicCalls)
+    this->RunFrameTasks(this->postLogicCalls, this->postLogicTasks, [ctx = &this->frameContext](ViewIndependentCall call)
     {
-        call(this->frameContext);
-    }
+        call(*ctx);
+    });
     N_MARKER_END();
 
     // Go through views and call before view
@@ -522,10 +724,10 @@ void GraphicsServer::RunPostLogic()
 
         this->currentView = view;
         N_MARKER_BEGIN(ContextPerView, Graphics);
-        for (auto& call : this->postLogicViewCalls)
+        this->RunFrameTasks(this->postLogicViewCalls, this->postLogicViewTasks, [view = &view, ctx = &this->frameContext](ViewDependentCall call)
         {
-            call(view, this->frameContext);
-        }
+            call(*view, *ctx);
+        });
         N_MARKER_END();
         this->currentView = nullptr;
     }
@@ -6,6 +6,12 @@
     The graphics server is the main singleton for the Graphics subsystem.
 
     Updating the GraphicsServer will progress the rendering process by one frame. 
+
+    The pre and post logic calls are run as a task graph on the job system. A call
+    belongs to the context which lists it in its function bundle, and waits for the
+    earlier calls of the same context and of the contexts it depends on, everything
+    else runs in parallel. Calls which no context claims are run on the main thread
+    in between, after all calls before them have returned.
     
     @copyright
     (C) 2017-2020 Individual contributors, see AUTHORS file
@@ -25,6 +31,7 @@
 #include "coregraphics/textrenderer.h"
 #include "frame/frameserver.h"
 #include "debug/debughandler.h"
+#include "threading/event.h"
 
 namespace Graphics
 {
@@ -91,6 +98,8 @@ public:
     void SetupPreLogicViewCalls(const Util::Array<ViewDependentCall>& calls);
     /// Setup per-view calls
     void SetupPostLogicViewCalls(const Util::Array<ViewDependentCall>& calls);
+    /// run the pre and post logic calls as a task graph (default), or one after another on the main thread
+    void SetFrameTaskGraphEnabled(bool b);
 
     /// Run pre-logic calls
     void RunPreLogic();
@@ -125,6 +134,20 @@ public:
 private:
     friend class CoreGraphics::BatchGroup;
 
+    struct FrameTask
+    {
+        const GraphicsContextFunctionBundle* context;   // nullptr if the call has to run on the main thread
+        bool waitsForJobs;                              // true if the call blocks until the jobs of its context are done
+        Util::Array<IndexT> dependencies;               // earlier tasks in the same segment this task waits for
+    };
+
+    /// build the task graphs for the frame calls
+    void SetupFrameTasks();
+    /// build the task graph for a list of frame calls
+    template <typename CALL> void SetupFrameTasks(const Util::Array<CALL>& calls, Util::Array<FrameTask>& outTasks);
+    /// run a list of frame calls
+    template <typename CALL, typename INVOKE> void RunFrameTasks(const Util::Array<CALL>& calls, const Util::Array<FrameTask>& tasks, const INVOKE& invoke);
+
     Ids::IdGenerationPool entityPool;
 
     Ptr<FrameSync::FrameSyncTimer> timer;
@@ -148,6 +171,11 @@ private:
 
     Util::Array<ViewIndependentCall> preLogicCalls, postLogicCalls;
     Util::Array<ViewDependentCall> preLogicViewCalls, postLogicViewCalls;
+    Util::Array<FrameTask> preLogicTasks, postLogicTasks, preLogicViewTasks, postLogicViewTasks;
+    bool frameTasksDirty;
+    bool frameTaskGraphEnabled;
+    Threading::AtomicCounter numPendingFrameTasks;
+    Threading::Event frameTasksReturned;
 
     bool isOpen;
 };
@@ -206,6 +234,7 @@ inline void
 GraphicsServer::SetupPreLogicCalls(const Util::Array<ViewIndependentCall>& calls)
 {
     this->preLogicCalls = calls;
+    this->frameTasksDirty = true;
 }
 
 //------------------------------------------------------------------------------
@@ -215,6 +244,7 @@ inline void
 GraphicsServer::SetupPostLogicCalls(const Util::Array<ViewIndependentCall>& calls)
 {
     this->postLogicCalls = calls;
+    this->frameTasksDirty = true;
 }
 
 //------------------------------------------------------------------------------
@@ -224,6 +254,7 @@ inline void
 GraphicsServer::SetupPreLogicViewCalls(const Util::Array<ViewDependentCall>& calls)
 {
     this->preLogicViewCalls = calls;
+    this->frameTasksDirty = true;
 }
 
 //------------------------------------------------------------------------------
@@ -233,6 +264,16 @@ inline void
 GraphicsServer::SetupPostLogicViewCalls(const Util::Array<ViewDependentCall>& calls)
 {
     this->postLogicViewCalls = calls;
+    this->frameTasksDirty = true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+GraphicsServer::SetFrameTaskGraphEnabled(bool b)
+{
+    this->frameTaskGraphEnabled = b;
 }
 
 //------------------------------------------------------------------------------
@@ -142,6 +142,8 @@ LightContext::Create(const Ptr<Frame::FrameScript>& frameScript)
 #ifndef PUBLIC_BUILD
     __bundle.OnRenderDebug = LightContext::OnRenderDebug;
 #endif
+    __bundle.viewCalls.Append(LightContext::OnPrepareView);
+    __bundle.dependencies.Append(Graphics::CameraContext::GetFunctionBundle());
     Graphics::GraphicsServer::Instance()->RegisterGraphicsContext(&__bundle, &__state);
 
     textureState.fogTexture = frameScript->GetTexture("VolumetricFogBuffer0");
@@ -924,7 +926,7 @@ LightContext::OnPrepareView(const Ptr<Graphics::View>& view, const Graphics::Fra
 
 #if __DX12__
         Math::mat4 textureScale = Math::scaling(0.5f, -0.5f, 1.0f);
-#elif __VULKAN__
+#elif (__VULKAN__ || __NULL_GRAPHICS__)
         Math::mat4 textureScale = Math::scaling(0.5f, 0.5f, 1.0f);
 #endif
         Math::mat4 textureTranslation = Math::translation(0.5f, 0.5f, 0);
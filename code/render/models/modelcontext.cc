@@ -70,6 +70,12 @@ ModelContext::Create()
 #ifndef PUBLIC_BUILD
     __bundle.OnRenderDebug = ModelContext::OnRenderDebug;
 #endif
+
+    // transforms follow the camera, the constant update jobs have to finish before WaitForWork may run
+    __bundle.frameCalls.Append(ModelContext::UpdateTransforms);
+    __bundle.waitCalls.Append(ModelContext::WaitForWork);
+    __bundle.dependencies.Append(Graphics::CameraContext::GetFunctionBundle());
+    __bundle.jobCounters.Append(&ModelContext::ConstantsUpdateCounter);
     Graphics::GraphicsServer::Instance()->RegisterGraphicsContext(&__bundle, &__state);
 
     TransformInstanceAllocator = Memory::RangeAllocator(0x7FFF, 0x7FFF);
@@ -109,11 +115,36 @@ ModelContext::Setup(const Graphics::GraphicsEntityId gfxId, const Resources::Res
             }
             if (node->GetBits() & Models::NodeBits::HasTransformBit)
             {
-                nodeLookup.Add(node, transformNodes.Size());
                 transformNodes.Append(node);
             }
         }
 
+        // Sort transform nodes by hierarchy level, this way the update can run through the nodes linearly
+        Util::Array<Models::ModelNode*> levelNodes;
+        Util::Array<uint32> nodeLevels;
+        uint32 numLevels = 0;
+        for (SizeT i = 0; i < transformNodes.Size(); i++)
+        {
+            uint32 level = 0;
+            for (Models::ModelNode* parent = transformNodes[i]->parent; parent != nullptr; parent = parent->parent)
+                level++;
+            nodeLevels.Append(level);
+            numLevels = Math::max(numLevels, level + 1);
+        }
+        levelNodes.Reserve(transformNodes.Size());
+        for (uint32 level = 0; level < numLevels; level++)
+        {
+            for (SizeT i = 0; i < transformNodes.Size(); i++)
+            {
+                if (nodeLevels[i] == level)
+                {
+                    nodeLookup.Add(transformNodes[i], levelNodes.Size());
+                    levelNodes.Append(transformNodes[i]);
+                }
+            }
+        }
+        transformNodes = levelNodes;
+
         // Setup transforms
         transformRange.allocation = TransformInstanceAllocator.Alloc(transformNodes.Size());
         transformRange.begin = transformRange.allocation.offset;
@@ -123,6 +154,8 @@ ModelContext::Setup(const Graphics::GraphicsEntityId gfxId, const Resources::Res
             NodeInstances.transformable.nodeParents.Extend(transformRange.end);
             NodeInstances.transformable.origTransforms.Extend(transformRange.end);
             NodeInstances.transformable.nodeTransforms.Extend(transformRange.end);
+            NodeInstances.transformable.nodeDirty.Extend(transformRange.end);
+            NodeInstances.transformable.nodeUpdateFrames.Extend(transformRange.end);
         }
         
         for (SizeT i = 0; i < transformNodes.Size(); i++)
@@ -137,6 +170,8 @@ ModelContext::Setup(const Graphics::GraphicsEntityId gfxId, const Resources::Res
             trans.setscalepivot(tNode->scalePivot);
             NodeInstances.transformable.origTransforms[index] = trans.getmatrix();
             NodeInstances.transformable.nodeTransforms[index] = trans.getmatrix();
+            NodeInstances.transformable.nodeDirty[index] = true;
+            NodeInstances.transformable.nodeUpdateFrames[index] = InvalidIndex;
             if (tNode->parent != nullptr)
                 NodeInstances.transformable.nodeParents[index] = nodeLookup[tNode->parent];
             else
@@ -145,6 +180,7 @@ ModelContext::Setup(const Graphics::GraphicsEntityId gfxId, const Resources::Res
                 roots.Append(i);
             }
         }
+        modelContextAllocator.Set<Model_HierarchyDirty>(cid.id, true);
 
         // Setup node states
         stateRange.allocation = RenderInstanceAllocator.Alloc(renderNodes.Size());
@@ -281,7 +317,10 @@ ModelContext::Setup(
     NodeInstances.transformable.origTransforms.Append(Math::mat4());
     NodeInstances.transformable.nodeTransforms.Append(transform);
     NodeInstances.transformable.nodeParents.Append(UINT32_MAX);
+    NodeInstances.transformable.nodeDirty.Append(true);
+    NodeInstances.transformable.nodeUpdateFrames.Append(InvalidIndex);
     roots.Append(0);
+    modelContextAllocator.Set<Model_HierarchyDirty>(cid.id, true);
 
      // Setup node states
     stateRange.allocation = RenderInstanceAllocator.Alloc(1);
@@ -611,6 +650,8 @@ ModelContext::UpdateTransforms(const Graphics::FrameContext& ctx)
     Util::Array<Math::bbox>& instanceBoxes = NodeInstances.renderable.nodeBoundingBoxes;
     Util::Array<Math::mat4>& pending = modelContextAllocator.GetArray<Model_Transform>();
     Util::Array<bool>& hasPending = modelContextAllocator.GetArray<Model_Dirty>();
+    Util::Array<bool>& hierarchyDirty = modelContextAllocator.GetArray<Model_HierarchyDirty>();
+    const IndexT frameIndex = ctx.frameIndex;
 
     // get the lod camera
     Graphics::GraphicsEntityId lodCamera = Graphics::CameraContext::GetLODCamera();
@@ -625,10 +666,13 @@ ModelContext::UpdateTransforms(const Graphics::FrameContext& ctx)
             , nodeInstanceRoots = nodeInstanceRoots.ConstBegin()
             , pending = pending.Begin()
             , hasPending = hasPending.Begin()
+            , hierarchyDirty = hierarchyDirty.Begin()
+            , frameIndex
         ]
     (SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocationOffset)
     {
         N_SCOPE(ModelTransformUpdate, Graphics);
+        ModelInstance::Transformable& transformable = NodeInstances.transformable;
         for (IndexT i = 0; i < groupSize; i++)
         {
             IndexT index = i + invocationOffset;
@@ -637,6 +681,7 @@ ModelContext::UpdateTransforms(const Graphics::FrameContext& ctx)
 
             const NodeInstanceRange& transformRange = nodeInstanceTransformRanges[index];
             const Util::Array<uint32>& roots = nodeInstanceRoots[index];
+            SizeT j;
             if (hasPending[index])
             {
                 // The pending transform is the root of the model
@@ -644,19 +689,32 @@ ModelContext::UpdateTransforms(const Graphics::FrameContext& ctx)
                 hasPending[index] = false;
 
                 // Set root transform
-                SizeT j;
                 for (j = 0; j < roots.Size(); j++)
-                    NodeInstances.transformable.nodeTransforms[transformRange.begin + roots[j]] = transform;
-
-                // Update transforms
-                for (j = transformRange.begin + 1; j < transformRange.end; j++)
                 {
-                    uint32 parent = NodeInstances.transformable.nodeParents[j];
-                    n_assert(parent != UINT32_MAX);
-                    Math::mat4 parentTransform = NodeInstances.transformable.nodeTransforms[transformRange.begin + parent];
-                    Math::mat4 orig = NodeInstances.transformable.origTransforms[j];
-                    NodeInstances.transformable.nodeTransforms[j] = parentTransform * orig;
+                    transformable.nodeTransforms[transformRange.begin + roots[j]] = transform;
+                    transformable.nodeDirty[transformRange.begin + roots[j]] = true;
                 }
+                hierarchyDirty[index] = true;
+            }
+
+            // Models which haven't changed are skipped entirely
+            if (!hierarchyDirty[index])
+                continue;
+            hierarchyDirty[index] = false;
+
+            // Nodes are sorted by level, so the parent is final by the time its children are visited,
+            // which lets dirtiness propagate down the hierarchy in a single linear pass
+            for (j = transformRange.begin; j < transformRange.end; j++)
+            {
+                const uint32 parent = transformable.nodeParents[j];
+                const bool parentMoved = parent != UINT32_MAX && transformable.nodeUpdateFrames[transformRange.begin + parent] == frameIndex;
+                if (!transformable.nodeDirty[j] && !parentMoved)
+                    continue;
+
+                if (parent != UINT32_MAX)
+                    transformable.nodeTransforms[j] = transformable.nodeTransforms[transformRange.begin + parent] * transformable.origTransforms[j];
+                transformable.nodeDirty[j] = false;
+                transformable.nodeUpdateFrames[j] = frameIndex;
             }
         }
     }, nodeInstanceTransformRanges.Size(), 256, nullptr, &TransformsUpdateCounter, nullptr);
@@ -671,6 +729,7 @@ ModelContext::UpdateTransforms(const Graphics::FrameContext& ctx)
             , nodeInstanceStateRanges = nodeInstanceStateRanges.ConstBegin()
             , instanceBoxes = instanceBoxes.Begin()
             , cameraTransform
+            , frameIndex
         ]
     (SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocationOffset)
     {
@@ -686,10 +745,22 @@ ModelContext::UpdateTransforms(const Graphics::FrameContext& ctx)
             SizeT j;
             for (j = stateRange.begin; j < stateRange.end; j++)
             {
-                Math::mat4 transform = NodeInstances.transformable.nodeTransforms[transformRange.begin + NodeInstances.renderable.nodeTransformIndex[j]];
-                Math::bbox box = NodeInstances.renderable.origBoundingBoxes[j];
-                box.affine_transform(transform);
-                instanceBoxes[j] = box;
+                const IndexT transformIndex = transformRange.begin + NodeInstances.renderable.nodeTransformIndex[j];
+                const Math::mat4& transform = NodeInstances.transformable.nodeTransforms[transformIndex];
+
+                // Only nodes which moved this frame need their bounding box transformed
+                const bool moved = NodeInstances.transformable.nodeUpdateFrames[transformIndex] == frameIndex;
+
+                // Particle nodes get their box from the emitter while it has living particles,
+                // once it goes idle fall back to the node box so the last emitter box doesn't drive culling
+                const bool idleParticles = NodeInstances.renderable.nodes[j]->GetType() == Models::ParticleSystemNodeType
+                    && !AllBits(NodeInstances.renderable.nodeFlags[j], Models::NodeInstanceFlags::NodeInstance_Active);
+                if (moved || idleParticles)
+                {
+                    Math::bbox box = NodeInstances.renderable.origBoundingBoxes[j];
+                    box.affine_transform(transform);
+                    instanceBoxes[j] = box;
+                }
 
                 Models::PrimitiveNode* primitiveNode = static_cast<Models::PrimitiveNode*>(NodeInstances.renderable.nodes[j]);
                 NodeInstances.renderable.nodeMeshes[j] = primitiveNode->GetMesh();
@@ -708,6 +779,17 @@ ModelContext::UpdateTransforms(const Graphics::FrameContext& ctx)
                 }
 
                 Models::NodeInstanceFlags nodeFlag = NodeInstances.renderable.nodeFlags[j];
+                if (moved)
+                    nodeFlag = SetBits(nodeFlag, Models::NodeInstanceFlags::NodeInstance_Moved);
+                else
+                    nodeFlag = UnsetBits(nodeFlag, Models::NodeInstanceFlags::NodeInstance_Moved);
+
+                // Visibility sets the visible flag every frame it sees the node, keep the previous result around
+                if (AllBits(nodeFlag, Models::NodeInstanceFlags::NodeInstance_Visible))
+                    nodeFlag = SetBits(nodeFlag, Models::NodeInstanceFlags::NodeInstance_WasVisible);
+                else
+                    nodeFlag = UnsetBits(nodeFlag, Models::NodeInstanceFlags::NodeInstance_WasVisible);
+                nodeFlag = UnsetBits(nodeFlag, Models::NodeInstanceFlags::NodeInstance_Visible);
 
                 // Calculate if object should be culled due to LOD
                 const auto& [min, max] = NodeInstances.renderable.nodeLodDistances[j];
@@ -50,7 +50,8 @@ enum class NodeInstanceFlags
     , NodeInstance_LodActive = N_BIT(2)         // If set, the node's LOD is active
     , NodeInstance_AlwaysVisible = N_BIT(3)     // Should always resolve to being visible by visibility
     , NodeInstance_Visible = N_BIT(4)           // Set to true if any observer sees it
-    , NodeInstance_Moved = N_BIT(5)
+    , NodeInstance_Moved = N_BIT(5)              // Set if the node transform changed this frame
+    , NodeInstance_WasVisible = N_BIT(6)         // Set if any observer saw the node in the previous frame
 };
 __ImplementEnumBitOperators(NodeInstanceFlags);
 
@@ -137,12 +138,15 @@ public:
 
     struct ModelInstance
     {
-        /// Transforms are only used by the model context to traverse and propagate the transform hierarchy
+        /// Transforms are only used by the model context to traverse and propagate the transform hierarchy.
+        /// The nodes of a model are sorted by hierarchy level, so a parent always precedes its children.
         struct Transformable
         {
             Util::PinnedArray<0xFFFF, Math::mat4> origTransforms;
             Util::PinnedArray<0xFFFF, Math::mat4> nodeTransforms;
             Util::PinnedArray<0xFFFF, uint32> nodeParents;
+            Util::PinnedArray<0xFFFF, bool> nodeDirty;              // node transform changed and has to be propagated
+            Util::PinnedArray<0xFFFF, IndexT> nodeUpdateFrames;     // frame index the world transform was last computed
         } transformable;
 
         /// The bounding boxes are used by visibility and the states by rendering
@@ -214,7 +218,8 @@ private:
         Model_NodeInstanceStates,
         Model_NodeLookup,
         Model_Transform,
-        Model_Dirty
+        Model_Dirty,
+        Model_HierarchyDirty
     };
     typedef Ids::IdAllocator<
         Resources::ResourceId,
@@ -223,7 +228,8 @@ private:
         NodeInstanceRange,
         Util::Dictionary<Util::StringAtom, IndexT>,
         Math::mat4,         // pending transforms
-        bool                // transform is dirty
+        bool,               // transform is dirty
+        bool                // any node in the hierarchy is dirty
     > ModelContextAllocator;
     static ModelContextAllocator modelContextAllocator;
 
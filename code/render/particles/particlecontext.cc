@@ -80,6 +80,13 @@ ParticleContext::Create()
     __bundle.OnRenderDebug = ParticleContext::OnRenderDebug;
 #endif
 
+    // emitters are placed by the model transforms and sorted against the camera
+    __bundle.frameCalls.Append(ParticleContext::UpdateParticles);
+    __bundle.viewCalls.Append(ParticleContext::OnPrepareView);
+    __bundle.waitCalls.Append(ParticleContext::WaitForParticleUpdates);
+    __bundle.dependencies.Append(Models::ModelContext::GetFunctionBundle());
+    __bundle.dependencies.Append(Graphics::CameraContext::GetFunctionBundle());
+    __bundle.jobCounters.Append(&ParticleContext::ConstantUpdateCounter);
     Graphics::GraphicsServer::Instance()->RegisterGraphicsContext(&__bundle, &__state);
 
     struct VectorB4N
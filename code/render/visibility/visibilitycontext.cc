@@ -39,6 +39,7 @@ ObservableContext::ObservableAllocator ObservableContext::observableAllocator;
 Util::Array<VisibilitySystem*> ObserverContext::systems;
 
 static Util::Queue<Threading::Event*> waitEvents;
+static Threading::AtomicCounter drawListCompletionCounter = 0;
 
 __ImplementContext(ObserverContext, ObserverContext::observerAllocator);
 
@@ -187,8 +188,8 @@ ObserverContext::RunVisibilityTests(const Graphics::FrameContext& ctx)
         }
     }
 
-    static Threading::AtomicCounter completionCounter;
-    completionCounter = observerResults.Size();
+    // the counter is also what the frame task graph waits on, so it must not be left pending when no jobs are dispatched
+    drawListCompletionCounter = NodeInstances.nodeStates.Size() > 0 ? observerResults.Size() : 0;
     Threading::Event* finishedEvent = nullptr;
 
     if (NodeInstances.nodeStates.Size() > 0)
@@ -367,7 +368,7 @@ ObserverContext::RunVisibilityTests(const Graphics::FrameContext& ctx)
                 cmd->numDrawPackets++;
                 numDraws++;
             }
-        }, nodes.Size(), waitCounters, &completionCounter, finishedEvent);
+        }, nodes.Size(), waitCounters, &drawListCompletionCounter, finishedEvent);
     }
 
     if (finishedEvent != nullptr)
@@ -394,6 +395,15 @@ ObserverContext::Create()
     __bundle.OnRenderDebug = ObserverContext::OnRenderDebug;
 #endif 
 
+    // visibility culls what the models, characters and particles have placed this frame
+    __bundle.frameCalls.Append(ObserverContext::RunVisibilityTests);
+    __bundle.frameCalls.Append(ObserverContext::GenerateDrawLists);
+    __bundle.waitCalls.Append(ObserverContext::WaitForVisibility);
+    __bundle.dependencies.Append(Graphics::CameraContext::GetFunctionBundle());
+    __bundle.dependencies.Append(Models::ModelContext::GetFunctionBundle());
+    __bundle.dependencies.Append(Characters::CharacterContext::GetFunctionBundle());
+    __bundle.dependencies.Append(Particles::ParticleContext::GetFunctionBundle());
+    __bundle.jobCounters.Append(&drawListCompletionCounter);
     Graphics::GraphicsServer::Instance()->RegisterGraphicsContext(&__bundle, &__state);
     __CreateContext();
 }
@@ -0,0 +1,445 @@
+//------------------------------------------------------------------------------
+// resourceioscheduler.cc
+// (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "foundation/stdneb.h"
+#include "resourceioscheduler.h"
+#include "resourceloaderthread.h"
+#include "profiling/profiling.h"
+#include "util/bit.h"
+
+N_DECLARE_COUNTER(N_RESOURCE_IO_QUEUE_DEPTH, Resource IO Queue Depth);
+N_DECLARE_COUNTER(N_RESOURCE_DECODE_QUEUE_DEPTH, Resource Decode Queue Depth);
+N_DECLARE_COUNTER(N_RESOURCE_IO_BYTES_PER_SECOND, Resource IO Bytes per Second);
+N_DECLARE_COUNTER(N_RESOURCE_IO_LATENCY, Resource IO Latency (us));
+
+namespace Resources
+{
+
+__ImplementClass(Resources::ResourceIoScheduler, 'RIOS', Core::RefCounted);
+
+//------------------------------------------------------------------------------
+/**
+*/
+ResourceIoScheduler::ResourceIoScheduler() :
+    sequence(0),
+    outstanding(0),
+    windowStart(0),
+    windowBytes(0),
+    windowRequests(0),
+    windowLatency(0),
+    bytesPerSecond(0),
+    latencyMicroSeconds(0),
+    idleEvent(true)
+{
+    this->idleEvent.Signal();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+ResourceIoScheduler::~ResourceIoScheduler()
+{
+    n_assert(this->workers[IoStage].IsEmpty());
+    n_assert(this->workers[DecodeStage].IsEmpty());
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceIoScheduler::Setup(SizeT numIoThreads, SizeT numDecodeThreads)
+{
+    n_assert(numIoThreads > 0 && numDecodeThreads > 0);
+    this->timer.Start();
+
+    SizeT numThreads[NumStages] = { numIoThreads, numDecodeThreads };
+    const char* names[NumStages] = { "Resource IO Thread", "Resource Decode Thread" };
+    for (IndexT stage = 0; stage < NumStages; stage++)
+    {
+        for (IndexT i = 0; i < numThreads[stage]; i++)
+        {
+            Ptr<ResourceLoaderThread> thread = ResourceLoaderThread::Create();
+            thread->scheduler = this;
+            thread->stage = (Stage)stage;
+            thread->SetName(Util::String::Sprintf("%s #%d", names[stage], i));
+            thread->Start();
+            this->workers[stage].Append(thread);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceIoScheduler::Discard()
+{
+    // drop everything which hasn't started yet, and let in-flight requests finish
+    this->lock.Enter();
+    for (IndexT stage = 0; stage < NumStages; stage++)
+    {
+        this->AddOutstanding(-this->queues[stage].Size());
+        this->queues[stage].Clear();
+    }
+    this->lock.Leave();
+    this->Wait();
+
+    for (IndexT stage = 0; stage < NumStages; stage++)
+    {
+        for (IndexT i = 0; i < this->workers[stage].Size(); i++)
+        {
+            this->workers[stage][i]->Stop();
+        }
+        this->workers[stage].Clear();
+    }
+    this->timer.Stop();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceIoScheduler::Enqueue(ResourceLoader* loader, const ResourceLoader::_PendingResourceLoad& load)
+{
+    _Request request;
+    request.loader = loader;
+    request.load = load;
+    request.priority = load.lod;
+    request.enqueueTime = this->timer.GetTime();
+    request.bytes = 0;
+
+    // only requests which create the resource need a stream, the rest can decode right away
+    Stage stage = AllBits(load.mode, ResourceLoader::_PendingResourceLoad::Create) ? IoStage : DecodeStage;
+    const uint64 key = Key(loader, load.entry);
+
+    this->lock.Enter();
+    request.sequence = this->sequence++;
+    this->Insert(stage, key, request);
+    this->lock.Leave();
+
+    this->WakeWorkers(stage);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+ResourceIoScheduler::Cancel(ResourceLoader* loader, const Ids::Id32 entry)
+{
+    const uint64 key = Key(loader, entry);
+    bool createCancelled = false;
+
+    this->lock.Enter();
+    for (IndexT stage = 0; stage < NumStages; stage++)
+    {
+        IndexT i = this->queues[stage].FindIndex(key);
+        if (i != InvalidIndex)
+        {
+            const ResourceLoader::_PendingResourceLoad& load = this->queues[stage].ValueAtIndex(i).load;
+            if (AllBits(load.mode, ResourceLoader::_PendingResourceLoad::Create) && !load.reload)
+                createCancelled = true;
+
+            this->queues[stage].EraseAtIndex(i);
+            this->AddOutstanding(-1);
+            if (stage == IoStage)
+            {
+                N_COUNTER_DECR(N_RESOURCE_IO_QUEUE_DEPTH, 1);
+            }
+            else
+            {
+                N_COUNTER_DECR(N_RESOURCE_DECODE_QUEUE_DEPTH, 1);
+            }
+        }
+    }
+    this->lock.Leave();
+    return createCancelled;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+ResourceIoScheduler::IsBusy(ResourceLoader* loader, const Ids::Id32 entry)
+{
+    const uint64 key = Key(loader, entry);
+    this->lock.Enter();
+    bool busy = this->inflight.Contains(key);
+    for (IndexT stage = 0; stage < NumStages && !busy; stage++)
+    {
+        busy = this->queues[stage].Contains(key);
+    }
+    this->lock.Leave();
+    return busy;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceIoScheduler::CancelAll(ResourceLoader* loader)
+{
+    this->lock.Enter();
+    for (IndexT stage = 0; stage < NumStages; stage++)
+    {
+        Util::Dictionary<uint64, _Request>& queue = this->queues[stage];
+        for (IndexT i = queue.Size() - 1; i >= 0; i--)
+        {
+            if (queue.ValueAtIndex(i).loader == loader)
+            {
+                queue.EraseAtIndex(i);
+                this->AddOutstanding(-1);
+                if (stage == IoStage)
+                {
+                    N_COUNTER_DECR(N_RESOURCE_IO_QUEUE_DEPTH, 1);
+                }
+                else
+                {
+                    N_COUNTER_DECR(N_RESOURCE_DECODE_QUEUE_DEPTH, 1);
+                }
+            }
+        }
+    }
+    this->lock.Leave();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceIoScheduler::Wait()
+{
+    this->idleEvent.Wait();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+ResourceIoScheduler::GetNumPending() const
+{
+    this->lock.Enter();
+    const SizeT numPending = this->outstanding;
+    this->lock.Leave();
+    return numPending;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+ResourceIoScheduler::RunNext(Stage stage)
+{
+    this->lock.Enter();
+    IndexT next = this->FindNext(stage);
+    if (next == InvalidIndex)
+    {
+        this->lock.Leave();
+        return false;
+    }
+
+    // take request out of the queue and mark the resource (and loader when decoding) as busy
+    const uint64 key = this->queues[stage].KeyAtIndex(next);
+    _Request request = this->queues[stage].ValueAtIndex(next);
+    this->queues[stage].EraseAtIndex(next);
+    this->inflight.Add(key);
+    if (stage == DecodeStage)
+    {
+        this->busyLoaders.Add(request.loader->GetUniqueId());
+        N_COUNTER_DECR(N_RESOURCE_DECODE_QUEUE_DEPTH, 1);
+    }
+    else
+    {
+        N_COUNTER_DECR(N_RESOURCE_IO_QUEUE_DEPTH, 1);
+    }
+    this->lock.Leave();
+
+    if (stage == IoStage)
+    {
+        N_SCOPE_DYN(request.loader->streamerThreadName.Value(), ResourceIO);
+
+        // open stream, if it fails the decode stage reports the resource as failed
+        request.stream = _OpenStream(request.loader, request.load);
+        if (request.stream.isvalid())
+            request.bytes = request.stream->GetSize();
+
+        this->lock.Enter();
+        this->inflight.Erase(key);
+        this->Insert(DecodeStage, key, request);
+
+        // two requests may have been merged into one
+        this->AddOutstanding(-1);
+        this->lock.Leave();
+        this->WakeWorkers(DecodeStage);
+    }
+    else
+    {
+        N_SCOPE_DYN(request.loader->streamerThreadName.Value(), ResourceDecode);
+        _LoadInternal(request.loader, request.load, request.stream);
+        request.stream = nullptr;
+
+        this->lock.Enter();
+        this->inflight.Erase(key);
+        this->busyLoaders.Erase(request.loader->GetUniqueId());
+        this->UpdateStats(request);
+        this->AddOutstanding(-1);
+        this->lock.Leave();
+
+        // finishing may unblock requests in both stages
+        this->WakeWorkers(IoStage);
+        this->WakeWorkers(DecodeStage);
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+    A request may not run if the same resource is already in flight, if a request
+    for the resource is waiting to decode before it, or if the loader is already decoding.
+*/
+IndexT
+ResourceIoScheduler::FindNext(Stage stage) const
+{
+    const Util::Dictionary<uint64, _Request>& queue = this->queues[stage];
+    IndexT best = InvalidIndex;
+    for (IndexT i = 0; i < queue.Size(); i++)
+    {
+        const uint64 key = queue.KeyAtIndex(i);
+        const _Request& request = queue.ValueAtIndex(i);
+        if (this->inflight.Contains(key))
+            continue;
+        if (stage == IoStage && this->queues[DecodeStage].Contains(key))
+            continue;
+        if (stage == DecodeStage && this->busyLoaders.Contains(request.loader->GetUniqueId()))
+            continue;
+
+        if (best == InvalidIndex)
+            best = i;
+        else
+        {
+            const _Request& bestRequest = queue.ValueAtIndex(best);
+            if (request.priority < bestRequest.priority
+                || (request.priority == bestRequest.priority && request.sequence < bestRequest.sequence))
+                best = i;
+        }
+    }
+    return best;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Requests which create the resource absorb any queued request which only streams
+    it, since creation streams the merged LOD as well. A request which only streams
+    is merged into any queued request for the same resource.
+*/
+void
+ResourceIoScheduler::Insert(Stage stage, uint64 key, const _Request& request)
+{
+    const bool create = AllBits(request.load.mode, ResourceLoader::_PendingResourceLoad::Create);
+    IndexT decodeIndex = this->queues[DecodeStage].FindIndex(key);
+    IndexT ioIndex = this->queues[IoStage].FindIndex(key);
+
+    _Request* target = nullptr;
+    if (stage == DecodeStage && decodeIndex != InvalidIndex)
+    {
+        _Request& queued = this->queues[DecodeStage].ValueAtIndex(decodeIndex);
+        if (create)
+        {
+            // replace the queued streaming request with the creation, but keep what it requested
+            _Request merged = request;
+            merged.load.mode |= queued.load.mode;
+            merged.load.lod = Math::min(merged.load.lod, queued.load.lod);
+            merged.priority = Math::min(merged.priority, queued.priority);
+            merged.sequence = Math::min(merged.sequence, queued.sequence);
+            queued = merged;
+            return;
+        }
+        target = &queued;
+    }
+    else if (!create && decodeIndex != InvalidIndex)
+        target = &this->queues[DecodeStage].ValueAtIndex(decodeIndex);
+    else if (ioIndex != InvalidIndex && (stage == IoStage || !create))
+        target = &this->queues[IoStage].ValueAtIndex(ioIndex);
+
+    if (target != nullptr)
+    {
+        target->load.mode |= request.load.mode;
+        target->load.lod = Math::min(target->load.lod, request.load.lod);
+        target->load.frame = Math::max(target->load.frame, request.load.frame);
+        target->load.immediate = target->load.immediate || request.load.immediate;
+        target->priority = Math::min(target->priority, request.priority);
+        return;
+    }
+
+    this->queues[stage].Add(key, request);
+    this->AddOutstanding(1);
+    if (stage == IoStage)
+    {
+        N_COUNTER_INCR(N_RESOURCE_IO_QUEUE_DEPTH, 1);
+    }
+    else
+    {
+        N_COUNTER_INCR(N_RESOURCE_DECODE_QUEUE_DEPTH, 1);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceIoScheduler::UpdateStats(const _Request& request)
+{
+    const Timing::Time now = this->timer.GetTime();
+    this->windowBytes += request.bytes;
+    this->windowRequests++;
+    this->windowLatency += now - request.enqueueTime;
+
+    // publish throughput and average latency once per second
+    if (now - this->windowStart >= 1.0)
+    {
+        uint64 bytesPerSecond = uint64(this->windowBytes / (now - this->windowStart));
+        uint64 latency = uint64(this->windowLatency / this->windowRequests * 1000000.0);
+        N_COUNTER_DECR(N_RESOURCE_IO_BYTES_PER_SECOND, this->bytesPerSecond);
+        N_COUNTER_INCR(N_RESOURCE_IO_BYTES_PER_SECOND, bytesPerSecond);
+        N_COUNTER_DECR(N_RESOURCE_IO_LATENCY, this->latencyMicroSeconds);
+        N_COUNTER_INCR(N_RESOURCE_IO_LATENCY, latency);
+        this->bytesPerSecond = bytesPerSecond;
+        this->latencyMicroSeconds = latency;
+
+        this->windowStart = now;
+        this->windowBytes = 0;
+        this->windowRequests = 0;
+        this->windowLatency = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceIoScheduler::WakeWorkers(Stage stage)
+{
+    for (IndexT i = 0; i < this->workers[stage].Size(); i++)
+    {
+        this->workers[stage][i]->wakeupEvent.Signal();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceIoScheduler::AddOutstanding(SizeT count)
+{
+    if (count == 0)
+        return;
+
+    if (this->outstanding == 0)
+        this->idleEvent.Reset();
+    this->outstanding += count;
+    n_assert(this->outstanding >= 0);
+    if (this->outstanding == 0)
+        this->idleEvent.Signal();
+}
+
+} // namespace Resources
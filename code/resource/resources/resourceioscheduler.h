@@ -0,0 +1,129 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    The resource I/O scheduler is shared by all ResourceLoaders which load asynchronously.
+
+    Every request passes through two stages. The I/O stage opens the resource stream
+    and runs on a pool of I/O threads. The decode stage initializes and streams the
+    resource on a pool of decode threads. Decoding is serialized per loader, so loaders
+    need not be thread safe internally, but different loaders decode concurrently, which
+    means a large texture no longer blocks small meshes behind it.
+
+    Requests are picked by priority (lower is more urgent), which is the LOD requested
+    through CreateResource or SetMinLod. Requests for a resource which are queued but not
+    yet in flight are merged, such that a new LOD request reorders the queue instead of
+    adding to it, and can be cancelled when the resource is discarded. Requests which only
+    stream more data of an already created resource skip the I/O stage.
+
+    @copyright
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+//------------------------------------------------------------------------------
+#include "core/refcounted.h"
+#include "threading/criticalsection.h"
+#include "threading/event.h"
+#include "timing/timer.h"
+#include "util/dictionary.h"
+#include "util/set.h"
+#include "resourceloader.h"
+
+namespace Resources
+{
+
+class ResourceLoaderThread;
+class ResourceIoScheduler : public Core::RefCounted
+{
+    __DeclareClass(ResourceIoScheduler);
+public:
+
+    enum Stage
+    {
+        IoStage,
+        DecodeStage,
+
+        NumStages
+    };
+
+    /// constructor
+    ResourceIoScheduler();
+    /// destructor
+    virtual ~ResourceIoScheduler();
+
+    /// setup scheduler and start worker threads
+    void Setup(SizeT numIoThreads, SizeT numDecodeThreads);
+    /// cancel queued requests, wait for in-flight requests and stop worker threads
+    void Discard();
+
+    /// enqueue a load, merges with a queued request for the same resource if there is one
+    void Enqueue(ResourceLoader* loader, const ResourceLoader::_PendingResourceLoad& load);
+    /// cancel queued requests for a resource, returns true if the creation of the resource was cancelled before it started
+    bool Cancel(ResourceLoader* loader, const Ids::Id32 entry);
+    /// cancel all queued requests issued by a loader
+    void CancelAll(ResourceLoader* loader);
+    /// returns true if a request for a resource is queued or in flight
+    bool IsBusy(ResourceLoader* loader, const Ids::Id32 entry);
+    /// wait for all queued and in-flight requests to finish (must be called from outside the worker threads!)
+    void Wait();
+
+    /// get number of queued and in-flight requests
+    SizeT GetNumPending() const;
+
+private:
+    friend class ResourceLoaderThread;
+
+    struct _Request
+    {
+        ResourceLoader* loader;
+        ResourceLoader::_PendingResourceLoad load;
+        Ptr<IO::Stream> stream;
+        float priority;
+        uint64 sequence;
+        Timing::Time enqueueTime;
+        IO::Stream::Size bytes;
+    };
+
+    /// run the most urgent request for a stage, returns false if there was nothing to run
+    bool RunNext(Stage stage);
+    /// find the most urgent request which may run, must be called within the lock
+    IndexT FindNext(Stage stage) const;
+    /// add request to queue, or merge with a queued one, must be called within the lock
+    void Insert(Stage stage, uint64 key, const _Request& request);
+    /// update profiling counters with a finished request, must be called within the lock
+    void UpdateStats(const _Request& request);
+    /// wake all worker threads of a stage
+    void WakeWorkers(Stage stage);
+    /// increase or decrease the number of outstanding requests, must be called within the lock
+    void AddOutstanding(SizeT count);
+
+    /// create key for resource in a loader
+    static uint64 Key(const ResourceLoader* loader, const Ids::Id32 entry);
+
+    Util::Array<Ptr<ResourceLoaderThread>> workers[NumStages];
+    Util::Dictionary<uint64, _Request> queues[NumStages];
+    Util::Set<uint64> inflight;
+    Util::Set<int32_t> busyLoaders;
+    uint64 sequence;
+    SizeT outstanding;
+
+    Timing::Timer timer;
+    Timing::Time windowStart;
+    uint64 windowBytes;
+    uint64 windowRequests;
+    Timing::Time windowLatency;
+    uint64 bytesPerSecond;
+    uint64 latencyMicroSeconds;
+
+    Threading::CriticalSection lock;
+    Threading::Event idleEvent;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline uint64
+ResourceIoScheduler::Key(const ResourceLoader* loader, const Ids::Id32 entry)
+{
+    return ((uint64)loader->GetUniqueId() << 32) | entry;
+}
+
+} // namespace Resources
@@ -5,8 +5,12 @@
 #include "foundation/stdneb.h"
 #include "resourceloader.h"
 #include "io/ioserver.h"
+#include "io/memorystream.h"
+#include "threading/event.h"
 #include "resourceserver.h"
+#include "resourceioscheduler.h"
 #include "util/bit.h"
+#include "profiling/profiling.h"
 
 using namespace IO;
 namespace Resources
@@ -17,7 +21,13 @@ __ImplementAbstractClass(Resources::ResourceLoader, 'RSLO', Core::RefCounted);
 /**
 */
 ResourceLoader::ResourceLoader() :
-    async(false)
+    async(false),
+    prefetchStreams(false),
+    scheduler(nullptr),
+    memoryBudget(0),
+    residentBytes(0),
+    cachedBytes(0),
+    frameIndex(0)
 {
     // maybe this is arrogant, just 1024 pending resources (actual resources that is) per loader?
     this->pendingLoads.Reserve(1024);
@@ -45,12 +55,7 @@ ResourceLoader::Setup()
     this->uniqueResourceId = 0;
 
     // set the async flag in the constructor of your subclass implementation of the resource pool
-    if (this->async)
-    {
-        this->streamerThread = ResourceLoaderThread::Create();
-        this->streamerThread->SetName(this->streamerThreadName.Value());
-        this->streamerThread->Start();
-    }
+    n_assert(!this->async || this->scheduler != nullptr);
 }
 
 //------------------------------------------------------------------------------
@@ -59,8 +64,12 @@ ResourceLoader::Setup()
 void
 ResourceLoader::Discard()
 {
-    this->streamerThread->Stop();
-    this->streamerThread = nullptr;
+    if (this->async)
+    {
+        // make sure no request references this loader anymore
+        this->scheduler->CancelAll(this);
+        this->scheduler->Wait();
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -120,6 +129,16 @@ ResourceLoader::StreamMaxLOD(const Resources::ResourceId& id, const float lod, b
     return SubresourceLoadStatus::Full;
 }
 
+//------------------------------------------------------------------------------
+/**
+    Called within the async section, so overloads must not enter it.
+*/
+uint64
+ResourceLoader::MemoryUsage(const Resources::ResourceId id) const
+{
+    return this->sourceBytes[id.loaderInstanceId];
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -183,25 +202,41 @@ ResourceLoader::Update(IndexT frameIndex)
         this->asyncSection.Leave();
     }
 
+    // evict unused resources before unloading, so evictions which have to wait are picked up right away
+    this->frameIndex = frameIndex;
+    this->EnforceMemoryBudget();
+
     // go through pending unloads
     for (i = this->pendingUnloads.Size() - 1; i >= 0; i--)
     {
         const _PendingResourceUnload& unload = this->pendingUnloads[i];
-        if (this->states[unload.resourceId.loaderInstanceId] != Resource::Pending)
+        const Ids::Id32 entry = unload.resourceId.loaderInstanceId;
+        if (this->states[entry] == Resource::Pending)
         {
-            if (this->states[unload.resourceId.loaderInstanceId] == Resource::Loaded)
-            {
-                // unload if loaded
-                this->Unload(unload.resourceId);
-                this->states[unload.resourceId.loaderInstanceId] = Resource::Unloaded;
-            }
-
-            // give up the resource id
-            this->resourceInstanceIndexPool.Dealloc(unload.resourceId.loaderInstanceId);
-            
-            // remove pending unload if not Pending or Loaded (so explicitly Unloaded or Failed)
-            this->pendingUnloads.EraseIndex(i);
+            if (!this->async)
+                continue;
+
+            // a partially streamed resource stays pending, drop the lod streams requested since and release it once nothing is in flight
+            this->CancelLoad(unload.resourceId);
+            if (this->scheduler->IsBusy(this, entry))
+                continue;
+            if (this->states[entry] == Resource::Pending)
+                this->ReleaseResource(unload.resourceId);
+        }
+        else if (this->states[entry] == Resource::Loaded)
+        {
+            // unload if loaded, the id stays mapped to the resource name so it can be loaded again
+            this->ReleaseResource(unload.resourceId);
         }
+
+        // remove pending unload, the resource is now either Unloaded or Failed
+        this->pendingUnloads.EraseIndex(i);
+    }
+
+    if (this->memoryCounterName.IsValid())
+    {
+        N_BUDGET_COUNTER_RESET(this->memoryCounterName.Value());
+        N_BUDGET_COUNTER_INCR(this->memoryCounterName.Value(), this->residentBytes);
     }
 }
 
@@ -263,9 +298,76 @@ ResourceLoader::GetPlaceholder(const Resources::ResourceName& name)
 
 //------------------------------------------------------------------------------
 /**
+    Open the stream for a resource which is to be created, this is the I/O stage
+    of a load and may run concurrently with the decode stage of other resources.
+    Returns an invalid pointer if the stream can't be opened.
+*/
+Ptr<IO::Stream>
+_OpenStream(ResourceLoader* loader, const ResourceLoader::_PendingResourceLoad& res)
+{
+    loader->asyncSection.Enter();
+    ResourceName name = loader->names[res.entry];
+    loader->asyncSection.Leave();
+
+    Ptr<Stream> stream = IO::IoServer::Instance()->CreateStream(name.Value());
+    stream->SetAccessMode(Stream::ReadAccess);
+    if (!stream->Open())
+        return nullptr;
+
+    if (loader->prefetchStreams && stream->CanReadAsync() && stream->GetSize() > 0)
+    {
+        // read the whole file as a single batch of chunks, which the kernel can service in parallel
+        const Stream::Size size = stream->GetSize();
+        const Stream::Size chunkSize = 1_MB;
+        Ptr<MemoryStream> memStream = MemoryStream::Create();
+        memStream->SetURI(stream->GetURI());
+        memStream->SetAccessMode(Stream::ReadWriteAccess);
+        memStream->Open();
+        memStream->SetSize(size);
+        char* buffer = (char*)memStream->Map();
+
+        SizeT numChunks = (SizeT)((size + chunkSize - 1) / chunkSize);
+        Util::FixedArray<Stream::AsyncRead> reads(numChunks);
+        Util::FixedArray<Stream::Size> bytesRead(numChunks, 0);
+        Threading::AtomicCounter counter = numChunks;
+        Threading::Event readsDone;
+        IndexT i;
+        for (i = 0; i < numChunks; i++)
+        {
+            Stream::Position offset = i * chunkSize;
+            reads[i].buffer = buffer + offset;
+            reads[i].numBytes = Math::min(chunkSize, size - offset);
+            reads[i].offset = offset;
+            reads[i].callback = [&bytesRead, i](Stream::Size numBytes) { bytesRead[i] = numBytes; };
+            reads[i].counter = &counter;
+            reads[i].signalEvent = &readsDone;
+        }
+        stream->ReadAsyncBatch(reads.Begin(), numChunks);
+        readsDone.Wait();
+        memStream->Unmap();
+        stream->Close();
+
+        // a short or failed read would hand a partly zeroed file to the decoder
+        for (i = 0; i < numChunks; i++)
+        {
+            if (bytesRead[i] != reads[i].numBytes)
+            {
+                n_warning("[RESOURCE LOADER] Failed to read %s (%d of %d bytes at offset %d)\n", name.Value(), (int)bytesRead[i], (int)reads[i].numBytes, (int)reads[i].offset);
+                return nullptr;
+            }
+        }
+        return memStream.upcast<Stream>();
+    }
+    return stream;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Initialize and stream a resource, this is the decode stage of a load. If the
+    load creates the resource, the stream must be opened by _OpenStream first.
 */
 Resource::State
-_LoadInternal(ResourceLoader* loader, const ResourceLoader::_PendingResourceLoad res)
+_LoadInternal(ResourceLoader* loader, const ResourceLoader::_PendingResourceLoad res, const Ptr<IO::Stream>& stream)
 {
     loader->asyncSection.Enter();
     Resource::State state = loader->states[res.entry];
@@ -283,10 +385,7 @@ _LoadInternal(ResourceLoader* loader, const ResourceLoader::_PendingResourceLoad
 
     if (AllBits(res.mode, ResourceLoader::_PendingResourceLoad::Create))
     {
-        // construct stream
-        Ptr<Stream> stream = IO::IoServer::Instance()->CreateStream(name.Value());
-        stream->SetAccessMode(Stream::ReadAccess);
-        if (stream->Open())
+        if (stream.isvalid())
         {
             // If new resource, initialize it
             ResourceUnknownId internalResource = loader->InitializeResource(res.entry, res.tag, stream, res.immediate);
@@ -352,6 +451,11 @@ skip_stream:
     loader->states[res.entry] = state;
     loader->resources[res.entry] = resource;
 
+    // account the memory of the resource, a reload replaces what the previous load accounted
+    if (AllBits(res.mode, ResourceLoader::_PendingResourceLoad::Create) && stream.isvalid())
+        loader->sourceBytes[res.entry] = stream->GetSize();
+    loader->SetMemoryUsage(res.entry, state == Resource::Failed ? 0 : loader->MemoryUsage(resource));
+
     // We run the callbacks if the resource loaded or failed
     if (state == Resource::Loaded || state == Resource::Failed)
         loader->RunCallbacks(state, resource);
@@ -378,7 +482,10 @@ ResourceLoader::LoadImmediate(_PendingResourceLoad& res)
     //if (this->states[res.entry] == Resource::Loaded)
     //    return Resource::Loaded;
 
-    return _LoadInternal(this, res);
+    Ptr<Stream> stream;
+    if (AllBits(res.mode, _PendingResourceLoad::Create))
+        stream = _OpenStream(this, res);
+    return _LoadInternal(this, res, stream);
 }
 
 //------------------------------------------------------------------------------
@@ -387,19 +494,58 @@ ResourceLoader::LoadImmediate(_PendingResourceLoad& res)
 void
 ResourceLoader::LoadAsync(_PendingResourceLoad res)
 {
-    // Create callable function
-    auto loadFunc = std::bind(_LoadInternal, this, res);
-
-    // If async, add function call to thread
+    // If async, hand the load over to the scheduler
     if (this->async)
     {
         res.inflight = true;
-        this->streamerThread->jobs.Enqueue(loadFunc);
+        this->scheduler->Enqueue(this, res);
     }
     else
     {
         // Otherwise, run immediately
-        loadFunc();
+        this->LoadImmediate(res);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Loads which haven't started yet are dropped. If that means the resource was
+    never created, it's marked as unloaded so the pending unload only releases its id.
+    Resources which were created but are only partially streamed stay pending, and
+    are released by the pending unload once no request for them is in flight.
+*/
+void
+ResourceLoader::CancelLoad(const Resources::ResourceId id)
+{
+    const Ids::Id32 entry = id.loaderInstanceId;
+    bool createCancelled = this->scheduler->Cancel(this, entry);
+
+    // stop streaming the resource, a load which was never handed to the scheduler hasn't created it yet either
+    IndexT i = this->pendingLoads.FindIndex(entry);
+    if (i != InvalidIndex)
+    {
+        const _PendingResourceLoad& load = this->loads[entry];
+        if (AllBits(load.mode, _PendingResourceLoad::Create) && !load.reload)
+            createCancelled = true;
+        this->pendingLoads.EraseIndexSwap(i);
+    }
+
+    if (createCancelled)
+    {
+        this->asyncSection.Enter();
+        this->states[entry] = Resource::Unloaded;
+        this->loads[entry].mode = _PendingResourceLoad::None;
+        this->callbacks[entry].Clear();
+
+        // the load which would have freed the metadata won't run
+        _LoadMetaData& metaData = this->metaData[entry];
+        if (metaData.data != nullptr)
+        {
+            Memory::Free(Memory::ScratchHeap, metaData.data);
+            metaData.data = nullptr;
+            metaData.size = 0;
+        }
+        this->asyncSection.Leave();
     }
 }
 
@@ -438,6 +584,9 @@ Resources::ResourceLoader::CreateResource(const ResourceName& res, const void* l
             this->loads.Resize(this->loads.Size() + ResourceIndexGrow);
             this->metaData.Resize(this->metaData.Size() + ResourceIndexGrow);
             this->streams.Resize(this->streams.Size() + ResourceIndexGrow);
+            this->sourceBytes.Resize(this->sourceBytes.Size() + ResourceIndexGrow);
+            this->memoryUsage.Resize(this->memoryUsage.Size() + ResourceIndexGrow);
+            this->cached.Resize(this->cached.Size() + ResourceIndexGrow);
         }
 
         // add the resource name to the resource id
@@ -447,6 +596,9 @@ Resources::ResourceLoader::CreateResource(const ResourceName& res, const void* l
         this->states[instanceId] = Resource::Pending;
         this->loadedBits[instanceId] = 0x0;
         this->requestedBits[instanceId] = 0xFFFFFFFF;
+        this->sourceBytes[instanceId] = 0;
+        this->memoryUsage[instanceId] = 0;
+        this->cached[instanceId] = _CachedResource();
 
         // allocate metadata if present
         _LoadMetaData metaData;
@@ -504,8 +656,18 @@ Resources::ResourceLoader::CreateResource(const ResourceName& res, const void* l
         // Get id of previously created resource
         Ids::Id32 instanceId = this->ids.ValueAtIndex(i);
 
-        // bump usage
-        this->usage[instanceId]++;
+        // bump usage, if the resource was unused it's spared from eviction
+        if (this->usage[instanceId]++ == 0)
+        {
+            this->UncacheResource(instanceId);
+
+            IndexT j;
+            for (j = this->pendingUnloads.Size() - 1; j >= 0; j--)
+            {
+                if (this->pendingUnloads[j].resourceId.loaderInstanceId == instanceId)
+                    this->pendingUnloads.EraseIndex(j);
+            }
+        }
 
         // start the async section, the loader might change the resource state
         this->asyncSection.Enter();
@@ -602,21 +764,26 @@ Resources::ResourceLoader::DiscardResource(const Resources::ResourceId id)
     n_assert(Threading::Thread::GetMyThreadId() == this->creatorThread);
     if (id != this->placeholderResourceId && id != this->failResourceId)
     {
-        // if usage reaches 0, add it to the list of pending unloads
+        n_assert(this->usage[id.loaderInstanceId] > 0);
+        this->usage[id.loaderInstanceId]--;
+
+        // if usage reaches 0, keep it loaded until memory runs out, or add it to the list of pending unloads
         if (this->usage[id.loaderInstanceId] == 0)
         {
-            if (this->async)
+            if (this->IsCaching() && this->states[id.loaderInstanceId] == Resource::Loaded)
+            {
+                this->CacheResource(id.loaderInstanceId);
+            }
+            else if (this->async)
             {
                 // add pending unload, it will be unloaded once loaded
+                this->CancelLoad(id);
                 this->pendingUnloads.Append({ id });
-            
             }
-            else
+            else if (this->states[id.loaderInstanceId] == Resource::Loaded)
             {
-                this->Unload(id);
-                this->states[id.loaderInstanceId] = Resource::Unloaded;
+                this->ReleaseResource(id);
             }
-            this->resourceInstanceIndexPool.Dealloc(id.loaderInstanceId);
         }
     }
 #if N_DEBUG
@@ -640,7 +807,10 @@ ResourceLoader::DiscardByTag(const Util::StringAtom& tag)
         if (this->tags[i] == tag)
         {
             // add pending unload, it will be unloaded once loaded
-            this->pendingUnloads.Append({ this->resources[this->ids[this->names[i]]] });
+            const Resources::ResourceId id = this->resources[this->ids[this->names[i]]];
+            if (this->async)
+                this->CancelLoad(id);
+            this->pendingUnloads.Append({ id });
             this->tags[i] = "";
         }
     }
@@ -762,4 +932,151 @@ ResourceLoader::SetMinLod(const Resources::ResourceId& id, const float lod, bool
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceLoader::SetMemoryBudget(uint64 bytes)
+{
+    n_assert(Threading::Thread::GetMyThreadId() == this->creatorThread);
+    this->memoryBudget = bytes;
+    if (this->memoryCounterName.IsValid())
+    {
+        N_BUDGET_COUNTER_SETUP(this->memoryCounterName.Value(), bytes);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+ResourceLoader::IsCaching() const
+{
+    return this->memoryBudget > 0 || ResourceServer::Instance()->GetMemoryBudget() > 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceLoader::CacheResource(const Ids::Id32 entry)
+{
+    this->asyncSection.Enter();
+    _CachedResource& cache = this->cached[entry];
+    n_assert(cache.iter == nullptr);
+    cache.iter = this->lru.AddBack(entry);
+    cache.frame = this->frameIndex;
+    this->cachedBytes += this->memoryUsage[entry];
+    this->asyncSection.Leave();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceLoader::UncacheResource(const Ids::Id32 entry)
+{
+    this->asyncSection.Enter();
+    _CachedResource& cache = this->cached[entry];
+    if (cache.iter != nullptr)
+    {
+        this->lru.Remove(cache.iter);
+        cache.iter = nullptr;
+        this->cachedBytes -= this->memoryUsage[entry];
+    }
+    this->asyncSection.Leave();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Resources which are still being loaded are unloaded once their load finishes.
+*/
+uint64
+ResourceLoader::EvictOne()
+{
+    n_assert(!this->lru.IsEmpty());
+    const Ids::Id32 entry = this->lru.Front();
+    const Resources::ResourceId id = this->resources[entry];
+    const uint64 bytes = this->memoryUsage[entry];
+
+    if (this->async)
+    {
+        this->CancelLoad(id);
+        if (this->scheduler->IsBusy(this, entry))
+        {
+            this->UncacheResource(entry);
+            this->pendingUnloads.Append({ id });
+            return bytes;
+        }
+    }
+    this->ReleaseResource(id);
+    return bytes;
+}
+
+//------------------------------------------------------------------------------
+/**
+    The global budget is enforced by the ResourceServer across all loaders.
+*/
+void
+ResourceLoader::EnforceMemoryBudget()
+{
+    if (!this->IsCaching())
+    {
+        // the budgets were lifted, so unused resources are unloaded right away again
+        while (!this->lru.IsEmpty())
+            this->EvictOne();
+        return;
+    }
+
+    if (this->memoryBudget == 0 || this->residentBytes <= this->memoryBudget)
+        return;
+
+    uint64 excess = this->residentBytes - this->memoryBudget;
+    while (excess > 0 && !this->lru.IsEmpty())
+    {
+        const uint64 freed = this->EvictOne();
+        excess = freed < excess ? excess - freed : 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+IndexT
+ResourceLoader::GetOldestCachedFrame() const
+{
+    if (this->lru.IsEmpty())
+        return InvalidIndex;
+    return this->cached[this->lru.Front()].frame;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceLoader::ReleaseResource(const Resources::ResourceId id)
+{
+    this->UncacheResource(id.loaderInstanceId);
+    this->Unload(id);
+
+    this->asyncSection.Enter();
+    this->states[id.loaderInstanceId] = Resource::Unloaded;
+    this->loadedBits[id.loaderInstanceId] = 0x0;
+    this->SetMemoryUsage(id.loaderInstanceId, 0);
+    this->asyncSection.Leave();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceLoader::SetMemoryUsage(const Ids::Id32 entry, uint64 bytes)
+{
+    const uint64 previous = this->memoryUsage[entry];
+    this->memoryUsage[entry] = bytes;
+    this->residentBytes = this->residentBytes - previous + bytes;
+    if (this->cached[entry].iter != nullptr)
+        this->cachedBytes = this->cachedBytes - previous + bytes;
+}
+
 } // namespace Resources
@@ -27,6 +27,12 @@
     Resources created with tags must also be removed using the tag. A tagged resource can only
     be discarded by using that tag. If a resource is loaded with a tag, it will remain bound
     to that tag, no matter what consecutive loads say. 
+
+    When a memory budget is set, either on the loader or globally on the ResourceServer,
+    resources whose usage drops to zero are not unloaded right away. They are kept in a
+    least recently used list, and only when the budget is exceeded are they evicted, oldest
+    first. The bytes a resource occupies are given by MemoryUsage, which defaults to the
+    size of the file it was loaded from, loaders override it to report resident memory.
     
     @copyright
     (C) 2017-2020 Individual contributors, see AUTHORS file
@@ -40,6 +46,7 @@
 #include "threading/safequeue.h"
 #include "threading/threadid.h"
 #include "ids/idpool.h"
+#include "util/list.h"
 #include <tuple>
 #include <functional>
 
@@ -53,7 +60,7 @@ struct PartialLoadBits
 };
 
 class Resource;
-class ResourceLoaderThread;
+class ResourceIoScheduler;
 class ResourceLoader : public Core::RefCounted
 {
     __DeclareAbstractClass(ResourceLoader);
@@ -107,8 +114,18 @@ public:
     /// begin updating a resources lod
     void SetMinLod(const Resources::ResourceId& id, const float lod, bool immediate);
 
+    /// set the memory budget in bytes, unused resources are kept loaded until it's exceeded, 0 disables the budget
+    void SetMemoryBudget(uint64 bytes);
+    /// get the memory budget in bytes
+    uint64 GetMemoryBudget() const;
+    /// get bytes occupied by all resources of this loader
+    uint64 GetResidentBytes() const;
+    /// get bytes occupied by unused resources which are kept loaded
+    uint64 GetCachedBytes() const;
+
 protected:
     friend class ResourceServer;
+    friend class ResourceIoScheduler;
 
     /// struct for pending resources which are about to be loaded
     struct _PendingResourceLoad
@@ -168,6 +185,15 @@ protected:
         Rejected    // None of the requested subresources were loaded, loader out of budget
     };
 
+    /// entry in the list of unused resources
+    struct _CachedResource
+    {
+        Util::List<Ids::Id32>::Iterator iter;
+        IndexT frame;
+
+        _CachedResource() : frame(InvalidIndex) {};
+    };
+
     static const uint32_t ResourceIndexGrow = 512;
 
     /// Initialize and create the resource, optionally load if no subresource management is necessary
@@ -186,6 +212,8 @@ protected:
 
     /// unload resource (overload to implement resource deallocation)
     virtual void Unload(const Resources::ResourceId id) = 0;
+    /// get the bytes a loaded resource occupies, overload if the file size is a bad estimate
+    virtual uint64 MemoryUsage(const Resources::ResourceId id) const;
     /// update the resource loader, this is done every frame
     virtual void Update(IndexT frameIndex);
 
@@ -196,10 +224,30 @@ protected:
     Resource::State LoadImmediate(_PendingResourceLoad& res);
     /// Load async
     void LoadAsync(_PendingResourceLoad res);
+    /// Cancel queued async loads of a resource which is about to be discarded
+    void CancelLoad(const Resources::ResourceId id);
     /// run callbacks
     void RunCallbacks(Resource::State status, const Resources::ResourceId id);
 
-    friend Resource::State _LoadInternal(ResourceLoader* loader, const _PendingResourceLoad res);
+    /// returns true if unused resources should be kept loaded
+    bool IsCaching() const;
+    /// put an unused resource at the back of the eviction list
+    void CacheResource(const Ids::Id32 entry);
+    /// take a resource out of the eviction list, does nothing if it isn't in it
+    void UncacheResource(const Ids::Id32 entry);
+    /// unload the least recently used unused resource, returns the number of bytes freed
+    uint64 EvictOne();
+    /// evict unused resources until the loader is within its budget
+    void EnforceMemoryBudget();
+    /// get frame in which the least recently used resource was discarded, InvalidIndex if there is none
+    IndexT GetOldestCachedFrame() const;
+    /// unload a loaded resource and release its bytes
+    void ReleaseResource(const Resources::ResourceId id);
+    /// set the bytes occupied by a resource, must be called within the async section
+    void SetMemoryUsage(const Ids::Id32 entry, uint64 bytes);
+
+    friend Ptr<IO::Stream> _OpenStream(ResourceLoader* loader, const _PendingResourceLoad& res);
+    friend Resource::State _LoadInternal(ResourceLoader* loader, const _PendingResourceLoad res, const Ptr<IO::Stream>& stream);
 
     struct _PlaceholderResource
     {
@@ -225,8 +273,11 @@ protected:
     };
 
     bool async;
+    /// read whole resource files into memory with batched async reads during the I/O stage
+    bool prefetchStreams;
 
-    Ptr<ResourceLoaderThread> streamerThread;
+    /// shared scheduler running async loads, assigned by the ResourceServer
+    ResourceIoScheduler* scheduler;
     Util::StringAtom streamerThreadName;
 
     Util::Array<IndexT> pendingLoads;
@@ -248,8 +299,19 @@ protected:
     Util::FixedArray<_PendingResourceLoad> loads;
     Util::FixedArray<_LoadMetaData> metaData;
     Util::FixedArray<StreamData> streams;
+    Util::FixedArray<uint64> sourceBytes;
+    Util::FixedArray<uint64> memoryUsage;
+    Util::FixedArray<_CachedResource> cached;
     uint32_t uniqueResourceId;
 
+    /// unused resources, least recently used first
+    Util::List<Ids::Id32> lru;
+    uint64 memoryBudget;
+    uint64 residentBytes;
+    uint64 cachedBytes;
+    IndexT frameIndex;
+    Util::StringAtom memoryCounterName;
+
     /// id in resource manager
     int32_t uniqueId;
 
@@ -332,4 +394,31 @@ ResourceLoader::GetUniqueId() const
     return this->uniqueId;
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline uint64
+ResourceLoader::GetMemoryBudget() const
+{
+    return this->memoryBudget;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline uint64
+ResourceLoader::GetResidentBytes() const
+{
+    return this->residentBytes;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline uint64
+ResourceLoader::GetCachedBytes() const
+{
+    return this->cachedBytes;
+}
+
 } // namespace Resources
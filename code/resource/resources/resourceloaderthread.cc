@@ -15,7 +15,8 @@ __ImplementClass(Resources::ResourceLoaderThread, 'RETH', Threading::Thread);
 /**
 */
 ResourceLoaderThread::ResourceLoaderThread() :
-    completeEvent(true)
+    scheduler(nullptr),
+    stage(ResourceIoScheduler::IoStage)
 {
     // empty
 }
@@ -39,25 +40,13 @@ ResourceLoaderThread::DoWork()
 {
     this->ioServer = IO::IoServer::Create();
     Profiling::ProfilingRegisterThread();
-    Util::Array<std::function<void()>> arr;
-    arr.Reserve(1000);
     while (!this->ThreadStopRequested())
     {
-        this->completeEvent.Reset();
-
-        this->jobs.DequeueAll(arr);
-        IndexT i;
-        for (i = 0; i < arr.Size(); i++)
+        // run requests until there is nothing left we may run, then wait for more
+        if (!this->scheduler->RunNext(this->stage))
         {
-            arr[i]();
+            this->wakeupEvent.Wait();
         }
-        arr.Reset();
-
-        // signal that this batch is complete
-        this->completeEvent.Signal();
-
-        // wait for more jobs!
-        this->jobs.Wait();
     }
 
     this->ioServer = nullptr;
@@ -69,16 +58,7 @@ ResourceLoaderThread::DoWork()
 void
 ResourceLoaderThread::EmitWakeupSignal()
 {
-    this->jobs.Signal();
-}
-
-//------------------------------------------------------------------------------
-/**
-*/
-void
-ResourceLoaderThread::Wait()
-{
-    this->completeEvent.Wait();
+    this->wakeupEvent.Signal();
 }
 
 } // namespace Resources
@@ -1,16 +1,16 @@
 #pragma once
 //------------------------------------------------------------------------------
 /**
-    The resource loader thread is responsible to handle all ResourceLoaders that wish to load resources asynchronously
+    A resource loader thread is a worker of the ResourceIoScheduler, running requests
+    for one of its stages (I/O or decode) on behalf of all ResourceLoaders
     
     @copyright
     (C) 2017-2020 Individual contributors, see AUTHORS file
 */
 //------------------------------------------------------------------------------
 #include "threading/thread.h"
-#include "threading/safequeue.h"
-#include <functional>
-#include "resourceid.h"
+#include "threading/event.h"
+#include "resourceioscheduler.h"
 
 namespace IO
 {
@@ -28,19 +28,17 @@ public:
     /// destructor
     virtual ~ResourceLoaderThread();
 
-    /// wait for the thread to be done (must be called from outside this thread!)
-    void Wait();
-
 private:
-    friend class ResourceLoader;
+    friend class ResourceIoScheduler;
 
     /// perform work
     void DoWork() override;
     /// emit wakeup signal
     virtual void EmitWakeupSignal() override;
     
-    Threading::SafeQueue<std::function<void()>> jobs;
-    Threading::Event completeEvent;
+    ResourceIoScheduler* scheduler;
+    ResourceIoScheduler::Stage stage;
+    Threading::Event wakeupEvent;
     Ptr<IO::IoServer> ioServer;
 };
 } // namespace Resources
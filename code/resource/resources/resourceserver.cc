@@ -5,6 +5,7 @@
 #include "foundation/stdneb.h"
 #include "resourceserver.h"
 #include "profiling/profiling.h"
+#include "system/systeminfo.h"
 
 #if NEBULA_DEBUG
 #include "core/sysfunc.h"
@@ -16,10 +17,12 @@ __ImplementClass(Resources::ResourceServer, 'RMGR', Core::RefCounted);
 __ImplementInterfaceSingleton(Resources::ResourceServer);
 
 int32_t ResourceServer::UniquePoolCounter = 0;
+N_DECLARE_COUNTER(N_RESOURCE_MEMORY, Resource Memory);
 //------------------------------------------------------------------------------
 /**
 */
-ResourceServer::ResourceServer()
+ResourceServer::ResourceServer() :
+    memoryBudget(0)
 {
     __ConstructSingleton;
     this->open = false;
@@ -42,6 +45,18 @@ ResourceServer::Open()
 {
     n_assert(!this->open);
     this->loaders.Reserve(256); // lower 8 bits of resource id can only get to 256
+
+    // I/O threads mostly wait for the disk, decoding is bound by the number of loaders which can run in parallel
+    this->scheduler = ResourceIoScheduler::Create();
+    this->scheduler->Setup(2, Math::clamp(System::NumCpuCores / 2, 1, 4));
+
+    // loaders which prefetch their streams read through the async reader
+    if (!IO::AsyncReader::HasInstance())
+    {
+        this->asyncReader = IO::AsyncReader::Create();
+        this->asyncReader->Setup();
+    }
+    N_BUDGET_COUNTER_SETUP(N_RESOURCE_MEMORY, this->memoryBudget);
     this->open = true;
     UniquePoolCounter = 0;
 }
@@ -81,6 +96,13 @@ ResourceServer::Close()
     }
 
 #endif
+    this->scheduler->Discard();
+    this->scheduler = nullptr;
+    if (this->asyncReader.isvalid())
+    {
+        this->asyncReader->Discard();
+        this->asyncReader = nullptr;
+    }
     this->loaders.Clear();
     this->extensionMap.Clear();
     this->open = false;
@@ -97,7 +119,10 @@ ResourceServer::RegisterStreamLoader(const Util::StringAtom& ext, const Core::Rt
     void* obj = loaderClass.Create();
     Ptr<ResourceLoader> loader((ResourceLoader*)obj);
     loader->uniqueId = UniquePoolCounter++;
+    loader->scheduler = this->scheduler;
+    loader->memoryCounterName = Util::String::Sprintf("%s Memory", loaderClass.GetName().AsCharPtr());
     loader->Setup();
+    N_BUDGET_COUNTER_SETUP(loader->memoryCounterName.Value(), loader->memoryBudget);
     this->loaders.Append(loader);
     this->extensionMap.Add(ext, this->loaders.Size() - 1);
     this->typeMap.Add(&loaderClass, this->loaders.Size() - 1);
@@ -130,6 +155,59 @@ ResourceServer::Update(IndexT frameIndex)
         const Ptr<ResourceLoader>& loader = this->loaders[i];
         loader->Update(frameIndex);
     }
+
+    uint64 residentBytes = this->GetResidentBytes();
+    if (this->memoryBudget > 0 && residentBytes > this->memoryBudget)
+    {
+        // evict the least recently used resource across all loaders until within budget
+        while (residentBytes > this->memoryBudget)
+        {
+            ResourceLoader* oldest = nullptr;
+            IndexT oldestFrame = InvalidIndex;
+            for (i = 0; i < this->loaders.Size(); i++)
+            {
+                const IndexT frame = this->loaders[i]->GetOldestCachedFrame();
+                if (frame != InvalidIndex && (oldest == nullptr || frame < oldestFrame))
+                {
+                    oldest = this->loaders[i];
+                    oldestFrame = frame;
+                }
+            }
+            if (oldest == nullptr)
+                break;
+
+            const uint64 freed = oldest->EvictOne();
+            residentBytes = freed < residentBytes ? residentBytes - freed : 0;
+        }
+    }
+
+    N_BUDGET_COUNTER_RESET(N_RESOURCE_MEMORY);
+    N_BUDGET_COUNTER_INCR(N_RESOURCE_MEMORY, this->GetResidentBytes());
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ResourceServer::SetMemoryBudget(uint64 bytes)
+{
+    this->memoryBudget = bytes;
+    N_BUDGET_COUNTER_SETUP(N_RESOURCE_MEMORY, bytes);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+uint64
+ResourceServer::GetResidentBytes() const
+{
+    uint64 bytes = 0;
+    IndexT i;
+    for (i = 0; i < this->loaders.Size(); i++)
+    {
+        bytes += this->loaders[i]->GetResidentBytes();
+    }
+    return bytes;
 }
 
 //------------------------------------------------------------------------------
@@ -163,7 +241,7 @@ ResourceServer::HasPendingResources()
                 return true;
         }
     }
-    return false;
+    return this->scheduler->GetNumPending() > 0;
 }
 
 //------------------------------------------------------------------------------
@@ -187,10 +265,7 @@ ResourceServer::GetType(const Resources::ResourceId id)
 void 
 ResourceServer::WaitForLoaderThread()
 {
-    for (const Ptr<ResourceLoader>& loader : this->loaders)
-    {
-        loader->streamerThread->Wait();
-    }
+    this->scheduler->Wait();
 }
 
 } // namespace Resources
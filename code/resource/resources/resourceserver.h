@@ -16,6 +16,8 @@
 #include "resourceid.h"
 #include "resourceloader.h"
 #include "resourceloaderthread.h"
+#include "resourceioscheduler.h"
+#include "io/asyncreader.h"
 namespace Resources
 {
 class ResourceServer : public Core::RefCounted
@@ -78,9 +80,16 @@ public:
     /// get stream pool for later use
     template <class POOL_TYPE> POOL_TYPE* GetStreamLoader() const;
 
-    /// Wait for all loader threads
+    /// Wait for all queued and in-flight async loads to finish
     void WaitForLoaderThread();
 
+    /// set the memory budget in bytes for the resources of all loaders, unused resources are kept loaded until it's exceeded, 0 disables the budget
+    void SetMemoryBudget(uint64 bytes);
+    /// get the memory budget for the resources of all loaders
+    uint64 GetMemoryBudget() const;
+    /// get bytes occupied by the resources of all loaders
+    uint64 GetResidentBytes() const;
+
     /// goes through all pools and sets up their default resources
     void LoadDefaultResources();
 private:
@@ -90,6 +99,9 @@ private:
     Util::Dictionary<Util::StringAtom, IndexT> extensionMap;
     Util::Dictionary<const Core::Rtti*, IndexT> typeMap;
     Util::Array<Ptr<ResourceLoader>> loaders;
+    Ptr<ResourceIoScheduler> scheduler;
+    Ptr<IO::AsyncReader> asyncReader;
+    uint64 memoryBudget;
 
     static int32_t UniquePoolCounter;
 };
@@ -196,6 +208,15 @@ ResourceServer::ReloadResource(const ResourceName& res, std::function<void(const
     loader->ReloadResource(res, success, failed);
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline uint64
+ResourceServer::GetMemoryBudget() const
+{
+    return this->memoryBudget;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
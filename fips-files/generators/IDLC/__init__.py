@@ -110,7 +110,7 @@ class IDLCodeGenerator:
         hasEnums = "enums" in self.document
 
         if hasEnums or hasComponents:
-            IDLDocument.AddInclude(f, "pjson/pjson.h");
+            IDLDocument.AddInclude(f, "io/jsonindex.h");
             IDLDocument.BeginNamespaceOverride(f, self.document, "IO")
             if hasEnums:
                 IDLComponent.WriteEnumJsonSerializers(f, self.document);
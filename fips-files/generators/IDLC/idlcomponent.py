@@ -182,19 +182,19 @@ def WriteEnumJsonSerializers(f, document):
         f.WriteLine('template<> void JsonReader::Get<{namespace}::{name}>({namespace}::{name}& ret, const char* attr)'.format(namespace=namespace, name=enumName))
         f.WriteLine('{')
         f.IncreaseIndent()
-        f.WriteLine("const pjson::value_variant* node = this->GetChild(attr);")
-        f.WriteLine("if (node->is_string())")
+        f.WriteLine("const IndexT node = this->GetChild(attr);")
+        f.WriteLine("if (this->index->IsString(node))")
         f.WriteLine("{")
         f.IncreaseIndent()
-        f.WriteLine("Util::String str = node->as_string_ptr();")
+        f.WriteLine("Util::String str = this->index->GetString(node);")
         for value in enum:
             f.WriteLine('if (str == "{val}") {{ ret = {namespace}::{name}::{val}; return; }}'.format(val=value, namespace=namespace, name=enumName))
         f.DecreaseIndent()
         f.WriteLine("}")
-        f.WriteLine("else if (node->is_int())")
+        f.WriteLine("else if (this->index->IsInt(node))")
         f.WriteLine("{")
         f.IncreaseIndent()
-        f.WriteLine('ret = ({namespace}::{name})node->as_int32();'.format(namespace=namespace, name=enumName))
+        f.WriteLine('ret = ({namespace}::{name})this->index->GetInt64(node);'.format(namespace=namespace, name=enumName))
         f.WriteLine('return;')
         f.DecreaseIndent()
         f.WriteLine("}")
@@ -221,8 +221,8 @@ def WriteStructJsonSerializers(f, document):
         f.WriteLine('{')
         f.IncreaseIndent()
         f.WriteLine('ret = {namespace}::{name}();'.format(namespace=namespace, name=comp.componentName))
-        f.WriteLine("const pjson::value_variant* node = this->GetChild(attr);")
-        f.WriteLine("if (node->is_object())")
+        f.WriteLine("const IndexT node = this->GetChild(attr);")
+        f.WriteLine("if (this->index->IsObject(node))")
         f.WriteLine("{")
         f.IncreaseIndent()
         f.WriteLine("this->SetToNode(attr);")
@@ -113,7 +113,7 @@ target_include_directories(PxLibs INTERFACE ${FIPS_DEPLOY_DIR}/physx/include)
 
 set(DEF_RENDERER "N_RENDERER_VULKAN")
 set(N_RENDERER ${DEF_RENDERER} CACHE STRING "Nebula 3D Render Device")
-set_property(CACHE N_RENDERER PROPERTY STRINGS "N_RENDERER_VULKAN" )
+set_property(CACHE N_RENDERER PROPERTY STRINGS "N_RENDERER_VULKAN" "N_RENDERER_NULL" )
 set(${N_RENDERER} ON)
 
 if(N_QT5)
@@ -134,6 +134,13 @@ if(N_RENDERER_VULKAN)
     add_definitions(-DGRAPHICS_IMPLEMENTATION_NAMESPACE=Vulkan)
 endif()
 
+if(N_RENDERER_NULL)
+    # headless renderer, resources live in CPU memory and submissions are no-ops
+    # the backends implement the same CoreGraphics functions, so the renderer is picked here and not at startup
+    add_definitions(-D__NULL_GRAPHICS__)
+    add_definitions(-DGRAPHICS_IMPLEMENTATION_NAMESPACE=Null)
+endif()
+
 option(N_NEBULA_DEBUG_SHADERS "Compile shaders with debug flag" OFF)
 
 option(USE_DOTNET "Build with .NET support" OFF)
@@ -0,0 +1,180 @@
+//------------------------------------------------------------------------------
+//  asyncreadbenchmark.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "asyncreadbenchmark.h"
+#include "io/ioserver.h"
+#include "io/asyncreader.h"
+#include "io/assignregistry.h"
+#include "io/fswrapper.h"
+#include "threading/event.h"
+#if __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Benchmarking
+{
+__ImplementClass(Benchmarking::AsyncReadBenchmark, 'ASRB', Benchmarking::Benchmark);
+
+using namespace Timing;
+using namespace IO;
+
+static const Stream::Size FileSize = 64_MB;
+static const Stream::Size ReadSize = 4096;
+static const SizeT NumReads = 4096;
+static const SizeT BatchSize = 64;
+
+//------------------------------------------------------------------------------
+/**
+    Evict the file from the page cache, only supported on Linux.
+*/
+static bool
+DropFileCache(const URI& uri)
+{
+#if __linux__
+    Util::String path = AssignRegistry::Instance()->ResolveAssigns(uri).LocalPath();
+    int fd = open(path.AsCharPtr(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    fdatasync(fd);
+    bool result = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    close(fd);
+    return result;
+#else
+    return false;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static void
+Report(const char* name, Time time, SizeT numReads, Time totalLatency)
+{
+    n_printf("%-24s %10.0f reads/s, avg latency %8.1f us\n", name, numReads / time, (totalLatency / numReads) * 1000000.0);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AsyncReadBenchmark::Run(Timer& timer)
+{
+    Ptr<IoServer> ioServer;
+    if (!IoServer::HasInstance())
+        ioServer = IoServer::Create();
+    Ptr<AsyncReader> reader;
+    if (!AsyncReader::HasInstance())
+    {
+        reader = AsyncReader::Create();
+        reader->Setup(BatchSize * 2, 4);
+    }
+    n_printf("AsyncReader backend: %s\n", AsyncReader::Instance()->IsKernelQueue() ? "io_uring" : "thread pool");
+
+    // write a file filled with noise
+    URI uri("temp:asyncreadbenchmark.bin");
+    Ptr<Stream> stream = IoServer::Instance()->CreateStream(uri);
+    stream->SetAccessMode(Stream::WriteAccess);
+    n_assert(stream->Open());
+    Util::FixedArray<uint> noise((SizeT)(1_MB / sizeof(uint)));
+    IndexT i;
+    for (i = 0; i < noise.Size(); i++)
+        noise[i] = i * 2654435761u;
+    for (i = 0; i < FileSize / 1_MB; i++)
+        stream->Write(noise.Begin(), noise.ByteSize());
+    stream->Close();
+
+    // random page aligned offsets
+    Util::FixedArray<Stream::Position> offsets(NumReads);
+    uint seed = 1337;
+    for (i = 0; i < NumReads; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        offsets[i] = (Stream::Position)(seed % (uint)(FileSize / ReadSize)) * ReadSize;
+    }
+
+    char* buffer = (char*)Memory::Alloc(Memory::ScratchHeap, NumReads * ReadSize);
+    AsyncReader::Instance()->RegisterBuffer(buffer, NumReads * ReadSize);
+    Util::FixedArray<Time> submitTimes(NumReads);
+    Util::FixedArray<Time> completeTimes(NumReads);
+
+    timer.Start();
+    for (IndexT pass = 0; pass < 2; pass++)
+    {
+        const bool cold = pass == 0;
+        if (cold && !DropFileCache(uri))
+        {
+            n_printf("Can't drop the file cache on this platform, cold results are warm\n");
+        }
+
+        // synchronous reads, one at a time
+        stream->SetAccessMode(Stream::ReadAccess);
+        n_assert(stream->Open());
+        Timer syncTimer;
+        syncTimer.Start();
+        Time latency = 0;
+        for (i = 0; i < NumReads; i++)
+        {
+            Time start = syncTimer.GetTime();
+            stream->Seek(offsets[i], Stream::Begin);
+            stream->Read(buffer + i * ReadSize, ReadSize);
+            latency += syncTimer.GetTime() - start;
+        }
+        syncTimer.Stop();
+        stream->Close();
+        Report(cold ? "sync (cold):" : "sync (warm):", syncTimer.GetTime(), NumReads, latency);
+
+        if (cold)
+            DropFileCache(uri);
+
+        // asynchronous reads, submitted in batches
+        stream->Open();
+        Timer asyncTimer;
+        asyncTimer.Start();
+        Threading::AtomicCounter counter = NumReads;
+        Threading::Event done;
+        Stream::AsyncRead reads[BatchSize];
+        for (i = 0; i < NumReads; i += BatchSize)
+        {
+            IndexT j;
+            for (j = 0; j < BatchSize; j++)
+            {
+                const IndexT index = i + j;
+                reads[j].buffer = buffer + index * ReadSize;
+                reads[j].numBytes = ReadSize;
+                reads[j].offset = offsets[index];
+                reads[j].callback = [&asyncTimer, &completeTimes, index](Stream::Size)
+                {
+                    completeTimes[index] = asyncTimer.GetTime();
+                };
+                reads[j].counter = &counter;
+                reads[j].signalEvent = &done;
+                submitTimes[index] = asyncTimer.GetTime();
+            }
+            stream->ReadAsyncBatch(reads, BatchSize);
+        }
+        done.Wait();
+        asyncTimer.Stop();
+        stream->Close();
+        latency = 0;
+        for (i = 0; i < NumReads; i++)
+            latency += completeTimes[i] - submitTimes[i];
+        Report(cold ? "async (cold):" : "async (warm):", asyncTimer.GetTime(), NumReads, latency);
+    }
+    timer.Stop();
+
+    AsyncReader::Instance()->UnregisterBuffer(buffer);
+    Memory::Free(Memory::ScratchHeap, buffer);
+    IoServer::Instance()->DeleteFile(uri);
+
+    if (reader.isvalid())
+    {
+        reader->Discard();
+        reader = nullptr;
+    }
+    ioServer = nullptr;
+}
+
+} // namespace Benchmarking
@@ -0,0 +1,25 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Benchmarking::AsyncReadBenchmark
+
+    Compare random reads through Stream::ReadAsync against synchronous
+    Seek/Read, with a cold and a warm file cache.
+
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "benchmarkbase/benchmark.h"
+
+//------------------------------------------------------------------------------
+namespace Benchmarking
+{
+class AsyncReadBenchmark : public Benchmark
+{
+    __DeclareClass(AsyncReadBenchmark);
+public:
+    /// run the benchmark
+    virtual void Run(Timing::Timer& timer);
+};
+
+} // namespace Benchmarking
+//------------------------------------------------------------------------------
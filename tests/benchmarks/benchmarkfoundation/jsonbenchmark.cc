@@ -0,0 +1,220 @@
+//------------------------------------------------------------------------------
+//  jsonbenchmark.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "jsonbenchmark.h"
+#include "io/ioserver.h"
+#include "io/jsonindex.h"
+#ifdef min
+#undef min
+#endif
+#ifdef max
+#undef max
+#endif
+#include "pjson/pjson.h"
+
+namespace Benchmarking
+{
+__ImplementClass(Benchmarking::JsonBenchmark, 'JSNB', Benchmarking::Benchmark);
+
+using namespace Timing;
+using namespace IO;
+using namespace Util;
+
+static const SizeT NumAssets = 4;
+static const SizeT NumEntities = 100000;
+static const SizeT NumRuns = 5;
+
+//------------------------------------------------------------------------------
+/**
+*/
+static void
+CollectJsonFiles(const URI& dir, Array<String>& outFiles)
+{
+    IoServer* ioServer = IoServer::Instance();
+    if (!ioServer->DirectoryExists(dir))
+    {
+        return;
+    }
+    outFiles.AppendArray(ioServer->ListFiles(dir, "*.json", true));
+    Array<String> dirs = ioServer->ListDirectories(dir, "*", true);
+    IndexT i;
+    for (i = 0; i < dirs.Size(); i++)
+    {
+        CollectJsonFiles(dirs[i], outFiles);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Generate a level file with entities and components, like the ones
+    written by the level editor.
+*/
+static void
+GenerateLevel(Array<char>& json)
+{
+    char buf[512];
+    const char* begin = "{\n    \"entities\": [\n";
+    json.AppendArray(begin, (SizeT)strlen(begin));
+    IndexT i;
+    for (i = 0; i < NumEntities; i++)
+    {
+        const float f = float(i);
+        int len = snprintf(buf, sizeof(buf),
+            "        {\n"
+            "            \"name\": \"entity_%d\",\n"
+            "            \"template\": \"StaticEnvironment/tree_%d\",\n"
+            "            \"components\": {\n"
+            "                \"Position\": [%f, %f, %f],\n"
+            "                \"Orientation\": [0.0, 0.7071068, 0.0, 0.7071068],\n"
+            "                \"Scale\": [1.0, 1.0, 1.0],\n"
+            "                \"ModelResource\": \"mdl:environment/tree_%d.n3\",\n"
+            "                \"Tags\": [\"static\", \"shadow\", \"lod\"],\n"
+            "                \"Flags\": %d\n"
+            "            }\n"
+            "        }%s\n",
+            i, i % 16, f * 0.5f, f * 0.25f, -f, i % 16, i & 0xff, (i + 1 < NumEntities) ? "," : "");
+        json.AppendArray(buf, len);
+    }
+    const char* end = "    ]\n}\n";
+    json.AppendArray(end, (SizeT)strlen(end));
+}
+
+//------------------------------------------------------------------------------
+/**
+    Count the values of a pjson DOM, as an estimate of its size.
+*/
+static void
+CountValues(const pjson::value_variant& value, SizeT& numValues, SizeT& numMembers)
+{
+    numValues++;
+    if (value.is_object_or_array())
+    {
+        if (value.is_object())
+        {
+            numMembers += value.size();
+        }
+        uint i;
+        for (i = 0; i < value.size(); i++)
+        {
+            CountValues(value.get_value_at_index(i), numValues, numMembers);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Parses the json with both parsers, and reports the best of a few runs.
+    pjson parses in place, so it gets a fresh copy of the text every run.
+*/
+static void
+Compare(const char* name, const Array<char>& json)
+{
+    Array<char> copy;
+    Timer timer;
+    Time pjsonTime = 1000.0;
+    Time indexTime = 1000.0;
+    SizeT pjsonSize = 0;
+    SizeT indexSize = 0;
+    IndexT run;
+    for (run = 0; run < NumRuns; run++)
+    {
+        copy = json;
+        timer.Reset();
+        timer.Start();
+        pjson::document* document = new pjson::document;
+        bool pjsonValid = document->deserialize_in_place(copy.Begin());
+        timer.Stop();
+        pjsonTime = Math::min(pjsonTime, timer.GetTime());
+        if (pjsonValid)
+        {
+            SizeT numValues = 0, numMembers = 0;
+            CountValues(*document, numValues, numMembers);
+            pjsonSize = numValues * sizeof(pjson::value_variant) + numMembers * sizeof(char*);
+        }
+        delete document;
+
+        timer.Reset();
+        timer.Start();
+        JsonIndex index;
+        bool indexValid = index.Parse(json.Begin(), json.Size() - 1);
+        timer.Stop();
+        indexTime = Math::min(indexTime, timer.GetTime());
+        indexSize = index.GetMemorySize();
+        if (pjsonValid != indexValid)
+        {
+            n_printf("%s: pjson %s, JsonIndex %s\n", name, pjsonValid ? "valid" : "invalid", indexValid ? "valid" : "invalid");
+            return;
+        }
+    }
+
+    const double megaBytes = double(json.Size() - 1) / (1024.0 * 1024.0);
+    n_printf("%-40s %8.2f MB\n", name, megaBytes);
+    n_printf("    pjson:     %8.2f ms %8.1f MB/s, DOM >= %8.2f MB\n", pjsonTime * 1000.0, megaBytes / pjsonTime, pjsonSize / (1024.0 * 1024.0));
+    n_printf("    JsonIndex: %8.2f ms %8.1f MB/s, index  %8.2f MB\n", indexTime * 1000.0, megaBytes / indexTime, indexSize / (1024.0 * 1024.0));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+JsonBenchmark::Run(Timer& timer)
+{
+    Ptr<IoServer> ioServer;
+    if (!IoServer::HasInstance())
+        ioServer = IoServer::Create();
+
+    // the largest json assets
+    Array<String> files;
+    CollectJsonFiles("root:work", files);
+    CollectJsonFiles("root:syswork", files);
+    Array<KeyValuePair<SizeT, String>> sizes;
+    IndexT i;
+    for (i = 0; i < files.Size(); i++)
+    {
+        Ptr<Stream> stream = IoServer::Instance()->CreateStream(files[i]);
+        stream->SetAccessMode(Stream::ReadAccess);
+        if (stream->Open())
+        {
+            sizes.Append(KeyValuePair<SizeT, String>((SizeT)stream->GetSize(), files[i]));
+            stream->Close();
+        }
+    }
+    sizes.Sort();
+
+    timer.Start();
+    for (i = sizes.Size() - 1; i >= 0 && i >= sizes.Size() - NumAssets; i--)
+    {
+        Ptr<Stream> stream = IoServer::Instance()->CreateStream(sizes[i].Value());
+        stream->SetAccessMode(Stream::ReadAccess);
+        n_assert(stream->Open());
+        Array<char> json;
+        json.Resize((SizeT)stream->GetSize() + 1);
+        stream->Read(json.Begin(), stream->GetSize());
+        json.Back() = 0;
+        stream->Close();
+        Compare(sizes[i].Value().ExtractFileName().AsCharPtr(), json);
+    }
+
+    // a generated level file
+    Array<char> level;
+    GenerateLevel(level);
+    level.Append(0);
+    Compare("generated level", level);
+
+    // reading a single value, Parse still scans and validates every byte but nothing is materialized except that value
+    Timer lookupTimer;
+    lookupTimer.Start();
+    JsonIndex index;
+    bool valid = index.Parse(level.Begin(), level.Size() - 1);
+    n_assert(valid);
+    IndexT entity = index.GetChildAt(index.FindChild(index.GetRoot(), "entities"), NumEntities / 2);
+    IndexT position = index.FindChild(index.FindChild(entity, "components"), "Position");
+    double x = index.GetDouble(index.GetFirstChild(position));
+    lookupTimer.Stop();
+    n_printf("JsonIndex parse and read one position: %8.2f ms (x = %f)\n", lookupTimer.GetTime() * 1000.0, x);
+    timer.Stop();
+}
+
+} // namespace Benchmarking
@@ -0,0 +1,26 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Benchmarking::JsonBenchmark
+
+    Compare parse time and memory of the pjson DOM against the JsonIndex
+    used by the JsonReader, on the largest json assets and on a generated
+    level file.
+
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "benchmarkbase/benchmark.h"
+
+//------------------------------------------------------------------------------
+namespace Benchmarking
+{
+class JsonBenchmark : public Benchmark
+{
+    __DeclareClass(JsonBenchmark);
+public:
+    /// run the benchmark
+    virtual void Run(Timing::Timer& timer);
+};
+
+} // namespace Benchmarking
+//------------------------------------------------------------------------------
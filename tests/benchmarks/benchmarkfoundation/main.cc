@@ -17,6 +17,11 @@
 #include "mempoolbenchmark.h"
 #include "containerbenchmark.h"
 #include "delegates.h"
+#include "asyncreadbenchmark.h"
+#include "tcpbenchmark.h"
+#include "udpbenchmark.h"
+#include "stringbenchmark.h"
+#include "jsonbenchmark.h"
 
 using namespace Core;
 using namespace Benchmarking;
@@ -40,6 +45,11 @@ main(int argc, char** argv)
     runner->AttachBenchmark(CreateObjectsByClassName::Create());
     runner->AttachBenchmark(ContainerBench::Create());
     runner->AttachBenchmark(DelegateBench::Create());
+    runner->AttachBenchmark(AsyncReadBenchmark::Create());
+    runner->AttachBenchmark(TcpBenchmark::Create());
+    runner->AttachBenchmark(UdpBenchmark::Create());
+    runner->AttachBenchmark(StringBenchmark::Create());
+    runner->AttachBenchmark(JsonBenchmark::Create());
     runner->Run();
     
     // shutdown Nebula runtime
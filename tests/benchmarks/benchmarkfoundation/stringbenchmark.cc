@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------
+//  stringbenchmark.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "stringbenchmark.h"
+#include "util/string.h"
+#include "util/stringview.h"
+#include "util/stringbuilder.h"
+
+namespace Benchmarking
+{
+__ImplementClass(Benchmarking::StringBenchmark, 'STRB', Benchmarking::Benchmark);
+
+using namespace Timing;
+using namespace Util;
+
+static const SizeT TextSize = 100 * 1024 * 1024;
+static const SizeT LineLength = 80;
+
+//------------------------------------------------------------------------------
+/**
+    Fill a buffer with lines of random words of 2 to 20 characters.
+*/
+static void
+GenerateText(Array<char>& text)
+{
+    text.Reserve(TextSize + LineLength + 32);
+    uint seed = 0x1234567;
+    SizeT lineLength = 0;
+    while (text.Size() < TextSize)
+    {
+        seed = seed * 1664525 + 1013904223;
+        SizeT wordLength = 2 + (seed >> 16) % 19;
+        IndexT i;
+        for (i = 0; i < wordLength; i++)
+        {
+            text.Append(char('a' + (seed >> (i % 24)) % 26));
+        }
+        lineLength += wordLength + 1;
+        if (lineLength >= LineLength)
+        {
+            text.Append('\n');
+            lineLength = 0;
+        }
+        else
+        {
+            text.Append(' ');
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+StringBenchmark::Run(Timer& timer)
+{
+    Array<char> text;
+    GenerateText(text);
+    const StringView textView(text.Begin(), text.Size());
+    n_printf("tokenizing %d MB of text\n", text.Size() / (1024 * 1024));
+
+    // split into lines and tokens as Strings
+    timer.Start();
+    {
+        Array<String> tokens;
+        String line;
+        SizeT numTokens = 0;
+        IndexT lineStart = 0;
+        IndexT lineEnd;
+        while ((lineEnd = textView.FindCharIndex('\n', lineStart)) != InvalidIndex)
+        {
+            line.Set(textView.Data() + lineStart, lineEnd - lineStart);
+            numTokens += line.Tokenize(" ", tokens);
+            lineStart = lineEnd + 1;
+        }
+        n_printf("String tokens: %d, %f\n", numTokens, timer.GetTime());
+    }
+    timer.Stop();
+
+    // split into lines and tokens as StringViews
+    timer.Reset();
+    timer.Start();
+    {
+        Array<StringView> tokens;
+        SizeT numTokens = 0;
+        IndexT lineStart = 0;
+        IndexT lineEnd;
+        while ((lineEnd = textView.FindCharIndex('\n', lineStart)) != InvalidIndex)
+        {
+            const StringView line = textView.ExtractRange(lineStart, lineEnd - lineStart);
+            numTokens += line.Tokenize(" ", tokens);
+            lineStart = lineEnd + 1;
+        }
+        n_printf("StringView tokens: %d, %f\n", numTokens, timer.GetTime());
+    }
+    timer.Stop();
+
+    // split into StringViews and keep a copy of every token in a builder, resetting it every few lines
+    timer.Reset();
+    timer.Start();
+    {
+        Array<StringView> tokens;
+        StringBuilder builder;
+        SizeT numTokens = 0;
+        uint checksum = 0;
+        IndexT lineStart = 0;
+        IndexT lineEnd;
+        IndexT lineIndex = 0;
+        while ((lineEnd = textView.FindCharIndex('\n', lineStart)) != InvalidIndex)
+        {
+            const StringView line = textView.ExtractRange(lineStart, lineEnd - lineStart);
+            numTokens += line.Tokenize(" ", tokens);
+            IndexT i;
+            for (i = 0; i < tokens.Size(); i++)
+            {
+                checksum += builder.Add(tokens[i]).Length();
+            }
+            if (++lineIndex % 1024 == 0)
+            {
+                builder.Reset();
+            }
+            lineStart = lineEnd + 1;
+        }
+        n_printf("StringBuilder tokens: %d (checksum %u), %f\n", numTokens, checksum, timer.GetTime());
+    }
+    timer.Stop();
+}
+
+} // namespace Benchmarking
@@ -0,0 +1,138 @@
+//------------------------------------------------------------------------------
+//  tcpbenchmark.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "tcpbenchmark.h"
+#include "net/tcpserver.h"
+#include "net/tcpclient.h"
+#include "io/memorystream.h"
+
+namespace Benchmarking
+{
+__ImplementClass(Benchmarking::TcpBenchmark, 'TCPB', Benchmarking::Benchmark);
+
+using namespace Timing;
+using namespace Net;
+using namespace IO;
+
+static const ushort Port = 2143;
+static const SizeT NumClients = 64;
+static const SizeT NumRoundTrips = 1000;
+static const SizeT RoundTripSize = 64;
+static const SizeT NumBroadcasts = 256;
+static const SizeT BroadcastSize = 4096;
+
+//------------------------------------------------------------------------------
+/**
+*/
+static void
+WriteMessage(const Ptr<Stream>& stream, const uchar* data, SizeT size)
+{
+    stream->SetAccessMode(Stream::WriteAccess);
+    stream->SetSize(0);
+    stream->Open();
+    stream->Write(data, size);
+    stream->Close();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TcpBenchmark::Run(Timer& timer)
+{
+    Ptr<TcpServer> server = TcpServer::Create();
+    server->SetAddress(IpAddress("127.0.0.1", Port));
+    if (!server->Open())
+    {
+        n_printf("TcpBenchmark: failed to open server on port %d, skipping\n", Port);
+        return;
+    }
+
+    Util::Array<Ptr<TcpClient>> clients;
+    IndexT i;
+    for (i = 0; i < NumClients; i++)
+    {
+        Ptr<TcpClient> client = TcpClient::Create();
+        client->SetBlocking(true);
+        client->SetServerAddress(IpAddress("127.0.0.1", Port));
+        n_assert(TcpClient::Success == client->Connect());
+        clients.Append(client);
+    }
+    while (server->GetNumClientConnections() < NumClients)
+    {
+        Timing::Sleep(0.001);
+    }
+
+    uchar message[BroadcastSize];
+    for (i = 0; i < BroadcastSize; i++)
+        message[i] = (uchar)i;
+
+    timer.Start();
+
+    // round trips, the server polls for data and echoes it back
+    Timer latencyTimer;
+    latencyTimer.Start();
+    const Ptr<TcpClient>& pinger = clients[0];
+    for (i = 0; i < NumRoundTrips; i++)
+    {
+        WriteMessage(pinger->GetSendStream(), message, RoundTripSize);
+        pinger->Send();
+
+        SizeT received = 0;
+        while (received < RoundTripSize)
+        {
+            Util::Array<Ptr<TcpClientConnection>> ready = server->Recv();
+            IndexT j;
+            for (j = 0; j < ready.Size(); j++)
+            {
+                received += (SizeT)ready[j]->GetRecvStream()->GetSize();
+                ready[j]->Send(ready[j]->GetRecvStream());
+            }
+        }
+
+        received = 0;
+        while (received < RoundTripSize && pinger->Recv())
+        {
+            received += (SizeT)pinger->GetRecvStream()->GetSize();
+        }
+    }
+    latencyTimer.Stop();
+    n_printf("round trip:  %8.1f us\n", (latencyTimer.GetTime() / NumRoundTrips) * 1000000.0);
+
+    // broadcast to all clients, then drain them
+    Timer throughputTimer;
+    throughputTimer.Start();
+    Ptr<MemoryStream> broadcast = MemoryStream::Create();
+    WriteMessage(broadcast, message, BroadcastSize);
+    for (i = 0; i < NumBroadcasts; i++)
+    {
+        server->Broadcast(broadcast);
+    }
+    const SizeT expected = NumBroadcasts * BroadcastSize;
+    for (i = 0; i < clients.Size(); i++)
+    {
+        SizeT received = 0;
+        while (received < expected && clients[i]->Recv())
+        {
+            received += (SizeT)clients[i]->GetRecvStream()->GetSize();
+        }
+        n_assert(received == expected);
+    }
+    throughputTimer.Stop();
+    const double megaBytes = double(expected) * NumClients / (1024.0 * 1024.0);
+    n_printf("broadcast:   %8.1f MB/s to %d clients\n", megaBytes / throughputTimer.GetTime(), NumClients);
+
+    timer.Stop();
+
+    for (i = 0; i < clients.Size(); i++)
+    {
+        clients[i]->Disconnect();
+    }
+    clients.Clear();
+    server->Close();
+    server = nullptr;
+}
+
+} // namespace Benchmarking
@@ -0,0 +1,141 @@
+//------------------------------------------------------------------------------
+//  udpbenchmark.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "udpbenchmark.h"
+#include "net/socket/socket.h"
+#include "net/udp/packetpool.h"
+
+namespace Benchmarking
+{
+__ImplementClass(Benchmarking::UdpBenchmark, 'UDPB', Benchmarking::Benchmark);
+
+using namespace Timing;
+using namespace Net;
+
+static const SizeT NumPackets = 200000;
+static const SizeT PacketSize = 64;
+static const SizeT BatchSize = 64;
+
+//------------------------------------------------------------------------------
+/**
+*/
+static Ptr<Socket>
+OpenSocket()
+{
+    Ptr<Socket> socket = Socket::Create();
+    n_assert(socket->Open(Socket::UDP));
+    socket->SetAddress(IpAddress("127.0.0.1", 0));
+    n_assert(socket->Bind());
+    socket->SetBlocking(false);
+    socket->SetRecvBufSize(4 * 1024 * 1024);
+    return socket;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static void
+Report(const char* name, Time sendTime, Time recvTime, SizeT numReceived)
+{
+    n_printf("%-10s send %10.0f packets/s, recv %10.0f packets/s, %d%% received\n", name, NumPackets / sendTime, numReceived / recvTime, (numReceived * 100) / NumPackets);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Packets are sent in bursts which fit into the receive buffer, and
+    drained after each burst, so nothing should get lost.
+*/
+void
+UdpBenchmark::Run(Timer& timer)
+{
+    Ptr<Socket> sender = OpenSocket();
+    Ptr<Socket> receiver = OpenSocket();
+    const uint addr = receiver->GetAddress().GetAddr();
+    const ushort port = receiver->GetAddress().GetPort();
+
+    Ptr<PacketPool> pool = PacketPool::Create();
+    pool->Setup(BatchSize * 2, PacketSize);
+    Socket::Datagram sendBatch[BatchSize];
+    Socket::Datagram recvBatch[BatchSize];
+    Util::Array<Socket::Datagram*> packets;
+    IndexT i;
+    for (i = 0; i < BatchSize * 2; i++)
+    {
+        Socket::Datagram* packet = pool->Alloc();
+        Memory::Fill(packet->buf, PacketSize, (uchar)i);
+        packet->numBytes = PacketSize;
+        packet->addr = addr;
+        packet->port = port;
+        packets.Append(packet);
+        if (i < BatchSize)
+            sendBatch[i] = *packet;
+        else
+            recvBatch[i - BatchSize] = *packet;
+    }
+
+    timer.Start();
+
+    // one system call per datagram
+    Timer stopwatch;
+    stopwatch.Start();
+    Time sendTime = 0, recvTime = 0;
+    SizeT numReceived = 0;
+    for (i = 0; i < NumPackets; i += BatchSize)
+    {
+        Time start = stopwatch.GetTime();
+        IndexT j;
+        for (j = 0; j < BatchSize; j++)
+        {
+            SizeT bytesSent;
+            sender->SendTo(sendBatch[j].buf, PacketSize, addr, port, bytesSent);
+        }
+        sendTime += stopwatch.GetTime() - start;
+
+        start = stopwatch.GetTime();
+        uchar buf[PacketSize];
+        uint fromAddr;
+        ushort fromPort;
+        SizeT bytesReceived;
+        while (Socket::Success == receiver->RecvFrom(buf, sizeof(buf), fromAddr, fromPort, bytesReceived))
+        {
+            numReceived++;
+        }
+        recvTime += stopwatch.GetTime() - start;
+    }
+    Report("single:", sendTime, recvTime, numReceived);
+
+    // batched
+    sendTime = recvTime = 0;
+    numReceived = 0;
+    for (i = 0; i < NumPackets; i += BatchSize)
+    {
+        Time start = stopwatch.GetTime();
+        SizeT numSent;
+        sender->SendBatch(sendBatch, BatchSize, numSent);
+        sendTime += stopwatch.GetTime() - start;
+
+        start = stopwatch.GetTime();
+        SizeT batchReceived;
+        while (Socket::Success == receiver->RecvBatch(recvBatch, BatchSize, batchReceived))
+        {
+            numReceived += batchReceived;
+        }
+        recvTime += stopwatch.GetTime() - start;
+    }
+    stopwatch.Stop();
+    Report("batched:", sendTime, recvTime, numReceived);
+
+    timer.Stop();
+
+    for (i = 0; i < packets.Size(); i++)
+    {
+        pool->Free(packets[i]);
+    }
+    pool->Discard();
+    sender->Close();
+    receiver->Close();
+}
+
+} // namespace Benchmarking
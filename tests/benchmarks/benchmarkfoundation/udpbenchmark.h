@@ -0,0 +1,25 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Benchmarking::UdpBenchmark
+
+    Compare datagram throughput of single SendTo/RecvFrom calls against
+    batched SendBatch/RecvBatch over the loopback interface.
+
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "benchmarkbase/benchmark.h"
+
+//------------------------------------------------------------------------------
+namespace Benchmarking
+{
+class UdpBenchmark : public Benchmark
+{
+    __DeclareClass(UdpBenchmark);
+public:
+    /// run the benchmark
+    virtual void Run(Timing::Timer& timer);
+};
+
+} // namespace Benchmarking
+//------------------------------------------------------------------------------
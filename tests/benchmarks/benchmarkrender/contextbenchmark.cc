@@ -0,0 +1,366 @@
+//------------------------------------------------------------------------------
+//  contextbenchmark.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "contextbenchmark.h"
+#include "io/ioserver.h"
+#include "resources/resourceserver.h"
+#include "jobs2/jobs2.h"
+#include "coregraphics/window.h"
+#include "coregraphics/null/nullgraphicsdevice.h"
+#include "graphics/graphicsserver.h"
+#include "graphics/cameracontext.h"
+#include "graphics/view.h"
+#include "graphics/stage.h"
+#include "models/modelcontext.h"
+#include "characters/charactercontext.h"
+#include "particles/particlecontext.h"
+#include "visibility/visibilitycontext.h"
+
+namespace Benchmarking
+{
+__ImplementClass(Benchmarking::ContextBenchmark, 'BCTX', Benchmarking::Benchmark);
+
+using namespace Graphics;
+using namespace Models;
+using namespace Characters;
+using namespace Particles;
+using namespace Visibility;
+using namespace Timing;
+
+struct TimedViewIndependentCall
+{
+    const char* name;
+    ViewIndependentCall call;
+    Time time;
+};
+
+struct TimedViewDependentCall
+{
+    const char* name;
+    ViewDependentCall call;
+    Time time;
+};
+
+static Timer callTimer;
+
+static TimedViewIndependentCall preLogicCalls[] =
+{
+    { "CameraContext::UpdateCameras", CameraContext::UpdateCameras, 0 },
+    { "ModelContext::UpdateTransforms", ModelContext::UpdateTransforms, 0 },
+    { "CharacterContext::UpdateAnimations", CharacterContext::UpdateAnimations, 0 },
+    { "ParticleContext::UpdateParticles", ParticleContext::UpdateParticles, 0 },
+};
+
+static TimedViewDependentCall preLogicViewCalls[] =
+{
+    { "ParticleContext::OnPrepareView", ParticleContext::OnPrepareView, 0 },
+};
+
+static TimedViewIndependentCall postLogicCalls[] =
+{
+    { "ObserverContext::RunVisibilityTests", ObserverContext::RunVisibilityTests, 0 },
+    { "ObserverContext::GenerateDrawLists", ObserverContext::GenerateDrawLists, 0 },
+    { "ModelContext::WaitForWork", ModelContext::WaitForWork, 0 },
+    { "CharacterContext::WaitForCharacterJobs", CharacterContext::WaitForCharacterJobs, 0 },
+    { "ParticleContext::WaitForParticleUpdates", ParticleContext::WaitForParticleUpdates, 0 },
+    { "ObserverContext::WaitForVisibility", ObserverContext::WaitForVisibility, 0 },
+};
+
+static const SizeT NumPreLogicCalls = sizeof(preLogicCalls) / sizeof(preLogicCalls[0]);
+static const SizeT NumPreLogicViewCalls = sizeof(preLogicViewCalls) / sizeof(preLogicViewCalls[0]);
+static const SizeT NumPostLogicCalls = sizeof(postLogicCalls) / sizeof(postLogicCalls[0]);
+
+//------------------------------------------------------------------------------
+/**
+    The graphics server only takes plain function pointers, so every timed
+    call gets a trampoline of its own.
+*/
+template <int INDEX> static void
+TimedPreLogic(const FrameContext& ctx)
+{
+    Time start = callTimer.GetTime();
+    preLogicCalls[INDEX].call(ctx);
+    preLogicCalls[INDEX].time += callTimer.GetTime() - start;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template <int INDEX> static void
+TimedPreLogicView(const Ptr<View>& view, const FrameContext& ctx)
+{
+    Time start = callTimer.GetTime();
+    preLogicViewCalls[INDEX].call(view, ctx);
+    preLogicViewCalls[INDEX].time += callTimer.GetTime() - start;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template <int INDEX> static void
+TimedPostLogic(const FrameContext& ctx)
+{
+    Time start = callTimer.GetTime();
+    postLogicCalls[INDEX].call(ctx);
+    postLogicCalls[INDEX].time += callTimer.GetTime() - start;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template <typename CALL> static void
+PrintCalls(CALL* calls, SizeT numCalls, SizeT numFrames)
+{
+    IndexT i;
+    for (i = 0; i < numCalls; i++)
+    {
+        n_printf("    %-42s %8.3f ms\n", calls[i].name, (calls[i].time / numFrames) * 1000.0);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template <typename CALL> static void
+ResetCalls(CALL* calls, SizeT numCalls)
+{
+    IndexT i;
+    for (i = 0; i < numCalls; i++)
+    {
+        calls[i].time = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+ContextBenchmark::ContextBenchmark() :
+    numModels(1000),
+    numCharacters(100),
+    numParticles(100),
+    numWarmupFrames(60),
+    numFrames(500),
+    model("sysmdl:placeholder.n3"),
+    characterModel("mdl:test/Unit_Knight.n3"),
+    skeleton("ske:test/Unit_Knight.nsk"),
+    animation("ani:test/Unit_Knight.nax"),
+    particleModel("mdl:Particles/Build_dust.n3")
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ContextBenchmark::SetCmdLineArgs(const Util::CommandLineArgs& args)
+{
+    this->numModels = args.GetInt("-models", this->numModels);
+    this->numCharacters = args.GetInt("-characters", this->numCharacters);
+    this->numParticles = args.GetInt("-particles", this->numParticles);
+    this->numWarmupFrames = args.GetInt("-warmup", this->numWarmupFrames);
+    this->numFrames = Math::max(args.GetInt("-frames", this->numFrames), 1);
+    this->model = args.GetString("-model", this->model);
+    this->characterModel = args.GetString("-charactermodel", this->characterModel);
+    this->skeleton = args.GetString("-skeleton", this->skeleton);
+    this->animation = args.GetString("-animation", this->animation);
+    this->particleModel = args.GetString("-particlemodel", this->particleModel);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ContextBenchmark::Run(Timer& timer)
+{
+    Ptr<IO::IoServer> ioServer = IO::IoServer::Create();
+    Ptr<Resources::ResourceServer> resMgr = Resources::ResourceServer::Create();
+    Ptr<GraphicsServer> gfxServer = GraphicsServer::Create();
+    resMgr->Open();
+    gfxServer->Open();
+
+    Jobs2::JobSystemInitInfo jobSystemInfo;
+    jobSystemInfo.numThreads = 8;
+    jobSystemInfo.name = "JobSystem";
+    jobSystemInfo.scratchMemorySize = 8_MB;
+    Jobs2::JobSystemInit(jobSystemInfo);
+
+    const SizeT width = 1280;
+    const SizeT height = 720;
+    CoreGraphics::WindowCreateInfo wndInfo =
+    {
+        CoreGraphics::DisplayMode{ 0, 0, width, height },
+        "Nebula Render Benchmark", "", CoreGraphics::AntiAliasQuality::None, false, false, false, false
+    };
+    CoreGraphics::WindowId wnd = CoreGraphics::CreateWindow(wndInfo);
+
+    // the view has no frame script, rendering only runs the contexts
+    Ptr<View> view = gfxServer->CreateView("benchmark");
+    gfxServer->SetCurrentView(view);
+    Ptr<Stage> stage = gfxServer->CreateStage("benchmark", true);
+
+    CameraContext::Create();
+    ModelContext::Create();
+    CharacterContext::Create();
+    ParticleContext::Create();
+    ObserverContext::Create();
+    ObservableContext::Create();
+
+    GraphicsEntityId cam = CreateEntity();
+    RegisterEntity<CameraContext, ObserverContext>(cam);
+    CameraContext::SetupProjectionFov(cam, width / (float)height, Math::deg2rad(60.f), 0.1f, 10000.0f);
+    CameraContext::SetLODCamera(cam);
+    CameraContext::SetView(cam, Math::inverse(Math::lookatrh(Math::point(0, 50, -50), Math::point(0, 0, 100), Math::vector::upvec())));
+    view->SetCamera(cam);
+    view->SetStage(stage);
+    ObserverContext::CreateBruteforceSystem({});
+    ObserverContext::Setup(cam, VisibilityEntityType::Camera);
+
+    // spread the entities on a grid in front of the camera
+    const SizeT numEntities = this->numModels + this->numCharacters + this->numParticles;
+    const SizeT gridSize = Math::max((SizeT)Math::ceil(Math::sqrt((float)numEntities)), 1);
+    Util::Array<GraphicsEntityId> entities;
+    entities.Reserve(numEntities);
+    IndexT i;
+    for (i = 0; i < numEntities; i++)
+    {
+        GraphicsEntityId ent = CreateEntity();
+        RegisterEntity<ModelContext, ObservableContext>(ent);
+        const Math::mat4 transform = Math::translation((i % gridSize - gridSize * 0.5f) * 2.0f, 0, (i / gridSize) * 2.0f);
+        if (i < this->numModels)
+        {
+            ModelContext::Setup(ent, this->model, "Benchmark", [ent]()
+            {
+                ObservableContext::Setup(ent, VisibilityEntityType::Model);
+            });
+        }
+        else if (i < this->numModels + this->numCharacters)
+        {
+            RegisterEntity<CharacterContext>(ent);
+            Util::String skeleton = this->skeleton;
+            Util::String animation = this->animation;
+            ModelContext::Setup(ent, this->characterModel, "Benchmark", [ent, skeleton, animation]()
+            {
+                ObservableContext::Setup(ent, VisibilityEntityType::Model);
+                CharacterContext::Setup(ent, skeleton, 0, animation, 0, "Benchmark");
+                CharacterContext::PlayClip(ent, nullptr, 0, 0, Append, 1.0f, 0, Math::rand() * 100.0f, 0.0f, 0.0f, 0.0f);
+            });
+        }
+        else
+        {
+            RegisterEntity<ParticleContext>(ent);
+            ModelContext::Setup(ent, this->particleModel, "Benchmark", [ent]()
+            {
+                ObservableContext::Setup(ent, VisibilityEntityType::Particle);
+                ParticleContext::Setup(ent);
+                ParticleContext::Play(ent, ParticleContext::RestartIfPlaying);
+            });
+        }
+        ModelContext::SetTransform(ent, transform);
+        entities.Append(ent);
+    }
+
+    gfxServer->SetupPreLogicCalls(
+    {
+        TimedPreLogic<0>,
+        TimedPreLogic<1>,
+        TimedPreLogic<2>,
+        TimedPreLogic<3>,
+    });
+    gfxServer->SetupPreLogicViewCalls(
+    {
+        TimedPreLogicView<0>,
+    });
+    gfxServer->SetupPostLogicCalls(
+    {
+        TimedPostLogic<0>,
+        TimedPostLogic<1>,
+        TimedPostLogic<2>,
+        TimedPostLogic<3>,
+        TimedPostLogic<4>,
+        TimedPostLogic<5>,
+    });
+    static_assert(NumPreLogicCalls == 4 && NumPreLogicViewCalls == 1 && NumPostLogicCalls == 6, "every timed call needs a trampoline");
+
+    // warm up until the resources have been loaded, then measure
+    Time preLogicTime = 0;
+    Time postLogicTime = 0;
+    Time renderTime = 0;
+    uint64 numSubmissions = 0;
+    callTimer.Start();
+    for (i = 0; i < this->numWarmupFrames + this->numFrames; i++)
+    {
+        if (i == this->numWarmupFrames)
+        {
+            ResetCalls(preLogicCalls, NumPreLogicCalls);
+            ResetCalls(preLogicViewCalls, NumPreLogicViewCalls);
+            ResetCalls(postLogicCalls, NumPostLogicCalls);
+            preLogicTime = postLogicTime = renderTime = 0;
+            numSubmissions = Null::GetNumSubmissions();
+            timer.Start();
+        }
+
+        Jobs2::JobNewFrame();
+        resMgr->Update(gfxServer->GetFrameIndex());
+
+        Time start = callTimer.GetTime();
+        gfxServer->RunPreLogic();
+        Time end = callTimer.GetTime();
+        preLogicTime += end - start;
+
+        start = end;
+        gfxServer->RunPostLogic();
+        end = callTimer.GetTime();
+        postLogicTime += end - start;
+
+        start = end;
+        gfxServer->Render();
+        gfxServer->EndFrame();
+        CoreGraphics::WindowPresent(wnd, gfxServer->GetFrameIndex());
+        gfxServer->NewFrame();
+        renderTime += callTimer.GetTime() - start;
+    }
+    timer.Stop();
+    callTimer.Stop();
+
+    n_printf("ContextBenchmark: %d models, %d characters, %d particle emitters, %d frames\n", this->numModels, this->numCharacters, this->numParticles, this->numFrames);
+    n_printf("  RunPreLogic:  %8.3f ms\n", (preLogicTime / this->numFrames) * 1000.0);
+    PrintCalls(preLogicCalls, NumPreLogicCalls, this->numFrames);
+    PrintCalls(preLogicViewCalls, NumPreLogicViewCalls, this->numFrames);
+    n_printf("  RunPostLogic: %8.3f ms\n", (postLogicTime / this->numFrames) * 1000.0);
+    PrintCalls(postLogicCalls, NumPostLogicCalls, this->numFrames);
+    n_printf("  Render:       %8.3f ms\n", (renderTime / this->numFrames) * 1000.0);
+    n_printf("  %d command buffer submissions\n", (int)(Null::GetNumSubmissions() - numSubmissions));
+#if NEBULA_ENABLE_PROFILING
+    n_printf("  %d draw calls in the last frame\n", CoreGraphics::GetNumDrawCalls());
+#endif
+
+    // shutdown
+    for (i = 0; i < entities.Size(); i++)
+    {
+        if (CharacterContext::IsEntityRegistered(entities[i]))
+            CharacterContext::DeregisterEntity(entities[i]);
+        if (ParticleContext::IsEntityRegistered(entities[i]))
+            ParticleContext::DeregisterEntity(entities[i]);
+        ObservableContext::DeregisterEntity(entities[i]);
+        ModelContext::DeregisterEntity(entities[i]);
+        DestroyEntity(entities[i]);
+    }
+    DeregisterEntity<CameraContext, ObserverContext>(cam);
+    DestroyEntity(cam);
+
+    gfxServer->SetupPreLogicCalls({});
+    gfxServer->SetupPreLogicViewCalls({});
+    gfxServer->SetupPostLogicCalls({});
+    Jobs2::JobSystemUninit();
+    CoreGraphics::DestroyWindow(wnd);
+    gfxServer->DiscardStage(stage);
+    gfxServer->DiscardView(view);
+    ObserverContext::Discard();
+    gfxServer->Close();
+    resMgr->Close();
+}
+
+} // namespace Benchmarking
@@ -0,0 +1,44 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Benchmarking::ContextBenchmark
+
+    Runs the graphics server headless on the null renderer with a configurable
+    number of models, characters and particle emitters, and measures how long
+    each graphics context spends in RunPreLogic and RunPostLogic per frame.
+
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "benchmarkbase/benchmark.h"
+#include "util/commandlineargs.h"
+
+//------------------------------------------------------------------------------
+namespace Benchmarking
+{
+class ContextBenchmark : public Benchmark
+{
+    __DeclareClass(ContextBenchmark);
+public:
+    /// constructor
+    ContextBenchmark();
+
+    /// setup the scene from command line arguments
+    void SetCmdLineArgs(const Util::CommandLineArgs& args);
+    /// run the benchmark
+    virtual void Run(Timing::Timer& timer);
+
+private:
+    SizeT numModels;
+    SizeT numCharacters;
+    SizeT numParticles;
+    SizeT numWarmupFrames;
+    SizeT numFrames;
+    Util::String model;
+    Util::String characterModel;
+    Util::String skeleton;
+    Util::String animation;
+    Util::String particleModel;
+};
+
+} // namespace Benchmarking
+//------------------------------------------------------------------------------
@@ -0,0 +1,38 @@
+//------------------------------------------------------------------------------
+//  main.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "core/coreserver.h"
+#include "core/sysfunc.h"
+#include "benchmarkbase/benchmarkrunner.h"
+
+#include "meshweldbenchmark.h"
+
+using namespace Core;
+using namespace Benchmarking;
+
+int __cdecl
+main(int argc, const char** argv)
+{
+    // create Nebula runtime
+    Ptr<CoreServer> coreServer = CoreServer::Create();
+    coreServer->SetAppName(Util::StringAtom("Nebula Toolkit Benchmark"));
+    coreServer->Open();
+
+    // setup and run benchmarks
+    Ptr<MeshWeldBenchmark> meshWeldBenchmark = MeshWeldBenchmark::Create();
+    meshWeldBenchmark->SetCmdLineArgs(Util::CommandLineArgs(argc, argv));
+
+    Ptr<BenchmarkRunner> runner = BenchmarkRunner::Create();
+    runner->AttachBenchmark(meshWeldBenchmark);
+    runner->Run();
+
+    // shutdown Nebula runtime
+    runner = nullptr;
+    meshWeldBenchmark = nullptr;
+    coreServer->Close();
+    coreServer = nullptr;
+    SysFunc::Exit(0);
+    return 0;
+}
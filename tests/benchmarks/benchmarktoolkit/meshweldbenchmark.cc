@@ -0,0 +1,220 @@
+//------------------------------------------------------------------------------
+//  meshweldbenchmark.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "meshweldbenchmark.h"
+#include "jobs2/jobs2.h"
+#include "model/meshutil/meshbuilder.h"
+
+namespace Benchmarking
+{
+__ImplementClass(Benchmarking::MeshWeldBenchmark, 'BMWB', Benchmarking::Benchmark);
+
+using namespace ToolkitUtil;
+using namespace Timing;
+using namespace Util;
+
+//------------------------------------------------------------------------------
+/**
+    Builds a gridSize x gridSize grid where every triangle has vertices of its
+    own, so welding is expected to collapse it to (gridSize + 1)^2 vertices.
+*/
+static void
+BuildGrid(MeshBuilder& mesh, SizeT gridSize)
+{
+    const MeshBuilderVertex::ComponentMask components = MeshBuilderVertex::Components::Position
+        | MeshBuilderVertex::Components::Uvs
+        | MeshBuilderVertex::Components::Normals
+        | MeshBuilderVertex::Components::Tangents;
+    mesh.NewMesh(gridSize * gridSize * 6, gridSize * gridSize * 2);
+    mesh.SetComponents(components);
+
+    static const IndexT Corners[6][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 0 }, { 1, 1 }, { 0, 1 } };
+    MeshBuilderVertex v;
+    v.SetComponents(components);
+    v.SetNormal(Math::vec3(0, 1, 0));
+    v.SetTangent(Math::vec3(1, 0, 0));
+    MeshBuilderTriangle tri;
+    IndexT x, y, i;
+    for (y = 0; y < gridSize; y++)
+    {
+        for (x = 0; x < gridSize; x++)
+        {
+            const IndexT base = mesh.GetNumVertices();
+            for (i = 0; i < 6; i++)
+            {
+                const float cx = float(x + Corners[i][0]);
+                const float cy = float(y + Corners[i][1]);
+                v.SetPosition(Math::vec4(cx, 0, cy, 1));
+                v.SetUv(Math::vec2(cx / gridSize, cy / gridSize));
+                mesh.AddVertex(v);
+            }
+            tri.SetVertexIndices(base, base + 1, base + 2);
+            mesh.AddTriangle(tri);
+            tri.SetVertexIndices(base + 3, base + 4, base + 5);
+            mesh.AddTriangle(tri);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    qsort() hook for QsortCollapseMap(), equal vertices are ordered by index
+    so the lowest index of every group comes first.
+*/
+static const MeshBuilder* qsortMesh = nullptr;
+static int
+QsortVertexSorter(const void* elm0, const void* elm1)
+{
+    const IndexT i0 = *(const IndexT*)elm0;
+    const IndexT i1 = *(const IndexT*)elm1;
+    const int result = qsortMesh->VertexAt(i0).Compare(qsortMesh->VertexAt(i1));
+    if (result != 0)
+        return result;
+    return i0 < i1 ? -1 : (i0 > i1 ? 1 : 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+    The collapse map the sort based MeshBuilder::Deflate() produced before
+    welding went through a hash table, as a reference for the new one.
+*/
+static void
+QsortCollapseMap(const MeshBuilder& mesh, FixedArray<Array<IndexT>>& collapseMap)
+{
+    const SizeT numVertices = mesh.GetNumVertices();
+    FixedArray<IndexT> indexMap(numVertices);
+    FixedArray<IndexT> sortMap(numVertices);
+    FixedArray<IndexT> shiftMap(numVertices);
+    IndexT i;
+    for (i = 0; i < numVertices; i++)
+    {
+        indexMap[i] = i;
+        sortMap[i] = i;
+    }
+    qsortMesh = &mesh;
+    qsort(sortMap.Begin(), numVertices, sizeof(IndexT), QsortVertexSorter);
+
+    // runs of equal vertices collapse into the first one
+    IndexT baseIndex;
+    for (baseIndex = 0; baseIndex < numVertices - 1;)
+    {
+        IndexT nextIndex = baseIndex + 1;
+        while (nextIndex < numVertices && mesh.VertexAt(sortMap[baseIndex]) == mesh.VertexAt(sortMap[nextIndex]))
+        {
+            indexMap[sortMap[nextIndex]] = sortMap[baseIndex];
+            nextIndex++;
+        }
+        baseIndex = nextIndex;
+    }
+
+    SizeT numInvalid = 0;
+    for (i = 0; i < numVertices; i++)
+    {
+        if (indexMap[i] != i)
+            numInvalid++;
+        shiftMap[i] = numInvalid;
+    }
+
+    collapseMap.SetSize(numVertices);
+    for (i = 0; i < numVertices; i++)
+    {
+        const IndexT newIndex = indexMap[i];
+        collapseMap[newIndex - shiftMap[newIndex]].Append(i);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+MeshWeldBenchmark::MeshWeldBenchmark() :
+    gridSize(1000),
+    numThreads(8),
+    numRuns(3)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+MeshWeldBenchmark::SetCmdLineArgs(const Util::CommandLineArgs& args)
+{
+    this->gridSize = Math::max(args.GetInt("-grid", this->gridSize), 1);
+    this->numThreads = Math::max(args.GetInt("-threads", this->numThreads), 1);
+    this->numRuns = Math::max(args.GetInt("-runs", this->numRuns), 1);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+MeshWeldBenchmark::Run(Timer& timer)
+{
+    Jobs2::JobSystemInitInfo jobSystemInfo;
+    jobSystemInfo.numThreads = this->numThreads;
+    jobSystemInfo.name = "JobSystem";
+    jobSystemInfo.scratchMemorySize = 1_MB;
+    Jobs2::JobSystemInit(jobSystemInfo);
+
+    MeshBuilder source;
+    BuildGrid(source, this->gridSize);
+    const SizeT expectedVertices = (this->gridSize + 1) * (this->gridSize + 1);
+    n_printf("MeshWeldBenchmark: %d vertices, %d triangles, %d job threads\n", source.GetNumVertices(), source.GetNumTriangles(), this->numThreads);
+
+    // the sort based weld is only run once as the reference
+    Timer weldTimer;
+    FixedArray<Array<IndexT>> qsortCollapseMap;
+    weldTimer.Start();
+    QsortCollapseMap(source, qsortCollapseMap);
+    weldTimer.Stop();
+    const Time qsortTime = weldTimer.GetTime();
+
+    Time inlineTime = 0, parallelTime = 0;
+    bool identical = true;
+    timer.Start();
+    IndexT run;
+    for (run = 0; run < this->numRuns; run++)
+    {
+        // welding inside a job runs inline on that job's thread
+        MeshBuilder inlineMesh = source;
+        FixedArray<Array<IndexT>> inlineCollapseMap;
+        Threading::Event event;
+        weldTimer.Reset();
+        weldTimer.Start();
+        Jobs2::JobDispatch([mesh = &inlineMesh, collapseMap = &inlineCollapseMap](SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocationOffset)
+        {
+            mesh->Deflate(collapseMap);
+        }, 1, 1, nullptr, nullptr, &event);
+        event.Wait();
+        weldTimer.Stop();
+        Jobs2::JobNewFrame();
+        inlineTime += weldTimer.GetTime();
+
+        MeshBuilder parallelMesh = source;
+        FixedArray<Array<IndexT>> parallelCollapseMap;
+        weldTimer.Reset();
+        weldTimer.Start();
+        parallelMesh.Deflate(&parallelCollapseMap);
+        weldTimer.Stop();
+        parallelTime += weldTimer.GetTime();
+
+        n_assert(inlineMesh.GetNumVertices() == expectedVertices);
+        n_assert(parallelMesh.GetNumVertices() == expectedVertices);
+        identical &= inlineCollapseMap == parallelCollapseMap;
+        identical &= parallelCollapseMap == qsortCollapseMap;
+    }
+    timer.Stop();
+
+    n_printf("  Qsort:    %8.3f ms\n", qsortTime * 1000.0);
+    n_printf("  Inline:   %8.3f ms\n", (inlineTime / this->numRuns) * 1000.0);
+    n_printf("  Parallel: %8.3f ms\n", (parallelTime / this->numRuns) * 1000.0);
+    n_printf("  %d welded vertices, collapse maps %s\n", expectedVertices, identical ? "identical" : "DIFFER");
+    n_assert(identical);
+
+    Jobs2::JobSystemUninit();
+}
+
+} // namespace Benchmarking
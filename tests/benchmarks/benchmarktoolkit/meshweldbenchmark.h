@@ -0,0 +1,38 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Benchmarking::MeshWeldBenchmark
+
+    Measures MeshBuilder::Deflate on an unindexed grid mesh with millions of
+    vertices, once inside a single job (which welds inline) and once spread
+    over the job threads, and checks that both produce the same collapse map
+    as the sort based weld it replaced.
+
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "benchmarkbase/benchmark.h"
+#include "util/commandlineargs.h"
+
+//------------------------------------------------------------------------------
+namespace Benchmarking
+{
+class MeshWeldBenchmark : public Benchmark
+{
+    __DeclareClass(MeshWeldBenchmark);
+public:
+    /// constructor
+    MeshWeldBenchmark();
+
+    /// setup the mesh size from command line arguments
+    void SetCmdLineArgs(const Util::CommandLineArgs& args);
+    /// run the benchmark
+    virtual void Run(Timing::Timer& timer);
+
+private:
+    SizeT gridSize;
+    SizeT numThreads;
+    SizeT numRuns;
+};
+
+} // namespace Benchmarking
+//------------------------------------------------------------------------------
@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------
+//  jsonindextest.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "jsonindextest.h"
+#include "io/jsonindex.h"
+
+namespace Test
+{
+__ImplementClass(Test::JsonIndexTest, 'JIDT', Test::TestCase);
+
+using namespace IO;
+using namespace Util;
+
+//------------------------------------------------------------------------------
+/**
+*/
+static bool
+Parses(const char* json)
+{
+    JsonIndex index;
+    return index.Parse(json, (SizeT)strlen(json));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+JsonIndexTest::Run()
+{
+    // long enough to span several 64 byte blocks
+    const char* json =
+        "{\n"
+        "    \"name\": \"a \\\"quoted\\\" {string}, with [brackets]: and \\\\\",\n"
+        "    \"count\": 42,\n"
+        "    \"scale\": -1.5e2,\n"
+        "    \"visible\": true,\n"
+        "    \"parent\": null,\n"
+        "    \"empty\": {},\n"
+        "    \"position\": [1, 2.5, -3],\n"
+        "    \"children\": [ { \"id\": 1 }, { \"id\": 2, \"tags\": [\"x\", \"y\"] }, [] ],\n"
+        "    \"unicode\": \"\\u00e9\\ud83d\\ude00\",\n"
+        "    \"esc\\u0061ped\": 7\n"
+        "}";
+    JsonIndex index;
+    VERIFY(index.Parse(json, (SizeT)strlen(json)));
+
+    IndexT root = index.GetRoot();
+    VERIFY(index.IsObject(root));
+    VERIFY(index.Size(root) == 10);
+    VERIFY(index.GetString(index.FindChild(root, "name")) == "a \"quoted\" {string}, with [brackets]: and \\");
+    VERIFY(index.IsInt(index.FindChild(root, "count")));
+    VERIFY(index.GetInt64(index.FindChild(root, "count")) == 42);
+    VERIFY(index.IsDouble(index.FindChild(root, "scale")));
+    VERIFY(index.GetDouble(index.FindChild(root, "scale")) == -150.0);
+    VERIFY(index.GetInt64(index.FindChild(root, "scale")) == -150);
+    VERIFY(index.GetBool(index.FindChild(root, "visible")));
+    VERIFY(index.IsNull(index.FindChild(root, "parent")));
+    VERIFY(index.Size(index.FindChild(root, "empty")) == 0);
+    VERIFY(index.GetFirstChild(index.FindChild(root, "empty")) == InvalidIndex);
+    VERIFY(index.FindChild(root, "missing") == InvalidIndex);
+    VERIFY(index.GetString(index.FindChild(root, "unicode")) == "\xc3\xa9\xf0\x9f\x98\x80");
+    VERIFY(index.GetInt64(index.FindChild(root, "escaped")) == 7);
+
+    // strings unescaped into a builder are zero terminated and stay valid while it grows
+    StringBuilder builder(16);
+    StringView name = index.GetString(index.FindChild(root, "name"), builder);
+    VERIFY(name == "a \"quoted\" {string}, with [brackets]: and \\");
+    VERIFY(name.Data()[name.Length()] == 0);
+    StringView unicode = index.GetString(index.FindChild(root, "unicode"), builder);
+    VERIFY(unicode == "\xc3\xa9\xf0\x9f\x98\x80");
+    VERIFY(name == "a \"quoted\" {string}, with [brackets]: and \\");
+
+    // iterating and indexing children
+    IndexT position = index.FindChild(root, "position");
+    VERIFY(index.IsArray(position));
+    VERIFY(index.Size(position) == 3);
+    IndexT x = index.GetFirstChild(position);
+    IndexT y = index.GetNextSibling(x);
+    IndexT z = index.GetNextSibling(y);
+    VERIFY(index.GetDouble(x) == 1.0 && index.GetDouble(y) == 2.5 && index.GetDouble(z) == -3.0);
+    VERIFY(index.GetNextSibling(z) == InvalidIndex);
+    VERIFY(index.GetChildAt(position, 2) == z);
+    VERIFY(index.GetChildAt(position, 3) == InvalidIndex);
+
+    // nested containers are skipped as a whole
+    IndexT children = index.FindChild(root, "children");
+    VERIFY(index.Size(children) == 3);
+    IndexT second = index.GetChildAt(children, 1);
+    VERIFY(index.GetInt64(index.FindChild(second, "id")) == 2);
+    VERIFY(index.GetRaw(index.FindChild(second, "tags")) == "[\"x\", \"y\"]");
+    VERIFY(index.IsArray(index.GetNextSibling(second)));
+    IndexT childIndex;
+    VERIFY(index.FindChild(root, "children", &childIndex) == children && childIndex == 7);
+    VERIFY(index.GetKey(children) == "children");
+    VERIFY(index.GetKey(index.FindChild(root, "escaped")) == "escaped");
+
+    // scalar root values
+    VERIFY(index.Parse(" \"text\" ", 8));
+    VERIFY(index.GetString(index.GetRoot()) == "text");
+
+    // syntax errors
+    VERIFY(!Parses(""));
+    VERIFY(!Parses("{"));
+    VERIFY(!Parses("[1, 2,]"));
+    VERIFY(!Parses("{\"a\": 1,}"));
+    VERIFY(!Parses("{\"a\" 1}"));
+    VERIFY(!Parses("[1 2]"));
+    VERIFY(!Parses("[1}"));
+    VERIFY(!Parses("[tru]"));
+    VERIFY(!Parses("\"unterminated"));
+    VERIFY(!Parses("{\"a\": \"b\\\"}"));
+    VERIFY(!Parses("[] []"));
+    VERIFY(Parses("[[[[]]], {}]"));
+
+    // numbers follow the json grammar, strings may not contain raw control characters
+    VERIFY(Parses("[0, -0, 1.5, -2e10, 3E+2, 4.25e-3, 1234567890]"));
+    VERIFY(!Parses("[01]"));
+    VERIFY(!Parses("[1.]"));
+    VERIFY(!Parses("[.5]"));
+    VERIFY(!Parses("[-]"));
+    VERIFY(!Parses("[1e]"));
+    VERIFY(!Parses("[1e+]"));
+    VERIFY(!Parses("[+1]"));
+    VERIFY(!Parses("[1x]"));
+    VERIFY(!Parses("[-1-2]"));
+    VERIFY(!Parses("[\"tab\there\"]"));
+    VERIFY(!Parses("{\"new\nline\": 1}"));
+    VERIFY(Parses("[\"escaped\\ttab\"]"));
+    VERIFY(!index.Parse("[1, 2.]", 7));
+    VERIFY(Util::String(index.GetError()) == "invalid number" && index.GetErrorOffset() == 4);
+}
+
+} // namespace Test
@@ -39,6 +39,7 @@
 #include "streamservertest.h"
 #include "luaservertest.h"
 #include "zipfstest.h"
+#include "packfstest.h"
 #include "float4test.h"
 #include "matrix44test.h"
 #include "threadtest.h"
@@ -55,6 +56,10 @@
 #include "profilingtest.h"
 #include "bitfieldtest.h"
 #include "cvartest.h"
+#include "udptest.h"
+#include "tcpmessagecodectest.h"
+#include "stringviewtest.h"
+#include "jsonindextest.h"
 
 using namespace Core;
 using namespace Test;
@@ -94,6 +99,7 @@ __cdecl main()
     testRunner->AttachTestCase(Matrix44Test::Create());
     testRunner->AttachTestCase(Float4Test::Create());
     testRunner->AttachTestCase(ZipFSTest::Create());
+    testRunner->AttachTestCase(PackFSTest::Create());
     //testRunner->AttachTestCase(FileWatcherTest::Create());
     testRunner->AttachTestCase(LuaServerTest::Create());
     testRunner->AttachTestCase(StreamServerTest::Create());
@@ -101,6 +107,7 @@ __cdecl main()
     testRunner->AttachTestCase(MediaTypeTest::Create());
     testRunner->AttachTestCase(URITest::Create());
     testRunner->AttachTestCase(StringTest::Create());   
+    testRunner->AttachTestCase(StringViewTest::Create());
     testRunner->AttachTestCase(ArrayTest::Create());
     testRunner->AttachTestCase(PinnedArrayTest::Create());
     testRunner->AttachTestCase(StackArrayTest::Create());
@@ -119,12 +126,15 @@ __cdecl main()
     testRunner->AttachTestCase(MessageReaderWriterTest::Create());
     testRunner->AttachTestCase(XmlReaderWriterTest::Create());
     // testRunner->AttachTestCase(JSonReaderWriterTest::Create());
+    testRunner->AttachTestCase(JsonIndexTest::Create());
     testRunner->AttachTestCase(BinaryReaderWriterTest::Create());
     testRunner->AttachTestCase(VariantTest::Create());
     testRunner->AttachTestCase(IOInterfaceTest::Create());
     testRunner->AttachTestCase(ThreadTest::Create());
     testRunner->AttachTestCase(ArrayAllocatorTest::Create());
     testRunner->AttachTestCase(ProfilingTest::Create());
+    testRunner->AttachTestCase(UdpTest::Create());
+    testRunner->AttachTestCase(TcpMessageCodecTest::Create());
     bool result = testRunner->Run(); 
 
     gameContentServer->Discard();
@@ -0,0 +1,127 @@
+//------------------------------------------------------------------------------
+//  packfstest.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "packfstest.h"
+#include "io/ioserver.h"
+#include "io/packfs/packarchivewriter.h"
+#include "io/packfs/lz4codec.h"
+
+namespace Test
+{
+__ImplementClass(Test::PackFSTest, 'PKTS', Test::TestCase);
+
+using namespace IO;
+using namespace Util;
+
+//------------------------------------------------------------------------------
+/**
+*/
+static bool
+ReadAndCompare(const URI& uri, const unsigned char* expected, SizeT size)
+{
+    Ptr<Stream> stream = IoServer::Instance()->CreateStream(uri);
+    stream->SetAccessMode(Stream::ReadAccess);
+    if (!stream->Open())
+    {
+        return false;
+    }
+    bool result = stream->GetSize() == size;
+    if (result && size > 0)
+    {
+        const void* data = stream->Map();
+        result = memcmp(data, expected, size) == 0;
+        stream->Unmap();
+    }
+    stream->Close();
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PackFSTest::Run()
+{
+    Ptr<IoServer> ioServer = IoServer::Create();
+
+    // spans several chunks and compresses well
+    const SizeT textSize = 300 * 1024 + 17;
+    unsigned char* text = (unsigned char*)Memory::Alloc(Memory::ScratchHeap, textSize);
+    IndexT i;
+    for (i = 0; i < textSize; i++)
+    {
+        text[i] = "nebula pack archive "[(i / 3) % 20] + (i % 7 == 0);
+    }
+
+    // doesn't compress at all, ends up stored
+    const SizeT noiseSize = 100 * 1024;
+    unsigned char* noise = (unsigned char*)Memory::Alloc(Memory::ScratchHeap, noiseSize);
+    uint seed = 12345;
+    for (i = 0; i < noiseSize; i++)
+    {
+        seed = seed * 1664525 + 1013904223;
+        noise[i] = (unsigned char)(seed >> 24);
+    }
+
+    // codec roundtrip
+    SizeT bound = Lz4Codec::CompressBound(textSize);
+    unsigned char* compressed = (unsigned char*)Memory::Alloc(Memory::ScratchHeap, bound);
+    unsigned char* decompressed = (unsigned char*)Memory::Alloc(Memory::ScratchHeap, textSize);
+    SizeT compressedSize = Lz4Codec::Compress(text, textSize, compressed, bound);
+    VERIFY(compressedSize > 0 && compressedSize < textSize / 2);
+    VERIFY(Lz4Codec::Decompress(compressed, compressedSize, decompressed, textSize));
+    VERIFY(memcmp(text, decompressed, textSize) == 0);
+    VERIFY(!Lz4Codec::Decompress(compressed, compressedSize - 1, decompressed, textSize));
+    Memory::Free(Memory::ScratchHeap, compressed);
+    Memory::Free(Memory::ScratchHeap, decompressed);
+
+    // write an archive
+    Ptr<PackArchiveWriter> writer = PackArchiveWriter::Create();
+    VERIFY(writer->Open("temp:packfstest.npk"));
+    writer->AddFile("packfstest/data/text.txt", text, textSize, true);
+    writer->AddFile("packfstest/data/noise.bin", noise, noiseSize, true);
+    writer->AddFile("packfstest/data/sub/small.txt", text, 100, false);
+    writer->AddFile("packfstest/empty.txt", text, 0, true);
+    VERIFY(writer->Close());
+    VERIFY(writer->GetNumCompressedFiles() == 1);
+    VERIFY(writer->GetNumStoredFiles() == 3);
+
+    // mount it and read through the transparent archive layer
+    VERIFY(ioServer->MountArchive("temp:packfstest"));
+    VERIFY(ioServer->IsArchiveMounted("temp:packfstest"));
+    VERIFY(ioServer->FileExists("temp:packfstest/data/text.txt"));
+    VERIFY(ioServer->FileExists("temp:packfstest/data/sub/small.txt"));
+    VERIFY(!ioServer->FileExists("temp:packfstest/data/missing.txt"));
+    VERIFY(ioServer->DirectoryExists("temp:packfstest/data/sub"));
+    VERIFY(ReadAndCompare("temp:packfstest/data/text.txt", text, textSize));
+    VERIFY(ReadAndCompare("temp:packfstest/data/noise.bin", noise, noiseSize));
+    VERIFY(ReadAndCompare("temp:packfstest/data/sub/small.txt", text, 100));
+    VERIFY(ReadAndCompare("temp:packfstest/empty.txt", text, 0));
+
+    // stored files are mapped in place
+    Ptr<Stream> stream = ioServer->CreateStream("temp:packfstest/data/noise.bin");
+    stream->SetAccessMode(Stream::ReadAccess);
+    VERIFY(stream->Open());
+    VERIFY(((uintptr_t)stream->Map() % 4096) == 0);
+    stream->Unmap();
+    stream->Close();
+
+    Array<String> files = ioServer->ListFiles("temp:packfstest/data", "*");
+    VERIFY(files.Size() == 2);
+    VERIFY(InvalidIndex != files.FindIndex("text.txt"));
+    VERIFY(InvalidIndex != files.FindIndex("noise.bin"));
+    Array<String> dirs = ioServer->ListDirectories("temp:packfstest", "*");
+    VERIFY(dirs.Size() == 1);
+    VERIFY(dirs.Size() == 1 && dirs[0] == "data");
+
+    ioServer->UnmountArchive("temp:packfstest");
+    VERIFY(!ioServer->IsArchiveMounted("temp:packfstest"));
+    ioServer->DeleteFile("temp:packfstest.npk");
+
+    Memory::Free(Memory::ScratchHeap, text);
+    Memory::Free(Memory::ScratchHeap, noise);
+}
+
+} // namespace Test
@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+//  stringviewtest.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "stringviewtest.h"
+#include "util/string.h"
+#include "util/stringview.h"
+#include "util/stringbuilder.h"
+#include "math/scalar.h"
+
+namespace Test
+{
+__ImplementClass(Test::StringViewTest, 'SVWT', Test::TestCase);
+
+using namespace Util;
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+StringViewTest::Run()
+{
+    // views of strings
+    String str = "The quick brown fox";
+    StringView view = str;
+    VERIFY(view.Length() == str.Length());
+    VERIFY(view == "The quick brown fox");
+    VERIFY(view == str);
+    VERIFY(view.ExtractRange(4, 5) == "quick");
+    VERIFY(String(view.ExtractToEnd(16)) == "fox");
+    VERIFY(StringView().IsEmpty());
+
+    // comparison follows strcmp, length decides between prefixes
+    VERIFY(String::StrCmp(StringView("abc"), StringView("abd")) < 0);
+    VERIFY(String::StrCmp(StringView("abc"), StringView("ab")) > 0);
+    VERIFY(String::StrCmp(StringView("abcdef", 3), StringView("abc")) == 0);
+    VERIFY(StringView("a") < StringView("b"));
+    VERIFY(StringView("abc", 2) != "abc");
+    VERIFY(StringView("bla").HashCode() == String("bla").HashCode());
+
+    // searching
+    VERIFY(view.FindStringIndex("quick") == 4);
+    VERIFY(view.FindStringIndex("o", 13) == 17);
+    VERIFY(view.FindStringIndex("slow") == InvalidIndex);
+    VERIFY(view.FindCharIndex('b') == 10);
+    VERIFY(view.FindCharIndex('x', 19) == InvalidIndex);
+    VERIFY(view.BeginsWithString("The"));
+    VERIFY(view.EndsWithString("fox"));
+    VERIFY(str.FindStringIndex(StringView("brown fox jumps", 9)) == 10);
+
+    // tokenize into views, empty tokens are skipped like String::Tokenize
+    str = " This is, a\ttest  ";
+    Array<StringView> tokens;
+    VERIFY(str.Tokenize(" ,\t", tokens) == 4);
+    VERIFY(tokens[0] == "This");
+    VERIFY(tokens[1] == "is");
+    VERIFY(tokens[2] == "a");
+    VERIFY(tokens[3] == "test");
+    VERIFY(tokens[3].Data() == str.AsCharPtr() + 12);
+    Array<String> stringTokens;
+    VERIFY(str.Tokenize(" ,\t", stringTokens) == tokens.Size());
+    VERIFY(StringView("").Tokenize(" ", tokens) == 0);
+    VERIFY(StringView(" ,\t ").Tokenize(" ,\t", tokens) == 0);
+
+    // trimming and conversion
+    VERIFY(StringView(" ..*Bla Blub*.. ").Trim(" .*") == "Bla Blub");
+    VERIFY(StringView("1234,5", 4).AsInt() == 1234);
+    VERIFY(Math::fequal(StringView("0.5 1.0", 3).AsFloat(), 0.5f, 0.0001f));
+
+    // builder, strings are zero terminated and survive chunk changes
+    StringBuilder builder(32);
+    Array<StringView> built;
+    IndexT i;
+    for (i = 0; i < 100; i++)
+    {
+        builder.Begin();
+        builder.Append("entry");
+        builder.AppendChar('_');
+        builder.AppendInt(i);
+        built.Append(builder.End());
+    }
+    bool builtValid = true;
+    for (i = 0; i < 100; i++)
+    {
+        String expected = String::Sprintf("entry_%d", i);
+        builtValid &= (built[i] == expected) && (built[i].Data()[built[i].Length()] == 0);
+    }
+    VERIFY(builtValid);
+    VERIFY(builder.GetNumChunks() > 1);
+
+    // strings larger than a chunk get their own chunk
+    StringView large = builder.Add("a string which is longer than the 32 byte chunks of this builder");
+    VERIFY(large == "a string which is longer than the 32 byte chunks of this builder");
+    VERIFY(builder.GetUsedSize() > 0);
+
+    // reset reuses the chunks
+    SizeT numChunks = builder.GetNumChunks();
+    builder.Reset();
+    VERIFY(builder.GetUsedSize() == 0);
+    for (i = 0; i < 100; i++)
+    {
+        builder.Add("entry");
+    }
+    VERIFY(builder.GetNumChunks() == numChunks);
+    builder.Discard();
+    VERIFY(builder.GetNumChunks() == 0);
+}
+
+} // namespace Test
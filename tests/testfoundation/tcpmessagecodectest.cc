@@ -0,0 +1,187 @@
+//------------------------------------------------------------------------------
+//  tcpmessagecodectest.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "tcpmessagecodectest.h"
+#include "net/tcpmessagecodec.h"
+#include "io/memorystream.h"
+
+namespace Test
+{
+__ImplementClass(Test::TcpMessageCodecTest, 'TMCT', Test::TestCase);
+
+using namespace Net;
+
+//------------------------------------------------------------------------------
+/**
+*/
+static void
+FillMessage(uchar* ptr, SizeT size, uint seed)
+{
+    IndexT i;
+    for (i = 0; i < size; i++)
+    {
+        ptr[i] = (uchar)(seed * 31 + i);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static bool
+CheckMessage(const TcpMessageView& view, SizeT size, uint seed)
+{
+    if (!view.IsValid() || view.GetSize() != size)
+    {
+        return false;
+    }
+    IndexT i;
+    for (i = 0; i < size; i++)
+    {
+        if (view.GetData()[i] != (uchar)(seed * 31 + i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static void
+Concat(TcpMessageCodec& codec, Util::Array<uchar>& outData)
+{
+    Util::Array<Ptr<TcpSendBuffer>> buffers;
+    codec.TakeSendBuffers(buffers);
+    IndexT i;
+    for (i = 0; i < buffers.Size(); i++)
+    {
+        IndexT j;
+        for (j = 0; j < buffers[i]->GetSize(); j++)
+        {
+            outData.Append(buffers[i]->GetData()[j]);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TcpMessageCodecTest::Run()
+{
+    const SizeT NumMessages = 200;
+    TcpMessageCodec sender;
+    TcpMessageCodec receiver;
+
+    // small messages and messages larger than a slab
+    Util::Array<SizeT> sizes;
+    IndexT i;
+    for (i = 0; i < NumMessages; i++)
+    {
+        const SizeT size = (i % 50 == 49) ? TcpMessageCodec::SlabSize + 1000 * i : (i * 97) % 3000;
+        sizes.Append(size);
+        FillMessage(sender.BeginMessage(size), size, i);
+    }
+    Util::Array<uchar> stream;
+    Concat(sender, stream);
+    VERIFY(sender.GetNumSlabs() > 1);
+
+    // feed the stream in odd chunk sizes, so frames and headers are cut everywhere
+    bool allValid = true;
+    IndexT numReceived = 0;
+    IndexT offset = 0;
+    IndexT chunk = 0;
+    while (offset < stream.Size())
+    {
+        const SizeT chunkSize = Math::min(1 + (chunk++ * 7919) % 20000, stream.Size() - offset);
+        receiver.Decode(&stream[offset], chunkSize);
+        offset += chunkSize;
+
+        TcpMessageView view;
+        while (receiver.DequeueMessage(view))
+        {
+            allValid &= CheckMessage(view, sizes[numReceived], numReceived);
+            numReceived++;
+        }
+    }
+    VERIFY(allValid);
+    VERIFY(numReceived == NumMessages);
+    VERIFY(receiver.GetNumMessages() == 0);
+
+    // once released, slabs are recycled instead of allocating new ones, the slabs of the large messages are freed
+    const SizeT numSenderSlabs = sender.GetNumSlabs();
+    const SizeT numReceiverSlabs = receiver.GetNumSlabs();
+    SizeT numRecycledSenderSlabs = 0;
+    SizeT numRecycledReceiverSlabs = 0;
+    IndexT round;
+    for (round = 0; round < 20; round++)
+    {
+        if (round == 10)
+        {
+            numRecycledSenderSlabs = sender.GetNumSlabs();
+            numRecycledReceiverSlabs = receiver.GetNumSlabs();
+        }
+        for (i = 0; i < NumMessages; i++)
+        {
+            sender.Encode(&stream[0], 64);
+        }
+        Util::Array<Ptr<TcpSendBuffer>> buffers;
+        sender.TakeSendBuffers(buffers);
+        for (i = 0; i < buffers.Size(); i++)
+        {
+            receiver.Decode(buffers[i]->GetData(), buffers[i]->GetSize());
+        }
+        TcpMessageView view;
+        while (receiver.DequeueMessage(view))
+        {
+            numReceived++;
+        }
+    }
+    VERIFY(numReceived == NumMessages * 21);
+    VERIFY(sender.GetNumSlabs() < numSenderSlabs);
+    VERIFY(receiver.GetNumSlabs() < numReceiverSlabs);
+    VERIFY(sender.GetNumSlabs() == numRecycledSenderSlabs);
+    VERIFY(receiver.GetNumSlabs() == numRecycledReceiverSlabs);
+
+    // a view keeps its slab alive while the codec moves on
+    const uchar payload[] = { 1, 2, 3, 4 };
+    sender.Encode(payload, sizeof(payload));
+    Util::Array<Ptr<TcpSendBuffer>> buffers;
+    VERIFY(sender.TakeSendBuffers(buffers));
+    VERIFY(!sender.TakeSendBuffers(buffers));
+    receiver.Decode(buffers[0]->GetData(), buffers[0]->GetSize());
+    TcpMessageView held;
+    VERIFY(receiver.DequeueMessage(held));
+    for (i = 0; i < NumMessages; i++)
+    {
+        sender.Encode(&stream[0], 1024);
+    }
+    buffers.Clear();
+    sender.TakeSendBuffers(buffers);
+    for (i = 0; i < buffers.Size(); i++)
+    {
+        receiver.Decode(buffers[i]->GetData(), buffers[i]->GetSize());
+    }
+    VERIFY(held.GetSize() == sizeof(payload) && memcmp(held.GetData(), payload, sizeof(payload)) == 0);
+    held.Release();
+
+    // the stream based interface is compatible
+    Ptr<IO::MemoryStream> message = IO::MemoryStream::Create();
+    message->SetAccessMode(IO::Stream::WriteAccess);
+    message->Open();
+    message->Write(payload, sizeof(payload));
+    message->Close();
+    Ptr<IO::MemoryStream> framed = IO::MemoryStream::Create();
+    sender.EncodeToMessage(message.upcast<IO::Stream>(), framed.upcast<IO::Stream>());
+    VERIFY(framed->GetSize() == TcpMessageCodec::HeaderSize + sizeof(payload));
+    TcpMessageCodec streamReceiver;
+    streamReceiver.DecodeStream(framed.upcast<IO::Stream>());
+    VERIFY(streamReceiver.HasMessages());
+    Util::Array<Ptr<IO::Stream>> messages = streamReceiver.DequeueMessages();
+    VERIFY(messages.Size() == 1 && messages[0]->GetSize() == sizeof(payload));
+}
+
+} // namespace Test
@@ -0,0 +1,223 @@
+//------------------------------------------------------------------------------
+//  udptest.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "udptest.h"
+#include "net/socket/socket.h"
+#include "net/udp/packetpool.h"
+#include "net/udp/reliablechannel.h"
+#include "timing/time.h"
+
+namespace Test
+{
+__ImplementClass(Test::UdpTest, 'UDPT', Test::TestCase);
+
+using namespace Net;
+
+//------------------------------------------------------------------------------
+/**
+*/
+static Ptr<Socket>
+OpenSocket()
+{
+    Ptr<Socket> socket = Socket::Create();
+    if (!socket->Open(Socket::UDP))
+    {
+        return nullptr;
+    }
+    socket->SetAddress(IpAddress("127.0.0.1", 0));
+    if (!socket->Bind())
+    {
+        return nullptr;
+    }
+    socket->SetBlocking(false);
+    return socket;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Wait a bit for a datagram, loopback delivery is usually immediate.
+*/
+static Socket::Result
+PollRecvFrom(const Ptr<Socket>& socket, void* buf, SizeT bufSize, uint& addr, ushort& port, SizeT& bytesReceived)
+{
+    Socket::Result res = Socket::WouldBlock;
+    IndexT i;
+    for (i = 0; i < 1000 && res == Socket::WouldBlock; i++)
+    {
+        res = socket->RecvFrom(buf, bufSize, addr, port, bytesReceived);
+        if (res == Socket::WouldBlock)
+        {
+            Timing::Sleep(0.001);
+        }
+    }
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Pass everything waiting at the socket to the channel, dropping every
+    dropRate-th datagram.
+*/
+static void
+Pump(const Ptr<Socket>& socket, const Ptr<ReliableChannel>& channel, IndexT dropRate, IndexT& counter)
+{
+    uchar buf[PacketPool::DefaultPacketSize];
+    uint addr;
+    ushort port;
+    SizeT bytesReceived;
+    while (Socket::Success == socket->RecvFrom(buf, sizeof(buf), addr, port, bytesReceived))
+    {
+        if ((++counter % dropRate) != 0)
+        {
+            channel->ProcessPacket(buf, bytesReceived);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+UdpTest::Run()
+{
+    Ptr<Socket> a = OpenSocket();
+    Ptr<Socket> b = OpenSocket();
+    VERIFY(a.isvalid() && b.isvalid());
+    if (!a.isvalid() || !b.isvalid())
+    {
+        return;
+    }
+    const uint loopback = a->GetAddress().GetAddr();
+    VERIFY(loopback == 0x7f000001);
+    VERIFY(a->GetAddress().GetPort() != 0);
+    VERIFY(a->GetAddress().GetPort() != b->GetAddress().GetPort());
+
+    // single datagram
+    const char* hello = "hello datagram";
+    SizeT bytesSent = 0;
+    VERIFY(Socket::Success == a->SendTo(hello, 15, loopback, b->GetAddress().GetPort(), bytesSent));
+    VERIFY(15 == bytesSent);
+    char buf[64];
+    uint addr = 0;
+    ushort port = 0;
+    SizeT bytesReceived = 0;
+    VERIFY(Socket::Success == PollRecvFrom(b, buf, sizeof(buf), addr, port, bytesReceived));
+    VERIFY(15 == bytesReceived);
+    VERIFY(0 == strcmp(buf, hello));
+    VERIFY(addr == loopback);
+    VERIFY(port == a->GetAddress().GetPort());
+    VERIFY(Socket::WouldBlock == b->RecvFrom(buf, sizeof(buf), addr, port, bytesReceived));
+
+    // batches from a packet pool
+    const SizeT NumPackets = 32;
+    Ptr<PacketPool> pool = PacketPool::Create();
+    pool->Setup(NumPackets * 2, 64);
+    VERIFY(pool->GetNumFree() == NumPackets * 2);
+    Socket::Datagram sendBatch[NumPackets];
+    Socket::Datagram* sendPackets[NumPackets];
+    Socket::Datagram* recvPackets[NumPackets];
+    Socket::Datagram recvBatch[NumPackets];
+    IndexT i;
+    for (i = 0; i < NumPackets; i++)
+    {
+        Socket::Datagram* packet = pool->Alloc();
+        *(uint*)packet->buf = i;
+        packet->numBytes = sizeof(uint) + i;
+        packet->addr = loopback;
+        packet->port = b->GetAddress().GetPort();
+        sendBatch[i] = *packet;
+        sendPackets[i] = packet;
+        recvPackets[i] = pool->Alloc();
+        recvBatch[i] = *recvPackets[i];
+    }
+    VERIFY(pool->GetNumFree() == 0);
+    VERIFY(pool->Alloc() == nullptr);
+
+    SizeT numSent = 0;
+    VERIFY(Socket::Success == a->SendBatch(sendBatch, NumPackets, numSent));
+    VERIFY(NumPackets == numSent);
+    SizeT numReceived = 0;
+    IndexT tries;
+    for (tries = 0; tries < 1000 && numReceived < NumPackets; tries++)
+    {
+        SizeT batchReceived = 0;
+        if (Socket::Success == b->RecvBatch(recvBatch + numReceived, NumPackets - numReceived, batchReceived))
+            numReceived += batchReceived;
+        else
+            Timing::Sleep(0.001);
+    }
+    VERIFY(NumPackets == numReceived);
+    bool inOrder = true;
+    for (i = 0; i < numReceived; i++)
+    {
+        inOrder &= (*(uint*)recvBatch[i].buf == (uint)i) && (recvBatch[i].numBytes == sizeof(uint) + i);
+        inOrder &= (recvBatch[i].port == a->GetAddress().GetPort());
+    }
+    VERIFY(inOrder);
+    for (i = 0; i < NumPackets; i++)
+    {
+        pool->Free(sendPackets[i]);
+        pool->Free(recvPackets[i]);
+    }
+    VERIFY(pool->GetNumFree() == NumPackets * 2);
+
+    // reliable channel, losing every third datagram in either direction
+    Ptr<ReliableChannel> sender = ReliableChannel::Create();
+    Ptr<ReliableChannel> receiver = ReliableChannel::Create();
+    sender->Setup(a, loopback, b->GetAddress().GetPort());
+    receiver->Setup(b, loopback, a->GetAddress().GetPort());
+    const SizeT NumMessages = 1000;
+    IndexT numQueued = 0;
+    IndexT numDelivered = 0;
+    IndexT counterA = 0, counterB = 0;
+    SizeT maxUnacked = 0;
+    bool ordered = true;
+    Timing::Time time = 0;
+    for (tries = 0; tries < 10000 && numDelivered < NumMessages; tries++)
+    {
+        while (numQueued < NumMessages && sender->Send(&numQueued, sizeof(numQueued)))
+        {
+            numQueued++;
+        }
+        maxUnacked = Math::max(maxUnacked, sender->GetNumUnacked());
+        time += 0.05;
+        sender->Update(time);
+        Pump(b, receiver, 3, counterB);
+        receiver->Update(time);
+        Pump(a, sender, 3, counterA);
+
+        Util::Blob message;
+        while (receiver->Recv(message))
+        {
+            ordered &= (message.Size() == sizeof(IndexT)) && (*(IndexT*)message.GetPtr() == numDelivered);
+            numDelivered++;
+        }
+    }
+    VERIFY(NumMessages == numDelivered);
+    VERIFY(ordered);
+
+    // the window has been full, so messages far beyond the latest ack have been acknowledged too
+    VERIFY(ReliableChannel::WindowSize == maxUnacked);
+    VERIFY(sender->GetNumResent() > 0);
+
+    // the last acks might still be in flight
+    for (tries = 0; tries < 100 && sender->GetNumUnacked() > 0; tries++)
+    {
+        time += 0.05;
+        sender->Update(time);
+        Pump(b, receiver, 3, counterB);
+        receiver->Update(time);
+        Pump(a, sender, 3, counterA);
+    }
+    VERIFY(0 == sender->GetNumUnacked());
+
+    sender->Discard();
+    receiver->Discard();
+    pool->Discard();
+    a->Close();
+    b->Close();
+}
+
+} // namespace Test
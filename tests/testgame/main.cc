@@ -14,6 +14,7 @@
 #include "databasetest.h"
 #include "entitysystemtest.h"
 #include "scriptingtest.h"
+#include "replicationtest.h"
 
 #include "testcomponents.h"
 
@@ -52,8 +53,8 @@ private:
             .OnInit = &InitializeTestVec4
         });
         
-        Game::RegisterType<TestStruct>();
-        Game::RegisterType<TestHealth>();
+        Game::RegisterType<TestStruct>({ .replicate = true });
+        Game::RegisterType<TestHealth>({ .replicate = true });
         Game::RegisterType<MyFlag>();
         Game::RegisterType<TestEmptyStruct>();
         Game::RegisterType<TestAsyncComponent>();
@@ -94,6 +95,7 @@ NebulaMain(const Util::CommandLineArgs& args)
     testRunner->AttachTestCase(IdTest::Create());
     testRunner->AttachTestCase(DatabaseTest::Create());
     testRunner->AttachTestCase(EntitySystemTest::Create());
+    testRunner->AttachTestCase(ReplicationTest::Create());
     //testRunner->AttachTestCase(ScriptingTest::Create());
     
     bool result = testRunner->Run(); 
@@ -0,0 +1,265 @@
+//------------------------------------------------------------------------------
+//  replicationtest.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "replicationtest.h"
+#include "game/world.h"
+#include "game/api.h"
+#include "game/replication/bitpacker.h"
+#include "game/replication/deltacodec.h"
+#include "game/replication/replicationserver.h"
+#include "game/replication/replicationclient.h"
+#include "memdb/attributeregistry.h"
+#include "basegamefeature/components/position.h"
+#include "timing/time.h"
+#include "testcomponents.h"
+
+using namespace Game;
+
+namespace Test
+{
+
+__ImplementClass(Test::ReplicationTest, 'RPLT', Test::TestCase);
+
+//------------------------------------------------------------------------------
+/**
+*/
+static bool
+Roundtrip(
+    const ReplicationSnapshot& current,
+    Util::Array<uint64_t>* currentMask,
+    const ReplicationSnapshot* baseline,
+    const Util::Array<uint64_t>* baselineMask,
+    const ReplicationSnapshot* clientBaseline,
+    ReplicationSnapshot& result,
+    SizeT& numBytes)
+{
+    Util::Array<BitWriter> packets;
+    DeltaCodec::Encode(current, currentMask, baseline, baselineMask, 256, packets);
+    Util::FixedArray<Util::Blob> blobs(packets.Size());
+    numBytes = 0;
+    IndexT i;
+    for (i = 0; i < packets.Size(); i++)
+    {
+        blobs[i].Reserve(packets[i].GetNumBytes());
+        packets[i].CopyTo(blobs[i].GetPtr());
+        numBytes += packets[i].GetNumBytes();
+    }
+    return DeltaCodec::Decode(blobs.Begin(), blobs.Size(), clientBaseline, result);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ReplicationTest::Run()
+{
+    // bit packing
+    BitWriter writer;
+    writer.Write(5, 3);
+    writer.WriteBool(true);
+    writer.Write(0xDEADBEEF, 32);
+    writer.Write(0x1234, 13);
+    VERIFY(writer.GetNumBits() == 49);
+    VERIFY(writer.GetNumBytes() == 7);
+    uint8_t bytes[7];
+    writer.CopyTo(bytes);
+    BitReader reader(bytes, sizeof(bytes));
+    VERIFY(reader.Read(3) == 5);
+    VERIFY(reader.ReadBool());
+    VERIFY(reader.Read(32) == 0xDEADBEEF);
+    VERIFY(reader.Read(13) == (0x1234 & 0x1FFF));
+    VERIFY(!reader.HasOverflow());
+    reader.Read(16);
+    VERIFY(reader.HasOverflow());
+
+    // quantization
+    ComponentInterface::FieldQuantization quantization = { -100.0f, 100.0f, 16 };
+    float value = 12.345f;
+    uint32_t word;
+    Memory::Copy(&value, &word, sizeof(float));
+    word = ReplicationSnapshot::DequantizeWord(ReplicationSnapshot::QuantizeWord(word, quantization), quantization);
+    float dequantized;
+    Memory::Copy(&word, &dequantized, sizeof(float));
+    VERIFY(Math::abs(dequantized - value) <= 200.0f / 65535.0f);
+
+    // setup replicated entities in a grid of 8x8 cells, away from the entities of other tests
+    World* world = Game::GetWorld(WORLD_DEFAULT);
+    ComponentId const structId = GetComponentId<TestStruct>();
+    ComponentId const healthId = GetComponentId<TestHealth>();
+    ComponentInterface* structInterface = static_cast<ComponentInterface*>(MemDb::AttributeRegistry::GetAttribute(structId));
+    structInterface->SetFieldQuantization(0, -100.0f, 100.0f, 16);
+    VERIFY(structInterface->IsReplicated());
+
+    EntityTableCreateInfo info;
+    info.name = "ReplicationTest";
+    info.components = { structId, healthId };
+    MemDb::TableId const table = world->CreateEntityTable(info);
+
+    const float CellSize = 10.0f;
+    const float Origin = 1000.0f;
+    const SizeT NumEntities = 64;
+    Util::Array<Entity> entities;
+    IndexT i;
+    for (i = 0; i < NumEntities; i++)
+    {
+        Entity entity = world->AllocateEntity();
+        world->AllocateInstance(entity, table);
+        world->SetComponent<Position>(entity, Math::vec3(Origin + (i % 8) * CellSize + 1.0f, 0.0f, Origin + (i / 8) * CellSize + 1.0f));
+        TestStruct testStruct = world->GetComponent<TestStruct>(entity);
+        testStruct.pos = Math::vec3(i * 0.5f, -i * 0.25f, 3.0f);
+        world->SetComponent<TestStruct>(entity, testStruct);
+        world->SetComponent<TestHealth>(entity, { (uint)i * 10 });
+        entities.Append(entity);
+    }
+
+    // full update
+    ReplicationSnapshot server0, server1, server2;
+    ReplicationSnapshot client0, client1, client2;
+    server0.Capture(world, 0, CellSize, nullptr);
+    VERIFY(server0.records.Size() >= NumEntities);
+    SizeT fullBytes = 0;
+    VERIFY(Roundtrip(server0, nullptr, nullptr, nullptr, nullptr, client0, fullBytes));
+    VERIFY(client0.records.Size() == server0.records.Size());
+    bool valuesMatch = true;
+    for (i = 0; i < NumEntities; i++)
+    {
+        const IndexT record = client0.FindRecord((Ids::Id32)entities[i]);
+        TestStruct testStruct;
+        TestHealth health;
+        valuesMatch &= record != InvalidIndex;
+        valuesMatch &= client0.ReadComponent(record, structId, &testStruct);
+        valuesMatch &= client0.ReadComponent(record, healthId, &health);
+        valuesMatch &= health.value == (uint)i * 10;
+        valuesMatch &= Math::abs(testStruct.pos.x - i * 0.5f) <= 200.0f / 65535.0f;
+        valuesMatch &= Math::abs(testStruct.pos.y + i * 0.25f) <= 200.0f / 65535.0f;
+    }
+    VERIFY(valuesMatch);
+
+    // only modified rows are captured, the delta only contains the changed entity
+    world->SetComponent<TestHealth>(entities[3], { 1 });
+    world->MarkAsModified(entities[3]);
+    world->SetComponent<TestHealth>(entities[4], { 2 });
+    server1.Capture(world, 1, CellSize, &server0);
+    SizeT deltaBytes = 0;
+    VERIFY(Roundtrip(server1, nullptr, &server0, nullptr, &client0, client1, deltaBytes));
+    VERIFY(deltaBytes < fullBytes / 10);
+    TestHealth health;
+    VERIFY(client1.ReadComponent(client1.FindRecord((Ids::Id32)entities[3]), healthId, &health) && health.value == 1);
+    VERIFY(client1.ReadComponent(client1.FindRecord((Ids::Id32)entities[4]), healthId, &health) && health.value == 40);
+    VERIFY(client1.records.Size() == client0.records.Size());
+
+    // interest management, only the 3x3 cells around the first entity are relevant
+    server2.Capture(world, 2, CellSize, &server1);
+    const uint32_t center = ReplicationSnapshot::PackCell(Math::vec3(Origin + 1.0f, 0.0f, Origin + 1.0f), CellSize);
+    Util::Array<uint64_t> mask;
+    mask.Resize((server2.records.Size() + 63) / 64, 0ull);
+    SizeT numRelevant = 0;
+    for (i = 0; i < server2.records.Size(); i++)
+    {
+        if (ReplicationSnapshot::InRange(server2.records[i].cell, center, 1))
+        {
+            mask[i / 64] |= 1ull << (i % 64);
+            numRelevant++;
+        }
+    }
+    VERIFY(numRelevant == 4);
+    VERIFY(Roundtrip(server2, &mask, &server1, nullptr, &client1, client2, deltaBytes));
+    VERIFY(client2.records.Size() == numRelevant);
+    VERIFY(client2.FindRecord((Ids::Id32)entities[0]) != InvalidIndex);
+    VERIFY(client2.FindRecord((Ids::Id32)entities[63]) == InvalidIndex);
+
+    // a created entity with an unknown component is dropped
+    ReplicationSnapshot rejected;
+    BitWriter bogus;
+    bogus.WriteBool(true);
+    bogus.Write(0, 2);
+    bogus.Write(1, 6);
+    bogus.Write(1, 2);
+    bogus.Write(1, 8);
+    bogus.Write(0xFFFE, 16);
+    bogus.WriteBool(false);
+    Util::Blob bogusBlob;
+    bogusBlob.Reserve(bogus.GetNumBytes());
+    bogus.CopyTo(bogusBlob.GetPtr());
+    VERIFY(!DeltaCodec::Decode(&bogusBlob, 1, nullptr, rejected));
+
+    // so is one which claims more components than the packet holds
+    bogus.Clear();
+    bogus.WriteBool(true);
+    bogus.Write(0, 2);
+    bogus.Write(1, 6);
+    bogus.Write(1, 2);
+    bogus.Write(255, 8);
+    bogus.Write(healthId.id, 16);
+    bogus.WriteBool(false);
+    bogusBlob.Reserve(bogus.GetNumBytes());
+    bogus.CopyTo(bogusBlob.GetPtr());
+    VERIFY(!DeltaCodec::Decode(&bogusBlob, 1, nullptr, rejected));
+
+    // records which don't fit into a packet are dropped from the mask, the receiver removes the ones it had
+    Util::Array<uint64_t> baselineMask;
+    baselineMask.Resize((server0.records.Size() + 63) / 64, 0ull);
+    for (i = 0; i < server0.records.Size(); i++)
+    {
+        baselineMask[i / 64] |= 1ull << (i % 64);
+    }
+    Util::Array<uint64_t> droppedMask = baselineMask;
+    Util::Array<BitWriter> tinyPackets;
+    // 5 byte packets only have room for the 2 bits of a removal
+    VERIFY(DeltaCodec::Encode(server1, &droppedMask, &server0, &baselineMask, 5, tinyPackets) == 1);
+    const IndexT changed = server1.FindRecord((Ids::Id32)entities[3]);
+    VERIFY(!DeltaCodec::IsRelevant(&droppedMask, changed));
+    VERIFY(DeltaCodec::IsRelevant(&droppedMask, server1.FindRecord((Ids::Id32)entities[5])));
+
+    // server and client over the loopback interface
+    Ptr<ReplicationServer> server = ReplicationServer::Create();
+    Ptr<ReplicationClient> client = ReplicationClient::Create();
+    VERIFY(server->Open(world, Net::IpAddress("127.0.0.1", 0)));
+    VERIFY(client->Open(Net::IpAddress("127.0.0.1", 0)));
+    if (server->IsOpen() && client->IsOpen())
+    {
+        server->SetCellSize(CellSize);
+        IndexT clientId = server->AddClient(client->GetSocket()->GetAddress().GetAddr(), client->GetSocket()->GetAddress().GetPort());
+        server->Update();
+        VERIFY(server->GetStats().numFullUpdates == 1);
+        for (i = 0; i < 1000 && client->GetTick() != 0; i++)
+        {
+            Timing::Sleep(0.001);
+            client->Update();
+        }
+        VERIFY(client->GetTick() == 0);
+        VERIFY(client->ReadComponent<TestHealth>(entities[5], health) && health.value == 50);
+
+        world->SetComponent<TestHealth>(entities[5], { 7 });
+        world->MarkAsModified(entities[5]);
+        for (i = 0; i < 1000 && server->GetClientAckedTick(clientId) != 0; i++)
+        {
+            Timing::Sleep(0.001);
+            server->Update();
+        }
+        VERIFY(server->GetClientAckedTick(clientId) == 0);
+        server->Update();
+        VERIFY(server->GetStats().numFullUpdates == 0);
+        const uint32_t tick = server->GetTick() - 1;
+        for (i = 0; i < 1000 && client->GetTick() != tick; i++)
+        {
+            Timing::Sleep(0.001);
+            client->Update();
+        }
+        VERIFY(client->GetTick() == tick);
+        VERIFY(client->ReadComponent<TestHealth>(entities[5], health) && health.value == 7);
+    }
+    if (server->IsOpen())
+        server->Close();
+    if (client->IsOpen())
+        client->Close();
+
+    for (i = 0; i < entities.Size(); i++)
+    {
+        world->DeleteEntity(entities[i]);
+    }
+}
+
+} // namespace Test
@@ -7,6 +7,8 @@
 #include "coreanimation/animcurve.h"
 #include "timing/time.h"
 #include "coreanimation/animation.h"
+#include "coreanimation/animcompression.h"
+#include "coreanimation/naxfileformatstructs.h"
 #include "animtest.h"
 namespace Test
 {
@@ -134,6 +136,60 @@ AnimTest::Run()
     VERIFY(value[7] == 0.0f);
     VERIFY(value[8] == 0.0f);
     VERIFY(value[9] == 1.0f);
+
+    // Quantized rotations come back within the precision of 15 bits per component
+    const Math::quat rotation = Math::normalize(Math::quat(0.1f, -0.7f, 0.3f, 0.6f));
+    ushort packedRotation[3];
+    float rotationValues[4];
+    rotation.storeu(rotationValues);
+    AnimPackQuaternion(rotationValues, packedRotation);
+    const Math::quat unpackedRotation = AnimUnpackQuaternion(packedRotation);
+    VERIFY(Math::abs(Math::dot(rotation, unpackedRotation)) > 0.99999f);
+
+    // Compressed clip with one segment holding two translation keys, 0, 1, 2 and 2, 3, 4 at 0 and 24
+    float rangeMin[4] = { 0, 1, 2, 0 };
+    float rangeExtent[3] = { 2, 2, 2 };
+    float key0[4] = { 0, 1, 2, 0 };
+    float key1[4] = { 2, 3, 4, 0 };
+    ushort segmentData[2 + 2 + 6] = { 2, 0, 0, 24 };
+    AnimPackRange(key0, rangeMin, rangeExtent, segmentData + 4);
+    AnimPackRange(key1, rangeMin, rangeExtent, segmentData + 7);
+    NaxcSegment segment = { 0, 24, 0, 2 };
+
+    Ptr<AnimCompressedBuffer> compressedBuffer = AnimCompressedBuffer::Create();
+    compressedBuffer->Setup(2, 1, sizeof(segmentData), &segment, segmentData);
+    Memory::Copy(rangeMin, compressedBuffer->GetCurveRange(0).min, sizeof(rangeMin));
+    Memory::Copy(rangeExtent, compressedBuffer->GetCurveRange(0).extent, sizeof(rangeExtent));
+
+    AnimCurve compressedCurve = posCurve;
+    compressedCurve.numIntervals = 1;
+    Util::FixedArray<AnimCurve> compressedCurves = { compressedCurve, nullScale };
+    AnimClip compressedClip;
+    compressedClip.numCurves = 2;
+    compressedClip.duration = 24;
+    compressedClip.numSegments = 1;
+    compressedClip.segmentDuration = 24;
+
+    // Halfway between the keys, the dead scale curve takes the idle sample
+    AnimSampleCompressedLinear(compressedClip, compressedCurves, 12, Math::vec4{ 1 }, idleSamples, compressedBuffer, value, count);
+    VERIFY(Math::abs(value[0] - 1.0f) < 0.001f);
+    VERIFY(Math::abs(value[1] - 2.0f) < 0.001f);
+    VERIFY(Math::abs(value[2] - 3.0f) < 0.001f);
+    VERIFY(value[3] == 1.0f);
+    VERIFY(count[0] == 1);
+    VERIFY(count[1] == 0);
+
+    AnimSampleCompressedStep(compressedClip, compressedCurves, 23, Math::vec4{ 1 }, idleSamples, compressedBuffer, value, count);
+    VERIFY(Math::abs(value[0] - 0.0f) < 0.001f);
+    VERIFY(Math::abs(value[2] - 2.0f) < 0.001f);
+
+    // Curves of masked joints keep the last sampled value
+    AnimSampleMask jointMask;
+    jointMask.weights = { 0.0f };
+    AnimSampleCompressedLinear(compressedClip, compressedCurves, 12, Math::vec4{ 1 }, idleSamples, compressedBuffer, value, count, &jointMask);
+    VERIFY(Math::abs(value[0] - 0.0f) < 0.001f);
+    VERIFY(Math::abs(value[2] - 2.0f) < 0.001f);
+    VERIFY(count[0] == 1);
 }
 
 } // namespace Test
@@ -6,6 +6,9 @@
 #include "zipstresstestapplication.h"
 #include "threading/thread.h"
 #include "io/stream.h"
+#include "io/ioserver.h"
+#include "timing/timer.h"
+#include "system/systeminfo.h"
 
 namespace App
 {
@@ -19,13 +22,20 @@ class ReaderThread : public Threading::Thread
     __DeclareClass(ReaderThread);
 public:
     /// constructor
-    ReaderThread() : loopCount(0) {};
-    /// setup the directory and file pattern
-    void Setup(SizeT loopCount_, const String& path_, const String& pattern_)
+    ReaderThread() : loopCount(0), first(0), stride(1), bytesRead(0) {};
+    /// setup the files to read, the thread reads every stride'th file starting at first
+    void Setup(SizeT loopCount_, const Array<URI>& files_, IndexT first_, SizeT stride_)
     {
         this->loopCount = loopCount_;
-        this->path = path_;
-        this->pattern = pattern_;
+        this->files = files_;
+        this->first = first_;
+        this->stride = stride_;
+        this->bytesRead = 0;
+    };
+    /// get number of decompressed bytes
+    Stream::Size GetBytesRead() const
+    {
+        return this->bytesRead;
     };
 
 protected:
@@ -34,8 +44,10 @@ protected:
 
 private:
     SizeT loopCount;
-    String path;
-    String pattern;
+    Array<URI> files;
+    IndexT first;
+    SizeT stride;
+    Stream::Size bytesRead;
 };
 __ImplementClass(App::ReaderThread, 'RTHR', Threading::Thread);
 
@@ -45,28 +57,28 @@ __ImplementClass(App::ReaderThread, 'RTHR', Threading::Thread);
 void
 ReaderThread::DoWork()
 {
-    // create an IoServer and console for this thread
+    // create an IoServer for this thread
     Ptr<IoServer> ioServer = IoServer::Create();
 
     IndexT loopIndex;
     for (loopIndex = 0; loopIndex < this->loopCount; loopIndex++)
     {
-        // list files for reading
-        Array<String> files = ioServer->ListFiles(this->path, this->pattern);
         IndexT i;
-        for (i = 0; i < files.Size(); i++)
+        for (i = this->first; i < this->files.Size(); i += this->stride)
         {
-            URI fileUri(this->path + "/" + files[i]);
-            n_printf("%s: %s\n", Thread::GetMyThreadName(), fileUri.AsString().AsCharPtr());
-            Ptr<Stream> stream = ioServer->CreateStream(fileUri);
+            Ptr<Stream> stream = ioServer->CreateStream(this->files[i]);
             if (stream->Open())
             {
                 SizeT fileSize = stream->GetSize();
-                void* buf = Memory::Alloc(Memory::DefaultHeap, fileSize);
-                n_assert(buf);
-                SizeT readSize = stream->Read(buf, fileSize);
-                n_assert(readSize == fileSize);
-                Memory::Free(Memory::DefaultHeap, buf);
+                if (fileSize > 0)
+                {
+                    void* buf = Memory::Alloc(Memory::DefaultHeap, fileSize);
+                    n_assert(buf);
+                    SizeT readSize = stream->Read(buf, fileSize);
+                    n_assert(readSize == fileSize);
+                    Memory::Free(Memory::DefaultHeap, buf);
+                    this->bytesRead += fileSize;
+                }
                 stream->Close();
             }
         }
@@ -77,58 +89,86 @@ ReaderThread::DoWork()
 
 //------------------------------------------------------------------------------
 /**
+    Collects the files in a set of directories, and decompresses them with an 
+    increasing number of threads, reporting the throughput of each run. Files 
+    are opened through the IoServer, so they come from the mounted archives.
 */
 void
 ZipStressTestApplication::Run()
 {
     // mount standard zip archives
     IoServer::Instance()->MountStandardArchives();
-    const SizeT numThreads = 8;
+    const SizeT loopCount = 10;
 
-    // create reader threads
-    Array<Ptr<ReaderThread>> threads;
+    // collect files to read
+    const char* dirs[] = { "tex:characters", "tex:examples", "tex:ground", "tex:layered", "tex:lighting", "tex:materials", "tex:mlpaintmaps", "tex:system" };
+    Array<URI> files;
     IndexT i;
-    for (i = 0; i < numThreads; i++)
+    for (i = 0; i < sizeof(dirs) / sizeof(dirs[0]); i++)
     {
-        Ptr<ReaderThread> newThread = (ReaderThread*) ReaderThread::Create();
-        threads.Append(newThread);
-        String threadName;
-        threadName.Format("ReaderThread%d", i);
-        threads[i]->SetName(threadName);
+        Array<String> dirFiles = IoServer::Instance()->ListFiles(dirs[i], "*.dds");
+        IndexT j;
+        for (j = 0; j < dirFiles.Size(); j++)
+        {
+            files.Append(URI(String(dirs[i]) + "/" + dirFiles[j]));
+        }
     }
-    threads[0]->Setup(100, "tex:characters", "*.dds");
-    threads[1]->Setup(100, "tex:examples", "*.dds");
-    threads[2]->Setup(100, "tex:ground", "*.dds");
-    threads[3]->Setup(100, "tex:layered", "*.dds");
-    threads[4]->Setup(100, "tex:lighting", "*.dds");
-    threads[5]->Setup(100, "tex:materials", "*.dds");
-    threads[6]->Setup(100, "tex:mlpaintmaps", "*.dds");
-    threads[7]->Setup(100, "tex:system", "*.dds");
-
-    // start threads
-    for (i = 0; i < numThreads; i++)
+    if (files.IsEmpty())
     {
-        threads[i]->Start();
+        n_printf("No files found to read.\n");
+        return;
     }
+    n_printf("Reading %d files %d times per run\n", files.Size(), loopCount);
 
-    // wait for threads to finish
-    bool anyRunning;
-    do
+    const SizeT maxThreads = Math::max(System::NumCpuCores, 8);
+    SizeT numThreads;
+    for (numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
     {
-        anyRunning = false;
+        // create reader threads, which split the files between them
+        Array<Ptr<ReaderThread>> threads;
+        for (i = 0; i < numThreads; i++)
+        {
+            Ptr<ReaderThread> newThread = (ReaderThread*) ReaderThread::Create();
+            newThread->SetName(String::Sprintf("ReaderThread%d", i));
+            newThread->Setup(loopCount, files, i, numThreads);
+            threads.Append(newThread);
+        }
+
+        Timing::Timer timer;
+        timer.Start();
         for (i = 0; i < numThreads; i++)
         {
-            if (threads[i]->IsRunning())
+            threads[i]->Start();
+        }
+
+        // wait for threads to finish
+        bool anyRunning;
+        do
+        {
+            anyRunning = false;
+            for (i = 0; i < numThreads; i++)
             {
-                anyRunning = true;
-                break;
+                if (threads[i]->IsRunning())
+                {
+                    anyRunning = true;
+                    break;
+                }
             }
+            n_sleep(0.001);
+        }
+        while (anyRunning);
+        timer.Stop();
+
+        Stream::Size bytesRead = 0;
+        for (i = 0; i < numThreads; i++)
+        {
+            bytesRead += threads[i]->GetBytesRead();
         }
-        n_sleep(0.01);
+        const double megaBytes = bytesRead / (1024.0 * 1024.0);
+        n_printf("%2d threads: %8.1f MB in %6.3f s, %8.1f MB/s\n", numThreads, megaBytes, timer.GetTime(), megaBytes / timer.GetTime());
     }
-    while (anyRunning);
 
     n_printf("DONE.\n");
 }
 
-} // namespace App
\ No newline at end of file
+} // namespace App
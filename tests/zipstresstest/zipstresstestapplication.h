@@ -3,7 +3,8 @@
 /**
     @class ZipStressTestApplication
     
-    Multithreading stress test for zip file access.
+    Multithreading stress test for zip file access, reports the decompression
+    throughput for an increasing number of reader threads.
     
     (C) 2009 Radon Labs GmbH
 */
@@ -20,7 +20,8 @@ using namespace IO;
 /**
 */
 ArchiverApp::ArchiverApp() :
-    webDeployFlag(false)
+    webDeployFlag(false),
+    packFlag(false)
 {
     // empty
 }
@@ -35,7 +36,8 @@ ArchiverApp::ShowHelp()
              "(C) Radon Labs GmbH\n"
              "Creates platform-specific asset archives (e.g. export.zip, export_win32.zip)\n"
              "-help -- display this help\n"
-             "-webdeploy -- create a web-deployment directory (only win32 platform)!\n");
+             "-webdeploy -- create a web-deployment directory (only win32 platform)!\n"
+             "-pack -- create a Nebula pack archive (e.g. export.npk) instead of a zip archive\n");
 }
 
 //------------------------------------------------------------------------------
@@ -47,6 +49,7 @@ ArchiverApp::ParseCmdLineArgs()
     if (ToolkitApp::ParseCmdLineArgs())
     {
         this->webDeployFlag = this->args.GetBoolFlag("-webdeploy");
+        this->packFlag = this->args.GetBoolFlag("-pack");
         return true;
     }
     return false;
@@ -64,7 +67,7 @@ ArchiverApp::SetupProjectInfo()
         {
             this->toolPath = this->projectInfo.GetPathAttr("ArchiverTool");
         }
-        else
+        else if (!this->packFlag)
         {
             n_printf("ERROR: no ArchiveTool attribute set in projectinfo.xml!");
             return false;
@@ -76,7 +79,18 @@ ArchiverApp::SetupProjectInfo()
         else
         {
             this->excludePatterns.Append("*.db4");
-        }        
+        }
+        if (this->projectInfo.HasAttr("ArchiverStorePatterns"))
+        {
+            this->storePatterns = this->projectInfo.GetAttr("ArchiverStorePatterns").Tokenize("; ");
+        }
+        else
+        {
+            // already compressed or streamed formats gain nothing from compression
+            this->storePatterns.Append("*.dds");
+            this->storePatterns.Append("*.ogg");
+            this->storePatterns.Append("*.bank");
+        }
         return true;
     }
     return false;
@@ -100,6 +114,12 @@ ArchiverApp::Run()
         return;
     }
     
+    if (this->packFlag)
+    {
+        this->PackDirectoryNpk(this->projectInfo.GetAttr("DstDir"));
+        return;
+    }
+
     // invoke platformspecific packers
     switch (this->platform)
     {
@@ -273,6 +293,92 @@ ArchiverApp::PackDirectoryWin360(const String& dirPath)
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+    Packs a single directory into a Nebula pack archive. Like the zip archive,
+    paths in the archive start with the name of the directory.
+*/
+void
+ArchiverApp::PackDirectoryNpk(const String& dirPath)
+{
+    IoServer* ioServer = IoServer::Instance();
+
+    // make sure the directory exists
+    if (!ioServer->DirectoryExists(dirPath))
+    {
+        n_printf("ERROR: dir '%s' does not exist!", dirPath.AsCharPtr());
+        return;
+    }
+
+    String filePath = dirPath + ".npk";
+    if (ioServer->FileExists(filePath))
+    {
+        ioServer->DeleteFile(filePath);
+    }
+
+    Ptr<PackArchiveWriter> writer = PackArchiveWriter::Create();
+    if (!writer->Open(filePath))
+    {
+        n_printf("ERROR: failed to open '%s' for writing!\n", filePath.AsCharPtr());
+        return;
+    }
+    n_printf("Archiving: %s\n", filePath.AsCharPtr());
+    this->RecursePackDirectory(writer, dirPath, dirPath.ExtractFileName());
+    writer->Close();
+
+    n_printf("%d files compressed, %d files stored, %llu -> %llu bytes\n",
+        writer->GetNumCompressedFiles(), writer->GetNumStoredFiles(),
+        (unsigned long long)writer->GetUncompressedSize(), (unsigned long long)writer->GetArchiveSize());
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ArchiverApp::RecursePackDirectory(PackArchiveWriter* writer, const String& srcDir, const String& pathInArchive)
+{
+    IoServer* ioServer = IoServer::Instance();
+
+    Array<String> files = ioServer->ListFiles(srcDir, "*");
+    IndexT fileIndex;
+    for (fileIndex = 0; fileIndex < files.Size(); fileIndex++)
+    {
+        const String& file = files[fileIndex];
+        IndexT i;
+        bool exclude = false;
+        for (i = 0; i < this->excludePatterns.Size() && !exclude; i++)
+        {
+            exclude = String::MatchPattern(file, this->excludePatterns[i]);
+        }
+        if (exclude)
+        {
+            continue;
+        }
+        bool store = false;
+        for (i = 0; i < this->storePatterns.Size() && !store; i++)
+        {
+            store = String::MatchPattern(file, this->storePatterns[i]);
+        }
+
+        String srcPath = srcDir + "/" + file;
+        if (!writer->AddFile(pathInArchive + "/" + file, srcPath, !store))
+        {
+            n_printf("WARNING: failed to read '%s'!\n", srcPath.AsCharPtr());
+        }
+    }
+
+    Array<String> dirs = ioServer->ListDirectories(srcDir, "*");
+    IndexT dirIndex;
+    for (dirIndex = 0; dirIndex < dirs.Size(); dirIndex++)
+    {
+        const String& curDir = dirs[dirIndex];
+        if ((curDir != "CVS") && (curDir != ".svn"))
+        {
+            this->RecursePackDirectory(writer, srcDir + "/" + curDir, pathInArchive + "/" + curDir);
+        }
+    }
+}
+
 
 
 } // namespace Toolkit
@@ -9,6 +9,7 @@
     (C) 2013-2016 Individual contributors, see AUTHORS file
 */
 #include "toolkitutil/toolkitapp.h"
+#include "io/packfs/packarchivewriter.h"
 
 //------------------------------------------------------------------------------
 namespace Toolkit
@@ -36,11 +37,17 @@ private:
     void RecursePackWebDeployDirectory(const Util::String& srcDir, const Util::String& dstDir);
     /// compress and copy a file for web deployment
     void CompressCopyFile(const Util::String& srcPath, const Util::String& dstPath);
+    /// pack directory into a Nebula pack archive
+    void PackDirectoryNpk(const Util::String& dir);
+    /// recursively add the files of a directory to a pack archive
+    void RecursePackDirectory(IO::PackArchiveWriter* writer, const Util::String& srcDir, const Util::String& pathInArchive);
 
     Util::String toolPath;
     Util::String wiiDvdRoot;
     Util::Array<Util::String> excludePatterns;
+    Util::Array<Util::String> storePatterns;
     bool webDeployFlag;
+    bool packFlag;
 };
 
 } // namespace Toolkit
\ No newline at end of file
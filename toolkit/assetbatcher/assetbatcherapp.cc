@@ -11,12 +11,14 @@
 #include "core/coreserver.h"
 #include "io/textreader.h"
 #include "asset/assetexporter.h"
+#include "model/meshutil/meshbuildersaver.h"
 #include "io/console.h"
 #include "profiling/profiling.h"
 #include "nflatbuffer/flatbufferinterface.h"
 #include "flat/physics/material.h"
 #include "jobs2/jobs2.h"
 #include "system/nebulasettings.h"
+#include "system/systeminfo.h"
 
 #ifdef WIN32
 #include "io/win32/win32consolehandler.h"
@@ -123,9 +125,16 @@ AssetBatcherApp::DoWork()
     ExporterBase::ExportFlag exportFlag = ExporterBase::All;
     Dictionary<String, String> sources;
 
+    // assets are exported as jobs, so the number of job threads is the number of parallel exports
+    int numJobs = System::NumCpuCores;
+    if (this->args.HasArg("-j"))
+    {
+        numJobs = Math::max(this->args.GetInt("-j"), 1);
+    }
+
     Jobs2::JobSystemInitInfo systemInit;
     systemInit.name = "JobSystem";
-    systemInit.numThreads = 8;
+    systemInit.numThreads = numJobs;
     systemInit.scratchMemorySize = 16_MB;
     systemInit.affinity = System::Cpu::All;
     systemInit.enableIo = true;
@@ -177,7 +186,8 @@ AssetBatcherApp::DoWork()
     {
         mode = (AssetExporter::ExportModes)0;
         Util::String exportMode = this->args.GetString("-mode");
-        Util::Array<Util::String> modeFlags = exportMode.Tokenize(",");
+        Util::Array<Util::StringView> modeFlags;
+        exportMode.Tokenize(",", modeFlags);
         if (modeFlags.Find("fbx")) mode |= AssetExporter::FBX;
         if (modeFlags.Find("model")) mode |= AssetExporter::Models;
         if (modeFlags.Find("surface")) mode |= AssetExporter::Surfaces;
@@ -189,7 +199,25 @@ AssetBatcherApp::DoWork()
 
     AssignRegistry::Instance()->SetAssign(Assign("home","proj:"));
 
+    // restore unchanged assets from the content hashed cache, an explicit -force still rebuilds everything
+    AssetCache cache;
+    if (!this->args.GetBoolFlag("-nocache"))
+    {
+        Util::String cacheDir = this->args.GetString("-cache", "intermediate:assetcache");
+        uint64 cacheSize = uint64(this->args.GetInt("-cachesize", 4096)) * 1_MB;
+        if (cache.Open(cacheDir, cacheSize))
+        {
+            cache.SetBypass(force);
+            exporter->SetCache(&cache);
+        }
+        else
+        {
+            this->logger.Warning("Could not open asset cache %s\n", cacheDir.AsCharPtr());
+        }
+    }
+
     // check to see if the assetbatcher has been updated, in that case, force all assets to be rebuilt.
+    // the cache keys include the exporter versions, so with a cache this only refreshes the time stamp
     IO::FileTime cmdBinModifiedTime = IO::IoServer::Instance()->GetFileWriteTime(this->args.GetCmdName());
     if (System::NebulaSettings::Exists("gscept", "ToolkitShared", "AssetBatcherTimeStamp"))
     {
@@ -197,13 +225,13 @@ AssetBatcherApp::DoWork()
         if (IO::FileTime(oldFileTime) < cmdBinModifiedTime)
         {
             System::NebulaSettings::WriteString("gscept", "ToolkitShared", "AssetBatcherTimeStamp", cmdBinModifiedTime.AsString());
-            force = true;
+            force = force || !cache.IsOpen();
         }
     }
     else
     {
         System::NebulaSettings::WriteString("gscept", "ToolkitShared", "AssetBatcherTimeStamp", cmdBinModifiedTime.AsString());
-        force = true;
+        force = force || !cache.IsOpen();
     }
 
     exporter->Open();
@@ -252,7 +280,14 @@ AssetBatcherApp::DoWork()
         }
     }
     
+    exporter->PrintTimeSummary();
+    ToolkitUtil::MeshBuilderSaver::PrintQuantizationStats(&this->logger);
     exporter->Close();
+    if (cache.IsOpen())
+    {
+        cache.PrintStats(&this->logger);
+        cache.Close();
+    }
 
     Jobs2::JobSystemUninit();
 
@@ -319,6 +354,10 @@ AssetBatcherApp::ShowHelp()
              "-source       --select asset source from projectinfo, default all\n"
              "-work         --batch a non-registered work folder into the project\n"
              "-mode         --batch only a type of resource, can be: fbx, model, surface, texture, physics, gltf, audio\n"
+             "-j            --number of assets to export in parallel, default is the number of cores\n"
+             "-cache        --asset cache directory, default is intermediate:assetcache\n"
+             "-cachesize    --asset cache size limit in MB, default is 4096\n"
+             "-nocache      --don't restore or store assets in the cache\n"
              "-project      --projectinfo override\n");
 }
 
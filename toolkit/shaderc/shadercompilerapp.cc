@@ -5,10 +5,27 @@
 #include "foundation/stdneb.h"
 #include "shadercompilerapp.h"
 #include "timing/time.h"
+#include "timing/timer.h"
+#include "io/ioserver.h"
+#include "system/process.h"
+#include "system/systeminfo.h"
+#include "toolkitutil/asset/assetcache.h"
 
 namespace Toolkit
 {
 using namespace ToolkitUtil;
+using namespace Util;
+using namespace IO;
+
+//------------------------------------------------------------------------------
+/**
+*/
+ShaderCompilerApp::ShaderCompilerApp() :
+    cacheSize(0),
+    numWorkers(1)
+{
+    // empty
+}
 
 //------------------------------------------------------------------------------
 /**
@@ -39,10 +56,227 @@ ShaderCompilerApp::ParseCmdLineArgs()
         
         this->src = this->args.GetString("-i");
         this->type = this->args.GetString("-t");        
+
+        // every -i is part of the batch, folders add all their shaders
+        this->sources.Clear();
+        Array<String> inputs = this->args.GetStrings("-i");
+        for (const String& input : inputs)
+        {
+            if (IoServer::Instance()->DirectoryExists(input))
+            {
+                Array<String> files = IoServer::Instance()->ListFiles(input, "*.fx");
+                for (const String& file : files)
+                {
+                    this->sources.Append(input + "/" + file);
+                }
+            }
+            else
+            {
+                this->sources.Append(input);
+            }
+        }
+
+        this->numWorkers = System::NumCpuCores;
+        if (this->args.HasArg("-j"))
+        {
+            this->numWorkers = Math::max(this->args.GetInt("-j"), 1);
+        }
+
+        // single shaders are compiled by the build system in parallel, so they
+        // only use the cache when asked to, batches use it by default
+        this->cacheDir.Clear();
+        if (this->args.HasArg("-cache"))
+        {
+            this->cacheDir = this->args.GetString("-cache");
+        }
+        else if (this->sources.Size() > 1)
+        {
+            this->cacheDir = "temp:shadercache";
+        }
+        if (this->args.GetBoolFlag("-nocache"))
+        {
+            this->cacheDir.Clear();
+        }
+        this->cacheSize = (uint64)Math::max(this->args.GetInt("-cachesize", 512), 1) * 1_MB;
     }
     return true;
 }
 
+//------------------------------------------------------------------------------
+/**
+    Dependencies and cache lookups are done up front, then the remaining
+    shaders are compiled by up to numWorkers child processes. A child which
+    exits with an error or leaves any output missing failed, a stale output
+    of an earlier compile must not be cached in its place.
+*/
+bool
+ShaderCompilerApp::CompileShaderBatch()
+{
+    enum Status
+    {
+        Pending,
+        Running,
+        Compiled,
+        Cached,
+        Failed
+    };
+    struct Task
+    {
+        String src;
+        Array<AssetCache::Dependency> dependencies;
+        Array<String> outputs;
+        uint64 key = 0;
+        Status status = Pending;
+        System::Process process;
+        Timing::Timer timer;
+    };
+
+    const Ptr<IoServer>& ioServer = IoServer::Instance();
+    Timing::Timer batchTimer;
+    batchTimer.Start();
+
+    AssetCache cache;
+    if (this->cacheDir.IsValid() && !cache.Open(URI(this->cacheDir), this->cacheSize))
+    {
+        n_printf("[shaderc] warning: failed to open shader cache '%s'\n", this->cacheDir.AsCharPtr());
+    }
+    const String settings = this->shaderCompiler.GetCacheSettings();
+
+    // hash sources and their includes, restore whatever is up to date
+    FixedArray<Task> tasks(this->sources.Size());
+    Array<IndexT> pending;
+    for (IndexT i = 0; i < tasks.Size(); i++)
+    {
+        Task& task = tasks[i];
+        task.src = this->sources[i];
+        task.timer.Start();
+        this->shaderCompiler.GetOutputs(task.src, task.outputs);
+
+        Array<String> files;
+        if (!this->shaderCompiler.GetDependencies(task.src, files))
+        {
+            task.status = Failed;
+            task.timer.Stop();
+            continue;
+        }
+        for (const String& file : files)
+        {
+            AssetCache::AddDependency(task.dependencies, file);
+        }
+        task.key = AssetCache::ComputeKey(task.dependencies, settings);
+        task.timer.Stop();
+
+        if (cache.Restore(task.key))
+        {
+            task.status = Cached;
+            continue;
+        }
+        pending.Append(i);
+    }
+
+    if (pending.Size() == 1)
+    {
+        // not worth a process
+        Task& task = tasks[pending[0]];
+        task.timer.Start();
+        task.status = this->shaderCompiler.CompileShader(task.src) ? Compiled : Failed;
+        task.timer.Stop();
+        if (task.status == Compiled)
+        {
+            cache.Store(task.key, task.src, task.dependencies, task.outputs);
+        }
+    }
+    else if (pending.Size() > 1)
+    {
+        IndexT next = 0;
+        SizeT running = 0;
+        while (next < pending.Size() || running > 0)
+        {
+            while (running < this->numWorkers && next < pending.Size())
+            {
+                Task& task = tasks[pending[next++]];
+                for (const String& output : task.outputs)
+                {
+                    if (ioServer->FileExists(output))
+                    {
+                        ioServer->DeleteFile(output);
+                    }
+                }
+                task.process.SetExecutable(URI(this->args.GetCmdName()));
+                task.process.SetArguments(this->shaderCompiler.GetCommandLine(task.src));
+                task.timer.Start();
+                if (task.process.Launch())
+                {
+                    task.status = Running;
+                    running++;
+                }
+                else
+                {
+                    task.status = Failed;
+                    task.timer.Stop();
+                }
+            }
+
+            for (IndexT i : pending)
+            {
+                Task& task = tasks[i];
+                if (task.status != Running || task.process.IsRunning())
+                    continue;
+
+                task.timer.Stop();
+                running--;
+                task.status = task.process.GetExitCode() == 0 ? Compiled : Failed;
+                for (const String& output : task.outputs)
+                {
+                    if (!ioServer->FileExists(output))
+                    {
+                        task.status = Failed;
+                    }
+                }
+                if (task.status == Compiled)
+                {
+                    cache.Store(task.key, task.src, task.dependencies, task.outputs);
+                }
+            }
+            Timing::Sleep(0.005);
+        }
+    }
+    batchTimer.Stop();
+
+    // slowest shaders first
+    Array<KeyValuePair<Timing::Time, IndexT>> order;
+    order.Reserve(tasks.Size());
+    SizeT numCompiled = 0, numCached = 0, numFailed = 0;
+    for (IndexT i = 0; i < tasks.Size(); i++)
+    {
+        order.Append(KeyValuePair<Timing::Time, IndexT>(-tasks[i].timer.GetTime(), i));
+        switch (tasks[i].status)
+        {
+            case Compiled: numCompiled++; break;
+            case Cached: numCached++; break;
+            default: numFailed++; break;
+        }
+    }
+    order.Sort();
+
+    static const char* StatusNames[] = { "pending", "running", "compiled", "cached", "FAILED" };
+    n_printf("\n[shaderc] Timing ---------\n");
+    for (const KeyValuePair<Timing::Time, IndexT>& entry : order)
+    {
+        const Task& task = tasks[entry.Value()];
+        n_printf("%9.2f ms  %-8s  %s\n", task.timer.GetTime() * 1000.0, StatusNames[task.status], URI(task.src).LocalPath().AsCharPtr());
+    }
+    n_printf("[shaderc] %d shaders: %d compiled, %d cached, %d failed in %.2f s with %d workers\n",
+        tasks.Size(), numCompiled, numCached, numFailed, batchTimer.GetTime(), this->numWorkers);
+
+    if (cache.IsOpen())
+    {
+        cache.PrintStats(&this->logger);
+        cache.Close();
+    }
+    return numFailed == 0;
+}
+
 
 
 //------------------------------------------------------------------------------
@@ -73,6 +307,10 @@ ShaderCompilerApp::Run()
         {
             success = this->shaderCompiler.CreateDependencies(this->src);
         }
+        else if (this->sources.Size() > 1 || this->cacheDir.IsValid())
+        {
+            success = this->CompileShaderBatch();
+        }
         else
         {
             success = this->shaderCompiler.CompileShader(this->src);
@@ -4,6 +4,11 @@
     @class Toolkit::ShaderCompilerApp
 
     Application class for the shaderc tool.
+
+    Several -i arguments (or folders of shaders) make up a batch. Up to date
+    shaders are restored from a content hash cache, the rest are compiled by
+    a pool of shaderc processes, since the AnyFX preprocessor is not thread
+    safe. A timing summary is printed at the end of a batch.
         
     (C) 2018-2020 Individual contributors, see AUTHORS file
 */
@@ -16,16 +21,24 @@ namespace Toolkit
 class ShaderCompilerApp : public ToolkitUtil::ToolkitApp
 {
 public:
+    /// constructor
+    ShaderCompilerApp();
     /// run the application
     virtual void Run();
 
 private:
     /// parse command line arguments
     virtual bool ParseCmdLineArgs();    
+    /// compile several shaders in parallel, using the cache
+    bool CompileShaderBatch();
 
     ToolkitUtil::SingleShaderCompiler shaderCompiler;
     Util::String src;
+    Util::Array<Util::String> sources;
     Util::String type;
+    Util::String cacheDir;
+    uint64 cacheSize;
+    int numWorkers;
 };
 
 } // namespace Toolkit
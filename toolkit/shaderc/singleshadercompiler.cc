@@ -18,6 +18,9 @@ using namespace IO;
 namespace ToolkitUtil
 {
 
+// bump when the compiler or its flags change the output, invalidates cached shaders
+static const uint ShaderCompilerVersion = 1;
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -436,5 +439,111 @@ const Ptr<IoServer>& ioServer = IoServer::Instance();
     return true;
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+void
+SingleShaderCompiler::GetDefines(const Util::String& srcf, std::vector<std::string>& defines) const
+{
+    Util::String define;
+    define.Format("-D GLSL");
+    defines.push_back(define.AsCharPtr());
+
+    // first include this folder
+    define.Format("-I%s/", URI(srcf.ExtractDirName()).LocalPath().AsCharPtr());
+    defines.push_back(define.AsCharPtr());
+
+    for (auto inc = this->includeDirs.Begin(); inc != this->includeDirs.End(); inc++)
+    {
+        define.Format("-I%s/", URI(*inc).LocalPath().AsCharPtr());
+        defines.push_back(define.AsCharPtr());
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+SingleShaderCompiler::GetDependencies(const Util::String& srcf, Util::Array<Util::String>& outFiles)
+{
+#ifndef __ANYFX__
+    n_printf("Error: Cannot compile DX11 shaders without DX11 support\n");
+    return false;
+#else
+    if (!IoServer::Instance()->FileExists(srcf))
+    {
+        n_printf("[shaderc] error: shader source '%s' not found!\n", srcf.AsCharPtr());
+        return false;
+    }
+
+    std::vector<std::string> defines;
+    this->GetDefines(srcf, defines);
+    outFiles.Append(URI(srcf).LocalPath());
+    std::vector<std::string> deps = AnyFXGenerateDependencies(URI(srcf).LocalPath().AsCharPtr(), defines);
+    for (const std::string& dep : deps)
+    {
+        String file = dep.c_str();
+        if (file.IsValid() && outFiles.FindIndex(file) == InvalidIndex)
+        {
+            outFiles.Append(file);
+        }
+    }
+    return true;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+SingleShaderCompiler::GetOutputs(const Util::String& srcf, Util::Array<Util::String>& outFiles) const
+{
+    Util::String file = srcf.ExtractFileName();
+    file.StripFileExtension();
+    outFiles.Append(URI(this->dstBinary + "/" + file + ".fxb").LocalPath());
+    outFiles.Append(URI(this->dstHeader + "/" + file + ".h").LocalPath());
+}
+
+//------------------------------------------------------------------------------
+/**
+    Include directories are part of the settings since they decide which
+    files the includes resolve to. The output paths are too, as the cache
+    restores outputs to the paths they were stored from.
+*/
+Util::String
+SingleShaderCompiler::GetCacheSettings() const
+{
+    String settings = String::Sprintf("shaderc %d %s spv10 defaultset %d debug %d",
+        ShaderCompilerVersion, this->language.AsCharPtr(), NEBULA_BATCH_GROUP, this->debug);
+    for (const String& inc : this->includeDirs)
+    {
+        settings.Append(" -I ");
+        settings.Append(URI(inc).LocalPath());
+    }
+    settings.Append(" -o ");
+    settings.Append(URI(this->dstBinary).LocalPath());
+    settings.Append(" -h ");
+    settings.Append(URI(this->dstHeader).LocalPath());
+    return settings;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Util::String
+SingleShaderCompiler::GetCommandLine(const Util::String& srcf) const
+{
+    String args = String::Sprintf("-t shader -i \"%s\" -o \"%s\" -h \"%s\"",
+        URI(srcf).LocalPath().AsCharPtr(), URI(this->dstBinary).LocalPath().AsCharPtr(), URI(this->dstHeader).LocalPath().AsCharPtr());
+    for (const String& inc : this->includeDirs)
+    {
+        args.Append(String::Sprintf(" -I \"%s\"", URI(inc).LocalPath().AsCharPtr()));
+    }
+    if (this->debug)
+    {
+        args.Append(" -debug");
+    }
+    return args;
+}
 
-} // namespace ToolkitUtil
\ No newline at end of file
+} // namespace ToolkitUtil
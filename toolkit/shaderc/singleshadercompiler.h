@@ -11,6 +11,8 @@
 #include "toolkit-common/platform.h"
 #include "io/uri.h"
 #include "util/string.h"
+#include <vector>
+#include <string>
 
 namespace ToolkitUtil
 {
@@ -49,6 +51,15 @@ public:
     bool CompileFrameShader(const Util::String& src);
     /// calculate include dependencies
     bool CreateDependencies(const Util::String& src);
+
+    /// get the source and all files it includes
+    bool GetDependencies(const Util::String& src, Util::Array<Util::String>& outFiles);
+    /// get the files written when compiling a shader
+    void GetOutputs(const Util::String& src, Util::Array<Util::String>& outFiles) const;
+    /// get the compiler settings which affect the output, for cache keys
+    Util::String GetCacheSettings() const;
+    /// get the command line arguments to compile a shader in a separate process
+    Util::String GetCommandLine(const Util::String& src) const;
     
 private:
     
@@ -56,6 +67,8 @@ private:
     bool CompileGLSL(const Util::String& src);
     /// compiles shaders for SPIRV
     bool CompileSPIRV(const Util::String& src);
+    /// get the preprocessor defines and include directories of a shader
+    void GetDefines(const Util::String& src, std::vector<std::string>& defines) const;
     
     Platform::Code platform;    
     Util::String dstBinary;    
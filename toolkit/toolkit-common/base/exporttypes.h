@@ -27,7 +27,10 @@ enum ExportFlags
     ImportSecondaryUVs = 1 << 4,
     CalcTangents = 1 << 5,
     CalcRigidSkin = 1 << 6,
-    All = (1 << 7) - 1,
+    CompressAnimations = 1 << 7,
+    All = (1 << 8) - 1,
+    SkipMeshOptimization = 1 << 8,      // opt out of vertex cache, overdraw and vertex fetch ordering
+    SkipVertexQuantization = 1 << 9,    // opt out of writing quantized vertex data
 
     NumMeshFlags
 };
@@ -0,0 +1,161 @@
+//------------------------------------------------------------------------------
+//  bufferedlogger.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "foundation/stdneb.h"
+#include "bufferedlogger.h"
+
+namespace ToolkitUtil
+{
+using namespace Util;
+
+ThreadLocal BufferedLogger::Buffer* BufferedLogger::CurrentBuffer = nullptr;
+
+//------------------------------------------------------------------------------
+/**
+*/
+BufferedLogger::BufferedLogger() :
+    target(nullptr)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+BufferedLogger::~BufferedLogger()
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BufferedLogger::BeginBuffer(Buffer* buffer)
+{
+    n_assert(CurrentBuffer == nullptr);
+    CurrentBuffer = buffer;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BufferedLogger::EndBuffer()
+{
+    n_assert(CurrentBuffer != nullptr);
+    CurrentBuffer = nullptr;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BufferedLogger::Flush(const Buffer& buffer)
+{
+    n_assert(this->target != nullptr);
+    for (const Entry& entry : buffer.entries)
+    {
+        switch (entry.level)
+        {
+            case LogInfo:
+                this->target->Print("%s", entry.message.AsCharPtr());
+                break;
+            case LogWarning:
+                this->target->Warning("%s", entry.message.AsCharPtr());
+                break;
+            case LogError:
+                this->target->Error("%s", entry.message.AsCharPtr());
+                break;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BufferedLogger::Put(Level level, const char* msg, va_list args)
+{
+    String str;
+    str.FormatArgList(msg, args);
+    if (CurrentBuffer != nullptr)
+    {
+        CurrentBuffer->entries.Append({ level, CurrentBuffer->indent + str });
+        if (level == LogError)         CurrentBuffer->numErrors++;
+        else if (level == LogWarning)  CurrentBuffer->numWarnings++;
+    }
+    else
+    {
+        n_assert(this->target != nullptr);
+        switch (level)
+        {
+            case LogInfo:      this->target->Print("%s", str.AsCharPtr()); break;
+            case LogWarning:   this->target->Warning("%s", str.AsCharPtr()); break;
+            case LogError:     this->target->Error("%s", str.AsCharPtr()); break;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BufferedLogger::Error(const char* msg, ...)
+{
+    va_list argList;
+    va_start(argList, msg);
+    this->Put(LogError, msg, argList);
+    va_end(argList);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BufferedLogger::Warning(const char* msg, ...)
+{
+    va_list argList;
+    va_start(argList, msg);
+    this->Put(LogWarning, msg, argList);
+    va_end(argList);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BufferedLogger::Print(const char* msg, ...)
+{
+    va_list argList;
+    va_start(argList, msg);
+    this->Put(LogInfo, msg, argList);
+    va_end(argList);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BufferedLogger::Indent()
+{
+    if (CurrentBuffer != nullptr)
+        CurrentBuffer->indent += "    ";
+    else
+        this->target->Indent();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BufferedLogger::Unindent()
+{
+    if (CurrentBuffer != nullptr)
+        CurrentBuffer->indent = CurrentBuffer->indent.ExtractRange(0, CurrentBuffer->indent.Length() - 4);
+    else
+        this->target->Unindent();
+}
+
+} // namespace ToolkitUtil
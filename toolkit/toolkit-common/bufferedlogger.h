@@ -0,0 +1,89 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class ToolkitUtil::BufferedLogger
+
+    A logger which can be shared between jobs. While a thread has a buffer
+    bound with BeginBuffer, everything it logs (including indentation) goes
+    into that buffer instead of the output, the owner then flushes the buffers
+    in a deterministic order so the output of concurrent jobs is not interleaved.
+    Threads without a buffer forward directly to the target logger.
+
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "logger.h"
+#include "core/types.h"
+
+//------------------------------------------------------------------------------
+namespace ToolkitUtil
+{
+class BufferedLogger : public Logger
+{
+public:
+    enum Level
+    {
+        LogInfo,
+        LogWarning,
+        LogError
+    };
+
+    struct Entry
+    {
+        Level level;
+        Util::String message;
+    };
+
+    struct Buffer
+    {
+        Util::Array<Entry> entries;
+        Util::String indent;
+        SizeT numErrors = 0;
+        SizeT numWarnings = 0;
+    };
+
+    /// constructor
+    BufferedLogger();
+    /// destructor
+    virtual ~BufferedLogger();
+
+    /// set logger to forward to and to flush buffers into
+    void SetTarget(Logger* target);
+
+    /// redirect messages from the calling thread into buffer
+    void BeginBuffer(Buffer* buffer);
+    /// stop redirecting messages from the calling thread
+    void EndBuffer();
+    /// write buffered messages to the target logger
+    void Flush(const Buffer& buffer);
+
+    /// put a formatted error message
+    void Error(const char* msg, ...) override;
+    /// put a formatted warning message
+    void Warning(const char* msg, ...) override;
+    /// put a formatted message
+    void Print(const char* msg, ...) override;
+
+    /// Indent logger
+    void Indent() override;
+    /// Unindent logger
+    void Unindent() override;
+
+private:
+    /// add entry to the calling thread's buffer, or forward it if there is none
+    void Put(Level level, const char* msg, va_list args);
+
+    Logger* target;
+    static ThreadLocal Buffer* CurrentBuffer;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+BufferedLogger::SetTarget(Logger* target)
+{
+    this->target = target;
+}
+
+} // namespace ToolkitUtil
+//------------------------------------------------------------------------------
@@ -35,9 +35,9 @@ public:
     virtual void Print(const char* msg, ...);
 
     /// Indent logger
-    void Indent();
+    virtual void Indent();
     /// Unindent logger
-    void Unindent();
+    virtual void Unindent();
 
 protected:
     bool verbose;
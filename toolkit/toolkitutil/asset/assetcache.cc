@@ -0,0 +1,452 @@
+//------------------------------------------------------------------------------
+//  assetcache.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "foundation/stdneb.h"
+#include "assetcache.h"
+#include "io/ioserver.h"
+#include "io/stream.h"
+#include "io/binaryreader.h"
+#include "io/binarywriter.h"
+#include "io/jsonwriter.h"
+#include "util/keyvaluepair.h"
+
+using namespace Util;
+using namespace IO;
+namespace ToolkitUtil
+{
+
+static const uint IndexMagic = 'NACI';
+static const uint IndexVersion = 1;
+static const uint64 HashOffset = 0xcbf29ce484222325ull;
+static const uint64 HashPrime = 0x100000001b3ull;
+
+//------------------------------------------------------------------------------
+/**
+    FNV-1a over 8 byte words, the tail is hashed byte by byte
+*/
+static uint64
+HashBytes(const void* data, SizeT numBytes, uint64 hash)
+{
+    const ubyte* bytes = (const ubyte*)data;
+    SizeT numWords = numBytes / sizeof(uint64);
+    for (SizeT i = 0; i < numWords; i++)
+    {
+        uint64 word;
+        memcpy(&word, bytes + i * sizeof(uint64), sizeof(uint64));
+        hash ^= word;
+        hash *= HashPrime;
+    }
+    for (SizeT i = numWords * sizeof(uint64); i < numBytes; i++)
+    {
+        hash ^= bytes[i];
+        hash *= HashPrime;
+    }
+    return hash;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+AssetCache::AssetCache() :
+    maxSize(0),
+    size(0),
+    useCounter(0),
+    bypass(false),
+    isOpen(false),
+    hits(0),
+    misses(0),
+    upToDate(0),
+    bytesRestored(0),
+    bytesStored(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+AssetCache::~AssetCache()
+{
+    if (this->IsOpen())
+    {
+        this->Close();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+AssetCache::Open(const IO::URI& dir, uint64 maxSize)
+{
+    n_assert(!this->IsOpen());
+    if (!IoServer::Instance()->CreateDirectory(dir))
+    {
+        return false;
+    }
+    this->dir = dir.AsString();
+    this->maxSize = maxSize;
+    this->LoadIndex();
+    this->isOpen = true;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AssetCache::Close()
+{
+    n_assert(this->IsOpen());
+    this->Trim();
+    this->SaveIndex();
+    this->entries.Clear();
+    this->isOpen = false;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AssetCache::AddDependency(Util::Array<Dependency>& dependencies, const Util::String& file)
+{
+    Dependency dependency;
+    dependency.file = file;
+    dependency.hash = 0;
+
+    IoServer* ioServer = IoServer::Instance();
+    if (ioServer->FileExists(file))
+    {
+        Ptr<Stream> stream = ioServer->CreateStream(file);
+        stream->SetAccessMode(Stream::ReadAccess);
+        if (stream->Open())
+        {
+            const void* data = stream->Map();
+            dependency.hash = HashBytes(data, stream->GetSize(), HashOffset);
+            stream->Unmap();
+            stream->Close();
+        }
+    }
+    dependencies.Append(dependency);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+uint64
+AssetCache::ComputeKey(const Util::Array<Dependency>& dependencies, const Util::String& settings)
+{
+    uint64 hash = HashBytes(settings.AsCharPtr(), settings.Length(), HashOffset);
+    for (const Dependency& dependency : dependencies)
+    {
+        hash = HashBytes(dependency.file.AsCharPtr(), dependency.file.Length(), hash);
+        hash = HashBytes(&dependency.hash, sizeof(uint64), hash);
+    }
+    return hash;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Copies the cached outputs of an entry back into place, outputs which are
+    unchanged since they were stored or restored are left alone
+*/
+bool
+AssetCache::Restore(uint64 key)
+{
+    if (!this->IsOpen())
+        return false;
+
+    Entry entry;
+    this->lock.Enter();
+    IndexT index = this->entries.FindIndex(key);
+    if (this->bypass || index == InvalidIndex)
+    {
+        this->misses++;
+        this->lock.Leave();
+        return false;
+    }
+    entry = this->entries.ValueAtIndex(index);
+    this->lock.Leave();
+
+    IoServer* ioServer = IoServer::Instance();
+    uint64 restored = 0;
+    bool valid = true;
+    for (IndexT i = 0; i < entry.outputs.Size(); i++)
+    {
+        Output& output = entry.outputs[i];
+
+        // untouched since it was stored or last restored
+        if (ioServer->FileExists(output.file) && ioServer->GetFileWriteTime(output.file).AsString() == output.writeTime)
+            continue;
+
+        String path = this->GetEntryPath(key, i);
+        if (!ioServer->FileExists(path))
+        {
+            valid = false;
+            break;
+        }
+        ioServer->CreateDirectory(output.file.ExtractDirName());
+        if (!ioServer->CopyFile(path, output.file))
+        {
+            valid = false;
+            break;
+        }
+        output.writeTime = ioServer->GetFileWriteTime(output.file).AsString();
+        restored += output.size;
+    }
+
+    this->lock.Enter();
+    index = this->entries.FindIndex(key);
+    if (!valid)
+    {
+        // the cache directory was tampered with, drop the entry and rebuild
+        if (index != InvalidIndex)
+        {
+            this->size -= this->entries.ValueAtIndex(index).size;
+            this->entries.EraseAtIndex(index);
+        }
+        this->misses++;
+        this->lock.Leave();
+        return false;
+    }
+
+    this->hits++;
+    if (restored == 0)
+        this->upToDate++;
+    this->bytesRestored += restored;
+    if (index != InvalidIndex)
+    {
+        Entry& stored = this->entries.ValueAtIndex(index);
+        stored.outputs = entry.outputs;
+        stored.lastUse = ++this->useCounter;
+    }
+    this->lock.Leave();
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AssetCache::Store(uint64 key, const Util::String& asset, const Util::Array<Dependency>& dependencies, const Util::Array<Util::String>& outputs)
+{
+    if (!this->IsOpen())
+        return;
+
+    IoServer* ioServer = IoServer::Instance();
+    Entry entry;
+    for (const String& file : outputs)
+    {
+        if (!ioServer->FileExists(file))
+            continue;
+
+        String path = this->GetEntryPath(key, entry.outputs.Size());
+        if (!ioServer->CopyFile(file, path))
+            continue;
+
+        Output output;
+        output.file = file;
+        output.size = 0;
+        output.writeTime = ioServer->GetFileWriteTime(file).AsString();
+        Ptr<Stream> stream = ioServer->CreateStream(path);
+        stream->SetAccessMode(Stream::ReadAccess);
+        if (stream->Open())
+        {
+            output.size = stream->GetSize();
+            stream->Close();
+        }
+        entry.size += output.size;
+        entry.outputs.Append(output);
+    }
+
+    // the manifest is for inspecting the cache, lookups only use the key
+    Ptr<JsonWriter> writer = JsonWriter::Create();
+    writer->SetStream(ioServer->CreateStream(this->GetEntryPath(key, InvalidIndex)));
+    if (writer->Open())
+    {
+        writer->Add(asset, "asset");
+        writer->Add(String::Sprintf("%016llx", key), "key");
+        writer->BeginArray("dependencies");
+        for (const Dependency& dependency : dependencies)
+        {
+            writer->BeginObject();
+            writer->Add(dependency.file, "file");
+            writer->Add(String::Sprintf("%016llx", dependency.hash), "hash");
+            writer->End();
+        }
+        writer->End();
+        writer->BeginArray("outputs");
+        for (const Output& output : entry.outputs)
+        {
+            writer->Add(output.file);
+        }
+        writer->End();
+        writer->Close();
+    }
+
+    this->lock.Enter();
+    IndexT index = this->entries.FindIndex(key);
+    if (index != InvalidIndex)
+    {
+        // rebuilt while bypassing the cache, drop stored outputs which are no longer produced
+        const Entry& old = this->entries.ValueAtIndex(index);
+        for (IndexT i = entry.outputs.Size(); i < old.outputs.Size(); i++)
+            ioServer->DeleteFile(this->GetEntryPath(key, i));
+        this->size -= old.size;
+        this->entries.EraseAtIndex(index);
+    }
+    entry.lastUse = ++this->useCounter;
+    this->size += entry.size;
+    this->bytesStored += entry.size;
+    this->entries.Add(key, entry);
+    this->lock.Leave();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AssetCache::Trim()
+{
+    if (this->size <= this->maxSize)
+        return;
+
+    Array<KeyValuePair<uint64, uint64>> order;
+    order.Reserve(this->entries.Size());
+    for (IndexT i = 0; i < this->entries.Size(); i++)
+        order.Append(KeyValuePair<uint64, uint64>(this->entries.ValueAtIndex(i).lastUse, this->entries.KeyAtIndex(i)));
+    order.Sort();
+
+    for (IndexT i = 0; i < order.Size() && this->size > this->maxSize; i++)
+    {
+        IndexT index = this->entries.FindIndex(order[i].Value());
+        const Entry& entry = this->entries.ValueAtIndex(index);
+        this->DeleteEntry(order[i].Value(), entry);
+        this->size -= entry.size;
+        this->entries.EraseAtIndex(index);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AssetCache::PrintStats(Logger* logger) const
+{
+    const SizeT lookups = this->hits + this->misses;
+    logger->Print("\nAsset cache ---------\n");
+    logger->Print("%d hits, %d misses (%.1f%% hit rate), %d already up to date\n",
+        this->hits, this->misses, lookups > 0 ? 100.0f * this->hits / lookups : 0.0f, this->upToDate);
+    logger->Print("restored %.2f MB, stored %.2f MB, cache size %.2f of %.2f MB\n",
+        this->bytesRestored / 1048576.0, this->bytesStored / 1048576.0, this->size / 1048576.0, this->maxSize / 1048576.0);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Util::String
+AssetCache::GetEntryPath(uint64 key, IndexT output) const
+{
+    if (output == InvalidIndex)
+        return String::Sprintf("%s/%016llx.manifest", this->dir.AsCharPtr(), key);
+    else
+        return String::Sprintf("%s/%016llx.%d", this->dir.AsCharPtr(), key, output);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AssetCache::DeleteEntry(uint64 key, const Entry& entry) const
+{
+    IoServer* ioServer = IoServer::Instance();
+    for (IndexT i = 0; i < entry.outputs.Size(); i++)
+        ioServer->DeleteFile(this->GetEntryPath(key, i));
+    ioServer->DeleteFile(this->GetEntryPath(key, InvalidIndex));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AssetCache::LoadIndex()
+{
+    IoServer* ioServer = IoServer::Instance();
+    String indexPath = this->dir + "/index";
+    bool loaded = false;
+    if (ioServer->FileExists(indexPath))
+    {
+        Ptr<BinaryReader> reader = BinaryReader::Create();
+        reader->SetStream(ioServer->CreateStream(indexPath));
+        if (reader->Open())
+        {
+            if (reader->ReadUInt() == IndexMagic && reader->ReadUInt() == IndexVersion)
+            {
+                this->useCounter = reader->ReadUInt64();
+                uint numEntries = reader->ReadUInt();
+                for (uint i = 0; i < numEntries; i++)
+                {
+                    uint64 key = reader->ReadUInt64();
+                    Entry entry;
+                    entry.lastUse = reader->ReadUInt64();
+                    uint numOutputs = reader->ReadUInt();
+                    for (uint j = 0; j < numOutputs; j++)
+                    {
+                        Output output;
+                        output.file = reader->ReadString();
+                        output.size = reader->ReadUInt64();
+                        output.writeTime = reader->ReadString();
+                        entry.size += output.size;
+                        entry.outputs.Append(output);
+                    }
+                    this->size += entry.size;
+                    this->entries.Add(key, entry);
+                }
+                loaded = true;
+            }
+            reader->Close();
+        }
+    }
+
+    if (!loaded)
+    {
+        // without an index nothing in the directory can be trusted
+        Array<String> files = ioServer->ListFiles(this->dir, "*", true);
+        for (const String& file : files)
+            ioServer->DeleteFile(file);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AssetCache::SaveIndex()
+{
+    Ptr<BinaryWriter> writer = BinaryWriter::Create();
+    writer->SetStream(IoServer::Instance()->CreateStream(this->dir + "/index"));
+    if (writer->Open())
+    {
+        writer->WriteUInt(IndexMagic);
+        writer->WriteUInt(IndexVersion);
+        writer->WriteUInt64(this->useCounter);
+        writer->WriteUInt(this->entries.Size());
+        for (IndexT i = 0; i < this->entries.Size(); i++)
+        {
+            const Entry& entry = this->entries.ValueAtIndex(i);
+            writer->WriteUInt64(this->entries.KeyAtIndex(i));
+            writer->WriteUInt64(entry.lastUse);
+            writer->WriteUInt(entry.outputs.Size());
+            for (const Output& output : entry.outputs)
+            {
+                writer->WriteString(output.file);
+                writer->WriteUInt64(output.size);
+                writer->WriteString(output.writeTime);
+            }
+        }
+        writer->Close();
+    }
+}
+
+} // namespace ToolkitUtil
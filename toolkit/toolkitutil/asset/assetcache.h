@@ -0,0 +1,129 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class ToolkitUtil::AssetCache
+
+    Local content addressed cache of export results.
+
+    An asset is keyed by the hashes of everything it is built from (source
+    bytes, attribute files) and a settings string holding the exporter
+    version, platform and output names. A hit copies the stored outputs back
+    into place, which makes the result independent of file time stamps, so
+    branch switches and fresh checkouts only rebuild what actually changed.
+
+    Outputs are stored flat in the cache directory as <key>.<n>, next to a
+    <key>.manifest listing the dependencies and outputs of the asset. An index
+    keeps sizes and use order, and the cache is trimmed least recently used
+    first when it grows beyond its size limit.
+
+    Restore and Store are safe to call from jobs.
+
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "util/string.h"
+#include "util/array.h"
+#include "util/dictionary.h"
+#include "io/uri.h"
+#include "threading/criticalsection.h"
+#include "toolkit-common/logger.h"
+
+//------------------------------------------------------------------------------
+namespace ToolkitUtil
+{
+class AssetCache
+{
+public:
+    struct Dependency
+    {
+        Util::String file;
+        uint64 hash;
+    };
+
+    /// constructor
+    AssetCache();
+    /// destructor
+    ~AssetCache();
+
+    /// open the cache in a directory, maxSize is in bytes
+    bool Open(const IO::URI& dir, uint64 maxSize);
+    /// trim the cache and write the index
+    void Close();
+    /// returns true if the cache is open
+    bool IsOpen() const;
+    /// only store results, never restore them (for forced rebuilds)
+    void SetBypass(bool b);
+
+    /// add a file to the dependency list, missing files are recorded with a zero hash
+    static void AddDependency(Util::Array<Dependency>& dependencies, const Util::String& file);
+    /// compute the cache key from the dependencies and the export settings
+    static uint64 ComputeKey(const Util::Array<Dependency>& dependencies, const Util::String& settings);
+
+    /// restore the outputs stored for key, returns false on a miss
+    bool Restore(uint64 key);
+    /// store the outputs of an asset, outputs that don't exist are skipped
+    void Store(uint64 key, const Util::String& asset, const Util::Array<Dependency>& dependencies, const Util::Array<Util::String>& outputs);
+
+    /// remove least recently used entries until the cache fits its size limit
+    void Trim();
+    /// print hit rate and size
+    void PrintStats(Logger* logger) const;
+
+private:
+    struct Output
+    {
+        Util::String file;
+        uint64 size;
+        Util::String writeTime;     // write time of the file when it was stored or restored
+    };
+    struct Entry
+    {
+        Util::Array<Output> outputs;
+        uint64 size = 0;
+        uint64 lastUse = 0;
+    };
+
+    /// get the path of a stored output, or of the manifest if output is InvalidIndex
+    Util::String GetEntryPath(uint64 key, IndexT output) const;
+    /// delete the files of an entry
+    void DeleteEntry(uint64 key, const Entry& entry) const;
+    /// read the index
+    void LoadIndex();
+    /// write the index
+    void SaveIndex();
+
+    Threading::CriticalSection lock;
+    Util::Dictionary<uint64, Entry> entries;
+    Util::String dir;
+    uint64 maxSize;
+    uint64 size;
+    uint64 useCounter;
+    bool bypass;
+    bool isOpen;
+
+    SizeT hits;
+    SizeT misses;
+    SizeT upToDate;
+    uint64 bytesRestored;
+    uint64 bytesStored;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+AssetCache::IsOpen() const
+{
+    return this->isOpen;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+AssetCache::SetBypass(bool b)
+{
+    this->bypass = b;
+}
+
+} // namespace ToolkitUtil
+//------------------------------------------------------------------------------
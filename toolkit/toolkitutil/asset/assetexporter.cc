@@ -10,6 +10,9 @@
 #include "nflatbuffer/flatbufferinterface.h"
 #include "toolkit-common/text.h"
 #include "io/jsonreader.h"
+#include "jobs2/jobs2.h"
+#include "timing/timer.h"
+#include "threading/event.h"
 
 using namespace Util;
 using namespace IO;
@@ -17,13 +20,23 @@ namespace ToolkitUtil
 {
 __ImplementClass(ToolkitUtil::AssetExporter, 'ASEX', Core::RefCounted);
 
+// bump the version of a task type whenever its exporter changes its output, so cached results are rebuilt
+static const uint ExporterVersions[] = { 3, 3, 1, 2, 2, 1, 1, 1 };
+static const char* TaskNames[] = { "GLTF", "FBX", "Model", "Texture", "Cubemap", "Surface", "Audio", "Physics" };
+
 //------------------------------------------------------------------------------
 /**
 */
 AssetExporter::AssetExporter() :
-    mode(All)
+    cache(nullptr),
+    mode(All),
+    exportTime(0)
 {
-    // empty
+    for (IndexT i = 0; i < NumTaskTypes; i++)
+    {
+        this->taskTimes[i] = 0;
+        this->taskCounts[i] = 0;
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -43,7 +56,6 @@ AssetExporter::Open()
     ExporterBase::Open();
     this->surfaceExporter = ToolkitUtil::SurfaceExporter::Create();
     this->surfaceExporter->Open();
-    this->modelBuilder = ToolkitUtil::ModelBuilder::Create();
     this->textureExporter.Setup();
 }
 
@@ -55,7 +67,6 @@ AssetExporter::Close()
 {
     this->surfaceExporter->Close();
     this->surfaceExporter = nullptr;
-    this->modelBuilder = nullptr;
     this->textureExporter.Discard();
     this->textureAttrTable.Discard();
     ExporterBase::Close();
@@ -85,6 +96,38 @@ AssetExporter::ExportDir(const Util::String& category)
     this->ExportFolder(assetPath, category);
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AssetExporter::AddTask(Util::Array<ExportTask>& tasks, TaskType type, const Util::String& file)
+{
+    ExportTask task;
+    task.type = type;
+    task.file = file;
+
+    // models are built from what their source writes, and a source exported as both glTF and FBX
+    // writes the same files, so wait for the last source with the same name
+    if (type == GLTFTask || type == FBXTask || type == ModelTask)
+    {
+        String name = file;
+        name.StripFileExtension();
+        for (IndexT i = tasks.Size() - 1; i >= 0; i--)
+        {
+            if (tasks[i].type != GLTFTask && tasks[i].type != FBXTask)
+                continue;
+            String source = tasks[i].file;
+            source.StripFileExtension();
+            if (source == name)
+            {
+                task.dependency = i;
+                break;
+            }
+        }
+    }
+    tasks.Append(task);
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -97,112 +140,43 @@ AssetExporter::ExportFolder(const Util::String& assetPath, const Util::String& c
     IndexT fileIndex;
     ToolLog log(category);
     Ptr<ToolkitUtil::ToolkitConsoleHandler> console = ToolkitUtil::ToolkitConsoleHandler::Instance();
+    Array<ExportTask> tasks;
 
+    // plan the export, sources first so models can depend on them
     if (this->mode & ExportModes::GLTF)
     {
-        console->Clear();
-        // export GLTF sources
-
-        this->logger->Print("\nGLTFs ------------\n");
         Array<String> files = ioServer->ListFiles(assetPath, "*.gltf");
         files.AppendArray(ioServer->ListFiles(assetPath, "*.glb"));
-        this->gltfExporter = ToolkitUtil::NglTFExporter::Create();
-        this->gltfExporter->SetTextureConverter(&this->textureExporter);
-        this->gltfExporter->Open();
-        this->gltfExporter->SetForce(this->force || (this->mode & ExportModes::ForceGLTF) != 0);
-        this->gltfExporter->SetCategory(category);
-        this->gltfExporter->SetLogger(this->logger);
-        log.AddEntry(console, "GLTF", category);
-        if (files.IsEmpty())
-        {
-            this->logger->Print("Nothing to export\n");
-        }
-        else
-        {
-            for (fileIndex = 0; fileIndex < files.Size(); fileIndex++)
-            {
-                console->Clear();
-                this->gltfExporter->SetFile(files[fileIndex]);
-                this->gltfExporter->ExportFile(assetPath + files[fileIndex]);
-                log.AddEntry(console, "GLTF", files[fileIndex]);
-            }
-        }
-        this->gltfExporter->Close();
-        this->gltfExporter = nullptr;
+        for (fileIndex = 0; fileIndex < files.Size(); fileIndex++)
+            AddTask(tasks, GLTFTask, files[fileIndex]);
     }
 
     if (this->mode & ExportModes::FBX)
     {
-        this->logger->Print("\nFBXs ----------------\n");
-
-        // export FBX sources
         Array<String> files = ioServer->ListFiles(assetPath, "*.fbx");
-        this->fbxExporter = ToolkitUtil::NFbxExporter::Create();
-        this->fbxExporter->Open();
-        this->fbxExporter->SetForce(this->force || (this->mode & ExportModes::ForceFBX) != 0);
-        this->fbxExporter->SetCategory(category);
-        this->fbxExporter->SetLogger(this->logger);
-        log.AddEntry(console, "FBX", category);
-        if (files.IsEmpty())
-        {
-            this->logger->Print("Nothing to export\n");
-        }
-        else
-        {
-            for (fileIndex = 0; fileIndex < files.Size(); fileIndex++)
-            {
-                console->Clear();
-                this->fbxExporter->SetFile(files[fileIndex]);
-                this->fbxExporter->ExportFile(assetPath + files[fileIndex]);
-                log.AddEntry(console, "FBX", files[fileIndex]);
-            }
-        }
-        this->fbxExporter->Close();
-        this->fbxExporter = nullptr;
+        for (fileIndex = 0; fileIndex < files.Size(); fileIndex++)
+            AddTask(tasks, FBXTask, files[fileIndex]);
     }
 
     if (this->mode & ExportModes::Models)
     {
-        // export models
-        this->logger->Print("\nModels --------------\n");
+        // sources being exported will write attributes which may not exist yet
         Array<String> files = ioServer->ListFiles(assetPath, "*.attributes");
-        if (files.IsEmpty())
+        for (const ExportTask& task : tasks)
         {
-            this->logger->Print("Nothing to export\n");
-        }
-        else
-        {
-            for (fileIndex = 0; fileIndex < files.Size(); fileIndex++)
-            {
-                console->Clear();
-                String modelName = files[fileIndex];
-                modelName.StripFileExtension();
-                modelName = category + "/" + modelName;
-                Ptr<ModelConstants> constants = ModelDatabase::Instance()->LookupConstants(modelName, true);
-                Ptr<ModelAttributes> attributes = ModelDatabase::Instance()->LookupAttributes(modelName, true);
-                Ptr<ModelPhysics> physics = ModelDatabase::Instance()->LookupPhysics(modelName, true);
-
-                this->modelBuilder->SetConstants(constants);
-                this->modelBuilder->SetAttributes(attributes);
-                this->modelBuilder->SetPhysics(physics);
-
-                // save models and physics
-
-                String modelPath = String::Sprintf("mdl:%s.n3", modelName.AsCharPtr());
-                this->logger->Print("%s -> %s\n", Text(URI(assetPath + files[fileIndex]).LocalPath()).Color(TextColor::Blue).AsCharPtr(), Text(URI(modelPath).LocalPath()).Color(TextColor::Green).AsCharPtr());
-                this->modelBuilder->SaveN3(modelPath, this->platform);
-
-                String physicsPath = String::Sprintf("phys:%s.actor", modelName.AsCharPtr());
-                this->modelBuilder->SaveN3Physics(physicsPath, this->platform);
-
-                log.AddEntry(console, "Model", files[fileIndex]);
-            }
+            String attributes = task.file;
+            attributes.StripFileExtension();
+            attributes.Append(".attributes");
+            if (files.FindIndex(attributes) == InvalidIndex)
+                files.Append(attributes);
         }
+        files.Sort();
+        for (fileIndex = 0; fileIndex < files.Size(); fileIndex++)
+            AddTask(tasks, ModelTask, files[fileIndex]);
     }
 
     if (this->mode & ExportModes::Textures)
     {
-        // export textures
         Array<String> files = ioServer->ListFiles(assetPath, "*.tga");
         files.AppendArray(ioServer->ListFiles(assetPath, "*.bmp"));
         files.AppendArray(ioServer->ListFiles(assetPath, "*.dds"));
@@ -211,113 +185,461 @@ AssetExporter::ExportFolder(const Util::String& assetPath, const Util::String& c
         files.AppendArray(ioServer->ListFiles(assetPath, "*.exr"));
         files.AppendArray(ioServer->ListFiles(assetPath, "*.tif"));
         Array<String> cubes = ioServer->ListDirectories(assetPath, "*.cube");
+        for (fileIndex = 0; fileIndex < files.Size(); fileIndex++)
+            AddTask(tasks, TextureTask, files[fileIndex]);
+        for (fileIndex = 0; fileIndex < cubes.Size(); fileIndex++)
+            AddTask(tasks, CubemapTask, cubes[fileIndex]);
 
         this->textureExporter.SetForceFlag(this->force || (this->mode & ExportModes::ForceTextures) != 0);
-        this->textureExporter.SetLogger(this->logger);
+        this->textureExporter.SetLogger(&this->jobLogger);
+    }
 
-        this->logger->Print("\nTextures ------------\n");
-        Util::String dstDir = Util::String::Sprintf("tex:%s", category.AsCharPtr());
-        if (files.IsEmpty() && cubes.IsEmpty())
+    if (this->mode & ExportModes::Surfaces)
+    {
+        Array<String> files = ioServer->ListFiles(assetPath, "*.sur");
+        for (fileIndex = 0; fileIndex < files.Size(); fileIndex++)
+            AddTask(tasks, SurfaceTask, files[fileIndex]);
+
+        this->surfaceExporter->SetLogger(&this->jobLogger);
+        this->surfaceExporter->SetForce(this->force || (this->mode & ExportModes::ForceSurfaces) != 0);
+    }
+
+    if (this->mode & ExportModes::Audio)
+    {
+        Array<String> files = ioServer->ListFiles(assetPath, "*.wav");
+        files.AppendArray(ioServer->ListFiles(assetPath, "*.mp3"));
+        for (fileIndex = 0; fileIndex < files.Size(); fileIndex++)
+            AddTask(tasks, AudioTask, files[fileIndex]);
+        if (!files.IsEmpty())
+            ioServer->CreateDirectory(Util::String::Sprintf("dst:audio/%s", category.AsCharPtr()));
+    }
+
+    if (this->mode & ExportModes::Physics)
+    {
+        Array<String> files = ioServer->ListFiles(assetPath, "*.actor", true);
+        for (fileIndex = 0; fileIndex < files.Size(); fileIndex++)
+            AddTask(tasks, PhysicsTask, files[fileIndex]);
+    }
+
+    this->jobLogger.SetTarget(this->logger);
+    this->RunTasks(tasks, assetPath, category);
+
+    // flush the task logs in the order the sections are exported in
+    static const struct
+    {
+        unsigned int mode;
+        TaskType first, last;
+        const char* header;
+        const char* entry;
+    } sections[] =
+    {
+        { ExportModes::GLTF, GLTFTask, GLTFTask, "\nGLTFs ------------\n", "GLTF" },
+        { ExportModes::FBX, FBXTask, FBXTask, "\nFBXs ----------------\n", "FBX" },
+        { ExportModes::Models, ModelTask, ModelTask, "\nModels --------------\n", nullptr },
+        { ExportModes::Textures, TextureTask, CubemapTask, "\nTextures ------------\n", nullptr },
+        { ExportModes::Surfaces, SurfaceTask, SurfaceTask, "\nSurfaces ------------\n", nullptr },
+        { ExportModes::Audio, AudioTask, AudioTask, "\nAudio ---------------\n", nullptr },
+        { ExportModes::Physics, PhysicsTask, PhysicsTask, "\nPhysics -------------\n", nullptr }
+    };
+    static const char* entryNames[] = { "GLTF", "FBX", "Model", "Texture", "Texture", "Surface", "Audio", "Physics" };
+
+    for (const auto& section : sections)
+    {
+        if ((this->mode & section.mode) == 0)
+            continue;
+
+        console->Clear();
+        this->logger->Print(section.header);
+        if (section.entry != nullptr)
+            log.AddEntry(console, section.entry, category);
+
+        bool empty = true;
+        for (ExportTask& task : tasks)
+        {
+            if (task.type < section.first || task.type > section.last)
+                continue;
+            empty = false;
+
+            console->Clear();
+            this->jobLogger.Flush(task.log);
+            if (task.addLogEntry)
+                log.AddEntry(console, entryNames[task.type], task.file);
+            if (task.log.numErrors > 0)
+                this->SetHasErrors(true);
+        }
+        if (empty)
         {
             this->logger->Print("Nothing to export\n");
         }
-        else
+    }
+    this->messages.Append(log);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AssetExporter::RunTasks(Util::Array<ExportTask>& tasks, const Util::String& assetPath, const Util::String& category)
+{
+    if (tasks.IsEmpty())
+        return;
+
+    Timing::Timer timer;
+    timer.Start();
+
+    // one dispatch per task, so models can wait on the exact source they are built from
+    Util::FixedArray<Threading::AtomicCounter> counters(tasks.Size());
+    Util::FixedArray<const Threading::AtomicCounter*> allCounters(tasks.Size());
+    for (IndexT i = 0; i < tasks.Size(); i++)
+    {
+        counters[i] = 1;
+        auto job = [exporter = this, task = &tasks[i], assetPath = &assetPath, category = &category](SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocationOffset)
         {
-            for (fileIndex = 0; fileIndex < files.Size(); fileIndex++)
-            {
-                console->Clear();
-                Util::String dstFile = Util::String::Sprintf("%s/%s", dstDir.AsCharPtr(), files[fileIndex].AsCharPtr());
-                dstFile.StripFileExtension();
-                this->textureExporter.ConvertTexture(assetPath + files[fileIndex], dstFile, "temp:textureconverter");
-                log.AddEntry(console, "Texture", files[fileIndex]);
-            }
+            exporter->RunTask(*task, *assetPath, *category);
+        };
+
+        Util::FixedArray<const Threading::AtomicCounter*> waitCounters;
+        if (tasks[i].dependency != InvalidIndex)
+            waitCounters = { &counters[tasks[i].dependency] };
+        Jobs2::JobDispatch(job, 1, waitCounters, &counters[i]);
+        allCounters[i] = &counters[i];
+    }
 
-            for (fileIndex = 0; fileIndex < cubes.Size(); fileIndex++)
-            {
-                console->Clear();
-                Util::String dstFile = Util::String::Sprintf("%s/%s", dstDir.AsCharPtr(), cubes[fileIndex].AsCharPtr());
-                dstFile.StripFileExtension();
-                this->textureExporter.ConvertCubemap(assetPath + cubes[fileIndex], dstFile, "temp:textureconverter");
-                log.AddEntry(console, "Texture", cubes[fileIndex]);
-            }
+    // wait for all tasks
+    Threading::Event event;
+    Jobs2::JobDispatch([](SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocationOffset) {}, 1, allCounters, nullptr, &event);
+    event.Wait();
+
+    // tasks allocate scratch memory for nested work, which is safe to reclaim now
+    Jobs2::JobNewFrame();
+
+    timer.Stop();
+    this->exportTime += timer.GetTime();
+    for (const ExportTask& task : tasks)
+    {
+        this->taskTimes[task.type] += task.time;
+        this->taskCounts[task.type]++;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AssetExporter::RunTask(ExportTask& task, const Util::String& assetPath, const Util::String& category)
+{
+    Timing::Timer timer;
+    timer.Start();
+    this->jobLogger.BeginBuffer(&task.log);
+
+    // the console log is per thread
+    ToolkitUtil::ToolkitConsoleHandler::Instance()->Clear();
+
+    // copying audio is as fast as restoring it
+    const bool cached = this->cache != nullptr && task.type != AudioTask;
+    Util::Array<AssetCache::Dependency> dependencies;
+    uint64 key = 0;
+    if (cached)
+    {
+        this->CollectDependencies(task, assetPath, category, dependencies);
+        String settings = String::Sprintf("%s %d %s %s/%s",
+            TaskNames[task.type],
+            ExporterVersions[task.type],
+            Platform::ToString(this->platform).AsCharPtr(),
+            category.AsCharPtr(),
+            task.file.AsCharPtr());
+        key = AssetCache::ComputeKey(dependencies, settings);
+        task.cacheHit = this->cache->Restore(key);
+    }
+
+    if (task.cacheHit)
+    {
+        this->jobLogger.Print("%s restored from cache\n", Text(URI(assetPath + task.file).LocalPath()).Color(TextColor::Blue).AsCharPtr());
+    }
+    else
+    {
+        this->Export(task, assetPath, category);
+        if (cached && task.exported)
+        {
+            Util::Array<Util::String> outputs;
+            this->CollectOutputs(task, category, outputs);
+            this->cache->Store(key, category + "/" + task.file, dependencies, outputs);
         }
     }
 
-    if (this->mode & ExportModes::Surfaces)
+    this->jobLogger.EndBuffer();
+    timer.Stop();
+    task.time = timer.GetTime();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AssetExporter::Export(ExportTask& task, const Util::String& assetPath, const Util::String& category)
+{
+    // the model database is per thread
+    Ptr<ModelDatabase> modelDatabase;
+    if ((task.type == GLTFTask || task.type == FBXTask || task.type == ModelTask) && !ModelDatabase::HasInstance())
     {
-        this->logger->Print("\nSurfaces ------------\n");
-        Array<String> files = ioServer->ListFiles(assetPath, "*.sur");
-        this->surfaceExporter->SetLogger(this->logger);
-        this->surfaceExporter->SetForce(this->force || (this->mode & ExportModes::ForceSurfaces) != 0);
-        if (files.IsEmpty())
+        modelDatabase = ModelDatabase::Create();
+        modelDatabase->Open();
+    }
+
+    switch (task.type)
+    {
+        case GLTFTask:
         {
-            this->logger->Print("Nothing to export\n");
+            Ptr<NglTFExporter> exporter = NglTFExporter::Create();
+            exporter->SetTextureConverter(&this->textureExporter);
+            exporter->Open();
+            exporter->SetForce(this->force || (this->mode & ExportModes::ForceGLTF) != 0);
+            exporter->SetCategory(category);
+            exporter->SetLogger(&this->jobLogger);
+            exporter->SetFile(task.file);
+            exporter->ExportFile(assetPath + task.file);
+            exporter->Close();
+            break;
+        }
+        case FBXTask:
+        {
+            Ptr<NFbxExporter> exporter = NFbxExporter::Create();
+            exporter->Open();
+            exporter->SetForce(this->force || (this->mode & ExportModes::ForceFBX) != 0);
+            exporter->SetCategory(category);
+            exporter->SetLogger(&this->jobLogger);
+            exporter->SetFile(task.file);
+            exporter->ExportFile(assetPath + task.file);
+            exporter->Close();
+            break;
         }
-        else
+        case ModelTask:
         {
-            for (fileIndex = 0; fileIndex < files.Size(); fileIndex++)
+            String modelName = task.file;
+            modelName.StripFileExtension();
+            modelName = category + "/" + modelName;
+
+            // planned for a source that failed to write its attributes
+            if (!ModelDatabase::Instance()->AttributesExist(modelName))
             {
-                console->Clear();
-                this->surfaceExporter->ExportFile(assetPath + files[fileIndex]);
-                log.AddEntry(console, "Surface", files[fileIndex]);
+                task.addLogEntry = false;
+                task.exported = false;
+                break;
             }
-        }
-    }
 
-    if (this->mode & ExportModes::Audio)
-    {
-        this->logger->Print("\nAudio ---------------\n");
-        Array<String> files = ioServer->ListFiles(assetPath, "*.wav");
-        files.AppendArray(ioServer->ListFiles(assetPath, "*.mp3"));
-        if (files.IsEmpty())
+            Ptr<ModelConstants> constants = ModelDatabase::Instance()->LookupConstants(modelName, true);
+            Ptr<ModelAttributes> attributes = ModelDatabase::Instance()->LookupAttributes(modelName, true);
+            Ptr<ModelPhysics> physics = ModelDatabase::Instance()->LookupPhysics(modelName, true);
+
+            Ptr<ModelBuilder> modelBuilder = ModelBuilder::Create();
+            modelBuilder->SetConstants(constants);
+            modelBuilder->SetAttributes(attributes);
+            modelBuilder->SetPhysics(physics);
+
+            // save models and physics
+            String modelPath = String::Sprintf("mdl:%s.n3", modelName.AsCharPtr());
+            this->jobLogger.Print("%s -> %s\n", Text(URI(assetPath + task.file).LocalPath()).Color(TextColor::Blue).AsCharPtr(), Text(URI(modelPath).LocalPath()).Color(TextColor::Green).AsCharPtr());
+            modelBuilder->SaveN3(modelPath, this->platform);
+
+            String physicsPath = String::Sprintf("phys:%s.actor", modelName.AsCharPtr());
+            modelBuilder->SaveN3Physics(physicsPath, this->platform);
+            break;
+        }
+        case TextureTask:
+        case CubemapTask:
         {
-            this->logger->Print("Nothing to export\n");
+            Util::String dstFile = Util::String::Sprintf("tex:%s/%s", category.AsCharPtr(), task.file.AsCharPtr());
+            dstFile.StripFileExtension();
+            if (task.type == TextureTask)
+                this->textureExporter.ConvertTexture(assetPath + task.file, dstFile, "temp:textureconverter");
+            else
+                this->textureExporter.ConvertCubemap(assetPath + task.file, dstFile, "temp:textureconverter");
+            break;
         }
-        else
+        case SurfaceTask:
+            this->surfaceExporter->ExportFile(assetPath + task.file);
+            break;
+        case AudioTask:
         {
-            Util::String dstDir = Util::String::Sprintf("dst:audio/%s", category.AsCharPtr());
-            ioServer->CreateDirectory(dstDir);
-
-            for (fileIndex = 0; fileIndex < files.Size(); fileIndex++)
+            Util::String dstFile = Util::String::Sprintf("dst:audio/%s/%s", category.AsCharPtr(), task.file.AsCharPtr());
+            this->jobLogger.Print("%s -> %s\n", Text(URI(assetPath + task.file).LocalPath()).Color(TextColor::Blue).AsCharPtr(), Text(URI(dstFile).LocalPath()).Color(TextColor::Green).AsCharPtr());
+            IoServer::Instance()->CopyFile(assetPath + task.file, dstFile);
+            break;
+        }
+        case PhysicsTask:
+        {
+            Util::String dstDir = Util::String::Sprintf("dst:physics/%s", category.AsCharPtr());
+            Util::String dstFile = Util::String::Sprintf("%s/%s", dstDir.AsCharPtr(), task.file.ExtractFileName().AsCharPtr());
+            if (this->mode & ExportModes::ForcePhysics || NeedsConversion(task.file, dstFile))
             {
-                console->Clear();
-                Util::String dstFile = Util::String::Sprintf("%s/%s", dstDir.AsCharPtr(), files[fileIndex].AsCharPtr());
-                this->logger->Print("%s -> %s\n", Text(URI(assetPath + files[fileIndex]).LocalPath()).Color(TextColor::Blue).AsCharPtr(), Text(URI(dstFile).LocalPath()).Color(TextColor::Green).AsCharPtr());
-                ioServer->CopyFile(assetPath + files[fileIndex], dstFile);
-                log.AddEntry(console, "Audio", files[fileIndex]);
+                Flat::FlatbufferInterface::Compile(task.file, dstDir, "ACTO");
+                this->jobLogger.Print("%s -> %s\n", Text(Format("%s", task.file.AsCharPtr())).Color(TextColor::Blue).AsCharPtr(), Text(URI(dstFile).LocalPath()).Color(TextColor::Green).Style(FontMode::Underline).AsCharPtr());
             }
+            else
+            {
+                this->jobLogger.Print("Skipping %s\n", Text(task.file).Color(TextColor::Blue).AsCharPtr());
+                task.addLogEntry = false;
+            }
+            break;
         }
+        default:
+            n_error("Unhandled export task type");
     }
-    if (this->mode & ExportModes::Physics)
+
+    if (modelDatabase.isvalid())
     {
-        this->logger->Print("\nPhysics -------------\n");
-        Array<String> files = ioServer->ListFiles(assetPath, "*.actor", true);
-        Util::String dstDir = Util::String::Sprintf("dst:physics/%s", category.AsCharPtr());
+        modelDatabase->Close();
+        modelDatabase = nullptr;
+    }
+}
 
-        if (files.IsEmpty())
-        {
-            this->logger->Print("Nothing to export\n");
-        }
-        else
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AssetExporter::CollectDependencies(const ExportTask& task, const Util::String& assetPath, const Util::String& category, Util::Array<AssetCache::Dependency>& dependencies) const
+{
+    String name = task.file;
+    name.StripFileExtension();
+    String source = task.type == PhysicsTask ? task.file : assetPath + task.file;
+    String attributes = String::Sprintf("src:assets/%s/%s", category.AsCharPtr(), name.AsCharPtr());
+
+    switch (task.type)
+    {
+        case GLTFTask:
         {
-            for (auto const& file : files)
+            AssetCache::AddDependency(dependencies, source);
+            AssetCache::AddDependency(dependencies, attributes + ".attributes");
+
+            // external buffers and images
+            if (task.file.CheckFileExtension("gltf"))
             {
-                Util::String dstFile = Util::String::Sprintf("%s/%s", dstDir.AsCharPtr(), file.ExtractFileName().AsCharPtr());
-                
-                if (this->mode & ExportModes::ForcePhysics || NeedsConversion(file, dstFile))
+                String text;
+                if (IoServer::ReadFile(source, text))
                 {
-                    Flat::FlatbufferInterface::Compile(file, dstDir, "ACTO");
-                    log.AddEntry(console, "Physics", file);
-                    this->logger->Print("%s -> %s\n", Text(Format("%s", file.AsCharPtr())).Color(TextColor::Blue).AsCharPtr(), Text(URI(dstFile).LocalPath()).Color(TextColor::Green).Style(FontMode::Underline).AsCharPtr());
-                }
-                else
-                {
-                    this->logger->Print("Skipping %s\n", Text(file).Color(TextColor::Blue).AsCharPtr());
+                    Array<String> uris;
+                    const char* cur = strstr(text.AsCharPtr(), "\"uri\"");
+                    while (cur != nullptr)
+                    {
+                        const char* begin = strchr(cur + 5, '"');
+                        const char* end = begin != nullptr ? strchr(begin + 1, '"') : nullptr;
+                        if (end == nullptr)
+                            break;
+                        String uri;
+                        uri.Set(begin + 1, SizeT(end - begin - 1));
+                        if (!uri.BeginsWithString("data:") && uris.FindIndex(uri) == InvalidIndex)
+                            uris.Append(uri);
+                        cur = strstr(end + 1, "\"uri\"");
+                    }
+                    for (const String& uri : uris)
+                        AssetCache::AddDependency(dependencies, assetPath + uri);
                 }
             }
+            break;
+        }
+        case FBXTask:
+            AssetCache::AddDependency(dependencies, source);
+            AssetCache::AddDependency(dependencies, attributes + ".attributes");
+            break;
+        case ModelTask:
+            AssetCache::AddDependency(dependencies, attributes + ".attributes");
+            AssetCache::AddDependency(dependencies, attributes + ".constants");
+            AssetCache::AddDependency(dependencies, attributes + ".physics");
+            break;
+        case TextureTask:
+            // the texture attributes are stored next to the texture
+            AssetCache::AddDependency(dependencies, source);
+            AssetCache::AddDependency(dependencies, attributes + ".xml");
+            break;
+        case CubemapTask:
+        {
+            Array<String> faces = IoServer::Instance()->ListFiles(source, "*");
+            for (const String& face : faces)
+                AssetCache::AddDependency(dependencies, source + "/" + face);
+            AssetCache::AddDependency(dependencies, attributes + ".xml");
+            break;
         }
+        default:
+            AssetCache::AddDependency(dependencies, source);
+            break;
     }
-    this->messages.Append(log);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AssetExporter::CollectOutputs(const ExportTask& task, const Util::String& category, Util::Array<Util::String>& outputs) const
+{
+    IoServer* ioServer = IoServer::Instance();
+    String name = task.file.ExtractFileName();
+    name.StripFileExtension();
+    const char* cat = category.AsCharPtr();
+    const char* file = name.AsCharPtr();
+
+    // outputs with a converter specific extension
+    auto addMatching = [&outputs, ioServer](const String& dir, const String& pattern)
+    {
+        Array<String> files = ioServer->ListFiles(dir, pattern);
+        for (const String& file : files)
+            outputs.Append(dir + "/" + file);
+    };
+
+    switch (task.type)
+    {
+        case GLTFTask:
+        case FBXTask:
+            outputs.Append(String::Sprintf("msh:%s/%s.nvx", cat, file));
+            outputs.Append(String::Sprintf("msh:%s/%s_ph.nvx", cat, file));
+            outputs.Append(String::Sprintf("ani:%s/%s.nax", cat, file));
+            outputs.Append(String::Sprintf("ske:%s/%s.nsk", cat, file));
+            outputs.Append(String::Sprintf("mdl:%s/%s.n3", cat, file));
+            outputs.Append(String::Sprintf("phys:%s/%s.actor", cat, file));
+            outputs.Append(String::Sprintf("src:assets/%s/%s.attributes", cat, file));
+            outputs.Append(String::Sprintf("src:assets/%s/%s.constants", cat, file));
+            outputs.Append(String::Sprintf("src:assets/%s/%s.physics", cat, file));
+            if (task.type == GLTFTask)
+                addMatching(String::Sprintf("tex:%s/%s", cat, file), "*");
+            break;
+        case ModelTask:
+            outputs.Append(String::Sprintf("mdl:%s/%s.n3", cat, file));
+            outputs.Append(String::Sprintf("phys:%s/%s.actor", cat, file));
+            break;
+        case TextureTask:
+        case CubemapTask:
+            addMatching(String::Sprintf("tex:%s", cat), name + ".*");
+            break;
+        case SurfaceTask:
+            outputs.Append(String::Sprintf("sur:%s/%s.sur", cat, file));
+            break;
+        case PhysicsTask:
+            addMatching(String::Sprintf("dst:physics/%s", cat), name + ".*");
+            break;
+        default:
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AssetExporter::PrintTimeSummary()
+{
+    static const char* typeNames[] = { "GLTF", "FBX", "Models", "Textures", "Cubemaps", "Surfaces", "Audio", "Physics" };
+
+    Timing::Time total = 0;
+    for (IndexT i = 0; i < NumTaskTypes; i++)
+        total += this->taskTimes[i];
+
+    this->logger->Print("\nExport time ---------\n");
+    for (IndexT i = 0; i < NumTaskTypes; i++)
+    {
+        if (this->taskCounts[i] == 0)
+            continue;
+        this->logger->Print("%-10s %5d assets %9.2f s (%5.1f%%)\n", typeNames[i], this->taskCounts[i], this->taskTimes[i], total > 0 ? 100.0 * this->taskTimes[i] / total : 0.0);
+    }
+    this->logger->Print("Total      %9.2f s of work in %.2f s\n", total, this->exportTime);
 }
 
 //------------------------------------------------------------------------------
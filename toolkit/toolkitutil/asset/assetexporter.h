@@ -6,6 +6,14 @@
     The asset exporter takes a single directory and exports any models, textures and gfx-sources.
 
     This isn't based on an exporter class, because it has no need for incremental batching.
+
+    Every file in a directory becomes an export task, and the tasks are run as jobs. Models
+    depend on the glTF/FBX source of the same name, since the source export writes the attributes,
+    constants and physics the model is built from, everything else runs independently. Tasks log
+    into their own buffer which is flushed in directory order once all tasks are done.
+
+    With an AssetCache set, a task first looks up its outputs by the hash of its inputs and
+    only exports on a miss.
     
     (C) 2015-2016 Individual contributors, see AUTHORS file
 */
@@ -19,6 +27,9 @@
 #include "surface/surfaceexporter.h"
 #include "toolkit-common/toolkitconsolehandler.h"
 #include "model/import/gltf/ngltfexporter.h"
+#include "toolkit-common/bufferedlogger.h"
+#include "asset/assetcache.h"
+#include "timing/time.h"
 
 namespace ToolkitUtil
 {
@@ -75,21 +86,76 @@ public:
 
     /// set export mode flag
     void SetExportMode(unsigned int mode);
+    /// set cache to restore unchanged assets from
+    void SetCache(AssetCache* cache);
     
     /// get failed files (if any)
     const Util::Array<ToolkitUtil::ToolLog> & GetMessages() const;
+    /// print the time spent exporting each type of asset
+    void PrintTimeSummary();
 
 private:
-    Ptr<ToolkitUtil::NFbxExporter> fbxExporter;
-    Ptr<ToolkitUtil::NglTFExporter> gltfExporter;
+    enum TaskType
+    {
+        GLTFTask,
+        FBXTask,
+        ModelTask,
+        TextureTask,
+        CubemapTask,
+        SurfaceTask,
+        AudioTask,
+        PhysicsTask,
+
+        NumTaskTypes
+    };
+
+    struct ExportTask
+    {
+        TaskType type;
+        Util::String file;
+        IndexT dependency = InvalidIndex;
+        bool addLogEntry = true;
+        bool exported = true;
+        bool cacheHit = false;
+        BufferedLogger::Buffer log;
+        Timing::Time time = 0;
+    };
+
+    /// add a task exporting file
+    static void AddTask(Util::Array<ExportTask>& tasks, TaskType type, const Util::String& file);
+    /// run all tasks as jobs and wait for them to finish
+    void RunTasks(Util::Array<ExportTask>& tasks, const Util::String& assetPath, const Util::String& category);
+    /// run a single task, called from a job
+    void RunTask(ExportTask& task, const Util::String& assetPath, const Util::String& category);
+    /// export the asset of a task
+    void Export(ExportTask& task, const Util::String& assetPath, const Util::String& category);
+    /// get the files the output of a task is built from
+    void CollectDependencies(const ExportTask& task, const Util::String& assetPath, const Util::String& category, Util::Array<AssetCache::Dependency>& dependencies) const;
+    /// get the files written by a task
+    void CollectOutputs(const ExportTask& task, const Util::String& category, Util::Array<Util::String>& outputs) const;
+
     ToolkitUtil::TextureConverter textureExporter;
     Ptr<ToolkitUtil::SurfaceExporter> surfaceExporter;
-    Ptr<ToolkitUtil::ModelBuilder> modelBuilder;    
     ToolkitUtil::TextureAttrTable textureAttrTable;
+    ToolkitUtil::BufferedLogger jobLogger;
+    AssetCache* cache;
     unsigned int mode;
     Util::Array<ToolLog> messages;
+
+    Timing::Time taskTimes[NumTaskTypes];
+    SizeT taskCounts[NumTaskTypes];
+    Timing::Time exportTime;
 };
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+AssetExporter::SetCache(AssetCache* cache)
+{
+    this->cache = cache;
+}
+
 __ImplementEnumBitOperators(AssetExporter::ExportModes);
 ///------------------------------------------------------------------------------
 /**
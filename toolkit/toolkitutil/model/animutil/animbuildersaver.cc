@@ -7,6 +7,7 @@
 #include "model/animutil/animbuildersaver.h"
 #include "io/ioserver.h"
 #include "coreanimation/naxfileformatstructs.h"
+#include "coreanimation/animcompression.h"
 
 namespace ToolkitUtil
 {
@@ -20,7 +21,7 @@ using namespace Math;
 /**
 */
 bool
-AnimBuilderSaver::Save(const URI& uri, const Util::Array<AnimBuilder>& animBuilders, Platform::Code platform)
+AnimBuilderSaver::Save(const URI& uri, const Util::Array<AnimBuilder>& animBuilders, Platform::Code platform, bool compress)
 {
     // make sure the target directory exists
     IoServer::Instance()->CreateDirectory(uri.LocalPath().ExtractDirName());
@@ -30,8 +31,11 @@ AnimBuilderSaver::Save(const URI& uri, const Util::Array<AnimBuilder>& animBuild
     if (stream->Open())
     {
         ByteOrder byteOrder(ByteOrder::Host, Platform::GetPlatformByteOrder(platform));
-        AnimBuilderSaver::WriteHeader(stream, animBuilders, byteOrder);
-        AnimBuilderSaver::WriteAnimations(stream, animBuilders, byteOrder);
+        AnimBuilderSaver::WriteHeader(stream, animBuilders, byteOrder, compress);
+        if (compress)
+            AnimBuilderSaver::WriteCompressedAnimations(stream, animBuilders, byteOrder);
+        else
+            AnimBuilderSaver::WriteAnimations(stream, animBuilders, byteOrder);
 
         stream->Close();
         stream = nullptr;
@@ -48,11 +52,11 @@ AnimBuilderSaver::Save(const URI& uri, const Util::Array<AnimBuilder>& animBuild
 /**
 */
 void
-AnimBuilderSaver::WriteHeader(const Ptr<Stream>& stream, const Util::Array<AnimBuilder>& animBuilders, const ByteOrder& byteOrder)
+AnimBuilderSaver::WriteHeader(const Ptr<Stream>& stream, const Util::Array<AnimBuilder>& animBuilders, const ByteOrder& byteOrder, bool compress)
 {
     // setup header
     Nax3Header nax3Header;
-    nax3Header.magic         = byteOrder.Convert<uint>(NEBULA_NAX3_MAGICNUMBER);
+    nax3Header.magic         = byteOrder.Convert<uint>(compress ? NEBULA_NAXC_MAGICNUMBER : NEBULA_NAX3_MAGICNUMBER);
     nax3Header.numAnimations = byteOrder.Convert(animBuilders.Size());
 
     // write header
@@ -118,35 +122,7 @@ AnimBuilderSaver::WriteAnimations(const Ptr<IO::Stream>& stream, const Util::Arr
             }
         }
 
-        for (const auto& animEvent : anim.events)
-        {
-            Nax3AnimEvent nax3AnimEvent;
-
-            // check name restrictions
-            const String& eventName = animEvent.name.AsString();
-            const String& categoryName = animEvent.category.AsString();
-            if (eventName.Length() >= sizeof(nax3AnimEvent.name))
-            {
-                n_error("AnimBuilderSaver: Anim event name too long! (file=%s, event=%s)\n",
-                    stream->GetURI().LocalPath().AsCharPtr(),
-                    eventName.AsCharPtr());
-            }
-            if (categoryName.Length() >= sizeof(nax3AnimEvent.category))
-            {
-                n_error("AnimBuilderServer: Anim event category too long! (file=%s, event=%s, category=%s)\n",
-                    stream->GetURI().LocalPath().AsCharPtr(),
-                    eventName.AsCharPtr(),
-                    categoryName.AsCharPtr());
-            }
-
-            // write event attributes
-            nax3AnimEvent.keyIndex = byteOrder.Convert(animEvent.time);
-            eventName.CopyToBuffer(&(nax3AnimEvent.name[0]), sizeof(nax3AnimEvent.name));
-            categoryName.CopyToBuffer(&(nax3AnimEvent.category[0]), sizeof(nax3AnimEvent.category));
-
-            // write anim event to stream
-            stream->Write(&nax3AnimEvent, sizeof(nax3AnimEvent));
-        }
+        AnimBuilderSaver::WriteEvents(stream, anim, byteOrder);
 
         uint curveOffset = 0, eventOffset = 0, velocityCurveOffset = 0;
         SizeT numClips = anim.GetNumClips();
@@ -194,4 +170,378 @@ AnimBuilderSaver::WriteAnimations(const Ptr<IO::Stream>& stream, const Util::Arr
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+    Largest error allowed when dropping keys, in radians for rotations and units for the others
+*/
+static const float RotationTolerance = 0.001f;
+static const float TranslationTolerance = 0.0005f;
+static const float ScaleTolerance = 0.0005f;
+
+/// segment duration in ticks, key times within a segment are stored in 16 bits
+static const Timing::Tick SegmentDuration = 500;
+
+//------------------------------------------------------------------------------
+/**
+*/
+static Math::vec4
+GetCurveKey(const AnimBuilder& anim, const AnimBuilderCurve& curve, IndexT key)
+{
+    if (curve.curveType == CurveType::Rotation)
+    {
+        const float* ptr = &anim.keys[curve.firstKeyOffset + key * 4];
+        return Math::vec4(ptr[0], ptr[1], ptr[2], ptr[3]);
+    }
+    else
+    {
+        const float* ptr = &anim.keys[curve.firstKeyOffset + key * 3];
+        return Math::vec4(ptr[0], ptr[1], ptr[2], 0.0f);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static Math::vec4
+InterpolateCurveKeys(const AnimBuilderCurve& curve, const Math::vec4& key0, const Math::vec4& key1, float weight)
+{
+    if (curve.curveType == CurveType::Rotation)
+        return Math::slerp(Math::quat(key0), Math::quat(key1), weight).vec;
+    else
+        return Math::lerp(key0, key1, weight);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static bool
+IsWithinTolerance(const AnimBuilderCurve& curve, const Math::vec4& key, const Math::vec4& approximation)
+{
+    if (curve.curveType == CurveType::Rotation)
+    {
+        // angle between the rotations, q and -q are the same rotation
+        const float cosHalfAngle = Math::min(Math::abs(Math::dot(key, approximation)), 1.0f);
+        return 2.0f * Math::acos(cosHalfAngle) <= RotationTolerance;
+    }
+    else
+    {
+        const float tolerance = curve.curveType == CurveType::Scale ? ScaleTolerance : TranslationTolerance;
+        const Math::vec4 diff = Math::abs(key - approximation);
+        return diff.x <= tolerance && diff.y <= tolerance && diff.z <= tolerance;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Evaluate a curve from its kept keys, clamped to the first and last key
+*/
+static Math::vec4
+EvaluateReducedCurve(const AnimBuilder& anim, const AnimBuilderCurve& curve, const Util::Array<IndexT>& keptKeys, Timing::Tick time)
+{
+    IndexT i;
+    for (i = 0; i < keptKeys.Size() - 1; i++)
+    {
+        const Timing::Tick end = anim.keyTimes[curve.firstTimeOffset + keptKeys[i + 1]];
+        if (time < end)
+            break;
+    }
+    if (i == keptKeys.Size() - 1)
+        return GetCurveKey(anim, curve, keptKeys.Back());
+
+    const Timing::Tick start = anim.keyTimes[curve.firstTimeOffset + keptKeys[i]];
+    const Timing::Tick end = anim.keyTimes[curve.firstTimeOffset + keptKeys[i + 1]];
+    const float weight = end > start ? Math::clamp(float(time - start) / float(end - start), 0.0f, 1.0f) : 0.0f;
+    return InterpolateCurveKeys(curve, GetCurveKey(anim, curve, keptKeys[i]), GetCurveKey(anim, curve, keptKeys[i + 1]), weight);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Greedily extend every kept key as far as all keys in between stay within tolerance
+    when interpolated, always keeps the first and last key.
+    Returns true if the curve is constant within tolerance.
+*/
+static bool
+ReduceCurveKeys(const AnimBuilder& anim, const AnimBuilderCurve& curve, Util::Array<IndexT>& outKeptKeys)
+{
+    const SizeT numKeys = curve.numKeys;
+    const Math::vec4 firstKey = GetCurveKey(anim, curve, 0);
+    bool constant = true;
+    IndexT key;
+    for (key = 1; key < numKeys && constant; key++)
+        constant = IsWithinTolerance(curve, GetCurveKey(anim, curve, key), firstKey);
+
+    outKeptKeys.Append(0);
+    if (constant)
+    {
+        outKeptKeys.Append(numKeys - 1);
+        return true;
+    }
+
+    IndexT anchor = 0;
+    while (anchor < numKeys - 1)
+    {
+        const Math::vec4 anchorKey = GetCurveKey(anim, curve, anchor);
+        const Timing::Tick anchorTime = anim.keyTimes[curve.firstTimeOffset + anchor];
+        IndexT end = anchor + 1;
+        while (end + 1 < numKeys)
+        {
+            // try to drop every key up to and including end
+            const IndexT candidate = end + 1;
+            const Math::vec4 candidateKey = GetCurveKey(anim, curve, candidate);
+            const Timing::Tick candidateTime = anim.keyTimes[curve.firstTimeOffset + candidate];
+            bool withinTolerance = true;
+            for (key = anchor + 1; key < candidate && withinTolerance; key++)
+            {
+                const Timing::Tick time = anim.keyTimes[curve.firstTimeOffset + key];
+                const float weight = candidateTime > anchorTime ? float(time - anchorTime) / float(candidateTime - anchorTime) : 0.0f;
+                withinTolerance = IsWithinTolerance(curve, GetCurveKey(anim, curve, key), InterpolateCurveKeys(curve, anchorKey, candidateKey, weight));
+            }
+            if (!withinTolerance)
+                break;
+            end = candidate;
+        }
+        outKeptKeys.Append(end);
+        anchor = end;
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AnimBuilderSaver::WriteCompressedAnimations(const Ptr<IO::Stream>& stream, const Util::Array<AnimBuilder>& animBuilders, const System::ByteOrder& byteOrder)
+{
+    for (auto& anim : animBuilders)
+    {
+        // reduce keys and find the quantization range of every curve
+        Util::FixedArray<Util::Array<IndexT>> keptKeys(anim.curves.Size());
+        Util::FixedArray<bool> constantCurves(anim.curves.Size());
+        Util::FixedArray<NaxcCurve> naxcCurves(anim.curves.Size());
+        IndexT curveIndex;
+        for (curveIndex = 0; curveIndex < anim.curves.Size(); curveIndex++)
+        {
+            const AnimBuilderCurve& curve = anim.curves[curveIndex];
+            NaxcCurve& naxcCurve = naxcCurves[curveIndex];
+            Memory::Clear(&naxcCurve, sizeof(NaxcCurve));
+            naxcCurve.preInfinityType = curve.preInfinityType;
+            naxcCurve.postInfinityType = curve.postInfinityType;
+            naxcCurve.curveType = curve.curveType;
+            constantCurves[curveIndex] = false;
+
+            // curves with less than two keys are inactive and sample the idle pose
+            if (curve.numKeys < 2)
+                continue;
+
+            constantCurves[curveIndex] = ReduceCurveKeys(anim, curve, keptKeys[curveIndex]);
+            naxcCurve.numKeys = keptKeys[curveIndex].Size();
+
+            Math::vec4 min = GetCurveKey(anim, curve, keptKeys[curveIndex][0]);
+            Math::vec4 max = min;
+            for (IndexT key : keptKeys[curveIndex])
+            {
+                min = Math::minimize(min, GetCurveKey(anim, curve, key));
+                max = Math::maximize(max, GetCurveKey(anim, curve, key));
+            }
+
+            // constant curves store their key as the range minimum
+            if (constantCurves[curveIndex])
+                GetCurveKey(anim, curve, 0).storeu(naxcCurve.rangeMin);
+            else if (curve.curveType != CurveType::Rotation)
+            {
+                min.storeu(naxcCurve.rangeMin);
+                (max - min).storeu3(naxcCurve.rangeExtent);
+            }
+        }
+
+        // cut clips into segments, each holding the keys of all clip curves within its time span
+        Util::Array<NaxcSegment> segments;
+        Util::Array<ushort> segmentData;
+        Util::FixedArray<NaxcClip> naxcClips(anim.GetNumClips());
+        uint curveOffset = 0, eventOffset = 0, velocityCurveOffset = 0;
+        IndexT clipIndex;
+        for (clipIndex = 0; clipIndex < anim.GetNumClips(); clipIndex++)
+        {
+            const AnimBuilderClip& clip = anim.GetClipAtIndex(clipIndex);
+            NaxcClip& naxcClip = naxcClips[clipIndex];
+            Memory::Clear(&naxcClip, sizeof(NaxcClip));
+
+            // check clip name restrictions
+            const String& clipName = clip.GetName().AsString();
+            if (clipName.Length() >= sizeof(naxcClip.name))
+            {
+                n_error("AnimBuilderSaver: Clip name '%s' is too long (%s)!\n", clipName.AsCharPtr(), stream->GetURI().LocalPath().AsCharPtr());
+            }
+            clipName.CopyToBuffer(&(naxcClip.name[0]), sizeof(naxcClip.name));
+            naxcClip.firstCurve = curveOffset;
+            naxcClip.numCurves = clip.numCurves;
+            naxcClip.firstEvent = eventOffset;
+            naxcClip.numEvents = clip.numEvents;
+            naxcClip.firstVelocityCurve = velocityCurveOffset;
+            naxcClip.numVelocityCurves = clip.numVelocityCurves;
+            naxcClip.duration = clip.duration;
+            naxcClip.firstSegment = segments.Size();
+            naxcClip.numSegments = Math::max(1, (clip.duration + SegmentDuration - 1) / SegmentDuration);
+            naxcClip.segmentDuration = SegmentDuration;
+
+            IndexT segmentIndex;
+            for (segmentIndex = 0; segmentIndex < (IndexT)naxcClip.numSegments; segmentIndex++)
+            {
+                const Timing::Tick start = segmentIndex * SegmentDuration;
+                const Timing::Tick end = Math::min(start + SegmentDuration, clip.duration);
+
+                Util::Array<ushort> keyCounts;
+                Util::Array<ushort> keyTimes;
+                keyCounts.Reserve(clip.numCurves);
+                Util::Array<ushort> keys;
+                IndexT i;
+                for (i = 0; i < (IndexT)clip.numCurves; i++)
+                {
+                    const IndexT index = curveOffset + i;
+                    const AnimBuilderCurve& curve = anim.curves[index];
+                    const NaxcCurve& naxcCurve = naxcCurves[index];
+                    if (naxcCurve.numKeys == 0 || constantCurves[index])
+                    {
+                        keyCounts.Append(0);
+                        continue;
+                    }
+
+                    // keys on the segment bounds make every segment self contained
+                    Util::Array<Timing::Tick> times;
+                    times.Append(start);
+                    for (IndexT key : keptKeys[index])
+                    {
+                        const Timing::Tick time = anim.keyTimes[curve.firstTimeOffset + key];
+                        if (time > start && time < end)
+                            times.Append(time);
+                    }
+                    if (end > start)
+                        times.Append(end);
+
+                    for (Timing::Tick time : times)
+                    {
+                        const Math::vec4 value = EvaluateReducedCurve(anim, curve, keptKeys[index], time);
+                        float values[4];
+                        value.storeu(values);
+                        ushort packed[3];
+                        if (curve.curveType == CurveType::Rotation)
+                            AnimPackQuaternion(values, packed);
+                        else
+                            AnimPackRange(values, naxcCurve.rangeMin, naxcCurve.rangeExtent, packed);
+
+                        keyTimes.Append(ushort(time - start));
+                        keys.AppendArray(packed, 3);
+                    }
+                    keyCounts.Append(times.Size());
+                }
+
+                NaxcSegment segment;
+                segment.start = start;
+                segment.end = end;
+                segment.dataOffset = segmentData.Size() * sizeof(ushort);
+                segment.numKeys = keyTimes.Size();
+                segments.Append(segment);
+
+                segmentData.AppendArray(keyCounts);
+                segmentData.AppendArray(keyTimes);
+                segmentData.AppendArray(keys);
+
+                // keep segments 4 byte aligned
+                if (segmentData.Size() % 2 != 0)
+                    segmentData.Append(0);
+            }
+
+            curveOffset += clip.numCurves;
+            eventOffset += clip.numEvents;
+            velocityCurveOffset += clip.numVelocityCurves;
+        }
+
+        // write header
+        NaxcAnim naxc;
+        naxc.numClips = byteOrder.Convert<ushort>(anim.GetNumClips());
+        naxc.numCurves = byteOrder.Convert<ushort>(anim.curves.Size());
+        naxc.numEvents = byteOrder.Convert<ushort>(anim.events.Size());
+        naxc.numSegments = byteOrder.Convert<uint>(segments.Size());
+        naxc.segmentDataSize = byteOrder.Convert<uint>(segmentData.Size() * sizeof(ushort));
+        stream->Write(&naxc, sizeof(naxc));
+
+        for (NaxcCurve& naxcCurve : naxcCurves)
+        {
+            for (float& value : naxcCurve.rangeMin)
+                byteOrder.ConvertInPlace(value);
+            for (float& value : naxcCurve.rangeExtent)
+                byteOrder.ConvertInPlace(value);
+            byteOrder.ConvertInPlace(naxcCurve.numKeys);
+            stream->Write(&naxcCurve, sizeof(NaxcCurve));
+        }
+
+        AnimBuilderSaver::WriteEvents(stream, anim, byteOrder);
+
+        for (NaxcClip& naxcClip : naxcClips)
+        {
+            byteOrder.ConvertInPlace(naxcClip.numCurves);
+            byteOrder.ConvertInPlace(naxcClip.firstCurve);
+            byteOrder.ConvertInPlace(naxcClip.numEvents);
+            byteOrder.ConvertInPlace(naxcClip.firstEvent);
+            byteOrder.ConvertInPlace(naxcClip.numVelocityCurves);
+            byteOrder.ConvertInPlace(naxcClip.firstVelocityCurve);
+            byteOrder.ConvertInPlace(naxcClip.duration);
+            byteOrder.ConvertInPlace(naxcClip.firstSegment);
+            byteOrder.ConvertInPlace(naxcClip.numSegments);
+            byteOrder.ConvertInPlace(naxcClip.segmentDuration);
+            stream->Write(&naxcClip, sizeof(NaxcClip));
+        }
+
+        for (NaxcSegment& segment : segments)
+        {
+            byteOrder.ConvertInPlace(segment.start);
+            byteOrder.ConvertInPlace(segment.end);
+            byteOrder.ConvertInPlace(segment.dataOffset);
+            byteOrder.ConvertInPlace(segment.numKeys);
+            stream->Write(&segment, sizeof(NaxcSegment));
+        }
+
+        for (ushort& value : segmentData)
+            byteOrder.ConvertInPlace(value);
+        stream->Write(segmentData.Begin(), segmentData.Size() * sizeof(ushort));
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AnimBuilderSaver::WriteEvents(const Ptr<IO::Stream>& stream, const AnimBuilder& anim, const System::ByteOrder& byteOrder)
+{
+    for (const auto& animEvent : anim.events)
+    {
+        Nax3AnimEvent nax3AnimEvent;
+
+        // check name restrictions
+        const String& eventName = animEvent.name.AsString();
+        const String& categoryName = animEvent.category.AsString();
+        if (eventName.Length() >= sizeof(nax3AnimEvent.name))
+        {
+            n_error("AnimBuilderSaver: Anim event name too long! (file=%s, event=%s)\n",
+                stream->GetURI().LocalPath().AsCharPtr(),
+                eventName.AsCharPtr());
+        }
+        if (categoryName.Length() >= sizeof(nax3AnimEvent.category))
+        {
+            n_error("AnimBuilderServer: Anim event category too long! (file=%s, event=%s, category=%s)\n",
+                stream->GetURI().LocalPath().AsCharPtr(),
+                eventName.AsCharPtr(),
+                categoryName.AsCharPtr());
+        }
+
+        // write event attributes
+        nax3AnimEvent.keyIndex = byteOrder.Convert(animEvent.time);
+        eventName.CopyToBuffer(&(nax3AnimEvent.name[0]), sizeof(nax3AnimEvent.name));
+        categoryName.CopyToBuffer(&(nax3AnimEvent.category[0]), sizeof(nax3AnimEvent.category));
+
+        // write anim event to stream
+        stream->Write(&nax3AnimEvent, sizeof(nax3AnimEvent));
+    }
+}
+
 } // namespace ToolkitUtil
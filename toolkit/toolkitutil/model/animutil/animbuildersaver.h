@@ -4,6 +4,10 @@
     @class ToolkitUtil::AnimBuilderSaver
     
     Save AnimBuilder object into NAX3 file.
+
+    With compression enabled, the keys of every curve are reduced until the
+    interpolation error would exceed a per curve type tolerance, quantized
+    and written in time segments (see CoreAnimation::NaxcCurve).
     
     (C) 2009 Radon Labs GmbH
     (C) 2013-2016 Individual contributors, see AUTHORS file
@@ -20,14 +24,18 @@ namespace ToolkitUtil
 class AnimBuilderSaver
 {
 public:
-    /// Save NAX3 file
-    static bool Save(const IO::URI& uri, const Util::Array<AnimBuilder>& animBuilders, Platform::Code platform);
+    /// Save NAX3 file, or compressed NAXC file
+    static bool Save(const IO::URI& uri, const Util::Array<AnimBuilder>& animBuilders, Platform::Code platform, bool compress = false);
 
 private:
     /// Write header to stream
-    static void WriteHeader(const Ptr<IO::Stream>& stream, const Util::Array<AnimBuilder>& animBuilders, const System::ByteOrder& byteOrder);
+    static void WriteHeader(const Ptr<IO::Stream>& stream, const Util::Array<AnimBuilder>& animBuilders, const System::ByteOrder& byteOrder, bool compress);
     /// Write anim header to stream
     static void WriteAnimations(const Ptr<IO::Stream>& stream, const Util::Array<AnimBuilder>& animBuilders, const System::ByteOrder& byteOrder);
+    /// Write compressed animations to stream
+    static void WriteCompressedAnimations(const Ptr<IO::Stream>& stream, const Util::Array<AnimBuilder>& animBuilders, const System::ByteOrder& byteOrder);
+    /// Write anim events to stream
+    static void WriteEvents(const Ptr<IO::Stream>& stream, const AnimBuilder& anim, const System::ByteOrder& byteOrder);
 };
 
 } // namespace ToolkitUtil
@@ -14,6 +14,8 @@
 
 #include "model/modelwriter.h"
 #include "model/meshutil/meshbuildersaver.h"
+#include "model/meshutil/meshoptimizer.h"
+#include "model/meshutil/meshsimplifier.h"
 
 #include "model/import/gltf/node/ngltfscene.h"
 #include "model/import/base/uniquestring.h"
@@ -117,6 +119,25 @@ ModelExporter::ExportFile(const IO::URI& file)
     Util::Array<MeshBuilder*> mergedMeshes;
     this->scene->OptimizeGraphics(mergedMeshNodes, mergedCharacterNodes, mergedGroups, mergedMeshes);
 
+    // simplified levels of detail share the vertices of their source groups
+    const ModelAttributes::LodSettings& lodSettings = attributes->GetLodSettings();
+    if (lodSettings.numLods > 0)
+    {
+        this->GenerateLods(lodSettings, mergedMeshNodes, mergedGroups, mergedMeshes);
+    }
+
+    // order triangles and vertices for the vertex cache, overdraw and vertex fetch
+    if (!AllBits(this->exportFlags, ToolkitUtil::SkipMeshOptimization))
+    {
+        for (MeshBuilder* mesh : mergedMeshes)
+        {
+            MeshOptimizer::Stats before = MeshOptimizer::AnalyzeVertexCache(*mesh);
+            MeshOptimizer::Optimize(*mesh, mergedGroups);
+            MeshOptimizer::Stats after = MeshOptimizer::AnalyzeVertexCache(*mesh);
+            this->logger->Print("Optimized %d triangles: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n", mesh->GetNumTriangles(), before.acmr, after.acmr, before.atvr, after.atvr);
+        }
+    }
+
     Util::String physicsMeshExportName = String::Sprintf("msh:%s/%s_ph.nvx", this->category.AsCharPtr(), this->file.AsCharPtr());
     IO::URI destinationFiles[] =
     {
@@ -135,13 +156,21 @@ ModelExporter::ExportFile(const IO::URI& file)
     };
 
     // save mesh to file
-    if (!MeshBuilderSaver::Save(destinationFiles[DestinationFile::Mesh], mergedMeshes, mergedGroups, this->platform))
+    const bool quantize = !AllBits(this->exportFlags, ToolkitUtil::SkipVertexQuantization);
+    MeshBuilderSaver::QuantizationStats quantizationStats;
+    if (!MeshBuilderSaver::Save(destinationFiles[DestinationFile::Mesh], mergedMeshes, mergedGroups, this->platform, quantize, &quantizationStats))
     {
         this->logger->Error("Failed to save NVX file : % s\n", destinationFiles[DestinationFile::Mesh].LocalPath().AsCharPtr());
     }
     else
     {
         outputFiles.Append(destinationFiles[DestinationFile::Mesh]);
+        if (quantize)
+        {
+            this->logger->Print("Quantized vertices %.1f KB -> %.1f KB: position error %.5f, normal error %.2f deg, skin weight error %.4f, %d components unquantized\n",
+                quantizationStats.rawBytes / 1024.0f, quantizationStats.quantizedBytes / 1024.0f,
+                quantizationStats.maxPositionError, quantizationStats.maxNormalError, quantizationStats.maxSkinWeightError, quantizationStats.numFallbacks);
+        }
     }
     
 
@@ -197,7 +226,7 @@ ModelExporter::ExportFile(const IO::URI& file)
         }
 
         // now save actual animation
-        if (!AnimBuilderSaver::Save(destinationFiles[DestinationFile::Animation], this->scene->animations, this->platform))
+        if (!AnimBuilderSaver::Save(destinationFiles[DestinationFile::Animation], this->scene->animations, this->platform, AllBits(this->exportFlags, ToolkitUtil::CompressAnimations)))
         {
             this->logger->Error("Failed to save animation file: %s\n", destinationFiles[DestinationFile::Animation].LocalPath().AsCharPtr());
         }
@@ -250,6 +279,108 @@ ModelExporter::ExportFile(const IO::URI& file)
     this->scene = nullptr;
 }
 
+//------------------------------------------------------------------------------
+/**
+    Every level is simplified from the previous one, skins simplify each
+    fragment separately so the triangles keep their joint palettes. Generation
+    stops early when a level no longer reduces the triangle count noticeably
+    or the error limit is reached. The simplified triangles are only appended
+    once all nodes are done, since the simplifier locks positions used
+    outside of the range it works on.
+*/
+void
+ModelExporter::GenerateLods(const ModelAttributes::LodSettings& settings, const Util::Array<SceneNode*>& meshNodes, Util::Array<MeshBuilderGroup>& groups, const Util::Array<MeshBuilder*>& meshes)
+{
+    struct PendingLod
+    {
+        IndexT mesh;
+        IndexT group;
+        Util::Array<MeshBuilderTriangle> triangles;
+    };
+    Util::Array<PendingLod> pending;
+
+    // position ids only depend on the vertices, which stay the same until the levels are appended
+    Util::FixedArray<Util::FixedArray<IndexT>> posIds(meshes.Size());
+
+    for (SceneNode* node : meshNodes)
+    {
+        // authored levels of detail are kept as they are
+        if (node->mesh.lodIndex != InvalidIndex)
+            continue;
+
+        const MeshBuilder& mesh = *meshes[node->mesh.meshIndex];
+        Util::FixedArray<IndexT>& meshPosIds = posIds[node->mesh.meshIndex];
+        if (meshPosIds.Size() != mesh.GetNumVertices())
+            MeshSimplifier::FindPositionIds(mesh, meshPosIds);
+        Util::Array<IndexT> sourceGroups;
+        if (node->base.isSkin)
+            sourceGroups = node->skin.skinFragments;
+        else
+            sourceGroups.Append(node->mesh.groupId);
+
+        Util::Array<Util::Array<MeshBuilderTriangle>> current;
+        SizeT sourceTriangles = 0;
+        for (IndexT i = 0; i < sourceGroups.Size(); i++)
+        {
+            const MeshBuilderGroup& group = groups[sourceGroups[i]];
+            Util::Array<MeshBuilderTriangle> triangles;
+            triangles.Reserve(group.GetNumTriangles());
+            for (IndexT j = 0; j < group.GetNumTriangles(); j++)
+                triangles.Append(mesh.TriangleAt(group.GetFirstTriangleIndex() + j));
+            current.Append(triangles);
+            sourceTriangles += group.GetNumTriangles();
+        }
+
+        Util::String report = Util::String::Sprintf("%d", sourceTriangles);
+        SizeT previousTriangles = sourceTriangles;
+        float ratio = 1.0f;
+        float distance = settings.distance;
+        for (IndexT level = 1; level <= settings.numLods; level++)
+        {
+            ratio *= settings.triangleRatio;
+            Util::Array<Util::Array<MeshBuilderTriangle>> next;
+            SizeT levelTriangles = 0;
+            float levelError = 0.0f;
+            for (IndexT i = 0; i < sourceGroups.Size(); i++)
+            {
+                const MeshBuilderGroup& group = groups[sourceGroups[i]];
+                const SizeT target = (SizeT)(group.GetNumTriangles() * ratio);
+                Util::Array<MeshBuilderTriangle> triangles;
+                levelError = Math::max(levelError, MeshSimplifier::Simplify(mesh, meshPosIds, group, current[i], target, settings.maxError, triangles));
+                levelTriangles += triangles.Size();
+                next.Append(triangles);
+            }
+
+            // a level which barely reduces anything isn't worth its draw calls
+            if (levelTriangles == 0 || levelTriangles > previousTriangles * 0.95f)
+                break;
+
+            for (IndexT i = 0; i < sourceGroups.Size(); i++)
+            {
+                node->mesh.lodGroups.Append(groups.Size());
+                pending.Append({ node->mesh.meshIndex, groups.Size(), next[i] });
+                groups.Append(MeshBuilderGroup());
+            }
+            node->mesh.lodDistances.Append(distance);
+            distance *= settings.distanceFactor;
+
+            report.Append(Util::String::Sprintf(" -> %d (%.2f%%)", levelTriangles, levelError * 100.0f));
+            previousTriangles = levelTriangles;
+            current = next;
+        }
+        this->logger->Print("LODs %s: %s triangles\n", node->base.name.AsCharPtr(), report.AsCharPtr());
+    }
+
+    for (const PendingLod& lod : pending)
+    {
+        MeshBuilder* mesh = meshes[lod.mesh];
+        groups[lod.group].SetFirstTriangleIndex(mesh->GetNumTriangles());
+        groups[lod.group].SetNumTriangles(lod.triangles.Size());
+        for (const MeshBuilderTriangle& triangle : lod.triangles)
+            mesh->AddTriangle(triangle);
+    }
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -11,6 +11,7 @@
 #include "toolkit-common/base/exporttypes.h"
 #include "toolkitutil/texutil/textureconverter.h"
 #include "model/import/base/scene.h"
+#include "model/modelutil/modelattributes.h"
 namespace ToolkitUtil
 {
 
@@ -40,6 +41,8 @@ public:
 protected:
     /// checks whether or not a file needs to be updated 
     bool NeedsConversion(const Util::String& path);
+    /// generate simplified levels of detail for the merged mesh nodes, appended as new groups
+    void GenerateLods(const ModelAttributes::LodSettings& settings, const Util::Array<SceneNode*>& meshNodes, Util::Array<MeshBuilderGroup>& groups, const Util::Array<MeshBuilder*>& meshes);
 
     ToolkitUtil::ExportFlags exportFlags;
     float sceneScale;
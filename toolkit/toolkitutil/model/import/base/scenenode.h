@@ -136,6 +136,8 @@ private:
         Util::String                                    material;
         IndexT                                          lodIndex = InvalidIndex;
         IndexT                                          meshIndex = InvalidIndex;
+        Util::Array<IndexT>                             lodGroups;      // groups of generated levels, level major with one group per skin fragment
+        Util::Array<float>                              lodDistances;   // view distance at which each generated level starts
         //ToolkitUtil::MeshBuilderVertex::ComponentMask   components;
         //ToolkitUtil::MeshBuilder                        mesh;
     } mesh;
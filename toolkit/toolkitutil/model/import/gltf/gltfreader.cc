@@ -13,14 +13,7 @@
 #include "io/ioserver.h"
 #include "io/filestream.h"
 #include "io/memorystream.h"
-
-#ifdef min
-#undef min
-#endif
-#ifdef max
-#undef max
-#endif
-#include "pjson/pjson.h"
+#include "io/jsonindex.h"
 
 #pragma warning( disable : 4307 )
 
@@ -37,23 +30,18 @@ constexpr unsigned int chash(const char* c, int h = 0)
 /**
 */
 void
-ReadExtensionsAndExtras(Gltf::GltfBase& base, const pjson::value_variant* object)
+ReadExtensionsAndExtras(Gltf::GltfBase& base, const IO::JsonIndex* index, IndexT object)
 {
-    int extsIdx = object->find_key("extensions");
-    if (extsIdx >= 0)
+    // keep the json text of the values as it is
+    IndexT exts = index->FindChild(object, "extensions");
+    if (exts != InvalidIndex)
     {
-        //FIXME overload this with native nebula type
-        pjson::char_vec_t vec;
-        object->get_value_at_index(extsIdx).serialize(vec);
-        base.extensions = &vec[0];
+        base.extensions = Util::String(index->GetRaw(exts));
     }
-    int extrasIdx = object->find_key("extras");
-    if (extrasIdx >= 0)
+    IndexT extras = index->FindChild(object, "extras");
+    if (extras != InvalidIndex)
     {
-        //FIXME overload this with native nebula type
-        pjson::char_vec_t vec;
-        object->get_value_at_index(extrasIdx).serialize(vec);
-        base.extras = &vec[0];
+        base.extras = Util::String(index->GetRaw(extras));
     }
 }
 
@@ -88,7 +76,7 @@ IO::JsonReader::Get<Gltf::Accessor::Sparse::Indices>(Gltf::Accessor::Sparse::Ind
     this->Get(item.bufferView, "bufferView");
     this->GetOpt(item.byteOffset, "byteOffset");
     item.componentType = static_cast<Gltf::Accessor::ComponentType>(this->GetInt("componentType"));
-    ReadExtensionsAndExtras(item, this->curNode);
+    ReadExtensionsAndExtras(item, this->index, this->curNode);
     this->SetToParent();
 }
 
@@ -101,7 +89,7 @@ IO::JsonReader::Get<Gltf::Accessor::Sparse::Values>(Gltf::Accessor::Sparse::Valu
     n_assert(this->SetToFirstChild(key));
     this->Get(item.bufferView, "bufferView");
     this->GetOpt(item.byteOffset, "byteOffset");
-    ReadExtensionsAndExtras(item, this->curNode);
+    ReadExtensionsAndExtras(item, this->index, this->curNode);
     this->SetToParent();
 }
 
@@ -117,7 +105,7 @@ IO::JsonReader::GetOpt<Gltf::Accessor::Sparse>(Gltf::Accessor::Sparse& item, con
         this->Get(item.count, "count");
         this->Get(item.indices, "indices");
         this->Get(item.values, "values");
-        ReadExtensionsAndExtras(item, this->curNode);
+        ReadExtensionsAndExtras(item, this->index, this->curNode);
         this->SetToParent();
         return true;
     }
@@ -265,7 +253,7 @@ IO::JsonReader::Get<Util::Array<Gltf::Animation::Sampler>>(Util::Array<Gltf::Ani
         this->Get(item.input, "input");
         this->Get(item.output, "output");
         this->GetOpt(item.interpolation, "interpolation");
-        ReadExtensionsAndExtras(item, this->curNode);
+        ReadExtensionsAndExtras(item, this->index, this->curNode);
     } while (this->SetToNextChild());
     this->SetToParent();
 }
@@ -281,7 +269,7 @@ IO::JsonReader::Get<Gltf::Animation::Channel::Target>(Gltf::Animation::Channel::
     this->SetToFirstChild(key);
     this->GetOpt(item.node, "node");
     this->Get(item.path, "path");
-    ReadExtensionsAndExtras(item, this->curNode);
+    ReadExtensionsAndExtras(item, this->index, this->curNode);
     this->SetToParent();
 }
 
@@ -302,7 +290,7 @@ IO::JsonReader::Get<Util::Array<Gltf::Animation::Channel>>(Util::Array<Gltf::Ani
         Gltf::Animation::Channel& item = items[i++];
         this->Get(item.sampler, "sampler");
         this->Get(item.target, "target");
-        ReadExtensionsAndExtras(item, this->curNode);
+        ReadExtensionsAndExtras(item, this->index, this->curNode);
     } while (this->SetToNextChild());
     this->SetToParent();
 }
@@ -325,7 +313,7 @@ IO::JsonReader::GetOpt<Util::Array<Gltf::Animation>>(Util::Array<Gltf::Animation
             this->Get(item.channels, "channels");
             this->Get(item.samplers, "samplers");
             this->GetOpt(item.name, "name");
-            ReadExtensionsAndExtras(item, this->curNode);
+            ReadExtensionsAndExtras(item, this->index, this->curNode);
         } while (this->SetToNextChild());
         this->SetToParent();
         this->SetToParent();
@@ -360,7 +348,7 @@ IO::JsonReader::GetOpt<Util::Array<Gltf::Buffer>>(Util::Array<Gltf::Buffer>& ite
             item.data.Reserve(byteLength);
             Util::String folder = this->stream->GetURI().AsString().ExtractDirName();
             item.Load(folder);
-            ReadExtensionsAndExtras(item, this->curNode);
+            ReadExtensionsAndExtras(item, this->index, this->curNode);
         } while (this->SetToNextChild());
         this->SetToParent();
         this->SetToParent();
@@ -395,7 +383,7 @@ IO::JsonReader::GetOpt<Util::Array<Gltf::BufferView>>(Util::Array<Gltf::BufferVi
             {
                 item.target = static_cast<Gltf::BufferView::TargetType>(target);
             }
-            ReadExtensionsAndExtras(item, this->curNode);
+            ReadExtensionsAndExtras(item, this->index, this->curNode);
         } while (this->SetToNextChild());
         this->SetToParent();
         this->SetToParent();
@@ -416,7 +404,7 @@ IO::JsonReader::Get<Gltf::Camera::Perspective>(Gltf::Camera::Perspective& item,
     this->Get(item.znear, "znear");
     this->GetOpt(item.zfar, "zfar");
     this->GetOpt(item.aspectRatio, "aspectRatio");
-    ReadExtensionsAndExtras(item, this->curNode);
+    ReadExtensionsAndExtras(item, this->index, this->curNode);
     this->SetToParent();
 }
 
@@ -431,7 +419,7 @@ IO::JsonReader::Get<Gltf::Camera::Orthographic>(Gltf::Camera::Orthographic& item
     this->Get(item.ymag, "ymag");
     this->Get(item.zfar, "zfar");
     this->Get(item.znear, "znear");
-    ReadExtensionsAndExtras(item, this->curNode);
+    ReadExtensionsAndExtras(item, this->index, this->curNode);
     this->SetToParent();
 }
 
@@ -474,7 +462,7 @@ IO::JsonReader::GetOpt<Util::Array<Gltf::Camera>>(Util::Array<Gltf::Camera>& ite
                 case Gltf::Camera::Type::Perspective: this->Get(item.perspective, "perspective"); break;
                 case Gltf::Camera::Type::Orthographic: this->Get(item.orthographic, "orthographic"); break;
             }
-            ReadExtensionsAndExtras(item, this->curNode);
+            ReadExtensionsAndExtras(item, this->index, this->curNode);
         } while (this->SetToNextChild());
         this->SetToParent();
         this->SetToParent();
@@ -518,7 +506,7 @@ IO::JsonReader::GetOpt<Gltf::Material::Texture>(Gltf::Material::Texture& item, c
     {
         this->Get(item.index, "index");
         this->GetOpt(item.texCoord, "texCoord");
-        ReadExtensionsAndExtras(item, this->curNode);
+        ReadExtensionsAndExtras(item, this->index, this->curNode);
         this->SetToParent();
         return true;
     }
@@ -537,7 +525,7 @@ IO::JsonReader::GetOpt<Gltf::Material::NormalTexture>(Gltf::Material::NormalText
     {
         this->SetToFirstChild(key);
         this->GetOpt(item.scale, "scale");
-        ReadExtensionsAndExtras(item, this->curNode);
+        ReadExtensionsAndExtras(item, this->index, this->curNode);
         this->SetToParent();
         return true;
     }
@@ -555,7 +543,7 @@ IO::JsonReader::GetOpt<Gltf::Material::OcclusionTexture>(Gltf::Material::Occlusi
     {
         this->SetToFirstChild(key);
         this->GetOpt(item.strength, "strength");
-        ReadExtensionsAndExtras(item, this->curNode);
+        ReadExtensionsAndExtras(item, this->index, this->curNode);
         this->SetToParent();
         return true;
     }
@@ -575,7 +563,7 @@ IO::JsonReader::GetOpt<Gltf::Material::PBRMetallicRoughness>(Gltf::Material::PBR
         this->GetOpt(item.metallicFactor, "metallicFactor");
         this->GetOpt(item.metallicRoughnessTexture, "metallicRoughnessTexture");
         this->GetOpt(item.roughnessFactor, "roughnessFactor");
-        ReadExtensionsAndExtras(item, this->curNode);
+        ReadExtensionsAndExtras(item, this->index, this->curNode);
         this->SetToParent();
         return true;
     }
@@ -620,7 +608,7 @@ IO::JsonReader::GetOpt<Util::Array<Gltf::Material>>(Util::Array<Gltf::Material>&
                 this->SetToParent();
             }
             
-            ReadExtensionsAndExtras(item, this->curNode);
+            ReadExtensionsAndExtras(item, this->index, this->curNode);
         } while (this->SetToNextChild());
         this->SetToParent();
         this->SetToParent();
@@ -759,7 +747,7 @@ IO::JsonReader::Get<Util::Array<Gltf::Primitive>>(Util::Array<Gltf::Primitive>&
             }
             this->SetToParent();
         }
-        ReadExtensionsAndExtras(item, this->curNode);
+        ReadExtensionsAndExtras(item, this->index, this->curNode);
     } while (this->SetToNextChild());
     this->SetToParent();
 }
@@ -783,7 +771,7 @@ IO::JsonReader::GetOpt<Util::Array<Gltf::Mesh>>(Util::Array<Gltf::Mesh>& items,
             this->Get(item.primitives, "primitives");
             this->GetOpt(item.name, "name");
             this->GetOpt(item.weights, "weights");
-            ReadExtensionsAndExtras(item, this->curNode);
+            ReadExtensionsAndExtras(item, this->index, this->curNode);
         } while (this->SetToNextChild());
         this->SetToParent();
         this->SetToParent();
@@ -831,7 +819,7 @@ IO::JsonReader::GetOpt<Util::Array<Gltf::Node>>(Util::Array<Gltf::Node>& items,
             item.hasTRS |= this->GetOpt(item.scale, "scale");
             item.hasTRS |= this->GetOpt(item.translation, "translation");
 
-            ReadExtensionsAndExtras(item, this->curNode);
+            ReadExtensionsAndExtras(item, this->index, this->curNode);
         } while (this->SetToNextChild());
         this->SetToParent();
         this->SetToParent();
@@ -890,7 +878,7 @@ IO::JsonReader::GetOpt<Util::Array<Gltf::Image>>(Util::Array<Gltf::Image>& items
                     item.data.SetFromFile(fullPath);
                 }
             }
-            ReadExtensionsAndExtras(item, this->curNode);
+            ReadExtensionsAndExtras(item, this->index, this->curNode);
         } while (this->SetToNextChild());
         this->SetToParent();
         this->SetToParent();
@@ -920,7 +908,7 @@ IO::JsonReader::GetOpt<Util::Array<Gltf::Sampler>>(Util::Array<Gltf::Sampler>& i
             if (this->GetOpt(filter, "wrapS")) item.wrapS = static_cast<Gltf::Sampler::WrappingMode>(filter);
             if (this->GetOpt(filter, "wrapT")) item.wrapT = static_cast<Gltf::Sampler::WrappingMode>(filter);
             this->GetOpt(item.name, "name");
-            ReadExtensionsAndExtras(item, this->curNode);
+            ReadExtensionsAndExtras(item, this->index, this->curNode);
         } while (this->SetToNextChild());
         this->SetToParent();
         this->SetToParent();
@@ -946,7 +934,7 @@ IO::JsonReader::GetOpt<Util::Array<Gltf::Scene>>(Util::Array<Gltf::Scene>& items
             auto& item = items[i++];
             this->GetOpt(item.nodes, "nodes");
             this->GetOpt(item.name, "name");
-            ReadExtensionsAndExtras(item, this->curNode);
+            ReadExtensionsAndExtras(item, this->index, this->curNode);
         } while (this->SetToNextChild());
         this->SetToParent();
         this->SetToParent();
@@ -974,7 +962,7 @@ IO::JsonReader::GetOpt<Util::Array<Gltf::Skin>>(Util::Array<Gltf::Skin>& items,
             this->GetOpt(item.inverseBindMatrices, "inverseBindMatrices");
             this->GetOpt(item.skeleton, "skeleton");
             this->GetOpt(item.name, "name");
-            ReadExtensionsAndExtras(item, this->curNode);
+            ReadExtensionsAndExtras(item, this->index, this->curNode);
         } while (this->SetToNextChild());
         this->SetToParent();
         this->SetToParent();
@@ -1001,7 +989,7 @@ IO::JsonReader::GetOpt<Util::Array<Gltf::Texture>>(Util::Array<Gltf::Texture>& i
             this->GetOpt(item.sampler, "sampler");
             this->GetOpt(item.source, "source");
             this->GetOpt(item.name, "name");
-            ReadExtensionsAndExtras(item, this->curNode);
+            ReadExtensionsAndExtras(item, this->index, this->curNode);
         } while (this->SetToNextChild());
         this->SetToParent();
         this->SetToParent();
@@ -1032,7 +1020,7 @@ IO::JsonReader::Get<Gltf::Document>(Gltf::Document& item, const char* key)
     this->GetOpt(item.skins, "skins");
     this->GetOpt(item.textures, "textures");
 
-    ReadExtensionsAndExtras(item, this->curNode);
+    ReadExtensionsAndExtras(item, this->index, this->curNode);
 }
 namespace Gltf
 {
@@ -1097,7 +1085,7 @@ Document::Deserialize(Ptr<IO::Stream> const& stream, bool binary)
         return false;
     }
 
-    // binary file, must splice the input buffer into two separate streams because of how pjson works
+    // binary file, must splice the input buffer into two separate streams since the json reader needs the json part on its own
     Ptr<IO::StreamReader> streamReader = IO::StreamReader::Create();
     streamReader->SetStream(stream);
 
@@ -244,8 +244,13 @@ NglTFExporter::ParseScene()
                     }
                 }
             };
+            // when exporting from a job, convert the images inline rather than waiting on nested jobs
+            const bool nested = Jobs2::JobIsWorkerThread();
             Threading::Event event;
-            Jobs2::JobDispatch(job, gltfScene.images.Size(), 1, nullptr, nullptr, &event);
+            if (nested)
+                job(gltfScene.images.Size(), gltfScene.images.Size(), 0, 0);
+            else
+                Jobs2::JobDispatch(job, gltfScene.images.Size(), 1, nullptr, nullptr, &event);
 
             for (IndexT i = 0; i < gltfScene.images.Size(); i++)
             {
@@ -253,7 +258,8 @@ NglTFExporter::ParseScene()
                 outputFiles.Append(dstFile);
             }
 
-            event.Wait();
+            if (!nested)
+                event.Wait();
 
             // Delete temporary directory
             if (IO::IoServer::Instance()->DirectoryExists(tmpDir))
@@ -263,7 +269,8 @@ NglTFExporter::ParseScene()
             }
 
             // Reset scratch memory
-            Jobs2::JobNewFrame();
+            if (!nested)
+                Jobs2::JobNewFrame();
         }
     }
 
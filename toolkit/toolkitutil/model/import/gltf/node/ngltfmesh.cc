@@ -70,6 +70,15 @@ NglTFMesh::Setup(Util::Array<MeshBuilder>& meshes
         jobContext.outSceneNodes[i]->mesh.meshIndex = basePrimitive + i;
     }
 
+    if (Jobs2::JobIsWorkerThread())
+    {
+        // already running as a job (parallel asset export), waiting on nested jobs could
+        // starve the worker pool, so process the primitives inline. The scratch memory is
+        // reclaimed by whoever dispatched us
+        MeshPrimitiveFunc(gltfMesh->primitives.Size(), gltfMesh->primitives.Size(), 0, 0, &jobContext);
+        return;
+    }
+
     Threading::Event event;
     Jobs2::JobDispatch(MeshPrimitiveFunc, gltfMesh->primitives.Size(), 1, jobContext, nullptr, nullptr, &event);
 
@@ -5,6 +5,7 @@
 //------------------------------------------------------------------------------
 #include "foundation/stdneb.h"
 #include "meshbuilder.h"
+#include "jobs2/jobs2.h"
 
 namespace ToolkitUtil
 {
@@ -165,67 +166,245 @@ MeshBuilder::Transform(const mat4& m)
 
 //------------------------------------------------------------------------------
 /**
-    qsort() hook for Deflate() method.
+    Snap a float to its weld cell. -0 is mapped to +0 on the bit pattern so
+    both produce the same key, like they compare equal.
 */
-MeshBuilder* MeshBuilder::qsortData = 0;
-int
-__cdecl
-MeshBuilder::VertexSorter(const void* elm0, const void* elm1)
+static inline uint
+WeldSnap(float f, float tolerance)
 {
-    MeshBuilder* meshBuilder = qsortData;
-    int i0 = *(int*)elm0;
-    int i1 = *(int*)elm1;
-    const MeshBuilderVertex& v0 = meshBuilder->VertexAt(i0);
-    const MeshBuilderVertex& v1 = meshBuilder->VertexAt(i1);
-    return v0.Compare(v1);
+    const float snapped = tolerance > 0.0f ? floorf(f / tolerance + 0.5f) : f;
+    uint bits;
+    memcpy(&bits, &snapped, sizeof(bits));
+    if ((bits & 0x7fffffff) == 0)
+        bits = 0;
+    return bits;
 }
 
 //------------------------------------------------------------------------------
 /**
-    Cleanup the mesh. This removes redundant vertices and optionally record
-    the collapse history into a client-provided collapsMap. The collaps map
-    contains at each new vertex index the 'old' vertex indices which have
-    been collapsed into the new vertex.
+    Word-wise FNV-1a with a final avalanche, snapped coordinates have mostly
+    empty low mantissa bits which would otherwise cluster in the hash table.
 */
-void
-MeshBuilder::Deflate(FixedArray<Array<IndexT>>* collapsMap)
+static inline uint
+WeldHash(const uint* key, SizeT size)
 {
-    // generate a index remapping table and sorted vertex array
-    SizeT numVertices = this->GetNumVertices();
-    IndexT* indexMap = (IndexT*)Memory::Alloc(Memory::ScratchHeap, numVertices * sizeof(IndexT));
-    IndexT* sortMap = (IndexT*)Memory::Alloc(Memory::ScratchHeap, numVertices * sizeof(IndexT));
-    IndexT* shiftMap = (IndexT*)Memory::Alloc(Memory::ScratchHeap, numVertices * sizeof(IndexT));
-    IndexT i;
-    for (i = 0; i < numVertices; i++)
+    uint64 hash = 14695981039346656037ull;
+    for (IndexT i = 0; i < size; i++)
     {
-        indexMap[i] = i;
-        sortMap[i] = i;
+        hash ^= key[i];
+        hash *= 1099511628211ull;
     }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return (uint)hash;
+}
+
+//------------------------------------------------------------------------------
+/**
+    The key holds the same components MeshBuilderVertex::Compare() looks at,
+    so with zero tolerances two vertices have equal keys exactly when they
+    compare equal.
+*/
+SizeT
+MeshBuilder::WeldKey(const MeshBuilderVertex& v, const WeldTolerance& tolerance, uint* key)
+{
+    SizeT size = 0;
+    key[size++] = WeldSnap(v.base.position.x, tolerance.position);
+    key[size++] = WeldSnap(v.base.position.y, tolerance.position);
+    key[size++] = WeldSnap(v.base.position.z, tolerance.position);
+    key[size++] = WeldSnap(v.base.position.w, tolerance.position);
+    key[size++] = WeldSnap(v.base.uv.x, tolerance.uv);
+    key[size++] = WeldSnap(v.base.uv.y, tolerance.uv);
+
+    if (AllBits(v.componentMask, MeshBuilderVertex::Components::Normals))
+    {
+        key[size++] = WeldSnap(v.attributes.normal.normal.x, tolerance.normal);
+        key[size++] = WeldSnap(v.attributes.normal.normal.y, tolerance.normal);
+        key[size++] = WeldSnap(v.attributes.normal.normal.z, tolerance.normal);
+        key[size++] = WeldSnap(v.attributes.normal.tangent.x, tolerance.normal);
+        key[size++] = WeldSnap(v.attributes.normal.tangent.y, tolerance.normal);
+        key[size++] = WeldSnap(v.attributes.normal.tangent.z, tolerance.normal);
+    }
+    if (AllBits(v.componentMask, MeshBuilderVertex::Components::Color))
+    {
+        key[size++] = WeldSnap(v.attributes.color.color.x, tolerance.color);
+        key[size++] = WeldSnap(v.attributes.color.color.y, tolerance.color);
+        key[size++] = WeldSnap(v.attributes.color.color.z, tolerance.color);
+        key[size++] = WeldSnap(v.attributes.color.color.w, tolerance.color);
+    }
+    if (AllBits(v.componentMask, MeshBuilderVertex::Components::SecondUv))
+    {
+        key[size++] = WeldSnap(v.attributes.secondUv.uv2.x, tolerance.uv);
+        key[size++] = WeldSnap(v.attributes.secondUv.uv2.y, tolerance.uv);
+    }
+    if (AllBits(v.componentMask, MeshBuilderVertex::Components::SkinIndices | MeshBuilderVertex::Components::SkinWeights))
+    {
+        key[size++] = WeldSnap(v.attributes.skin.weights.x, tolerance.skinWeights);
+        key[size++] = WeldSnap(v.attributes.skin.weights.y, tolerance.skinWeights);
+        key[size++] = WeldSnap(v.attributes.skin.weights.z, tolerance.skinWeights);
+        key[size++] = WeldSnap(v.attributes.skin.weights.w, tolerance.skinWeights);
+        key[size++] = v.attributes.skin.indices.x;
+        key[size++] = v.attributes.skin.indices.y;
+        key[size++] = v.attributes.skin.indices.z;
+        key[size++] = v.attributes.skin.indices.w;
+    }
+    n_assert(size <= MaxWeldKeySize);
+    return size;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Finds for every vertex the lowest index of a vertex with the same weld
+    key and writes it to indexMap, all vertices which don't map to themselves
+    are flagged as redundant.
+
+    Vertices are hashed into an open addressing table which is filled
+    concurrently, a slot is claimed with a compare-exchange and then only
+    ever lowered to a smaller index of the same key, so once all inserts
+    are done every slot holds the first vertex of its key no matter in which
+    order the jobs ran. Big meshes are split into jobs over the vertex range,
+    when already running inside a job everything runs inline.
+*/
+void
+MeshBuilder::Weld(IndexT* indexMap)
+{
+    const SizeT numVertices = this->vertices.Size();
+    if (numVertices == 0)
+        return;
+
+    SizeT tableSize = 1;
+    while (tableSize < numVertices * 2)
+        tableSize <<= 1;
+    const uint tableMask = tableSize - 1;
+
+    uint* hashes = (uint*)Memory::Alloc(Memory::ScratchHeap, numVertices * sizeof(uint));
+    volatile int* table = (volatile int*)Memory::Alloc(Memory::ScratchHeap, tableSize * sizeof(int));
+    for (IndexT i = 0; i < tableSize; i++)
+        table[i] = InvalidIndex;
 
-    // generate a sorted index map (sort by X coordinate)
-    qsortData = this;
-    qsort(sortMap, numVertices, sizeof(IndexT), MeshBuilder::VertexSorter);
+    MeshBuilderVertex* vertices = this->vertices.Begin();
+    const WeldTolerance tolerance = this->weldTolerance;
 
-    // search sorted array for redundant vertices
-    IndexT baseIndex = 0;
-    for (baseIndex = 0; baseIndex < (numVertices - 1);)
+    auto hashFunc = [vertices, hashes, tolerance](SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocationOffset)
     {
-        IndexT nextIndex = baseIndex + 1;
-        while ((nextIndex < numVertices) &&
-            (this->vertices[sortMap[baseIndex]] == this->vertices[sortMap[nextIndex]]))
+        uint key[MaxWeldKeySize];
+        for (IndexT i = 0; i < groupSize; i++)
         {
-            // mark the vertex as invalid
-            this->vertices[sortMap[nextIndex]].SetFlag(MeshBuilderVertex::Redundant);
+            IndexT index = i + invocationOffset;
+            if (index >= totalJobs)
+                return;
+            hashes[index] = WeldHash(key, WeldKey(vertices[index], tolerance, key));
+        }
+    };
+
+    auto insertFunc = [vertices, hashes, table, tableMask, tolerance](SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocationOffset)
+    {
+        uint key[MaxWeldKeySize], otherKey[MaxWeldKeySize];
+        for (IndexT i = 0; i < groupSize; i++)
+        {
+            IndexT index = i + invocationOffset;
+            if (index >= totalJobs)
+                return;
+
+            const SizeT keySize = WeldKey(vertices[index], tolerance, key);
+            const uint hash = hashes[index];
+            uint slot = hash & tableMask;
+            while (true)
+            {
+                int other = table[slot];
+                if (other == InvalidIndex)
+                {
+                    other = Threading::Interlocked::CompareExchange(&table[slot], index, InvalidIndex);
+                    if (other == InvalidIndex)
+                        break;
+                }
+
+                if (hashes[other] == hash
+                    && WeldKey(vertices[other], tolerance, otherKey) == keySize
+                    && memcmp(key, otherKey, keySize * sizeof(uint)) == 0)
+                {
+                    // same key, the slot keeps the lowest index
+                    while (index < other)
+                    {
+                        int prev = Threading::Interlocked::CompareExchange(&table[slot], index, other);
+                        if (prev == other)
+                            break;
+                        other = prev;
+                    }
+                    break;
+                }
+                slot = (slot + 1) & tableMask;
+            }
+        }
+    };
 
-            // put the new valid index into the index remapping table
-            indexMap[sortMap[nextIndex]] = sortMap[baseIndex];
-            nextIndex++;
+    auto lookupFunc = [vertices, hashes, table, tableMask, tolerance, indexMap](SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocationOffset)
+    {
+        uint key[MaxWeldKeySize], otherKey[MaxWeldKeySize];
+        for (IndexT i = 0; i < groupSize; i++)
+        {
+            IndexT index = i + invocationOffset;
+            if (index >= totalJobs)
+                return;
+
+            const SizeT keySize = WeldKey(vertices[index], tolerance, key);
+            const uint hash = hashes[index];
+            uint slot = hash & tableMask;
+            while (true)
+            {
+                const int other = table[slot];
+                n_assert(other != InvalidIndex);
+                if (other == index
+                    || (hashes[other] == hash
+                        && WeldKey(vertices[other], tolerance, otherKey) == keySize
+                        && memcmp(key, otherKey, keySize * sizeof(uint)) == 0))
+                {
+                    indexMap[index] = other;
+                    if (other != index)
+                        vertices[index].SetFlag(MeshBuilderVertex::Redundant);
+                    break;
+                }
+                slot = (slot + 1) & tableMask;
+            }
         }
-        baseIndex = nextIndex;
+    };
+
+    static const SizeT WeldGroupSize = 16384;
+    if (numVertices <= WeldGroupSize || Jobs2::JobIsWorkerThread())
+    {
+        hashFunc(numVertices, numVertices, 0, 0);
+        insertFunc(numVertices, numVertices, 0, 0);
+        lookupFunc(numVertices, numVertices, 0, 0);
+    }
+    else
+    {
+        Threading::AtomicCounter hashCounter = 1;
+        Threading::AtomicCounter insertCounter = 1;
+        Threading::Event event;
+        Jobs2::JobDispatch(hashFunc, numVertices, WeldGroupSize, nullptr, &hashCounter, nullptr);
+        Jobs2::JobDispatch(insertFunc, numVertices, WeldGroupSize, { &hashCounter }, &insertCounter, nullptr);
+        Jobs2::JobDispatch(lookupFunc, numVertices, WeldGroupSize, { &insertCounter }, nullptr, &event);
+        event.Wait();
+
+        // free up scratch memory
+        Jobs2::JobNewFrame();
     }
 
-    // fill the shiftMap, this contains for each vertex index the number
-    // of invalid vertices in front of it
+    Memory::Free(Memory::ScratchHeap, hashes);
+    Memory::Free(Memory::ScratchHeap, (void*)table);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Fills the shiftMap, which contains for each vertex index the number of
+    redundant vertices up to it, remaps the triangles and removes the
+    redundant vertices.
+*/
+void
+MeshBuilder::RemoveRedundantVertices(const IndexT* indexMap, IndexT* shiftMap)
+{
+    SizeT numVertices = this->vertices.Size();
     SizeT numInvalid = 0;
     IndexT vertexIndex;
     for (vertexIndex = 0; vertexIndex < numVertices; vertexIndex++)
@@ -241,12 +420,12 @@ MeshBuilder::Deflate(FixedArray<Array<IndexT>>* collapsMap)
     // valid index from the indexMap, then decrement by the shiftMap entry
     // at that index (which contains the number of invalid vertices in front
     // of that index)
-    // fix vertex indices in triangles
     SizeT numTriangles = this->triangles.Size();
     IndexT curTriangle;
     for (curTriangle = 0; curTriangle < numTriangles; curTriangle++)
     {
         MeshBuilderTriangle& t = this->triangles[curTriangle];
+        IndexT i;
         for (i = 0; i < 3; i++)
         {
             IndexT newIndex = indexMap[t.vertexIndex[i]];
@@ -254,12 +433,47 @@ MeshBuilder::Deflate(FixedArray<Array<IndexT>>* collapsMap)
         }
     }
 
+    // finally, remove the redundant vertices
+    Array<MeshBuilderVertex> newArray;
+    newArray.Reserve(numVertices - numInvalid);
+    for (vertexIndex = 0; vertexIndex < numVertices; vertexIndex++)
+    {
+        if (!this->vertices[vertexIndex].CheckFlag(MeshBuilderVertex::Redundant))
+        {
+            newArray.Append(this->vertices[vertexIndex]);
+        }
+    }
+    this->vertices = std::move(newArray);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Cleanup the mesh. This removes redundant vertices and optionally record
+    the collapse history into a client-provided collapsMap. The collaps map
+    contains at each new vertex index the 'old' vertex indices which have
+    been collapsed into the new vertex.
+
+    Vertices are welded when their components fall into the same cells of the
+    weld tolerance, by default only exact matches are welded. Of each set of
+    welded vertices the one with the lowest index is kept.
+*/
+void
+MeshBuilder::Deflate(FixedArray<Array<IndexT>>* collapsMap)
+{
+    SizeT numVertices = this->GetNumVertices();
+    IndexT* indexMap = (IndexT*)Memory::Alloc(Memory::ScratchHeap, numVertices * sizeof(IndexT));
+    IndexT* shiftMap = (IndexT*)Memory::Alloc(Memory::ScratchHeap, numVertices * sizeof(IndexT));
+
+    this->Weld(indexMap);
+    this->RemoveRedundantVertices(indexMap, shiftMap);
+
     // initialize the collapse map so that for each new (collapsed)
     // index it contains a list of old vertex indices which have been
     // collapsed into the new vertex 
     if (collapsMap)
     {
         collapsMap->SetSize(numVertices);
+        IndexT i;
         for (i = 0; i < numVertices; i++)
         {
             IndexT newIndex = indexMap[i];
@@ -268,22 +482,8 @@ MeshBuilder::Deflate(FixedArray<Array<IndexT>>* collapsMap)
         }
     }
 
-    // finally, remove the redundant vertices
-    numVertices = this->vertices.Size();
-    Array<MeshBuilderVertex> newArray;
-    newArray.Reserve(numVertices);
-    for (vertexIndex = 0; vertexIndex < numVertices; vertexIndex++)
-    {
-        if (!this->vertices[vertexIndex].CheckFlag(MeshBuilderVertex::Redundant))
-        {
-            newArray.Append(this->vertices[vertexIndex]);
-        }
-    }
-    this->vertices = newArray;
-
     // cleanup
     Memory::Free(Memory::ScratchHeap, indexMap);
-    Memory::Free(Memory::ScratchHeap, sortMap);
     Memory::Free(Memory::ScratchHeap, shiftMap);
 }
 
@@ -348,75 +548,17 @@ MeshBuilder::FlipUvs()
 void MeshBuilder::Cleanup(Array<Array<int> >* collapseMap)
 {
     int numVertices = this->vertices.Size();
-
-    // generate a index remapping table and sorted vertex array
     int* indexMap = new int[numVertices];
-    int* sortMap = new int[numVertices];
     int* shiftMap = new int[numVertices];
 
-    int i;
-    for (i = 0; i < numVertices; i++)
-    {
-        indexMap[i] = i;
-        sortMap[i] = i;
-    }
-
-    // generate a sorted index map (sort by X coordinate)
-    qsortData = this;
-    qsort(sortMap, numVertices, sizeof(int), MeshBuilder::VertexSorter);
-
-    // search sorted array for redundant vertices
-    int baseIndex = 0;
-    for (baseIndex = 0; baseIndex < (numVertices - 1);)
-    {
-        int nextIndex = baseIndex + 1;
-        while (nextIndex < numVertices &&
-            this->vertices[sortMap[baseIndex]] == this->vertices[sortMap[nextIndex]])
-        {
-            // mark the vertex as invalid
-            this->vertices[sortMap[nextIndex]].SetFlag(MeshBuilderVertex::Redundant);
-
-            // put the new valid index into the index remapping table
-            indexMap[sortMap[nextIndex]] = sortMap[baseIndex];
-            nextIndex++;
-        }
-
-        baseIndex = nextIndex;
-    }
-
-    // fill the shiftMap, this contains for each vertex index the number of invalid vertices in front of it
-    int numInvalid = 0;
-
-    int vertexIndex;
-    for (vertexIndex = 0; vertexIndex < numVertices; vertexIndex++)
-    {
-        if (this->vertices[vertexIndex].CheckFlag(MeshBuilderVertex::Redundant))
-            numInvalid++;
-
-        shiftMap[vertexIndex] = numInvalid;
-    }
-
-    // fix the triangle's vertex indices, first, remap the old index to a valid index from the indexMap,
-    //  then decrement by the shiftMap entry at that index, which contains the number of invalid vertices
-    //  in front of that index
-    //  fix vertex indices in triangles
-    int numTriangles = this->triangles.Size();
-
-    int curTriangle;
-    for (curTriangle = 0; curTriangle < numTriangles; curTriangle++)
-    {
-        MeshBuilderTriangle& t = this->triangles[curTriangle];
-        for (i = 0; i < 3; i++)
-        {
-            int newIndex = indexMap[t.vertexIndex[i]];
-            t.vertexIndex[i] = newIndex - shiftMap[newIndex];
-        }
-    }
+    this->Weld(indexMap);
+    this->RemoveRedundantVertices(indexMap, shiftMap);
 
     // initialize the collaps map so that for each new (collapsed) index it contains a list of old vertex indices
     //  which have been collapsed into the new vertex
     if (collapseMap)
     {
+        int i;
         for (i = 0; i < numVertices; i++)
         {
             int newIndex = indexMap[i];
@@ -426,21 +568,8 @@ void MeshBuilder::Cleanup(Array<Array<int> >* collapseMap)
         }
     }
 
-    // finally, remove the redundant vertices
-    numVertices = this->vertices.Size();
-
-    Array<MeshBuilderVertex> newArray(numVertices, numVertices);
-    for (vertexIndex = 0; vertexIndex < numVertices; vertexIndex++)
-    {
-        if (!this->vertices[vertexIndex].CheckFlag(MeshBuilderVertex::Redundant))
-            newArray.Append(this->vertices[vertexIndex]);
-    }
-
-    this->vertices = newArray;
-
     // cleanup
     delete[] indexMap;
-    delete[] sortMap;
     delete[] shiftMap;
 }
 
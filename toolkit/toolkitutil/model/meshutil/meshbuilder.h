@@ -25,6 +25,16 @@ class MeshBuilder
     struct Mesh;
 public:
 
+    /// per component tolerances used when welding vertices, 0 only welds exact matches
+    struct WeldTolerance
+    {
+        float position = 0.0f;
+        float uv = 0.0f;            // primary and secondary uvs
+        float normal = 0.0f;        // normals and tangents
+        float color = 0.0f;
+        float skinWeights = 0.0f;   // skin indices always have to match exactly
+    };
+
     /// constructor
     MeshBuilder();
     
@@ -66,6 +76,10 @@ public:
     void Clear();
     /// transform vertices
     void Transform(const Math::mat4& m);
+    /// set tolerances for welding vertices in Deflate() and Cleanup()
+    void SetWeldTolerance(const WeldTolerance& tolerance);
+    /// get tolerances for welding vertices
+    const WeldTolerance& GetWeldTolerance() const;
     /// remove redundant vertices
     void Deflate(Util::FixedArray<Util::Array<IndexT> >* collapseMap);
     /// inflate mesh to 3 unique vertices per triangles, created redundant vertices
@@ -84,20 +98,45 @@ public:
     void CalculateTangents();
 
 private:
-    /// a qsort() hook for generating a sorted index array
-    static int __cdecl VertexSorter(const void* elm0, const void* elm1);
-    static MeshBuilder* qsortData;
+    /// maximum number of words in a weld key
+    static const SizeT MaxWeldKeySize = 26;
+    /// build the weld key of a vertex, returns the number of words written
+    static SizeT WeldKey(const MeshBuilderVertex& v, const WeldTolerance& tolerance, uint* key);
+    /// map every vertex to the first vertex it is equal to and flag the others as redundant
+    void Weld(IndexT* indexMap);
+    /// remove the redundant vertices and remap triangles, shiftMap receives the number of removed vertices up to each index
+    void RemoveRedundantVertices(const IndexT* indexMap, IndexT* shiftMap);
     friend class MeshBuilderSaver;
     friend class SkinPartitioner;
     friend class SkinFragment;
     friend class NFbxScene;
+    friend class MeshOptimizer;
 
     Util::Array<MeshBuilderTriangle> triangles;
     CoreGraphics::PrimitiveTopology::Code topology;
     MeshBuilderVertex::ComponentMask componentMask;
     Util::Array<MeshBuilderVertex> vertices;
+    WeldTolerance weldTolerance;
 };
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+MeshBuilder::SetWeldTolerance(const WeldTolerance& tolerance)
+{
+    this->weldTolerance = tolerance;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const MeshBuilder::WeldTolerance&
+MeshBuilder::GetWeldTolerance() const
+{
+    return this->weldTolerance;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
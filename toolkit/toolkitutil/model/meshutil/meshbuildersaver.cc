@@ -8,6 +8,7 @@
 #include "coregraphics/legacy/nvx2fileformatstructs.h"
 #include "coregraphics/nvx3fileformatstructs.h"
 #include "io/ioserver.h"
+#include "threading/criticalsection.h"
 
 namespace ToolkitUtil
 {
@@ -20,11 +21,19 @@ using namespace Math;
 #define SWAPINT16ENDIAN(x) ( (((x) & 0xFF) << 8) | ((unsigned short)(x) >> 8) )
 #define SWAPINT32ENDIAN(x) ( ((x) << 24) | (( (x) << 8) & 0x00FF0000) | (( (x) >> 8) & 0x0000FF00) | ((x) >> 24) )
 
+// error bounds for quantized components, a mesh keeps a component in the GPU layout if it exceeds them
+static const float MaxQuantizedPositionError = 0.001f;
+static const float MaxQuantizedNormalError = 2.0f;
+static const float MaxQuantizedSkinWeightError = 0.01f;
+
+static MeshBuilderSaver::QuantizationStats QuantizationTotals;
+static Threading::CriticalSection QuantizationLock;
+
 //------------------------------------------------------------------------------
 /**
 */
 bool
-MeshBuilderSaver::Save(const IO::URI& uri, const Util::Array<MeshBuilder*>& meshes, const Util::Array<MeshBuilderGroup>& groups, Platform::Code platform)
+MeshBuilderSaver::Save(const IO::URI& uri, const Util::Array<MeshBuilder*>& meshes, const Util::Array<MeshBuilderGroup>& groups, Platform::Code platform, bool quantize, QuantizationStats* stats)
 {
     // make sure the target directory exists
     IoServer::Instance()->CreateDirectory(uri.LocalPath().ExtractDirName());
@@ -35,10 +44,40 @@ MeshBuilderSaver::Save(const IO::URI& uri, const Util::Array<MeshBuilder*>& mesh
     {
         ByteOrder byteOrder(ByteOrder::Host, Platform::GetPlatformByteOrder(platform));
 
-        MeshBuilderSaver::WriteHeader(stream, meshes, groups, byteOrder);
-        MeshBuilderSaver::WriteMeshes(stream, meshes, byteOrder);
-        MeshBuilderSaver::WriteGroups(stream, groups, byteOrder);
-        MeshBuilderSaver::WriteVertices(stream, meshes, byteOrder);
+        if (quantize)
+        {
+            Util::Array<Nvx3QuantizedRange> ranges;
+            Util::Array<ubyte> encoded;
+            QuantizationStats meshStats;
+            MeshBuilderSaver::QuantizeVertices(meshes, ranges, encoded, meshStats);
+
+            MeshBuilderSaver::WriteHeader(stream, meshes, groups, byteOrder, encoded.Size());
+            MeshBuilderSaver::WriteMeshes(stream, meshes, byteOrder);
+            MeshBuilderSaver::WriteGroups(stream, groups, byteOrder);
+            stream->Write(ranges.Begin(), ranges.ByteSize());
+            stream->Write(encoded.Begin(), encoded.Size());
+
+            QuantizationLock.Enter();
+            QuantizationTotals.numFiles++;
+            QuantizationTotals.numMeshes += meshStats.numMeshes;
+            QuantizationTotals.rawBytes += meshStats.rawBytes;
+            QuantizationTotals.quantizedBytes += meshStats.quantizedBytes;
+            QuantizationTotals.maxPositionError = Math::max(QuantizationTotals.maxPositionError, meshStats.maxPositionError);
+            QuantizationTotals.maxNormalError = Math::max(QuantizationTotals.maxNormalError, meshStats.maxNormalError);
+            QuantizationTotals.maxSkinWeightError = Math::max(QuantizationTotals.maxSkinWeightError, meshStats.maxSkinWeightError);
+            QuantizationTotals.numFallbacks += meshStats.numFallbacks;
+            QuantizationLock.Leave();
+
+            if (stats != nullptr)
+                *stats = meshStats;
+        }
+        else
+        {
+            MeshBuilderSaver::WriteHeader(stream, meshes, groups, byteOrder, InvalidIndex);
+            MeshBuilderSaver::WriteMeshes(stream, meshes, byteOrder);
+            MeshBuilderSaver::WriteGroups(stream, groups, byteOrder);
+            MeshBuilderSaver::WriteVertices(stream, meshes, byteOrder);
+        }
         MeshBuilderSaver::WriteTriangles(stream, meshes, byteOrder);
         MeshBuilderSaver::WriteMeshlets(stream, meshes, byteOrder);
 
@@ -59,7 +98,28 @@ MeshBuilderSaver::Save(const IO::URI& uri, const Util::Array<MeshBuilder*>& mesh
 /**
 */
 void
-MeshBuilderSaver::WriteHeader(const Ptr<IO::Stream>& stream, const Util::Array<MeshBuilder*>& meshes, const Util::Array<MeshBuilderGroup>& groups, const System::ByteOrder& byteOrder)
+MeshBuilderSaver::PrintQuantizationStats(Logger* logger)
+{
+    QuantizationLock.Enter();
+    const QuantizationStats totals = QuantizationTotals;
+    QuantizationLock.Leave();
+
+    if (totals.numFiles == 0)
+        return;
+
+    logger->Print("\nVertex quantization ---------\n");
+    logger->Print("%d meshes in %d files, vertex data %.2f MB -> %.2f MB (%.1f%% saved)\n",
+        totals.numMeshes, totals.numFiles, totals.rawBytes / 1048576.0, totals.quantizedBytes / 1048576.0,
+        totals.rawBytes > 0 ? 100.0 * (totals.rawBytes - totals.quantizedBytes) / totals.rawBytes : 0.0);
+    logger->Print("max error: position %.5f, normal %.2f deg, skin weight %.4f, %d components kept unquantized\n",
+        totals.maxPositionError, totals.maxNormalError, totals.maxSkinWeightError, totals.numFallbacks);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+MeshBuilderSaver::WriteHeader(const Ptr<IO::Stream>& stream, const Util::Array<MeshBuilder*>& meshes, const Util::Array<MeshBuilderGroup>& groups, const System::ByteOrder& byteOrder, SizeT quantizedVertexDataSize)
 {
     SizeT indexDataSize = 0;
     SizeT vertexDataSize = 0;
@@ -76,12 +136,12 @@ MeshBuilderSaver::WriteHeader(const Ptr<IO::Stream>& stream, const Util::Array<M
 
     // write header
     Nvx3Header nvx3Header;
-    nvx3Header.magic = byteOrder.Convert<uint>(NEBULA_NVX_MAGICNUMBER);
+    nvx3Header.magic = byteOrder.Convert<uint>(quantizedVertexDataSize != InvalidIndex ? NEBULA_NVX_QUANTIZED_MAGICNUMBER : NEBULA_NVX_MAGICNUMBER);
     nvx3Header.numMeshes = byteOrder.Convert<uint>(meshes.Size());
     nvx3Header.numGroups = byteOrder.Convert<uint>(groups.Size());
     nvx3Header.numMeshlets = 0;
     nvx3Header.indexDataSize = indexDataSize;
-    nvx3Header.vertexDataSize = vertexDataSize;
+    nvx3Header.vertexDataSize = quantizedVertexDataSize != InvalidIndex ? quantizedVertexDataSize : vertexDataSize;
 
     // write header
     stream->Write(&nvx3Header, sizeof(nvx3Header));
@@ -144,115 +204,297 @@ MeshBuilderSaver::WriteGroups(const Ptr<IO::Stream>& stream, const Util::Array<M
 /**
 */
 void
-MeshBuilderSaver::WriteVertices(const Ptr<Stream>& stream, const Util::Array<MeshBuilder*>& meshes, const ByteOrder& byteOrder)
+MeshBuilderSaver::BuildVertices(const MeshBuilder* mesh, Util::Array<CoreGraphics::BaseVertex>& baseVertices, Util::Array<ubyte>& attributeVertices)
 {
-    // First pass, output base attributes (positions and uvs)
-    for (auto& mesh : meshes)
+    // base attributes (positions and uvs)
+    baseVertices.Resize(mesh->vertices.Size());
+    for (uint vertexIndex = 0; vertexIndex < mesh->vertices.Size(); vertexIndex++)
     {
-        CoreGraphics::BaseVertex* baseBuffer = new CoreGraphics::BaseVertex[mesh->vertices.Size()];
-        for (uint vertexIndex = 0; vertexIndex < mesh->vertices.Size(); vertexIndex++)
+        const MeshBuilderVertex& vtx = mesh->vertices[vertexIndex];
+        CoreGraphics::BaseVertex& outVtx = baseVertices[vertexIndex];
+        outVtx.position[0] = vtx.base.position.x;
+        outVtx.position[1] = vtx.base.position.y;
+        outVtx.position[2] = vtx.base.position.z;
+        outVtx.uv[0] = vtx.base.uv.x * 1000.0f;
+        outVtx.uv[1] = vtx.base.uv.y * 1000.0f;
+    }
+
+    CoreGraphics::VertexLayoutType layout = MeshBuilderVertex::GetVertexLayoutType(mesh->componentMask);
+    attributeVertices.Resize(MeshBuilderVertex::GetSize(mesh->componentMask) * mesh->vertices.Size());
+    byte* attributeBuffer = attributeVertices.Begin();
+    auto normalLambda = [](CoreGraphics::NormalVertex& outVtx, const MeshBuilderVertex& vtx)
+    {
+        outVtx.normal.x = vtx.attributes.normal.normal.x * 128.0f;
+        outVtx.normal.y = vtx.attributes.normal.normal.y * 128.0f;
+        outVtx.normal.z = vtx.attributes.normal.normal.z * 128.0f;
+        outVtx.normal.w = 0.0f;
+
+        outVtx.tangent.x = vtx.attributes.normal.tangent.x * 128.0f;
+        outVtx.tangent.y = vtx.attributes.normal.tangent.y * 128.0f;
+        outVtx.tangent.z = vtx.attributes.normal.tangent.z * 128.0f;
+        outVtx.tangent.w = vtx.attributes.normal.sign > 0.0f ? 0x7F : 0x80;
+    };
+    switch (layout)
+    {
+        case CoreGraphics::VertexLayoutType::Normal:
         {
-            const MeshBuilderVertex& vtx = mesh->vertices[vertexIndex];
-            CoreGraphics::BaseVertex& outVtx = baseBuffer[vertexIndex];
-            outVtx.position[0] = vtx.base.position.x;
-            outVtx.position[1] = vtx.base.position.y;
-            outVtx.position[2] = vtx.base.position.z;
-            outVtx.uv[0] = vtx.base.uv.x * 1000.0f;
-            outVtx.uv[1] = vtx.base.uv.y * 1000.0f;
+            CoreGraphics::NormalVertex* attrBuffer = (CoreGraphics::NormalVertex*)attributeBuffer;
+            for (uint vertexIndex = 0; vertexIndex < mesh->vertices.Size(); vertexIndex++)
+            {
+                const MeshBuilderVertex& vtx = mesh->vertices[vertexIndex];
+                CoreGraphics::NormalVertex& outVtx = attrBuffer[vertexIndex];
+                normalLambda(outVtx, vtx);
+            }
+            break;
         }
-        stream->Write(baseBuffer, sizeof(CoreGraphics::BaseVertex) * mesh->vertices.Size());
-        delete[] baseBuffer;
+        case CoreGraphics::VertexLayoutType::Colors:
+        {
+            CoreGraphics::ColorVertex* attrBuffer = (CoreGraphics::ColorVertex*)attributeBuffer;
+            for (uint vertexIndex = 0; vertexIndex < mesh->vertices.Size(); vertexIndex++)
+            {
+                const MeshBuilderVertex& vtx = mesh->vertices[vertexIndex];
+                CoreGraphics::ColorVertex& outVtx = attrBuffer[vertexIndex];
+                normalLambda(outVtx, vtx);
+
+                outVtx.color.x = vtx.attributes.color.color.x * 255.0f;
+                outVtx.color.y = vtx.attributes.color.color.y * 255.0f;
+                outVtx.color.z = vtx.attributes.color.color.z * 255.0f;
+                outVtx.color.w = vtx.attributes.color.color.w * 255.0f;
+            }
+            break;
+        }
+        case CoreGraphics::VertexLayoutType::SecondUV:
+        {
+            CoreGraphics::SecondUVVertex* attrBuffer = (CoreGraphics::SecondUVVertex*)attributeBuffer;
+            for (uint vertexIndex = 0; vertexIndex < mesh->vertices.Size(); vertexIndex++)
+            {
+                const MeshBuilderVertex& vtx = mesh->vertices[vertexIndex];
+                CoreGraphics::SecondUVVertex& outVtx = attrBuffer[vertexIndex];
+                normalLambda(outVtx, vtx);
+
+                outVtx.uv2[0] = vtx.attributes.secondUv.uv2.x * 65535.0f;
+                outVtx.uv2[1] = vtx.attributes.secondUv.uv2.y * 65535.0f;
+            }
+            break;
+        }
+        case CoreGraphics::VertexLayoutType::Skin:
+        {
+            CoreGraphics::SkinVertex* attrBuffer = (CoreGraphics::SkinVertex*)attributeBuffer;
+            for (uint vertexIndex = 0; vertexIndex < mesh->vertices.Size(); vertexIndex++)
+            {
+                const MeshBuilderVertex& vtx = mesh->vertices[vertexIndex];
+                CoreGraphics::SkinVertex& outVtx = attrBuffer[vertexIndex];
+                normalLambda(outVtx, vtx);
+
+                outVtx.skinWeights[0] = vtx.attributes.skin.weights.x;
+                outVtx.skinWeights[1] = vtx.attributes.skin.weights.y;
+                outVtx.skinWeights[2] = vtx.attributes.skin.weights.z;
+                outVtx.skinWeights[3] = vtx.attributes.skin.weights.w;
+
+                outVtx.skinIndices.x = vtx.attributes.skin.remapIndices.x;
+                outVtx.skinIndices.y = vtx.attributes.skin.remapIndices.y;
+                outVtx.skinIndices.z = vtx.attributes.skin.remapIndices.z;
+                outVtx.skinIndices.w = vtx.attributes.skin.remapIndices.w;
+            }
+            break;
+        }
+    }
+}
 
-        CoreGraphics::VertexLayoutType layout = MeshBuilderVertex::GetVertexLayoutType(mesh->componentMask);
-        byte* attributeBuffer = nullptr;
-        uint bufferSize = 0;
-        auto normalLambda = [](CoreGraphics::NormalVertex& outVtx, const MeshBuilderVertex& vtx)
+//------------------------------------------------------------------------------
+/**
+    Angle in degrees between a unit vector and its octahedral encoding, after
+    the loader expands it to the snorm components of the GPU layout.
+*/
+static float
+OctahedralError(const Math::vec3& v, const byte* encoded)
+{
+    float x, y, z;
+    CoreGraphics::Nvx3::DecodeOctahedral(encoded, x, y, z);
+    x = Math::round(x * 127.0f) / 127.0f;
+    y = Math::round(y * 127.0f) / 127.0f;
+    z = Math::round(z * 127.0f) / 127.0f;
+    const float cosine = (v.x * x + v.y * y + v.z * z) / Math::sqrt(x * x + y * y + z * z);
+    return Math::rad2deg(Math::acos(Math::clamp(cosine, -1.0f, 1.0f)));
+}
+
+//------------------------------------------------------------------------------
+/**
+    Quantizes each mesh into its own set of encoded streams. Error bounds are
+    checked per mesh and component, a component failing them is written in
+    its GPU format instead, which the loader simply copies.
+*/
+void
+MeshBuilderSaver::QuantizeVertices(const Util::Array<MeshBuilder*>& meshes, Util::Array<CoreGraphics::Nvx3QuantizedRange>& ranges, Util::Array<ubyte>& encoded, QuantizationStats& stats)
+{
+    Util::Array<CoreGraphics::BaseVertex> baseVertices;
+    Util::Array<ubyte> attributeVertices;
+    Util::Array<ushort> positions;
+    Util::Array<byte> normals;
+    Util::Array<ubyte> weights;
+
+    ranges.Resize(meshes.Size());
+    stats.numMeshes = meshes.Size();
+    for (IndexT meshIndex = 0; meshIndex < meshes.Size(); meshIndex++)
+    {
+        const MeshBuilder* mesh = meshes[meshIndex];
+        const uint numVertices = mesh->vertices.Size();
+        const CoreGraphics::VertexLayoutType layout = MeshBuilderVertex::GetVertexLayoutType(mesh->componentMask);
+        MeshBuilderSaver::BuildVertices(mesh, baseVertices, attributeVertices);
+        stats.rawBytes += baseVertices.ByteSize() + attributeVertices.Size();
+
+        CoreGraphics::Nvx3QuantizedRange& range = ranges[meshIndex];
+        range.numVertices = numVertices;
+        range.encodedByteOffset = encoded.Size();
+        range.flags = 0;
+
+        // positions, 16 bit unorm within the bounding box
+        Math::vec3 boxMin(FLT_MAX), boxMax(-FLT_MAX);
+        for (uint i = 0; i < numVertices; i++)
         {
-            outVtx.normal.x = vtx.attributes.normal.normal.x * 128.0f;
-            outVtx.normal.y = vtx.attributes.normal.normal.y * 128.0f;
-            outVtx.normal.z = vtx.attributes.normal.normal.z * 128.0f;
-            outVtx.normal.w = 0.0f;
-
-            outVtx.tangent.x = vtx.attributes.normal.tangent.x * 128.0f;
-            outVtx.tangent.y = vtx.attributes.normal.tangent.y * 128.0f;
-            outVtx.tangent.z = vtx.attributes.normal.tangent.z * 128.0f;
-            outVtx.tangent.w = vtx.attributes.normal.sign > 0.0f ? 0x7F : 0x80;
-        };
-        switch (layout)
+            const Math::vec3 p = Math::xyz(mesh->vertices[i].base.position);
+            boxMin = Math::minimize(boxMin, p);
+            boxMax = Math::maximize(boxMax, p);
+        }
+        positions.Resize(numVertices * 3);
+        float positionError = 0.0f;
+        for (int c = 0; c < 3; c++)
         {
-            case CoreGraphics::VertexLayoutType::Normal:
+            range.positionOffset[c] = numVertices > 0 ? boxMin[c] : 0.0f;
+            range.positionScale[c] = numVertices > 0 ? (boxMax[c] - boxMin[c]) / 65535.0f : 0.0f;
+            for (uint i = 0; i < numVertices; i++)
             {
-                bufferSize = sizeof(CoreGraphics::NormalVertex) * mesh->vertices.Size();
-                attributeBuffer = (byte*)new byte[bufferSize];
-                CoreGraphics::NormalVertex* attrBuffer = (CoreGraphics::NormalVertex*)attributeBuffer;
-                for (uint vertexIndex = 0; vertexIndex < mesh->vertices.Size(); vertexIndex++)
-                {
-                    const MeshBuilderVertex& vtx = mesh->vertices[vertexIndex];
-                    CoreGraphics::NormalVertex& outVtx = attrBuffer[vertexIndex];
-                    normalLambda(outVtx, vtx);
-                }
-                break;
+                const float p = baseVertices[i].position[c];
+                const ushort q = range.positionScale[c] > 0.0f ? (ushort)Math::clamp(Math::round((p - range.positionOffset[c]) / range.positionScale[c]), 0.0f, 65535.0f) : 0;
+                positions[i * 3 + c] = q;
+                positionError = Math::max(positionError, Math::abs(range.positionOffset[c] + range.positionScale[c] * q - p));
             }
-            case CoreGraphics::VertexLayoutType::Colors:
+        }
+        if (positionError <= MaxQuantizedPositionError)
+        {
+            range.flags |= CoreGraphics::Nvx3QuantizedPositions;
+            stats.maxPositionError = Math::max(stats.maxPositionError, positionError);
+        }
+        else
+            stats.numFallbacks++;
+
+        // normals and tangents, octahedral
+        normals.Resize(numVertices * 4);
+        float normalError = 0.0f;
+        for (uint i = 0; i < numVertices; i++)
+        {
+            const MeshBuilderVertex::VertexAttributes::Normal& n = mesh->vertices[i].attributes.normal;
+            const Math::vec3 normal = Math::length(n.normal) > 0.0f ? Math::normalize(n.normal) : Math::vec3(0, 0, 1);
+            const Math::vec3 tangent = Math::length(n.tangent) > 0.0f ? Math::normalize(n.tangent) : Math::vec3(1, 0, 0);
+            CoreGraphics::Nvx3::EncodeOctahedral(normal.x, normal.y, normal.z, &normals[i * 4 + 0]);
+            CoreGraphics::Nvx3::EncodeOctahedral(tangent.x, tangent.y, tangent.z, &normals[i * 4 + 2]);
+            normalError = Math::max(normalError, OctahedralError(normal, &normals[i * 4 + 0]), OctahedralError(tangent, &normals[i * 4 + 2]));
+        }
+        if (normalError <= MaxQuantizedNormalError)
+        {
+            range.flags |= CoreGraphics::Nvx3QuantizedNormals;
+            stats.maxNormalError = Math::max(stats.maxNormalError, normalError);
+        }
+        else
+            stats.numFallbacks++;
+
+        // skin weights, 8 bit unorm, rounded so weights summing to one still do
+        if (layout == CoreGraphics::VertexLayoutType::Skin)
+        {
+            weights.Resize(numVertices * 4);
+            float weightError = 0.0f;
+            for (uint i = 0; i < numVertices; i++)
             {
-                bufferSize = sizeof(CoreGraphics::ColorVertex) * mesh->vertices.Size();
-                attributeBuffer = (byte*)new byte[bufferSize];
-                CoreGraphics::ColorVertex* attrBuffer = (CoreGraphics::ColorVertex*)attributeBuffer;
-                for (uint vertexIndex = 0; vertexIndex < mesh->vertices.Size(); vertexIndex++)
+                const Math::vec4& w = mesh->vertices[i].attributes.skin.weights;
+                int sum = 0, largest = 0;
+                for (int c = 0; c < 4; c++)
                 {
-                    const MeshBuilderVertex& vtx = mesh->vertices[vertexIndex];
-                    CoreGraphics::ColorVertex& outVtx = attrBuffer[vertexIndex];
-                    normalLambda(outVtx, vtx);
-
-                    outVtx.color.x = vtx.attributes.color.color.x * 255.0f;
-                    outVtx.color.y = vtx.attributes.color.color.y * 255.0f;
-                    outVtx.color.z = vtx.attributes.color.color.z * 255.0f;
-                    outVtx.color.w = vtx.attributes.color.color.w * 255.0f;
+                    weights[i * 4 + c] = (ubyte)Math::clamp(Math::round(w[c] * 255.0f), 0.0f, 255.0f);
+                    sum += weights[i * 4 + c];
+                    if (w[c] > w[largest])
+                        largest = c;
                 }
-                break;
+                if (Math::abs(w.x + w.y + w.z + w.w - 1.0f) < 0.01f)
+                    weights[i * 4 + largest] = (ubyte)Math::clamp(weights[i * 4 + largest] + 255 - sum, 0, 255);
+                for (int c = 0; c < 4; c++)
+                    weightError = Math::max(weightError, Math::abs(weights[i * 4 + c] / 255.0f - w[c]));
             }
-            case CoreGraphics::VertexLayoutType::SecondUV:
+            if (weightError <= MaxQuantizedSkinWeightError)
             {
-                bufferSize = sizeof(CoreGraphics::SecondUVVertex) * mesh->vertices.Size();
-                attributeBuffer = (byte*)new byte[bufferSize];
-                CoreGraphics::SecondUVVertex* attrBuffer = (CoreGraphics::SecondUVVertex*)attributeBuffer;
-                for (uint vertexIndex = 0; vertexIndex < mesh->vertices.Size(); vertexIndex++)
-                {
-                    const MeshBuilderVertex& vtx = mesh->vertices[vertexIndex];
-                    CoreGraphics::SecondUVVertex& outVtx = attrBuffer[vertexIndex];
-                    normalLambda(outVtx, vtx);
+                range.flags |= CoreGraphics::Nvx3QuantizedSkinWeights;
+                stats.maxSkinWeightError = Math::max(stats.maxSkinWeightError, weightError);
+            }
+            else
+                stats.numFallbacks++;
+        }
 
-                    outVtx.uv2[0] = vtx.attributes.secondUv.uv2.x * 65535.0f;
-                    outVtx.uv2[1] = vtx.attributes.secondUv.uv2.y * 65535.0f;
-                }
-                break;
+        // write the streams, the rest is copied from the GPU layout
+        const CoreGraphics::Nvx3QuantizedStreams streams = CoreGraphics::Nvx3::GetQuantizedStreams(layout, numVertices, range.flags);
+        encoded.Resize(range.encodedByteOffset + streams.size);
+        ubyte* out = encoded.Begin() + range.encodedByteOffset;
+        Memory::Clear(out, streams.size);
+        const SizeT stride = CoreGraphics::Nvx3::AttributeVertexSize(layout);
+
+        for (uint i = 0; i < numVertices; i++)
+        {
+            if (range.flags & CoreGraphics::Nvx3QuantizedPositions)
+                Memory::Copy(&positions[i * 3], out + streams.positions + i * 3 * sizeof(ushort), 3 * sizeof(ushort));
+            else
+                Memory::Copy(baseVertices[i].position, out + streams.positions + i * 3 * sizeof(float), 3 * sizeof(float));
+            Memory::Copy(baseVertices[i].uv, out + streams.uvs + i * 2 * sizeof(short), 2 * sizeof(short));
+
+            const CoreGraphics::NormalVertex& vertex = *(const CoreGraphics::NormalVertex*)(attributeVertices.Begin() + i * stride);
+            if (range.flags & CoreGraphics::Nvx3QuantizedNormals)
+            {
+                Memory::Copy(&normals[i * 4], out + streams.normals + i * 4, 4);
+                if (mesh->vertices[i].attributes.normal.sign > 0.0f)
+                    out[streams.tangentSigns + i / 8] |= 1 << (i % 8);
             }
-            case CoreGraphics::VertexLayoutType::Skin:
+            else
             {
-                bufferSize = sizeof(CoreGraphics::SkinVertex) * mesh->vertices.Size();
-                attributeBuffer = (byte*)new byte[bufferSize];
-                CoreGraphics::SkinVertex* attrBuffer = (CoreGraphics::SkinVertex*)attributeBuffer;
-                for (uint vertexIndex = 0; vertexIndex < mesh->vertices.Size(); vertexIndex++)
+                Memory::Copy(&vertex.normal, out + streams.normals + i * 2 * sizeof(Math::byte4), sizeof(Math::byte4));
+                Memory::Copy(&vertex.tangent, out + streams.normals + (i * 2 + 1) * sizeof(Math::byte4), sizeof(Math::byte4));
+            }
+
+            switch (layout)
+            {
+                case CoreGraphics::VertexLayoutType::Colors:
+                    Memory::Copy(&((const CoreGraphics::ColorVertex&)vertex).color, out + streams.colors + i * sizeof(Math::byte4u), sizeof(Math::byte4u));
+                    break;
+                case CoreGraphics::VertexLayoutType::SecondUV:
+                    Memory::Copy(((const CoreGraphics::SecondUVVertex&)vertex).uv2, out + streams.secondaryUvs + i * 2 * sizeof(ushort), 2 * sizeof(ushort));
+                    break;
+                case CoreGraphics::VertexLayoutType::Skin:
                 {
-                    const MeshBuilderVertex& vtx = mesh->vertices[vertexIndex];
-                    CoreGraphics::SkinVertex& outVtx = attrBuffer[vertexIndex];
-                    normalLambda(outVtx, vtx);
-
-                    outVtx.skinWeights[0] = vtx.attributes.skin.weights.x;
-                    outVtx.skinWeights[1] = vtx.attributes.skin.weights.y;
-                    outVtx.skinWeights[2] = vtx.attributes.skin.weights.z;
-                    outVtx.skinWeights[3] = vtx.attributes.skin.weights.w;
-
-                    outVtx.skinIndices.x = vtx.attributes.skin.remapIndices.x;
-                    outVtx.skinIndices.y = vtx.attributes.skin.remapIndices.y;
-                    outVtx.skinIndices.z = vtx.attributes.skin.remapIndices.z;
-                    outVtx.skinIndices.w = vtx.attributes.skin.remapIndices.w;
+                    const CoreGraphics::SkinVertex& skin = (const CoreGraphics::SkinVertex&)vertex;
+                    if (range.flags & CoreGraphics::Nvx3QuantizedSkinWeights)
+                        Memory::Copy(&weights[i * 4], out + streams.skinWeights + i * 4, 4);
+                    else
+                        Memory::Copy(skin.skinWeights, out + streams.skinWeights + i * 4 * sizeof(float), 4 * sizeof(float));
+                    Memory::Copy(&skin.skinIndices, out + streams.skinIndices + i * sizeof(Math::byte4u), sizeof(Math::byte4u));
+                    break;
                 }
-                break;
+                default:
+                    break;
             }
         }
-        stream->Write(attributeBuffer, bufferSize);
-        delete[] attributeBuffer;
+    }
+    stats.quantizedBytes = ranges.ByteSize() + encoded.Size();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+MeshBuilderSaver::WriteVertices(const Ptr<Stream>& stream, const Util::Array<MeshBuilder*>& meshes, const ByteOrder& byteOrder)
+{
+    Util::Array<CoreGraphics::BaseVertex> baseVertices;
+    Util::Array<ubyte> attributeVertices;
+    for (auto& mesh : meshes)
+    {
+        MeshBuilderSaver::BuildVertices(mesh, baseVertices, attributeVertices);
+        stream->Write(baseVertices.Begin(), baseVertices.ByteSize());
+        stream->Write(attributeVertices.Begin(), attributeVertices.Size());
     }
 }
 
@@ -11,6 +11,8 @@
 #include "toolkit-common/platform.h"
 #include "io/stream.h"
 #include "system/byteorder.h"
+#include "toolkit-common/logger.h"
+#include "coregraphics/nvx3quantization.h"
 
 //------------------------------------------------------------------------------
 namespace ToolkitUtil
@@ -18,17 +20,37 @@ namespace ToolkitUtil
 class MeshBuilderSaver
 {
 public:
-    /// save nvx3 file
-    static bool Save(const IO::URI& uri, const Util::Array<MeshBuilder*>& meshes, const Util::Array<MeshBuilderGroup>& groups, Platform::Code platform);
+    /// statistics of quantized saves
+    struct QuantizationStats
+    {
+        SizeT numFiles = 0;
+        SizeT numMeshes = 0;
+        SizeT rawBytes = 0;                 // vertex data size in the GPU layouts
+        SizeT quantizedBytes = 0;           // vertex data size as written, including the quantized ranges
+        float maxPositionError = 0.0f;      // in object space units
+        float maxNormalError = 0.0f;        // in degrees, for normals and tangents
+        float maxSkinWeightError = 0.0f;
+        SizeT numFallbacks = 0;             // mesh components kept in the GPU format as quantizing them exceeded the error bounds
+    };
+
+    /// save nvx3 file, or a quantized nvx3 file if quantize is set
+    static bool Save(const IO::URI& uri, const Util::Array<MeshBuilder*>& meshes, const Util::Array<MeshBuilderGroup>& groups, Platform::Code platform, bool quantize = false, QuantizationStats* stats = nullptr);
+    /// print the statistics of all quantized saves so far
+    static void PrintQuantizationStats(Logger* logger);
+
 private:
 
     /// write header to stream using nvx3
-    static void WriteHeader(const Ptr<IO::Stream>& stream, const Util::Array<MeshBuilder*>& meshes, const Util::Array<MeshBuilderGroup>& groups, const System::ByteOrder& byteOrder);
+    static void WriteHeader(const Ptr<IO::Stream>& stream, const Util::Array<MeshBuilder*>& meshes, const Util::Array<MeshBuilderGroup>& groups, const System::ByteOrder& byteOrder, SizeT quantizedVertexDataSize);
     /// Write meshes
     static void WriteMeshes(const Ptr<IO::Stream>& stream, const Util::Array<MeshBuilder*>& meshes, const System::ByteOrder& byteOrder);
     /// write groups to stream in nvx3
     static void WriteGroups(const Ptr<IO::Stream>& stream, const Util::Array<MeshBuilderGroup>& groups, const System::ByteOrder& byteOrder);
 
+    /// build the vertex buffers of a mesh in the GPU layout
+    static void BuildVertices(const MeshBuilder* mesh, Util::Array<CoreGraphics::BaseVertex>& baseVertices, Util::Array<ubyte>& attributeVertices);
+    /// quantize the vertices of all meshes, components exceeding the error bounds are kept in the GPU layout
+    static void QuantizeVertices(const Util::Array<MeshBuilder*>& meshes, Util::Array<CoreGraphics::Nvx3QuantizedRange>& ranges, Util::Array<ubyte>& encoded, QuantizationStats& stats);
     /// write the vertices to stream
     static void WriteVertices(const Ptr<IO::Stream>& stream, const Util::Array<MeshBuilder*>& meshes, const System::ByteOrder& byteOrder);
     /// write the triangles to stream
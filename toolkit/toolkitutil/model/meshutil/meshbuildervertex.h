@@ -99,6 +99,8 @@ private:
     friend class SkinFragment;
     friend class NFbxScene;
     friend class Scene;
+    friend class MeshOptimizer;
+    friend class MeshSimplifier;
     ComponentMask componentMask;
     FlagMask flagMask;
 
@@ -0,0 +1,490 @@
+//------------------------------------------------------------------------------
+//  meshoptimizer.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "foundation/stdneb.h"
+#include "meshoptimizer.h"
+#include "util/fixedarray.h"
+
+#include <algorithm>
+
+namespace ToolkitUtil
+{
+using namespace Util;
+using namespace Math;
+
+// scoring parameters from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+static const int ForsythCacheSize = 32;
+static const int ForsythMaxValence = 32;
+static const float ForsythCacheDecayPower = 1.5f;
+static const float ForsythLastTriangleScore = 0.75f;
+static const float ForsythValenceBoostScale = 2.0f;
+static const float ForsythValenceBoostPower = 0.5f;
+
+//------------------------------------------------------------------------------
+/**
+    Precomputed vertex scores by cache position and number of triangles
+    which still use the vertex.
+*/
+struct ForsythScores
+{
+    float cache[ForsythCacheSize + 1];
+    float valence[ForsythMaxValence + 1];
+
+    ForsythScores()
+    {
+        // not in the cache
+        this->cache[0] = 0.0f;
+        for (int i = 0; i < ForsythCacheSize; i++)
+        {
+            // the vertices of the last triangle get a fixed score, so the triangle
+            // sharing an edge with it isn't always preferred, which would make long strips
+            if (i < 3)
+                this->cache[i + 1] = ForsythLastTriangleScore;
+            else
+                this->cache[i + 1] = powf(1.0f - (i - 3) * (1.0f / (ForsythCacheSize - 3)), ForsythCacheDecayPower);
+        }
+
+        // boost vertices with few triangles left, so lone triangles get taken care of early
+        this->valence[0] = 0.0f;
+        for (int i = 1; i <= ForsythMaxValence; i++)
+            this->valence[i] = ForsythValenceBoostScale * powf((float)i, -ForsythValenceBoostPower);
+    }
+
+    float Score(int cachePosition, SizeT numLiveTriangles) const
+    {
+        if (numLiveTriangles == 0)
+            return -1.0f;
+        return this->cache[cachePosition + 1] + this->valence[Math::min(numLiveTriangles, ForsythMaxValence)];
+    }
+};
+
+//------------------------------------------------------------------------------
+/**
+    Simulated FIFO cache using time stamps, a vertex is in the cache if it
+    was added less than cacheSize misses ago.
+*/
+struct FifoCache
+{
+    FixedArray<uint> timeStamps;
+    uint time;
+    uint size;
+
+    FifoCache(SizeT numVertices, SizeT cacheSize) :
+        timeStamps(numVertices, 0),
+        time(cacheSize + 1),
+        size(cacheSize)
+    {
+        // empty
+    }
+
+    SizeT Update(const MeshBuilderTriangle& tri)
+    {
+        SizeT misses = 0;
+        for (IndexT i = 0; i < 3; i++)
+        {
+            uint& stamp = this->timeStamps[tri.GetVertexIndex(i)];
+            if (this->time - stamp > this->size)
+            {
+                stamp = this->time++;
+                misses++;
+            }
+        }
+        return misses;
+    }
+
+    void Flush()
+    {
+        this->time += this->size + 1;
+    }
+};
+
+//------------------------------------------------------------------------------
+/**
+    The bounds of all groups inside the mesh cut it into ranges which are
+    optimized on their own. Groups of other meshes in the same file only add
+    superfluous cuts, so the whole group list of a file can be passed.
+*/
+void
+MeshOptimizer::Optimize(MeshBuilder& mesh, const Array<MeshBuilderGroup>& groups)
+{
+    const SizeT numTriangles = mesh.GetNumTriangles();
+    if (numTriangles == 0)
+        return;
+
+    Array<IndexT> bounds;
+    bounds.Append(0);
+    bounds.Append(numTriangles);
+    for (const MeshBuilderGroup& group : groups)
+    {
+        const IndexT first = group.GetFirstTriangleIndex();
+        const IndexT end = first + group.GetNumTriangles();
+        if (first > 0 && first < numTriangles)
+            bounds.Append(first);
+        if (end > 0 && end < numTriangles)
+            bounds.Append(end);
+    }
+    bounds.Sort();
+
+    IndexT i;
+    for (i = 1; i < bounds.Size(); i++)
+    {
+        if (bounds[i] == bounds[i - 1])
+            continue;
+
+        MeshBuilderGroup range;
+        range.SetFirstTriangleIndex(bounds[i - 1]);
+        range.SetNumTriangles(bounds[i] - bounds[i - 1]);
+        MeshOptimizer::OptimizeVertexCache(mesh, range);
+        MeshOptimizer::OptimizeOverdraw(mesh, range, 1.05f);
+    }
+    MeshOptimizer::OptimizeVertexFetch(mesh);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Greedily emits the triangle with the highest score, where the score of a
+    triangle is the sum of the scores of its vertices. Vertices score high
+    when they are recent in a simulated LRU cache and when they have few
+    triangles left. Only triangles of vertices whose score changed are
+    rescored, which keeps it linear in the number of triangles.
+*/
+void
+MeshOptimizer::OptimizeVertexCache(MeshBuilder& mesh, const MeshBuilderGroup& range)
+{
+    static const ForsythScores Scores;
+    const IndexT firstTriangle = range.GetFirstTriangleIndex();
+    const SizeT numTriangles = range.GetNumTriangles();
+    if (numTriangles < 2)
+        return;
+
+    // compact the vertices used by the range
+    FixedArray<IndexT> localIndex(mesh.GetNumVertices(), InvalidIndex);
+    FixedArray<IndexT> indices(numTriangles * 3);
+    SizeT numVertices = 0;
+    IndexT i, j, k;
+    for (i = 0; i < numTriangles; i++)
+    {
+        const MeshBuilderTriangle& tri = mesh.TriangleAt(firstTriangle + i);
+        for (j = 0; j < 3; j++)
+        {
+            IndexT& local = localIndex[tri.GetVertexIndex(j)];
+            if (local == InvalidIndex)
+                local = numVertices++;
+            indices[i * 3 + j] = local;
+        }
+    }
+
+    // build the triangle lists of the vertices, the triangles not emitted yet are kept at the front
+    FixedArray<SizeT> numLive(numVertices, 0);
+    for (i = 0; i < numTriangles * 3; i++)
+        numLive[indices[i]]++;
+    FixedArray<IndexT> adjacencyOffset(numVertices);
+    IndexT offset = 0;
+    for (i = 0; i < numVertices; i++)
+    {
+        adjacencyOffset[i] = offset;
+        offset += numLive[i];
+    }
+    FixedArray<IndexT> adjacency(numTriangles * 3);
+    FixedArray<SizeT> fill(numVertices, 0);
+    for (i = 0; i < numTriangles * 3; i++)
+    {
+        const IndexT v = indices[i];
+        adjacency[adjacencyOffset[v] + fill[v]++] = i / 3;
+    }
+
+    FixedArray<int> cachePosition(numVertices, -1);
+    FixedArray<float> vertexScore(numVertices);
+    for (i = 0; i < numVertices; i++)
+        vertexScore[i] = Scores.Score(-1, numLive[i]);
+
+    FixedArray<bool> emitted(numTriangles, false);
+    IndexT best = InvalidIndex;
+    float bestScore = -FLT_MAX;
+    for (i = 0; i < numTriangles; i++)
+    {
+        const float score = vertexScore[indices[i * 3]] + vertexScore[indices[i * 3 + 1]] + vertexScore[indices[i * 3 + 2]];
+        if (score > bestScore)
+        {
+            bestScore = score;
+            best = i;
+        }
+    }
+
+    FixedArray<IndexT> order(numTriangles);
+    IndexT cache[ForsythCacheSize + 3];
+    SizeT cacheSize = 0;
+    IndexT cursor = 0;
+    IndexT n;
+    for (n = 0; n < numTriangles; n++)
+    {
+        if (best == InvalidIndex)
+        {
+            // none of the cached vertices has triangles left, continue with the next one not emitted yet
+            while (emitted[cursor])
+                cursor++;
+            best = cursor;
+        }
+        order[n] = best;
+        emitted[best] = true;
+
+        // remove the triangle from the live triangles of its vertices
+        const IndexT* tri = &indices[best * 3];
+        for (j = 0; j < 3; j++)
+        {
+            const IndexT v = tri[j];
+            IndexT* list = &adjacency[adjacencyOffset[v]];
+            const SizeT count = numLive[v];
+            for (k = 0; k < count; k++)
+            {
+                if (list[k] == best)
+                {
+                    list[k] = list[count - 1];
+                    list[count - 1] = best;
+                    break;
+                }
+            }
+            numLive[v]--;
+        }
+
+        // move the vertices of the triangle to the front of the cache
+        IndexT newCache[ForsythCacheSize + 3];
+        SizeT newCacheSize = 0;
+        for (j = 0; j < 3; j++)
+        {
+            if (j == 0 || (tri[j] != tri[0] && (j == 1 || tri[j] != tri[1])))
+                newCache[newCacheSize++] = tri[j];
+        }
+        for (j = 0; j < cacheSize; j++)
+        {
+            const IndexT v = cache[j];
+            if (v != tri[0] && v != tri[1] && v != tri[2])
+                newCache[newCacheSize++] = v;
+        }
+
+        // rescore the vertices in the cache and those pushed out of it
+        for (j = 0; j < newCacheSize; j++)
+        {
+            const IndexT v = newCache[j];
+            cachePosition[v] = j < ForsythCacheSize ? j : -1;
+            vertexScore[v] = Scores.Score(cachePosition[v], numLive[v]);
+        }
+
+        // rescore the live triangles of the cached vertices and pick the best one for the next step
+        best = InvalidIndex;
+        bestScore = -FLT_MAX;
+        for (j = 0; j < newCacheSize; j++)
+        {
+            const IndexT v = newCache[j];
+            const IndexT* list = &adjacency[adjacencyOffset[v]];
+            for (k = 0; k < numLive[v]; k++)
+            {
+                const IndexT t = list[k];
+                const float score = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    best = t;
+                }
+            }
+        }
+
+        cacheSize = Math::min(newCacheSize, ForsythCacheSize);
+        memcpy(cache, newCache, cacheSize * sizeof(IndexT));
+    }
+
+    // write back the triangles in their new order
+    FixedArray<MeshBuilderTriangle> triangles(numTriangles);
+    for (i = 0; i < numTriangles; i++)
+        triangles[i] = mesh.TriangleAt(firstTriangle + order[i]);
+    for (i = 0; i < numTriangles; i++)
+        mesh.TriangleAt(firstTriangle + i) = triangles[i];
+}
+
+//------------------------------------------------------------------------------
+/**
+    Based on Sander et al. "Fast Triangle Reordering for Vertex Locality and
+    Reduced Overdraw". The cache optimized sequence is cut wherever a triangle
+    misses the simulated cache with all its vertices, those clusters are cut
+    further as soon as their miss ratio drops below threshold times the one
+    of the whole cluster. The clusters are then sorted by how far they face
+    away from the center of the range, so the outer surfaces occlude the
+    inner ones.
+*/
+void
+MeshOptimizer::OptimizeOverdraw(MeshBuilder& mesh, const MeshBuilderGroup& range, float threshold)
+{
+    static const SizeT CacheSize = 16;
+    const IndexT firstTriangle = range.GetFirstTriangleIndex();
+    const SizeT numTriangles = range.GetNumTriangles();
+    if (numTriangles < 2)
+        return;
+
+    // hard cluster bounds, where the cache is effectively flushed
+    FifoCache cache(mesh.GetNumVertices(), CacheSize);
+    Array<IndexT> hardBounds;
+    IndexT i;
+    for (i = 0; i < numTriangles; i++)
+    {
+        if (cache.Update(mesh.TriangleAt(firstTriangle + i)) == 3 || i == 0)
+            hardBounds.Append(i);
+    }
+    hardBounds.Append(numTriangles);
+
+    // soft cluster bounds, cut as soon as the miss ratio is close enough to the hard cluster's
+    Array<IndexT> bounds;
+    IndexT c;
+    for (c = 0; c < hardBounds.Size() - 1; c++)
+    {
+        const IndexT start = hardBounds[c];
+        const IndexT end = hardBounds[c + 1];
+        cache.Flush();
+        SizeT clusterMisses = 0;
+        for (i = start; i < end; i++)
+            clusterMisses += cache.Update(mesh.TriangleAt(firstTriangle + i));
+        const float clusterThreshold = threshold * clusterMisses / float(end - start);
+
+        cache.Flush();
+        bounds.Append(start);
+        SizeT runningMisses = 0, runningTriangles = 0;
+        for (i = start; i < end - 1; i++)
+        {
+            runningMisses += cache.Update(mesh.TriangleAt(firstTriangle + i));
+            runningTriangles++;
+            if (runningMisses <= clusterThreshold * runningTriangles)
+            {
+                bounds.Append(i + 1);
+                cache.Flush();
+                runningMisses = runningTriangles = 0;
+            }
+        }
+    }
+    bounds.Append(numTriangles);
+
+    // area weighted centroids and normals of the clusters and the whole range
+    const SizeT numClusters = bounds.Size() - 1;
+    FixedArray<vec3> clusterCentroids(numClusters, vec3(0));
+    FixedArray<vec3> clusterNormals(numClusters, vec3(0));
+    vec3 centroid(0);
+    float area = 0.0f;
+    for (c = 0; c < numClusters; c++)
+    {
+        float clusterArea = 0.0f;
+        for (i = bounds[c]; i < bounds[c + 1]; i++)
+        {
+            const MeshBuilderTriangle& tri = mesh.TriangleAt(firstTriangle + i);
+            const vec3 p0 = xyz(mesh.VertexAt(tri.GetVertexIndex(0)).base.position);
+            const vec3 p1 = xyz(mesh.VertexAt(tri.GetVertexIndex(1)).base.position);
+            const vec3 p2 = xyz(mesh.VertexAt(tri.GetVertexIndex(2)).base.position);
+            const vec3 normal = cross(p1 - p0, p2 - p0);
+            const float triangleArea = length(normal);
+            const vec3 triangleCentroid = (p0 + p1 + p2) * (triangleArea / 3.0f);
+            clusterCentroids[c] += triangleCentroid;
+            clusterNormals[c] += normal;
+            clusterArea += triangleArea;
+        }
+        centroid += clusterCentroids[c];
+        area += clusterArea;
+        if (clusterArea > 0.0f)
+            clusterCentroids[c] *= 1.0f / clusterArea;
+    }
+    if (area > 0.0f)
+        centroid *= 1.0f / area;
+
+    FixedArray<float> clusterKeys(numClusters);
+    FixedArray<IndexT> clusterOrder(numClusters);
+    for (c = 0; c < numClusters; c++)
+    {
+        const float normalLength = length(clusterNormals[c]);
+        clusterKeys[c] = normalLength > 0.0f ? dot(clusterCentroids[c] - centroid, clusterNormals[c]) / normalLength : 0.0f;
+        clusterOrder[c] = c;
+    }
+    std::stable_sort(clusterOrder.Begin(), clusterOrder.End(), [&clusterKeys](IndexT lhs, IndexT rhs)
+    {
+        return clusterKeys[lhs] > clusterKeys[rhs];
+    });
+
+    // write back the triangles cluster by cluster
+    FixedArray<MeshBuilderTriangle> triangles(numTriangles);
+    IndexT triangleIndex = 0;
+    for (c = 0; c < numClusters; c++)
+    {
+        const IndexT cluster = clusterOrder[c];
+        for (i = bounds[cluster]; i < bounds[cluster + 1]; i++)
+            triangles[triangleIndex++] = mesh.TriangleAt(firstTriangle + i);
+    }
+    for (i = 0; i < numTriangles; i++)
+        mesh.TriangleAt(firstTriangle + i) = triangles[i];
+}
+
+//------------------------------------------------------------------------------
+/**
+    Vertices not referenced by any triangle are moved to the end.
+*/
+void
+MeshOptimizer::OptimizeVertexFetch(MeshBuilder& mesh)
+{
+    const SizeT numVertices = mesh.GetNumVertices();
+    const SizeT numTriangles = mesh.GetNumTriangles();
+    FixedArray<IndexT> remap(numVertices, InvalidIndex);
+    Array<MeshBuilderVertex> vertices;
+    vertices.Reserve(numVertices);
+
+    IndexT i, j;
+    for (i = 0; i < numTriangles; i++)
+    {
+        MeshBuilderTriangle& tri = mesh.TriangleAt(i);
+        IndexT indices[3];
+        for (j = 0; j < 3; j++)
+        {
+            const IndexT index = tri.GetVertexIndex(j);
+            if (remap[index] == InvalidIndex)
+            {
+                remap[index] = vertices.Size();
+                vertices.Append(mesh.VertexAt(index));
+            }
+            indices[j] = remap[index];
+        }
+        tri.SetVertexIndices(indices[0], indices[1], indices[2]);
+    }
+    for (i = 0; i < numVertices; i++)
+    {
+        if (remap[i] == InvalidIndex)
+            vertices.Append(mesh.VertexAt(i));
+    }
+    mesh.vertices = std::move(vertices);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+MeshOptimizer::Stats
+MeshOptimizer::AnalyzeVertexCache(const MeshBuilder& mesh, SizeT cacheSize)
+{
+    Stats stats;
+    const SizeT numTriangles = mesh.GetNumTriangles();
+    if (numTriangles == 0)
+        return stats;
+
+    FifoCache cache(mesh.GetNumVertices(), cacheSize);
+    FixedArray<bool> referenced(mesh.GetNumVertices(), false);
+    SizeT misses = 0, numReferenced = 0;
+    IndexT i, j;
+    for (i = 0; i < numTriangles; i++)
+    {
+        const MeshBuilderTriangle& tri = mesh.TriangleAt(i);
+        misses += cache.Update(tri);
+        for (j = 0; j < 3; j++)
+        {
+            bool& ref = referenced[tri.GetVertexIndex(j)];
+            numReferenced += ref ? 0 : 1;
+            ref = true;
+        }
+    }
+    stats.acmr = misses / float(numTriangles);
+    stats.atvr = misses / float(numReferenced);
+    return stats;
+}
+
+} // namespace ToolkitUtil
@@ -0,0 +1,51 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class ToolkitUtil::MeshOptimizer
+
+    Reorders the triangles and vertices of a mesh builder for rendering.
+
+    Triangles are first sorted for the post transform vertex cache using
+    Forsyth's linear speed algorithm. The cache optimized sequence is then
+    cut into clusters which are sorted so that outward facing clusters are
+    drawn first, which reduces overdraw while keeping the cache miss ratio
+    within a threshold of the cache optimized one. Finally vertices are
+    renumbered in the order they are first used, so vertex fetch walks the
+    vertex buffer linearly.
+
+    Triangles are never moved across primitive group bounds.
+
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "model/meshutil/meshbuilder.h"
+#include "model/meshutil/meshbuildergroup.h"
+#include "util/array.h"
+
+//------------------------------------------------------------------------------
+namespace ToolkitUtil
+{
+class MeshOptimizer
+{
+public:
+    struct Stats
+    {
+        float acmr = 0.0f;      // average cache miss ratio, vertex shader invocations per triangle
+        float atvr = 0.0f;      // average transformed vertex ratio, vertex shader invocations per referenced vertex
+    };
+
+    /// run all optimizations, groups may also hold groups of other meshes, their bounds are respected as well
+    static void Optimize(MeshBuilder& mesh, const Util::Array<MeshBuilderGroup>& groups);
+
+    /// reorder the triangles of a range for the post transform vertex cache
+    static void OptimizeVertexCache(MeshBuilder& mesh, const MeshBuilderGroup& range);
+    /// reorder clusters of the cache optimized triangles of a range front to back, threshold is the accepted ACMR increase
+    static void OptimizeOverdraw(MeshBuilder& mesh, const MeshBuilderGroup& range, float threshold);
+    /// renumber vertices in the order they are first referenced by the triangles
+    static void OptimizeVertexFetch(MeshBuilder& mesh);
+
+    /// simulate a FIFO post transform cache over all triangles
+    static Stats AnalyzeVertexCache(const MeshBuilder& mesh, SizeT cacheSize = 16);
+};
+
+} // namespace ToolkitUtil
+//------------------------------------------------------------------------------
@@ -0,0 +1,579 @@
+//------------------------------------------------------------------------------
+//  meshsimplifier.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "foundation/stdneb.h"
+#include "meshsimplifier.h"
+#include "util/fixedarray.h"
+
+#include <algorithm>
+#include <float.h>
+
+namespace ToolkitUtil
+{
+using namespace Util;
+using namespace Math;
+
+// border and seam edges are weighted higher than the surface, which keeps outlines in place
+static const float SimplifierEdgeWeight = 10.0f;
+// a pass only performs collapses up to this factor of the error it needs to reach its goal
+static const float SimplifierPassErrorScale = 1.5f;
+
+enum SimplifierVertexKind : uchar
+{
+    SimplifierManifold,     // interior vertex without seams, may collapse along any edge
+    SimplifierBorder,       // on a single open border chain, may only collapse along it
+    SimplifierSeam,         // on a single attribute seam chain, may only collapse along it
+    SimplifierLocked        // anything else, never collapses
+};
+
+//------------------------------------------------------------------------------
+/**
+    Symmetric 3x3 matrix, vector and constant of the sum of squared distances
+    to a set of planes. The weight only counts surface area and normalizes the
+    error into a squared distance.
+*/
+struct SimplifierQuadric
+{
+    float a00 = 0.0f, a11 = 0.0f, a22 = 0.0f, a01 = 0.0f, a02 = 0.0f, a12 = 0.0f;
+    float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f;
+    float c = 0.0f;
+    float w = 0.0f;
+
+    /// add the plane dot(n, p) + d = 0
+    void AddPlane(const vec3& n, float d, float weight)
+    {
+        this->a00 += n.x * n.x * weight;
+        this->a11 += n.y * n.y * weight;
+        this->a22 += n.z * n.z * weight;
+        this->a01 += n.x * n.y * weight;
+        this->a02 += n.x * n.z * weight;
+        this->a12 += n.y * n.z * weight;
+        this->b0 += n.x * d * weight;
+        this->b1 += n.y * d * weight;
+        this->b2 += n.z * d * weight;
+        this->c += d * d * weight;
+    }
+
+    /// add another quadric
+    void Add(const SimplifierQuadric& rhs)
+    {
+        this->a00 += rhs.a00;
+        this->a11 += rhs.a11;
+        this->a22 += rhs.a22;
+        this->a01 += rhs.a01;
+        this->a02 += rhs.a02;
+        this->a12 += rhs.a12;
+        this->b0 += rhs.b0;
+        this->b1 += rhs.b1;
+        this->b2 += rhs.b2;
+        this->c += rhs.c;
+        this->w += rhs.w;
+    }
+
+    /// weighted squared distance of a point to the planes
+    float Error(const vec3& p) const
+    {
+        const float rx = this->a00 * p.x + this->a01 * p.y + this->a02 * p.z;
+        const float ry = this->a01 * p.x + this->a11 * p.y + this->a12 * p.z;
+        const float rz = this->a02 * p.x + this->a12 * p.y + this->a22 * p.z;
+        float r = rx * p.x + ry * p.y + rz * p.z;
+        r += 2.0f * (this->b0 * p.x + this->b1 * p.y + this->b2 * p.z) + this->c;
+        r = r > 0.0f ? r : 0.0f;
+        return this->w > 0.0f ? r / this->w : r;
+    }
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+struct SimplifierHalfEdge
+{
+    IndexT from, to;                // position ids
+    IndexT fromVertex, toVertex;    // attribute vertices
+    IndexT triangle;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+struct SimplifierCollapse
+{
+    IndexT from, to;
+    float error;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline bool
+SamePosition(const vec3& lhs, const vec3& rhs)
+{
+    return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Add a plane through the edge, perpendicular to its triangle, to both
+    endpoints. This penalizes moving the edge sideways.
+*/
+static void
+AddEdgeQuadric(FixedArray<SimplifierQuadric>& quadrics, const FixedArray<vec3>& positions, const FixedArray<IndexT>& indices, const SimplifierHalfEdge& edge)
+{
+    const vec3& p0 = positions[edge.fromVertex];
+    const vec3& p1 = positions[edge.toVertex];
+    const vec3& t0 = positions[indices[edge.triangle * 3 + 0]];
+    const vec3& t1 = positions[indices[edge.triangle * 3 + 1]];
+    const vec3& t2 = positions[indices[edge.triangle * 3 + 2]];
+    const vec3 e = p1 - p0;
+    vec3 n = cross(e, cross(t1 - t0, t2 - t0));
+    const float len = length(n);
+    if (len == 0.0f)
+        return;
+    n *= 1.0f / len;
+    const float d = -dot(n, p0);
+    const float weight = dot(e, e) * SimplifierEdgeWeight;
+    quadrics[edge.from].AddPlane(n, d, weight);
+    quadrics[edge.to].AddPlane(n, d, weight);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline void
+AddChainNeighbour(FixedArray<IndexT>& chain, FixedArray<IndexT>& numChainEdges, IndexT vertex, IndexT neighbour)
+{
+    IndexT& count = numChainEdges[vertex];
+    if (count < 2)
+        chain[vertex * 2 + count] = neighbour;
+    count++;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline void
+ReplaceChainNeighbour(FixedArray<IndexT>& chain, IndexT vertex, IndexT oldNeighbour, IndexT newNeighbour)
+{
+    if (vertex == InvalidIndex)
+        return;
+    if (chain[vertex * 2] == oldNeighbour)
+        chain[vertex * 2] = newNeighbour;
+    else if (chain[vertex * 2 + 1] == oldNeighbour)
+        chain[vertex * 2 + 1] = newNeighbour;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline bool
+CanCollapse(const FixedArray<uchar>& kinds, const FixedArray<IndexT>& chain, IndexT from, IndexT to)
+{
+    switch (kinds[from])
+    {
+        case SimplifierManifold:
+            return true;
+        case SimplifierBorder:
+        case SimplifierSeam:
+            return chain[from * 2] == to || chain[from * 2 + 1] == to;
+        default:
+            return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Vertices with the same position share a position id, the lowest vertex
+    index among them. This sorts every vertex of the mesh, so it is done once
+    per mesh and shared by all ranges and levels simplified from it.
+*/
+void
+MeshSimplifier::FindPositionIds(const MeshBuilder& mesh, FixedArray<IndexT>& outPosIds)
+{
+    const SizeT numVertices = mesh.GetNumVertices();
+    FixedArray<vec3> positions(numVertices);
+    FixedArray<IndexT> order(numVertices);
+    IndexT i;
+    for (i = 0; i < numVertices; i++)
+    {
+        positions[i] = xyz(mesh.VertexAt(i).base.position);
+        order[i] = i;
+    }
+    std::sort(order.Begin(), order.End(), [&positions](IndexT lhs, IndexT rhs)
+    {
+        const vec3& a = positions[lhs];
+        const vec3& b = positions[rhs];
+        if (a.x != b.x) return a.x < b.x;
+        if (a.y != b.y) return a.y < b.y;
+        if (a.z != b.z) return a.z < b.z;
+        return lhs < rhs;
+    });
+    outPosIds.SetSize(numVertices);
+    for (i = 0; i < numVertices; i++)
+    {
+        const IndexT vertex = order[i];
+        outPosIds[vertex] = (i > 0 && SamePosition(positions[order[i - 1]], positions[vertex])) ? outPosIds[order[i - 1]] : vertex;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+float
+MeshSimplifier::Simplify(const MeshBuilder& mesh, const FixedArray<IndexT>& posIds, const MeshBuilderGroup& range, const Array<MeshBuilderTriangle>& triangles, SizeT targetTriangles, float targetError, Array<MeshBuilderTriangle>& outTriangles)
+{
+    outTriangles.Clear();
+    const SizeT numVertices = mesh.GetNumVertices();
+    const IndexT rangeBegin = range.GetFirstTriangleIndex();
+    const IndexT rangeEnd = rangeBegin + range.GetNumTriangles();
+    IndexT i, j, k;
+    if (triangles.IsEmpty() || numVertices == 0)
+        return 0.0f;
+    n_assert(posIds.Size() == numVertices);
+
+    // normalize positions to the extents of the range, which makes errors relative to its size
+    vec3 lo(FLT_MAX), hi(-FLT_MAX);
+    for (i = rangeBegin; i < rangeEnd; i++)
+    {
+        const MeshBuilderTriangle& tri = mesh.TriangleAt(i);
+        for (j = 0; j < 3; j++)
+        {
+            const vec4& p = mesh.VertexAt(tri.GetVertexIndex(j)).base.position;
+            lo = vec3(Math::min(lo.x, p.x), Math::min(lo.y, p.y), Math::min(lo.z, p.z));
+            hi = vec3(Math::max(hi.x, p.x), Math::max(hi.y, p.y), Math::max(hi.z, p.z));
+        }
+    }
+    const float extent = Math::max(hi.x - lo.x, Math::max(hi.y - lo.y, hi.z - lo.z));
+    const float scale = extent > 0.0f ? 1.0f / extent : 1.0f;
+
+    FixedArray<vec3> positions(numVertices);
+    for (i = 0; i < numVertices; i++)
+    {
+        positions[i] = (xyz(mesh.VertexAt(i).base.position) - lo) * scale;
+    }
+
+    // positions used outside of the range must not move, or the mesh would crack
+    FixedArray<bool> locked(numVertices, false);
+    for (i = 0; i < mesh.GetNumTriangles(); i++)
+    {
+        if (i >= rangeBegin && i < rangeEnd)
+            continue;
+        const MeshBuilderTriangle& tri = mesh.TriangleAt(i);
+        for (j = 0; j < 3; j++)
+            locked[posIds[tri.GetVertexIndex(j)]] = true;
+    }
+
+    // gather the triangles, dropping the ones which are already degenerate
+    FixedArray<IndexT> indices(triangles.Size() * 3);
+    SizeT numTriangles = 0;
+    for (i = 0; i < triangles.Size(); i++)
+    {
+        IndexT v0, v1, v2;
+        triangles[i].GetVertexIndices(v0, v1, v2);
+        if (posIds[v0] == posIds[v1] || posIds[v1] == posIds[v2] || posIds[v2] == posIds[v0])
+            continue;
+        indices[numTriangles * 3 + 0] = v0;
+        indices[numTriangles * 3 + 1] = v1;
+        indices[numTriangles * 3 + 2] = v2;
+        numTriangles++;
+    }
+    SizeT numIndices = numTriangles * 3;
+
+    // count the attribute copies of each position
+    FixedArray<bool> referenced(numVertices, false);
+    FixedArray<IndexT> numCopies(numVertices, 0);
+    for (i = 0; i < numIndices; i++)
+    {
+        if (!referenced[indices[i]])
+        {
+            referenced[indices[i]] = true;
+            numCopies[posIds[indices[i]]]++;
+        }
+    }
+
+    // surface quadrics
+    FixedArray<SimplifierQuadric> quadrics(numVertices);
+    for (i = 0; i < numTriangles; i++)
+    {
+        const vec3& p0 = positions[indices[i * 3 + 0]];
+        const vec3& p1 = positions[indices[i * 3 + 1]];
+        const vec3& p2 = positions[indices[i * 3 + 2]];
+        vec3 n = cross(p1 - p0, p2 - p0);
+        const float area = length(n);
+        if (area == 0.0f)
+            continue;
+        n *= 1.0f / area;
+        const float d = -dot(n, p0);
+        for (j = 0; j < 3; j++)
+        {
+            SimplifierQuadric& quadric = quadrics[posIds[indices[i * 3 + j]]];
+            quadric.AddPlane(n, d, area);
+            quadric.w += area;
+        }
+    }
+
+    // find open borders, attribute seams and non manifold edges by sorting the half edges
+    FixedArray<SimplifierHalfEdge> edges(numIndices);
+    for (i = 0; i < numTriangles; i++)
+    {
+        for (j = 0; j < 3; j++)
+        {
+            const IndexT v0 = indices[i * 3 + j];
+            const IndexT v1 = indices[i * 3 + (j + 1) % 3];
+            edges[i * 3 + j] = { posIds[v0], posIds[v1], v0, v1, i };
+        }
+    }
+    std::sort(edges.Begin(), edges.End(), [](const SimplifierHalfEdge& lhs, const SimplifierHalfEdge& rhs)
+    {
+        const IndexT lhsMin = Math::min(lhs.from, lhs.to), rhsMin = Math::min(rhs.from, rhs.to);
+        if (lhsMin != rhsMin) return lhsMin < rhsMin;
+        return Math::max(lhs.from, lhs.to) < Math::max(rhs.from, rhs.to);
+    });
+
+    FixedArray<IndexT> chain(numVertices * 2, InvalidIndex);
+    FixedArray<IndexT> numBorderEdges(numVertices, 0);
+    FixedArray<IndexT> numSeamEdges(numVertices, 0);
+    for (i = 0; i < numIndices; i = j)
+    {
+        const SimplifierHalfEdge& e0 = edges[i];
+        for (j = i + 1; j < numIndices; j++)
+        {
+            const SimplifierHalfEdge& e = edges[j];
+            if (!((e.from == e0.from && e.to == e0.to) || (e.from == e0.to && e.to == e0.from)))
+                break;
+        }
+
+        if (j - i == 1)
+        {
+            AddEdgeQuadric(quadrics, positions, indices, e0);
+            AddChainNeighbour(chain, numBorderEdges, e0.from, e0.to);
+            AddChainNeighbour(chain, numBorderEdges, e0.to, e0.from);
+        }
+        else if (j - i == 2)
+        {
+            const SimplifierHalfEdge& e1 = edges[i + 1];
+            if (e0.from == e1.from)
+            {
+                // inconsistent winding
+                locked[e0.from] = true;
+                locked[e0.to] = true;
+            }
+            else if (e0.fromVertex != e1.toVertex || e0.toVertex != e1.fromVertex)
+            {
+                AddEdgeQuadric(quadrics, positions, indices, e0);
+                AddEdgeQuadric(quadrics, positions, indices, e1);
+                AddChainNeighbour(chain, numSeamEdges, e0.from, e0.to);
+                AddChainNeighbour(chain, numSeamEdges, e0.to, e0.from);
+            }
+        }
+        else
+        {
+            locked[e0.from] = true;
+            locked[e0.to] = true;
+        }
+    }
+
+    FixedArray<uchar> kinds(numVertices, SimplifierLocked);
+    for (i = 0; i < numVertices; i++)
+    {
+        if (posIds[i] != i || locked[i])
+            continue;
+        if (numBorderEdges[i] == 0 && numSeamEdges[i] == 0)
+            kinds[i] = numCopies[i] == 1 ? SimplifierManifold : SimplifierLocked;
+        else if (numBorderEdges[i] == 2 && numSeamEdges[i] == 0 && numCopies[i] == 1)
+            kinds[i] = SimplifierBorder;
+        else if (numSeamEdges[i] == 2 && numBorderEdges[i] == 0)
+            kinds[i] = SimplifierSeam;
+    }
+
+    // collapse in passes, every pass collapses the cheapest independent edges
+    const float errorLimit = targetError > 0.0f ? targetError * targetError : FLT_MAX;
+    float reachedError = 0.0f;
+    bool relaxed = false;
+    FixedArray<IndexT> remap(numVertices);
+    for (i = 0; i < numVertices; i++)
+        remap[i] = i;
+    FixedArray<IndexT> pairs(numVertices, InvalidIndex);
+    FixedArray<bool> collapseLocked(numVertices);
+    FixedArray<IndexT> adjacencyOffsets(numVertices + 1);
+    FixedArray<IndexT> adjacencyCursor;
+    FixedArray<IndexT> adjacency(numIndices);
+    Array<IndexT> paired;
+    Array<SimplifierCollapse> collapses;
+    while (numTriangles > (SizeT)targetTriangles)
+    {
+        // triangles around each position
+        adjacencyOffsets.Fill(0);
+        for (i = 0; i < numIndices; i++)
+            adjacencyOffsets[posIds[indices[i]] + 1]++;
+        for (i = 0; i < numVertices; i++)
+            adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+        adjacencyCursor = adjacencyOffsets;
+        for (i = 0; i < numIndices; i++)
+            adjacency[adjacencyCursor[posIds[indices[i]]]++] = i / 3;
+
+        collapses.Clear();
+        for (i = 0; i < numTriangles; i++)
+        {
+            for (j = 0; j < 3; j++)
+            {
+                const IndexT p = posIds[indices[i * 3 + j]];
+                const IndexT q = posIds[indices[i * 3 + (j + 1) % 3]];
+                SimplifierQuadric quadric = quadrics[p];
+                quadric.Add(quadrics[q]);
+                if (CanCollapse(kinds, chain, p, q))
+                    collapses.Append({ p, q, quadric.Error(positions[q]) });
+                if (CanCollapse(kinds, chain, q, p))
+                    collapses.Append({ q, p, quadric.Error(positions[p]) });
+            }
+        }
+        if (collapses.IsEmpty())
+            break;
+        std::sort(collapses.Begin(), collapses.End(), [](const SimplifierCollapse& lhs, const SimplifierCollapse& rhs)
+        {
+            return lhs.error < rhs.error;
+        });
+
+        // an interior collapse removes two triangles, don't go far beyond the error this pass needs
+        float passLimit = errorLimit;
+        const IndexT goal = (IndexT)(numTriangles - targetTriangles) / 2;
+        if (!relaxed && goal < collapses.Size())
+            passLimit = Math::min(passLimit, collapses[goal].error * SimplifierPassErrorScale);
+
+        collapseLocked.Fill(false);
+        SizeT removed = 0;
+        SizeT performed = 0;
+        for (const SimplifierCollapse& collapse : collapses)
+        {
+            if (collapse.error > passLimit || numTriangles - removed <= (SizeT)targetTriangles)
+                break;
+            const IndexT p = collapse.from;
+            const IndexT q = collapse.to;
+            if (collapseLocked[p] || collapseLocked[q])
+                continue;
+
+            // match every attribute copy of p with the copy of q across the edge
+            bool valid = true;
+            SizeT degenerate = 0;
+            paired.Clear();
+            for (j = adjacencyOffsets[p]; j < adjacencyOffsets[p + 1] && valid; j++)
+            {
+                const IndexT t = adjacency[j];
+                IndexT from = InvalidIndex, to = InvalidIndex;
+                for (k = 0; k < 3; k++)
+                {
+                    const IndexT vertex = indices[t * 3 + k];
+                    if (posIds[vertex] == p)
+                        from = vertex;
+                    else if (posIds[vertex] == q)
+                        to = vertex;
+                }
+                if (to == InvalidIndex)
+                    continue;
+                if (pairs[from] == InvalidIndex)
+                {
+                    pairs[from] = to;
+                    paired.Append(from);
+                }
+                else if (pairs[from] != to)
+                    valid = false;
+                degenerate++;
+            }
+
+            // the remaining triangles must keep their orientation and find a partner
+            for (j = adjacencyOffsets[p]; j < adjacencyOffsets[p + 1] && valid; j++)
+            {
+                const IndexT t = adjacency[j];
+                vec3 corners[3];
+                IndexT pCorner = InvalidIndex;
+                bool hasQ = false;
+                for (k = 0; k < 3; k++)
+                {
+                    const IndexT vertex = indices[t * 3 + k];
+                    corners[k] = positions[vertex];
+                    if (posIds[vertex] == p)
+                        pCorner = k;
+                    else if (posIds[vertex] == q)
+                        hasQ = true;
+                }
+                if (hasQ)
+                    continue;
+                if (pairs[indices[t * 3 + pCorner]] == InvalidIndex)
+                {
+                    valid = false;
+                    break;
+                }
+                const vec3 before = cross(corners[1] - corners[0], corners[2] - corners[0]);
+                corners[pCorner] = positions[q];
+                const vec3 after = cross(corners[1] - corners[0], corners[2] - corners[0]);
+                valid = dot(before, after) > 0.0f;
+            }
+
+            if (valid)
+            {
+                for (IndexT from : paired)
+                    remap[from] = pairs[from];
+                quadrics[q].Add(quadrics[p]);
+
+                // keep the border or seam chain connected
+                if (kinds[p] == SimplifierBorder || kinds[p] == SimplifierSeam)
+                {
+                    const IndexT r = chain[p * 2] == q ? chain[p * 2 + 1] : chain[p * 2];
+                    ReplaceChainNeighbour(chain, q, p, r);
+                    ReplaceChainNeighbour(chain, r, p, q);
+                }
+                kinds[p] = SimplifierLocked;
+
+                // triangles around p are stale until the next pass
+                collapseLocked[p] = true;
+                collapseLocked[q] = true;
+                for (j = adjacencyOffsets[p]; j < adjacencyOffsets[p + 1]; j++)
+                {
+                    const IndexT t = adjacency[j];
+                    for (k = 0; k < 3; k++)
+                        collapseLocked[posIds[indices[t * 3 + k]]] = true;
+                }
+
+                removed += degenerate;
+                reachedError = Math::max(reachedError, collapse.error);
+                performed++;
+            }
+            for (IndexT from : paired)
+                pairs[from] = InvalidIndex;
+        }
+
+        if (performed == 0)
+        {
+            // the goal of this pass was only reachable through rejected collapses
+            if (relaxed || passLimit >= errorLimit)
+                break;
+            relaxed = true;
+            continue;
+        }
+        relaxed = false;
+
+        // apply the collapses and drop the degenerate triangles
+        SizeT kept = 0;
+        for (i = 0; i < numTriangles; i++)
+        {
+            const IndexT v0 = remap[indices[i * 3 + 0]];
+            const IndexT v1 = remap[indices[i * 3 + 1]];
+            const IndexT v2 = remap[indices[i * 3 + 2]];
+            if (posIds[v0] == posIds[v1] || posIds[v1] == posIds[v2] || posIds[v2] == posIds[v0])
+                continue;
+            indices[kept * 3 + 0] = v0;
+            indices[kept * 3 + 1] = v1;
+            indices[kept * 3 + 2] = v2;
+            kept++;
+        }
+        numTriangles = kept;
+        numIndices = kept * 3;
+    }
+
+    outTriangles.Reserve(numTriangles);
+    for (i = 0; i < numTriangles; i++)
+        outTriangles.Append(MeshBuilderTriangle(indices[i * 3 + 0], indices[i * 3 + 1], indices[i * 3 + 2]));
+    return Math::sqrt(reachedError);
+}
+
+} // namespace ToolkitUtil
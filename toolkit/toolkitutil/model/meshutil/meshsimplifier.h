@@ -0,0 +1,42 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class ToolkitUtil::MeshSimplifier
+
+    Reduces the triangle count of a mesh builder range with quadric error
+    metric edge collapses.
+
+    Collapses only ever move a vertex onto one of its neighbours, so the
+    simplified triangles reference the vertices of the source mesh and can be
+    appended to it as another primitive group without touching the vertex
+    buffer.
+
+    Vertices sharing a position but differing in any attribute (uvs, normals,
+    tangents, colors, skin weights) form seams. A seam vertex may only slide
+    along its seam, with all its attribute copies collapsing together, and
+    the same applies to open borders. Anything more complex than a simple
+    seam or border chain, and positions shared with triangles outside of the
+    simplified range (other materials, other nodes), is locked, so the result
+    stays watertight against the rest of the mesh.
+
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "model/meshutil/meshbuilder.h"
+#include "model/meshutil/meshbuildergroup.h"
+#include "util/array.h"
+#include "util/fixedarray.h"
+
+//------------------------------------------------------------------------------
+namespace ToolkitUtil
+{
+class MeshSimplifier
+{
+public:
+    /// find the position id of every vertex of the mesh, computed once per mesh and passed to Simplify()
+    static void FindPositionIds(const MeshBuilder& mesh, Util::FixedArray<IndexT>& outPosIds);
+    /// simplify triangles derived from a range of the mesh until targetTriangles or targetError (relative to the range extents, 0 for none) is reached, returns the error reached
+    static float Simplify(const MeshBuilder& mesh, const Util::FixedArray<IndexT>& posIds, const MeshBuilderGroup& range, const Util::Array<MeshBuilderTriangle>& triangles, SizeT targetTriangles, float targetError, Util::Array<MeshBuilderTriangle>& outTriangles);
+};
+
+} // namespace ToolkitUtil
+//------------------------------------------------------------------------------
@@ -22,7 +22,7 @@ __ImplementClass(ToolkitUtil::ModelAttributes, 'MOAT', Core::RefCounted);
 /**
 */
 ModelAttributes::ModelAttributes() :    
-    exportFlags(ToolkitUtil::ExportFlags(ToolkitUtil::FlipUVs)),
+    exportFlags(ToolkitUtil::ExportFlags(ToolkitUtil::FlipUVs | ToolkitUtil::CompressAnimations)),
     scaleFactor(1.0f)
 {
     // empty
@@ -272,6 +272,14 @@ ModelAttributes::Save(const Ptr<IO::Stream>& stream)
         // write options
         writer->SetInt("exportFlags", this->exportFlags);
         writer->SetFloat("scale", this->scaleFactor);
+        if (this->lodSettings.numLods > 0)
+        {
+            writer->SetInt("lods", this->lodSettings.numLods);
+            writer->SetFloat("lodTriangleRatio", this->lodSettings.triangleRatio);
+            writer->SetFloat("lodMaxError", this->lodSettings.maxError);
+            writer->SetFloat("lodDistance", this->lodSettings.distance);
+            writer->SetFloat("lodDistanceFactor", this->lodSettings.distanceFactor);
+        }
 
         // end options node
         writer->EndNode();
@@ -792,6 +800,14 @@ ModelAttributes::Load(const Ptr<IO::Stream>& stream)
         this->exportFlags = (ToolkitUtil::ExportFlags)reader->GetInt("exportFlags");
         this->scaleFactor = reader->GetFloat("scale");
 
+        // lod generation is optional
+        LodSettings defaultLods;
+        this->lodSettings.numLods = reader->GetOptInt("lods", defaultLods.numLods);
+        this->lodSettings.triangleRatio = reader->GetOptFloat("lodTriangleRatio", defaultLods.triangleRatio);
+        this->lodSettings.maxError = reader->GetOptFloat("lodMaxError", defaultLods.maxError);
+        this->lodSettings.distance = reader->GetOptFloat("lodDistance", defaultLods.distance);
+        this->lodSettings.distanceFactor = reader->GetOptFloat("lodDistanceFactor", defaultLods.distanceFactor);
+
         // now jump back one step and start collecting nodes
         reader->SetToParent();
 
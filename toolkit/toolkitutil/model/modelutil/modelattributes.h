@@ -22,6 +22,16 @@ class ModelAttributes : public Core::RefCounted
     __DeclareClass(ModelAttributes);
 public:
 
+    /// settings for generated levels of detail
+    struct LodSettings
+    {
+        int numLods = 0;                // number of generated levels below the source mesh, 0 disables generation
+        float triangleRatio = 0.5f;     // triangle count of each level relative to the previous one
+        float maxError = 0.0f;          // stop when the error relative to the mesh extents exceeds this, 0 for no limit
+        float distance = 20.0f;         // view distance at which the first generated level is used
+        float distanceFactor = 2.0f;    // factor between the distances of consecutive levels
+    };
+
     /// constructor
     ModelAttributes();
     /// destructor
@@ -88,6 +98,11 @@ public:
     /// gets the export flags
     const ToolkitUtil::ExportFlags& GetExportFlags() const;
 
+    /// sets the lod generation settings
+    void SetLodSettings(const LodSettings& settings);
+    /// gets the lod generation settings
+    const LodSettings& GetLodSettings() const;
+
     /// clears attributes
     void Clear();
 
@@ -107,6 +122,7 @@ private:
     Util::Array<JointMask> jointMasks;
 
     ToolkitUtil::ExportFlags exportFlags;
+    LodSettings lodSettings;
 
     static const short Version = 1;
 }; 
@@ -167,6 +183,24 @@ ModelAttributes::GetExportFlags() const
     return this->exportFlags;
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+ModelAttributes::SetLodSettings(const LodSettings& settings)
+{
+    this->lodSettings = settings;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const ModelAttributes::LodSettings&
+ModelAttributes::GetLodSettings() const
+{
+    return this->lodSettings;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -131,6 +131,16 @@ ModelBuilder::SaveN3Physics(const IO::URI& uri, Platform::Code platform)
     return false;
 }
 
+//------------------------------------------------------------------------------
+/**
+    Only the most detailed level of detail collides
+*/
+static bool
+IsCollisionLod(const ModelConstants::TransformNode& node)
+{
+    return !node.useLOD || node.LODMin <= 0.0f;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -147,6 +157,9 @@ ModelBuilder::WritePhysics()
                 const Array<ModelConstants::ShapeNode> & nodes = this->constants->GetShapeNodes();
                 for(Array<ModelConstants::ShapeNode>::Iterator iter = nodes.Begin();iter != nodes.End();iter++)
                 {
+                    if (!IsCollisionLod(*iter))
+                        continue;
+
                     auto newShape = std::make_unique<PhysicsResource::ShapeT>();
                     newShape->collider = std::make_unique<PhysicsResource::ColliderT>();
                     Math::mat4 nodetrans = iter->transform.GetTransform44().getmatrix();
@@ -228,6 +241,9 @@ ModelBuilder::WritePhysics()
                 const Array<ModelConstants::SkinSetNode>& skinSets = this->constants->GetSkinSetNodes();
                 for (Array<ModelConstants::SkinSetNode>::Iterator iter = skinSets.Begin(); iter != skinSets.End(); iter++)
                 {
+                    if (!IsCollisionLod(*iter))
+                        continue;
+
                     Math::mat4 setTransform = iter->transform.GetTransform44().getmatrix();
                     for (ModelConstants::SkinNode const& skinIter : iter->skinFragments)
                     {
@@ -260,6 +276,9 @@ ModelBuilder::WritePhysics()
                 
                 for(int i=0;i<shapes.Size();i++)
                 {
+                    if (!IsCollisionLod(shapes[i]))
+                        continue;
+
                     auto newShape = std::make_unique<PhysicsResource::ShapeT>();
                     newShape->material = this->physics->GetMaterial();
                     newShape->collider = std::make_unique<PhysicsResource::ColliderT>();
@@ -279,6 +298,9 @@ ModelBuilder::WritePhysics()
                 const Array<ModelConstants::SkinSetNode>& skinSets = this->constants->GetSkinSetNodes();
                 for (Array<ModelConstants::SkinSetNode>::Iterator iter = skinSets.Begin(); iter != skinSets.End(); iter++)
                 {
+                    if (!IsCollisionLod(*iter))
+                        continue;
+
                     Math::mat4 setTransform = iter->transform.GetTransform44().getmatrix();
                     for (ModelConstants::SkinNode const& skinIter : iter->skinFragments)
                     {
@@ -525,6 +547,17 @@ ModelBuilder::WriteSkins(const Ptr<ModelWriter>& writer)
         writer->BeginModelNode("CharacterSkinNode", 'CHSN', name);
             WriteTransform(writer, skinSet.transform);
 
+            if (skinSet.useLOD)
+            {
+                writer->BeginTag("LODMinDistance", 'SMID');
+                writer->WriteFloat(skinSet.LODMin);
+                writer->EndTag();
+
+                writer->BeginTag("LODMaxDistance", 'SMAD');
+                writer->WriteFloat(skinSet.LODMax);
+                writer->EndTag();
+            }
+
             writer->BeginTag("Number of skin fragments", 'NSKF');
             writer->WriteInt(skinSet.skinFragments.Size());
             writer->EndTag();
@@ -11,6 +11,8 @@
 #include "model/modelutil/modelbuilder.h"
 #include "util/crc.h"
 
+#include <float.h>
+
 namespace ToolkitUtil
 {
 
@@ -244,7 +246,35 @@ SceneWriter::CreateModel(
                 SetupDefaultState(skinNode.path, Util::String::Sprintf("%s/%s/%s", category.AsCharPtr(), file.AsCharPtr(), mesh->mesh.material.AsCharPtr()), attributes, true);
             }
 
+            // generated levels of detail take over from the skin at their distance
+            if (!mesh->mesh.lodGroups.IsEmpty())
+            {
+                skinSetNode.useLOD = true;
+                skinSetNode.LODMin = 0.0f;
+                skinSetNode.LODMax = mesh->mesh.lodDistances[0];
+            }
             constants->AddSkinSetNode(skinSetNode);
+
+            const SizeT numFragments = skinSetNode.skinFragments.Size();
+            for (IndexT j = 0; j < mesh->mesh.lodDistances.Size(); j++)
+            {
+                ModelConstants::SkinSetNode lodSetNode = skinSetNode;
+                lodSetNode.name.Format("%s_lod%d", skinSetNode.name.AsCharPtr(), j + 1);
+                lodSetNode.path.Format("root/%s", lodSetNode.name.AsCharPtr());
+                lodSetNode.LODMin = mesh->mesh.lodDistances[j];
+                lodSetNode.LODMax = j + 1 < mesh->mesh.lodDistances.Size() ? mesh->mesh.lodDistances[j + 1] : FLT_MAX;
+                for (IndexT k = 0; k < numFragments; k++)
+                {
+                    ModelConstants::SkinNode& lodNode = lodSetNode.skinFragments[k];
+                    lodNode.path.Format("%s/fragment_%d", lodSetNode.path.AsCharPtr(), k);
+                    lodNode.primitiveGroupIndex = mesh->mesh.lodGroups[j * numFragments + k];
+
+                    // levels share the material of their source fragment
+                    const State state = attributes->GetState(skinSetNode.skinFragments[k].path);
+                    attributes->SetState(lodNode.path, state);
+                }
+                constants->AddSkinSetNode(lodSetNode);
+            }
         }
         else
         {
@@ -265,10 +295,33 @@ SceneWriter::CreateModel(
             shapeNode.name = mesh->base.name;
             shapeNode.primitiveGroupIndex = mesh->mesh.groupId;
 
+            // generated levels of detail take over from the shape at their distance
+            if (!mesh->mesh.lodGroups.IsEmpty())
+            {
+                shapeNode.useLOD = true;
+                shapeNode.LODMin = 0.0f;
+                shapeNode.LODMax = mesh->mesh.lodDistances[0];
+            }
+
             // add to constants
             constants->AddShapeNode(shapeNode);
 
             SetupDefaultState(shapeNode.path, Util::String::Sprintf("%s/%s/%s", category.AsCharPtr(), file.AsCharPtr(), mesh->mesh.material.AsCharPtr()), attributes);
+
+            for (IndexT j = 0; j < mesh->mesh.lodGroups.Size(); j++)
+            {
+                ModelConstants::ShapeNode lodNode = shapeNode;
+                lodNode.name.Format("%s_lod%d", shapeNode.name.AsCharPtr(), j + 1);
+                lodNode.path.Format("root/%s", lodNode.name.AsCharPtr());
+                lodNode.primitiveGroupIndex = mesh->mesh.lodGroups[j];
+                lodNode.LODMin = mesh->mesh.lodDistances[j];
+                lodNode.LODMax = j + 1 < mesh->mesh.lodDistances.Size() ? mesh->mesh.lodDistances[j + 1] : FLT_MAX;
+                constants->AddShapeNode(lodNode);
+
+                // levels share the material of their source shape
+                const State state = attributes->GetState(shapeNode.path);
+                attributes->SetState(lodNode.path, state);
+            }
         }
     }
 
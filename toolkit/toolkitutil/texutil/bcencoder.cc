@@ -0,0 +1,815 @@
+//------------------------------------------------------------------------------
+//  bcencoder.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "foundation/stdneb.h"
+#include "bcencoder.h"
+#include "jobs2/jobs2.h"
+
+namespace ToolkitUtil
+{
+using namespace Util;
+
+// BC7 4 bit index interpolation weights
+static const int BC7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+//------------------------------------------------------------------------------
+/**
+    Writes bits into a block, least significant bit first.
+*/
+struct BCBitWriter
+{
+    ubyte* out;
+    uint bit;
+
+    void Write(uint value, uint numBits)
+    {
+        for (uint i = 0; i < numBits; i++, bit++)
+        {
+            if (value & (1 << i))
+                out[bit >> 3] |= 1 << (bit & 7);
+        }
+    }
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline float
+SRGBToLinear(float c)
+{
+    return c <= 0.04045f ? c / 12.92f : Math::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline float
+LinearToSRGB(float c)
+{
+    return c <= 0.0031308f ? c * 12.92f : 1.055f * Math::pow(c, 1.0f / 2.4f) - 0.055f;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline ubyte
+UnitToByte(float f)
+{
+    return (ubyte)Math::clamp(Math::round(f * 255.0f), 0.0f, 255.0f);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline float
+ColorDistance(const float* a, const float* b, int channels)
+{
+    float d = 0.0f;
+    for (int c = 0; c < channels; c++)
+        d += (a[c] - b[c]) * (a[c] - b[c]);
+    return d;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Fits two endpoints to the pixels, along the bounding box diagonal or the
+    principal axis of the pixels.
+*/
+static void
+FitEndpoints(const float (*pixels)[4], const bool* mask, int channels, bool principalAxis, float* e0, float* e1)
+{
+    float mean[4] = { 0, 0, 0, 0 };
+    float boxMin[4] = { 255, 255, 255, 255 };
+    float boxMax[4] = { 0, 0, 0, 0 };
+    int count = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        if (mask != nullptr && !mask[i])
+            continue;
+        count++;
+        for (int c = 0; c < channels; c++)
+        {
+            mean[c] += pixels[i][c];
+            boxMin[c] = Math::min(boxMin[c], pixels[i][c]);
+            boxMax[c] = Math::max(boxMax[c], pixels[i][c]);
+        }
+    }
+    if (count == 0)
+    {
+        for (int c = 0; c < channels; c++)
+            e0[c] = e1[c] = 0.0f;
+        return;
+    }
+    for (int c = 0; c < channels; c++)
+        mean[c] /= count;
+
+    if (!principalAxis)
+    {
+        // pick the box diagonal by the sign of each channel's covariance with the widest channel
+        int widest = 0;
+        for (int c = 1; c < channels; c++)
+        {
+            if (boxMax[c] - boxMin[c] > boxMax[widest] - boxMin[widest])
+                widest = c;
+        }
+        for (int c = 0; c < channels; c++)
+        {
+            float covariance = 0.0f;
+            for (int i = 0; i < 16; i++)
+            {
+                if (mask == nullptr || mask[i])
+                    covariance += (pixels[i][c] - mean[c]) * (pixels[i][widest] - mean[widest]);
+            }
+            e0[c] = covariance < 0.0f ? boxMax[c] : boxMin[c];
+            e1[c] = covariance < 0.0f ? boxMin[c] : boxMax[c];
+        }
+        return;
+    }
+
+    // covariance, then power iteration from the bounding box diagonal for the principal axis
+    float covariance[4][4] = {};
+    for (int i = 0; i < 16; i++)
+    {
+        if (mask != nullptr && !mask[i])
+            continue;
+        for (int a = 0; a < channels; a++)
+            for (int b = 0; b < channels; b++)
+                covariance[a][b] += (pixels[i][a] - mean[a]) * (pixels[i][b] - mean[b]);
+    }
+    float axis[4] = { 0, 0, 0, 0 };
+    for (int c = 0; c < channels; c++)
+        axis[c] = boxMax[c] - boxMin[c];
+    for (int iteration = 0; iteration < 8; iteration++)
+    {
+        float next[4] = { 0, 0, 0, 0 };
+        float length = 0.0f;
+        for (int a = 0; a < channels; a++)
+        {
+            for (int b = 0; b < channels; b++)
+                next[a] += covariance[a][b] * axis[b];
+            length = Math::max(length, Math::abs(next[a]));
+        }
+        if (length < 1e-6f)
+            break;
+        for (int c = 0; c < channels; c++)
+            axis[c] = next[c] / length;
+    }
+
+    float minT = FLT_MAX, maxT = -FLT_MAX;
+    for (int i = 0; i < 16; i++)
+    {
+        if (mask != nullptr && !mask[i])
+            continue;
+        float t = 0.0f;
+        for (int c = 0; c < channels; c++)
+            t += (pixels[i][c] - mean[c]) * axis[c];
+        minT = Math::min(minT, t);
+        maxT = Math::max(maxT, t);
+    }
+    float axisLengthSq = 0.0f;
+    for (int c = 0; c < channels; c++)
+        axisLengthSq += axis[c] * axis[c];
+    if (axisLengthSq < 1e-12f)
+        axisLengthSq = 1.0f;
+    for (int c = 0; c < channels; c++)
+    {
+        e0[c] = Math::clamp(mean[c] + axis[c] * minT / axisLengthSq, 0.0f, 255.0f);
+        e1[c] = Math::clamp(mean[c] + axis[c] * maxT / axisLengthSq, 0.0f, 255.0f);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Least squares fit of two endpoints to the pixels, given their
+    interpolation weights. Returns false for degenerate weights.
+*/
+static bool
+RefineEndpoints(const float (*pixels)[4], const bool* mask, const float* weights, int channels, float* e0, float* e1)
+{
+    float alpha2 = 0, beta2 = 0, alphaBeta = 0;
+    float alphaX[4] = { 0, 0, 0, 0 };
+    float betaX[4] = { 0, 0, 0, 0 };
+    for (int i = 0; i < 16; i++)
+    {
+        if (mask != nullptr && !mask[i])
+            continue;
+        const float b = weights[i];
+        const float a = 1.0f - b;
+        alpha2 += a * a;
+        beta2 += b * b;
+        alphaBeta += a * b;
+        for (int c = 0; c < channels; c++)
+        {
+            alphaX[c] += a * pixels[i][c];
+            betaX[c] += b * pixels[i][c];
+        }
+    }
+    const float det = alpha2 * beta2 - alphaBeta * alphaBeta;
+    if (Math::abs(det) < 1e-6f)
+        return false;
+    for (int c = 0; c < channels; c++)
+    {
+        e0[c] = Math::clamp((alphaX[c] * beta2 - betaX[c] * alphaBeta) / det, 0.0f, 255.0f);
+        e1[c] = Math::clamp((betaX[c] * alpha2 - alphaX[c] * alphaBeta) / det, 0.0f, 255.0f);
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline ushort
+PackRGB565(const float* color)
+{
+    const uint r = (uint)Math::clamp(Math::round(color[0] * 31.0f / 255.0f), 0.0f, 31.0f);
+    const uint g = (uint)Math::clamp(Math::round(color[1] * 63.0f / 255.0f), 0.0f, 63.0f);
+    const uint b = (uint)Math::clamp(Math::round(color[2] * 31.0f / 255.0f), 0.0f, 31.0f);
+    return (ushort)((r << 11) | (g << 5) | b);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+static inline void
+UnpackRGB565(ushort packed, float* color)
+{
+    const uint r = (packed >> 11) & 31;
+    const uint g = (packed >> 5) & 63;
+    const uint b = packed & 31;
+    color[0] = (float)((r << 3) | (r >> 2));
+    color[1] = (float)((g << 2) | (g >> 4));
+    color[2] = (float)((b << 3) | (b >> 2));
+}
+
+//------------------------------------------------------------------------------
+/**
+    Encodes the color part of a BC1 or BC3 block. Punch through alpha uses
+    the three color mode, with index 3 for transparent pixels.
+*/
+static void
+EncodeColorBlock(const float (*pixels)[4], const bool* opaque, bool punchThrough, const BCEncoder::Settings& settings, ubyte* out)
+{
+    static const float Weights4[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+    static const float Weights3[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+    const float* weightTable = punchThrough ? Weights3 : Weights4;
+
+    float e0[4], e1[4];
+    FitEndpoints(pixels, punchThrough ? opaque : nullptr, 3, settings.principalAxis, e0, e1);
+
+    ushort bestC0 = 0, bestC1 = 0;
+    uint bestIndices = 0;
+    float bestError = FLT_MAX;
+    for (int iteration = 0; iteration <= settings.refineIterations; iteration++)
+    {
+        ushort c0 = PackRGB565(e0);
+        ushort c1 = PackRGB565(e1);
+
+        // four color mode needs c0 > c1, three color mode c0 <= c1
+        if (punchThrough ? c0 > c1 : c0 < c1)
+        {
+            const ushort tmp = c0;
+            c0 = c1;
+            c1 = tmp;
+        }
+
+        float palette[4][4];
+        UnpackRGB565(c0, palette[0]);
+        UnpackRGB565(c1, palette[1]);
+        for (int c = 0; c < 3; c++)
+        {
+            if (punchThrough)
+            {
+                palette[2][c] = (palette[0][c] + palette[1][c]) * 0.5f;
+                palette[3][c] = 0.0f;
+            }
+            else
+            {
+                palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+                palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+            }
+        }
+
+        uint indices = 0;
+        float error = 0.0f;
+        float weights[16];
+        // equal endpoints decode in three color mode, where index 3 is black, so only use index 0
+        const int numColors = punchThrough ? 3 : (c0 == c1 ? 1 : 4);
+        for (int i = 0; i < 16; i++)
+        {
+            uint index = 3;
+            weights[i] = 0.0f;
+            if (!punchThrough || opaque[i])
+            {
+                float best = FLT_MAX;
+                for (int p = 0; p < numColors; p++)
+                {
+                    const float d = ColorDistance(pixels[i], palette[p], 3);
+                    if (d < best)
+                    {
+                        best = d;
+                        index = p;
+                    }
+                }
+                error += best;
+                weights[i] = weightTable[index];
+            }
+            indices |= index << (i * 2);
+        }
+
+        if (error < bestError)
+        {
+            bestError = error;
+            bestC0 = c0;
+            bestC1 = c1;
+            bestIndices = indices;
+        }
+        if (iteration == settings.refineIterations || bestError == 0.0f)
+            break;
+
+        // refit the endpoints to the chosen indices, c0 being the weight zero endpoint
+        if (!RefineEndpoints(pixels, punchThrough ? opaque : nullptr, weights, 3, e0, e1))
+            break;
+    }
+
+    out[0] = bestC0 & 0xFF;
+    out[1] = bestC0 >> 8;
+    out[2] = bestC1 & 0xFF;
+    out[3] = bestC1 >> 8;
+    out[4] = bestIndices & 0xFF;
+    out[5] = (bestIndices >> 8) & 0xFF;
+    out[6] = (bestIndices >> 16) & 0xFF;
+    out[7] = (bestIndices >> 24) & 0xFF;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Encodes a single channel BC4 block, which is also the alpha block of BC3
+    and each half of BC5. Always uses the eight value mode.
+*/
+static void
+EncodeAlphaBlock(const float (*pixels)[4], int channel, const BCEncoder::Settings& settings, ubyte* out)
+{
+    float minValue = 255.0f, maxValue = 0.0f;
+    for (int i = 0; i < 16; i++)
+    {
+        minValue = Math::min(minValue, pixels[i][channel]);
+        maxValue = Math::max(maxValue, pixels[i][channel]);
+    }
+
+    float e0 = maxValue, e1 = minValue;
+    int bestR0 = 0, bestR1 = 0;
+    uint64 bestIndices = 0;
+    float bestError = FLT_MAX;
+    for (int iteration = 0; iteration <= settings.refineIterations; iteration++)
+    {
+        int r0 = (int)Math::clamp(Math::round(Math::max(e0, e1)), 0.0f, 255.0f);
+        int r1 = (int)Math::clamp(Math::round(Math::min(e0, e1)), 0.0f, 255.0f);
+
+        uint64 indices = 0;
+        float error = 0.0f;
+        float weights[16];
+        float values[16][4];
+        if (r0 == r1)
+        {
+            // all pixels use the first endpoint
+            for (int i = 0; i < 16; i++)
+                error += (pixels[i][channel] - r0) * (pixels[i][channel] - r0);
+        }
+        else
+        {
+            float palette[8];
+            palette[0] = (float)r0;
+            palette[1] = (float)r1;
+            for (int k = 2; k < 8; k++)
+                palette[k] = ((8 - k) * r0 + (k - 1) * r1) / 7.0f;
+            for (int i = 0; i < 16; i++)
+            {
+                uint index = 0;
+                float best = FLT_MAX;
+                for (int k = 0; k < 8; k++)
+                {
+                    const float d = (pixels[i][channel] - palette[k]) * (pixels[i][channel] - palette[k]);
+                    if (d < best)
+                    {
+                        best = d;
+                        index = k;
+                    }
+                }
+                error += best;
+                weights[i] = index == 0 ? 0.0f : (index == 1 ? 1.0f : (index - 1) / 7.0f);
+                values[i][0] = pixels[i][channel];
+                indices |= (uint64)index << (i * 3);
+            }
+        }
+
+        if (error < bestError)
+        {
+            bestError = error;
+            bestR0 = r0;
+            bestR1 = r1;
+            bestIndices = indices;
+        }
+        if (iteration == settings.refineIterations || bestError == 0.0f || r0 == r1)
+            break;
+
+        float refined0, refined1;
+        if (!RefineEndpoints(values, nullptr, weights, 1, &refined0, &refined1))
+            break;
+        e0 = refined0;
+        e1 = refined1;
+    }
+
+    out[0] = (ubyte)bestR0;
+    out[1] = (ubyte)bestR1;
+    for (int i = 0; i < 6; i++)
+        out[2 + i] = (bestIndices >> (i * 8)) & 0xFF;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Quantizes an endpoint to 7 bits per channel with a shared p-bit, picking
+    the p-bit with the smallest error unless forced.
+*/
+static int
+QuantizeBC7Endpoint(const float* endpoint, int forcePBit, int* quantized)
+{
+    int bestPBit = 0;
+    float bestError = FLT_MAX;
+    for (int p = 0; p < 2; p++)
+    {
+        if (forcePBit >= 0 && p != forcePBit)
+            continue;
+        float error = 0.0f;
+        for (int c = 0; c < 4; c++)
+        {
+            const int q = (int)Math::clamp(Math::round((endpoint[c] - p) * 0.5f), 0.0f, 127.0f);
+            const float d = endpoint[c] - (float)((q << 1) | p);
+            error += d * d;
+        }
+        if (error < bestError)
+        {
+            bestError = error;
+            bestPBit = p;
+        }
+    }
+    for (int c = 0; c < 4; c++)
+        quantized[c] = (int)Math::clamp(Math::round((endpoint[c] - bestPBit) * 0.5f), 0.0f, 127.0f);
+    return bestPBit;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Encodes a BC7 mode 6 block.
+*/
+static void
+EncodeBC7Block(const float (*pixels)[4], const BCEncoder::Settings& settings, ubyte* out)
+{
+    float e0[4], e1[4];
+    FitEndpoints(pixels, nullptr, 4, settings.principalAxis, e0, e1);
+
+    int bestEndpoints[2][4] = {};
+    int bestPBits[2] = { 0, 0 };
+    int bestIndices[16] = {};
+    float bestError = FLT_MAX;
+    for (int iteration = 0; iteration <= settings.refineIterations; iteration++)
+    {
+        const int numPBitCombinations = settings.searchPBits ? 4 : 1;
+        int chosenIndices[16];
+        float chosenError = FLT_MAX;
+        for (int combination = 0; combination < numPBitCombinations; combination++)
+        {
+            int q[2][4], p[2];
+            p[0] = QuantizeBC7Endpoint(e0, settings.searchPBits ? (combination & 1) : -1, q[0]);
+            p[1] = QuantizeBC7Endpoint(e1, settings.searchPBits ? (combination >> 1) : -1, q[1]);
+
+            float palette[16][4];
+            for (int c = 0; c < 4; c++)
+            {
+                const int a = (q[0][c] << 1) | p[0];
+                const int b = (q[1][c] << 1) | p[1];
+                for (int k = 0; k < 16; k++)
+                    palette[k][c] = (float)(((64 - BC7Weights4[k]) * a + BC7Weights4[k] * b + 32) >> 6);
+            }
+
+            int indices[16];
+            float error = 0.0f;
+            for (int i = 0; i < 16; i++)
+            {
+                float best = FLT_MAX;
+                for (int k = 0; k < 16; k++)
+                {
+                    const float d = ColorDistance(pixels[i], palette[k], 4);
+                    if (d < best)
+                    {
+                        best = d;
+                        indices[i] = k;
+                    }
+                }
+                error += best;
+            }
+
+            if (error < chosenError)
+            {
+                chosenError = error;
+                Memory::Copy(indices, chosenIndices, sizeof(indices));
+            }
+            if (error < bestError)
+            {
+                bestError = error;
+                Memory::Copy(q, bestEndpoints, sizeof(q));
+                bestPBits[0] = p[0];
+                bestPBits[1] = p[1];
+                Memory::Copy(indices, bestIndices, sizeof(indices));
+            }
+        }
+        if (iteration == settings.refineIterations || bestError == 0.0f)
+            break;
+
+        float weights[16];
+        for (int i = 0; i < 16; i++)
+            weights[i] = BC7Weights4[chosenIndices[i]] / 64.0f;
+        if (!RefineEndpoints(pixels, nullptr, weights, 4, e0, e1))
+            break;
+    }
+
+    // the anchor index has an implicit zero high bit, swap the endpoints if needed
+    if (bestIndices[0] & 8)
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            const int tmp = bestEndpoints[0][c];
+            bestEndpoints[0][c] = bestEndpoints[1][c];
+            bestEndpoints[1][c] = tmp;
+        }
+        const int tmp = bestPBits[0];
+        bestPBits[0] = bestPBits[1];
+        bestPBits[1] = tmp;
+        for (int i = 0; i < 16; i++)
+            bestIndices[i] = 15 - bestIndices[i];
+    }
+
+    Memory::Clear(out, 16);
+    BCBitWriter writer = { out, 0 };
+    writer.Write(1 << 6, 7);
+    for (int c = 0; c < 4; c++)
+    {
+        writer.Write(bestEndpoints[0][c], 7);
+        writer.Write(bestEndpoints[1][c], 7);
+    }
+    writer.Write(bestPBits[0], 1);
+    writer.Write(bestPBits[1], 1);
+    writer.Write(bestIndices[0], 3);
+    for (int i = 1; i < 16; i++)
+        writer.Write(bestIndices[i], 4);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+BCEncoder::Settings
+BCEncoder::Preset(TextureAttrs::Quality quality)
+{
+    switch (quality)
+    {
+        case TextureAttrs::Low:
+            return { false, 0, false };
+        case TextureAttrs::High:
+            return { true, 4, true };
+        default:
+            return { true, 1, false };
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+BCEncoder::BlockSize(Format format)
+{
+    switch (format)
+    {
+        case BC1:
+        case BC1A:
+        case BC4:
+            return 8;
+        default:
+            return 16;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+BCEncoder::EncodedSize(Format format, SizeT width, SizeT height)
+{
+    return ((width + 3) / 4) * ((height + 3) / 4) * BlockSize(format);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Works on float pixels so every level is filtered from the full precision
+    level above it, not from its 8 bit encoding.
+*/
+void
+BCEncoder::GenerateMips(const ubyte* pixels, SizeT width, SizeT height, MipMode mode, bool mips, SizeT maxWidth, SizeT maxHeight, Util::Array<Image>& outMips)
+{
+    float srgbTable[256];
+    for (int i = 0; i < 256; i++)
+        srgbTable[i] = SRGBToLinear(i / 255.0f);
+
+    // unpack to linear values, or vectors for normal maps
+    FixedArray<float> level(width * height * 4);
+    for (SizeT i = 0; i < width * height; i++)
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            const ubyte value = pixels[i * 4 + c];
+            float& unpacked = level[i * 4 + c];
+            if (mode == SRGBMips && c < 3)
+                unpacked = srgbTable[value];
+            else if (mode == NormalMips && c < 3)
+                unpacked = value / 255.0f * 2.0f - 1.0f;
+            else
+                unpacked = value / 255.0f;
+        }
+    }
+
+    outMips.Clear();
+    FixedArray<float> next;
+    while (true)
+    {
+        if (width <= maxWidth && height <= maxHeight)
+        {
+            Image& image = outMips.Emplace();
+            image.width = width;
+            image.height = height;
+            image.pixels.Resize(width * height * 4);
+            for (SizeT i = 0; i < width * height; i++)
+            {
+                const float* texel = &level[i * 4];
+                ubyte* packed = &image.pixels[i * 4];
+                if (mode == SRGBMips)
+                {
+                    for (int c = 0; c < 3; c++)
+                        packed[c] = UnitToByte(LinearToSRGB(texel[c]));
+                }
+                else if (mode == NormalMips)
+                {
+                    for (int c = 0; c < 3; c++)
+                        packed[c] = UnitToByte(texel[c] * 0.5f + 0.5f);
+                }
+                else
+                {
+                    for (int c = 0; c < 3; c++)
+                        packed[c] = UnitToByte(texel[c]);
+                }
+                packed[3] = UnitToByte(texel[3]);
+            }
+            if (!mips)
+                break;
+        }
+        if (width == 1 && height == 1)
+            break;
+
+        // 2x2 box filter, clamping the odd row and column
+        const SizeT nextWidth = Math::max(width / 2, 1);
+        const SizeT nextHeight = Math::max(height / 2, 1);
+        next.Resize(nextWidth * nextHeight * 4);
+        for (SizeT y = 0; y < nextHeight; y++)
+        {
+            const SizeT y0 = Math::min(y * 2, height - 1);
+            const SizeT y1 = Math::min(y * 2 + 1, height - 1);
+            for (SizeT x = 0; x < nextWidth; x++)
+            {
+                const SizeT x0 = Math::min(x * 2, width - 1);
+                const SizeT x1 = Math::min(x * 2 + 1, width - 1);
+                float* texel = &next[(y * nextWidth + x) * 4];
+                for (int c = 0; c < 4; c++)
+                {
+                    texel[c] = (level[(y0 * width + x0) * 4 + c] + level[(y0 * width + x1) * 4 + c]
+                        + level[(y1 * width + x0) * 4 + c] + level[(y1 * width + x1) * 4 + c]) * 0.25f;
+                }
+                if (mode == NormalMips)
+                {
+                    const float length = Math::sqrt(texel[0] * texel[0] + texel[1] * texel[1] + texel[2] * texel[2]);
+                    if (length > 1e-6f)
+                    {
+                        texel[0] /= length;
+                        texel[1] /= length;
+                        texel[2] /= length;
+                    }
+                    else
+                    {
+                        texel[0] = texel[1] = 0.0f;
+                        texel[2] = 1.0f;
+                    }
+                }
+            }
+        }
+        level = std::move(next);
+        next = FixedArray<float>();
+        width = nextWidth;
+        height = nextHeight;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BCEncoder::EncodeBlock(Format format, const Settings& settings, const ubyte* block, ubyte* out)
+{
+    float pixels[16][4];
+    bool opaque[16];
+    bool anyTransparent = false;
+    for (int i = 0; i < 16; i++)
+    {
+        for (int c = 0; c < 4; c++)
+            pixels[i][c] = block[i * 4 + c];
+        opaque[i] = block[i * 4 + 3] >= 128;
+        anyTransparent |= !opaque[i];
+    }
+
+    switch (format)
+    {
+        case BC1:
+            EncodeColorBlock(pixels, opaque, false, settings, out);
+            break;
+        case BC1A:
+            EncodeColorBlock(pixels, opaque, anyTransparent, settings, out);
+            break;
+        case BC3:
+            EncodeAlphaBlock(pixels, 3, settings, out);
+            EncodeColorBlock(pixels, opaque, false, settings, out + 8);
+            break;
+        case BC4:
+            EncodeAlphaBlock(pixels, 0, settings, out);
+            break;
+        case BC5:
+            EncodeAlphaBlock(pixels, 0, settings, out);
+            EncodeAlphaBlock(pixels, 1, settings, out + 8);
+            break;
+        case BC7:
+            EncodeBC7Block(pixels, settings, out);
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+BCEncoder::Encode(Format format, const Settings& settings, const Image& image, ubyte* out)
+{
+    const SizeT blocksX = (image.width + 3) / 4;
+    const SizeT blocksY = (image.height + 3) / 4;
+    const SizeT blockSize = BlockSize(format);
+    const ubyte* pixels = image.pixels.Begin();
+    const SizeT width = image.width;
+    const SizeT height = image.height;
+
+    auto encodeRows = [format, settings, pixels, width, height, blocksX, blockSize, out](SizeT totalJobs, SizeT groupSize, IndexT groupIndex, SizeT invocationOffset)
+    {
+        ubyte block[16 * 4];
+        for (IndexT i = 0; i < groupSize; i++)
+        {
+            const IndexT by = i + invocationOffset;
+            if (by >= totalJobs)
+                return;
+            for (SizeT bx = 0; bx < blocksX; bx++)
+            {
+                // gather the block, clamping at the image edges
+                for (SizeT y = 0; y < 4; y++)
+                {
+                    const SizeT py = Math::min(by * 4 + y, height - 1);
+                    for (SizeT x = 0; x < 4; x++)
+                    {
+                        const SizeT px = Math::min(bx * 4 + x, width - 1);
+                        Memory::Copy(&pixels[(py * width + px) * 4], &block[(y * 4 + x) * 4], 4);
+                    }
+                }
+                BCEncoder::EncodeBlock(format, settings, block, out + (by * blocksX + bx) * blockSize);
+            }
+        }
+    };
+
+    // textures are converted in parallel already when running as a job
+    static const SizeT RowGroupSize = 8;
+    if (blocksY <= RowGroupSize || Jobs2::JobIsWorkerThread())
+    {
+        encodeRows(blocksY, blocksY, 0, 0);
+    }
+    else
+    {
+        Threading::Event event;
+        Jobs2::JobDispatch(encodeRows, blocksY, RowGroupSize, nullptr, nullptr, &event);
+        event.Wait();
+
+        // free up scratch memory
+        Jobs2::JobNewFrame();
+    }
+}
+
+} // namespace ToolkitUtil
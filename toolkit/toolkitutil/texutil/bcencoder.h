@@ -0,0 +1,86 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class ToolkitUtil::BCEncoder
+
+    In process block compression for BC1, BC3, BC4, BC5 and BC7, plus the mip
+    chain generation feeding it.
+
+    Color endpoints come from the bounding box or the principal axis of the
+    block, depending on the quality preset, and are refined with least squares
+    fits on the chosen indices. BC7 only uses mode 6 (one subset, RGBA, 4 bit
+    indices), which covers opaque and alpha blocks alike at a fraction of the
+    cost of a full mode search.
+
+    Mips are filtered in linear light for sRGB textures, and renormalized for
+    normal maps.
+
+    Encoding an image dispatches rows of blocks on Jobs2, unless called from
+    a job already, where it runs inline since textures are converted in
+    parallel by then.
+
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "core/types.h"
+#include "util/array.h"
+#include "util/fixedarray.h"
+#include "toolkitutil/texutil/textureattrs.h"
+
+//------------------------------------------------------------------------------
+namespace ToolkitUtil
+{
+class BCEncoder
+{
+public:
+    /// block compressed formats
+    enum Format
+    {
+        BC1,
+        BC1A,       // BC1 with punch through alpha
+        BC3,
+        BC4,
+        BC5,
+        BC7,
+    };
+
+    /// how mips are filtered
+    enum MipMode
+    {
+        LinearMips,     // average the stored values
+        SRGBMips,       // average in linear light
+        NormalMips,     // average and renormalize the unpacked vectors
+    };
+
+    /// encoder quality settings
+    struct Settings
+    {
+        bool principalAxis;         // fit endpoints along the principal axis instead of the bounding box diagonal
+        int refineIterations;       // least squares refinements of the endpoints
+        bool searchPBits;           // try all BC7 p-bit combinations instead of rounding
+    };
+
+    /// a mip level of RGBA8 pixels
+    struct Image
+    {
+        SizeT width = 0;
+        SizeT height = 0;
+        Util::FixedArray<ubyte> pixels;
+    };
+
+    /// get the encoder settings of a texture quality preset
+    static Settings Preset(TextureAttrs::Quality quality);
+    /// get the byte size of a block
+    static SizeT BlockSize(Format format);
+    /// get the byte size of an encoded image
+    static SizeT EncodedSize(Format format, SizeT width, SizeT height);
+
+    /// build a mip chain from an RGBA8 image, skipping levels larger than maxWidth x maxHeight
+    static void GenerateMips(const ubyte* pixels, SizeT width, SizeT height, MipMode mode, bool mips, SizeT maxWidth, SizeT maxHeight, Util::Array<Image>& outMips);
+    /// encode an RGBA8 image into out, which must hold EncodedSize bytes
+    static void Encode(Format format, const Settings& settings, const Image& image, ubyte* out);
+    /// encode a single block of 4x4 RGBA8 pixels
+    static void EncodeBlock(Format format, const Settings& settings, const ubyte* block, ubyte* out);
+};
+
+} // namespace ToolkitUtil
+//------------------------------------------------------------------------------
@@ -0,0 +1,345 @@
+//------------------------------------------------------------------------------
+//  nativetextureconversionjob.cc
+//  (C) 2024 Individual contributors, see AUTHORS file
+//------------------------------------------------------------------------------
+#include "foundation/stdneb.h"
+#include "nativetextureconversionjob.h"
+#include "io/uri.h"
+#include "io/ioserver.h"
+#include "io/stream.h"
+#include "timing/timer.h"
+#include "toolkit-common/text.h"
+
+#include "Compressonator.h"
+
+namespace ToolkitUtil
+{
+using namespace IO;
+using namespace Util;
+
+// DXGI formats written by the native path
+enum NativeDxgiFormat
+{
+    DxgiBC1 = 71,
+    DxgiBC1SRGB = 72,
+    DxgiBC3 = 77,
+    DxgiBC3SRGB = 78,
+    DxgiBC4 = 80,
+    DxgiBC5 = 83,
+    DxgiBC7 = 98,
+    DxgiBC7SRGB = 99,
+};
+
+#pragma pack(push, 1)
+struct NativeDDSHeader
+{
+    uint magic;
+    uint size;
+    uint flags;
+    uint height;
+    uint width;
+    uint pitchOrLinearSize;
+    uint depth;
+    uint mipMapCount;
+    uint reserved1[11];
+    uint pixelFormatSize;
+    uint pixelFormatFlags;
+    uint fourCC;
+    uint pixelFormatUnused[5];
+    uint caps;
+    uint caps2;
+    uint caps3;
+    uint caps4;
+    uint reserved2;
+    // DX10 extension
+    uint dxgiFormat;
+    uint resourceDimension;
+    uint miscFlag;
+    uint arraySize;
+    uint miscFlags2;
+};
+#pragma pack(pop)
+
+//------------------------------------------------------------------------------
+/**
+*/
+NativeTextureConversionJob::NativeTextureConversionJob()
+{
+    this->SetDstFileExtension("dds");
+}
+
+//------------------------------------------------------------------------------
+/**
+    Picks the target the same way as the platform jobs, normal maps by
+    attributes or file name, everything else by pixel format.
+*/
+bool
+NativeTextureConversionJob::SelectTarget(const String& srcPath, const TextureAttrs& attrs, Target& outTarget)
+{
+    // 8 bit sources only, float images and height maps need the platform jobs
+    if (!srcPath.CheckFileExtension("tga")
+        && !srcPath.CheckFileExtension("png")
+        && !srcPath.CheckFileExtension("jpg")
+        && !srcPath.CheckFileExtension("bmp"))
+        return false;
+    if (String::MatchPattern(srcPath, "*height.*"))
+        return false;
+
+    const bool srgb = attrs.GetColorSpace() == TextureAttrs::sRGB;
+    outTarget.flipY = false;
+    if ((attrs.GetPixelFormat() == TextureAttrs::DXT5NM)
+        || (attrs.GetPixelFormat() == TextureAttrs::BC5)
+        || (String::MatchPattern(srcPath, "*norm.*"))
+        || (String::MatchPattern(srcPath, "*normal.*"))
+        || (String::MatchPattern(srcPath, "*bump.*")))
+    {
+        outTarget.format = BCEncoder::BC5;
+        outTarget.mipMode = BCEncoder::NormalMips;
+        outTarget.dxgiFormat = DxgiBC5;
+        outTarget.flipY = attrs.GetFlipNormalY();
+        return true;
+    }
+
+    outTarget.mipMode = srgb ? BCEncoder::SRGBMips : BCEncoder::LinearMips;
+    switch (attrs.GetPixelFormat())
+    {
+        case TextureAttrs::DXT1C:
+            outTarget.format = BCEncoder::BC1;
+            outTarget.dxgiFormat = srgb ? DxgiBC1SRGB : DxgiBC1;
+            return true;
+        case TextureAttrs::DXT1A:
+            outTarget.format = BCEncoder::BC1A;
+            outTarget.dxgiFormat = srgb ? DxgiBC1SRGB : DxgiBC1;
+            return true;
+        case TextureAttrs::DXT5:
+            outTarget.format = BCEncoder::BC3;
+            outTarget.dxgiFormat = srgb ? DxgiBC3SRGB : DxgiBC3;
+            return true;
+        case TextureAttrs::BC4:
+            outTarget.format = BCEncoder::BC4;
+            outTarget.mipMode = BCEncoder::LinearMips;
+            outTarget.dxgiFormat = DxgiBC4;
+            return true;
+        case TextureAttrs::U888:
+        case TextureAttrs::BC7:
+            outTarget.format = BCEncoder::BC7;
+            outTarget.dxgiFormat = srgb ? DxgiBC7SRGB : DxgiBC7;
+            return true;
+        default:
+            return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+NativeTextureConversionJob::CanConvert(const String& srcPath, const TextureAttrs& attrs)
+{
+    Target target;
+    return SelectTarget(srcPath, attrs, target);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+NativeTextureConversionJob::CanConvertCube(const String& srcPath, const TextureAttrs& attrs)
+{
+    Array<String> files = IoServer::Instance()->ListFiles(srcPath, "*.*");
+    if (files.Size() != 6)
+        return false;
+    for (const String& file : files)
+    {
+        if (!CanConvert(String::Sprintf("%s/%s", srcPath.AsCharPtr(), file.AsCharPtr()), attrs))
+            return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Encodes all mips of an image. If inOutWidth is set, the top mip has to
+    match the size, which is how cube faces are checked against each other.
+*/
+bool
+NativeTextureConversionJob::EncodeImage(const String& path, const Target& target, SizeT& inOutWidth, SizeT& inOutHeight, SizeT& outMips, Util::Array<ubyte>& data)
+{
+    String src = URI(path).LocalPath();
+    CMP_MipSet mipSet;
+    Memory::Clear(&mipSet, sizeof(CMP_MipSet));
+    CMP_ERROR status = CMP_LoadTexture(src.AsCharPtr(), &mipSet);
+    if (status != CMP_OK)
+    {
+        this->logger->Error("Failed to load %s, error code: %d\n", src.AsCharPtr(), status);
+        return false;
+    }
+    if (mipSet.m_format != CMP_FORMAT_RGBA_8888)
+    {
+        this->logger->Error("%s is not an 8 bit RGBA image\n", src.AsCharPtr());
+        CMP_FreeMipSet(&mipSet);
+        return false;
+    }
+
+    CMP_MipLevel* level = nullptr;
+    CMP_GetMipLevel(&level, &mipSet, 0, 0);
+    const SizeT width = level->m_nWidth;
+    const SizeT height = level->m_nHeight;
+
+    // normal maps may need their green channel flipped before filtering
+    ubyte* pixels = (ubyte*)level->m_pbData;
+    if (target.flipY)
+    {
+        for (SizeT i = 0; i < width * height; i++)
+            pixels[i * 4 + 1] = 255 - pixels[i * 4 + 1];
+    }
+
+    const TextureAttrs& attrs = this->textureAttrs;
+    Util::Array<BCEncoder::Image> mips;
+    BCEncoder::GenerateMips(pixels, width, height, target.mipMode, attrs.GetGenMipMaps(), attrs.GetMaxWidth(), attrs.GetMaxHeight(), mips);
+    CMP_FreeMipSet(&mipSet);
+
+    if (inOutWidth != 0 && (mips[0].width != inOutWidth || mips[0].height != inOutHeight))
+    {
+        this->logger->Error("%s is %dx%d, expected %dx%d\n", src.AsCharPtr(), mips[0].width, mips[0].height, inOutWidth, inOutHeight);
+        return false;
+    }
+
+    const BCEncoder::Settings settings = BCEncoder::Preset(attrs.GetQuality());
+    for (const BCEncoder::Image& mip : mips)
+    {
+        const SizeT offset = data.Size();
+        data.Resize(offset + BCEncoder::EncodedSize(target.format, mip.width, mip.height));
+        BCEncoder::Encode(target.format, settings, mip, data.Begin() + offset);
+    }
+
+    inOutWidth = mips[0].width;
+    inOutHeight = mips[0].height;
+    outMips = mips.Size();
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+NativeTextureConversionJob::WriteDDS(const String& path, const Target& target, SizeT width, SizeT height, SizeT mips, bool cube, const Util::Array<ubyte>& data)
+{
+    NativeDDSHeader header;
+    Memory::Clear(&header, sizeof(header));
+    header.magic = ' SDD';
+    header.size = 124;
+    header.flags = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000;    // caps, height, width, pixel format, mip count, linear size
+    header.height = height;
+    header.width = width;
+    header.pitchOrLinearSize = BCEncoder::EncodedSize(target.format, width, height);
+    header.mipMapCount = mips;
+    header.pixelFormatSize = 32;
+    header.pixelFormatFlags = 0x4;                                  // fourcc
+    header.fourCC = '01XD';
+    header.caps = 0x1000 | (mips > 1 ? 0x400008 : 0);               // texture, mipmap and complex
+    if (cube)
+    {
+        header.caps |= 0x8;
+        header.caps2 = 0xFE00;                                      // cubemap with all faces
+    }
+    header.dxgiFormat = target.dxgiFormat;
+    header.resourceDimension = 3;                                   // texture 2D
+    header.miscFlag = cube ? 0x4 : 0;
+    header.arraySize = 1;
+
+    Ptr<Stream> stream = IoServer::Instance()->CreateStream(path);
+    stream->SetAccessMode(Stream::WriteAccess);
+    if (!stream->Open())
+    {
+        this->logger->Error("Failed to open %s for writing\n", URI(path).LocalPath().AsCharPtr());
+        return false;
+    }
+    stream->Write(&header, sizeof(header));
+    stream->Write(data.Begin(), data.Size());
+    stream->Close();
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+NativeTextureConversionJob::Convert()
+{
+    n_assert(0 != this->logger);
+    if (TextureConversionJob::Convert())
+    {
+        Target target;
+        if (!SelectTarget(this->srcPath, this->textureAttrs, target))
+        {
+            this->logger->Error("%s can not be converted natively\n", URI(this->srcPath).LocalPath().AsCharPtr());
+            return false;
+        }
+
+        Timing::Timer timer;
+        timer.Start();
+
+        SizeT width = 0, height = 0, mips = 0;
+        Util::Array<ubyte> data;
+        if (!this->EncodeImage(this->srcPath, target, width, height, mips, data))
+            return false;
+        if (!this->WriteDDS(this->dstPath, target, width, height, mips, false, data))
+            return false;
+
+        timer.Stop();
+        ToolkitUtil::Text print = Util::String::Sprintf("%s -> %s... ", Text(URI(this->srcPath).LocalPath()).Color(TextColor::Blue).AsCharPtr(), Text(Format("%s", URI(this->dstPath).LocalPath().AsCharPtr())).Color(TextColor::Green).Style(FontMode::Underline).AsCharPtr());
+        this->logger->Print("%s%s (%.2f ms)\n", print.AsCharPtr(), "done"_text.Color(TextColor::Green).AsCharPtr(), timer.GetTime() * 1000.0);
+        return true;
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Cube faces are taken in file name order, as +X, -X, +Y, -Y, +Z, -Z.
+*/
+bool
+NativeTextureConversionJob::ConvertCube()
+{
+    n_assert(0 != this->logger);
+    this->neverCopy = true;
+    if (TextureConversionJob::Convert())
+    {
+        Array<String> files = IoServer::Instance()->ListFiles(this->srcPath, "*.*");
+        if (files.Size() != 6)
+        {
+            this->logger->Warning("Exactly 6 images are required for a cubemap!\n");
+            return false;
+        }
+        files.Sort();
+
+        Timing::Timer timer;
+        timer.Start();
+
+        Target target;
+        SizeT width = 0, height = 0, mips = 0;
+        Util::Array<ubyte> data;
+        for (IndexT i = 0; i < files.Size(); i++)
+        {
+            String face = String::Sprintf("%s/%s", this->srcPath.AsCharPtr(), files[i].AsCharPtr());
+            if (!SelectTarget(face, this->textureAttrs, target))
+            {
+                this->logger->Error("%s can not be converted natively\n", URI(face).LocalPath().AsCharPtr());
+                return false;
+            }
+            if (!this->EncodeImage(face, target, width, height, mips, data))
+                return false;
+        }
+        if (!this->WriteDDS(this->dstPath, target, width, height, mips, true, data))
+            return false;
+
+        timer.Stop();
+        ToolkitUtil::Text print = Util::String::Sprintf("%s -> %s... ", Text(URI(this->srcPath).LocalPath()).Color(TextColor::Blue).AsCharPtr(), Text(Format("%s", URI(this->dstPath).LocalPath().AsCharPtr())).Color(TextColor::Green).Style(FontMode::Underline).AsCharPtr());
+        this->logger->Print("%s%s (%.2f ms)\n", print.AsCharPtr(), "done"_text.Color(TextColor::Green).AsCharPtr(), timer.GetTime() * 1000.0);
+        return true;
+    }
+    return false;
+}
+
+} // namespace ToolkitUtil
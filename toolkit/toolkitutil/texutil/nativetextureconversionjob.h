@@ -0,0 +1,56 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class ToolkitUtil::NativeTextureConversionJob
+
+    Converts textures and cubemaps in process with the BCEncoder, instead of
+    launching an external converter per texture and cube face. Writes DDS
+    files with DX10 headers.
+
+    Supports 8 bit sources and the BC1, BC3, BC4, BC5 and BC7 targets, use
+    CanConvert to check if a texture needs one of the platform jobs instead.
+
+    (C) 2024 Individual contributors, see AUTHORS file
+*/
+#include "toolkitutil/texutil/textureconversionjob.h"
+#include "toolkitutil/texutil/bcencoder.h"
+
+//------------------------------------------------------------------------------
+namespace ToolkitUtil
+{
+class NativeTextureConversionJob : public TextureConversionJob
+{
+public:
+    /// constructor
+    NativeTextureConversionJob();
+
+    /// check if a texture can be converted natively
+    static bool CanConvert(const Util::String& srcPath, const TextureAttrs& attrs);
+    /// check if a folder of cube faces can be converted natively
+    static bool CanConvertCube(const Util::String& srcPath, const TextureAttrs& attrs);
+
+    /// perform conversion
+    virtual bool Convert();
+    /// convert a folder of 6 cube faces
+    bool ConvertCube();
+
+private:
+    /// target format of a texture
+    struct Target
+    {
+        BCEncoder::Format format;
+        BCEncoder::MipMode mipMode;
+        uint dxgiFormat;
+        bool flipY;
+    };
+
+    /// select the target format of a texture, returns false if not supported natively
+    static bool SelectTarget(const Util::String& srcPath, const TextureAttrs& attrs, Target& outTarget);
+    /// load a source image, generate its mips and encode them, appending to data
+    bool EncodeImage(const Util::String& path, const Target& target, SizeT& inOutWidth, SizeT& inOutHeight, SizeT& outMips, Util::Array<ubyte>& data);
+    /// write a DDS file
+    bool WriteDDS(const Util::String& path, const Target& target, SizeT width, SizeT height, SizeT mips, bool cube, const Util::Array<ubyte>& data);
+};
+
+} // namespace ToolkitUtil
+//------------------------------------------------------------------------------
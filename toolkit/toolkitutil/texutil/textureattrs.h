@@ -58,12 +58,12 @@ public:
         Kaiser,
     };
 
-    /// quality types
+    /// quality types, select the BCEncoder presets for natively converted textures
     enum Quality
     {
-        Low,
-        Normal,
-        High,
+        Low,        // bounding box endpoints, no refinement
+        Normal,     // principal axis endpoints, one refinement
+        High,       // principal axis endpoints, four refinements and BC7 p-bit search
     };
 
     /// color spaces
@@ -10,6 +10,7 @@
 #include "io/xmlwriter.h"
 #include "toolkitutil/texutil/imageconverter.h"
 #include "util/guid.h"
+#include "toolkitutil/texutil/nativetextureconversionjob.h"
 
 #if (__WIN32__)
 #include "toolkitutil/texutil/directxtexconversionjob.h"
@@ -157,6 +158,21 @@ TextureConverter::ConvertTexture(const String& srcTexPath, const String& dstTexP
     String texFilename = tokens[tokens.Size() - 1];
 
 
+    // 8 bit sources to BC formats are encoded in process, the rest goes
+    // through the platform specific jobs
+    if (NativeTextureConversionJob::CanConvert(srcTexPath, this->textureAttrTable.GetEntry(srcTexPath)))
+    {
+        NativeTextureConversionJob job;
+        job.SetLogger(this->logger);
+        job.SetSrcPath(srcTexPath);
+        job.SetDstPath(dstTexPath);
+        job.SetTmpDir(tmpDir);
+        job.SetTexAttrTable(&this->textureAttrTable);
+        job.SetForceFlag(this->force);
+        job.SetQuietFlag(this->quiet);
+        return job.Convert();
+    }
+
     // select conversion method based on target platform
 #if (__WIN32__)    
     DirectXTexConversionJob job;
@@ -209,6 +225,20 @@ TextureConverter::ConvertCubemap(const String& srcTexPath, const String& dstTexP
 
     n_printf("Converting texture: %s\n", URI(srcTexPath).LocalPath().AsCharPtr());
 
+    // encode all faces in process when possible, this is the only cubemap path off Windows
+    if (NativeTextureConversionJob::CanConvertCube(srcTexPath, this->textureAttrTable.GetEntry(srcTexPath)))
+    {
+        NativeTextureConversionJob job;
+        job.SetLogger(this->logger);
+        job.SetSrcPath(srcTexPath);
+        job.SetDstPath(dstTexPath);
+        job.SetTmpDir(tmpDir);
+        job.SetTexAttrTable(&this->textureAttrTable);
+        job.SetForceFlag(this->force);
+        job.SetQuietFlag(this->quiet);
+        return job.ConvertCube();
+    }
+
     // select conversion method based on target platform
 #if (__WIN32__)
     DirectXTexConversionJob job;